@@ -0,0 +1,231 @@
+#include "Benchmark.hpp"
+#include "core/LibVersion.hpp"
+#include "core/Log.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+#ifndef QL_BENCH_BUILD_TYPE
+#define QL_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace quantiloom {
+
+static volatile f64 g_sink = 0.0;
+
+void KeepAlive(f64 value) {
+    g_sink = g_sink + value;
+}
+
+// ============================================================================
+// Helper: JSON string escaping
+// ============================================================================
+
+static String JsonEscape(const String& text) {
+    String escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+// ============================================================================
+// Helper: Run context
+// ============================================================================
+
+static String CompilerName() {
+#if defined(__clang__)
+    return fmt::format("clang {}.{}.{}", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+    return fmt::format("gcc {}.{}.{}", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+    return fmt::format("msvc {}", _MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+static String UtcTimestamp() {
+    const std::time_t now = std::time(nullptr);
+    char buffer[32] = {};
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+// ============================================================================
+// BenchmarkSuite
+// ============================================================================
+
+void BenchmarkSuite::Add(Benchmark benchmark) {
+    m_benchmarks.push_back(std::move(benchmark));
+}
+
+std::vector<String> BenchmarkSuite::Names() const {
+    std::vector<String> names;
+    names.reserve(m_benchmarks.size());
+    for (const Benchmark& benchmark : m_benchmarks) {
+        names.push_back(benchmark.name);
+    }
+    return names;
+}
+
+bool BenchmarkSuite::Selected(const String& name, const std::vector<String>& filters) {
+    if (filters.empty()) {
+        return true;
+    }
+    return std::any_of(filters.begin(), filters.end(),
+                       [&name](const String& filter) { return name.find(filter) != String::npos; });
+}
+
+BenchmarkResult BenchmarkSuite::Measure(const Benchmark& benchmark, const BenchmarkSettings& settings) const {
+    BenchmarkResult result;
+    result.name = benchmark.name;
+
+    for (u32 i = 0; i < settings.warmupIterations; ++i) {
+        benchmark.run();
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto minTime = std::chrono::duration<f64>(settings.minTimeSeconds);
+    std::vector<f64> samples;
+    const auto start = Clock::now();
+    const std::clock_t cpuStart = std::clock();
+    while (samples.size() < settings.maxIterations &&
+           (samples.size() < settings.minIterations || Clock::now() - start < minTime)) {
+        const auto iterationStart = Clock::now();
+        benchmark.run();
+        samples.push_back(std::chrono::duration<f64, std::nano>(Clock::now() - iterationStart).count());
+    }
+    const f64 cpuNs = static_cast<f64>(std::clock() - cpuStart) * 1e9 / static_cast<f64>(CLOCKS_PER_SEC);
+
+    const f64 count = static_cast<f64>(samples.size());
+    result.iterations = samples.size();
+    result.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+    f64 variance = 0.0;
+    for (f64 sample : samples) {
+        variance += (sample - result.meanNs) * (sample - result.meanNs);
+    }
+    result.stddevNs = samples.size() > 1 ? std::sqrt(variance / (count - 1.0)) : 0.0;
+    result.cpuNs = cpuNs / count;
+
+    std::sort(samples.begin(), samples.end());
+    result.minNs = samples.front();
+    const usize mid = samples.size() / 2;
+    result.medianNs = samples.size() % 2 == 1 ? samples[mid] : 0.5 * (samples[mid - 1] + samples[mid]);
+
+    if (result.medianNs > 0.0) {
+        result.itemsPerSecond = static_cast<f64>(benchmark.items) * 1e9 / result.medianNs;
+        result.bytesPerSecond = static_cast<f64>(benchmark.bytes) * 1e9 / result.medianNs;
+    }
+    return result;
+}
+
+bool BenchmarkSuite::Run(const BenchmarkSettings& settings) {
+    m_results.clear();
+    bool allPassed = true;
+
+    for (const Benchmark& benchmark : m_benchmarks) {
+        if (!Selected(benchmark.name, settings.filters)) {
+            continue;
+        }
+
+        // Library INFO lines (loaders, writers) would be timed along with the work
+        const Log::Level level = Log::GetLevel();
+        Log::SetLevel(Log::Level::Warn);
+        const bool ready = !benchmark.setup || benchmark.setup();
+        BenchmarkResult result = ready ? Measure(benchmark, settings) : BenchmarkResult{};
+        if (ready && benchmark.teardown) {
+            benchmark.teardown();
+        }
+        Log::SetLevel(level);
+
+        if (!ready) {
+            QL_LOG_ERROR("{}: setup failed", benchmark.name);
+            result.name = benchmark.name;
+            result.failed = true;
+            m_results.push_back(std::move(result));
+            allPassed = false;
+            continue;
+        }
+
+        String throughput;
+        if (result.bytesPerSecond > 0.0) {
+            throughput = fmt::format("  {:10.1f} MB/s", result.bytesPerSecond / 1e6);
+        } else if (result.itemsPerSecond > 0.0) {
+            throughput = fmt::format("  {:10.3f} M/s", result.itemsPerSecond / 1e6);
+        }
+        QL_LOG_INFO("{:<48} {:>8} it  median {:>12.3f} ms  min {:>12.3f} ms  +/- {:5.1f}%{}",
+                    result.name, result.iterations, result.medianNs / 1e6, result.minNs / 1e6,
+                    result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0, throughput);
+        m_results.push_back(std::move(result));
+    }
+
+    return allPassed;
+}
+
+bool BenchmarkSuite::WriteJson(const String& path, const BenchmarkSettings& settings) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        QL_LOG_ERROR("BenchmarkSuite::WriteJson: Cannot open {}", path);
+        return false;
+    }
+
+    file << "{\n  \"context\": {\n";
+    file << fmt::format("    \"date\": \"{}\",\n", UtcTimestamp());
+    file << fmt::format("    \"library_version\": \"{}\",\n", version::LibVersionString);
+    file << fmt::format("    \"library_build_type\": \"{}\",\n", JsonEscape(QL_BENCH_BUILD_TYPE));
+    file << fmt::format("    \"compiler\": \"{}\",\n", JsonEscape(CompilerName()));
+    file << fmt::format("    \"num_cpus\": {},\n", std::thread::hardware_concurrency());
+    file << fmt::format("    \"pool_threads\": {},\n", ThreadPool::Global().ThreadCount());
+    file << fmt::format("    \"min_time_s\": {},\n", settings.minTimeSeconds);
+    file << fmt::format("    \"min_iterations\": {}\n", settings.minIterations);
+    file << "  },\n  \"benchmarks\": [";
+
+    for (usize i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult& result = m_results[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << fmt::format("    {{\"name\": \"{}\", \"run_type\": \"iteration\", ", JsonEscape(result.name));
+        if (result.failed) {
+            file << "\"error_occurred\": true, \"error_message\": \"setup failed\"}";
+            continue;
+        }
+        file << fmt::format("\"iterations\": {}, \"real_time\": {:.1f}, \"cpu_time\": {:.1f}, \"time_unit\": \"ns\", "
+                            "\"min_ns\": {:.1f}, \"median_ns\": {:.1f}, \"mean_ns\": {:.1f}, \"stddev_ns\": {:.1f}",
+                            result.iterations, result.medianNs, result.cpuNs, result.minNs,
+                            result.medianNs, result.meanNs, result.stddevNs);
+        if (result.itemsPerSecond > 0.0) {
+            file << fmt::format(", \"items_per_second\": {:.6g}", result.itemsPerSecond);
+        }
+        if (result.bytesPerSecond > 0.0) {
+            file << fmt::format(", \"bytes_per_second\": {:.6g}", result.bytesPerSecond);
+        }
+        file << "}";
+    }
+    file << "\n  ]\n}\n";
+
+    if (!file) {
+        QL_LOG_ERROR("BenchmarkSuite::WriteJson: Failed to write {}", path);
+        return false;
+    }
+    QL_LOG_INFO("Wrote {} result(s) to {}", m_results.size(), path);
+    return true;
+}
+
+} // namespace quantiloom
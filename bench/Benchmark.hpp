@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <functional>
+#include <vector>
+
+// ============================================================================
+// Benchmark - Minimal timing harness behind quantiloom_bench
+// ============================================================================
+// Every benchmark has an optional setup (untimed, run once when the
+// benchmark is selected), a body that is timed per iteration, and an
+// optional teardown. The body is repeated until both the minimum number of
+// iterations and the minimum time are reached; min / median / mean /
+// stddev of the per-iteration wall time are reported, plus throughput when
+// the benchmark declares items or bytes per iteration.
+//
+// Results are written as JSON whose field names follow Google Benchmark
+// (name, iterations, real_time, cpu_time, time_unit, items_per_second,
+// bytes_per_second), so existing CI tooling can track them; extra fields
+// carry the distribution.
+//
+// Usage:
+//   BenchmarkSuite suite;
+//   suite.Add({.name = "lut/interpolate", .run = [&] { ... }, .items = 4096});
+//   suite.Run(settings);
+//   suite.WriteJson("results.json", settings);
+// ============================================================================
+
+namespace quantiloom {
+
+struct Benchmark {
+    String name;                               // "group/case/size"; selected by substring filter
+    std::function<bool()> setup = nullptr;     // Untimed; false = skip and report failure
+    std::function<void()> run = nullptr;       // One timed iteration
+    std::function<void()> teardown = nullptr;  // Untimed
+    u64 items = 0;                             // Items processed per iteration (0 = none)
+    u64 bytes = 0;                             // Bytes processed per iteration (0 = none)
+};
+
+struct BenchmarkResult {
+    String name;
+    u64 iterations = 0;
+    f64 minNs = 0.0;
+    f64 medianNs = 0.0;
+    f64 meanNs = 0.0;
+    f64 stddevNs = 0.0;
+    f64 cpuNs = 0.0;            // Mean process CPU time per iteration
+    f64 itemsPerSecond = 0.0;   // From the median
+    f64 bytesPerSecond = 0.0;   // From the median
+    bool failed = false;
+};
+
+struct BenchmarkSettings {
+    f64 minTimeSeconds = 0.5;   // Per benchmark, after warm-up
+    u32 minIterations = 3;
+    u32 maxIterations = 1000000;
+    u32 warmupIterations = 1;
+    std::vector<String> filters; // Substrings; empty = run everything
+};
+
+class BenchmarkSuite {
+public:
+    void Add(Benchmark benchmark);
+
+    // Names of every registered benchmark
+    std::vector<String> Names() const;
+
+    // Run the selected benchmarks in registration order; false if any failed
+    bool Run(const BenchmarkSettings& settings);
+
+    const std::vector<BenchmarkResult>& Results() const { return m_results; }
+
+    // Results with run context (version, build, threads, settings)
+    bool WriteJson(const String& path, const BenchmarkSettings& settings) const;
+
+private:
+    static bool Selected(const String& name, const std::vector<String>& filters);
+    BenchmarkResult Measure(const Benchmark& benchmark, const BenchmarkSettings& settings) const;
+
+    std::vector<Benchmark> m_benchmarks;
+    std::vector<BenchmarkResult> m_results;
+};
+
+// Keep a computed value alive so the optimiser cannot drop the work
+void KeepAlive(f64 value);
+
+} // namespace quantiloom
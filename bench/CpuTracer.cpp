@@ -0,0 +1,335 @@
+#include "CpuTracer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace quantiloom {
+
+static constexpr u32 kStackSize = 64;
+
+// ============================================================================
+// Helper: Bounding box
+// ============================================================================
+
+namespace {
+
+struct Aabb {
+    glm::vec3 min = glm::vec3(std::numeric_limits<f32>::max());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<f32>::max());
+
+    void Grow(const glm::vec3& p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    void Grow(const Aabb& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    f32 HalfArea() const {
+        const glm::vec3 extent = max - min;
+        return extent.x < 0.0f ? 0.0f : extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+};
+
+} // namespace
+
+struct CpuTracer::BuildScratch {
+    std::vector<glm::vec3> centroids;
+    std::vector<Aabb> bounds;
+};
+
+// ============================================================================
+// Helper: Slab test (returns entry distance, or tMax on a miss)
+// ============================================================================
+
+static f32 IntersectBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                           const glm::vec3& origin, const glm::vec3& invDirection, f32 tMin, f32 tMax) {
+    const glm::vec3 t0 = (boundsMin - origin) * invDirection;
+    const glm::vec3 t1 = (boundsMax - origin) * invDirection;
+    const glm::vec3 near = glm::min(t0, t1);
+    const glm::vec3 far = glm::max(t0, t1);
+    const f32 entry = std::max(std::max(near.x, near.y), std::max(near.z, tMin));
+    const f32 exit = std::min(std::min(far.x, far.y), std::min(far.z, tMax));
+    return entry <= exit ? entry : tMax;
+}
+
+// ============================================================================
+// CpuTracer - Build
+// ============================================================================
+
+void CpuTracer::Build(const Mesh& mesh) {
+    m_triangles.clear();
+    m_nodes.clear();
+
+    for (const GeometryPrimitive& primitive : mesh.primitives) {
+        for (usize i = 0; i + 2 < primitive.indices.size(); i += 3) {
+            const glm::vec3& v0 = primitive.positions[primitive.indices[i + 0]];
+            const glm::vec3& v1 = primitive.positions[primitive.indices[i + 1]];
+            const glm::vec3& v2 = primitive.positions[primitive.indices[i + 2]];
+            m_triangles.push_back({v0, v1 - v0, v2 - v0});
+        }
+    }
+    if (m_triangles.empty()) {
+        return;
+    }
+
+    BuildScratch scratch;
+    scratch.centroids.resize(m_triangles.size());
+    scratch.bounds.resize(m_triangles.size());
+    for (usize i = 0; i < m_triangles.size(); ++i) {
+        const Triangle& tri = m_triangles[i];
+        scratch.centroids[i] = tri.v0 + (tri.e1 + tri.e2) * (1.0f / 3.0f);
+        scratch.bounds[i].Grow(tri.v0);
+        scratch.bounds[i].Grow(tri.v0 + tri.e1);
+        scratch.bounds[i].Grow(tri.v0 + tri.e2);
+    }
+
+    m_nodes.reserve(2 * m_triangles.size());
+    Node root;
+    root.first = 0;
+    root.count = static_cast<u32>(m_triangles.size());
+    m_nodes.push_back(root);
+    Subdivide(0, scratch);
+}
+
+void CpuTracer::Subdivide(u32 nodeIndex, BuildScratch& scratch) {
+    // Node bounds and centroid bounds
+    Aabb bounds;
+    Aabb centroidBounds;
+    {
+        const Node& node = m_nodes[nodeIndex];
+        for (u32 i = node.first; i < node.first + node.count; ++i) {
+            bounds.Grow(scratch.bounds[i]);
+            centroidBounds.Grow(scratch.centroids[i]);
+        }
+        m_nodes[nodeIndex].boundsMin = bounds.min;
+        m_nodes[nodeIndex].boundsMax = bounds.max;
+    }
+
+    const u32 first = m_nodes[nodeIndex].first;
+    const u32 count = m_nodes[nodeIndex].count;
+    if (count <= MAX_LEAF_TRIANGLES) {
+        return;
+    }
+
+    // Binned SAH over all three axes
+    f32 bestCost = std::numeric_limits<f32>::max();
+    int bestAxis = -1;
+    f32 bestSplit = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const f32 lo = centroidBounds.min[axis];
+        const f32 hi = centroidBounds.max[axis];
+        if (hi <= lo) {
+            continue;
+        }
+
+        Aabb binBounds[BIN_COUNT];
+        u32 binCounts[BIN_COUNT] = {};
+        const f32 scale = static_cast<f32>(BIN_COUNT) / (hi - lo);
+        for (u32 i = first; i < first + count; ++i) {
+            const u32 bin = std::min(BIN_COUNT - 1, static_cast<u32>((scratch.centroids[i][axis] - lo) * scale));
+            ++binCounts[bin];
+            binBounds[bin].Grow(scratch.bounds[i]);
+        }
+
+        // Sweep: cost of splitting after bin b
+        f32 leftArea[BIN_COUNT - 1];
+        u32 leftCount[BIN_COUNT - 1];
+        Aabb running;
+        u32 runningCount = 0;
+        for (u32 b = 0; b + 1 < BIN_COUNT; ++b) {
+            running.Grow(binBounds[b]);
+            runningCount += binCounts[b];
+            leftArea[b] = running.HalfArea();
+            leftCount[b] = runningCount;
+        }
+        running = Aabb();
+        runningCount = 0;
+        for (u32 b = BIN_COUNT - 1; b > 0; --b) {
+            running.Grow(binBounds[b]);
+            runningCount += binCounts[b];
+            const f32 cost = static_cast<f32>(leftCount[b - 1]) * leftArea[b - 1] +
+                             static_cast<f32>(runningCount) * running.HalfArea();
+            if (leftCount[b - 1] > 0 && runningCount > 0 && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = lo + static_cast<f32>(b) / scale;
+            }
+        }
+    }
+
+    // Not worth splitting (or all centroids coincide)
+    if (bestAxis < 0 || bestCost >= static_cast<f32>(count) * bounds.HalfArea()) {
+        return;
+    }
+
+    // Partition in place
+    u32 i = first;
+    u32 j = first + count;
+    while (i < j) {
+        if (scratch.centroids[i][bestAxis] < bestSplit) {
+            ++i;
+        } else {
+            --j;
+            std::swap(m_triangles[i], m_triangles[j]);
+            std::swap(scratch.centroids[i], scratch.centroids[j]);
+            std::swap(scratch.bounds[i], scratch.bounds[j]);
+        }
+    }
+    const u32 leftCount = i - first;
+    if (leftCount == 0 || leftCount == count) {
+        return;
+    }
+
+    const u32 leftIndex = static_cast<u32>(m_nodes.size());
+    Node left;
+    left.first = first;
+    left.count = leftCount;
+    Node right;
+    right.first = i;
+    right.count = count - leftCount;
+    m_nodes.push_back(left);
+    m_nodes.push_back(right);
+
+    m_nodes[nodeIndex].first = leftIndex;
+    m_nodes[nodeIndex].count = 0;
+    Subdivide(leftIndex, scratch);
+    Subdivide(leftIndex + 1, scratch);
+}
+
+// ============================================================================
+// CpuTracer - Traversal
+// ============================================================================
+
+bool CpuTracer::IntersectTriangle(const Triangle& tri, const glm::vec3& origin, const glm::vec3& direction,
+                                  f32 tMin, f32 tMax, f32& t, f32& u, f32& v) {
+    // Moller-Trumbore
+    const glm::vec3 p = glm::cross(direction, tri.e2);
+    const f32 det = glm::dot(tri.e1, p);
+    if (std::fabs(det) < 1e-12f) {
+        return false;
+    }
+    const f32 invDet = 1.0f / det;
+    const glm::vec3 s = origin - tri.v0;
+    u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+    const glm::vec3 q = glm::cross(s, tri.e1);
+    v = glm::dot(direction, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+    t = glm::dot(tri.e2, q) * invDet;
+    return t > tMin && t < tMax;
+}
+
+CpuHit CpuTracer::Intersect(const glm::vec3& origin, const glm::vec3& direction, f32 tMin, f32 tMax) const {
+    CpuHit hit;
+    hit.t = tMax;
+    if (m_nodes.empty()) {
+        return hit;
+    }
+
+    struct StackEntry {
+        u32 node;
+        f32 entryT;
+    };
+    const glm::vec3 invDirection = 1.0f / direction;
+    StackEntry stack[kStackSize];
+    u32 stackSize = 0;
+    u32 nodeIndex = 0;
+    if (IntersectBounds(m_nodes[0].boundsMin, m_nodes[0].boundsMax, origin, invDirection, tMin, hit.t) >= hit.t) {
+        return hit;
+    }
+
+    for (;;) {
+        const Node& node = m_nodes[nodeIndex];
+        if (node.count > 0) {
+            for (u32 i = node.first; i < node.first + node.count; ++i) {
+                f32 t = 0.0f;
+                f32 u = 0.0f;
+                f32 v = 0.0f;
+                if (IntersectTriangle(m_triangles[i], origin, direction, tMin, hit.t, t, u, v)) {
+                    hit.t = t;
+                    hit.triangle = i;
+                    hit.u = u;
+                    hit.v = v;
+                }
+            }
+        } else {
+            // Descend into the nearer child, defer the farther one
+            u32 nearChild = node.first;
+            u32 farChild = node.first + 1;
+            f32 nearT = IntersectBounds(m_nodes[nearChild].boundsMin, m_nodes[nearChild].boundsMax,
+                                        origin, invDirection, tMin, hit.t);
+            f32 farT = IntersectBounds(m_nodes[farChild].boundsMin, m_nodes[farChild].boundsMax,
+                                       origin, invDirection, tMin, hit.t);
+            if (farT < nearT) {
+                std::swap(nearChild, farChild);
+                std::swap(nearT, farT);
+            }
+            if (nearT < hit.t) {
+                if (farT < hit.t && stackSize < kStackSize) {
+                    stack[stackSize++] = {farChild, farT};
+                }
+                nodeIndex = nearChild;
+                continue;
+            }
+        }
+
+        // Pop the next deferred node the current hit does not already occlude
+        bool found = false;
+        while (stackSize > 0 && !found) {
+            const StackEntry& entry = stack[--stackSize];
+            if (entry.entryT < hit.t) {
+                nodeIndex = entry.node;
+                found = true;
+            }
+        }
+        if (!found) {
+            break;
+        }
+    }
+    return hit;
+}
+
+bool CpuTracer::Occluded(const glm::vec3& origin, const glm::vec3& direction, f32 tMin, f32 tMax) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    const glm::vec3 invDirection = 1.0f / direction;
+    u32 stack[kStackSize];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (IntersectBounds(node.boundsMin, node.boundsMax, origin, invDirection, tMin, tMax) >= tMax) {
+            continue;
+        }
+        if (node.count == 0) {
+            if (stackSize + 2 <= kStackSize) {
+                stack[stackSize++] = node.first + 1;
+                stack[stackSize++] = node.first;
+            }
+            continue;
+        }
+        for (u32 i = node.first; i < node.first + node.count; ++i) {
+            f32 t = 0.0f;
+            f32 u = 0.0f;
+            f32 v = 0.0f;
+            if (IntersectTriangle(m_triangles[i], origin, direction, tMin, tMax, t, u, v)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,371 @@
+#include "SyntheticAssets.hpp"
+#include "SceneBuilder.hpp"
+#include "core/CounterRng.hpp"
+#include "core/Log.hpp"
+#include "io/ImageIO.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: Deterministic uniform in (0, 1) for (a, b, stream)
+// ============================================================================
+
+static f32 Uniform(u64 seed, u32 a, u32 b, u32 stream) {
+    const Philox4x32::Counter r = Philox4x32::Generate({a, b, stream, 0}, Philox4x32::KeyFromSeed(seed));
+    return Philox4x32::ToUniform(r[0]);
+}
+
+static f32 Gaussian(f32 x, f32 mean, f32 width) {
+    const f32 d = (x - mean) / width;
+    return std::exp(-0.5f * d * d);
+}
+
+static f32 Sigmoid(f32 x, f32 centre, f32 width) {
+    return 1.0f / (1.0f + std::exp(-(x - centre) / width));
+}
+
+// ============================================================================
+// Helper: Endmember reflectance spectra (vegetation, soil, water, concrete)
+// ============================================================================
+
+static constexpr u32 kEndmemberCount = 4;
+
+static f32 EndmemberReflectance(u32 endmember, f32 lambda) {
+    switch (endmember) {
+        case 0: {
+            // Green peak, red edge, NIR plateau with water absorption
+            const f32 visible = 0.04f + 0.08f * Gaussian(lambda, 550.0f, 35.0f);
+            const f32 nir = 0.45f * Sigmoid(lambda, 715.0f, 12.0f);
+            const f32 water = 1.0f - 0.5f * Gaussian(lambda, 1450.0f, 60.0f) - 0.6f * Gaussian(lambda, 1940.0f, 70.0f);
+            return (visible + nir) * water;
+        }
+        case 1:
+            return 0.08f + 0.30f * (lambda - 400.0f) / 2100.0f - 0.05f * Gaussian(lambda, 2200.0f, 40.0f);
+        case 2:
+            return 0.06f * std::exp(-(lambda - 400.0f) / 250.0f);
+        default:
+            return 0.28f + 0.04f * (lambda - 400.0f) / 2100.0f;
+    }
+}
+
+// ============================================================================
+// Helper: Smooth vertex normals and planar UVs
+// ============================================================================
+
+static void AddNormalsAndUvs(GeometryPrimitive& primitive) {
+    primitive.normals.assign(primitive.positions.size(), glm::vec3(0.0f));
+    for (usize i = 0; i + 2 < primitive.indices.size(); i += 3) {
+        const u32 i0 = primitive.indices[i + 0];
+        const u32 i1 = primitive.indices[i + 1];
+        const u32 i2 = primitive.indices[i + 2];
+        // Unnormalised cross product = area weighting
+        const glm::vec3 n = glm::cross(primitive.positions[i1] - primitive.positions[i0],
+                                       primitive.positions[i2] - primitive.positions[i0]);
+        primitive.normals[i0] += n;
+        primitive.normals[i1] += n;
+        primitive.normals[i2] += n;
+    }
+    for (glm::vec3& n : primitive.normals) {
+        const f32 length = glm::length(n);
+        n = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+
+    primitive.uvs.resize(primitive.positions.size());
+    for (usize i = 0; i < primitive.positions.size(); ++i) {
+        primitive.uvs[i] = glm::vec2(primitive.positions[i].x, primitive.positions[i].z) * 0.25f;
+    }
+}
+
+// ============================================================================
+// LUT / cube / image generators
+// ============================================================================
+
+AtmosphereLUT SyntheticAssets::MakeAtmosphereLut(u32 sampleCount) {
+    AtmosphereLUT lut;
+    sampleCount = std::max<u32>(sampleCount, 2);
+    lut.wavelengths.resize(sampleCount);
+    lut.solar_irradiance.resize(sampleCount);
+    lut.sky_radiance.resize(sampleCount);
+    lut.transmittance.resize(sampleCount);
+
+    // 5778 K blackbody shape (second radiation constant in nm K), peak ~1.9 W/m^2/nm
+    constexpr f32 kC2 = 1.4388e7f;
+    constexpr f32 kSunTemperature = 5778.0f;
+    auto planck = [](f32 lambda) {
+        return std::pow(lambda / 500.0f, -5.0f) / (std::exp(kC2 / (lambda * kSunTemperature)) - 1.0f);
+    };
+    const f32 peak = planck(500.0f);
+
+    for (u32 i = 0; i < sampleCount; ++i) {
+        const f32 lambda = 350.0f + 2150.0f * static_cast<f32>(i) / static_cast<f32>(sampleCount - 1);
+        const f32 rayleigh = std::pow(550.0f / lambda, 4.0f);
+        const f32 absorption = 1.2f * Gaussian(lambda, 760.0f, 4.0f) + 0.9f * Gaussian(lambda, 940.0f, 25.0f) +
+                               0.7f * Gaussian(lambda, 1140.0f, 30.0f) + 2.5f * Gaussian(lambda, 1380.0f, 40.0f) +
+                               3.0f * Gaussian(lambda, 1870.0f, 50.0f);
+        lut.wavelengths[i] = lambda;
+        lut.solar_irradiance[i] = 1.9f * planck(lambda) / peak;
+        lut.transmittance[i] = std::exp(-(0.1f * rayleigh + absorption));
+        lut.sky_radiance[i] = 0.02f * rayleigh * lut.solar_irradiance[i] * lut.transmittance[i];
+    }
+    lut.metadata["source"] = "synthetic";
+    return lut;
+}
+
+SpectralCube SyntheticAssets::MakeSpectralCube(u32 width, u32 height, u32 bandCount, u64 seed) {
+    SpectralCube cube(width, height, bandCount, 400.0f, 2500.0f);
+    cube.metadata["source"] = "synthetic";
+
+    // Endmember abundances from a smooth field (phases from the seed)
+    const u32 pixelCount = width * height;
+    std::vector<f32> abundances(static_cast<usize>(pixelCount) * kEndmemberCount);
+    f32 phases[kEndmemberCount];
+    for (u32 k = 0; k < kEndmemberCount; ++k) {
+        phases[k] = 6.2831853f * Uniform(seed, k, 0, 0);
+    }
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            const f32 fx = static_cast<f32>(x) / static_cast<f32>(width);
+            const f32 fy = static_cast<f32>(y) / static_cast<f32>(height);
+            f32* a = &abundances[(static_cast<usize>(y) * width + x) * kEndmemberCount];
+            f32 sum = 0.0f;
+            for (u32 k = 0; k < kEndmemberCount; ++k) {
+                const f32 k1 = static_cast<f32>(k + 1);
+                a[k] = std::max(0.0f, std::sin(6.2831853f * (k1 * fx + 0.5f * fy) + phases[k]) +
+                                      std::cos(6.2831853f * (0.5f * fx - k1 * fy) + phases[k]));
+                sum += a[k];
+            }
+            for (u32 k = 0; k < kEndmemberCount; ++k) {
+                a[k] = sum > 0.0f ? a[k] / sum : 1.0f / static_cast<f32>(kEndmemberCount);
+            }
+        }
+    }
+
+    for (u32 b = 0; b < bandCount; ++b) {
+        f32 reflectance[kEndmemberCount];
+        for (u32 k = 0; k < kEndmemberCount; ++k) {
+            reflectance[k] = EndmemberReflectance(k, cube.GetWavelength(b));
+        }
+        f32* band = cube.BandPtr(b);
+        for (u32 p = 0; p < pixelCount; ++p) {
+            const f32* a = &abundances[static_cast<usize>(p) * kEndmemberCount];
+            f32 value = 0.0f;
+            for (u32 k = 0; k < kEndmemberCount; ++k) {
+                value += a[k] * reflectance[k];
+            }
+            band[p] = value * (1.0f + 0.02f * (Uniform(seed, p, b, 1) - 0.5f));
+        }
+    }
+    return cube;
+}
+
+Image SyntheticAssets::MakeImage(u32 width, u32 height, u32 channels, u64 seed) {
+    Image image(width, height, channels);
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            const f32 fx = static_cast<f32>(x) / static_cast<f32>(width);
+            const f32 fy = static_cast<f32>(y) / static_cast<f32>(height);
+            for (u32 c = 0; c < channels; ++c) {
+                const f32 wave = 0.5f + 0.4f * std::sin(6.2831853f * (static_cast<f32>(c + 1) * fx + fy));
+                image(x, y, c) = wave + 0.05f * (Uniform(seed, y * width + x, c, 2) - 0.5f);
+            }
+        }
+    }
+    return image;
+}
+
+// ============================================================================
+// Scene generator
+// ============================================================================
+
+std::vector<Mesh> SyntheticAssets::MakeSceneMeshes(const SyntheticSceneDesc& desc) {
+    constexpr f32 kSpacing = 3.0f;
+    const u32 materialCount = std::max<u32>(desc.materialCount, 1);
+
+    std::vector<Mesh> meshes;
+    meshes.reserve(static_cast<usize>(desc.gridSize) * desc.gridSize + 1);
+    meshes.push_back(SceneBuilder::CreateGroundPlane(kSpacing * static_cast<f32>(desc.gridSize + 1)));
+
+    const f32 offset = 0.5f * kSpacing * static_cast<f32>(desc.gridSize - 1);
+    for (u32 gz = 0; gz < desc.gridSize; ++gz) {
+        for (u32 gx = 0; gx < desc.gridSize; ++gx) {
+            const u32 index = gz * desc.gridSize + gx;
+            const f32 jitterX = 0.6f * (Uniform(desc.seed, index, 0, 3) - 0.5f);
+            const f32 jitterZ = 0.6f * (Uniform(desc.seed, index, 1, 3) - 0.5f);
+            const f32 size = 0.6f + 1.4f * Uniform(desc.seed, index, 2, 3);
+            const f32 cx = static_cast<f32>(gx) * kSpacing - offset + jitterX;
+            const f32 cz = static_cast<f32>(gz) * kSpacing - offset + jitterZ;
+            const u32 materialId = index % materialCount;
+
+            Mesh mesh;
+            if (Uniform(desc.seed, index, 3, 3) < 0.5f) {
+                const f32 height = size * (1.0f + 2.0f * Uniform(desc.seed, index, 4, 3));
+                mesh = SceneBuilder::CreateBox(glm::vec3(size, height, size),
+                                               glm::vec3(cx, 0.5f * height, cz), materialId);
+            } else {
+                const f32 radius = 0.5f * size;
+                mesh = SceneBuilder::CreateSphere(radius, glm::vec3(cx, radius, cz),
+                                                  desc.sphereSubdivisions, materialId);
+            }
+            mesh.name = fmt::format("object_{}", index);
+            meshes.push_back(std::move(mesh));
+        }
+    }
+
+    for (Mesh& mesh : meshes) {
+        for (GeometryPrimitive& primitive : mesh.primitives) {
+            AddNormalsAndUvs(primitive);
+        }
+    }
+    return meshes;
+}
+
+// ============================================================================
+// glTF writer
+// ============================================================================
+
+namespace {
+
+// GL enums used by glTF
+constexpr u32 kFloat = 5126;
+constexpr u32 kUnsignedInt = 5125;
+constexpr u32 kArrayBuffer = 34962;
+constexpr u32 kElementArrayBuffer = 34963;
+
+struct GlbBuilder {
+    std::vector<u8> bin;
+    std::vector<String> bufferViews;
+    std::vector<String> accessors;
+
+    // Append raw data as a buffer view; returns the view index
+    u32 AddView(const void* data, usize bytes, u32 target) {
+        const usize offset = bin.size();
+        bin.resize(offset + ((bytes + 3) & ~usize(3)), 0);
+        std::memcpy(bin.data() + offset, data, bytes);
+        bufferViews.push_back(fmt::format(R"({{"buffer":0,"byteOffset":{},"byteLength":{},"target":{}}})",
+                                          offset, bytes, target));
+        return static_cast<u32>(bufferViews.size() - 1);
+    }
+
+    u32 AddAccessor(u32 view, u32 componentType, usize count, const char* type, const String& bounds = {}) {
+        accessors.push_back(fmt::format(R"({{"bufferView":{},"componentType":{},"count":{},"type":"{}"{}}})",
+                                        view, componentType, count, type, bounds));
+        return static_cast<u32>(accessors.size() - 1);
+    }
+};
+
+String Join(const std::vector<String>& items) {
+    String joined;
+    for (usize i = 0; i < items.size(); ++i) {
+        joined += (i == 0 ? "" : ",");
+        joined += items[i];
+    }
+    return joined;
+}
+
+} // namespace
+
+bool SyntheticAssets::WriteGlb(const String& path, const std::vector<Mesh>& meshes, const SyntheticSceneDesc& desc) {
+    namespace fs = std::filesystem;
+    GlbBuilder builder;
+    std::vector<String> meshJson;
+    std::vector<String> nodeJson;
+
+    for (usize m = 0; m < meshes.size(); ++m) {
+        std::vector<String> primitiveJson;
+        for (const GeometryPrimitive& primitive : meshes[m].primitives) {
+            glm::vec3 lo(std::numeric_limits<f32>::max());
+            glm::vec3 hi(-std::numeric_limits<f32>::max());
+            for (const glm::vec3& p : primitive.positions) {
+                lo = glm::min(lo, p);
+                hi = glm::max(hi, p);
+            }
+            const String bounds = fmt::format(R"(,"min":[{},{},{}],"max":[{},{},{}])", lo.x, lo.y, lo.z, hi.x, hi.y, hi.z);
+            const usize vertexCount = primitive.positions.size();
+
+            const u32 position = builder.AddAccessor(
+                builder.AddView(primitive.positions.data(), vertexCount * sizeof(glm::vec3), kArrayBuffer),
+                kFloat, vertexCount, "VEC3", bounds);
+            const u32 normal = builder.AddAccessor(
+                builder.AddView(primitive.normals.data(), vertexCount * sizeof(glm::vec3), kArrayBuffer),
+                kFloat, vertexCount, "VEC3");
+            const u32 uv = builder.AddAccessor(
+                builder.AddView(primitive.uvs.data(), vertexCount * sizeof(glm::vec2), kArrayBuffer),
+                kFloat, vertexCount, "VEC2");
+            const u32 indices = builder.AddAccessor(
+                builder.AddView(primitive.indices.data(), primitive.indices.size() * sizeof(u32), kElementArrayBuffer),
+                kUnsignedInt, primitive.indices.size(), "SCALAR");
+
+            primitiveJson.push_back(fmt::format(
+                R"({{"attributes":{{"POSITION":{},"NORMAL":{},"TEXCOORD_0":{}}},"indices":{},"material":{}}})",
+                position, normal, uv, indices, primitive.materialId));
+        }
+        meshJson.push_back(fmt::format(R"({{"name":"{}","primitives":[{}]}})", meshes[m].name, Join(primitiveJson)));
+        nodeJson.push_back(fmt::format(R"({{"name":"{}","mesh":{}}})", meshes[m].name, m));
+    }
+
+    // Materials (colours from the seed) and the optional shared texture
+    std::vector<String> materialJson;
+    const u32 materialCount = std::max<u32>(desc.materialCount, 1);
+    for (u32 i = 0; i < materialCount; ++i) {
+        materialJson.push_back(fmt::format(
+            R"({{"name":"material_{}","pbrMetallicRoughness":{{"baseColorFactor":[{},{},{},1.0],)"
+            R"("metallicFactor":0.0,"roughnessFactor":{}{}}}}})",
+            i, 0.2f + 0.8f * Uniform(desc.seed, i, 0, 4), 0.2f + 0.8f * Uniform(desc.seed, i, 1, 4),
+            0.2f + 0.8f * Uniform(desc.seed, i, 2, 4), 0.3f + 0.7f * Uniform(desc.seed, i, 3, 4),
+            desc.textured ? R"(,"baseColorTexture":{"index":0})" : ""));
+    }
+
+    String textureJson;
+    if (desc.textured) {
+        const fs::path texturePath = fs::path(path).parent_path() / (fs::path(path).stem().string() + "_albedo.png");
+        if (!ImageIO::WritePNG(texturePath.string(), MakeImage(1024, 1024, 3, desc.seed))) {
+            return false;
+        }
+        textureJson = fmt::format(R"(,"images":[{{"uri":"{}"}}],"samplers":[{{}}],"textures":[{{"source":0,"sampler":0}}])",
+                                  texturePath.filename().string());
+    }
+
+    std::vector<String> sceneNodes;
+    for (usize i = 0; i < meshes.size(); ++i) {
+        sceneNodes.push_back(std::to_string(i));
+    }
+
+    String json = fmt::format(
+        R"({{"asset":{{"version":"2.0","generator":"quantiloom_bench"}},"scene":0,"scenes":[{{"nodes":[{}]}}],)"
+        R"("nodes":[{}],"meshes":[{}],"materials":[{}],"accessors":[{}],"bufferViews":[{}],)"
+        R"("buffers":[{{"byteLength":{}}}]{}}})",
+        Join(sceneNodes), Join(nodeJson), Join(meshJson), Join(materialJson),
+        Join(builder.accessors), Join(builder.bufferViews), builder.bin.size(), textureJson);
+    json.resize((json.size() + 3) & ~usize(3), ' ');
+
+    // Header, JSON chunk, BIN chunk (all little endian)
+    const u32 totalLength = static_cast<u32>(12 + 8 + json.size() + 8 + builder.bin.size());
+    const u32 header[3] = {0x46546C67u, 2u, totalLength};   // "glTF", version 2
+    const u32 jsonChunk[2] = {static_cast<u32>(json.size()), 0x4E4F534Au};           // "JSON"
+    const u32 binChunk[2] = {static_cast<u32>(builder.bin.size()), 0x004E4942u};     // "BIN\0"
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        QL_LOG_ERROR("SyntheticAssets::WriteGlb: Cannot open {}", path);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(jsonChunk), sizeof(jsonChunk));
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    file.write(reinterpret_cast<const char*>(binChunk), sizeof(binChunk));
+    file.write(reinterpret_cast<const char*>(builder.bin.data()), static_cast<std::streamsize>(builder.bin.size()));
+    if (!file) {
+        QL_LOG_ERROR("SyntheticAssets::WriteGlb: Failed to write {}", path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace quantiloom
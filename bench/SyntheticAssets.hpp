@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Image.hpp"
+#include "core/LUT.hpp"
+#include "core/SpectralCube.hpp"
+#include "scene/Mesh.hpp"
+#include <vector>
+
+// ============================================================================
+// SyntheticAssets - Deterministic benchmark inputs
+// ============================================================================
+// Everything the benchmarks read is generated from a seed (Philox, see
+// core/CounterRng.hpp), so results are reproducible across machines and no
+// binary assets are checked in:
+//   - AtmosphereLUT      smooth solar / sky / transmittance curves with
+//                        absorption bands
+//   - SpectralCube       mixtures of four endmember spectra over a smooth
+//                        spatial field, plus 1% noise (realistic for
+//                        compression and IO)
+//   - Image              smooth gradients plus noise
+//   - glTF scenes        a ground plane and a grid of boxes and icospheres
+//                        (app/SceneBuilder.hpp) written as .glb with
+//                        normals, UVs, PBR materials and optionally one
+//                        PNG base-colour texture
+//
+// Usage:
+//   SyntheticSceneDesc desc = SyntheticSceneDesc::Medium();
+//   std::vector<Mesh> meshes = SyntheticAssets::MakeSceneMeshes(desc);
+//   SyntheticAssets::WriteGlb(dir + "/medium.glb", meshes, desc);
+// ============================================================================
+
+namespace quantiloom {
+
+struct SyntheticSceneDesc {
+    String name;
+    u32 gridSize = 4;             // Objects per side of the grid
+    u32 sphereSubdivisions = 2;   // Icosphere level (320 triangles at 2)
+    u32 materialCount = 4;
+    bool textured = false;        // Reference a generated PNG from every material
+    u64 seed = 1;
+
+    static SyntheticSceneDesc Small() { return {"small", 4, 1, 4, false, 1}; }
+    static SyntheticSceneDesc Medium() { return {"medium", 16, 2, 8, true, 2}; }
+    static SyntheticSceneDesc Large() { return {"large", 32, 3, 16, true, 3}; }
+};
+
+class SyntheticAssets {
+public:
+    // LUT over [350, 2500] nm
+    static AtmosphereLUT MakeAtmosphereLut(u32 sampleCount);
+
+    // Cube over [400, 2500] nm
+    static SpectralCube MakeSpectralCube(u32 width, u32 height, u32 bandCount, u64 seed);
+
+    static Image MakeImage(u32 width, u32 height, u32 channels, u64 seed);
+
+    // Ground plane first, then gridSize^2 boxes / spheres with jittered sizes
+    static std::vector<Mesh> MakeSceneMeshes(const SyntheticSceneDesc& desc);
+
+    // Binary glTF with one node per mesh; a textured scene also writes
+    // <stem>_albedo.png next to it
+    static bool WriteGlb(const String& path, const std::vector<Mesh>& meshes, const SyntheticSceneDesc& desc);
+};
+
+} // namespace quantiloom
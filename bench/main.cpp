@@ -0,0 +1,568 @@
+// ============================================================================
+// Quantiloom - Benchmark Suite
+// ============================================================================
+// Micro and macro benchmarks of the CPU-side hot paths, on deterministic
+// synthetic inputs (SyntheticAssets.hpp), with JSON results for CI:
+//   lut/*          AtmosphereLUT::Interpolate, sequential and random queries
+//   cube/*         SpectralCube access patterns (band-major, per-pixel spectra)
+//   spectral_io/*  SpectralIO / SpectralCubeReader / SpectralCubeWriter
+//   image_io/*     ImageIO::WriteEXR / ReadEXR
+//   gltf/*         GltfLoader on generated scenes (small, medium, large)
+//   trace/*        CPU BVH build and traversal of the same scenes
+//
+// Usage: quantiloom_bench [options]
+//   --out <file>          JSON results (default quantiloom_bench.json)
+//   --filter <substring>  Only benchmarks whose name contains it (repeatable)
+//   --list                Print benchmark names and exit
+//   --min-time <s>        Minimum measured time per benchmark (default 0.5)
+//   --min-iterations <n>  Minimum measured iterations (default 3)
+//   --quick               One iteration each, no warm-up (CI smoke run)
+//   --work-dir <dir>      Scratch directory for generated files
+//                         (default: a temporary directory, removed at exit)
+//
+// Exit code: 0 if every selected benchmark ran and the JSON was written.
+// ============================================================================
+
+#include "Benchmark.hpp"
+#include "CpuTracer.hpp"
+#include "SceneBuilder.hpp"
+#include "SyntheticAssets.hpp"
+#include "core/CounterRng.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+#include "io/GltfLoader.hpp"
+#include "io/ImageIO.hpp"
+#include "io/SpectralIO.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quantiloom;
+namespace fs = std::filesystem;
+
+// Queries per LUT iteration
+static constexpr u32 kLutQueries = 1u << 16;
+
+// Primary rays per trace iteration
+static constexpr u32 kTraceWidth = 256;
+static constexpr u32 kTraceHeight = 256;
+
+// ============================================================================
+// AtmosphereLUT
+// ============================================================================
+
+static void AddLutBenchmarks(BenchmarkSuite& suite) {
+    for (u32 samples : {256u, 4096u}) {
+        auto lut = std::make_shared<AtmosphereLUT>(SyntheticAssets::MakeAtmosphereLut(samples));
+
+        // Band sweep (what a per-band render loop does)
+        auto sequential = std::make_shared<std::vector<f32>>(kLutQueries);
+        // Scattered lookups (per-sample wavelengths)
+        auto random = std::make_shared<std::vector<f32>>(kLutQueries);
+        for (u32 i = 0; i < kLutQueries; ++i) {
+            (*sequential)[i] = 350.0f + 2150.0f * static_cast<f32>(i) / static_cast<f32>(kLutQueries);
+            const Philox4x32::Counter r = Philox4x32::Generate({i, 0, 0, 0}, Philox4x32::KeyFromSeed(7));
+            (*random)[i] = 350.0f + 2150.0f * Philox4x32::ToUniform(r[0]);
+        }
+
+        for (const auto& [kind, queries] : {std::pair{"sequential", sequential}, std::pair{"random", random}}) {
+            suite.Add({
+                .name = fmt::format("lut/interpolate/{}/{}", kind, samples),
+                .run = [lut, queries] {
+                    f64 sum = 0.0;
+                    for (f32 lambda : *queries) {
+                        sum += lut->GetSolarIrradiance(lambda) * lut->GetTransmittance(lambda);
+                    }
+                    KeepAlive(sum);
+                },
+                .items = 2ull * kLutQueries,
+            });
+        }
+    }
+}
+
+// ============================================================================
+// SpectralCube access patterns
+// ============================================================================
+
+static void AddCubeBenchmarks(BenchmarkSuite& suite) {
+    static constexpr u32 kWidth = 256;
+    static constexpr u32 kHeight = 256;
+    static constexpr u32 kBands = 128;
+    static constexpr u64 kBytes = u64(kWidth) * kHeight * kBands * sizeof(f32);
+    auto cube = std::make_shared<SpectralCube>();
+    auto setup = [cube] {
+        if (!cube->IsValid()) {
+            *cube = SyntheticAssets::MakeSpectralCube(kWidth, kHeight, kBands, 11);
+        }
+        return true;
+    };
+
+    // Contiguous band planes (storage order)
+    suite.Add({
+        .name = "cube/band_major/bandptr",
+        .setup = setup,
+        .run = [cube] {
+            f64 sum = 0.0;
+            for (u32 b = 0; b < cube->nbands; ++b) {
+                const f32* band = cube->BandPtr(b);
+                f32 bandSum = 0.0f;
+                for (u32 p = 0; p < cube->PixelsPerBand(); ++p) {
+                    bandSum += band[p];
+                }
+                sum += bandSum;
+            }
+            KeepAlive(sum);
+        },
+        .bytes = kBytes,
+    });
+
+    // Same order through operator() (index arithmetic per element)
+    suite.Add({
+        .name = "cube/band_major/operator",
+        .setup = setup,
+        .run = [cube] {
+            f64 sum = 0.0;
+            for (u32 b = 0; b < cube->nbands; ++b) {
+                f32 bandSum = 0.0f;
+                for (u32 y = 0; y < cube->height; ++y) {
+                    for (u32 x = 0; x < cube->width; ++x) {
+                        bandSum += (*cube)(x, y, b);
+                    }
+                }
+                sum += bandSum;
+            }
+            KeepAlive(sum);
+        },
+        .bytes = kBytes,
+    });
+
+    // Whole spectrum per pixel (strided by a band plane)
+    suite.Add({
+        .name = "cube/pixel_spectra/operator",
+        .setup = setup,
+        .run = [cube] {
+            f64 sum = 0.0;
+            for (u32 y = 0; y < cube->height; ++y) {
+                for (u32 x = 0; x < cube->width; ++x) {
+                    f32 pixelSum = 0.0f;
+                    for (u32 b = 0; b < cube->nbands; ++b) {
+                        pixelSum += (*cube)(x, y, b);
+                    }
+                    sum += pixelSum;
+                }
+            }
+            KeepAlive(sum);
+        },
+        .bytes = kBytes,
+    });
+
+    // Per-pixel spectra gathered one row at a time (band planes stream)
+    suite.Add({
+        .name = "cube/pixel_spectra/row_gather",
+        .setup = setup,
+        .run = [cube] {
+            std::vector<f32> row(static_cast<usize>(cube->width) * cube->nbands);
+            f64 sum = 0.0;
+            for (u32 y = 0; y < cube->height; ++y) {
+                for (u32 b = 0; b < cube->nbands; ++b) {
+                    const f32* src = cube->BandPtr(b) + static_cast<usize>(y) * cube->width;
+                    for (u32 x = 0; x < cube->width; ++x) {
+                        row[static_cast<usize>(x) * cube->nbands + b] = src[x];
+                    }
+                }
+                for (u32 x = 0; x < cube->width; ++x) {
+                    f32 pixelSum = 0.0f;
+                    for (u32 b = 0; b < cube->nbands; ++b) {
+                        pixelSum += row[static_cast<usize>(x) * cube->nbands + b];
+                    }
+                    sum += pixelSum;
+                }
+            }
+            KeepAlive(sum);
+        },
+        .bytes = kBytes,
+    });
+}
+
+// ============================================================================
+// SpectralIO
+// ============================================================================
+
+static void AddSpectralIoBenchmarks(BenchmarkSuite& suite, const fs::path& workDir) {
+    static constexpr u32 kWidth = 256;
+    static constexpr u32 kHeight = 256;
+    static constexpr u32 kBands = 64;
+    static constexpr u32 kChunkBands = 16;
+    static constexpr u64 kBytes = u64(kWidth) * kHeight * kBands * sizeof(f32);
+    auto cube = std::make_shared<SpectralCube>();
+    const String writePath = (workDir / "write.h5").string();
+    const String readPath = (workDir / "read.h5").string();
+
+    // The read benchmarks share one file written in setup
+    auto setup = [cube, readPath] {
+        if (!cube->IsValid()) {
+            *cube = SyntheticAssets::MakeSpectralCube(kWidth, kHeight, kBands, 13);
+        }
+        return fs::exists(readPath) || SpectralIO::WriteHDF5(readPath, *cube);
+    };
+    auto removeWritten = [writePath] { fs::remove(writePath); };
+
+    for (const auto& [format, formatName] : {std::pair{PixelFormat::F32, "f32"}, std::pair{PixelFormat::F16, "f16"},
+                                             std::pair{PixelFormat::U16, "u16"}}) {
+        suite.Add({
+            .name = fmt::format("spectral_io/write_hdf5/{}", formatName),
+            .setup = setup,
+            .run = [cube, writePath, format = format] { SpectralIO::WriteHDF5(writePath, *cube, format); },
+            .teardown = removeWritten,
+            .bytes = kBytes,
+        });
+    }
+
+    suite.Add({
+        .name = "spectral_io/write_compressed",
+        .setup = setup,
+        .run = [cube, writePath] {
+            SpectralPcaSettings settings;
+            settings.maxRelativeRmse = 1e-2f;
+            SpectralIO::WriteCompressedHDF5(writePath, *cube, settings);
+        },
+        .teardown = removeWritten,
+        .bytes = kBytes,
+    });
+
+    suite.Add({
+        .name = "spectral_io/writer_bands/chunk16",
+        .setup = setup,
+        .run = [cube, writePath] {
+            SpectralCubeWriter writer;
+            if (!writer.Open(writePath, *cube)) {
+                return;
+            }
+            for (u32 b = 0; b < cube->nbands; b += kChunkBands) {
+                writer.WriteBands(b, std::min(kChunkBands, cube->nbands - b), cube->BandPtr(b));
+            }
+            writer.Close();
+        },
+        .teardown = removeWritten,
+        .bytes = kBytes,
+    });
+
+    suite.Add({
+        .name = "spectral_io/read_hdf5",
+        .setup = setup,
+        .run = [readPath] {
+            std::optional<SpectralCube> loaded = SpectralIO::ReadHDF5(readPath);
+            KeepAlive(loaded ? loaded->data[0] : 0.0);
+        },
+        .bytes = kBytes,
+    });
+
+    suite.Add({
+        .name = "spectral_io/read_region/64x64",
+        .setup = setup,
+        .run = [readPath] {
+            std::optional<SpectralCube> region = SpectralIO::ReadRegion(readPath, 96, 96, 64, 64);
+            KeepAlive(region ? region->data[0] : 0.0);
+        },
+        .bytes = u64(64) * 64 * kBands * sizeof(f32),
+    });
+
+    suite.Add({
+        .name = "spectral_io/reader_bands/chunk16",
+        .setup = setup,
+        .run = [readPath] {
+            SpectralCubeReader reader;
+            if (!reader.Open(readPath)) {
+                return;
+            }
+            const SpectralCube& header = reader.GetHeader();
+            std::vector<f32> chunk(static_cast<usize>(kChunkBands) * header.PixelsPerBand());
+            for (u32 b = 0; b < header.nbands; b += kChunkBands) {
+                reader.ReadBands(b, std::min(kChunkBands, header.nbands - b), chunk.data());
+            }
+            KeepAlive(chunk[0]);
+        },
+        .bytes = kBytes,
+    });
+}
+
+// ============================================================================
+// ImageIO
+// ============================================================================
+
+static void AddImageIoBenchmarks(BenchmarkSuite& suite, const fs::path& workDir) {
+    static constexpr u32 kSize = 1024;
+    static constexpr u32 kChannels = 4;
+    static constexpr u64 kBytes = u64(kSize) * kSize * kChannels * sizeof(f32);
+    auto image = std::make_shared<Image>();
+    const String writePath = (workDir / "write.exr").string();
+    const String readPath = (workDir / "read.exr").string();
+
+    auto setup = [image, readPath] {
+        if (!image->IsValid()) {
+            *image = SyntheticAssets::MakeImage(kSize, kSize, kChannels, 17);
+        }
+        return fs::exists(readPath) || ImageIO::WriteEXR(readPath, *image);
+    };
+    auto removeWritten = [writePath] { fs::remove(writePath); };
+
+    for (const auto& [format, formatName] : {std::pair{PixelFormat::F32, "f32"}, std::pair{PixelFormat::F16, "f16"}}) {
+        suite.Add({
+            .name = fmt::format("image_io/write_exr/{}", formatName),
+            .setup = setup,
+            .run = [image, writePath, format = format] { ImageIO::WriteEXR(writePath, *image, format); },
+            .teardown = removeWritten,
+            .bytes = kBytes,
+        });
+    }
+
+    suite.Add({
+        .name = "image_io/read_exr",
+        .setup = setup,
+        .run = [readPath] {
+            std::optional<Image> loaded = ImageIO::ReadEXR(readPath);
+            KeepAlive(loaded ? loaded->data[0] : 0.0);
+        },
+        .bytes = kBytes,
+    });
+}
+
+// ============================================================================
+// glTF loading and CPU traversal of the synthetic scenes
+// ============================================================================
+
+namespace {
+
+// Generated once per scene, on first use
+struct SceneFixture {
+    SyntheticSceneDesc desc;
+    String glbPath;
+    std::vector<Mesh> meshes;
+    Mesh merged;
+    bool written = false;
+
+    CpuTracer tracer;
+    glm::vec3 cameraEye = glm::vec3(0.0f);
+    std::vector<glm::vec3> rayDirections;   // Primary rays (row-major)
+    std::vector<glm::vec3> shadowOrigins;   // Sun visibility grid on the ground
+    bool traceable = false;
+
+    bool Prepare() {
+        if (written) {
+            return true;
+        }
+        meshes = SyntheticAssets::MakeSceneMeshes(desc);
+        merged = SceneBuilder::MergeMeshes(meshes);
+        written = SyntheticAssets::WriteGlb(glbPath, meshes, desc);
+        return written;
+    }
+
+    bool PrepareTracing() {
+        if (!Prepare()) {
+            return false;
+        }
+        if (traceable) {
+            return true;
+        }
+        tracer.Build(merged);
+        traceable = true;
+
+        // Pinhole camera looking over the grid
+        const f32 extent = 1.5f * static_cast<f32>(desc.gridSize);
+        cameraEye = glm::vec3(0.0f, 0.6f * extent + 2.0f, -1.4f * extent - 4.0f);
+        const glm::vec3 forward = glm::normalize(glm::vec3(0.0f, 0.5f, 0.0f) - cameraEye);
+        const glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+        const glm::vec3 up = glm::cross(right, forward);
+        const f32 tanHalfFov = 0.5773503f;  // 60 degrees vertical
+        rayDirections.resize(static_cast<usize>(kTraceWidth) * kTraceHeight);
+        for (u32 y = 0; y < kTraceHeight; ++y) {
+            for (u32 x = 0; x < kTraceWidth; ++x) {
+                const f32 sx = (2.0f * (static_cast<f32>(x) + 0.5f) / kTraceWidth - 1.0f) * tanHalfFov;
+                const f32 sy = (1.0f - 2.0f * (static_cast<f32>(y) + 0.5f) / kTraceHeight) * tanHalfFov;
+                rayDirections[static_cast<usize>(y) * kTraceWidth + x] = glm::normalize(forward + sx * right + sy * up);
+            }
+        }
+
+        // Same number of points as primary rays, just above the ground
+        shadowOrigins.resize(rayDirections.size());
+        for (u32 y = 0; y < kTraceHeight; ++y) {
+            for (u32 x = 0; x < kTraceWidth; ++x) {
+                shadowOrigins[static_cast<usize>(y) * kTraceWidth + x] = glm::vec3(
+                    extent * (2.0f * (static_cast<f32>(x) + 0.5f) / kTraceWidth - 1.0f), 1e-3f,
+                    extent * (2.0f * (static_cast<f32>(y) + 0.5f) / kTraceHeight - 1.0f));
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+static void AddSceneBenchmarks(BenchmarkSuite& suite, const fs::path& workDir) {
+    const glm::vec3 toSun = LightingConfig::Standard3Point().sunDirection;
+
+    for (const SyntheticSceneDesc& desc :
+         {SyntheticSceneDesc::Small(), SyntheticSceneDesc::Medium(), SyntheticSceneDesc::Large()}) {
+        auto fixture = std::make_shared<SceneFixture>();
+        fixture->desc = desc;
+        fixture->glbPath = (workDir / (desc.name + ".glb")).string();
+
+        // Geometry, materials and texture decode only
+        suite.Add({
+            .name = fmt::format("gltf/load/{}", desc.name),
+            .setup = [fixture] { return fixture->Prepare(); },
+            .run = [fixture] {
+                GltfLoadOptions options;
+                options.generateMips = false;
+                auto result = GltfLoader::LoadFromFile(fixture->glbPath, options);
+                KeepAlive(result.has_value() ? static_cast<f64>(result.value().meshes.size()) : 0.0);
+            },
+            .items = desc.gridSize * desc.gridSize + 1ull,
+        });
+
+        // Default texture processing (mip chains) on top
+        if (desc.textured) {
+            suite.Add({
+                .name = fmt::format("gltf/load_with_mips/{}", desc.name),
+                .setup = [fixture] { return fixture->Prepare(); },
+                .run = [fixture] {
+                    auto result = GltfLoader::LoadFromFile(fixture->glbPath);
+                    KeepAlive(result.has_value() ? static_cast<f64>(result.value().meshes.size()) : 0.0);
+                },
+                .items = desc.gridSize * desc.gridSize + 1ull,
+            });
+        }
+
+        suite.Add({
+            .name = fmt::format("trace/bvh_build/{}", desc.name),
+            .setup = [fixture] { return fixture->Prepare(); },
+            .run = [fixture] {
+                CpuTracer tracer;
+                tracer.Build(fixture->merged);
+                KeepAlive(static_cast<f64>(tracer.NodeCount()));
+            },
+        });
+
+        suite.Add({
+            .name = fmt::format("trace/primary/{}", desc.name),
+            .setup = [fixture] { return fixture->PrepareTracing(); },
+            .run = [fixture] {
+                f64 sum = 0.0;
+                for (const glm::vec3& direction : fixture->rayDirections) {
+                    sum += fixture->tracer.Intersect(fixture->cameraEye, direction).t;
+                }
+                KeepAlive(sum);
+            },
+            .items = u64(kTraceWidth) * kTraceHeight,
+        });
+
+        suite.Add({
+            .name = fmt::format("trace/primary_parallel/{}", desc.name),
+            .setup = [fixture] { return fixture->PrepareTracing(); },
+            .run = [fixture] {
+                std::vector<f32> rowSums(kTraceHeight, 0.0f);
+                ParallelFor(kTraceHeight, 4, [&](usize y) {
+                    f32 rowSum = 0.0f;
+                    for (u32 x = 0; x < kTraceWidth; ++x) {
+                        rowSum += fixture->tracer.Intersect(fixture->cameraEye,
+                                                            fixture->rayDirections[y * kTraceWidth + x]).t;
+                    }
+                    rowSums[y] = rowSum;
+                });
+                KeepAlive(rowSums[0]);
+            },
+            .items = u64(kTraceWidth) * kTraceHeight,
+        });
+
+        suite.Add({
+            .name = fmt::format("trace/shadow/{}", desc.name),
+            .setup = [fixture] { return fixture->PrepareTracing(); },
+            .run = [fixture, toSun] {
+                u32 blocked = 0;
+                for (const glm::vec3& origin : fixture->shadowOrigins) {
+                    blocked += fixture->tracer.Occluded(origin, toSun, 1e-3f) ? 1u : 0u;
+                }
+                KeepAlive(static_cast<f64>(blocked));
+            },
+            .items = u64(kTraceWidth) * kTraceHeight,
+        });
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    Log::Init(nullptr, Log::Level::Info);
+
+    String outPath = "quantiloom_bench.json";
+    String workDirArg;
+    bool list = false;
+    BenchmarkSettings settings;
+    for (int i = 1; i < argc; ++i) {
+        const String arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            settings.filters.emplace_back(argv[++i]);
+        } else if (arg == "--list") {
+            list = true;
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            settings.minTimeSeconds = std::stod(argv[++i]);
+        } else if (arg == "--min-iterations" && i + 1 < argc) {
+            settings.minIterations = static_cast<u32>(std::stoul(argv[++i]));
+        } else if (arg == "--quick") {
+            settings.minTimeSeconds = 0.0;
+            settings.minIterations = 1;
+            settings.warmupIterations = 0;
+        } else if (arg == "--work-dir" && i + 1 < argc) {
+            workDirArg = argv[++i];
+        } else {
+            QL_LOG_WARN("Ignoring unknown argument '{}'", arg);
+        }
+    }
+
+    const bool temporaryWorkDir = workDirArg.empty();
+    const fs::path workDir = temporaryWorkDir
+        ? fs::temp_directory_path() / fmt::format("quantiloom_bench_{:08x}", std::random_device{}())
+        : fs::path(workDirArg);
+
+    BenchmarkSuite suite;
+    AddLutBenchmarks(suite);
+    AddCubeBenchmarks(suite);
+    AddSpectralIoBenchmarks(suite, workDir);
+    AddImageIoBenchmarks(suite, workDir);
+    AddSceneBenchmarks(suite, workDir);
+
+    if (list) {
+        for (const String& name : suite.Names()) {
+            QL_LOG_INFO("{}", name);
+        }
+        Log::Shutdown();
+        return 0;
+    }
+
+    std::error_code ec;
+    fs::create_directories(workDir, ec);
+    if (ec) {
+        QL_LOG_ERROR("Cannot create work directory {}: {}", workDir.string(), ec.message());
+        Log::Shutdown();
+        return 1;
+    }
+
+    QL_LOG_INFO("Running benchmarks (work directory {})", workDir.string());
+    bool passed = suite.Run(settings);
+    passed = suite.WriteJson(outPath, settings) && passed;
+
+    if (temporaryWorkDir) {
+        fs::remove_all(workDir, ec);
+    }
+    Log::Shutdown();
+    return passed ? 0 : 1;
+}
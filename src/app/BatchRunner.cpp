@@ -0,0 +1,223 @@
+#include "BatchRunner.hpp"
+#include "RenderSession.hpp"
+#include "Json.hpp"
+#include "core/Log.hpp"
+#include "core/Profiler.hpp"
+#include "renderer/VulkanContext.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace quantiloom {
+
+// ============================================================================
+// BatchManifest
+// ============================================================================
+
+Result<BatchManifest, String> BatchManifest::Load(const std::filesystem::path& path) {
+    using R = Result<BatchManifest, String>;
+
+    auto manifestResult = Config::Load(path);
+    if (!manifestResult.has_value()) {
+        return R::Err(manifestResult.error());
+    }
+
+    BatchManifest manifest;
+    manifest.settings = manifestResult.value();
+    const Config& settings = manifest.settings;
+    const std::filesystem::path manifestDir = path.parent_path();
+
+    // Relative paths in the manifest are relative to the manifest
+    auto resolve = [&manifestDir](const String& file) {
+        const std::filesystem::path p(file);
+        return (p.is_absolute() || manifestDir.empty()) ? p : manifestDir / p;
+    };
+
+    const String defaultBase = settings.Get<String>("batch.base", "");
+    const std::filesystem::path outputDir = settings.Get<String>("batch.output_dir", "batch_output");
+    manifest.timingsPath = settings.Get<String>("batch.timings", "batch_timings.jsonl");
+
+    const toml::array* jobs = settings.GetRoot()["jobs"].as_array();
+    if (!jobs || jobs->empty()) {
+        return R::Err("Manifest has no [[jobs]]: " + path.string());
+    }
+
+    // Base configs, loaded once per file
+    std::map<std::filesystem::path, Config> bases;
+    std::set<String> names;
+
+    for (usize i = 0; i < jobs->size(); ++i) {
+        const toml::table* entry = (*jobs)[i].as_table();
+        if (!entry) {
+            return R::Err(fmt::format("jobs[{}] is not a table", i));
+        }
+        const Config overrides = Config::FromTable(*entry);
+
+        BatchJob job;
+        job.index = i;
+        job.name = overrides.Get<String>("name", fmt::format("job{:04}", i));
+        if (!names.insert(job.name).second) {
+            return R::Err(fmt::format("jobs[{}]: Duplicate job name '{}'", i, job.name));
+        }
+
+        const String baseName = overrides.Get<String>("base", defaultBase);
+        Config base;
+        if (!baseName.empty()) {
+            const std::filesystem::path basePath = resolve(baseName);
+            auto it = bases.find(basePath);
+            if (it == bases.end()) {
+                auto baseResult = Config::Load(basePath);
+                if (!baseResult.has_value()) {
+                    return R::Err(fmt::format("jobs[{}] ({}): {}", i, job.name, baseResult.error()));
+                }
+                it = bases.emplace(basePath, baseResult.value()).first;
+            }
+            base = it->second;
+        }
+        job.config = base.WithOverrides(overrides);
+
+        // Without an explicit output every job would write the base's file
+        if (!overrides.Has("renderer.output")) {
+            const bool hsOff = job.config.Get<String>("spectral.mode", "single_wavelength") == "hs_off";
+            const String output = (outputDir / (job.name + (hsOff ? ".h5" : ".exr"))).string();
+            toml::table outputTable;
+            outputTable.insert_or_assign("renderer", toml::table{{"output", output}});
+            job.config = job.config.WithOverrides(Config::FromTable(outputTable));
+        }
+
+        job.sceneKey = GpuScene::Key(job.config);
+        manifest.jobs.push_back(std::move(job));
+    }
+
+    QL_LOG_INFO("Loaded batch manifest {}: {} job(s)", path.string(), manifest.jobs.size());
+    return manifest;
+}
+
+// ============================================================================
+// BatchRunner
+// ============================================================================
+
+bool BatchRunner::Run(const BatchManifest& manifest) {
+    using Clock = std::chrono::steady_clock;
+    QL_PROFILE_SCOPE("BatchRunner::Run");
+
+    std::ofstream timings(manifest.timingsPath, std::ios::binary);
+    if (!timings) {
+        QL_LOG_ERROR("BatchRunner::Run: Cannot open {}", manifest.timingsPath);
+        return false;
+    }
+
+    // Scene groups in order of first appearance
+    std::vector<std::vector<const BatchJob*>> groups;
+    std::map<String, usize> groupIndex;
+    for (const BatchJob& job : manifest.jobs) {
+        auto [it, inserted] = groupIndex.emplace(job.sceneKey, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(&job);
+    }
+    QL_LOG_INFO("Batch: {} job(s) over {} scene(s)", manifest.jobs.size(), groups.size());
+
+    usize succeeded = 0;
+    usize failed = 0;
+    auto writeRecord = [&](const BatchJob& job, const String& sceneName, const RenderStats& stats, f64 sceneLoadSeconds) {
+        timings << fmt::format("{{\"index\": {}, \"name\": \"{}\", \"scene\": \"{}\", \"status\": \"{}\", ",
+                               job.index, JsonEscape(job.name), JsonEscape(sceneName),
+                               stats.succeeded ? "ok" : "failed");
+        if (!stats.succeeded) {
+            timings << fmt::format("\"error\": \"{}\", ", JsonEscape(stats.error));
+        }
+        timings << fmt::format("\"output\": \"{}\", \"width\": {}, \"height\": {}, \"bands\": {}, "
+                               "\"scene_load_s\": {:.6f}, \"update_s\": {:.6f}, \"render_s\": {:.6f}, "
+                               "\"readback_s\": {:.6f}, \"finish_s\": {:.6f}, \"total_s\": {:.6f}}}\n",
+                               JsonEscape(stats.outputPath), stats.width, stats.height, stats.bandCount,
+                               sceneLoadSeconds, stats.updateSeconds, stats.renderSeconds,
+                               stats.readbackSeconds, stats.finishSeconds, stats.totalSeconds);
+        timings.flush();
+        ++(stats.succeeded ? succeeded : failed);
+    };
+    auto failJob = [&](const BatchJob& job, const String& sceneName, const String& error) {
+        QL_LOG_ERROR("  [FAIL] {}: {}", job.name, error);
+        RenderStats stats;
+        stats.jobName = job.name;
+        stats.error = error;
+        writeRecord(job, sceneName, stats, 0.0);
+    };
+
+    QL_LOG_INFO("Initializing Vulkan context...");
+    VulkanContext context;
+    if (!context.IsRayTracingSupported()) {
+        QL_LOG_ERROR("Ray tracing not supported on this device");
+        return false;
+    }
+    RenderSession session(context);
+
+    for (const auto& group : groups) {
+        // Parse every job first: invalid ones fail without loading the scene
+        std::vector<std::pair<const BatchJob*, RenderJob>> renderJobs;
+        for (const BatchJob* job : group) {
+            auto renderJob = RenderJob::FromConfig(job->config);
+            if (!renderJob.has_value()) {
+                failJob(*job, "", renderJob.error());
+                continue;
+            }
+            renderJob.value().name = job->name;
+            renderJobs.emplace_back(job, std::move(renderJob.value()));
+        }
+        if (renderJobs.empty()) {
+            continue;
+        }
+
+        // Same-resolution, same-band jobs back to back (images and band
+        // tables are kept between them)
+        std::stable_sort(renderJobs.begin(), renderJobs.end(), [](const auto& a, const auto& b) {
+            const RenderJob& x = a.second;
+            const RenderJob& y = b.second;
+            return std::make_tuple(x.width, x.height, x.bands.size(), x.bands.front().center_nm) <
+                   std::make_tuple(y.width, y.height, y.bands.size(), y.bands.front().center_nm);
+        });
+
+        const Clock::time_point loadStart = Clock::now();
+        auto sceneResult = GpuScene::Load(context, renderJobs.front().first->config);
+        const f64 sceneLoadSeconds = std::chrono::duration<f64>(Clock::now() - loadStart).count();
+        if (!sceneResult.has_value()) {
+            for (const auto& [job, renderJob] : renderJobs) {
+                failJob(*job, "", "Failed to load scene: " + sceneResult.error());
+            }
+            continue;
+        }
+        std::unique_ptr<GpuScene> scene = std::move(sceneResult.value());
+        const String sceneName = scene->GetName();
+        QL_LOG_INFO("Scene '{}': {} job(s), loaded in {:.2f} s", sceneName, renderJobs.size(), sceneLoadSeconds);
+
+        bool firstJob = true;
+        for (const auto& [job, renderJob] : renderJobs) {
+            QL_LOG_INFO("Job {} ({}/{}): {}", job->name, job->index + 1, manifest.jobs.size(), renderJob.outputPath);
+            const f64 loadSeconds = firstJob ? sceneLoadSeconds : 0.0;
+            firstJob = false;
+            const BatchJob* batchJob = job;
+            try {
+                session.Render(*scene, renderJob, [&, batchJob, loadSeconds](const RenderStats& stats) {
+                    writeRecord(*batchJob, sceneName, stats, loadSeconds);
+                });
+            } catch (const std::exception& e) {
+                // Already recorded as failed; later jobs may still succeed
+                QL_LOG_ERROR("  Job {} aborted: {}", job->name, e.what());
+            }
+        }
+
+        // The scene is released before the next group loads
+        session.Finish();
+    }
+
+    QL_LOG_INFO("Batch finished: {} succeeded, {} failed (timings: {})",
+                succeeded, failed, manifest.timingsPath);
+    return failed == 0;
+}
+
+} // namespace quantiloom
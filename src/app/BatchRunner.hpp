@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Config.hpp"
+
+#include <filesystem>
+#include <vector>
+
+// ============================================================================
+// BatchRunner - Many render jobs from one manifest in one process
+// ============================================================================
+// Manifest (TOML):
+//   [batch]
+//   base = "spectral_single.toml"     # Config every job starts from
+//                                     # (relative paths: to the manifest)
+//   output_dir = "batch_output"       # Default output: <dir>/<name>.exr|.h5
+//   timings = "batch_timings.jsonl"   # One JSON record per job
+//
+//   [[jobs]]
+//   name = "noon_550"
+//   spectral.wavelength_nm = 550.0    # Any config key, merged over the base
+//   lighting.sun_direction = [0.0, 1.0, 0.0]
+//
+//   [[jobs]]
+//   base = "other_scene.toml"         # Per-job base
+//   camera.position = [1.0, 2.0, -6.0]
+//
+// [threads] and [profiling] of the manifest configure the process.
+//
+// Scheduling: jobs are grouped by GpuScene::Key() (in order of first
+// appearance). Each group loads and uploads its scene once and runs its jobs
+// ordered by resolution and bands, so output images and band tables are
+// reused; one VulkanContext and RenderSession serve the whole batch. The
+// post-processing and writing of a job's last band overlap the rendering of
+// the next job's first band (not across scene groups).
+//
+// Timing records (JSON lines, written as jobs complete):
+//   {"index": 0, "name": "noon_550", "scene": "cornell_box", "status": "ok",
+//    "output": "...", "width": 1280, "height": 720, "bands": 1,
+//    "scene_load_s": ..., "update_s": ..., "render_s": ..., "readback_s": ...,
+//    "finish_s": ..., "total_s": ...}
+// scene_load_s is non-zero only for the first job of a scene group.
+//
+// Usage:
+//   auto manifest = BatchManifest::Load("jobs.toml");
+//   bool ok = BatchRunner::Run(manifest.value());
+// ============================================================================
+
+namespace quantiloom {
+
+struct BatchJob {
+    usize index = 0;      // Position in the manifest
+    String name;
+    Config config;        // Base merged with the job's entries
+    String sceneKey;      // GpuScene::Key(config)
+};
+
+struct BatchManifest {
+    Config settings;      // The manifest itself ([threads], [profiling])
+    std::vector<BatchJob> jobs;
+    String timingsPath;
+
+    static Result<BatchManifest, String> Load(const std::filesystem::path& path);
+};
+
+class BatchRunner {
+public:
+    // Render every job; false if any job failed
+    static bool Run(const BatchManifest& manifest);
+};
+
+} // namespace quantiloom
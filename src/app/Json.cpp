@@ -0,0 +1,315 @@
+#include "Json.hpp"
+#include "core/Log.hpp"
+
+#include <cctype>
+#include <charconv>
+
+namespace quantiloom {
+
+String JsonEscape(const String& text) {
+    String escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+// ============================================================================
+// Helper: recursive-descent parser
+// ============================================================================
+
+namespace {
+
+class JsonParser {
+public:
+    explicit JsonParser(const String& text) : m_text(text) {}
+
+    Result<toml::table, String> ParseDocument() {
+        using R = Result<toml::table, String>;
+        SkipWhitespace();
+        toml::table table;
+        if (!ParseObject(table, 0)) {
+            return R::Err(m_error);
+        }
+        SkipWhitespace();
+        if (m_pos != m_text.size()) {
+            return R::Err(fmt::format("JSON: Unexpected data at offset {}", m_pos));
+        }
+        return table;
+    }
+
+private:
+    static constexpr u32 MAX_DEPTH = 64;
+
+    bool Fail(const char* what) {
+        if (m_error.empty()) {
+            m_error = fmt::format("JSON: {} at offset {}", what, m_pos);
+        }
+        return false;
+    }
+
+    void SkipWhitespace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            ++m_pos;
+        }
+    }
+
+    bool Consume(char c) {
+        SkipWhitespace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool ConsumeWord(StringView word) {
+        if (m_text.compare(m_pos, word.size(), word) == 0) {
+            m_pos += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    static void AppendUtf8(String& out, u32 cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    bool ParseHex4(u32& value) {
+        if (m_pos + 4 > m_text.size()) {
+            return Fail("Truncated \\u escape");
+        }
+        const char* first = m_text.data() + m_pos;
+        auto [ptr, ec] = std::from_chars(first, first + 4, value, 16);
+        if (ec != std::errc() || ptr != first + 4) {
+            return Fail("Invalid \\u escape");
+        }
+        m_pos += 4;
+        return true;
+    }
+
+    bool ParseString(String& out) {
+        SkipWhitespace();
+        if (m_pos >= m_text.size() || m_text[m_pos] != '"') {
+            return Fail("Expected string");
+        }
+        ++m_pos;
+        while (m_pos < m_text.size()) {
+            const char c = m_text[m_pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_pos >= m_text.size()) {
+                break;
+            }
+            const char e = m_text[m_pos++];
+            switch (e) {
+                case '"':  out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    u32 cp = 0;
+                    if (!ParseHex4(cp)) {
+                        return false;
+                    }
+                    // Surrogate pair
+                    if (cp >= 0xD800 && cp < 0xDC00 && ConsumeWord("\\u")) {
+                        u32 low = 0;
+                        if (!ParseHex4(low)) {
+                            return false;
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return Fail("Invalid escape");
+            }
+        }
+        return Fail("Unterminated string");
+    }
+
+    // Number as int64 when it has no fraction or exponent, else double
+    bool ParseNumber(toml::array& out) {
+        const usize start = m_pos;
+        bool isInteger = true;
+        if (m_pos < m_text.size() && m_text[m_pos] == '-') {
+            ++m_pos;
+        }
+        while (m_pos < m_text.size()) {
+            const char c = m_text[m_pos];
+            if (std::isdigit(static_cast<unsigned char>(c))) {
+                ++m_pos;
+            } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                isInteger = false;
+                ++m_pos;
+            } else {
+                break;
+            }
+        }
+        const char* first = m_text.data() + start;
+        const char* last = m_text.data() + m_pos;
+        if (isInteger) {
+            i64 value = 0;
+            auto [ptr, ec] = std::from_chars(first, last, value);
+            if (ec == std::errc() && ptr == last) {
+                out.push_back(value);
+                return true;
+            }
+        }
+        // from_chars for floating point is not available everywhere yet
+        try {
+            usize used = 0;
+            const f64 value = std::stod(String(first, last), &used);
+            if (used == static_cast<usize>(last - first)) {
+                out.push_back(value);
+                return true;
+            }
+        } catch (const std::exception&) {
+        }
+        m_pos = start;
+        return Fail("Invalid number");
+    }
+
+    // Parse one value and append it to out (null appends nothing)
+    bool ParseValue(toml::array& out, u32 depth) {
+        if (depth > MAX_DEPTH) {
+            return Fail("Nesting too deep");
+        }
+        SkipWhitespace();
+        if (m_pos >= m_text.size()) {
+            return Fail("Unexpected end of input");
+        }
+        const char c = m_text[m_pos];
+        if (c == '{') {
+            toml::table table;
+            if (!ParseObject(table, depth + 1)) {
+                return false;
+            }
+            out.push_back(std::move(table));
+            return true;
+        }
+        if (c == '[') {
+            toml::array array;
+            if (!ParseArray(array, depth + 1)) {
+                return false;
+            }
+            out.push_back(std::move(array));
+            return true;
+        }
+        if (c == '"') {
+            String text;
+            if (!ParseString(text)) {
+                return false;
+            }
+            out.push_back(std::move(text));
+            return true;
+        }
+        if (ConsumeWord("true")) {
+            out.push_back(true);
+            return true;
+        }
+        if (ConsumeWord("false")) {
+            out.push_back(false);
+            return true;
+        }
+        if (ConsumeWord("null")) {
+            return true;
+        }
+        return ParseNumber(out);
+    }
+
+    bool ParseObject(toml::table& table, u32 depth) {
+        if (!Consume('{')) {
+            return Fail("Expected object");
+        }
+        if (Consume('}')) {
+            return true;
+        }
+        do {
+            String key;
+            if (!ParseString(key)) {
+                return false;
+            }
+            if (!Consume(':')) {
+                return Fail("Expected ':'");
+            }
+            toml::array value;
+            if (!ParseValue(value, depth)) {
+                return false;
+            }
+            if (!value.empty()) {
+                value.get(0)->visit([&](auto& v) { table.insert_or_assign(key, std::move(v)); });
+            }
+        } while (Consume(','));
+        if (!Consume('}')) {
+            return Fail("Expected '}'");
+        }
+        return true;
+    }
+
+    bool ParseArray(toml::array& array, u32 depth) {
+        if (!Consume('[')) {
+            return Fail("Expected array");
+        }
+        if (Consume(']')) {
+            return true;
+        }
+        do {
+            if (!ParseValue(array, depth)) {
+                return false;
+            }
+        } while (Consume(','));
+        if (!Consume(']')) {
+            return Fail("Expected ']'");
+        }
+        return true;
+    }
+
+    const String& m_text;
+    usize m_pos = 0;
+    String m_error;
+};
+
+} // namespace
+
+Result<toml::table, String> ParseJson(const String& text) {
+    return JsonParser(text).ParseDocument();
+}
+
+} // namespace quantiloom
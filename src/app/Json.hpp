@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Config.hpp"
+
+// ============================================================================
+// Json - Minimal JSON for the batch timings and the daemon protocol
+// ============================================================================
+// ParseJson() reads one JSON object into a toml::table so that a request can
+// be handed to Config::FromTable() / WithOverrides() like a TOML file:
+//   object -> table, array -> array, integer -> int64, other number -> double,
+//   string -> string, true/false -> bool; null members are dropped.
+//
+// Usage:
+//   auto table = ParseJson(R"({"op": "render", "config": {"renderer": {"spp": 4}}})");
+//   String line = fmt::format("{{\"error\": \"{}\"}}", JsonEscape(message));
+// ============================================================================
+
+namespace quantiloom {
+
+// Escape text for use inside a JSON string literal
+String JsonEscape(const String& text);
+
+// Parse a JSON object (the whole text, surrounding whitespace allowed)
+Result<toml::table, String> ParseJson(const String& text);
+
+} // namespace quantiloom
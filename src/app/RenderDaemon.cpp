@@ -0,0 +1,619 @@
+#include "RenderDaemon.hpp"
+#include "Json.hpp"
+#include "core/Log.hpp"
+#include "core/Profiler.hpp"
+#include "renderer/VulkanContext.hpp"
+
+#include <algorithm>
+#include <future>
+
+#if !defined(QL_WINDOWS)
+    #include <cerrno>
+    #include <csignal>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace quantiloom {
+
+// ============================================================================
+// DaemonSettings
+// ============================================================================
+
+DaemonSettings DaemonSettings::FromConfig(const Config& config, const std::filesystem::path& configDir) {
+    DaemonSettings settings;
+    settings.socketPath = config.Get<String>("daemon.socket", settings.socketPath);
+    settings.sceneCacheSize = std::max(1u, config.Get<u32>("daemon.scene_cache", settings.sceneCacheSize));
+
+    const String base = config.Get<String>("daemon.base", "");
+    if (!base.empty()) {
+        const std::filesystem::path basePath(base);
+        settings.basePath = (basePath.is_absolute() || configDir.empty()) ? basePath.string()
+                                                                          : (configDir / basePath).string();
+    }
+    return settings;
+}
+
+// ============================================================================
+// SceneCache
+// ============================================================================
+
+SceneCache::SceneCache(VulkanContext& context, usize capacity)
+    : m_context(context)
+    , m_capacity(std::max<usize>(capacity, 1)) {
+}
+
+bool SceneCache::Contains(const Config& config) const {
+    return m_index.find(GpuScene::Key(config)) != m_index.end();
+}
+
+Result<GpuScene*, String> SceneCache::Acquire(const Config& config, bool& hit) {
+    using R = Result<GpuScene*, String>;
+    QL_PROFILE_SCOPE("SceneCache::Acquire");
+
+    const String key = GpuScene::Key(config);
+    auto it = m_index.find(key);
+    hit = (it != m_index.end());
+    if (hit) {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return m_entries.front().second.get();
+    }
+
+    // Evict before loading: device memory may not hold one more scene
+    while (m_entries.size() >= m_capacity) {
+        QL_LOG_INFO("Scene cache: evicting '{}'", m_entries.back().second->GetName());
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+        ++m_evictions;
+    }
+
+    auto sceneResult = GpuScene::Load(m_context, config);
+    if (!sceneResult.has_value()) {
+        return R::Err(sceneResult.error());
+    }
+    m_entries.emplace_front(key, std::move(sceneResult.value()));
+    m_index[key] = m_entries.begin();
+    return m_entries.front().second.get();
+}
+
+#if defined(QL_WINDOWS)
+
+// ============================================================================
+// RenderDaemon (Unix domain sockets and POSIX shared memory only)
+// ============================================================================
+
+RenderDaemon::RenderDaemon(DaemonSettings settings)
+    : m_settings(std::move(settings)) {
+}
+
+RenderDaemon::~RenderDaemon() = default;
+
+bool RenderDaemon::Run() {
+    QL_LOG_ERROR("Daemon mode needs Unix domain sockets and POSIX shared memory (Linux / macOS)");
+    return false;
+}
+
+void RenderDaemon::Stop() {
+    m_stopping = true;
+}
+
+#else
+
+// Latency percentiles cover the last LATENCY_WINDOW requests
+static constexpr usize LATENCY_WINDOW = 1024;
+
+// Longest request line accepted (render configs are small)
+static constexpr usize MAX_REQUEST_BYTES = 1 << 20;
+
+struct RenderDaemon::Request {
+    String id;
+    Config config;
+    RenderJob job;
+    Clock::time_point received;
+    std::promise<RenderStats> done;
+
+    // Set by the render thread before done
+    bool cacheHit = false;
+    f64 queueSeconds = 0.0;
+    f64 sceneLoadSeconds = 0.0;
+};
+
+struct RenderDaemon::Connection {
+    int fd = -1;
+    std::thread thread;
+    std::atomic<bool> done{false};
+};
+
+// ============================================================================
+// Helper: socket and shared memory IO
+// ============================================================================
+
+static f64 SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool SendAll(int fd, const String& data) {
+    usize sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<usize>(n);
+    }
+    return true;
+}
+
+static bool WriteSharedMemory(const String& name, const std::vector<f32>& pixels, String& error) {
+    const usize bytes = pixels.size() * sizeof(f32);
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        error = fmt::format("shm_open({}) failed: {}", name, std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        error = fmt::format("ftruncate({}, {}) failed: {}", name, bytes, std::strerror(errno));
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        error = fmt::format("mmap({}) failed: {}", name, std::strerror(errno));
+        shm_unlink(name.c_str());
+        return false;
+    }
+    std::memcpy(mapped, pixels.data(), bytes);
+    munmap(mapped, bytes);
+    return true;
+}
+
+static String ErrorReply(const String& id, const String& error) {
+    return fmt::format("{{\"id\": \"{}\", \"status\": \"error\", \"error\": \"{}\"}}",
+                       JsonEscape(id), JsonEscape(error));
+}
+
+// ============================================================================
+// RenderDaemon
+// ============================================================================
+
+RenderDaemon::RenderDaemon(DaemonSettings settings)
+    : m_settings(std::move(settings)) {
+    m_latencies.reserve(LATENCY_WINDOW);
+}
+
+RenderDaemon::~RenderDaemon() {
+    Shutdown();
+}
+
+bool RenderDaemon::Run() {
+    // A client closing its socket early must not kill the daemon
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_settings.socketPath.empty() || m_settings.socketPath.size() >= sizeof(address.sun_path)) {
+        QL_LOG_ERROR("daemon.socket: Path must be 1-{} bytes: '{}'",
+                     sizeof(address.sun_path) - 1, m_settings.socketPath);
+        return false;
+    }
+    std::memcpy(address.sun_path, m_settings.socketPath.c_str(), m_settings.socketPath.size() + 1);
+
+    QL_LOG_INFO("Initializing Vulkan context...");
+    VulkanContext context;
+    if (!context.IsRayTracingSupported()) {
+        QL_LOG_ERROR("Ray tracing not supported on this device");
+        return false;
+    }
+
+    // A socket left behind by a killed daemon would make bind() fail; one
+    // that still accepts connections belongs to a running daemon
+    std::error_code ec;
+    if (std::filesystem::is_socket(m_settings.socketPath, ec)) {
+        const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool live = probe >= 0 &&
+                          connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (live) {
+            QL_LOG_ERROR("Another daemon is listening on {}", m_settings.socketPath);
+            return false;
+        }
+        std::filesystem::remove(m_settings.socketPath, ec);
+    }
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0 ||
+        bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listenFd, SOMAXCONN) != 0) {
+        QL_LOG_ERROR("Cannot listen on {}: {}", m_settings.socketPath, std::strerror(errno));
+        if (m_listenFd >= 0) {
+            close(m_listenFd);      // Not bound by us: the path is left alone
+            m_listenFd = -1;
+        }
+        return false;
+    }
+
+    m_start = Clock::now();
+    m_acceptThread = std::thread(&RenderDaemon::AcceptLoop, this);
+    QL_LOG_INFO("Daemon listening on {} (scene cache: {} scene(s){}{})", m_settings.socketPath,
+                m_settings.sceneCacheSize, m_settings.basePath.empty() ? "" : ", base: ", m_settings.basePath);
+
+    try {
+        RenderLoop(context);
+    } catch (...) {
+        Shutdown();
+        throw;
+    }
+    Shutdown();
+
+    QL_LOG_INFO("Daemon stopped: {} request(s) completed, {} failed", m_completed, m_failed);
+    return true;
+}
+
+void RenderDaemon::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_queueReady.notify_all();
+}
+
+void RenderDaemon::Shutdown() {
+    Stop();
+    FailQueued("Daemon shutting down");
+
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+
+    // Wake connections blocked in recv(); each waits for no render any more
+    std::lock_guard<std::mutex> lock(m_connectionsMutex);
+    for (auto& connection : m_connections) {
+        shutdown(connection->fd, SHUT_RDWR);
+    }
+    for (auto& connection : m_connections) {
+        connection->thread.join();
+        close(connection->fd);
+    }
+    m_connections.clear();
+
+    if (m_listenFd >= 0) {
+        close(m_listenFd);
+        m_listenFd = -1;
+        unlink(m_settings.socketPath.c_str());
+    }
+}
+
+// ============================================================================
+// Connections (accept thread, one thread per client)
+// ============================================================================
+
+void RenderDaemon::AcceptLoop() {
+    while (!m_stopping) {
+        // Poll so Stop() is noticed without closing the socket under accept()
+        pollfd pfd{m_listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) {
+            continue;
+        }
+        const int fd = accept(m_listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        for (auto it = m_connections.begin(); it != m_connections.end();) {
+            if ((*it)->done) {
+                (*it)->thread.join();
+                close((*it)->fd);
+                it = m_connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        Connection& client = *connection;
+        client.thread = std::thread([this, &client]() {
+            ServeConnection(client);
+            client.done = true;
+        });
+        m_connections.push_back(std::move(connection));
+    }
+}
+
+void RenderDaemon::ServeConnection(Connection& connection) {
+    String buffer;
+    char chunk[4096];
+    while (!m_stopping) {
+        const ssize_t n = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        buffer.append(chunk, static_cast<usize>(n));
+
+        usize newline = 0;
+        while ((newline = buffer.find('\n')) != String::npos) {
+            String line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.find_first_not_of(" \t") == String::npos) {
+                continue;
+            }
+            if (!SendAll(connection.fd, HandleLine(line) + "\n")) {
+                return;
+            }
+        }
+        if (buffer.size() > MAX_REQUEST_BYTES) {
+            SendAll(connection.fd, ErrorReply("", "Request line too long") + "\n");
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// Requests (connection threads)
+// ============================================================================
+
+String RenderDaemon::HandleLine(const String& line) {
+    auto parsed = ParseJson(line);
+    if (!parsed.has_value()) {
+        return ErrorReply("", parsed.error());
+    }
+    const Config request = Config::FromTable(parsed.value());
+    const String op = request.Get<String>("op", "");
+
+    if (op == "render") {
+        return HandleRender(request);
+    }
+    if (op == "stats") {
+        return StatsReply();
+    }
+    if (op == "ping") {
+        return "{\"status\": \"ok\"}";
+    }
+    if (op == "shutdown") {
+        QL_LOG_INFO("Daemon: shutdown requested");
+        Stop();
+        return "{\"status\": \"ok\"}";
+    }
+    return ErrorReply(request.Get<String>("id", ""),
+                      fmt::format("Unknown op '{}' (expected render, stats, ping or shutdown)", op));
+}
+
+String RenderDaemon::HandleRender(const Config& request) {
+    auto pending = std::make_shared<Request>();
+    pending->received = Clock::now();
+    pending->id = request.Get<String>("id", "");
+    const String& id = pending->id;
+
+    const String outputMode = request.Get<String>("output", "file");
+    if (outputMode != "file" && outputMode != "shm") {
+        return ErrorReply(id, fmt::format("Unknown output '{}' (expected file or shm)", outputMode));
+    }
+
+    // Base config merged with the request's config entries (as batch jobs)
+    Config base;
+    const String basePath = request.Get<String>("base", m_settings.basePath);
+    if (!basePath.empty()) {
+        auto baseResult = Config::Load(basePath);
+        if (!baseResult.has_value()) {
+            return ErrorReply(id, baseResult.error());
+        }
+        base = baseResult.value();
+    }
+    const toml::table* overrides = request.GetRoot()["config"].as_table();
+    pending->config = overrides ? base.WithOverrides(Config::FromTable(*overrides)) : base;
+
+    auto jobResult = RenderJob::FromConfig(pending->config);
+    if (!jobResult.has_value()) {
+        return ErrorReply(id, jobResult.error());
+    }
+    pending->job = std::move(jobResult.value());
+    pending->job.name = id;
+    pending->job.keepPixels = (outputMode == "shm");
+
+    std::future<RenderStats> done = pending->done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return ErrorReply(id, "Daemon shutting down");
+        }
+        m_queue.push_back(pending);
+    }
+    m_queueReady.notify_one();
+
+    RenderStats stats = done.get();
+    String reply = fmt::format("{{\"id\": \"{}\", ", JsonEscape(id));
+    if (stats.succeeded && pending->job.keepPixels) {
+        String name;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            name = fmt::format("/quantiloom-{}-{}", getpid(), ++m_sharedMemoryCount);
+        }
+        String error;
+        if (WriteSharedMemory(name, stats.pixels, error)) {
+            String wavelengths;
+            for (const SpectralBand& band : pending->job.bands) {
+                wavelengths += fmt::format("{}{:.3f}", wavelengths.empty() ? "" : ", ", band.center_nm);
+            }
+            reply += fmt::format("\"status\": \"ok\", \"shm\": \"{}\", \"bytes\": {}, \"width\": {}, "
+                                 "\"height\": {}, \"bands\": {}, \"wavelengths_nm\": [{}], "
+                                 "\"layout\": \"f32 [band][y][x]\", ",
+                                 name, stats.pixels.size() * sizeof(f32), stats.width, stats.height,
+                                 stats.bandCount, wavelengths);
+        } else {
+            stats.succeeded = false;
+            stats.error = error;
+        }
+    } else if (stats.succeeded) {
+        reply += fmt::format("\"status\": \"ok\", \"output\": \"{}\", ", JsonEscape(stats.outputPath));
+    }
+    if (!stats.succeeded) {
+        reply += fmt::format("\"status\": \"error\", \"error\": \"{}\", ", JsonEscape(stats.error));
+    }
+
+    const f64 latency = SecondsSince(pending->received);
+    RecordLatency(latency, stats.succeeded);
+    reply += fmt::format("\"scene_cache\": \"{}\", \"queue_s\": {:.6f}, \"scene_load_s\": {:.6f}, "
+                         "\"update_s\": {:.6f}, \"render_s\": {:.6f}, \"readback_s\": {:.6f}, "
+                         "\"finish_s\": {:.6f}, \"latency_s\": {:.6f}}}",
+                         pending->cacheHit ? "hit" : "miss", pending->queueSeconds, pending->sceneLoadSeconds,
+                         stats.updateSeconds, stats.renderSeconds, stats.readbackSeconds,
+                         stats.finishSeconds, latency);
+    return reply;
+}
+
+void RenderDaemon::RecordLatency(f64 seconds, bool succeeded) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++(succeeded ? m_completed : m_failed);
+    m_latencySum += seconds;
+    m_latencyMax = std::max(m_latencyMax, seconds);
+    m_latencyLast = seconds;
+    if (m_latencies.size() < LATENCY_WINDOW) {
+        m_latencies.push_back(seconds);
+    } else {
+        m_latencies[m_latencyNext] = seconds;
+    }
+    m_latencyNext = (m_latencyNext + 1) % LATENCY_WINDOW;
+}
+
+String RenderDaemon::StatsReply() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<f64> window = m_latencies;
+    std::sort(window.begin(), window.end());
+    auto percentile = [&window](f64 p) {
+        return window.empty() ? 0.0 : window[static_cast<usize>(p * static_cast<f64>(window.size() - 1) + 0.5)];
+    };
+    const u64 requests = m_completed + m_failed;
+
+    return fmt::format("{{\"status\": \"ok\", \"uptime_s\": {:.3f}, \"queue_depth\": {}, \"rendering\": {}, "
+                       "\"completed\": {}, \"failed\": {}, "
+                       "\"scene_cache\": {{\"capacity\": {}, \"scenes\": {}, \"hits\": {}, \"misses\": {}, "
+                       "\"evictions\": {}}}, "
+                       "\"latency_s\": {{\"count\": {}, \"last\": {:.6f}, \"mean\": {:.6f}, \"p50\": {:.6f}, "
+                       "\"p95\": {:.6f}, \"max\": {:.6f}}}}}",
+                       SecondsSince(m_start), m_queue.size(), m_rendering ? "true" : "false",
+                       m_completed, m_failed,
+                       m_settings.sceneCacheSize, m_cachedScenes, m_cacheHits, m_cacheMisses, m_cacheEvictions,
+                       requests, m_latencyLast, requests > 0 ? m_latencySum / static_cast<f64>(requests) : 0.0,
+                       percentile(0.50), percentile(0.95), m_latencyMax);
+}
+
+// ============================================================================
+// Rendering (Run() thread)
+// ============================================================================
+
+void RenderDaemon::RenderLoop(VulkanContext& context) {
+    RenderSession session(context);
+    SceneCache cache(context, m_settings.sceneCacheSize);
+
+    while (true) {
+        std::shared_ptr<Request> request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_rendering = false;
+            if (m_queue.empty()) {
+                // Nothing else to render: finish the last job now. Its reply
+                // is sent when it is retired, which otherwise waits until
+                // the next request has rendered its first band.
+                lock.unlock();
+                session.Finish();
+                lock.lock();
+            }
+            m_queueReady.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) {
+                break;
+            }
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_rendering = true;
+        }
+        request->queueSeconds = SecondsSince(request->received);
+
+        auto fail = [&request](const String& error) {
+            RenderStats stats;
+            stats.jobName = request->id;
+            stats.error = error;
+            request->done.set_value(std::move(stats));
+        };
+
+        // A miss loads a scene (HDF5 reads, device memory): deliver the
+        // previous job's output first rather than run it alongside
+        if (!cache.Contains(request->config)) {
+            session.Finish();
+        }
+
+        const Clock::time_point loadStart = Clock::now();
+        bool hit = false;
+        GpuScene* scene = nullptr;
+        String loadError;
+        try {
+            auto sceneResult = cache.Acquire(request->config, hit);
+            if (sceneResult.has_value()) {
+                scene = sceneResult.value();
+            } else {
+                loadError = "Failed to load scene: " + sceneResult.error();
+            }
+        } catch (const std::exception& e) {
+            loadError = fmt::format("Failed to load scene: {}", e.what());
+        }
+        request->cacheHit = hit;
+        request->sceneLoadSeconds = hit ? 0.0 : SecondsSince(loadStart);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++(hit ? m_cacheHits : m_cacheMisses);
+            m_cacheEvictions = cache.GetEvictions();
+            m_cachedScenes = cache.GetSize();
+        }
+        if (!scene) {
+            QL_LOG_ERROR("  [FAIL] {}: {}", request->id, loadError);
+            fail(loadError);
+            continue;
+        }
+
+        try {
+            session.Render(*scene, request->job, [request](RenderStats& stats) {
+                request->done.set_value(std::move(stats));
+            });
+        } catch (const std::exception& e) {
+            // Already answered with the error; later requests may still succeed
+            QL_LOG_ERROR("  Request {} aborted: {}", request->id, e.what());
+        }
+    }
+
+    session.Finish();
+    FailQueued("Daemon shutting down");
+}
+
+void RenderDaemon::FailQueued(const String& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& request : m_queue) {
+        RenderStats stats;
+        stats.jobName = request->id;
+        stats.error = error;
+        request->done.set_value(std::move(stats));
+    }
+    m_queue.clear();
+}
+
+#endif
+
+} // namespace quantiloom
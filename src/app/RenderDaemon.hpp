@@ -0,0 +1,163 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Config.hpp"
+#include "RenderSession.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// RenderDaemon - Long-running renderer serving jobs over a local socket
+// ============================================================================
+// Keeps the VulkanContext, the pipeline (RenderSession) and an LRU cache of
+// GPU-resident scenes (SceneCache) alive between requests, so a request pays
+// only for its own frames (plus a scene load on a cache miss).
+//
+// Daemon config (TOML):
+//   [daemon]
+//   socket = "/tmp/quantiloom.sock"   # Unix domain socket path
+//   base = "spectral_single.toml"     # Config requests start from (optional;
+//                                     # relative paths: to the daemon config)
+//   scene_cache = 4                   # Scenes kept on the GPU
+//   [threads] / [profiling] configure the process.
+//
+// Protocol: one JSON object per line in each direction. Requests on one
+// connection are answered in order, one at a time; concurrent connections
+// queue their renders (queue_depth).
+//   {"op": "render", "id": "r1", "base": "other.toml", "output": "file",
+//    "config": {"spectral": {"wavelength_nm": 650.0}, "renderer": {"spp": 4}}}
+//       base and id are optional; config is merged over the base like a
+//       batch job. output "file" (default) writes renderer.output; "shm"
+//       returns the radiance in a POSIX shared memory object instead:
+//   -> {"id": "r1", "status": "ok", "output": "spectral_output.exr",
+//       "scene_cache": "hit", "queue_s": ..., "scene_load_s": ...,
+//       "render_s": ..., "latency_s": ..., ...}
+//   -> {"id": "r1", "status": "ok", "shm": "/quantiloom-1234-7", "bytes": N,
+//       "width": W, "height": H, "bands": B, "wavelengths_nm": [...],
+//       "layout": "f32 [band][y][x]", ...}     (client maps, then shm_unlinks)
+//   {"op": "stats"}     -> queue depth, scene cache hits / misses, latency
+//   {"op": "ping"}      -> {"status": "ok"}
+//   {"op": "shutdown"}  -> stops after the current render; queued requests fail
+// Failures reply {"id": ..., "status": "error", "error": "..."}.
+//
+// Threads: Run() renders on the calling thread (all Vulkan work); one thread
+// accepts connections and one thread per connection parses requests, waits
+// for its render and writes the reply (and shared memory).
+//
+// Usage:
+//   auto settings = DaemonSettings::FromConfig(config, configPath.parent_path());
+//   RenderDaemon daemon(settings);
+//   daemon.Run();   // Until {"op": "shutdown"}
+// ============================================================================
+
+namespace quantiloom {
+
+struct DaemonSettings {
+    String socketPath = "/tmp/quantiloom.sock";
+    String basePath;                // Empty: requests carry complete configs
+    u32 sceneCacheSize = 4;
+
+    // [daemon] (relative base paths resolved against configDir)
+    static DaemonSettings FromConfig(const Config& config, const std::filesystem::path& configDir);
+};
+
+// ============================================================================
+// SceneCache - GpuScenes by GpuScene::Key(), least recently used evicted
+// ============================================================================
+
+class SceneCache {
+public:
+    SceneCache(VulkanContext& context, usize capacity);
+
+    // Scene for config: cached (hit) or loaded (miss), evicting the least
+    // recently used scene when full. Failed loads are not cached.
+    Result<GpuScene*, String> Acquire(const Config& config, bool& hit);
+
+    // True if Acquire(config) would be a hit
+    bool Contains(const Config& config) const;
+
+    usize GetSize() const { return m_entries.size(); }
+    usize GetCapacity() const { return m_capacity; }
+    u64 GetEvictions() const { return m_evictions; }
+
+private:
+    using Entry = std::pair<String, std::unique_ptr<GpuScene>>;
+
+    VulkanContext& m_context;
+    usize m_capacity;
+    std::list<Entry> m_entries;     // Most recently used first
+    std::unordered_map<String, std::list<Entry>::iterator> m_index;
+    u64 m_evictions = 0;
+};
+
+// ============================================================================
+// RenderDaemon
+// ============================================================================
+
+class RenderDaemon {
+public:
+    explicit RenderDaemon(DaemonSettings settings);
+    ~RenderDaemon();
+    RenderDaemon(const RenderDaemon&) = delete;
+    RenderDaemon& operator=(const RenderDaemon&) = delete;
+
+    // Serve requests until shutdown; false if the daemon could not start
+    bool Run();
+
+    // Stop accepting requests (any thread)
+    void Stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Request;
+    struct Connection;
+
+    void AcceptLoop();
+    void ServeConnection(Connection& connection);
+    String HandleLine(const String& line);
+    String HandleRender(const Config& request);
+    String StatsReply();
+    void RenderLoop(VulkanContext& context);
+    void FailQueued(const String& error);
+    void RecordLatency(f64 seconds, bool succeeded);
+    void Shutdown();
+
+    DaemonSettings m_settings;
+    int m_listenFd = -1;
+    std::atomic<bool> m_stopping{false};
+    u64 m_sharedMemoryCount = 0;     // Guarded by m_mutex
+    Clock::time_point m_start;
+
+    std::thread m_acceptThread;
+    std::mutex m_connectionsMutex;
+    std::list<std::unique_ptr<Connection>> m_connections;
+
+    // Render queue and statistics
+    std::mutex m_mutex;
+    std::condition_variable m_queueReady;
+    std::deque<std::shared_ptr<Request>> m_queue;
+    bool m_rendering = false;
+    u64 m_completed = 0;
+    u64 m_failed = 0;
+    u64 m_cacheHits = 0;
+    u64 m_cacheMisses = 0;
+    u64 m_cacheEvictions = 0;
+    usize m_cachedScenes = 0;
+    std::vector<f64> m_latencies;    // Last LATENCY_WINDOW requests (ring)
+    usize m_latencyNext = 0;
+    f64 m_latencySum = 0.0;
+    f64 m_latencyMax = 0.0;
+    f64 m_latencyLast = 0.0;
+};
+
+} // namespace quantiloom
@@ -0,0 +1,1248 @@
+#include "RenderSession.hpp"
+#include "SceneBuilder.hpp"
+#include "core/Log.hpp"
+#include "core/Profiler.hpp"
+#include "io/ImageIO.hpp"
+#include "io/GltfLoader.hpp"
+#include "io/RgbToSpectrumLoader.hpp"
+#include "io/SpectralLibraryLoader.hpp"
+#include "renderer/CommandHelper.hpp"
+#include "scene/TextureMips.hpp"
+#include "postprocess/PsfConvolution.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace quantiloom {
+
+using Clock = std::chrono::steady_clock;
+
+static f64 SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<f64>(Clock::now() - start).count();
+}
+
+// ============================================================================
+// Helper: Scene loading
+// ============================================================================
+
+// Load scene from config file
+// Returns either procedural scene or glTF-loaded scene
+// For glTF scenes, also populates materials and textures
+static Result<Scene, String> LoadSceneFromConfig(const Config& config) {
+    Scene scene;
+
+    // Check for glTF file
+    if (config.Has("scene.gltf")) {
+        String gltfPath = config.Get<String>("scene.gltf");
+        QL_LOG_INFO("Loading glTF model: {}", gltfPath);
+
+        GltfLoadOptions options;
+        options.generateMips = config.Get<bool>("textures.generate_mips", true);
+        options.mipFilter = MipGenerator::ParseFilter(config.Get<String>("textures.mip_filter", "box"));
+        options.compressTextures = config.Get<bool>("textures.compress", false);
+        options.preferBc7 = BcCodec::ParsePreferBc7(config.Get<String>("textures.color_format", "bc7"));
+        options.textureCachePath = config.Get<String>("textures.cache_path", "");
+
+        auto result = GltfLoader::LoadFromFile(gltfPath, options);
+        if (!result.has_value()) {
+            return Result<Scene, String>::Err("Failed to load glTF: " + result.error());
+        }
+
+        return std::move(result.value());
+    }
+
+    // Check for procedural preset
+    if (config.Has("scene.preset")) {
+        String preset = config.Get<String>("scene.preset", "cornell_box");
+        QL_LOG_INFO("Loading built-in scene preset: {}", preset);
+
+        Mesh mesh;
+        if (preset == "cornell_box") {
+            mesh = TestScenes::CreateCornellBoxScene();
+        } else if (preset == "multi_object") {
+            mesh = TestScenes::CreateMultiObjectScene();
+        } else if (preset == "lighting_test") {
+            mesh = TestScenes::CreateLightingTestScene();
+        } else {
+            QL_LOG_WARN("Unknown scene preset '{}', defaulting to cornell_box", preset);
+            mesh = TestScenes::CreateCornellBoxScene();
+        }
+
+        // Wrap in Scene
+        scene.name = preset;
+        scene.meshes.push_back(std::move(mesh));
+
+        // Create single node with identity transform
+        SceneNode node;
+        node.meshIndex = 0;
+        node.transform = glm::mat4(1.0f);
+        node.name = "SceneRoot";
+        scene.nodes.push_back(node);
+
+        return std::move(scene);
+    }
+
+    // Default: Cornell box
+    QL_LOG_WARN("No scene specified in config, using cornell_box preset");
+    Mesh mesh = TestScenes::CreateCornellBoxScene();
+    scene.name = "cornell_box";
+    scene.meshes.push_back(std::move(mesh));
+
+    SceneNode node;
+    node.meshIndex = 0;
+    node.transform = glm::mat4(1.0f);
+    node.name = "SceneRoot";
+    scene.nodes.push_back(node);
+
+    return std::move(scene);
+}
+
+// ============================================================================
+// Helper: Thermal
+// ============================================================================
+
+// Load a per-texel temperature map (EXR, Kelvin in the first channel) as an
+// 8-bit data texture; rangeK receives the temperatures of texel values 0 and 1
+// (quantisation step = (max - min) / 255)
+static std::optional<Texture> LoadTemperatureMap(const String& path, glm::vec2& rangeK) {
+    auto image = ImageIO::ReadEXR(path);
+    if (!image || !image->IsValid()) {
+        return std::nullopt;
+    }
+
+    f32 minK = image->data[0];
+    f32 maxK = image->data[0];
+    for (u32 i = 0; i < image->PixelCount(); ++i) {
+        const f32 value = image->data[static_cast<usize>(i) * image->channels];
+        minK = std::min(minK, value);
+        maxK = std::max(maxK, value);
+    }
+    if (minK < 0.0f) {
+        QL_LOG_ERROR("Temperature map {} has negative temperatures (expected Kelvin)", path);
+        return std::nullopt;
+    }
+    rangeK = glm::vec2(minK, maxK);
+
+    Texture texture;
+    texture.width = image->width;
+    texture.height = image->height;
+    texture.channels = 4;
+    texture.usage = TextureUsage::Data;
+    texture.name = std::filesystem::path(path).stem().string();
+    texture.sourceUri = path;
+    texture.pixels.resize(static_cast<usize>(texture.width) * texture.height * 4);
+
+    const f32 scale = (maxK > minK) ? 255.0f / (maxK - minK) : 0.0f;
+    for (u32 i = 0; i < image->PixelCount(); ++i) {
+        const f32 value = image->data[static_cast<usize>(i) * image->channels];
+        const u8 level = static_cast<u8>(std::lround((value - minK) * scale));
+        u8* texel = texture.pixels.data() + static_cast<usize>(i) * 4;
+        texel[0] = texel[1] = texel[2] = level;
+        texel[3] = 255;
+    }
+    return texture;
+}
+
+// ============================================================================
+// RenderJob
+// ============================================================================
+
+Result<RenderJob, String> RenderJob::FromConfig(const Config& config) {
+    using R = Result<RenderJob, String>;
+    RenderJob job;
+
+    // Renderer settings
+    auto resArray = config.GetArray<u32>("renderer.resolution");
+    if (resArray.size() != 2 || resArray[0] == 0 || resArray[1] == 0) {
+        return R::Err(fmt::format("renderer.resolution must be array of 2 positive integers, but got {} value(s)",
+                                  resArray.size()));
+    }
+    job.width = resArray[0];
+    job.height = resArray[1];
+    job.spp = config.Get<u32>("renderer.spp", 1);
+    job.seed = config.Get<u64>("renderer.seed", 0);
+    job.samplesPerPass = config.Get<u32>("renderer.samples_per_pass", 0);
+    job.spectralMode = config.Get<String>("spectral.mode", "single_wavelength");
+    const bool hsOff = job.IsHsOff();
+    job.outputPath = config.Get<String>("renderer.output", hsOff ? "spectral_cube.h5" : "spectral_output.exr");
+    job.outputFormat = ParsePixelFormat(config.Get<String>("renderer.output_format", "f32"));
+    if (config.Get<bool>("checkpoint.enabled", false)) {
+        job.checkpointPath = config.Get<String>("checkpoint.path", job.outputPath + ".ckpt");
+        job.checkpointIntervalSeconds = config.Get<f64>("checkpoint.interval_s", job.checkpointIntervalSeconds);
+        job.fingerprint = CheckpointFile::Fingerprint(config);
+    }
+
+    // Spectral settings
+    if (job.spectralMode != "single_wavelength" && !hsOff) {
+        return R::Err(fmt::format("Unknown spectral.mode '{}' (expected single_wavelength or hs_off)",
+                                  job.spectralMode));
+    }
+    if (hsOff && job.outputFormat == PixelFormat::U16) {
+        return R::Err("renderer.output_format: u16 cannot be streamed band by band, use f32 or f16");
+    }
+
+    // Render bands: the single wavelength, or the HS-OFF grid
+    // spectral.range_nm in steps of spectral.step_nm. HS-OFF renders every
+    // band with one scene and pipeline; the band tables (measured materials,
+    // Planck) are built for all bands up front and LUTData::spectralBand
+    // selects the column.
+    if (hsOff) {
+        auto rangeArray = config.GetArray<f32>("spectral.range_nm");
+        if (rangeArray.size() != 2) {
+            return R::Err(fmt::format("spectral.range_nm must be array of 2 floats, but got {}", rangeArray.size()));
+        }
+        const f32 step = config.Get<f32>("spectral.step_nm", 5.0f);
+        job.bands = SpectralMaterialTable::MakeUniformBands(rangeArray[0], rangeArray[1], step);
+        if (job.bands.size() < 2) {
+            return R::Err(fmt::format("spectral.range_nm [{}, {}] with step_nm {} gives fewer than 2 bands",
+                                      rangeArray[0], rangeArray[1], step));
+        }
+        if (config.Has("spectral.fwhm_nm")) {
+            for (auto& band : job.bands) {
+                band.fwhm_nm = config.Get<f32>("spectral.fwhm_nm", step);
+            }
+        }
+    } else {
+        SpectralBand renderBand;
+        renderBand.name = "render";
+        renderBand.center_nm = config.Get<f32>("spectral.wavelength_nm", 550.0f);
+        renderBand.fwhm_nm = config.Get<f32>("spectral.fwhm_nm", 0.0f);  // 0 = point sample
+        job.bands.push_back(renderBand);
+    }
+
+    // Camera settings
+    f32 aspectRatio = static_cast<f32>(job.width) / static_cast<f32>(job.height);
+    auto cameraResult = Camera::FromConfig(config, aspectRatio);
+    if (!cameraResult.has_value()) {
+        return R::Err("Failed to load camera: " + cameraResult.error());
+    }
+    job.camera = cameraResult.value();
+
+    // Lighting settings
+    auto sunDirArray = config.GetArray<f32>("lighting.sun_direction");
+    if (sunDirArray.size() != 3) {
+        return R::Err(fmt::format("lighting.sun_direction must be array of 3 floats, but got {}", sunDirArray.size()));
+    }
+    job.sunDirection = glm::normalize(glm::vec3(sunDirArray[0], sunDirArray[1], sunDirArray[2]));
+
+    auto sunRadArray = config.GetArray<f32>("lighting.sun_radiance");
+    if (sunRadArray.size() != 3) {
+        return R::Err(fmt::format("lighting.sun_radiance must be array of 3 floats, but got {}", sunRadArray.size()));
+    }
+    job.sunRadiance = glm::vec3(sunRadArray[0], sunRadArray[1], sunRadArray[2]);
+
+    auto skyRadArray = config.GetArray<f32>("lighting.sky_radiance");
+    if (skyRadArray.size() != 3) {
+        return R::Err(fmt::format("lighting.sky_radiance must be array of 3 floats, but got {}", skyRadArray.size()));
+    }
+    job.skyRadiance = glm::vec3(skyRadArray[0], skyRadArray[1], skyRadArray[2]);
+
+    // Post-processing: AOVs, a-trous denoiser, optical PSF ([sensor.psf])
+    job.writeAovs = config.Get<bool>("renderer.aovs", false);
+    job.denoise = config.Get<bool>("denoise.enabled", false);
+    job.denoiseParams.iterations = config.Get<u32>("denoise.iterations", job.denoiseParams.iterations);
+    job.denoiseParams.sigmaColor = config.Get<f32>("denoise.sigma_color", job.denoiseParams.sigmaColor);
+    job.denoiseParams.sigmaNormal = config.Get<f32>("denoise.sigma_normal", job.denoiseParams.sigmaNormal);
+    job.denoiseParams.sigmaDepth = config.Get<f32>("denoise.sigma_depth", job.denoiseParams.sigmaDepth);
+    job.psfType = config.Get<String>("sensor.psf.type", "none");
+    job.psfSigmaPx = config.Get<f32>("sensor.psf.sigma_px", job.psfSigmaPx);
+    job.psfFNumber = config.Get<f32>("sensor.psf.f_number", job.psfFNumber);
+    job.psfPixelPitchUm = config.Get<f32>("sensor.psf.pixel_pitch_um", job.psfPixelPitchUm);
+    if (job.psfType != "none" && job.psfType != "gaussian" && job.psfType != "airy") {
+        QL_LOG_WARN("sensor.psf.type: Unknown PSF '{}' (expected none, gaussian or airy)", job.psfType);
+        job.psfType = "none";
+    }
+
+    return job;
+}
+
+// ============================================================================
+// GpuScene
+// ============================================================================
+
+static std::atomic<u64> s_nextSceneId{1};
+
+Result<std::unique_ptr<GpuScene>, String> GpuScene::Load(VulkanContext& context, const Config& config) {
+    using R = Result<std::unique_ptr<GpuScene>, String>;
+    QL_PROFILE_SCOPE("GpuScene::Load");
+
+    auto sceneResult = LoadSceneFromConfig(config);
+    if (!sceneResult.has_value()) {
+        return R::Err(sceneResult.error());
+    }
+
+    Scene loadedScene = std::move(sceneResult.value());
+
+    // If scene has no materials (procedural), create default from config
+    if (loadedScene.materials.empty()) {
+        auto albedoArray = config.GetArray<f32>("material.albedo");
+        if (albedoArray.size() != 3) {
+            return R::Err(fmt::format("material.albedo must be array of 3 floats, but got {}", albedoArray.size()));
+        }
+        glm::vec3 albedo(albedoArray[0], albedoArray[1], albedoArray[2]);
+        Material defaultMaterial = Material::CreateLambertian(albedo, "DefaultMaterial");
+        loadedScene.materials.push_back(defaultMaterial);
+        QL_LOG_INFO("  Created default material (albedo: [{:.2f}, {:.2f}, {:.2f}])", albedo.x, albedo.y, albedo.z);
+    }
+
+    QL_LOG_INFO("  Scene loaded: {} meshes, {} nodes, {} materials",
+                loadedScene.meshes.size(), loadedScene.nodes.size(),
+                loadedScene.materials.size());
+
+    return std::make_unique<GpuScene>(context, std::move(loadedScene), config);
+}
+
+String GpuScene::Key(const Config& config) {
+    std::ostringstream key;
+    for (const char* section : {"scene", "material", "textures", "spectral_materials", "thermal"}) {
+        if (auto table = config.GetTable(section); table.has_value()) {
+            key << '[' << section << "]\n" << table.value().GetRoot() << '\n';
+        }
+    }
+    key << "rgb_to_spectrum_table = " << config.Get<String>("spectral.rgb_to_spectrum_table", "");
+    return key.str();
+}
+
+GpuScene::GpuScene(VulkanContext& context, Scene scene, const Config& config)
+    : m_context(context)
+    , m_id(s_nextSceneId.fetch_add(1))
+    , m_scene(std::move(scene))
+    , m_tlas(context)
+    , m_textureManager(context) {
+
+    // ========================================================================
+    // RGB-to-Spectrum Uplifting
+    // ========================================================================
+    // Material colours become smooth spectra evaluated at the render
+    // wavelength (CPU: base colour factors, GPU: per texel via binding 8).
+    // Without a table, materials fall back to the grey (R + G + B) / 3.
+    {
+        QL_PROFILE_SCOPE("Spectral materials");
+        String rgbToSpectrumPath = config.Get<String>("spectral.rgb_to_spectrum_table", "");
+        if (!rgbToSpectrumPath.empty()) {
+            m_rgbToSpectrum = RgbToSpectrumLoader::LoadHDF5(rgbToSpectrumPath);
+            if (!m_rgbToSpectrum) {
+                QL_LOG_WARN("RGB-to-spectrum table unavailable, using grey material reflectance");
+            }
+        }
+
+        // Measured spectral materials: materials whose name (or
+        // [spectral_materials.bindings] alias) matches a library spectrum use
+        // the measured reflectance instead of the uplift. The library is
+        // resampled to each job's bands (BuildSpectralMaterials)
+        String spectralLibraryPath = config.Get<String>("spectral_materials.library", "");
+        if (!spectralLibraryPath.empty()) {
+            m_spectralLibrary = SpectralLibraryLoader::Load(spectralLibraryPath);
+            if (m_spectralLibrary) {
+                if (auto bindings = config.GetTable("spectral_materials.bindings"); bindings.has_value()) {
+                    for (const auto& [key, node] : bindings.value().GetRoot()) {
+                        if (auto target = node.value<std::string>()) {
+                            m_spectralAliases[String(key.str())] = *target;
+                        }
+                    }
+                }
+            } else {
+                QL_LOG_WARN("Spectral material library unavailable, using uplifted material colours");
+            }
+        }
+    }
+
+    // ========================================================================
+    // Thermal Emission
+    // ========================================================================
+    // Materials get a temperature from [thermal.temperatures] (or the
+    // ambient temperature) and optionally a per-texel map from
+    // [thermal.temperature_maps]. Band-integrated Planck radiance is
+    // tabulated per job (binding 10).
+    {
+        QL_PROFILE_SCOPE("Thermal");
+        f32 ambientTemperature = config.Get<f32>("thermal.ambient_temperature_k", 0.0f);
+        auto findMaterial = [&](std::string_view name) {
+            return std::find_if(m_scene.materials.begin(), m_scene.materials.end(),
+                                [&](const Material& m) { return m.name == name; });
+        };
+        for (auto& mat : m_scene.materials) {
+            mat.temperatureK = ambientTemperature;
+        }
+        if (auto temperatures = config.GetTable("thermal.temperatures"); temperatures.has_value()) {
+            for (const auto& [key, node] : temperatures.value().GetRoot()) {
+                auto value = node.value<double>();
+                auto it = findMaterial(key.str());
+                if (!value || it == m_scene.materials.end()) {
+                    QL_LOG_WARN("thermal.temperatures: Ignoring entry '{}'", key.str());
+                    continue;
+                }
+                it->temperatureK = static_cast<f32>(*value);
+            }
+        }
+        if (auto maps = config.GetTable("thermal.temperature_maps"); maps.has_value()) {
+            for (const auto& [key, node] : maps.value().GetRoot()) {
+                auto path = node.value<std::string>();
+                auto it = findMaterial(key.str());
+                if (!path || it == m_scene.materials.end()) {
+                    QL_LOG_WARN("thermal.temperature_maps: Ignoring entry '{}'", key.str());
+                    continue;
+                }
+
+                glm::vec2 rangeK;
+                auto texture = LoadTemperatureMap(*path, rangeK);
+                if (!texture) {
+                    QL_LOG_WARN("Failed to load temperature map {}", *path);
+                    continue;
+                }
+                if (config.Get<bool>("textures.generate_mips", true)) {
+                    MipGenerator::GenerateMips(*texture);
+                }
+                it->temperatureTextureIndex = static_cast<i32>(m_scene.textures.size());
+                it->temperatureRangeK = rangeK;
+                m_scene.textures.push_back(std::move(*texture));
+                QL_LOG_INFO("  Temperature map for '{}': {} ({:.1f}-{:.1f} K)",
+                            it->name, *path, rangeK.x, rangeK.y);
+            }
+        }
+
+        auto rangeArray = config.GetArray<f32>("thermal.temperature_range_k");
+        if (rangeArray.size() == 2) {
+            m_planckMinK = rangeArray[0];
+            m_planckMaxK = rangeArray[1];
+        }
+        m_planckBins = config.Get<u32>("thermal.temperature_bins", PlanckTable::DEFAULT_TEMPERATURE_BINS);
+    }
+
+    // ========================================================================
+    // Geometry and Acceleration Structures
+    // ========================================================================
+    {
+        QL_PROFILE_SCOPE("Upload geometry");
+
+        // M2: Build BLAS for each primitive in each mesh
+        // This allows per-primitive materials and proper glTF support
+        for (const auto& mesh : m_scene.meshes) {
+            for (const auto& primitive : mesh.primitives) {
+                m_blasList.emplace_back(context, primitive);
+            }
+        }
+
+        u32 totalTriangles = 0;
+        for (const auto& mesh : m_scene.meshes) {
+            totalTriangles += mesh.GetTotalTriangleCount();
+        }
+
+        QL_LOG_INFO("  Created {} BLAS(es) for {} total triangles",
+                    m_blasList.size(), totalTriangles);
+    }
+    {
+        QL_PROFILE_SCOPE("Build acceleration structures");
+        QL_LOG_INFO("Building acceleration structures...");
+
+        CommandHelper::ExecuteImmediate(context, [&](VkCommandBuffer cmd) {
+            // Build all BLAS
+            for (auto& blas : m_blasList) {
+                blas.Build(cmd);
+            }
+
+            // Add instances to TLAS
+            size_t blasIndex = 0;
+            for (const auto& node : m_scene.nodes) {
+                const Mesh& mesh = m_scene.meshes[node.meshIndex];
+
+                for (size_t primIdx = 0; primIdx < mesh.primitives.size(); ++primIdx) {
+                    const auto& primitive = mesh.primitives[primIdx];
+                    m_tlas.AddInstance(
+                        m_blasList[blasIndex],
+                        primitive.materialId,
+                        node.transform
+                    );
+                    ++blasIndex;
+                }
+            }
+
+            m_tlas.Build(cmd);
+        });
+
+        QL_LOG_INFO("  TLAS built with {} instance(s)", m_scene.nodes.size());
+    }
+
+    // ========================================================================
+    // Textures and Spectral Tables
+    // ========================================================================
+    {
+        QL_PROFILE_SCOPE("Upload textures");
+        QL_LOG_INFO("Uploading textures to GPU...");
+
+        m_textureManager.UploadTextures(m_scene.textures);
+        QL_LOG_INFO("  {} textures uploaded", m_textureManager.GetTextureCount());
+
+        // RGB-to-spectrum table for per-texel uplifting (resolution 0 = grey fallback)
+        std::vector<f32> rgbToSpectrumData = m_rgbToSpectrum ? m_rgbToSpectrum->PackForGpu()
+                                                             : std::vector<f32>(4, 0.0f);
+        m_rgbToSpectrumBuffer = std::make_unique<GpuBuffer>(
+            context.GetAllocator(),
+            rgbToSpectrumData.size() * sizeof(f32),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VMA_MEMORY_USAGE_CPU_TO_GPU
+        );
+        m_rgbToSpectrumBuffer->Upload(rgbToSpectrumData.data(), rgbToSpectrumData.size() * sizeof(f32));
+    }
+
+    // ========================================================================
+    // Material Buffer (PBR)
+    // ========================================================================
+    {
+        QL_PROFILE_SCOPE("Upload materials");
+        QL_LOG_INFO("Creating PBR material buffer...");
+
+        // Upload all materials with full PBR parameters
+        m_materialData.reserve(m_scene.materials.size());
+
+        for (const auto& mat : m_scene.materials) {
+            MaterialDataCPU cpuMat;
+
+            // Base color
+            cpuMat.baseColorFactor = mat.baseColorFactor;
+            cpuMat.baseColorTextureIndex = mat.baseColorTextureIndex;
+
+            // Metallic-Roughness
+            cpuMat.metallicFactor = mat.metallicFactor;
+            cpuMat.roughnessFactor = mat.roughnessFactor;
+            cpuMat.metallicRoughnessTextureIndex = mat.metallicRoughnessTextureIndex;
+
+            // Normal mapping
+            cpuMat.normalTextureIndex = mat.normalTextureIndex;
+            cpuMat.normalScale = mat.normalScale;
+
+            // Emissive
+            cpuMat.emissiveFactor = mat.emissiveFactor;
+            cpuMat.emissiveTextureIndex = mat.emissiveTextureIndex;
+
+            // Alpha mode
+            cpuMat.alphaMode = static_cast<u32>(mat.alphaMode);
+            cpuMat.alphaCutoff = mat.alphaCutoff;
+
+            // Spectral (M1 compatibility; per band in SetBand)
+            cpuMat.spectralAlbedo = mat.spectralAlbedo;
+
+            // Samplers are deduplicated, so each texture slot carries its own sampler index
+            cpuMat.baseColorSamplerIndex = m_textureManager.GetSamplerIndex(mat.baseColorTextureIndex);
+            cpuMat.metallicRoughnessSamplerIndex = m_textureManager.GetSamplerIndex(mat.metallicRoughnessTextureIndex);
+            cpuMat.normalSamplerIndex = m_textureManager.GetSamplerIndex(mat.normalTextureIndex);
+            cpuMat.emissiveSamplerIndex = m_textureManager.GetSamplerIndex(mat.emissiveTextureIndex);
+            cpuMat.spectralMaterialIndex = mat.spectralMaterialIndex;
+
+            // Thermal emission
+            cpuMat.temperatureK = mat.temperatureK;
+            cpuMat.temperatureTextureIndex = mat.temperatureTextureIndex;
+            cpuMat.temperatureSamplerIndex = m_textureManager.GetSamplerIndex(mat.temperatureTextureIndex);
+            cpuMat.temperatureMinK = mat.temperatureRangeK.x;
+            cpuMat.temperatureMaxK = mat.temperatureRangeK.y;
+            cpuMat._pad0 = 0.0f;
+
+            m_materialData.push_back(cpuMat);
+
+            QL_LOG_INFO("  Material '{}': base=[{:.2f},{:.2f},{:.2f},{:.2f}] metal={:.2f} rough={:.2f}",
+                        mat.name,
+                        mat.baseColorFactor.r, mat.baseColorFactor.g, mat.baseColorFactor.b, mat.baseColorFactor.a,
+                        mat.metallicFactor, mat.roughnessFactor);
+        }
+
+        m_materialBuffer = std::make_unique<GpuBuffer>(
+            context.GetAllocator(),
+            m_materialData.size() * sizeof(MaterialDataCPU),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VMA_MEMORY_USAGE_CPU_TO_GPU
+        );
+        UploadMaterials();
+    }
+}
+
+void GpuScene::Bind(RayTracingPipeline& pipeline) const {
+    pipeline.BindAccelerationStructure(m_tlas.GetHandle());           // Binding 1
+
+    // Use first BLAS for geometry buffers (all BLAS share same vertex/index binding)
+    if (!m_blasList.empty()) {
+        pipeline.BindGeometryBuffers(m_blasList[0].GetVertexBuffer(), m_blasList[0].GetIndexBuffer()); // Binding 3, 4
+    }
+
+    pipeline.BindMaterialBuffer(*m_materialBuffer);                   // Binding 5
+
+    // Bind textures (bindless arrays)
+    pipeline.BindTextures(m_textureManager.GetImageViews(), m_textureManager.GetSamplers()); // Binding 6, 7
+    pipeline.BindSpectrumTableBuffer(*m_rgbToSpectrumBuffer);         // Binding 8
+}
+
+SpectralMaterialTable GpuScene::BuildSpectralMaterials(const std::vector<SpectralBand>& bands) {
+    if (!m_spectralLibrary) {
+        return {};
+    }
+    return SpectralMaterialTable::Build(*m_spectralLibrary, m_scene.materials, bands, m_spectralAliases);
+}
+
+PlanckTable GpuScene::BuildPlanckTable(const std::vector<SpectralBand>& bands) const {
+    const bool hasThermal = std::any_of(m_scene.materials.begin(), m_scene.materials.end(),
+                                        [](const Material& m) { return m.IsThermalEmitter(); });
+    if (!hasThermal) {
+        return {};
+    }
+    return PlanckTable::Build(bands, m_planckMinK, m_planckMaxK, m_planckBins);
+}
+
+void GpuScene::SetBand(const SpectralMaterialTable& table, u32 band, f32 wavelengthNm) {
+    for (usize i = 0; i < m_scene.materials.size(); ++i) {
+        Material& mat = m_scene.materials[i];
+        if (mat.spectralMaterialIndex >= 0) {
+            mat.spectralAlbedo = table.At(static_cast<u32>(mat.spectralMaterialIndex), band).reflectance;
+        } else if (m_rgbToSpectrum) {
+            mat.ComputeSpectralAlbedo(*m_rgbToSpectrum, wavelengthNm);
+        }
+        m_materialData[i].spectralAlbedo = mat.spectralAlbedo;
+        m_materialData[i].spectralMaterialIndex = mat.spectralMaterialIndex;
+    }
+    UploadMaterials();
+}
+
+void GpuScene::UploadMaterials() {
+    m_materialBuffer->Upload(m_materialData.data(), m_materialData.size() * sizeof(MaterialDataCPU));
+}
+
+// ============================================================================
+// RenderSession
+// ============================================================================
+
+// One job between Render() and its output being written
+struct RenderSession::PendingJob {
+    RenderJob job;
+    RenderStats stats;
+    FinishedCallback onFinished;
+    Clock::time_point start;
+    std::vector<f32> bandPixels;   // HS-OFF: one band of the cube
+    Clock::time_point outputDone;  // Last output task finished
+
+    // HS-OFF output. Opened by the first output task, so every HDF5 call of
+    // the job runs there and not alongside the previous job's output.
+    SpectralCube cubeHeader;
+    SpectralCubeWriter cube;
+
+    // Checkpoints (output thread): finished bands and their store
+    std::vector<u8> bandsDone;
+    CheckpointBandStore bandStore;
+};
+
+RenderSession::RenderSession(VulkanContext& context)
+    : m_context(context)
+    , m_pipeline(context, "raygen.spv", "closesthit.spv", "miss.spv")
+    , m_lutBuffer(context.GetAllocator(), sizeof(LUTData),
+                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU) {
+    // The buffers below are uploaded as arrays of these C++ structs; the
+    // shaders must index them with the same stride
+    const std::pair<u32, usize> strides[] = {
+        {2, sizeof(LUTData)},
+        {3, sizeof(glm::vec3)},
+        {5, sizeof(MaterialDataCPU)},
+        {9, sizeof(SpectralMaterialTable::Entry)},
+    };
+    for (const auto& [binding, size] : strides) {
+        const u32 stride = m_pipeline.GetBufferStride(binding);
+        if (stride != size) {
+            throw std::runtime_error(fmt::format("Shader stride of binding {} is {} bytes, the C++ struct has {} "
+                                                 "(stale SPIR-V? rebuild the CompileShaders target)",
+                                                 binding, stride, size));
+        }
+    }
+
+    m_pipeline.BindLUTBuffer(m_lutBuffer);                            // Binding 2
+}
+
+RenderSession::~RenderSession() {
+    // Outputs still in flight reference the session
+    m_output.Wait();
+}
+
+void RenderSession::PrepareImages(u32 width, u32 height) {
+    if (m_outputImage && width == m_width && height == m_height) {
+        return;
+    }
+    QL_LOG_INFO("Creating output images ({}x{})...", width, height);
+
+    m_outputImage = std::make_unique<GpuImage>(
+        m_context.GetAllocator(),
+        m_context.GetDevice(),
+        width, height,
+        VK_FORMAT_R32G32B32A32_SFLOAT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY
+    );
+
+    // First-hit AOVs (albedo, depth, octahedral normal) for the denoiser
+    m_aovImage = std::make_unique<GpuImage>(
+        m_context.GetAllocator(),
+        m_context.GetDevice(),
+        width, height,
+        VK_FORMAT_R32G32B32A32_SFLOAT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY
+    );
+
+    for (const GpuImage* image : {m_outputImage.get(), m_aovImage.get()}) {
+        CommandHelper::TransitionImageLayoutImmediate(
+            m_context,
+            image->GetImage(),
+            image->GetFormat(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL
+        );
+    }
+
+    m_pipeline.BindOutputImage(*m_outputImage);                       // Binding 0
+    m_pipeline.BindAovImage(*m_aovImage);                             // Binding 11
+    m_width = width;
+    m_height = height;
+}
+
+void RenderSession::PrepareBandTables(GpuScene& scene, const std::vector<SpectralBand>& bands) {
+    const bool sameBands = std::equal(bands.begin(), bands.end(), m_tableBands.begin(), m_tableBands.end(),
+                                      [](const SpectralBand& a, const SpectralBand& b) {
+                                          return a.center_nm == b.center_nm && a.fwhm_nm == b.fwhm_nm;
+                                      });
+    if (scene.GetId() == m_boundSceneId && sameBands && m_spectralMaterialBuffer) {
+        return;
+    }
+    QL_PROFILE_SCOPE("Band tables");
+
+    // Measured material table, (reflectance, emissivity) per [row][band]
+    // (one dummy entry when no material is bound; no material indexes it)
+    m_spectralMaterials = scene.BuildSpectralMaterials(bands);
+    std::vector<SpectralMaterialTable::Entry> spectralMaterialData = m_spectralMaterials.entries;
+    if (spectralMaterialData.empty()) {
+        spectralMaterialData.push_back({});
+    }
+    m_spectralMaterialBuffer = std::make_unique<GpuBuffer>(
+        m_context.GetAllocator(),
+        spectralMaterialData.size() * sizeof(SpectralMaterialTable::Entry),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VMA_MEMORY_USAGE_CPU_TO_GPU
+    );
+    m_spectralMaterialBuffer->Upload(spectralMaterialData.data(),
+                                     spectralMaterialData.size() * sizeof(SpectralMaterialTable::Entry));
+
+    // Planck table (header only, 0 bins = no thermal emission)
+    PlanckTable planckTable = scene.BuildPlanckTable(bands);
+    std::vector<f32> planckData = planckTable.IsValid() ? planckTable.PackForGpu()
+                                                        : std::vector<f32>(4, 0.0f);
+    m_planckBuffer = std::make_unique<GpuBuffer>(
+        m_context.GetAllocator(),
+        planckData.size() * sizeof(f32),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VMA_MEMORY_USAGE_CPU_TO_GPU
+    );
+    m_planckBuffer->Upload(planckData.data(), planckData.size() * sizeof(f32));
+
+    m_pipeline.BindSpectralMaterialBuffer(*m_spectralMaterialBuffer);  // Binding 9
+    m_pipeline.BindPlanckTableBuffer(*m_planckBuffer);                // Binding 10
+    m_boundSceneId = scene.GetId();
+    m_tableBands = bands;
+}
+
+void RenderSession::Render(GpuScene& scene, const RenderJob& job, FinishedCallback onFinished) {
+    QL_PROFILE_SCOPE("RenderSession::Render");
+
+    // The last job's output keeps running; it is retired at this job's first
+    // WaitForOutput(), i.e. once this job has rendered its first band
+    if (m_previous) {
+        WaitForOutput();
+    }
+    m_previous = std::move(m_pending);
+
+    auto pending = std::make_shared<PendingJob>();
+    pending->job = job;
+    pending->onFinished = std::move(onFinished);
+    pending->start = Clock::now();
+    pending->stats.jobName = job.name;
+    pending->stats.outputPath = job.outputPath;
+    pending->stats.width = job.RenderWidth();
+    pending->stats.height = job.RenderHeight();
+    pending->stats.bandCount = static_cast<u32>(job.bands.size());
+    m_pending = pending;
+    RenderStats& stats = pending->stats;
+
+    const u32 width = job.RenderWidth();
+    const u32 height = job.RenderHeight();
+    const u32 bandCount = static_cast<u32>(job.bands.size());
+    const bool hsOff = job.IsHsOff();
+    const usize pixelCount = static_cast<usize>(width) * height;
+    const u32 spp = std::max(job.spp, 1u);
+    const u32 passSamples = (job.samplesPerPass == 0) ? spp : std::min(job.samplesPerPass, spp);
+    const bool checkpointing = !job.checkpointPath.empty() && !job.keepPixels;
+
+    try {
+        // ====================================================================
+        // Per-job State
+        // ====================================================================
+        Clock::time_point phaseStart = Clock::now();
+        PrepareImages(width, height);
+        if (scene.GetId() != m_boundSceneId) {
+            scene.Bind(m_pipeline);
+        }
+        PrepareBandTables(scene, job.bands);
+
+        // ====================================================================
+        // Checkpoint / Resume
+        // ====================================================================
+        std::optional<RenderCheckpoint> resumed;
+        if (checkpointing) {
+            // The previous job may still write or remove checkpoint files
+            WaitForOutput();
+            pending->bandsDone.assign(bandCount, 0);
+            if (job.resume) {
+                resumed = CheckpointFile::Read(job.checkpointPath);
+                if (!resumed) {
+                    QL_LOG_WARN("No usable checkpoint at {}, rendering from the start", job.checkpointPath);
+                } else if (resumed->fingerprint != job.fingerprint || resumed->width != width ||
+                           resumed->height != height || resumed->bandCount != bandCount ||
+                           resumed->spp != spp || resumed->seed != job.seed) {
+                    stats.error = fmt::format("Checkpoint {} was written for another config or scene "
+                                              "(delete it or run without --resume)", job.checkpointPath);
+                    Complete();
+                    return;
+                }
+            }
+            // Finished bands (HS-OFF) go to the band store next to the checkpoint
+            if (hsOff && !pending->bandStore.Open(job.checkpointPath + ".bands", pixelCount, resumed.has_value())) {
+                stats.error = "Failed to open checkpoint band store " + job.checkpointPath + ".bands";
+                Complete();
+                return;
+            }
+            if (resumed) {
+                pending->bandsDone = resumed->bandsDone;
+                if (!hsOff) {
+                    std::fill(pending->bandsDone.begin(), pending->bandsDone.end(), 0);
+                }
+                QL_LOG_INFO("Resuming from {}: {}/{} band(s) done, band {} at sample {}/{}", job.checkpointPath,
+                            std::count(pending->bandsDone.begin(), pending->bandsDone.end(), 1), bandCount,
+                            resumed->band, resumed->nextSample, spp);
+            }
+        }
+        Clock::time_point lastCheckpoint = Clock::now();
+
+        if (job.keepPixels) {
+            stats.pixels.assign(static_cast<usize>(width) * height * bandCount, 0.0f);
+        } else if (hsOff) {
+            // Header only: the writer takes dimensions, wavelengths and metadata
+            SpectralCube& header = pending->cubeHeader;
+            header.width = width;
+            header.height = height;
+            header.nbands = bandCount;
+            header.lambda_min = job.bands.front().center_nm;
+            header.lambda_max = job.bands.back().center_nm;
+            header.delta_lambda = (bandCount > 1)
+                ? (header.lambda_max - header.lambda_min) / static_cast<f32>(bandCount - 1)
+                : 0.0f;
+            for (const auto& band : job.bands) {
+                header.wavelengths.push_back(band.center_nm);
+            }
+            header.metadata["renderer"] = "Quantiloom Spectral";
+            header.metadata["mode"] = job.spectralMode;
+            header.metadata["resolution"] = std::to_string(job.width) + "x" + std::to_string(job.height);
+            header.metadata["spp"] = std::to_string(job.spp);
+            if (job.psfType != "none") {
+                header.metadata["psf"] = job.psfType;
+            }
+            for (const auto& [key, value] : job.metadata) {
+                header.metadata[key] = value;
+            }
+
+            if (job.writeAovs) {
+                QL_LOG_WARN("renderer.aovs: AOV channels are not written to HS-OFF cubes");
+            }
+            pending->bandPixels.resize(static_cast<usize>(width) * height);
+        }
+
+        // Convert RGB radiance to spectral radiance (average of RGB channels)
+        // For single-wavelength mode, we approximate spectral radiance from RGB config
+        LUTData lutData;
+        lutData.sunDirection = job.sunDirection;
+        lutData.sunRadiance_spectral = (job.sunRadiance.r + job.sunRadiance.g + job.sunRadiance.b) / 3.0f;
+        lutData.skyRadiance_spectral = (job.skyRadiance.r + job.skyRadiance.g + job.skyRadiance.b) / 3.0f;
+        lutData.spectralBandCount = m_spectralMaterials.bandCount;
+
+        CameraData cameraData = job.camera.GetCameraData();
+        cameraData.tileOffsetX = job.tileX;
+        cameraData.tileOffsetY = job.tileY;
+        cameraData.imageWidth = job.width;
+        cameraData.imageHeight = job.height;
+        cameraData.seedLo = static_cast<u32>(job.seed);
+        cameraData.seedHi = static_cast<u32>(job.seed >> 32);
+        stats.updateSeconds += SecondsSince(phaseStart);
+
+        const bool readAovs = (job.writeAovs && !hsOff && !job.keepPixels) || job.denoise;
+        for (u32 band = 0; band < bandCount; ++band) {
+            const f32 bandWavelength = job.bands[band].center_nm;
+            const bool lastBand = (band + 1 == bandCount);
+
+            // Finished before the checkpoint: stream the stored band (cube
+            // bands are written in order)
+            if (checkpointing && pending->bandsDone[band]) {
+                WaitForOutput();
+                if (!stats.error.empty()) {
+                    break;
+                }
+                m_output.Run([this, pending, band, lastBand]() {
+                    try {
+                        RestoreBand(*pending, band, lastBand);
+                    } catch (const std::exception& e) {
+                        pending->stats.error = e.what();
+                    }
+                    pending->outputDone = Clock::now();
+                });
+                continue;
+            }
+
+            // Band inputs: material reflectances, LUT, camera wavelength
+            phaseStart = Clock::now();
+            scene.SetBand(m_spectralMaterials, band, bandWavelength);
+            lutData.wavelength_nm = bandWavelength;
+            lutData.spectralBand = band;
+            m_lutBuffer.Upload(&lutData, sizeof(LUTData));
+            cameraData.wavelength_nm = bandWavelength;
+            stats.updateSeconds += SecondsSince(phaseStart);
+
+            if (hsOff) {
+                QL_LOG_INFO("Rendering band {}/{} at wavelength {:.1f} nm...", band + 1, bandCount, bandWavelength);
+            } else {
+                QL_LOG_INFO("Rendering frame at wavelength {:.1f} nm...", bandWavelength);
+            }
+
+            // Passes of passSamples samples; more than one pass (or a resumed
+            // band) sums them on the host, weighted by their sample counts
+            u32 sample = 0;
+            std::vector<f32> sum;
+            std::vector<u32> sampleCounts;
+            if (resumed && resumed->band == band && resumed->nextSample > 0) {
+                sample = resumed->nextSample;
+                sum = std::move(resumed->sum);
+                sampleCounts = std::move(resumed->sampleCounts);
+            }
+
+            std::vector<f32> pixels;
+            std::vector<f32> aovPixels;
+            while (sample < spp) {
+                const u32 count = std::min(passSamples, spp - sample);
+                const bool lastPass = (sample + count == spp);
+                cameraData.sampleStart = job.sampleStart + sample;
+                cameraData.sampleCount = count;
+                m_pipeline.SetCameraData(cameraData);
+
+                // ============================================================
+                // Render Frame
+                // ============================================================
+                QL_LOG_DEBUG("  Submitting TraceRays (samples {}-{})...", sample, sample + count - 1);
+                phaseStart = Clock::now();
+                {
+                    QL_PROFILE_SCOPE("Render");
+                    try {
+                        CommandHelper::ExecuteImmediate(m_context, [&](VkCommandBuffer cmd) {
+                            m_pipeline.TraceRays(cmd, width, height);
+                        });
+                    } catch (const std::exception& e) {
+                        QL_LOG_ERROR("  GPU execution failed: {}", e.what());
+                        throw;
+                    }
+                }
+                stats.renderSeconds += SecondsSince(phaseStart);
+
+                // ============================================================
+                // Readback (AOVs of the last pass)
+                // ============================================================
+                phaseStart = Clock::now();
+                {
+                    QL_PROFILE_SCOPE("Readback");
+                    pixels = CommandHelper::ReadbackImage(
+                        m_context,
+                        m_outputImage->GetImage(),
+                        m_outputImage->GetFormat(),
+                        width,
+                        height
+                    );
+                    if (readAovs && lastPass) {
+                        aovPixels = CommandHelper::ReadbackImage(
+                            m_context,
+                            m_aovImage->GetImage(),
+                            m_aovImage->GetFormat(),
+                            width,
+                            height
+                        );
+                    }
+                }
+                stats.readbackSeconds += SecondsSince(phaseStart);
+
+                if (!(sample == 0 && lastPass)) {
+                    if (sum.empty()) {
+                        sum.assign(pixelCount * 4, 0.0f);
+                        sampleCounts.assign(pixelCount, 0);
+                    }
+                    const f32 weight = static_cast<f32>(count);
+                    for (usize i = 0; i < pixelCount * 4; ++i) {
+                        sum[i] += pixels[i] * weight;
+                    }
+                    for (usize i = 0; i < pixelCount; ++i) {
+                        sampleCounts[i] += count;
+                    }
+                }
+                sample += count;
+
+                // Periodic checkpoint of the band in progress
+                if (checkpointing && !lastPass && SecondsSince(lastCheckpoint) >= job.checkpointIntervalSeconds) {
+                    RenderCheckpoint checkpoint;
+                    checkpoint.band = band;
+                    checkpoint.nextSample = sample;
+                    checkpoint.sum = sum;
+                    checkpoint.sampleCounts = sampleCounts;
+                    WaitForOutput();
+                    m_output.Run([this, pending, checkpoint = std::move(checkpoint)]() mutable {
+                        SaveCheckpoint(*pending, checkpoint);
+                        pending->outputDone = Clock::now();
+                    });
+                    lastCheckpoint = Clock::now();
+                }
+            }
+            if (!sum.empty()) {
+                for (usize i = 0; i < pixelCount * 4; ++i) {
+                    pixels[i] = sum[i] / static_cast<f32>(sampleCounts[i / 4]);
+                }
+            }
+
+            // The previous band's output (or the previous job's) must be
+            // written before this one (ordered cube writes, HDF5 on one
+            // thread); stop early if it failed
+            WaitForOutput();
+            if (!stats.error.empty()) {
+                break;
+            }
+
+            // Checkpoint after this band is written (it is marked done then)
+            std::optional<RenderCheckpoint> checkpoint;
+            if (checkpointing && !lastBand && SecondsSince(lastCheckpoint) >= job.checkpointIntervalSeconds) {
+                checkpoint.emplace();
+                checkpoint->band = band + 1;
+                lastCheckpoint = Clock::now();
+            }
+
+            // ================================================================
+            // Post-process and Save (thread pool, overlaps the next frame)
+            // ================================================================
+            m_output.Run([this, pending, band, lastBand, pixels = std::move(pixels),
+                          aovPixels = std::move(aovPixels), checkpoint = std::move(checkpoint)]() mutable {
+                const Clock::time_point finishStart = Clock::now();
+                try {
+                    FinishFrame(*pending, band, lastBand, pixels, aovPixels);
+                    if (checkpoint && pending->stats.error.empty()) {
+                        SaveCheckpoint(*pending, *checkpoint);
+                    }
+                } catch (const std::exception& e) {
+                    pending->stats.error = e.what();
+                }
+                pending->stats.finishSeconds += SecondsSince(finishStart);
+                pending->outputDone = Clock::now();
+            });
+        }
+    } catch (const std::exception& e) {
+        stats.error = e.what();
+        Complete();
+        throw;
+    }
+}
+
+void RenderSession::FinishFrame(PendingJob& pending, u32 band, bool lastBand,
+                                const std::vector<f32>& pixels, const std::vector<f32>& aovPixels) {
+    QL_PROFILE_SCOPE("Post-process");
+    const RenderJob& job = pending.job;
+    const u32 width = job.RenderWidth();
+    const u32 height = job.RenderHeight();
+    const f32 bandWavelength = job.bands[band].center_nm;
+
+    // Convert to Image object (4 channels: RGBA)
+    Image img(width, height, 4);
+    img.channelNames = {"R", "G", "B", "A"};
+    img.metadata["renderer"] = "Quantiloom Spectral";
+    img.metadata["mode"] = job.spectralMode;
+    img.metadata["wavelength_nm"] = std::to_string(bandWavelength);
+    img.metadata["resolution"] = std::to_string(job.width) + "x" + std::to_string(job.height);
+    img.metadata["spp"] = std::to_string(job.spp);
+    for (const auto& [key, value] : job.metadata) {
+        img.metadata[key] = value;
+    }
+    std::copy(pixels.begin(), pixels.end(), img.data.begin());
+
+    // AOVs: denoiser guides and optional extra output channels
+    AovBuffers aovs;
+    if (!aovPixels.empty()) {
+        aovs = AovBuffers::Unpack(aovPixels, width, height);
+    }
+
+    // Edge-avoiding a-trous denoiser (preview only, off for validation runs)
+    if (job.denoise && AtrousDenoiser::Apply(img, aovs, job.denoiseParams)) {
+        QL_LOG_DEBUG("  [OK] Denoised ({} a-trous iterations)", job.denoiseParams.iterations);
+    }
+
+    // Sensor chain: optical PSF ([sensor.psf], off by default; Airy per band)
+    if (job.psfType != "none") {
+        PsfKernel psf = (job.psfType == "gaussian")
+                            ? PsfKernel::Gaussian(job.psfSigmaPx, job.psfSigmaPx)
+                            : PsfKernel::Airy(bandWavelength, job.psfFNumber, job.psfPixelPitchUm);
+        if (psf.IsValid() && PsfConvolution::Apply(img, {psf})) {
+            QL_LOG_DEBUG("  [OK] Applied {} PSF ({}x{} taps)", job.psfType, psf.width, psf.height);
+            img.metadata["psf"] = job.psfType;
+        }
+    }
+
+    if (job.keepPixels) {
+        f32* bandPixels = pending.stats.pixels.data() + static_cast<usize>(band) * width * height;
+        for (usize i = 0; i < static_cast<usize>(width) * height; ++i) {
+            bandPixels[i] = img.data[i * 4];
+        }
+        return;
+    }
+
+    if (job.IsHsOff()) {
+        // Grey output: the R channel carries the band radiance
+        for (usize i = 0; i < pending.bandPixels.size(); ++i) {
+            pending.bandPixels[i] = img.data[i * 4];
+        }
+        if (!OpenCube(pending)) {
+            return;
+        }
+        if (!pending.cube.WriteBands(band, 1, pending.bandPixels.data())) {
+            pending.stats.error = fmt::format("Failed to write band {} to {}", band, job.outputPath);
+            return;
+        }
+        // Synced to the band store before a checkpoint can mark it done
+        if (pending.bandStore.IsOpen() && pending.bandStore.Write(band, pending.bandPixels.data())) {
+            pending.bandsDone[band] = 1;
+        }
+        if (lastBand) {
+            if (!pending.cube.Close()) {
+                pending.stats.error = "Failed to save spectral cube to " + job.outputPath;
+                return;
+            }
+            QL_LOG_INFO("  [OK] Saved {}-band spectral cube to {}", job.bands.size(), job.outputPath);
+        }
+        return;
+    }
+
+    if (job.writeAovs) {
+        aovs.AppendTo(img);
+    }
+
+    // Save as EXR
+    if (!ImageIO::WriteEXR(job.outputPath, img, job.outputFormat)) {
+        pending.stats.error = "Failed to save image to " + job.outputPath;
+        return;
+    }
+    QL_LOG_INFO("  [OK] Saved spectral image to {}", job.outputPath);
+}
+
+void RenderSession::RestoreBand(PendingJob& pending, u32 band, bool lastBand) {
+    QL_PROFILE_SCOPE("Restore band");
+    const RenderJob& job = pending.job;
+    if (!pending.bandStore.Read(band, pending.bandPixels.data())) {
+        pending.stats.error = fmt::format("Failed to restore band {} from {}.bands", band, job.checkpointPath);
+        return;
+    }
+    if (!OpenCube(pending)) {
+        return;
+    }
+    if (!pending.cube.WriteBands(band, 1, pending.bandPixels.data())) {
+        pending.stats.error = fmt::format("Failed to write band {} to {}", band, job.outputPath);
+        return;
+    }
+    if (lastBand) {
+        if (!pending.cube.Close()) {
+            pending.stats.error = "Failed to save spectral cube to " + job.outputPath;
+            return;
+        }
+        QL_LOG_INFO("  [OK] Saved {}-band spectral cube to {}", job.bands.size(), job.outputPath);
+    }
+}
+
+bool RenderSession::OpenCube(PendingJob& pending) {
+    if (pending.cube.IsOpen()) {
+        return true;
+    }
+    const RenderJob& job = pending.job;
+    if (!pending.cube.Open(job.outputPath, pending.cubeHeader, job.outputFormat)) {
+        pending.stats.error = "Failed to create spectral cube " + job.outputPath;
+        return false;
+    }
+    return true;
+}
+
+void RenderSession::SaveCheckpoint(PendingJob& pending, RenderCheckpoint& checkpoint) {
+    const RenderJob& job = pending.job;
+    checkpoint.fingerprint = job.fingerprint;
+    checkpoint.width = job.RenderWidth();
+    checkpoint.height = job.RenderHeight();
+    checkpoint.bandCount = static_cast<u32>(job.bands.size());
+    checkpoint.spp = std::max(job.spp, 1u);
+    checkpoint.seed = job.seed;
+    checkpoint.bandsDone = pending.bandsDone;
+
+    // A failed checkpoint is not fatal: the previous one stays valid
+    if (CheckpointFile::Write(job.checkpointPath, checkpoint)) {
+        QL_LOG_INFO("  Checkpoint: band {}/{}, sample {}/{} -> {}", checkpoint.band + 1, checkpoint.bandCount,
+                    checkpoint.nextSample, checkpoint.spp, job.checkpointPath);
+    }
+}
+
+void RenderSession::WaitForOutput() {
+    QL_PROFILE_SCOPE("Wait for output");
+    m_output.Wait();
+    if (m_previous) {
+        Retire(std::move(m_previous));
+        m_previous.reset();
+    }
+}
+
+void RenderSession::Complete() {
+    WaitForOutput();
+    if (m_pending) {
+        Retire(std::move(m_pending));
+        m_pending.reset();
+    }
+}
+
+void RenderSession::Retire(std::shared_ptr<PendingJob> pending) {
+    // Bands after a failure were skipped; drop the partial cube's handle
+    if (pending->cube.IsOpen()) {
+        pending->cube.Close();
+    }
+
+    RenderStats& stats = pending->stats;
+    stats.succeeded = stats.error.empty();
+    const Clock::time_point end = (pending->outputDone > pending->start) ? pending->outputDone : Clock::now();
+    stats.totalSeconds = std::chrono::duration<f64>(end - pending->start).count();
+
+    // Checkpoints are kept until the output is complete
+    pending->bandStore.Close();
+    if (stats.succeeded && !pending->job.checkpointPath.empty() && !pending->job.keepPixels) {
+        CheckpointFile::Remove(pending->job.checkpointPath);
+        std::error_code ec;
+        std::filesystem::remove(pending->job.checkpointPath + ".bands", ec);
+    }
+    if (!stats.succeeded) {
+        QL_LOG_ERROR("  [FAIL] {}: {}", stats.jobName.empty() ? stats.outputPath : stats.jobName, stats.error);
+    }
+    if (pending->onFinished) {
+        pending->onFinished(stats);
+    }
+}
+
+void RenderSession::Finish() {
+    Complete();
+}
+
+} // namespace quantiloom
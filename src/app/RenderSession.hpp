@@ -0,0 +1,334 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Config.hpp"
+#include "core/Image.hpp"
+#include "core/PixelFormat.hpp"
+#include "core/RgbToSpectrum.hpp"
+#include "core/ThreadPool.hpp"
+#include "io/SpectralIO.hpp"
+#include "io/Checkpoint.hpp"
+#include "renderer/VulkanContext.hpp"
+#include "renderer/RayTracingPipeline.hpp"
+#include "renderer/AccelerationStructure.hpp"
+#include "renderer/GpuBuffer.hpp"
+#include "renderer/GpuImage.hpp"
+#include "renderer/TextureManager.hpp"
+#include "scene/Scene.hpp"
+#include "scene/Camera.hpp"
+#include "scene/SpectralBand.hpp"
+#include "scene/SpectralMaterial.hpp"
+#include "scene/PlanckTable.hpp"
+#include "postprocess/AtrousDenoiser.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>  // For offsetof
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// RenderSession - Render many jobs without re-initialising the GPU
+// ============================================================================
+// A render splits into three lifetimes:
+//   - RenderSession  Vulkan pipeline, LUT buffer, output / AOV images (kept
+//                    while the resolution does not change) and the band
+//                    tables of the current job; one per VulkanContext
+//   - GpuScene       loaded scene, BLAS/TLAS, textures, material buffer and
+//                    the spectral inputs (RGB-to-spectrum table, measured
+//                    library, temperatures); one per GpuScene::Key()
+//   - RenderJob      resolution, output, bands, camera, lighting and
+//                    post-processing; cheap to switch between frames
+//
+// Between jobs of one scene only the LUT, the band tables, the material
+// reflectances and the camera push constant are uploaded. Post-processing
+// and writing of a frame run on the thread pool while the GPU renders the
+// next one (at most one frame in flight; HS-OFF bands stream in order).
+//
+// With [checkpoint] enabled, band progress is saved on the same output
+// thread every interval (io/Checkpoint.hpp) and removed once the output is
+// written; RenderJob::resume continues from it.
+//
+// Usage:
+//   VulkanContext context;
+//   RenderSession session(context);
+//   auto scene = GpuScene::Load(context, config);
+//   auto job = RenderJob::FromConfig(config);
+//   session.Render(*scene.value(), job.value(), [](const RenderStats& stats) { ... });
+//   session.Finish();   // Wait for the last output
+// ============================================================================
+
+namespace quantiloom {
+
+// ============================================================================
+// LUT Data Structure (matches shader LUTData structure)
+// ============================================================================
+
+struct LUTData {
+    glm::vec3 sunDirection;        // FROM surface TO sun (normalized)
+    f32 sunRadiance_spectral;       // Spectral radiance at current λ (W·sr⁻¹·m⁻²·nm⁻¹)
+    f32 skyRadiance_spectral;       // Spectral radiance at current λ (W·sr⁻¹·m⁻²·nm⁻¹)
+    f32 wavelength_nm;              // Current wavelength (for RGB-to-spectrum uplifting)
+    u32 spectralBand;               // Column of the measured material table (binding 9)
+    u32 spectralBandCount;          // Columns per material row in binding 9
+};
+
+// ============================================================================
+// Material Data Structure (matches shader MaterialData structure)
+// ============================================================================
+// Must match the layout in common.hlsli exactly for GPU upload
+// ============================================================================
+
+struct MaterialDataCPU {
+    glm::vec4 baseColorFactor;           // offset 0, size 16
+    i32 baseColorTextureIndex;           // offset 16, size 4
+    f32 metallicFactor;                  // offset 20, size 4
+    f32 roughnessFactor;                 // offset 24, size 4
+    i32 metallicRoughnessTextureIndex;   // offset 28, size 4
+
+    i32 normalTextureIndex;              // offset 32, size 4
+    f32 normalScale;                     // offset 36, size 4
+
+    glm::vec3 emissiveFactor;            // offset 40, size 12
+    i32 emissiveTextureIndex;            // offset 52, size 4
+
+    u32 alphaMode;                       // offset 56, size 4
+    f32 alphaCutoff;                     // offset 60, size 4
+
+    f32 spectralAlbedo;                  // offset 64, size 4
+
+    i32 baseColorSamplerIndex;           // offset 68, size 4
+    i32 metallicRoughnessSamplerIndex;   // offset 72, size 4
+    i32 normalSamplerIndex;              // offset 76, size 4
+    i32 emissiveSamplerIndex;            // offset 80, size 4
+
+    i32 spectralMaterialIndex;           // offset 84, size 4
+    f32 temperatureK;                    // offset 88, size 4
+    i32 temperatureTextureIndex;         // offset 92, size 4
+    i32 temperatureSamplerIndex;         // offset 96, size 4
+    f32 temperatureMinK;                 // offset 100, size 4
+    f32 temperatureMaxK;                 // offset 104, size 4
+    f32 _pad0;                           // offset 108, size 4
+};  // Total: 112 bytes (must match GPU MaterialData in common.hlsli)
+
+// Verify struct layout matches shader expectations
+// If this fails, the CPU/GPU struct layouts are mismatched, which WILL cause GPU crashes
+static_assert(sizeof(MaterialDataCPU) == 112, "MaterialDataCPU size mismatch! Expected 112 bytes to match GPU MaterialData struct");
+static_assert(offsetof(MaterialDataCPU, baseColorTextureIndex) == 16, "baseColorTextureIndex offset mismatch");
+static_assert(offsetof(MaterialDataCPU, normalTextureIndex) == 32, "normalTextureIndex offset mismatch");
+static_assert(offsetof(MaterialDataCPU, emissiveFactor) == 40, "emissiveFactor offset mismatch");
+static_assert(offsetof(MaterialDataCPU, emissiveTextureIndex) == 52, "emissiveTextureIndex offset mismatch");
+static_assert(offsetof(MaterialDataCPU, baseColorSamplerIndex) == 68, "baseColorSamplerIndex offset mismatch");
+static_assert(offsetof(MaterialDataCPU, emissiveSamplerIndex) == 80, "emissiveSamplerIndex offset mismatch");
+static_assert(offsetof(MaterialDataCPU, spectralMaterialIndex) == 84, "spectralMaterialIndex offset mismatch");
+static_assert(offsetof(MaterialDataCPU, temperatureMinK) == 100, "temperatureMinK offset mismatch");
+
+// ============================================================================
+// RenderJob - Per-render settings (everything that is not the scene)
+// ============================================================================
+
+struct RenderJob {
+    String name;
+    u32 width = 0;
+    u32 height = 0;
+    u32 spp = 1;
+    String outputPath;
+    PixelFormat outputFormat = PixelFormat::F32;
+
+    // "single_wavelength" (one band, EXR) or "hs_off" (band grid, HDF5 cube)
+    String spectralMode = "single_wavelength";
+    std::vector<SpectralBand> bands;
+
+    Camera camera;
+    glm::vec3 sunDirection{0.0f, 1.0f, 0.0f};   // FROM surface TO sun (normalized)
+    glm::vec3 sunRadiance{0.0f};
+    glm::vec3 skyRadiance{0.0f};
+
+    // Hand the band images to the callback (RenderStats::pixels) instead of
+    // writing outputPath
+    bool keepPixels = false;
+
+    // Region and samples of the full image to render (shards, ShardWorker.hpp):
+    // a tileWidth x tileHeight tile at (tileX, tileY), 0 = whole image, and
+    // samples [sampleStart, sampleStart + spp) of the per-pixel sample
+    // sequence. Jitter depends on pixel, sample index and seed only, so tiles
+    // and sample ranges reproduce the full render.
+    u32 tileX = 0;
+    u32 tileY = 0;
+    u32 tileWidth = 0;
+    u32 tileHeight = 0;
+    u32 sampleStart = 0;
+    u64 seed = 0;                               // renderer.seed
+    std::unordered_map<String, String> metadata;   // Extra output metadata
+
+    // Samples per dispatch (renderer.samples_per_pass, 0 = all spp); passes
+    // are summed on the host, the result equals a single dispatch
+    u32 samplesPerPass = 0;
+
+    // Checkpoints ([checkpoint], io/Checkpoint.hpp): every interval the
+    // band progress is saved to checkpointPath (empty = off); resume
+    // continues from it if its fingerprint matches
+    String checkpointPath;
+    f64 checkpointIntervalSeconds = 600.0;
+    bool resume = false;
+    String fingerprint;                         // Config and scene file identity
+
+    bool writeAovs = false;
+    bool denoise = false;
+    DenoiseParameters denoiseParams;
+    String psfType = "none";                    // none, gaussian or airy
+    f32 psfSigmaPx = 1.0f;
+    f32 psfFNumber = 4.0f;
+    f32 psfPixelPitchUm = 5.0f;
+
+    bool IsHsOff() const { return spectralMode == "hs_off"; }
+    u32 RenderWidth() const { return (tileWidth == 0) ? width : tileWidth; }
+    u32 RenderHeight() const { return (tileHeight == 0) ? height : tileHeight; }
+
+    // [renderer], [spectral], [camera], [lighting], [denoise], [sensor.psf]
+    static Result<RenderJob, String> FromConfig(const Config& config);
+};
+
+// ============================================================================
+// RenderStats - Outcome and timing of one job (seconds)
+// ============================================================================
+
+struct RenderStats {
+    String jobName;
+    String outputPath;
+    bool succeeded = false;
+    String error;
+    u32 width = 0;
+    u32 height = 0;
+    u32 bandCount = 0;
+    f64 updateSeconds = 0.0;     // Band tables, uploads, image (re)allocation
+    f64 renderSeconds = 0.0;     // TraceRays submissions (GPU, all bands)
+    f64 readbackSeconds = 0.0;   // Output / AOV copies to the host
+    f64 finishSeconds = 0.0;     // Post-processing and writing (thread pool)
+    f64 totalSeconds = 0.0;      // Render() call to output written
+
+    std::vector<f32> pixels;     // keepPixels: radiance, band-sequential [band][y][x]
+};
+
+// ============================================================================
+// GpuScene - Scene resident on the GPU
+// ============================================================================
+
+class GpuScene {
+public:
+    GpuScene(VulkanContext& context, Scene scene, const Config& config);
+    GpuScene(const GpuScene&) = delete;
+    GpuScene& operator=(const GpuScene&) = delete;
+
+    // Load the scene named by config ([scene], [material], [textures],
+    // [spectral_materials], [thermal], spectral.rgb_to_spectrum_table) and
+    // upload it
+    static Result<std::unique_ptr<GpuScene>, String> Load(VulkanContext& context, const Config& config);
+
+    // Identity of the config entries a GpuScene is built from: jobs whose
+    // configs give the same key can share one GpuScene
+    static String Key(const Config& config);
+
+    const String& GetName() const { return m_scene.name; }
+    u64 GetId() const { return m_id; }   // Unique per process (addresses are reused)
+
+    // Bindings 1, 3-8 (TLAS, geometry, materials, textures, RGB-to-spectrum)
+    void Bind(RayTracingPipeline& pipeline) const;
+
+    // Measured material table resampled to bands (binds materials to rows)
+    SpectralMaterialTable BuildSpectralMaterials(const std::vector<SpectralBand>& bands);
+
+    // Planck table for bands (invalid when no material emits)
+    PlanckTable BuildPlanckTable(const std::vector<SpectralBand>& bands) const;
+
+    // Re-upload the material reflectances for one band (measured column,
+    // else the RGB uplift at wavelengthNm)
+    void SetBand(const SpectralMaterialTable& table, u32 band, f32 wavelengthNm);
+
+private:
+    void UploadMaterials();
+
+    VulkanContext& m_context;
+    u64 m_id = 0;
+    Scene m_scene;
+
+    std::optional<RgbToSpectrumTable> m_rgbToSpectrum;
+    std::optional<SpectralMaterialLibrary> m_spectralLibrary;
+    std::unordered_map<String, String> m_spectralAliases;
+    f32 m_planckMinK = PlanckTable::DEFAULT_TEMPERATURE_MIN;
+    f32 m_planckMaxK = PlanckTable::DEFAULT_TEMPERATURE_MAX;
+    u32 m_planckBins = PlanckTable::DEFAULT_TEMPERATURE_BINS;
+
+    std::vector<BLAS> m_blasList;
+    TLAS m_tlas;
+    TextureManager m_textureManager;
+    std::unique_ptr<GpuBuffer> m_rgbToSpectrumBuffer;
+    std::vector<MaterialDataCPU> m_materialData;
+    std::unique_ptr<GpuBuffer> m_materialBuffer;
+};
+
+// ============================================================================
+// RenderSession - Pipeline and per-job state
+// ============================================================================
+
+class RenderSession {
+public:
+    // Called on the rendering thread once a job's output is written (or
+    // failed); it may move the pixels out of stats
+    using FinishedCallback = std::function<void(RenderStats&)>;
+
+    explicit RenderSession(VulkanContext& context);
+    ~RenderSession();
+    RenderSession(const RenderSession&) = delete;
+    RenderSession& operator=(const RenderSession&) = delete;
+
+    // Render job; its post-processing and output run on the thread pool.
+    // The last band's output overlaps the next Render() until that job has
+    // rendered its first band (a job with a checkpoint waits for it first);
+    // onFinished is called then, or by Finish(). Throws on GPU failure.
+    void Render(GpuScene& scene, const RenderJob& job, FinishedCallback onFinished = nullptr);
+
+    // Wait for the output of the last job
+    void Finish();
+
+private:
+    struct PendingJob;
+
+    void PrepareImages(u32 width, u32 height);
+    void PrepareBandTables(GpuScene& scene, const std::vector<SpectralBand>& bands);
+    void FinishFrame(PendingJob& pending, u32 band, bool lastBand,
+                     const std::vector<f32>& pixels, const std::vector<f32>& aovPixels);
+    void RestoreBand(PendingJob& pending, u32 band, bool lastBand);
+    bool OpenCube(PendingJob& pending);
+    void SaveCheckpoint(PendingJob& pending, RenderCheckpoint& checkpoint);
+    void WaitForOutput();        // Also retires the previous job
+    void Complete();
+    void Retire(std::shared_ptr<PendingJob> pending);
+
+    VulkanContext& m_context;
+    RayTracingPipeline m_pipeline;
+    GpuBuffer m_lutBuffer;
+
+    // Output images (binding 0, 11), kept while the resolution does not change
+    std::unique_ptr<GpuImage> m_outputImage;
+    std::unique_ptr<GpuImage> m_aovImage;
+    u32 m_width = 0;
+    u32 m_height = 0;
+
+    // Band tables (binding 9, 10) of the bound scene and bands
+    u64 m_boundSceneId = 0;
+    std::vector<SpectralBand> m_tableBands;
+    SpectralMaterialTable m_spectralMaterials;
+    std::unique_ptr<GpuBuffer> m_spectralMaterialBuffer;
+    std::unique_ptr<GpuBuffer> m_planckBuffer;
+
+    // Output tasks (post-processing / writing on the pool), one at a time:
+    // those of m_pending, or the last ones of m_previous
+    TaskGroup m_output;
+    std::shared_ptr<PendingJob> m_pending;
+    std::shared_ptr<PendingJob> m_previous;
+};
+
+} // namespace quantiloom
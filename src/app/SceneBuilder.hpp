@@ -247,11 +247,11 @@ public:
         };
 
         // Step 2: Subdivide triangles
-        primitive.positions = baseVertices;
-        primitive.indices = baseIndices;
+        primitive.positions.assign(baseVertices.begin(), baseVertices.end());
+        primitive.indices.assign(baseIndices.begin(), baseIndices.end());
 
         for (u32 sub = 0; sub < subdivisions; ++sub) {
-            std::vector<u32> newIndices;
+            std::pmr::vector<u32> newIndices;
             newIndices.reserve(primitive.indices.size() * 4);
 
             // Cache for midpoint vertices to avoid duplicates
@@ -0,0 +1,220 @@
+#include "ShardWorker.hpp"
+#include "RenderSession.hpp"
+#include "core/Log.hpp"
+#include "core/Profiler.hpp"
+#include "io/SpectralIO.hpp"
+#include "renderer/VulkanContext.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <set>
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: Partial outputs
+// ============================================================================
+
+static std::filesystem::path PartialPath(const std::filesystem::path& dir, u32 index) {
+    return dir / fmt::format("shard_{:05}.h5", index);
+}
+
+// True if path holds the finished partial of shard index of this plan
+static bool HasPartial(const std::filesystem::path& path, const ShardPlan& plan, u32 index) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return false;
+    }
+    SpectralCubeReader reader;
+    if (!reader.Open(path.string())) {
+        return false;
+    }
+    const std::optional<ShardHeader> header = ReadShardHeader(reader.GetHeader().metadata);
+    return header && header->planId == plan.GetId() && header->shard.index == index;
+}
+
+// ============================================================================
+// ShardWorker
+// ============================================================================
+
+Result<ShardPlan, String> ShardWorker::Plan(const Config& config) {
+    using R = Result<ShardPlan, String>;
+
+    auto jobResult = RenderJob::FromConfig(config);
+    if (!jobResult.has_value()) {
+        return R::Err(jobResult.error());
+    }
+    const RenderJob& job = jobResult.value();
+    const ShardPlanSettings settings = ShardPlanSettings::FromConfig(config);
+    ShardPlan plan(job.width, job.height, static_cast<u32>(job.bands.size()), job.spp, settings);
+    if (plan.GetShards().empty()) {
+        return R::Err("distributed: Plan has no shards");
+    }
+
+    // Id: everything the partials' pixels depend on (the plan settings are
+    // part of [distributed]). Where outputs go and how the process runs do
+    // not change them.
+    const Config identity = config.Without({"threads", "profiling", "checkpoint", "distributed.output_dir",
+                                            "renderer.output", "renderer.output_format"});
+    plan.SetId(fmt::format("{:016x}", identity.Hash()));
+    return plan;
+}
+
+Result<std::vector<u32>, String> ShardWorker::ParseIndices(const String& text, u32 count) {
+    using R = Result<std::vector<u32>, String>;
+
+    std::set<u32> indices;
+    if (text == "all") {
+        for (u32 i = 0; i < count; ++i) {
+            indices.insert(i);
+        }
+        return std::vector<u32>(indices.begin(), indices.end());
+    }
+
+    auto parse = [](StringView part, u32& value) {
+        auto [ptr, ec] = std::from_chars(part.data(), part.data() + part.size(), value);
+        return ec == std::errc() && ptr == part.data() + part.size();
+    };
+
+    StringView rest = text;
+    while (!rest.empty()) {
+        const usize comma = rest.find(',');
+        const StringView part = rest.substr(0, comma);
+        rest = (comma == StringView::npos) ? StringView() : rest.substr(comma + 1);
+
+        u32 first = 0;
+        u32 last = 0;
+        const usize dash = part.find('-');
+        const bool valid = (dash == StringView::npos)
+            ? parse(part, first) && parse(part, last)
+            : parse(part.substr(0, dash), first) && parse(part.substr(dash + 1), last);
+        if (!valid || first > last) {
+            return R::Err(fmt::format("Invalid shard range '{}' (expected e.g. 3, 0-7, 1,4,9-12 or all)", part));
+        }
+        if (last >= count) {
+            return R::Err(fmt::format("Shard {} out of range (plan has {} shards)", last, count));
+        }
+        for (u32 i = first; i <= last; ++i) {
+            indices.insert(i);
+        }
+    }
+    if (indices.empty()) {
+        return R::Err("No shards given");
+    }
+    return std::vector<u32>(indices.begin(), indices.end());
+}
+
+bool ShardWorker::Run(const Config& config, const std::vector<u32>& indices) {
+    QL_PROFILE_SCOPE("ShardWorker::Run");
+
+    auto planResult = ShardWorker::Plan(config);
+    if (!planResult.has_value()) {
+        QL_LOG_ERROR("{}", planResult.error());
+        return false;
+    }
+    const ShardPlan& plan = planResult.value();
+    auto jobResult = RenderJob::FromConfig(config);
+    if (!jobResult.has_value()) {
+        QL_LOG_ERROR("{}", jobResult.error());
+        return false;
+    }
+    const RenderJob& base = jobResult.value();
+
+    const std::filesystem::path outputDir = config.Get<String>("distributed.output_dir", "shards");
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    if (ec) {
+        QL_LOG_ERROR("ShardWorker: Cannot create {}: {}", outputDir.string(), ec.message());
+        return false;
+    }
+
+    // Finished partials of this plan are not rendered again
+    std::vector<u32> pending;
+    for (u32 index : indices) {
+        if (HasPartial(PartialPath(outputDir, index), plan, index)) {
+            QL_LOG_INFO("Shard {}: partial exists, skipping", index);
+        } else {
+            pending.push_back(index);
+        }
+    }
+    QL_LOG_INFO("Plan {}: {} shard(s), rendering {} of {} requested", plan.GetId(), plan.GetShards().size(),
+                pending.size(), indices.size());
+    if (pending.empty()) {
+        return true;
+    }
+
+    if (base.denoise || base.psfType != "none" || base.writeAovs) {
+        QL_LOG_WARN("ShardWorker: Denoising, PSF and AOVs are not applied to partials; apply them after merging");
+    }
+
+    QL_LOG_INFO("Initializing Vulkan context...");
+    VulkanContext context;
+    if (!context.IsRayTracingSupported()) {
+        QL_LOG_ERROR("Ray tracing not supported on this device");
+        return false;
+    }
+    auto sceneResult = GpuScene::Load(context, config);
+    if (!sceneResult.has_value()) {
+        QL_LOG_ERROR("Failed to load scene: {}", sceneResult.error());
+        return false;
+    }
+    std::unique_ptr<GpuScene> scene = std::move(sceneResult.value());
+    RenderSession session(context);
+
+    usize failed = 0;
+    for (u32 index : pending) {
+        const Shard& shard = plan.GetShards()[index];
+        const std::filesystem::path outputPath = PartialPath(outputDir, index);
+        const std::filesystem::path tempPath = outputPath.string() + ".tmp";
+
+        RenderJob job = base;
+        job.name = fmt::format("shard {}", index);
+        job.outputPath = tempPath.string();
+        job.outputFormat = PixelFormat::F32;
+        job.spectralMode = "hs_off";     // Partials are always cubes
+        job.bands.assign(base.bands.begin() + shard.bandStart,
+                         base.bands.begin() + shard.bandStart + shard.bandCount);
+        job.tileX = shard.x;
+        job.tileY = shard.y;
+        job.tileWidth = shard.width;
+        job.tileHeight = shard.height;
+        job.sampleStart = shard.sampleStart;
+        job.spp = shard.sampleCount;
+        job.writeAovs = false;
+        job.denoise = false;
+        job.psfType = "none";
+        job.checkpointPath.clear();     // A shard is re-rendered whole
+        plan.WriteMetadata(shard, job.metadata);
+
+        QL_LOG_INFO("Shard {}/{}: tile {}x{} at ({}, {}), bands {}-{}, samples {}-{}", index + 1,
+                    plan.GetShards().size(), shard.width, shard.height, shard.x, shard.y, shard.bandStart,
+                    shard.bandStart + shard.bandCount - 1, shard.sampleStart,
+                    shard.sampleStart + shard.sampleCount - 1);
+        try {
+            session.Render(*scene, job, [&failed, index, tempPath, outputPath](const RenderStats& stats) {
+                std::error_code renameError;
+                if (stats.succeeded) {
+                    std::filesystem::rename(tempPath, outputPath, renameError);
+                }
+                if (!stats.succeeded || renameError) {
+                    QL_LOG_ERROR("  [FAIL] Shard {}: {}", index,
+                                 stats.succeeded ? renameError.message() : stats.error);
+                    std::filesystem::remove(tempPath, renameError);
+                    ++failed;
+                    return;
+                }
+                QL_LOG_INFO("  [OK] Shard {} -> {} ({:.2f} s)", index, outputPath.string(), stats.totalSeconds);
+            });
+        } catch (const std::exception& e) {
+            // Already counted by the callback; later shards may still succeed
+            QL_LOG_ERROR("  Shard {} aborted: {}", index, e.what());
+        }
+    }
+    session.Finish();
+
+    QL_LOG_INFO("Shards finished: {} succeeded, {} failed", pending.size() - failed, failed);
+    return failed == 0;
+}
+
+} // namespace quantiloom
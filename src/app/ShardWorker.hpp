@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Config.hpp"
+#include "core/ShardPlan.hpp"
+
+#include <vector>
+
+// ============================================================================
+// ShardWorker - Render shards of a distributed render to partial outputs
+// ============================================================================
+// Every worker loads the same config, computes the same ShardPlan
+// (core/ShardPlan.hpp) and renders the shard indices it is given; workers do
+// not talk to each other. Run them as separate processes, on one machine or
+// many (shared output directory), then merge the partials with
+// QuantiloomMerge (io/ShardMerge.hpp):
+//
+//   Quantiloom --plan scene.toml              # List the shards
+//   Quantiloom --shard 0-7 scene.toml &
+//   Quantiloom --shard 8-15 scene.toml
+//   QuantiloomMerge shards -o cube.h5         # Lists missing shards, if any
+//
+// Config ([distributed], plus the ShardPlanSettings keys):
+//   output_dir = "shards"       # Partials: <output_dir>/shard_00000.h5 ...
+//
+// A partial is an f32 HDF5 cube of the shard's tile and bands (the mean over
+// its samples) with shard.* metadata. It is written to a .tmp file and
+// renamed when complete, so a crashed worker never leaves a partial that
+// looks valid; shards whose partial already exists with the same plan id are
+// skipped, so re-running a failed range only renders what is missing.
+//
+// The plan id hashes the config (without output and process settings); the
+// scene files themselves are not hashed. Denoising, the optical PSF and AOVs
+// need whole images and are not applied to partials (apply them to the merged
+// output).
+// ============================================================================
+
+namespace quantiloom {
+
+class ShardWorker {
+public:
+    // Plan of the render described by config, with its id set
+    static Result<ShardPlan, String> Plan(const Config& config);
+
+    // "3", "0-7", "1,4,9-12" or "all" -> sorted shard indices below count
+    static Result<std::vector<u32>, String> ParseIndices(const String& text, u32 count);
+
+    // Render the given shards (plan order); false if any failed
+    static bool Run(const Config& config, const std::vector<u32>& indices);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,218 @@
+// ============================================================================
+// Quantiloom - Daemon Client
+// ============================================================================
+// Minimal client for the render daemon (RenderDaemon.hpp): sends JSON request
+// lines over the daemon's Unix domain socket and prints every reply line to
+// stdout. Requests come from the arguments, or from stdin (one per line) when
+// none are given.
+//
+// A reply carrying shared memory ("shm") is mapped, summarised in the log
+// (min / max / mean per band) and unlinked, unless --keep-shm is given.
+//
+// Usage: QuantiloomClient <socket> [--keep-shm] ['<json request>' ...]
+//   QuantiloomClient /tmp/quantiloom.sock '{"op": "stats"}'
+//   QuantiloomClient /tmp/quantiloom.sock '{"op": "render", "output": "shm",
+//       "config": {"spectral": {"wavelength_nm": 650.0}}}'
+//
+// Exit code: 0 if every reply has status "ok", 1 otherwise.
+// ============================================================================
+
+#include "core/Log.hpp"
+#include "Json.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if !defined(QL_WINDOWS)
+    #include <cerrno>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+using namespace quantiloom;
+
+#if !defined(QL_WINDOWS)
+
+static bool SendLine(int fd, const std::string& line) {
+    const std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool ReceiveLine(int fd, std::string& buffer, std::string& line) {
+    size_t newline = 0;
+    char chunk[4096];
+    while ((newline = buffer.find('\n')) == std::string::npos) {
+        const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    line = buffer.substr(0, newline);
+    buffer.erase(0, newline + 1);
+    return true;
+}
+
+// Map a shared memory reply, log per-band statistics, unlink unless kept
+static void ConsumeSharedMemory(const Config& reply, bool keep) {
+    const std::string name = reply.Get<String>("shm", "");
+    const u32 width = reply.Get<u32>("width", 0);
+    const u32 height = reply.Get<u32>("height", 0);
+    const u32 bands = reply.Get<u32>("bands", 0);
+    const size_t bytes = static_cast<size_t>(width) * height * bands * sizeof(f32);
+    if (name.empty() || bytes == 0) {
+        QL_LOG_ERROR("Malformed shared memory reply");
+        return;
+    }
+
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        QL_LOG_ERROR("shm_open({}) failed: {}", name, std::strerror(errno));
+        return;
+    }
+    void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        QL_LOG_ERROR("mmap({}) failed: {}", name, std::strerror(errno));
+    } else {
+        const f32* pixels = static_cast<const f32*>(mapped);
+        const std::vector<f32> wavelengths = reply.GetArray<f32>("wavelengths_nm");
+        const size_t bandPixels = static_cast<size_t>(width) * height;
+        for (u32 band = 0; band < bands; ++band) {
+            const f32* data = pixels + band * bandPixels;
+            f32 minValue = std::numeric_limits<f32>::max();
+            f32 maxValue = std::numeric_limits<f32>::lowest();
+            f64 sum = 0.0;
+            for (size_t i = 0; i < bandPixels; ++i) {
+                minValue = std::min(minValue, data[i]);
+                maxValue = std::max(maxValue, data[i]);
+                sum += data[i];
+            }
+            QL_LOG_INFO("  Band {} ({:.1f} nm): min {:.6g}, max {:.6g}, mean {:.6g}", band,
+                        band < wavelengths.size() ? wavelengths[band] : 0.0f,
+                        minValue, maxValue, sum / static_cast<f64>(bandPixels));
+        }
+        munmap(mapped, bytes);
+    }
+
+    if (!keep) {
+        shm_unlink(name.c_str());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Log::Init(nullptr, Log::Level::Info);
+
+    if (argc < 2) {
+        QL_LOG_ERROR("Missing arguments");
+        QL_LOG_INFO("Usage: {} <socket> [--keep-shm] ['<json request>' ...]", argv[0]);
+        Log::Shutdown();
+        return 1;
+    }
+
+    const std::string socketPath = argv[1];
+    bool keepShm = false;
+    std::vector<std::string> requests;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--keep-shm") {
+            keepShm = true;
+        } else {
+            requests.push_back(arg);
+        }
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        QL_LOG_ERROR("Socket path too long: {}", socketPath);
+        Log::Shutdown();
+        return 1;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        QL_LOG_ERROR("Cannot connect to {}: {}", socketPath, std::strerror(errno));
+        Log::Shutdown();
+        return 1;
+    }
+
+    bool allOk = true;
+    std::string buffer;
+    auto exchange = [&](const std::string& request) {
+        std::string replyLine;
+        if (!SendLine(fd, request) || !ReceiveLine(fd, buffer, replyLine)) {
+            QL_LOG_ERROR("Connection to {} closed", socketPath);
+            return false;
+        }
+        std::cout << replyLine << std::endl;
+
+        auto reply = ParseJson(replyLine);
+        if (!reply.has_value()) {
+            QL_LOG_ERROR("Invalid reply: {}", reply.error());
+            allOk = false;
+            return true;
+        }
+        const Config replyConfig = Config::FromTable(reply.value());
+        if (replyConfig.Get<String>("status", "") != "ok") {
+            allOk = false;
+        } else if (replyConfig.Has("shm")) {
+            ConsumeSharedMemory(replyConfig, keepShm);
+        }
+        return true;
+    };
+
+    bool connected = true;
+    if (requests.empty()) {
+        std::string line;
+        while (connected && std::getline(std::cin, line)) {
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                connected = exchange(line);
+            }
+        }
+    } else {
+        for (const std::string& request : requests) {
+            if (!(connected = exchange(request))) {
+                break;
+            }
+        }
+    }
+
+    close(fd);
+    Log::Shutdown();
+    return (connected && allOk) ? 0 : 1;
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    Log::Init(nullptr, Log::Level::Info);
+    QL_LOG_ERROR("{}: The render daemon needs Unix domain sockets (Linux / macOS)", argv[0]);
+    Log::Shutdown();
+    return 1;
+}
+
+#endif
@@ -0,0 +1,141 @@
+// ============================================================================
+// Quantiloom - Reference Comparison
+// ============================================================================
+// Offline validation tool: compares renders against reference renders
+// (PBRT-v4, Mitsuba 3) band by band and reports RMSE, relMSE, SSIM and the
+// bias with its 95% confidence interval (validation/Comparison.hpp).
+//
+// Inputs are two files (HDF5 cubes or EXR images) or two directories; for
+// directories every .h5/.hdf5/.exr file in <test> is compared with the file
+// of the same name in <reference>.
+//
+// Usage: QuantiloomCompare <test> <reference> [options]
+//   --csv <file>               Per-band metrics of every comparison
+//   --error-map <file|dir>     Write error maps (a directory in directory mode)
+//   --error-kind diff|abs|relmse  Error map contents (default diff)
+//   --no-ssim                  Skip SSIM
+//   --chunk-bands <n>          Bands read per chunk (default 8)
+//   --max-relmse <x>           Fail if any comparison's pooled relMSE exceeds x
+//   --min-ssim <x>             Fail if any comparison's mean SSIM is below x
+//
+// Exit code: 0 if every comparison ran, met the thresholds and had no NaN/Inf
+// pixels, 1 otherwise.
+// ============================================================================
+
+#include "core/Log.hpp"
+#include "validation/Comparison.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace quantiloom;
+namespace fs = std::filesystem;
+
+static bool IsComparable(const fs::path& path) {
+    const std::string ext = path.extension().string();
+    return ext == ".h5" || ext == ".hdf5" || ext == ".exr" || ext == ".EXR";
+}
+
+int main(int argc, char* argv[]) {
+    Log::Init(nullptr, Log::Level::Info);
+
+    if (argc < 3) {
+        QL_LOG_ERROR("Missing arguments");
+        QL_LOG_INFO("Usage: {} <test> <reference> [--csv file] [--error-map file|dir] "
+                    "[--error-kind diff|abs|relmse] [--no-ssim] [--chunk-bands n] "
+                    "[--max-relmse x] [--min-ssim x]", argv[0]);
+        Log::Shutdown();
+        return 1;
+    }
+
+    const fs::path testPath = argv[1];
+    const fs::path referencePath = argv[2];
+
+    ComparisonSettings settings;
+    std::string csvPath;
+    std::string errorMapPath;
+    f64 maxRelMse = -1.0;
+    f64 minSsim = -1.0;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (arg == "--error-map" && i + 1 < argc) {
+            errorMapPath = argv[++i];
+        } else if (arg == "--error-kind" && i + 1 < argc) {
+            settings.errorMap = ComparisonSettings::ParseErrorMap(argv[++i]);
+        } else if (arg == "--no-ssim") {
+            settings.computeSsim = false;
+        } else if (arg == "--chunk-bands" && i + 1 < argc) {
+            settings.chunkBands = static_cast<u32>(std::stoul(argv[++i]));
+        } else if (arg == "--max-relmse" && i + 1 < argc) {
+            maxRelMse = std::stod(argv[++i]);
+        } else if (arg == "--min-ssim" && i + 1 < argc) {
+            minSsim = std::stod(argv[++i]);
+        } else {
+            QL_LOG_WARN("Ignoring unknown argument '{}'", arg);
+        }
+    }
+
+    // (test, reference, error map) triples
+    std::vector<std::tuple<std::string, std::string, std::string>> jobs;
+    if (fs::is_directory(testPath)) {
+        if (!errorMapPath.empty()) {
+            fs::create_directories(errorMapPath);
+        }
+        for (const auto& entry : fs::directory_iterator(testPath)) {
+            if (!entry.is_regular_file() || !IsComparable(entry.path())) {
+                continue;
+            }
+            const fs::path name = entry.path().filename();
+            jobs.emplace_back(entry.path().string(), (referencePath / name).string(),
+                              errorMapPath.empty() ? std::string() : (fs::path(errorMapPath) / name).string());
+        }
+        std::sort(jobs.begin(), jobs.end());
+    } else {
+        jobs.emplace_back(testPath.string(), referencePath.string(), errorMapPath);
+    }
+
+    if (jobs.empty()) {
+        QL_LOG_ERROR("No files to compare in {}", testPath.string());
+        Log::Shutdown();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ComparisonResult> results;
+    u32 failures = 0;
+    for (const auto& [test, reference, errorMap] : jobs) {
+        std::optional<ComparisonResult> result = Comparison::CompareFiles(test, reference, settings, errorMap);
+        if (!result.has_value()) {
+            QL_LOG_ERROR("FAIL {}: comparison failed", test);
+            ++failures;
+            continue;
+        }
+
+        const BandMetrics summary = result->Summary();
+        const bool relMseFailed = maxRelMse >= 0.0 && summary.relMse > maxRelMse;
+        const bool ssimFailed = minSsim >= 0.0 && settings.computeSsim && summary.ssim < minSsim;
+        const bool passed = !relMseFailed && !ssimFailed && summary.nonFiniteCount == 0;
+        QL_LOG_INFO("{} {}: {} bands, RMSE {:.4g}, relMSE {:.4g}, SSIM {:.4f}, bias {:.4g} +/- {:.2g}{}",
+                    passed ? "PASS" : "FAIL", test, result->bands.size(), summary.rmse, summary.relMse,
+                    summary.ssim, summary.bias, summary.biasCi95,
+                    summary.nonFiniteCount > 0 ? fmt::format(", {} non-finite pixels", summary.nonFiniteCount) : "");
+        failures += passed ? 0 : 1;
+        results.push_back(std::move(result.value()));
+    }
+
+    f64 seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    QL_LOG_INFO("Compared {} file(s) in {:.2f} s, {} failed", jobs.size(), seconds, failures);
+
+    if (!csvPath.empty() && !Comparison::WriteCsv(csvPath, results)) {
+        ++failures;
+    }
+
+    Log::Shutdown();
+    return failures == 0 ? 0 : 1;
+}
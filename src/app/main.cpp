@@ -3,583 +3,309 @@
 // ============================================================================
 // Main entry point for Quantiloom spectral rendering system
 // Supports single-wavelength and multi-wavelength rendering modes
+//
+//   Quantiloom <config.toml>              One render (EXR or HS-OFF cube)
+//   Quantiloom --resume <config.toml>     Continue a render from its checkpoint
+//                                         ([checkpoint], io/Checkpoint.hpp)
+//   Quantiloom --batch <manifest.toml>    Many jobs in one process (BatchRunner.hpp)
+//   Quantiloom --daemon <daemon.toml>     Serve render requests on a local socket
+//                                         (RenderDaemon.hpp)
+//   Quantiloom --plan <config.toml>       List the shards of a distributed render
+//   Quantiloom --shard <list> <config.toml>
+//                                         Render shards to partial outputs
+//                                         (ShardWorker.hpp, merge: QuantiloomMerge)
 // ============================================================================
 
 #include "core/Log.hpp"
 #include "core/Config.hpp"
-#include "core/Image.hpp"
-#include "io/ImageIO.hpp"
-#include "io/GltfLoader.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Profiler.hpp"
 #include "renderer/VulkanContext.hpp"
-#include "renderer/RayTracingPipeline.hpp"
-#include "renderer/AccelerationStructure.hpp"
-#include "renderer/GpuBuffer.hpp"
-#include "renderer/GpuImage.hpp"
-#include "renderer/TextureManager.hpp"
-#include "renderer/CommandHelper.hpp"
-#include "scene/Mesh.hpp"
-#include "scene/Material.hpp"
-#include "scene/Camera.hpp"
-#include "SceneBuilder.hpp"
-
-#include <glm/glm.hpp>
-#include <iostream>
+#include "RenderSession.hpp"
+#include "BatchRunner.hpp"
+#include "RenderDaemon.hpp"
+#include "ShardWorker.hpp"
+
 #include <filesystem>
 #include <stdexcept>
-#include <cstddef>  // For offsetof
 
 using namespace quantiloom;
 
 // ============================================================================
-// LUT Data Structure (matches shader LUTData structure)
+// Batch Mode
 // ============================================================================
 
-struct LUTData {
-    glm::vec3 sunDirection;        // FROM surface TO sun (normalized)
-    f32 sunRadiance_spectral;       // Spectral radiance at current λ (W·sr⁻¹·m⁻²·nm⁻¹)
-    f32 skyRadiance_spectral;       // Spectral radiance at current λ (W·sr⁻¹·m⁻²·nm⁻¹)
-    f32 _pad0;
-    f32 _pad1;
-    f32 _pad2;
-};
-
-// ============================================================================
-// Material Data Structure (matches shader MaterialData structure)
-// ============================================================================
-// Must match the layout in common.hlsli exactly for GPU upload
-// ============================================================================
+static int RunBatch(const std::filesystem::path& manifestPath) {
+    QL_LOG_INFO("Loading batch manifest: {}", manifestPath.string());
 
-struct MaterialDataCPU {
-    glm::vec4 baseColorFactor;           // offset 0, size 16
-    i32 baseColorTextureIndex;           // offset 16, size 4
-    f32 metallicFactor;                  // offset 20, size 4
-    f32 roughnessFactor;                 // offset 24, size 4
-    i32 metallicRoughnessTextureIndex;   // offset 28, size 4
-
-    i32 normalTextureIndex;              // offset 32, size 4
-    f32 normalScale;                     // offset 36, size 4
-
-    glm::vec3 emissiveFactor;            // offset 40, size 12
-    i32 emissiveTextureIndex;            // offset 52, size 4
-
-    u32 alphaMode;                       // offset 56, size 4
-    f32 alphaCutoff;                     // offset 60, size 4
+    auto manifestResult = BatchManifest::Load(manifestPath);
+    if (!manifestResult.has_value()) {
+        QL_LOG_ERROR("Failed to load batch manifest: {}", manifestResult.error());
+        return 1;
+    }
+    const BatchManifest& manifest = manifestResult.value();
 
-    f32 spectralAlbedo;                  // offset 64, size 4
-    f32 _pad0;                           // offset 68, size 4
-};  // Total: 72 bytes (must match GPU MaterialData in common.hlsli)
+    // [threads] / [profiling] of the manifest apply to the whole batch
+    ThreadPool::ConfigureGlobal(ThreadPoolSettings::FromConfig(manifest.settings));
+    ProfilerSession profilerSession(ProfilerSettings::FromConfig(manifest.settings));
 
-// Verify struct layout matches shader expectations
-// If this fails, the CPU/GPU struct layouts are mismatched, which WILL cause GPU crashes
-static_assert(sizeof(MaterialDataCPU) == 72, "MaterialDataCPU size mismatch! Expected 72 bytes to match GPU MaterialData struct");
-static_assert(offsetof(MaterialDataCPU, baseColorTextureIndex) == 16, "baseColorTextureIndex offset mismatch");
-static_assert(offsetof(MaterialDataCPU, normalTextureIndex) == 32, "normalTextureIndex offset mismatch");
-static_assert(offsetof(MaterialDataCPU, emissiveFactor) == 40, "emissiveFactor offset mismatch");
-static_assert(offsetof(MaterialDataCPU, emissiveTextureIndex) == 52, "emissiveTextureIndex offset mismatch");
+    return BatchRunner::Run(manifest) ? 0 : 1;
+}
 
 // ============================================================================
-// Scene Loading Helper
+// Daemon Mode
 // ============================================================================
 
-// Load scene from config file
-// Returns either procedural scene or glTF-loaded scene
-// For glTF scenes, also populates materials and textures
-Result<Scene, String> LoadSceneFromConfig(const Config& config) {
-    Scene scene;
-
-    // Check for glTF file
-    if (config.Has("scene.gltf")) {
-        String gltfPath = config.Get<String>("scene.gltf");
-        QL_LOG_INFO("Loading glTF model: {}", gltfPath);
-
-        auto result = GltfLoader::LoadFromFile(gltfPath);
-        if (!result.has_value()) {
-            return Result<Scene, String>::Err("Failed to load glTF: " + result.error());
-        }
+static int RunDaemon(const std::filesystem::path& configPath) {
+    QL_LOG_INFO("Loading daemon configuration: {}", configPath.string());
 
-        return std::move(result.value());
+    auto configResult = Config::Load(configPath);
+    if (!configResult.has_value()) {
+        QL_LOG_ERROR("Failed to load configuration: {}", configResult.error());
+        return 1;
     }
+    const Config& config = configResult.value();
 
-    // Check for procedural preset
-    if (config.Has("scene.preset")) {
-        String preset = config.Get<String>("scene.preset", "cornell_box");
-        QL_LOG_INFO("Loading built-in scene preset: {}", preset);
-
-        Mesh mesh;
-        if (preset == "cornell_box") {
-            mesh = TestScenes::CreateCornellBoxScene();
-        } else if (preset == "multi_object") {
-            mesh = TestScenes::CreateMultiObjectScene();
-        } else if (preset == "lighting_test") {
-            mesh = TestScenes::CreateLightingTestScene();
-        } else {
-            QL_LOG_WARN("Unknown scene preset '{}', defaulting to cornell_box", preset);
-            mesh = TestScenes::CreateCornellBoxScene();
-        }
+    ThreadPool::ConfigureGlobal(ThreadPoolSettings::FromConfig(config));
+    ProfilerSession profilerSession(ProfilerSettings::FromConfig(config));
 
-        // Wrap in Scene
-        scene.name = preset;
-        scene.meshes.push_back(std::move(mesh));
+    RenderDaemon daemon(DaemonSettings::FromConfig(config, configPath.parent_path()));
+    return daemon.Run() ? 0 : 1;
+}
 
-        // Create single node with identity transform
-        SceneNode node;
-        node.meshIndex = 0;
-        node.transform = glm::mat4(1.0f);
-        node.name = "SceneRoot";
-        scene.nodes.push_back(node);
+// ============================================================================
+// Distributed Mode
+// ============================================================================
 
-        return std::move(scene);
+static int RunPlan(const std::filesystem::path& configPath) {
+    auto configResult = Config::Load(configPath);
+    if (!configResult.has_value()) {
+        QL_LOG_ERROR("Failed to load configuration: {}", configResult.error());
+        return 1;
+    }
+    auto planResult = ShardWorker::Plan(configResult.value());
+    if (!planResult.has_value()) {
+        QL_LOG_ERROR("{}", planResult.error());
+        return 1;
+    }
+    const ShardPlan& plan = planResult.value();
+
+    QL_LOG_INFO("Plan {}: {}x{}, {} band(s), {} spp, {} shard(s)", plan.GetId(), plan.GetWidth(),
+                plan.GetHeight(), plan.GetBandCount(), plan.GetSpp(), plan.GetShards().size());
+    for (const Shard& shard : plan.GetShards()) {
+        QL_LOG_INFO("  {:5}: tile {}x{} at ({}, {}), bands {}-{}, samples {}-{}", shard.index, shard.width,
+                    shard.height, shard.x, shard.y, shard.bandStart, shard.bandStart + shard.bandCount - 1,
+                    shard.sampleStart, shard.sampleStart + shard.sampleCount - 1);
     }
+    return 0;
+}
 
-    // Default: Cornell box
-    QL_LOG_WARN("No scene specified in config, using cornell_box preset");
-    Mesh mesh = TestScenes::CreateCornellBoxScene();
-    scene.name = "cornell_box";
-    scene.meshes.push_back(std::move(mesh));
+static int RunShards(const String& shardList, const std::filesystem::path& configPath) {
+    QL_LOG_INFO("Loading configuration: {}", configPath.string());
 
-    SceneNode node;
-    node.meshIndex = 0;
-    node.transform = glm::mat4(1.0f);
-    node.name = "SceneRoot";
-    scene.nodes.push_back(node);
+    auto configResult = Config::Load(configPath);
+    if (!configResult.has_value()) {
+        QL_LOG_ERROR("Failed to load configuration: {}", configResult.error());
+        return 1;
+    }
+    const Config& config = configResult.value();
+
+    ThreadPool::ConfigureGlobal(ThreadPoolSettings::FromConfig(config));
+    ProfilerSession profilerSession(ProfilerSettings::FromConfig(config));
 
-    return std::move(scene);
+    auto planResult = ShardWorker::Plan(config);
+    if (!planResult.has_value()) {
+        QL_LOG_ERROR("{}", planResult.error());
+        return 1;
+    }
+    auto indicesResult = ShardWorker::ParseIndices(shardList, static_cast<u32>(planResult.value().GetShards().size()));
+    if (!indicesResult.has_value()) {
+        QL_LOG_ERROR("{}", indicesResult.error());
+        return 1;
+    }
+    return ShardWorker::Run(config, indicesResult.value()) ? 0 : 1;
 }
 
 // ============================================================================
-// Main Entry Point
+// Single Render
 // ============================================================================
 
-int main(int argc, char* argv[]) {
-    // ========================================================================
-    // Initialize Logging
-    // ========================================================================
-    Log::Init("quantiloom.log", Log::Level::Info);
-
-    QL_LOG_INFO("========================================");
-    QL_LOG_INFO("  Quantiloom Spectral Path Tracer");
-    QL_LOG_INFO("========================================");
-
-    // ========================================================================
-    // Load Configuration
-    // ========================================================================
-    if (argc < 2) {
-        QL_LOG_ERROR("No configuration file provided");
-        QL_LOG_INFO("Usage: {} <config.toml>", argv[0]);
-        QL_LOG_INFO("Example: {} assets/configs/spectral_single.toml", argv[0]);
-        Log::Shutdown();
-        return 1;
+static void LogSpectralSettings(const RenderJob& job) {
+    QL_LOG_INFO("  Spectral mode: {}", job.spectralMode);
+    if (job.IsHsOff()) {
+        QL_LOG_INFO("  Bands: {} ({:.1f} - {:.1f} nm)", job.bands.size(),
+                    job.bands.front().center_nm, job.bands.back().center_nm);
+    } else {
+        QL_LOG_INFO("  Wavelength: {:.1f} nm", job.bands.front().center_nm);
     }
+}
 
-    std::filesystem::path configPath(argv[1]);
+static int RunSingle(const std::filesystem::path& configPath, bool resume) {
     QL_LOG_INFO("Loading configuration: {}", configPath.string());
 
     auto configResult = Config::Load(configPath);
     if (!configResult.has_value()) {
         QL_LOG_ERROR("Failed to load configuration: {}", configResult.error());
-        Log::Shutdown();
         return 1;
     }
 
     Config config = configResult.value();
     QL_LOG_INFO("Configuration loaded successfully");
 
-    try {
-        // ====================================================================
-        // Parse Configuration
-        // ====================================================================
-        QL_LOG_INFO("Parsing configuration...");
-
-        // Renderer settings
-        auto resArray = config.GetArray<u32>("renderer.resolution");
-        if (resArray.size() != 2) {
-            QL_LOG_ERROR("renderer.resolution must be array of 2 integers, but got {} and they are {} {}", resArray.size(), resArray[0], resArray[1]);
-            return 1;
-        }
-        u32 width = resArray[0];
-        u32 height = resArray[1];
-        u32 spp = config.Get<u32>("renderer.spp", 1);
-        String outputPath = config.Get<String>("renderer.output", "spectral_output.exr");
-
-        QL_LOG_INFO("  Resolution: {}x{}", width, height);
-        QL_LOG_INFO("  Samples per pixel: {}", spp);
-        QL_LOG_INFO("  Output: {}", outputPath);
+    // CPU worker pool for texture processing, post-processing and IO
+    ThreadPool::ConfigureGlobal(ThreadPoolSettings::FromConfig(config));
 
-        // Spectral settings
-        String spectralMode = config.Get<String>("spectral.mode", "single_wavelength");
-        f32 wavelength_nm = config.Get<f32>("spectral.wavelength_nm", 550.0f);
+    // CPU timing ([profiling] trace / summary); written when this scope exits
+    ProfilerSession profilerSession(ProfilerSettings::FromConfig(config));
 
-        QL_LOG_INFO("  Spectral mode: {}", spectralMode);
-        QL_LOG_INFO("  Wavelength: {:.1f} nm", wavelength_nm);
-
-        if (spectralMode != "single_wavelength") {
-            QL_LOG_ERROR("Only 'single_wavelength' mode is supported in this version");
-            return 1;
-        }
-
-        // Camera settings
-        f32 aspectRatio = static_cast<f32>(width) / static_cast<f32>(height);
-        auto cameraResult = Camera::FromConfig(config, aspectRatio);
-        if (!cameraResult.has_value()) {
-            QL_LOG_ERROR("Failed to load camera: {}", cameraResult.error());
-            return 1;
-        }
-        Camera camera = cameraResult.value();
-
-        // Lighting settings
-        auto sunDirArray = config.GetArray<f32>("lighting.sun_direction");
-        if (sunDirArray.size() != 3) {
-            QL_LOG_ERROR("lighting.sun_direction must be array of 3 floats, but got {}", sunDirArray.size());
-            return 1;
-        }
-        glm::vec3 sunDirection = glm::normalize(glm::vec3(sunDirArray[0], sunDirArray[1], sunDirArray[2]));
-
-        auto sunRadArray = config.GetArray<f32>("lighting.sun_radiance");
-        if (sunRadArray.size() != 3) {
-            QL_LOG_ERROR("lighting.sun_radiance must be array of 3 floats, but got {}", sunRadArray.size());
-            return 1;
-        }
-        glm::vec3 sunRadiance(sunRadArray[0], sunRadArray[1], sunRadArray[2]);
+    // ========================================================================
+    // Parse Configuration
+    // ========================================================================
+    QL_PROFILE_PHASE(phase, "Parse configuration");
+    QL_LOG_INFO("Parsing configuration...");
 
-        auto skyRadArray = config.GetArray<f32>("lighting.sky_radiance");
-        if (skyRadArray.size() != 3) {
-            QL_LOG_ERROR("lighting.sky_radiance must be array of 3 floats, but got {}", skyRadArray.size());
-            return 1;
-        }
-        glm::vec3 skyRadiance(skyRadArray[0], skyRadArray[1], skyRadArray[2]);
-
-        QL_LOG_INFO("  Sun direction: [{:.2f}, {:.2f}, {:.2f}]",
-                    sunDirection.x, sunDirection.y, sunDirection.z);
-        QL_LOG_INFO("  Sun radiance: [{:.2f}, {:.2f}, {:.2f}]",
-                    sunRadiance.x, sunRadiance.y, sunRadiance.z);
-        QL_LOG_INFO("  Sky radiance: [{:.2f}, {:.2f}, {:.2f}]",
-                    skyRadiance.x, skyRadiance.y, skyRadiance.z);
-
-        // Material settings
-        auto albedoArray = config.GetArray<f32>("material.albedo");
-        if (albedoArray.size() != 3) {
-            QL_LOG_ERROR("material.albedo must be array of 3 floats, but got {}", albedoArray.size());
-            return 1;
-        }
-        glm::vec3 albedo(albedoArray[0], albedoArray[1], albedoArray[2]);
-        QL_LOG_INFO("  Material albedo: [{:.2f}, {:.2f}, {:.2f}]", albedo.x, albedo.y, albedo.z);
-
-        // ====================================================================
-        // Initialize Vulkan Context
-        // ====================================================================
-        QL_LOG_INFO("Initializing Vulkan context...");
-        VulkanContext context;
-
-        if (!context.IsRayTracingSupported()) {
-            QL_LOG_ERROR("Ray tracing not supported on this device");
-            return 1;
-        }
+    auto jobResult = RenderJob::FromConfig(config);
+    if (!jobResult.has_value()) {
+        QL_LOG_ERROR("{}", jobResult.error());
+        return 1;
+    }
+    RenderJob& job = jobResult.value();
+    if (resume && job.checkpointPath.empty()) {
+        QL_LOG_ERROR("--resume needs checkpoints ([checkpoint] enabled = true)");
+        return 1;
+    }
+    job.resume = resume;
+
+    QL_LOG_INFO("  Resolution: {}x{}", job.width, job.height);
+    QL_LOG_INFO("  Samples per pixel: {}", job.spp);
+    QL_LOG_INFO("  Output: {} ({})", job.outputPath, PixelFormatName(job.outputFormat));
+    if (!job.checkpointPath.empty()) {
+        QL_LOG_INFO("  Checkpoint: {} (every {:.0f} s{})", job.checkpointPath, job.checkpointIntervalSeconds,
+                    resume ? ", resuming" : "");
+    }
+    LogSpectralSettings(job);
+    QL_LOG_INFO("  Sun direction: [{:.2f}, {:.2f}, {:.2f}]",
+                job.sunDirection.x, job.sunDirection.y, job.sunDirection.z);
+    QL_LOG_INFO("  Sun radiance: [{:.2f}, {:.2f}, {:.2f}]",
+                job.sunRadiance.x, job.sunRadiance.y, job.sunRadiance.z);
+    QL_LOG_INFO("  Sky radiance: [{:.2f}, {:.2f}, {:.2f}]",
+                job.skyRadiance.x, job.skyRadiance.y, job.skyRadiance.z);
 
-        // ====================================================================
-        // Load Scene Geometry
-        // ====================================================================
-        QL_LOG_INFO("Loading scene...");
+    // ========================================================================
+    // Initialize Vulkan Context
+    // ========================================================================
+    QL_PROFILE_NEXT_PHASE(phase, "Vulkan init");
+    QL_LOG_INFO("Initializing Vulkan context...");
+    VulkanContext context;
 
-        auto sceneResult = LoadSceneFromConfig(config);
-        if (!sceneResult.has_value()) {
-            QL_LOG_ERROR("Failed to load scene: {}", sceneResult.error());
-            return 1;
-        }
+    if (!context.IsRayTracingSupported()) {
+        QL_LOG_ERROR("Ray tracing not supported on this device");
+        return 1;
+    }
 
-        Scene loadedScene = sceneResult.value();
+    // ========================================================================
+    // Load Scene (geometry, acceleration structures, textures, materials)
+    // ========================================================================
+    QL_PROFILE_NEXT_PHASE(phase, "Load scene");
+    QL_LOG_INFO("Loading scene...");
 
-        // If scene has no materials (procedural), create default from config
-        if (loadedScene.materials.empty()) {
-            Material defaultMaterial = Material::CreateLambertian(albedo, "DefaultMaterial");
-            loadedScene.materials.push_back(defaultMaterial);
-            QL_LOG_INFO("  Created default material (spectral albedo: {:.3f})",
-                        defaultMaterial.spectralAlbedo);
-        }
+    auto sceneResult = GpuScene::Load(context, config);
+    if (!sceneResult.has_value()) {
+        QL_LOG_ERROR("Failed to load scene: {}", sceneResult.error());
+        return 1;
+    }
+    std::unique_ptr<GpuScene> scene = std::move(sceneResult.value());
 
-        QL_LOG_INFO("  Scene loaded: {} meshes, {} nodes, {} materials",
-                    loadedScene.meshes.size(), loadedScene.nodes.size(),
-                    loadedScene.materials.size());
+    // ========================================================================
+    // Create Ray Tracing Pipeline
+    // ========================================================================
+    QL_PROFILE_NEXT_PHASE(phase, "Create pipeline");
+    QL_LOG_INFO("Creating ray tracing pipeline...");
+    RenderSession session(context);
+    QL_LOG_INFO("  Pipeline created");
 
-        // M2: Build BLAS for each primitive in each mesh
-        // This allows per-primitive materials and proper glTF support
-        std::vector<BLAS> blasList;
-        std::vector<u32> primitiveMaterialIds;  // Track material ID for each BLAS
+    // ========================================================================
+    // Render and Save
+    // ========================================================================
+    QL_PROFILE_NEXT_PHASE(phase, "Render");
+    bool succeeded = false;
+    session.Render(*scene, job, [&succeeded](const RenderStats& stats) {
+        succeeded = stats.succeeded;
+        QL_LOG_INFO("  Timing: update {:.3f} s, render {:.3f} s, readback {:.3f} s, finish {:.3f} s",
+                    stats.updateSeconds, stats.renderSeconds, stats.readbackSeconds, stats.finishSeconds);
+    });
+    session.Finish();
 
-        for (const auto& mesh : loadedScene.meshes) {
-            for (const auto& primitive : mesh.primitives) {
-                blasList.emplace_back(context, primitive);
-                primitiveMaterialIds.push_back(primitive.materialId);
-            }
-        }
+    // ========================================================================
+    // Summary
+    // ========================================================================
+    QL_PROFILE_NEXT_PHASE(phase, "Shutdown");   // Covers GPU resource teardown
+    QL_LOG_INFO("========================================");
+    QL_LOG_INFO("  Rendering {}", succeeded ? "COMPLETED" : "FAILED");
+    QL_LOG_INFO("========================================");
+    LogSpectralSettings(job);
+    QL_LOG_INFO("  Output: {}", job.outputPath);
+    QL_LOG_INFO("========================================");
 
-        u32 totalTriangles = 0;
-        for (const auto& mesh : loadedScene.meshes) {
-            totalTriangles += mesh.GetTotalTriangleCount();
-        }
+    return succeeded ? 0 : 1;
+}
 
-        QL_LOG_INFO("  Created {} BLAS(es) for {} total triangles",
-                    blasList.size(), totalTriangles);
-
-        // ====================================================================
-        // Build Acceleration Structures
-        // ====================================================================
-        QL_LOG_INFO("Building acceleration structures...");
-
-        // Build TLAS with all instances
-        TLAS tlas(context);
-
-        CommandHelper::ExecuteImmediate(context, [&](VkCommandBuffer cmd) {
-            // Build all BLAS
-            for (auto& blas : blasList) {
-                blas.Build(cmd);
-            }
-
-            // Add instances to TLAS
-            size_t blasIndex = 0;
-            for (const auto& node : loadedScene.nodes) {
-                const Mesh& mesh = loadedScene.meshes[node.meshIndex];
-
-                for (size_t primIdx = 0; primIdx < mesh.primitives.size(); ++primIdx) {
-                    const auto& primitive = mesh.primitives[primIdx];
-                    tlas.AddInstance(
-                        blasList[blasIndex],
-                        primitive.materialId,
-                        node.transform
-                    );
-                    ++blasIndex;
-                }
-            }
-
-            tlas.Build(cmd);
-        });
-
-        QL_LOG_INFO("  TLAS built with {} instance(s)", loadedScene.nodes.size());
-
-        // ====================================================================
-        // Create Output Image
-        // ====================================================================
-        QL_LOG_INFO("Creating output image ({}x{})...", width, height);
-
-        GpuImage outputImage(
-            context.GetAllocator(),
-            context.GetDevice(),
-            width, height,
-            VK_FORMAT_R32G32B32A32_SFLOAT,
-            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-            VMA_MEMORY_USAGE_GPU_ONLY
-        );
-
-        CommandHelper::TransitionImageLayoutImmediate(
-            context,
-            outputImage.GetImage(),
-            outputImage.GetFormat(),
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_GENERAL
-        );
-
-        // ====================================================================
-        // Create LUT Buffer (Spectral)
-        // ====================================================================
-        QL_LOG_INFO("Creating spectral LUT buffer...");
-
-        // Convert RGB radiance to spectral radiance (average of RGB channels)
-        // For single-wavelength mode, we approximate spectral radiance from RGB config
-        f32 sunRadiance_spectral = (sunRadiance.r + sunRadiance.g + sunRadiance.b) / 3.0f;
-        f32 skyRadiance_spectral = (skyRadiance.r + skyRadiance.g + skyRadiance.b) / 3.0f;
-
-        QL_LOG_INFO("  Sun spectral radiance: {:.3f} W·sr⁻¹·m⁻²·nm⁻¹", sunRadiance_spectral);
-        QL_LOG_INFO("  Sky spectral radiance: {:.3f} W·sr⁻¹·m⁻²·nm⁻¹", skyRadiance_spectral);
-
-        LUTData lutData;
-        lutData.sunDirection = sunDirection;
-        lutData.sunRadiance_spectral = sunRadiance_spectral;
-        lutData.skyRadiance_spectral = skyRadiance_spectral;
-
-        GpuBuffer lutBuffer(
-            context.GetAllocator(),
-            sizeof(LUTData),
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU
-        );
-
-        lutBuffer.Upload(&lutData, sizeof(LUTData));
-
-        // ====================================================================
-        // Upload Textures to GPU
-        // ====================================================================
-        QL_LOG_INFO("Uploading textures to GPU...");
-
-        TextureManager textureManager(context);
-        textureManager.UploadTextures(loadedScene.textures);
-
-        QL_LOG_INFO("  {} textures uploaded", textureManager.GetTextureCount());
-
-        // ====================================================================
-        // Create Material Buffer (PBR)
-        // ====================================================================
-        QL_LOG_INFO("Creating PBR material buffer...");
-
-        // Upload all materials with full PBR parameters
-        std::vector<MaterialDataCPU> materialData;
-        materialData.reserve(loadedScene.materials.size());
-
-        for (const auto& mat : loadedScene.materials) {
-            MaterialDataCPU cpuMat;
-
-            // Base color
-            cpuMat.baseColorFactor = mat.baseColorFactor;
-            cpuMat.baseColorTextureIndex = mat.baseColorTextureIndex;
-
-            // Metallic-Roughness
-            cpuMat.metallicFactor = mat.metallicFactor;
-            cpuMat.roughnessFactor = mat.roughnessFactor;
-            cpuMat.metallicRoughnessTextureIndex = mat.metallicRoughnessTextureIndex;
-
-            // Normal mapping
-            cpuMat.normalTextureIndex = mat.normalTextureIndex;
-            cpuMat.normalScale = mat.normalScale;
-
-            // Emissive
-            cpuMat.emissiveFactor = mat.emissiveFactor;
-            cpuMat.emissiveTextureIndex = mat.emissiveTextureIndex;
-
-            // Alpha mode
-            cpuMat.alphaMode = static_cast<u32>(mat.alphaMode);
-            cpuMat.alphaCutoff = mat.alphaCutoff;
-
-            // Spectral (M1 compatibility)
-            cpuMat.spectralAlbedo = mat.spectralAlbedo;
-            cpuMat._pad0 = 0.0f;
-
-            materialData.push_back(cpuMat);
-
-            QL_LOG_INFO("  Material '{}': base=[{:.2f},{:.2f},{:.2f},{:.2f}] metal={:.2f} rough={:.2f}",
-                        mat.name,
-                        mat.baseColorFactor.r, mat.baseColorFactor.g, mat.baseColorFactor.b, mat.baseColorFactor.a,
-                        mat.metallicFactor, mat.roughnessFactor);
-        }
+// ============================================================================
+// Main Entry Point
+// ============================================================================
 
-        GpuBuffer materialBuffer(
-            context.GetAllocator(),
-            materialData.size() * sizeof(MaterialDataCPU),
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU
-        );
-
-        materialBuffer.Upload(materialData.data(), materialData.size() * sizeof(MaterialDataCPU));
-
-        // ====================================================================
-        // Create Ray Tracing Pipeline
-        // ====================================================================
-        QL_LOG_INFO("Creating ray tracing pipeline...");
-
-        RayTracingPipeline pipeline(
-            context,
-            "raygen.spv",
-            "closesthit.spv",
-            "miss.spv"
-        );
-
-        // Bind resources in correct order (bindings 0-7)
-        pipeline.BindOutputImage(outputImage);                          // Binding 0
-        pipeline.BindAccelerationStructure(tlas.GetHandle());           // Binding 1
-        pipeline.BindLUTBuffer(lutBuffer);                              // Binding 2
-
-        // Use first BLAS for geometry buffers (all BLAS share same vertex/index binding)
-        if (!blasList.empty()) {
-            pipeline.BindGeometryBuffers(blasList[0].GetVertexBuffer(), blasList[0].GetIndexBuffer()); // Binding 3, 4
-        }
+int main(int argc, char* argv[]) {
+    // ========================================================================
+    // Initialize Logging
+    // ========================================================================
+    Log::Init("quantiloom.log", Log::Level::Info, Log::Mode::Async);
 
-        pipeline.BindMaterialBuffer(materialBuffer);                    // Binding 5
-
-        // Bind textures (bindless arrays)
-        pipeline.BindTextures(textureManager.GetImageViews(), textureManager.GetSamplers()); // Binding 6, 7
-
-        // Set camera parameters (with spectral wavelength)
-        CameraData cameraData = camera.GetCameraData();
-        cameraData.wavelength_nm = wavelength_nm;  // Override with config wavelength
-        pipeline.SetCameraData(cameraData);
-
-        QL_LOG_INFO("  Pipeline created and resources bound");
-
-        // ====================================================================
-        // Render Frame
-        // ====================================================================
-        QL_LOG_INFO("Rendering frame at wavelength {:.1f} nm...", wavelength_nm);
-        QL_LOG_INFO("  [DEBUG] Starting TraceRays command submission...");
-
-        try {
-            CommandHelper::ExecuteImmediate(context, [&](VkCommandBuffer cmd) {
-                QL_LOG_INFO("  [DEBUG] Recording TraceRays commands...");
-                pipeline.TraceRays(cmd, width, height);
-                QL_LOG_INFO("  [DEBUG] TraceRays commands recorded successfully");
-            });
-            QL_LOG_INFO("  [DEBUG] GPU execution completed successfully");
-        } catch (const std::exception& e) {
-            QL_LOG_ERROR("  [DEBUG] GPU execution FAILED: {}", e.what());
-            throw;
-        }
+    QL_LOG_INFO("========================================");
+    QL_LOG_INFO("  Quantiloom Spectral Path Tracer");
+    QL_LOG_INFO("========================================");
 
-        QL_LOG_INFO("  Frame rendered ({}x{})", width, height);
-
-        // ====================================================================
-        // Readback and Save
-        // ====================================================================
-        QL_LOG_INFO("Reading back and saving image...");
-        QL_LOG_INFO("  [DEBUG] Starting image readback...");
-
-        std::vector<f32> pixels = CommandHelper::ReadbackImage(
-            context,
-            outputImage.GetImage(),
-            outputImage.GetFormat(),
-            width,
-            height
-        );
-
-        // Convert to Image object (4 channels: RGBA)
-        Image img(width, height, 4);
-        img.channelNames = {"R", "G", "B", "A"};
-        img.metadata["renderer"] = "Quantiloom Spectral";
-        img.metadata["mode"] = spectralMode;
-        img.metadata["wavelength_nm"] = std::to_string(wavelength_nm);
-        img.metadata["resolution"] = std::to_string(width) + "x" + std::to_string(height);
-        img.metadata["spp"] = std::to_string(spp);
-
-        // Copy pixel data
-        for (u32 y = 0; y < height; ++y) {
-            for (u32 x = 0; x < width; ++x) {
-                u32 pixelIndex = (y * width + x) * 4;
-                img(x, y, 0) = pixels[pixelIndex + 0];  // R
-                img(x, y, 1) = pixels[pixelIndex + 1];  // G
-                img(x, y, 2) = pixels[pixelIndex + 2];  // B
-                img(x, y, 3) = pixels[pixelIndex + 3];  // A
-            }
-        }
+    // ========================================================================
+    // Parse Arguments
+    // ========================================================================
+    const String mode = (argc >= 2) ? String(argv[1]) : String();
+    const bool batch = (mode == "--batch");
+    const bool daemon = (mode == "--daemon");
+    const bool plan = (mode == "--plan");
+    const bool shard = (mode == "--shard");
+    const bool resume = (mode == "--resume");
+    if (argc < 2 || ((batch || daemon || plan || resume) && argc < 3) || (shard && argc < 4)) {
+        QL_LOG_ERROR("No configuration file provided");
+        QL_LOG_INFO("Usage: {} <config.toml>", argv[0]);
+        QL_LOG_INFO("       {} --resume <config.toml>", argv[0]);
+        QL_LOG_INFO("       {} --batch <manifest.toml>", argv[0]);
+        QL_LOG_INFO("       {} --daemon <daemon.toml>", argv[0]);
+        QL_LOG_INFO("       {} --plan <config.toml>", argv[0]);
+        QL_LOG_INFO("       {} --shard <0-7|1,4,9|all> <config.toml>", argv[0]);
+        QL_LOG_INFO("Example: {} assets/configs/spectral_single.toml", argv[0]);
+        Log::Shutdown();
+        return 1;
+    }
 
-        // Save as EXR
-        if (ImageIO::WriteEXR(outputPath, img)) {
-            QL_LOG_INFO("  [OK] Saved spectral image to {}", outputPath);
+    int exitCode = 1;
+    try {
+        if (batch) {
+            exitCode = RunBatch(argv[2]);
+        } else if (daemon) {
+            exitCode = RunDaemon(argv[2]);
+        } else if (plan) {
+            exitCode = RunPlan(argv[2]);
+        } else if (shard) {
+            exitCode = RunShards(argv[2], argv[3]);
+        } else if (resume) {
+            exitCode = RunSingle(argv[2], true);
         } else {
-            QL_LOG_ERROR("  [FAIL] Failed to save image to {}", outputPath);
+            exitCode = RunSingle(argv[1], false);
         }
-
-        // ====================================================================
-        // Success
-        // ====================================================================
-        QL_LOG_INFO("========================================");
-        QL_LOG_INFO("  Rendering COMPLETED");
-        QL_LOG_INFO("========================================");
-        QL_LOG_INFO("  Spectral mode: {}", spectralMode);
-        QL_LOG_INFO("  Wavelength: {:.1f} nm", wavelength_nm);
-        QL_LOG_INFO("  Output: {}", outputPath);
-        QL_LOG_INFO("========================================");
-
     } catch (const std::exception& e) {
         QL_LOG_ERROR("FATAL ERROR: {}", e.what());
-        Log::Shutdown();
-        return 1;
+        exitCode = 1;
     }
 
     Log::Shutdown();
-    return 0;
+    return exitCode;
 }
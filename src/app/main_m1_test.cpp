@@ -23,7 +23,10 @@
 #include "renderer/GpuBuffer.hpp"
 #include "renderer/GpuImage.hpp"
 #include "renderer/CommandHelper.hpp"
+#include "renderer/TextureManager.hpp"
 #include "scene/Mesh.hpp"
+#include "scene/SpectralMaterial.hpp"
+#include "RenderSession.hpp"
 #include "SceneBuilder.hpp"
 
 #include <glm/glm.hpp>
@@ -60,18 +63,9 @@ ScenePreset    g_scenePreset    = ScenePreset::MultiObject;
 CameraPreset   g_cameraPreset   = CameraPreset::DefaultOverview;
 LightingPreset g_lightingPreset = LightingPreset::Standard;
 
-// ============================================================================
-// LUT Data Structure (matches shader LUTData structure)
-// ============================================================================
-
-struct LUTData {
-    glm::vec3 sunDirection;
-    f32 _pad0;
-    glm::vec3 sunRadiance;
-    f32 _pad1;
-    glm::vec3 skyRadiance;
-    f32 _pad2;
-};
+// The test renders one band at this wavelength; LUTData and MaterialDataCPU
+// come from RenderSession.hpp so they always match the shaders
+constexpr f32 TEST_WAVELENGTH_NM = 550.0f;
 
 // ============================================================================
 // Scene Generation Functions
@@ -334,6 +328,23 @@ int main(int argc, char* argv[]) {
             VK_IMAGE_LAYOUT_GENERAL
         );
 
+        // First-hit AOVs (binding 11), written by raygen but not saved here
+        GpuImage aovImage(
+            context.GetAllocator(),
+            context.GetDevice(),
+            width, height,
+            VK_FORMAT_R32G32B32A32_SFLOAT,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY
+        );
+        CommandHelper::TransitionImageLayoutImmediate(
+            context,
+            aovImage.GetImage(),
+            aovImage.GetFormat(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL
+        );
+
         QL_LOG_INFO("  Output image: {}x{} (RGBA32F)", width, height);
 
         // ====================================================================
@@ -344,10 +355,14 @@ int main(int argc, char* argv[]) {
         // Get lighting configuration from preset
         LightingConfig lighting = GetLightingConfig(g_lightingPreset);
 
-        LUTData lutData;
+        // Single band: the preset's RGB radiance is reduced to its mean
+        LUTData lutData{};
         lutData.sunDirection = lighting.sunDirection;
-        lutData.sunRadiance = lighting.sunRadiance;
-        lutData.skyRadiance = lighting.skyRadiance;
+        lutData.sunRadiance_spectral = (lighting.sunRadiance.x + lighting.sunRadiance.y + lighting.sunRadiance.z) / 3.0f;
+        lutData.skyRadiance_spectral = (lighting.skyRadiance.x + lighting.skyRadiance.y + lighting.skyRadiance.z) / 3.0f;
+        lutData.wavelength_nm = TEST_WAVELENGTH_NM;
+        lutData.spectralBand = 0;
+        lutData.spectralBandCount = 1;
 
         GpuBuffer lutBuffer(
             context.GetAllocator(),
@@ -360,10 +375,8 @@ int main(int argc, char* argv[]) {
         QL_LOG_INFO("  LUT uploaded:");
         QL_LOG_INFO("    sunDirection: [{:.2f}, {:.2f}, {:.2f}]",
                     lutData.sunDirection.x, lutData.sunDirection.y, lutData.sunDirection.z);
-        QL_LOG_INFO("    sunRadiance:  [{:.2f}, {:.2f}, {:.2f}]",
-                    lutData.sunRadiance.x, lutData.sunRadiance.y, lutData.sunRadiance.z);
-        QL_LOG_INFO("    skyRadiance:  [{:.2f}, {:.2f}, {:.2f}]",
-                    lutData.skyRadiance.x, lutData.skyRadiance.y, lutData.skyRadiance.z);
+        QL_LOG_INFO("    sunRadiance:  {:.2f}", lutData.sunRadiance_spectral);
+        QL_LOG_INFO("    skyRadiance:  {:.2f}", lutData.skyRadiance_spectral);
 
         
         // ====================================================================
@@ -371,15 +384,28 @@ int main(int argc, char* argv[]) {
         // ====================================================================
         QL_LOG_INFO("Step 5.5: Creating material buffer...");
 
-        // Define material data (matches MaterialData in common.hlsli)
-        struct MaterialDataCPU {
-            glm::vec3 albedo;
-            f32 _pad0;
-        };
-
-        MaterialDataCPU defaultMaterial;
-        defaultMaterial.albedo = glm::vec3(0.8f, 0.8f, 0.8f);  // Gray
-        defaultMaterial._pad0 = 0.0f;
+        // Untextured grey Lambert-like material, not emitting
+        MaterialDataCPU defaultMaterial{};
+        defaultMaterial.baseColorFactor = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);  // Gray
+        defaultMaterial.baseColorTextureIndex = -1;
+        defaultMaterial.metallicFactor = 0.0f;
+        defaultMaterial.roughnessFactor = 1.0f;
+        defaultMaterial.metallicRoughnessTextureIndex = -1;
+        defaultMaterial.normalTextureIndex = -1;
+        defaultMaterial.normalScale = 1.0f;
+        defaultMaterial.emissiveFactor = glm::vec3(0.0f);
+        defaultMaterial.emissiveTextureIndex = -1;
+        defaultMaterial.alphaMode = 0;
+        defaultMaterial.alphaCutoff = 0.5f;
+        defaultMaterial.spectralAlbedo = 0.8f;
+        defaultMaterial.baseColorSamplerIndex = -1;
+        defaultMaterial.metallicRoughnessSamplerIndex = -1;
+        defaultMaterial.normalSamplerIndex = -1;
+        defaultMaterial.emissiveSamplerIndex = -1;
+        defaultMaterial.spectralMaterialIndex = -1;
+        defaultMaterial.temperatureK = 0.0f;
+        defaultMaterial.temperatureTextureIndex = -1;
+        defaultMaterial.temperatureSamplerIndex = -1;
 
         GpuBuffer materialBuffer(
             context.GetAllocator(),
@@ -390,8 +416,30 @@ int main(int argc, char* argv[]) {
 
         materialBuffer.Upload(&defaultMaterial, sizeof(MaterialDataCPU));
 
-        QL_LOG_INFO("  Material buffer uploaded (albedo: [{:.2f}, {:.2f}, {:.2f}])",
-                    defaultMaterial.albedo.x, defaultMaterial.albedo.y, defaultMaterial.albedo.z);
+        QL_LOG_INFO("  Material buffer uploaded (albedo: {:.2f})", defaultMaterial.spectralAlbedo);
+
+        // ====================================================================
+        // Step 5.6: Textures and Spectral Tables
+        // ====================================================================
+        QL_LOG_INFO("Step 5.6: Creating texture and spectral table bindings...");
+
+        // No scene textures: the manager provides a dummy texture and sampler
+        TextureManager textureManager(context);
+        textureManager.UploadTextures({});
+
+        // Resolution 0 (grey fallback), no measured materials, no thermal bins;
+        // the material above uses none of them
+        const std::vector<f32> emptyTable(4, 0.0f);
+        const SpectralMaterialTable::Entry dummyEntry{};
+        GpuBuffer spectrumTableBuffer(context.GetAllocator(), emptyTable.size() * sizeof(f32),
+                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        spectrumTableBuffer.Upload(emptyTable.data(), emptyTable.size() * sizeof(f32));
+        GpuBuffer spectralMaterialBuffer(context.GetAllocator(), sizeof(dummyEntry),
+                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        spectralMaterialBuffer.Upload(&dummyEntry, sizeof(dummyEntry));
+        GpuBuffer planckTableBuffer(context.GetAllocator(), emptyTable.size() * sizeof(f32),
+                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        planckTableBuffer.Upload(emptyTable.data(), emptyTable.size() * sizeof(f32));
 
 
         // ====================================================================
@@ -406,16 +454,31 @@ int main(int argc, char* argv[]) {
             "miss.spv"
         );
 
+        if (pipeline.GetBufferStride(2) != sizeof(LUTData) ||
+            pipeline.GetBufferStride(5) != sizeof(MaterialDataCPU)) {
+            throw std::runtime_error("Shader LUTData / MaterialData strides do not match the C++ structs");
+        }
+
         // Bind resources
-        pipeline.BindOutputImage(outputImage);
-        pipeline.BindAccelerationStructure(tlas.GetHandle());
-        pipeline.BindLUTBuffer(lutBuffer);
-        pipeline.BindMaterialBuffer(materialBuffer);
-        pipeline.BindGeometryBuffers(blas.GetVertexBuffer(), blas.GetIndexBuffer());
-        pipeline.BindMaterialBuffer(materialBuffer);  // Bind material buffer (binding 5)
-
-        // Set camera parameters (push constants)
-        pipeline.SetCameraData(camera.GetCameraData());
+        pipeline.BindOutputImage(outputImage);                                  // Binding 0
+        pipeline.BindAccelerationStructure(tlas.GetHandle());                   // Binding 1
+        pipeline.BindLUTBuffer(lutBuffer);                                      // Binding 2
+        pipeline.BindGeometryBuffers(blas.GetVertexBuffer(), blas.GetIndexBuffer()); // Binding 3, 4
+        pipeline.BindMaterialBuffer(materialBuffer);                            // Binding 5
+        pipeline.BindTextures(textureManager.GetImageViews(), textureManager.GetSamplers()); // Binding 6, 7
+        pipeline.BindSpectrumTableBuffer(spectrumTableBuffer);                  // Binding 8
+        pipeline.BindSpectralMaterialBuffer(spectralMaterialBuffer);            // Binding 9
+        pipeline.BindPlanckTableBuffer(planckTableBuffer);                      // Binding 10
+        pipeline.BindAovImage(aovImage);                                        // Binding 11
+
+        // Set camera parameters (push constants): whole image, pixel-centre sample
+        CameraData cameraData = camera.GetCameraData();
+        cameraData.wavelength_nm = TEST_WAVELENGTH_NM;
+        cameraData.imageWidth = width;
+        cameraData.imageHeight = height;
+        cameraData.sampleStart = 0;
+        cameraData.sampleCount = 1;
+        pipeline.SetCameraData(cameraData);
 
         QL_LOG_INFO("  Pipeline created and resources bound");
 
@@ -0,0 +1,139 @@
+// ============================================================================
+// Quantiloom - Shard Merge
+// ============================================================================
+// Merges the partial outputs of a distributed render (Quantiloom --shard,
+// ShardWorker.hpp) into the full image or cube (io/ShardMerge.hpp).
+//
+// Inputs are partial files or directories; for directories every .h5/.hdf5
+// file in it is added. Missing shards are listed so they can be re-rendered
+// (Quantiloom --shard <list> <config>).
+//
+// Usage: QuantiloomMerge <partials dir | files...> -o <output> [options]
+//   -o <file>            Output: .h5 / .hdf5 (cube) or .exr (single band)
+//   --format f32|f16     Output pixel format (default f32)
+//   --allow-missing      Merge even if shards are missing (their pixels are 0)
+//
+// Exit code: 0 if the output was written, 1 otherwise.
+// ============================================================================
+
+#include "core/Log.hpp"
+#include "core/PixelFormat.hpp"
+#include "io/ShardMerge.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace quantiloom;
+namespace fs = std::filesystem;
+
+static bool IsPartial(const fs::path& path) {
+    const std::string ext = path.extension().string();
+    return ext == ".h5" || ext == ".hdf5";
+}
+
+// "0,1,2,5,7,8" -> "0-2,5,7-8"
+static std::string FormatRanges(const std::vector<u32>& indices) {
+    std::string text;
+    for (usize i = 0; i < indices.size();) {
+        usize j = i;
+        while (j + 1 < indices.size() && indices[j + 1] == indices[j] + 1) {
+            ++j;
+        }
+        if (!text.empty()) {
+            text += ',';
+        }
+        text += (i == j) ? std::to_string(indices[i])
+                         : std::to_string(indices[i]) + "-" + std::to_string(indices[j]);
+        i = j + 1;
+    }
+    return text;
+}
+
+int main(int argc, char* argv[]) {
+    Log::Init(nullptr, Log::Level::Info);
+
+    std::vector<fs::path> inputs;
+    std::string outputPath;
+    PixelFormat format = PixelFormat::F32;
+    bool allowMissing = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = ParsePixelFormat(argv[++i]);
+        } else if (arg == "--allow-missing") {
+            allowMissing = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            QL_LOG_WARN("Ignoring unknown argument '{}'", arg);
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+
+    if (inputs.empty() || outputPath.empty()) {
+        QL_LOG_ERROR("Missing arguments");
+        QL_LOG_INFO("Usage: {} <partials dir | files...> -o <output.h5|output.exr> [--format f32|f16] "
+                    "[--allow-missing]", argv[0]);
+        Log::Shutdown();
+        return 1;
+    }
+    if (format == PixelFormat::U16) {
+        QL_LOG_ERROR("--format: u16 is not supported for merged output, use f32 or f16");
+        Log::Shutdown();
+        return 1;
+    }
+
+    // Partial files, directories expanded in name order
+    std::vector<std::string> files;
+    for (const fs::path& input : inputs) {
+        if (fs::is_directory(input)) {
+            std::vector<std::string> entries;
+            for (const auto& entry : fs::directory_iterator(input)) {
+                if (entry.is_regular_file() && IsPartial(entry.path())) {
+                    entries.push_back(entry.path().string());
+                }
+            }
+            std::sort(entries.begin(), entries.end());
+            files.insert(files.end(), entries.begin(), entries.end());
+        } else {
+            files.push_back(input.string());
+        }
+    }
+
+    ShardMerger merger;
+    u32 rejected = 0;
+    for (const std::string& file : files) {
+        if (!merger.Add(file)) {
+            ++rejected;
+        }
+    }
+    if (merger.GetPartialCount() == 0) {
+        QL_LOG_ERROR("No partial outputs found");
+        Log::Shutdown();
+        return 1;
+    }
+
+    const ShardHeader& plan = merger.GetPlan();
+    QL_LOG_INFO("Plan {}: {}x{}, {} band(s), {} spp; {} of {} shard(s) present ({} file(s) rejected)",
+                plan.planId, plan.imageWidth, plan.imageHeight, plan.bandCount, plan.spp,
+                merger.GetPartialCount(), plan.shardCount, rejected);
+
+    const std::vector<u32> missing = merger.GetMissingShards();
+    if (!missing.empty()) {
+        QL_LOG_WARN("Missing shards: {}", FormatRanges(missing));
+        QL_LOG_INFO("Re-render them with: Quantiloom --shard {} <config.toml>", FormatRanges(missing));
+        if (!allowMissing) {
+            QL_LOG_ERROR("Not merging with missing shards (use --allow-missing to write them as 0)");
+            Log::Shutdown();
+            return 1;
+        }
+    }
+
+    const bool succeeded = merger.Merge(outputPath, format, allowMissing);
+    QL_LOG_INFO("{}", succeeded ? "Merge COMPLETED" : "Merge FAILED");
+    Log::Shutdown();
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// ============================================================================
+// Quantiloom - Spectral Preview
+// ============================================================================
+// Offline tool: integrates an HS-OFF cube (SpectralIO HDF5) against the CIE
+// 1931 colour matching functions and writes an sRGB / ACEScg / XYZ preview
+// as EXR (linear float or half) or PNG (8-bit sRGB-encoded), chosen by extension.
+//
+// Usage: QuantiloomPreview <cube.h5> <output.exr|png> [options]
+//   --space srgb|acescg|xyz      Output primaries (default srgb)
+//   --exposure <EV>              Exposure adjustment (default 0)
+//   --auto-exposure              Scale the mean luminance to 0.18 first
+//   --tonemap none|reinhard|aces Tonemap after exposure (default none)
+//   --half                       Write EXR as half float (half the size)
+// ============================================================================
+
+#include "core/Log.hpp"
+#include "io/ImageIO.hpp"
+#include "io/SpectralIO.hpp"
+#include "postprocess/SpectralPreview.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+using namespace quantiloom;
+
+int main(int argc, char* argv[]) {
+    Log::Init(nullptr, Log::Level::Info);
+
+    if (argc < 3) {
+        QL_LOG_ERROR("Missing arguments");
+        QL_LOG_INFO("Usage: {} <cube.h5> <output.exr|png> [--space srgb|acescg|xyz] [--exposure EV] "
+                    "[--auto-exposure] [--tonemap none|reinhard|aces] [--half]", argv[0]);
+        Log::Shutdown();
+        return 1;
+    }
+
+    const std::string inputPath = argv[1];
+    const std::string outputPath = argv[2];
+
+    PreviewSettings settings;
+    PixelFormat exrFormat = PixelFormat::F32;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--space" && i + 1 < argc) {
+            settings.colorSpace = PreviewSettings::ParseColorSpace(argv[++i]);
+        } else if (arg == "--exposure" && i + 1 < argc) {
+            settings.exposure = std::stof(argv[++i]);
+        } else if (arg == "--auto-exposure") {
+            settings.autoExposure = true;
+        } else if (arg == "--tonemap" && i + 1 < argc) {
+            settings.tonemap = PreviewSettings::ParseTonemap(argv[++i]);
+        } else if (arg == "--half") {
+            exrFormat = PixelFormat::F16;
+        } else {
+            QL_LOG_WARN("Ignoring unknown argument '{}'", arg);
+        }
+    }
+
+    std::optional<SpectralCube> cube = SpectralIO::ReadHDF5(inputPath);
+    if (!cube.has_value()) {
+        Log::Shutdown();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Image preview = SpectralPreview::Convert(cube.value(), settings);
+    f64 ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    QL_LOG_INFO("Converted {} bands of {}x{} in {:.1f} ms", cube->nbands, cube->width, cube->height, ms);
+
+    const std::string ext = std::filesystem::path(outputPath).extension().string();
+    const bool ok = (ext == ".png" || ext == ".PNG") ? ImageIO::WritePNG(outputPath, preview)
+                                                    : ImageIO::WriteEXR(outputPath, preview, exrFormat);
+    Log::Shutdown();
+    return ok ? 0 : 1;
+}
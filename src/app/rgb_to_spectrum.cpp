@@ -0,0 +1,46 @@
+// ============================================================================
+// Quantiloom - RGB-to-Spectrum Table Builder
+// ============================================================================
+// Offline tool: optimises the sigmoid-polynomial RGB-to-spectrum table
+// (RgbToSpectrumTable::Build, parallel) and writes it to HDF5 for use with
+// the spectral.rgb_to_spectrum_table config key.
+//
+// Usage: QuantiloomRgbToSpectrum <output.h5> [resolution]
+// ============================================================================
+
+#include "core/Log.hpp"
+#include "core/RgbToSpectrum.hpp"
+#include "io/RgbToSpectrumLoader.hpp"
+
+#include <chrono>
+#include <string>
+
+using namespace quantiloom;
+
+int main(int argc, char* argv[]) {
+    Log::Init(nullptr, Log::Level::Info);
+
+    if (argc < 2) {
+        QL_LOG_ERROR("No output file provided");
+        QL_LOG_INFO("Usage: {} <output.h5> [resolution]", argv[0]);
+        QL_LOG_INFO("Example: {} assets/luts/rgb_to_spectrum_srgb.h5 64", argv[0]);
+        Log::Shutdown();
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    u32 resolution = RgbToSpectrumTable::DEFAULT_RESOLUTION;
+    if (argc >= 3) {
+        resolution = static_cast<u32>(std::stoul(argv[2]));
+    }
+
+    QL_LOG_INFO("Building {}^3 RGB-to-spectrum table (sRGB, D65)...", resolution);
+    auto start = std::chrono::steady_clock::now();
+    RgbToSpectrumTable table = RgbToSpectrumTable::Build(resolution);
+    f64 seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    QL_LOG_INFO("  Optimised {} entries in {:.1f} s", 3ull * resolution * resolution * resolution, seconds);
+
+    bool ok = RgbToSpectrumLoader::SaveHDF5(outputPath, table);
+    Log::Shutdown();
+    return ok ? 0 : 1;
+}
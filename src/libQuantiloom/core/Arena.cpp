@@ -0,0 +1,124 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace quantiloom {
+
+// Largest alignment blocks are requested with (covers every scalar and SIMD type)
+static constexpr usize kBlockAlignment = 64;
+
+// Geometric block growth stops here; larger requests get a block of their own size
+static constexpr usize kMaxGrowthBlockSize = 64 * 1024 * 1024;
+
+// ============================================================================
+// Helper: Round a pointer up to an alignment (power of two)
+// ============================================================================
+
+static u8* AlignUp(u8* ptr, usize alignment) {
+    const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    return reinterpret_cast<u8*>((address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+}
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+Arena::Arena(usize initialBlockSize, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream)
+    , m_nextBlockSize(std::max<usize>(initialBlockSize, 256)) {
+}
+
+Arena::~Arena() {
+    Release();
+}
+
+void Arena::NewBlock(usize bytes, usize alignment) {
+    usize size = std::max(m_nextBlockSize, bytes + std::max(alignment, kBlockAlignment));
+    Block block{static_cast<u8*>(m_upstream->allocate(size, kBlockAlignment)), size};
+    m_blocks.push_back(block);
+    m_bytesReserved += size;
+
+    m_cursor = block.data;
+    m_end = block.data + size;
+    m_lastAlloc = nullptr;
+    if (m_nextBlockSize < kMaxGrowthBlockSize) {
+        m_nextBlockSize *= 2;
+    }
+}
+
+void* Arena::do_allocate(usize bytes, usize alignment) {
+    u8* ptr = m_cursor ? AlignUp(m_cursor, alignment) : nullptr;
+    if (!ptr || ptr > m_end || static_cast<usize>(m_end - ptr) < bytes) {
+        NewBlock(bytes, alignment);
+        ptr = AlignUp(m_cursor, alignment);
+    }
+
+    m_bytesUsed += static_cast<usize>(ptr + bytes - m_cursor);
+    m_lastStart = m_cursor;
+    m_cursor = ptr + bytes;
+    m_lastAlloc = ptr;
+    ++m_allocationCount;
+    return ptr;
+}
+
+void Arena::do_deallocate(void* ptr, usize bytes, usize /*alignment*/) {
+    // Only the most recent allocation can be taken back; this covers
+    // temporaries that are freed before anything else is allocated
+    if (ptr == m_lastAlloc && static_cast<u8*>(ptr) + bytes == m_cursor) {
+        m_bytesUsed -= static_cast<usize>(m_cursor - m_lastStart);
+        m_cursor = m_lastStart;
+        m_lastAlloc = nullptr;
+    }
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void Arena::Reserve(usize bytes) {
+    if (m_cursor && static_cast<usize>(m_end - m_cursor) >= bytes) {
+        return;
+    }
+    NewBlock(bytes, kBlockAlignment);
+}
+
+void Arena::Reset() {
+    if (m_blocks.empty()) {
+        return;
+    }
+
+    // Keep the largest block, return the rest
+    auto largest = std::max_element(m_blocks.begin(), m_blocks.end(),
+                                     [](const Block& a, const Block& b) { return a.size < b.size; });
+    const Block kept = *largest;
+    for (const Block& block : m_blocks) {
+        if (block.data != kept.data) {
+            m_upstream->deallocate(block.data, block.size, kBlockAlignment);
+        }
+    }
+    m_blocks.assign(1, kept);
+
+    m_cursor = kept.data;
+    m_end = kept.data + kept.size;
+    m_lastAlloc = nullptr;
+    m_bytesUsed = 0;
+    m_bytesReserved = kept.size;
+    m_allocationCount = 0;
+}
+
+void Arena::Release() {
+    for (const Block& block : m_blocks) {
+        m_upstream->deallocate(block.data, block.size, kBlockAlignment);
+    }
+    m_blocks.clear();
+
+    m_cursor = nullptr;
+    m_end = nullptr;
+    m_lastAlloc = nullptr;
+    m_bytesUsed = 0;
+    m_bytesReserved = 0;
+    m_allocationCount = 0;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <memory_resource>
+#include <vector>
+
+// ============================================================================
+// Arena - Linear (bump) allocator as a std::pmr::memory_resource
+// ============================================================================
+// Allocation is a pointer bump inside the current block; blocks come from
+// the upstream resource and grow geometrically when one fills up.
+// Individual frees are no-ops (except for the most recent allocation, which
+// is rolled back so a growing vector can reuse its space), and all memory
+// is returned at once by Reset() or Release().
+//
+// Two uses:
+//   Load time  - pmr containers of a scene (GeometryPrimitive, Mesh) are
+//                allocated from one arena owned by the Scene, so geometry
+//                is packed contiguously and freed in one shot
+//   Per frame  - scratch containers are built in an arena that is Reset()
+//                at the end of the frame; the largest block is kept, so a
+//                steady-state frame does no upstream allocation at all
+//
+// Not thread-safe: use one arena per thread.
+//
+// Usage:
+//   Arena frameArena;
+//   for (;;) {
+//       std::pmr::vector<u32> visible(&frameArena);
+//       ...
+//       frameArena.Reset();   // visible must be gone by now
+//   }
+// ============================================================================
+
+namespace quantiloom {
+
+class QL_API Arena final : public std::pmr::memory_resource {
+public:
+    static constexpr usize DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit Arena(usize initialBlockSize = DEFAULT_BLOCK_SIZE,
+                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~Arena() override;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Make sure the next `bytes` can be allocated without a new block
+    // (loaders call this with the total size they are about to read)
+    void Reserve(usize bytes);
+
+    // Forget every allocation; keeps the largest block for reuse
+    void Reset();
+
+    // Forget every allocation and return all blocks upstream
+    void Release();
+
+    // Statistics
+    usize BytesUsed() const { return m_bytesUsed; }          // Allocated (incl. alignment padding)
+    usize BytesReserved() const { return m_bytesReserved; }  // Held in blocks
+    usize BlockCount() const { return m_blocks.size(); }
+    usize AllocationCount() const { return m_allocationCount; }
+
+protected:
+    void* do_allocate(usize bytes, usize alignment) override;
+    void do_deallocate(void* ptr, usize bytes, usize alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Block {
+        u8* data = nullptr;
+        usize size = 0;
+    };
+
+    // Start a block of at least `bytes` (aligned to `alignment`)
+    void NewBlock(usize bytes, usize alignment);
+
+    std::pmr::memory_resource* m_upstream;
+    std::vector<Block> m_blocks;
+    u8* m_cursor = nullptr;      // Next free byte in the current block
+    u8* m_end = nullptr;         // End of the current block
+    u8* m_lastAlloc = nullptr;   // Most recent allocation
+    u8* m_lastStart = nullptr;   // Cursor before it (incl. alignment padding)
+    usize m_nextBlockSize;
+    usize m_bytesUsed = 0;
+    usize m_bytesReserved = 0;
+    usize m_allocationCount = 0;
+};
+
+} // namespace quantiloom
@@ -0,0 +1,245 @@
+#include "BandStatistics.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace quantiloom {
+
+// Independent accumulators per block (one SIMD register of f32)
+static constexpr usize kLanes = 8;
+
+// Values per parallel work item in Compute
+static constexpr usize kParallelChunk = 64 * BandStatistics::BLOCK_SIZE;
+
+// ============================================================================
+// QuantileSketch
+// ============================================================================
+
+void QuantileSketch::Store::Add(u32 index, u64 count) {
+    if (counts.empty()) {
+        offset = index;
+        counts.assign(1, count);
+        return;
+    }
+    if (index < offset) {
+        counts.insert(counts.begin(), offset - index, 0);
+        offset = index;
+    } else if (index >= offset + counts.size()) {
+        counts.resize(index - offset + 1, 0);
+    }
+    counts[index - offset] += count;
+}
+
+u32 QuantileSketch::BucketIndex(f32 magnitude) {
+    // Monotone in the value for non-negative floats (denormals included)
+    return std::bit_cast<u32>(magnitude) >> (23 - MANTISSA_BITS);
+}
+
+f64 QuantileSketch::BucketValue(u32 index) {
+    if (index == 0) {
+        return 0.0;  // +0 and the smallest denormals
+    }
+    const f64 lower = std::bit_cast<f32>(index << (23 - MANTISSA_BITS));
+    if (!std::isfinite(lower)) {
+        return lower;
+    }
+    // The top finite bucket ends at FLT_MAX, not at infinity
+    const f64 upper = std::min<f64>(std::bit_cast<f32>((index + 1) << (23 - MANTISSA_BITS)),
+                                    std::numeric_limits<f32>::max());
+    return 0.5 * (lower + upper);
+}
+
+void QuantileSketch::Add(f32 value) {
+    if (std::signbit(value)) {
+        m_negative.Add(BucketIndex(-value), 1);
+        ++m_negativeCount;
+    } else {
+        m_positive.Add(BucketIndex(value), 1);
+    }
+    ++m_count;
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+    for (usize i = 0; i < other.m_positive.counts.size(); ++i) {
+        if (other.m_positive.counts[i] > 0) {
+            m_positive.Add(other.m_positive.offset + static_cast<u32>(i), other.m_positive.counts[i]);
+        }
+    }
+    for (usize i = 0; i < other.m_negative.counts.size(); ++i) {
+        if (other.m_negative.counts[i] > 0) {
+            m_negative.Add(other.m_negative.offset + static_cast<u32>(i), other.m_negative.counts[i]);
+        }
+    }
+    m_count += other.m_count;
+    m_negativeCount += other.m_negativeCount;
+}
+
+f64 QuantileSketch::Quantile(f64 q) const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+
+    const u64 rank = static_cast<u64>(std::clamp(q, 0.0, 1.0) * static_cast<f64>(m_count - 1));
+    u64 seen = 0;
+
+    // Negative values in ascending order: largest magnitude first
+    if (rank < m_negativeCount) {
+        for (usize i = m_negative.counts.size(); i-- > 0;) {
+            seen += m_negative.counts[i];
+            if (seen > rank) {
+                return -BucketValue(m_negative.offset + static_cast<u32>(i));
+            }
+        }
+    }
+
+    seen = m_negativeCount;
+    for (usize i = 0; i < m_positive.counts.size(); ++i) {
+        seen += m_positive.counts[i];
+        if (seen > rank) {
+            return BucketValue(m_positive.offset + static_cast<u32>(i));
+        }
+    }
+    return BucketValue(m_positive.offset + static_cast<u32>(m_positive.counts.size() - 1));
+}
+
+// ============================================================================
+// BandStatistics
+// ============================================================================
+
+// Combine moments of a finite block (Chan et al.)
+static void MergeMoments(BandStatistics& stats, u64 count, f64 mean, f64 m2, f64 min, f64 max) {
+    if (count == 0) {
+        return;
+    }
+    if (stats.count == 0) {
+        stats.min = min;
+        stats.max = max;
+    } else {
+        stats.min = std::min(stats.min, min);
+        stats.max = std::max(stats.max, max);
+    }
+
+    const f64 n = static_cast<f64>(stats.count + count);
+    const f64 delta = mean - stats.mean;
+    stats.mean += delta * static_cast<f64>(count) / n;
+    stats.m2 += m2 + delta * delta * static_cast<f64>(stats.count) * static_cast<f64>(count) / n;
+    stats.count += count;
+}
+
+// Slow path for blocks with NaN/Inf (or f32 sums that overflow): Welford in f64
+static void AccumulateChecked(BandStatistics& stats, const f32* values, usize valueCount) {
+    for (usize i = 0; i < valueCount; ++i) {
+        const f32 value = values[i];
+        if (!std::isfinite(value)) {
+            ++stats.nonFiniteCount;
+            continue;
+        }
+        MergeMoments(stats, 1, value, 0.0, value, value);
+        stats.sketch.Add(value);
+    }
+}
+
+void BandStatistics::Accumulate(const f32* values, usize valueCount) {
+    for (usize begin = 0; begin < valueCount; begin += BLOCK_SIZE) {
+        const f32* block = values + begin;
+        const usize n = std::min(BLOCK_SIZE, valueCount - begin);
+
+        // Pass 1: min, max, sum in kLanes independent lanes
+        f32 laneMin[kLanes], laneMax[kLanes], laneSum[kLanes] = {};
+        std::fill(laneMin, laneMin + kLanes, block[0]);
+        std::fill(laneMax, laneMax + kLanes, block[0]);
+        usize i = 0;
+        for (; i + kLanes <= n; i += kLanes) {
+            for (usize l = 0; l < kLanes; ++l) {
+                laneMin[l] = std::min(laneMin[l], block[i + l]);
+                laneMax[l] = std::max(laneMax[l], block[i + l]);
+                laneSum[l] += block[i + l];
+            }
+        }
+        for (; i < n; ++i) {
+            laneMin[0] = std::min(laneMin[0], block[i]);
+            laneMax[0] = std::max(laneMax[0], block[i]);
+            laneSum[0] += block[i];
+        }
+
+        f32 blockMin = laneMin[0];
+        f32 blockMax = laneMax[0];
+        f64 blockSum = 0.0;
+        for (usize l = 0; l < kLanes; ++l) {
+            blockMin = std::min(blockMin, laneMin[l]);
+            blockMax = std::max(blockMax, laneMax[l]);
+            blockSum += laneSum[l];
+        }
+
+        // NaN hides from min/max but not from the sum
+        if (!std::isfinite(blockSum) || !std::isfinite(blockMin) || !std::isfinite(blockMax)) {
+            AccumulateChecked(*this, block, n);
+            continue;
+        }
+
+        // Pass 2 (block is in cache): squared deviations from the block mean
+        const f32 blockMean = static_cast<f32>(blockSum / static_cast<f64>(n));
+        f32 laneM2[kLanes] = {};
+        i = 0;
+        for (; i + kLanes <= n; i += kLanes) {
+            for (usize l = 0; l < kLanes; ++l) {
+                const f32 d = block[i + l] - blockMean;
+                laneM2[l] += d * d;
+            }
+        }
+        for (; i < n; ++i) {
+            const f32 d = block[i] - blockMean;
+            laneM2[0] += d * d;
+        }
+        f64 blockM2 = 0.0;
+        for (usize l = 0; l < kLanes; ++l) {
+            blockM2 += laneM2[l];
+        }
+
+        MergeMoments(*this, n, blockMean, blockM2, blockMin, blockMax);
+        for (usize k = 0; k < n; ++k) {
+            sketch.Add(block[k]);
+        }
+    }
+}
+
+void BandStatistics::Merge(const BandStatistics& other) {
+    MergeMoments(*this, other.count, other.mean, other.m2, other.min, other.max);
+    nonFiniteCount += other.nonFiniteCount;
+    sketch.Merge(other.sketch);
+}
+
+f64 BandStatistics::StdDev() const {
+    return std::sqrt(Variance());
+}
+
+f64 BandStatistics::Percentile(f64 p) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    // The ends are known exactly; elsewhere clamping keeps bucket midpoints in range
+    if (p <= 0.0) {
+        return min;
+    }
+    if (p >= 100.0) {
+        return max;
+    }
+    return std::clamp(sketch.Quantile(p / 100.0), min, max);
+}
+
+BandStatistics BandStatistics::Compute(const f32* values, usize valueCount, bool parallel) {
+    BandStatistics stats;
+    if (!parallel || valueCount <= kParallelChunk) {
+        stats.Accumulate(values, valueCount);
+        return stats;
+    }
+
+    return ParallelReduce(valueCount, kParallelChunk, stats,
+        [&](usize begin, usize end, BandStatistics& partial) { partial.Accumulate(values + begin, end - begin); },
+        [](BandStatistics a, const BandStatistics& b) { a.Merge(b); return a; });
+}
+
+} // namespace quantiloom
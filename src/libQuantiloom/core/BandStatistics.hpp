@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <vector>
+
+// ============================================================================
+// BandStatistics - Streaming, mergeable per-band summary statistics
+// ============================================================================
+// Accumulates count, min, max, mean, variance and approximate percentiles
+// of a band while it is produced, so cube consumers can normalise without
+// another pass over the data. Everything is mergeable: blocks of a band are
+// reduced in parallel and combined, and partial cubes (shards) can be
+// combined the same way.
+//
+// Mean/variance: per 1024-value block, lane-parallel f32 sums (vectorised)
+// give the block mean, a second pass over the cached block gives its M2,
+// and blocks are merged with Chan's parallel update in f64.
+//
+// Percentiles: QuantileSketch is a log-bucketed histogram indexed directly
+// by the top bits of the IEEE-754 float (exponent + 7 mantissa bits, as in
+// HdrHistogram / DDSketch). Merging adds bucket counts, so it is exact and
+// order-independent; a reported percentile is within 0.4% (relative) of a
+// value that has the requested rank. Denormals are not log-spaced and share a
+// few buckets, so below FLT_MIN the bound is absolute (2^-133) instead.
+// Percentile(0) and Percentile(100) return the exact min and max.
+//
+// NaN/Inf values are counted separately and excluded from every statistic.
+//
+// Usage:
+//   BandStatistics stats = BandStatistics::Compute(cube.BandPtr(b), cube.PixelsPerBand());
+//   f64 p99 = stats.Percentile(99.0);
+// ============================================================================
+
+namespace quantiloom {
+
+class QL_API QuantileSketch {
+public:
+    // Mantissa bits per bucket: 2^7 buckets per octave
+    static constexpr u32 MANTISSA_BITS = 7;
+
+    void Add(f32 value);
+    void Merge(const QuantileSketch& other);
+
+    u64 Count() const { return m_count; }
+
+    // Value at quantile q in [0, 1] (0 if empty)
+    f64 Quantile(f64 q) const;
+
+private:
+    // Dense bucket counts over [offset, offset + counts.size())
+    struct Store {
+        std::vector<u64> counts;
+        u32 offset = 0;
+
+        void Add(u32 index, u64 count);
+    };
+
+    static u32 BucketIndex(f32 magnitude);
+    static f64 BucketValue(u32 index);
+
+    Store m_positive;   // +0 and positive values
+    Store m_negative;   // Negative values (by magnitude)
+    u64 m_count = 0;
+    u64 m_negativeCount = 0;
+};
+
+class QL_API BandStatistics {
+public:
+    // Values per block of the vectorised reduction
+    static constexpr usize BLOCK_SIZE = 1024;
+
+    u64 count = 0;             // Finite values
+    u64 nonFiniteCount = 0;    // NaN/Inf values (excluded)
+    f64 min = 0.0;
+    f64 max = 0.0;
+    f64 mean = 0.0;
+    f64 m2 = 0.0;              // Sum of squared deviations from the mean
+    QuantileSketch sketch;
+
+    // Add values (any count, any order)
+    void Accumulate(const f32* values, usize valueCount);
+
+    // Combine with statistics of other values of the same band
+    void Merge(const BandStatistics& other);
+
+    f64 Variance() const { return count > 1 ? m2 / static_cast<f64>(count - 1) : 0.0; }
+    f64 StdDev() const;
+
+    // Percentile p in [0, 100]
+    f64 Percentile(f64 p) const;
+
+    // Statistics of one band, blocks reduced in parallel
+    static BandStatistics Compute(const f32* values, usize valueCount, bool parallel = true);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Types.hpp"
+#include <glm/glm.hpp>
+#include <cmath>
+
+// ============================================================================
+// Color - Colour space transfer functions and colorimetry
+// ============================================================================
+// sRGB <-> linear conversions (IEC 61966-2-1 piecewise curve).
+// Used for gamma-correct texture filtering and sampling on the CPU, matching
+// what the GPU does for VK_FORMAT_*_SRGB images.
+//
+// CIE 1931 2-degree colour matching functions use the multi-lobe Gaussian
+// fit of Wyman, Sloan & Shirley (JCGT 2013), accurate to ~1% of the tabulated
+// observer and cheap enough to evaluate on any wavelength grid.
+// ============================================================================
+
+namespace quantiloom {
+
+// sRGB-encoded value [0, 1] -> linear [0, 1]
+inline f32 SrgbToLinear(f32 value) {
+    if (value <= 0.04045f) {
+        return value / 12.92f;
+    }
+    return std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+// Linear value [0, 1] -> sRGB-encoded [0, 1]
+inline f32 LinearToSrgb(f32 value) {
+    if (value <= 0.0031308f) {
+        return value * 12.92f;
+    }
+    return 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// Quantise a [0, 1] float to u8 with rounding and clamping
+inline u8 QuantizeUnorm8(f32 value) {
+    f32 clamped = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<u8>(clamped * 255.0f + 0.5f);
+}
+
+// Piecewise Gaussian lobe used by the CIE fit
+inline f32 CieLobe(f32 wavelengthNm, f32 mean, f32 sigmaLow, f32 sigmaHigh) {
+    const f32 t = (wavelengthNm - mean) / (wavelengthNm < mean ? sigmaLow : sigmaHigh);
+    return std::exp(-0.5f * t * t);
+}
+
+// CIE 1931 2-degree colour matching functions (x-bar, y-bar, z-bar) at a wavelength
+inline glm::vec3 CieColorMatching(f32 wavelengthNm) {
+    const f32 x = 1.056f * CieLobe(wavelengthNm, 599.8f, 37.9f, 31.0f) +
+                  0.362f * CieLobe(wavelengthNm, 442.0f, 16.0f, 26.7f) -
+                  0.065f * CieLobe(wavelengthNm, 501.1f, 20.4f, 26.2f);
+    const f32 y = 0.821f * CieLobe(wavelengthNm, 568.8f, 46.9f, 40.5f) +
+                  0.286f * CieLobe(wavelengthNm, 530.9f, 16.3f, 31.1f);
+    const f32 z = 1.217f * CieLobe(wavelengthNm, 437.0f, 11.8f, 36.0f) +
+                  0.681f * CieLobe(wavelengthNm, 459.0f, 26.0f, 13.8f);
+    return glm::vec3(x, y, z);
+}
+
+// CIE XYZ -> linear sRGB (D65 white)
+inline glm::vec3 XyzToLinearSrgb(const glm::vec3& xyz) {
+    return glm::vec3( 3.2404542f * xyz.x - 1.5371385f * xyz.y - 0.4985314f * xyz.z,
+                     -0.9692660f * xyz.x + 1.8760108f * xyz.y + 0.0415560f * xyz.z,
+                      0.0556434f * xyz.x - 0.2040259f * xyz.y + 1.0572252f * xyz.z);
+}
+
+// Linear sRGB -> CIE XYZ (D65 white)
+inline glm::vec3 LinearSrgbToXyz(const glm::vec3& rgb) {
+    return glm::vec3(0.4124564f * rgb.x + 0.3575761f * rgb.y + 0.1804375f * rgb.z,
+                     0.2126729f * rgb.x + 0.7151522f * rgb.y + 0.0721750f * rgb.z,
+                     0.0193339f * rgb.x + 0.1191920f * rgb.y + 0.9503041f * rgb.z);
+}
+
+// CIE XYZ (D65) -> linear ACEScg (AP1 primaries, D60 white, Bradford adaptation)
+inline glm::vec3 XyzToAcesCg(const glm::vec3& xyz) {
+    return glm::vec3( 1.6410234f * xyz.x - 0.3248033f * xyz.y - 0.2364247f * xyz.z,
+                     -0.6636629f * xyz.x + 1.6153316f * xyz.y + 0.0167563f * xyz.z,
+                      0.0117219f * xyz.x - 0.0082844f * xyz.y + 0.9883949f * xyz.z);
+}
+
+} // namespace quantiloom
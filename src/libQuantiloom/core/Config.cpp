@@ -6,8 +6,29 @@
 
 namespace quantiloom {
 
+// ============================================================================
+// Helper: Recursive table merge
+// ============================================================================
+
+static void MergeTables(toml::table& base, const toml::table& overrides) {
+    for (const auto& [key, node] : overrides) {
+        if (node.is_table()) {
+            if (toml::table* baseTable = base.get_as<toml::table>(key.str())) {
+                MergeTables(*baseTable, *node.as_table());
+                continue;
+            }
+        }
+        node.visit([&](const auto& value) { base.insert_or_assign(key.str(), value); });
+    }
+}
+
 Config::Config(toml::table&& root) : m_Root(std::move(root)) {}
 
+Config Config::FromTable(const toml::table& table) {
+    toml::table copy = table;
+    return Config(std::move(copy));
+}
+
 Result<Config, String> Config::Load(const std::filesystem::path& filePath) {
     if (!std::filesystem::exists(filePath)) {
         return Result<Config, String>::Err("Config file not found: " + filePath.string());
@@ -49,6 +70,43 @@ Result<Config, String> Config::GetTable(StringView key) const {
     return Config(std::move(clonedTable));
 }
 
+Config Config::WithOverrides(const Config& overrides) const {
+    toml::table merged = m_Root;
+    MergeTables(merged, overrides.m_Root);
+    return Config(std::move(merged));
+}
+
+Config Config::Without(std::initializer_list<StringView> keys) const {
+    toml::table copy = m_Root;
+    for (StringView key : keys) {
+        toml::table* table = &copy;
+        usize start = 0;
+        usize end = key.find('.');
+        while (table && end != StringView::npos) {
+            table = table->get_as<toml::table>(String(key.substr(start, end - start)));
+            start = end + 1;
+            end = key.find('.', start);
+        }
+        if (table) {
+            table->erase(String(key.substr(start)));
+        }
+    }
+    return Config(std::move(copy));
+}
+
+u64 Config::Hash() const {
+    std::ostringstream oss;
+    oss << m_Root;
+    const String text = oss.str();
+
+    u64 hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= static_cast<u8>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 void Config::Print() const {
     std::ostringstream oss;
     oss << m_Root;
@@ -8,6 +8,7 @@ QL_DISABLE_WARNINGS_PUSH
 QL_DISABLE_WARNINGS_POP
 
 #include <filesystem>
+#include <initializer_list>
 
 // ============================================================================
 // Configuration Loader (TOML)
@@ -27,6 +28,9 @@ public:
     /// Create an empty configuration
     Config() = default;
 
+    /// Wrap an already parsed table (e.g. one entry of an array of tables)
+    static Config FromTable(const toml::table& table);
+
     /// Check if a key exists in the configuration
     /// @param key Dot-separated key path (e.g., "renderer.resolution")
     bool Has(StringView key) const;
@@ -54,6 +58,18 @@ public:
     template<typename T>
     Vector<T> GetArray(StringView key) const;
 
+    /// Copy of this configuration with `overrides` merged on top: tables
+    /// merge key by key, any other value (arrays included) replaces the base
+    Config WithOverrides(const Config& overrides) const;
+
+    /// Copy of this configuration without the given keys (dot-separated;
+    /// a table key removes the whole table, missing keys are ignored)
+    Config Without(std::initializer_list<StringView> keys) const;
+
+    /// FNV-1a hash of the TOML text: equal contents give equal hashes on
+    /// every machine (identity of a render for shards and checkpoints)
+    u64 Hash() const;
+
     /// Access the underlying toml::table (for advanced usage)
     const toml::table& GetRoot() const { return m_Root; }
 
@@ -92,6 +108,15 @@ T Config::Get(StringView key, const T& defaultValue) const {
         if (auto val = node->value<int64_t>()) {
             return static_cast<u32>(*val);
         }
+    } else if constexpr (std::is_same_v<T, i64>) {
+        if (auto val = node->value<int64_t>()) {
+            return static_cast<i64>(*val);
+        }
+    } else if constexpr (std::is_same_v<T, u64>) {
+        // TOML integers are signed 64-bit: values >= 2^63 are written negative
+        if (auto val = node->value<int64_t>()) {
+            return static_cast<u64>(*val);
+        }
     } else if constexpr (std::is_same_v<T, f32>) {
         if (auto val = node->value<double>()) {
             return static_cast<f32>(*val);
@@ -113,7 +138,7 @@ template<typename T>
 Result<T, String> Config::GetRequired(StringView key) const {
     const toml::node* node = Navigate(key);
     if (!node) {
-        return Result<T, String>::Err("Missing required key: " + String(key));
+        return typename Result<T, String>::Err("Missing required key: " + String(key));
     }
 
     if constexpr (std::is_same_v<T, String>) {
@@ -128,6 +153,15 @@ Result<T, String> Config::GetRequired(StringView key) const {
         if (auto val = node->value<int64_t>()) {
             return static_cast<u32>(*val);
         }
+    } else if constexpr (std::is_same_v<T, i64>) {
+        if (auto val = node->value<int64_t>()) {
+            return static_cast<i64>(*val);
+        }
+    } else if constexpr (std::is_same_v<T, u64>) {
+        // TOML integers are signed 64-bit: values >= 2^63 are written negative
+        if (auto val = node->value<int64_t>()) {
+            return static_cast<u64>(*val);
+        }
     } else if constexpr (std::is_same_v<T, f32>) {
         if (auto val = node->value<double>()) {
             return static_cast<f32>(*val);
@@ -142,7 +176,7 @@ Result<T, String> Config::GetRequired(StringView key) const {
         }
     }
 
-    return Result<T, String>::Err("Type mismatch for key: " + String(key));
+    return typename Result<T, String>::Err("Type mismatch for key: " + String(key));
 }
 
 template<typename T>
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cmath>
+
+// ============================================================================
+// CounterRng - Counter-based random numbers (Philox4x32-10)
+// ============================================================================
+// Philox (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3",
+// SC 2011) maps a 128-bit counter and a 64-bit key to 128 random bits with
+// ten rounds of multiply / xor. There is no state to advance: the value for
+// (pixel, band, stream) is a pure function of those indices and the seed, so
+// results do not depend on how work is split across threads, and a loop
+// over pixels has no loop-carried dependency (the compiler vectorises it).
+//
+// Usage:
+//   Philox4x32::Counter c = {pixelIndex, band, stream, 0};
+//   Philox4x32::Counter r = Philox4x32::Generate(c, Philox4x32::KeyFromSeed(seed));
+//   f32 u = Philox4x32::ToUniform(r[0]);          // (0, 1)
+// ============================================================================
+
+namespace quantiloom {
+
+struct Philox4x32 {
+    using Counter = Array<u32, 4>;
+    using Key = Array<u32, 2>;
+
+    static constexpr u32 MULTIPLIER_0 = 0xD2511F53u;
+    static constexpr u32 MULTIPLIER_1 = 0xCD9E8D57u;
+    static constexpr u32 WEYL_0 = 0x9E3779B9u;  // Golden ratio
+    static constexpr u32 WEYL_1 = 0xBB67AE85u;  // sqrt(3) - 1
+    static constexpr u32 ROUNDS = 10;
+
+    static constexpr Key KeyFromSeed(u64 seed) {
+        return {static_cast<u32>(seed), static_cast<u32>(seed >> 32)};
+    }
+
+    static constexpr Counter Generate(Counter counter, Key key) {
+        for (u32 round = 0; round < ROUNDS; ++round) {
+            const u64 product0 = static_cast<u64>(MULTIPLIER_0) * counter[0];
+            const u64 product1 = static_cast<u64>(MULTIPLIER_1) * counter[2];
+            counter = {
+                static_cast<u32>(product1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<u32>(product1),
+                static_cast<u32>(product0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<u32>(product0)
+            };
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+        }
+        return counter;
+    }
+
+    // 23 random bits -> uniform in the open interval (0, 1). With 24 bits the
+    // top value (2^24 - 0.5) / 2^24 rounds to 1.0f.
+    static constexpr f32 ToUniform(u32 bits) {
+        return (static_cast<f32>(bits >> 9) + 0.5f) * (1.0f / 8388608.0f);
+    }
+
+    // Box-Muller: two uniforms -> two independent standard normals
+    static void ToNormal(f32 u0, f32 u1, f32& n0, f32& n1) {
+        const f32 radius = std::sqrt(-2.0f * std::log(u0));
+        const f32 angle = static_cast<f32>(constants::TWO_PI) * u1;
+        n0 = radius * std::cos(angle);
+        n1 = radius * std::sin(angle);
+    }
+};
+
+} // namespace quantiloom
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Types.hpp"
+#include "PixelFormat.hpp"
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -18,17 +20,25 @@ namespace quantiloom {
 // Memory layout: Row-major, channel-last
 //   data[y * width * channels + x * channels + c]
 // This matches OpenEXR's scanline order and allows efficient iteration.
+//
+// Element type: Image (f32) is the working format. ImageF16 / ImageU16 hold
+// the same pixels in half the memory for outputs and previews (see
+// core/PixelFormat.hpp); convert with ConvertToStorage / ConvertToFloat.
 // ============================================================================
 
-struct Image {
+template <typename T>
+struct ImageT {
     // Dimensions
     u32 width = 0;
     u32 height = 0;
     u32 channels = 0;
 
     // Pixel data (row-major, channel-last: [y][x][c])
-    // Always stored as f32, even if source is f16 or u8
-    std::vector<f32> data;
+    std::vector<T> data;
+
+    // U16 storage only: value = data * scale + offset
+    f32 scale = 1.0f;
+    f32 offset = 0.0f;
 
     // Channel metadata (optional, for multi-spectral outputs)
     // e.g., {"VIS_550", "NIR_850", "SWIR_1600"}
@@ -42,10 +52,10 @@ struct Image {
     // Constructors
     // ========================================================================
 
-    Image() = default;
+    ImageT() = default;
 
-    Image(u32 w, u32 h, u32 c)
-        : width(w), height(h), channels(c), data(w * h * c, 0.0f) {
+    ImageT(u32 w, u32 h, u32 c)
+        : width(w), height(h), channels(c), data(w * h * c, T{}) {
         channelNames.resize(c);
         for (u32 i = 0; i < c; ++i) {
             channelNames[i] = "Channel_" + std::to_string(i);
@@ -58,20 +68,20 @@ struct Image {
 
     // Get pixel value at (x, y, channel)
     // No bounds checking in release mode for performance
-    inline f32& operator()(u32 x, u32 y, u32 c) {
+    inline T& operator()(u32 x, u32 y, u32 c) {
         return data[y * width * channels + x * channels + c];
     }
 
-    inline const f32& operator()(u32 x, u32 y, u32 c) const {
+    inline const T& operator()(u32 x, u32 y, u32 c) const {
         return data[y * width * channels + x * channels + c];
     }
 
     // Get pointer to pixel (x, y) - useful for bulk operations
-    inline f32* PixelPtr(u32 x, u32 y) {
+    inline T* PixelPtr(u32 x, u32 y) {
         return &data[y * width * channels + x * channels];
     }
 
-    inline const f32* PixelPtr(u32 x, u32 y) const {
+    inline const T* PixelPtr(u32 x, u32 y) const {
         return &data[y * width * channels + x * channels];
     }
 
@@ -92,14 +102,14 @@ struct Image {
     }
 
     // Clear image data (set all to zero)
-    void Clear() { std::fill(data.begin(), data.end(), 0.0f); }
+    void Clear() { std::fill(data.begin(), data.end(), T{}); }
 
     // Resize image (will clear existing data)
     void Resize(u32 w, u32 h, u32 c) {
         width = w;
         height = h;
         channels = c;
-        data.resize(w * h * c, 0.0f);
+        data.resize(w * h * c, T{});
         channelNames.resize(c);
         for (u32 i = 0; i < c; ++i) {
             channelNames[i] = "Channel_" + std::to_string(i);
@@ -107,4 +117,56 @@ struct Image {
     }
 };
 
+using Image = ImageT<f32>;
+using ImageF16 = ImageT<f16>;
+using ImageU16 = ImageT<u16>;
+
+// ============================================================================
+// Storage conversion
+// ============================================================================
+
+// Same pixels, channel names and metadata in another element type
+// (U16 scale/offset span the finite range of the image)
+template <typename T>
+ImageT<T> ConvertToStorage(const Image& image) {
+    ImageT<T> result;
+    result.width = image.width;
+    result.height = image.height;
+    result.channels = image.channels;
+    result.channelNames = image.channelNames;
+    result.metadata = image.metadata;
+    if constexpr (std::is_same_v<T, f32>) {
+        result.data = image.data;
+    } else if constexpr (std::is_same_v<T, u16>) {
+        result.data.resize(image.data.size());
+        Unorm16Range(image.data.data(), image.data.size(), result.scale, result.offset);
+        ConvertSamples(image.data.data(), result.data.data(), image.data.size(), result.scale, result.offset);
+    } else {
+        result.data.resize(image.data.size());
+        ConvertSamples(image.data.data(), result.data.data(), image.data.size());
+    }
+    return result;
+}
+
+template <typename T>
+Image ConvertToFloat(const ImageT<T>& image) {
+    if constexpr (std::is_same_v<T, f32>) {
+        return image;
+    } else {
+        Image result;
+        result.width = image.width;
+        result.height = image.height;
+        result.channels = image.channels;
+        result.channelNames = image.channelNames;
+        result.metadata = image.metadata;
+        result.data.resize(image.data.size());
+        if constexpr (std::is_same_v<T, u16>) {
+            ConvertSamples(image.data.data(), result.data.data(), image.data.size(), image.scale, image.offset);
+        } else {
+            ConvertSamples(image.data.data(), result.data.data(), image.data.size());
+        }
+        return result;
+    }
+}
+
 } // namespace quantiloom
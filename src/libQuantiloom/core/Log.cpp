@@ -1,10 +1,14 @@
 #include "Log.hpp"
 
 QL_DISABLE_WARNINGS_PUSH
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 QL_DISABLE_WARNINGS_POP
 
+#include <chrono>
+#include <cstdlib>
+#include <string>
 #include <vector>
 
 namespace quantiloom {
@@ -12,7 +16,31 @@ namespace quantiloom {
 // Static member definition
 std::shared_ptr<spdlog::logger> Log::s_Logger;
 
-void Log::Init(const char* logFilePath, Level level) {
+// ============================================================================
+// Helper: Environment overrides (QUANTILOOM_LOG_ASYNC, QUANTILOOM_LOG_LEVEL)
+// ============================================================================
+
+static void ApplyEnvironment(Log::Level& level, Log::Mode& mode) {
+    if (const char* async = std::getenv("QUANTILOOM_LOG_ASYNC")) {
+        const std::string value = async;
+        mode = (value.empty() || value == "0" || value == "false" || value == "off")
+            ? Log::Mode::Sync : Log::Mode::Async;
+    }
+    if (const char* name = std::getenv("QUANTILOOM_LOG_LEVEL")) {
+        const std::string value = name;
+        if (value == "trace")         level = Log::Level::Trace;
+        else if (value == "debug")    level = Log::Level::Debug;
+        else if (value == "info")     level = Log::Level::Info;
+        else if (value == "warn")     level = Log::Level::Warn;
+        else if (value == "error")    level = Log::Level::Error;
+        else if (value == "critical") level = Log::Level::Critical;
+        else if (value == "off")      level = Log::Level::Off;
+    }
+}
+
+void Log::Init(const char* logFilePath, Level level, Mode mode) {
+    ApplyEnvironment(level, mode);
+
     // Create multi-sink logger (console + file)
     std::vector<spdlog::sink_ptr> sinks;
 
@@ -28,8 +56,17 @@ void Log::Init(const char* logFilePath, Level level) {
         sinks.push_back(fileSink);
     }
 
-    // Create logger
-    s_Logger = std::make_shared<spdlog::logger>("Quantiloom", sinks.begin(), sinks.end());
+    // Create logger (async: one background thread behind a bounded queue;
+    // a full queue blocks the caller, so nothing is dropped)
+    if (mode == Mode::Async) {
+        spdlog::init_thread_pool(ASYNC_QUEUE_SIZE, 1);
+        s_Logger = std::make_shared<spdlog::async_logger>(
+            "Quantiloom", sinks.begin(), sinks.end(), spdlog::thread_pool(),
+            spdlog::async_overflow_policy::block);
+        spdlog::flush_every(std::chrono::seconds(FLUSH_INTERVAL_SECONDS));
+    } else {
+        s_Logger = std::make_shared<spdlog::logger>("Quantiloom", sinks.begin(), sinks.end());
+    }
     s_Logger->set_level(spdlog::level::trace); // Capture all levels, filter below
     s_Logger->flush_on(spdlog::level::err);    // Auto-flush on errors
 
@@ -40,7 +77,7 @@ void Log::Init(const char* logFilePath, Level level) {
     // Set user-specified level
     SetLevel(level);
 
-    Info("Quantiloom Logger initialized");
+    Info("Quantiloom Logger initialized ({})", mode == Mode::Async ? "async" : "sync");
     Info("Platform: {}, Compiler: {}, Config: {}",
          GetPlatformName(), GetCompilerName(), GetBuildConfig());
 }
@@ -9,12 +9,50 @@ QL_DISABLE_WARNINGS_PUSH
 #include <spdlog/sinks/basic_file_sink.h>
 QL_DISABLE_WARNINGS_POP
 
+#include <atomic>
 #include <memory>
 
 // ============================================================================
 // Logging System Facade
 // Quantiloom M0 - spdlog wrapper with multiple severity levels
 // ============================================================================
+// Modes:
+//   Sync   - every message is written by the calling thread
+//   Async  - messages go into a bounded queue (ASYNC_QUEUE_SIZE) drained by a
+//            background thread; a full queue blocks the caller rather than
+//            dropping messages. Sinks are flushed every FLUSH_INTERVAL_SECONDS
+//            and immediately on Error and above
+// QUANTILOOM_LOG_ASYNC=0/1 and QUANTILOOM_LOG_LEVEL=trace..off override the
+// mode and level passed to Init (use QUANTILOOM_LOG_ASYNC=0 when chasing a
+// crash, the async queue is lost with the process).
+//
+// Compile-time stripping:
+//   QL_LOG_ACTIVE_LEVEL (QL_LOG_LEVEL_TRACE..QL_LOG_LEVEL_OFF) removes the
+//   macros below it. Their arguments are still type-checked and count as
+//   used (no unused-variable warnings) but are never evaluated. Defaults to
+//   TRACE in debug builds and INFO in release builds (CMake:
+//   QUANTILOOM_LOG_ACTIVE_LEVEL).
+//
+// Rate limiting (per call site):
+//   QL_LOG_FIRST_N(WARN, 10, ...)   first 10 occurrences, then one notice
+//   QL_LOG_EVERY_N(INFO, 100, ...)  occurrences 1, 101, 201, ...
+// ============================================================================
+
+#define QL_LOG_LEVEL_TRACE    0
+#define QL_LOG_LEVEL_DEBUG    1
+#define QL_LOG_LEVEL_INFO     2
+#define QL_LOG_LEVEL_WARN     3
+#define QL_LOG_LEVEL_ERROR    4
+#define QL_LOG_LEVEL_CRITICAL 5
+#define QL_LOG_LEVEL_OFF      6
+
+#ifndef QL_LOG_ACTIVE_LEVEL
+    #if defined(QL_DEBUG)
+        #define QL_LOG_ACTIVE_LEVEL QL_LOG_LEVEL_TRACE
+    #else
+        #define QL_LOG_ACTIVE_LEVEL QL_LOG_LEVEL_INFO
+    #endif
+#endif
 
 namespace quantiloom {
 
@@ -32,10 +70,21 @@ public:
         Off       // Disable logging
     };
 
+    /// Where messages are written from
+    enum class Mode {
+        Sync,     // Calling thread
+        Async     // Background thread behind a bounded queue
+    };
+
+    static constexpr usize ASYNC_QUEUE_SIZE = 8192;      // Messages
+    static constexpr int FLUSH_INTERVAL_SECONDS = 2;     // Async mode
+
     /// Initialize the logging system with console and file output
     /// @param logFilePath Optional path to log file (nullptr = console only)
     /// @param level Minimum severity level to display
-    static void Init(const char* logFilePath = "quantiloom.log", Level level = Level::Info);
+    /// @param mode Sync or Async (QUANTILOOM_LOG_ASYNC overrides)
+    static void Init(const char* logFilePath = "quantiloom.log", Level level = Level::Info,
+                     Mode mode = Mode::Sync);
 
     /// Shutdown the logging system (flushes buffers)
     static void Shutdown();
@@ -80,22 +129,80 @@ public:
         s_Logger->critical(fmt, std::forward<Args>(args)...);
     }
 
-    /// Flush all log buffers immediately
+    /// Flush all log buffers (async mode: after the messages already queued)
     static void Flush();
 
 private:
     static std::shared_ptr<spdlog::logger> s_Logger;
 };
 
+/// Occurrence counter of one rate-limited call site (see QL_LOG_FIRST_N)
+class LogSiteCounter {
+public:
+    u64 Next() { return m_count.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<u64> m_count{0};
+};
+
 } // namespace quantiloom
 
 // ============================================================================
 // Convenience Macros (optional - can be disabled if conflicts exist)
 // ============================================================================
 
-#define QL_LOG_TRACE(...)    ::quantiloom::Log::Trace(__VA_ARGS__)
-#define QL_LOG_DEBUG(...)    ::quantiloom::Log::Debug(__VA_ARGS__)
-#define QL_LOG_INFO(...)     ::quantiloom::Log::Info(__VA_ARGS__)
-#define QL_LOG_WARN(...)     ::quantiloom::Log::Warn(__VA_ARGS__)
-#define QL_LOG_ERROR(...)    ::quantiloom::Log::Error(__VA_ARGS__)
-#define QL_LOG_CRITICAL(...) ::quantiloom::Log::Critical(__VA_ARGS__)
+#if QL_LOG_ACTIVE_LEVEL <= QL_LOG_LEVEL_TRACE
+    #define QL_LOG_TRACE(...)    ::quantiloom::Log::Trace(__VA_ARGS__)
+#else
+    #define QL_LOG_TRACE(...)    do { if (false) ::quantiloom::Log::Trace(__VA_ARGS__); } while (0)
+#endif
+
+#if QL_LOG_ACTIVE_LEVEL <= QL_LOG_LEVEL_DEBUG
+    #define QL_LOG_DEBUG(...)    ::quantiloom::Log::Debug(__VA_ARGS__)
+#else
+    #define QL_LOG_DEBUG(...)    do { if (false) ::quantiloom::Log::Debug(__VA_ARGS__); } while (0)
+#endif
+
+#if QL_LOG_ACTIVE_LEVEL <= QL_LOG_LEVEL_INFO
+    #define QL_LOG_INFO(...)     ::quantiloom::Log::Info(__VA_ARGS__)
+#else
+    #define QL_LOG_INFO(...)     do { if (false) ::quantiloom::Log::Info(__VA_ARGS__); } while (0)
+#endif
+
+#if QL_LOG_ACTIVE_LEVEL <= QL_LOG_LEVEL_WARN
+    #define QL_LOG_WARN(...)     ::quantiloom::Log::Warn(__VA_ARGS__)
+#else
+    #define QL_LOG_WARN(...)     do { if (false) ::quantiloom::Log::Warn(__VA_ARGS__); } while (0)
+#endif
+
+#if QL_LOG_ACTIVE_LEVEL <= QL_LOG_LEVEL_ERROR
+    #define QL_LOG_ERROR(...)    ::quantiloom::Log::Error(__VA_ARGS__)
+#else
+    #define QL_LOG_ERROR(...)    do { if (false) ::quantiloom::Log::Error(__VA_ARGS__); } while (0)
+#endif
+
+#if QL_LOG_ACTIVE_LEVEL <= QL_LOG_LEVEL_CRITICAL
+    #define QL_LOG_CRITICAL(...) ::quantiloom::Log::Critical(__VA_ARGS__)
+#else
+    #define QL_LOG_CRITICAL(...) do { if (false) ::quantiloom::Log::Critical(__VA_ARGS__); } while (0)
+#endif
+
+// Rate-limited logging; level is TRACE, DEBUG, INFO, WARN, ERROR or CRITICAL
+#define QL_LOG_FIRST_N(level, n, ...) \
+    do { \
+        static ::quantiloom::LogSiteCounter ql_logSite; \
+        const ::quantiloom::u64 ql_logCount = ql_logSite.Next(); \
+        if (ql_logCount < static_cast<::quantiloom::u64>(n)) { \
+            QL_LOG_##level(__VA_ARGS__); \
+        } else if (ql_logCount == static_cast<::quantiloom::u64>(n)) { \
+            QL_LOG_##level("  (further messages from {}:{} suppressed)", __FILE__, __LINE__); \
+        } \
+    } while (false)
+
+#define QL_LOG_EVERY_N(level, n, ...) \
+    do { \
+        static ::quantiloom::LogSiteCounter ql_logSite; \
+        if (ql_logSite.Next() % static_cast<::quantiloom::u64>(n) == 0) { \
+            QL_LOG_##level(__VA_ARGS__); \
+        } \
+    } while (false)
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Types.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// ============================================================================
+// Parallel - Data-parallel loops on the core thread pool
+// ============================================================================
+// ParallelFor splits [0, count) into chunks of `grain` iterations and hands
+// the chunks out through an atomic counter to tasks on ThreadPool::Global()
+// (core/ThreadPool.hpp). The calling thread participates, so a loop with a
+// single chunk runs inline, and loops nest (the waiting thread helps).
+//
+// ParallelReduce gives every chunk its own partial result and combines the
+// partials in chunk order, so floating-point results do not depend on the
+// thread count or scheduling.
+//
+// Both accept an optional CancellationToken: once cancelled no further
+// chunks start, and the loop returns false. Bodies must not throw.
+//
+// Usage:
+//   ParallelFor(height, 16, [&](usize y) { ProcessRow(y); });
+//
+//   f64 sum = ParallelReduce(n, 4096, 0.0,
+//       [&](usize begin, usize end, f64& partial) { partial += Sum(values + begin, end - begin); },
+//       [](f64 a, f64 b) { return a + b; });
+// ============================================================================
+
+namespace quantiloom {
+
+template<typename Fn>
+bool ParallelFor(usize count, usize grain, Fn&& fn, const CancellationToken* cancel = nullptr) {
+    if (count == 0) {
+        return true;
+    }
+
+    grain = std::max<usize>(grain, 1);
+    const usize chunkCount = (count + grain - 1) / grain;
+    ThreadPool& pool = ThreadPool::Global();
+    const usize workerCount = std::min<usize>(chunkCount, pool.ThreadCount());
+
+    std::atomic<usize> nextChunk{0};
+    auto worker = [&]() {
+        for (;;) {
+            if (cancel && cancel->IsCancelled()) {
+                break;
+            }
+            usize chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount) {
+                break;
+            }
+            usize begin = chunk * grain;
+            usize end = std::min(count, begin + grain);
+            for (usize i = begin; i < end; ++i) {
+                fn(i);
+            }
+        }
+    };
+
+    // Serial fast path (single chunk or single thread)
+    if (workerCount <= 1) {
+        worker();
+        return !(cancel && cancel->IsCancelled());
+    }
+
+    TaskGroup group(pool);
+    for (usize t = 1; t < workerCount; ++t) {
+        group.Run(worker);
+    }
+
+    worker();
+    group.Wait();
+    return !(cancel && cancel->IsCancelled());
+}
+
+// Reduce [0, count): body(begin, end, partial) accumulates a chunk into a
+// partial that starts as identity; partials are folded with combine(a, b)
+// in chunk order
+template<typename T, typename Body, typename Combine>
+T ParallelReduce(usize count, usize grain, const T& identity, Body&& body, Combine&& combine,
+                 const CancellationToken* cancel = nullptr) {
+    grain = std::max<usize>(grain, 1);
+    const usize chunkCount = (count + grain - 1) / grain;
+    std::vector<T> partials(chunkCount, identity);
+    ParallelFor(chunkCount, 1, [&](usize chunk) {
+        const usize begin = chunk * grain;
+        body(begin, std::min(count, begin + grain), partials[chunk]);
+    }, cancel);
+
+    T result = identity;
+    for (T& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+// Run body(b, parallel) for every band: across bands when there are enough of
+// them to occupy all threads (parallel = false), else one band at a time with
+// parallelism inside the band (parallel = true)
+template<typename Fn>
+void ForEachBand(u32 bandCount, Fn&& body) {
+    const u32 threads = ThreadPool::Global().ThreadCount();
+    if (bandCount >= threads) {
+        ParallelFor(bandCount, 1, [&](usize b) { body(static_cast<u32>(b), false); });
+    } else {
+        for (u32 b = 0; b < bandCount; ++b) {
+            body(b, true);
+        }
+    }
+}
+
+} // namespace quantiloom
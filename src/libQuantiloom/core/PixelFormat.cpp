@@ -0,0 +1,175 @@
+#include "PixelFormat.hpp"
+#include "Log.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define QL_HALF_F16C_DISPATCH 1
+#include <immintrin.h>
+#elif defined(_M_X64) && defined(__AVX2__)
+#define QL_HALF_F16C_ALWAYS 1
+#include <immintrin.h>
+#endif
+
+namespace quantiloom {
+
+// Values per parallel work item (256 KB of f32)
+static constexpr usize kParallelChunk = 64 * 1024;
+
+// ============================================================================
+// Helper: F16C kernels (8 values per instruction, round to nearest even)
+// ============================================================================
+
+#if defined(QL_HALF_F16C_DISPATCH)
+#define QL_F16C_TARGET __attribute__((target("avx,f16c")))
+#else
+#define QL_F16C_TARGET
+#endif
+
+#if defined(QL_HALF_F16C_DISPATCH) || defined(QL_HALF_F16C_ALWAYS)
+
+QL_F16C_TARGET static void FloatToHalfF16c(const f32* src, f16* dst, usize count) {
+    usize i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+    }
+    for (; i < count; ++i) {
+        dst[i] = FloatToHalf(src[i]);
+    }
+}
+
+QL_F16C_TARGET static void HalfToFloatF16c(const f16* src, f32* dst, usize count) {
+    usize i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    for (; i < count; ++i) {
+        dst[i] = HalfToFloat(src[i]);
+    }
+}
+
+#endif
+
+bool HasHardwareHalf() {
+#if defined(QL_HALF_F16C_DISPATCH)
+    static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return supported;
+#elif defined(QL_HALF_F16C_ALWAYS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// Helper: Per-chunk kernels
+// ============================================================================
+
+static void FloatToHalfChunk(const f32* src, f16* dst, usize count) {
+#if defined(QL_HALF_F16C_DISPATCH) || defined(QL_HALF_F16C_ALWAYS)
+    if (HasHardwareHalf()) {
+        FloatToHalfF16c(src, dst, count);
+        return;
+    }
+#endif
+    for (usize i = 0; i < count; ++i) {
+        dst[i] = FloatToHalf(src[i]);
+    }
+}
+
+static void HalfToFloatChunk(const f16* src, f32* dst, usize count) {
+#if defined(QL_HALF_F16C_DISPATCH) || defined(QL_HALF_F16C_ALWAYS)
+    if (HasHardwareHalf()) {
+        HalfToFloatF16c(src, dst, count);
+        return;
+    }
+#endif
+    for (usize i = 0; i < count; ++i) {
+        dst[i] = HalfToFloat(src[i]);
+    }
+}
+
+// Split [0, count) into kParallelChunk pieces (inline for small arrays)
+template<typename Fn>
+static void ForEachChunk(usize count, bool parallel, Fn&& fn) {
+    if (!parallel) {
+        fn(0, count);
+        return;
+    }
+    const usize chunkCount = (count + kParallelChunk - 1) / kParallelChunk;
+    ParallelFor(chunkCount, 1, [&](usize chunk) {
+        const usize begin = chunk * kParallelChunk;
+        fn(begin, std::min(kParallelChunk, count - begin));
+    });
+}
+
+// ============================================================================
+// Bulk conversion
+// ============================================================================
+
+void ConvertSamples(const f32* src, f16* dst, usize count, bool parallel) {
+    ForEachChunk(count, parallel, [&](usize begin, usize n) { FloatToHalfChunk(src + begin, dst + begin, n); });
+}
+
+void ConvertSamples(const f16* src, f32* dst, usize count, bool parallel) {
+    ForEachChunk(count, parallel, [&](usize begin, usize n) { HalfToFloatChunk(src + begin, dst + begin, n); });
+}
+
+void ConvertSamples(const f32* src, u16* dst, usize count, f32 scale, f32 offset, bool parallel) {
+    const f32 invScale = scale > 0.0f ? 1.0f / scale : 0.0f;
+    ForEachChunk(count, parallel, [&](usize begin, usize n) {
+        // max(0, NaN) is 0, so NaN stores 0; the loop vectorises (no branches)
+        for (usize i = begin; i < begin + n; ++i) {
+            const f32 level = std::min(std::max(0.0f, (src[i] - offset) * invScale + 0.5f), 65535.0f);
+            dst[i] = static_cast<u16>(level);
+        }
+    });
+}
+
+void ConvertSamples(const u16* src, f32* dst, usize count, f32 scale, f32 offset, bool parallel) {
+    ForEachChunk(count, parallel, [&](usize begin, usize n) {
+        for (usize i = begin; i < begin + n; ++i) {
+            dst[i] = static_cast<f32>(src[i]) * scale + offset;
+        }
+    });
+}
+
+void Unorm16Range(const f32* values, usize count, f32& scale, f32& offset) {
+    f32 lo = std::numeric_limits<f32>::max();
+    f32 hi = std::numeric_limits<f32>::lowest();
+    for (usize i = 0; i < count; ++i) {
+        if (std::isfinite(values[i])) {
+            lo = std::min(lo, values[i]);
+            hi = std::max(hi, values[i]);
+        }
+    }
+
+    if (lo > hi) {
+        scale = 1.0f;   // No finite values
+        offset = 0.0f;
+        return;
+    }
+    offset = lo;
+    scale = hi > lo ? (hi - lo) / 65535.0f : 1.0f;
+}
+
+PixelFormat ParsePixelFormat(const String& name) {
+    if (name == "f32" || name == "float") {
+        return PixelFormat::F32;
+    }
+    if (name == "f16" || name == "half") {
+        return PixelFormat::F16;
+    }
+    if (name == "u16") {
+        return PixelFormat::U16;
+    }
+    QL_LOG_WARN("ParsePixelFormat: Unknown pixel format '{}' (expected f32, f16 or u16), using f32", name);
+    return PixelFormat::F32;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <bit>
+#include <type_traits>
+
+// ============================================================================
+// PixelFormat - Storage element types of Image and SpectralCube
+// ============================================================================
+// Containers are templated over their element type (ImageT<T>,
+// SpectralCubeT<T>); rendering and post-processing work on f32, compact
+// types are for outputs and previews:
+//
+//   F32  float                       4 bytes, working format
+//   F16  IEEE-754 binary16 (f16)     2 bytes, ~3 significant digits,
+//                                    range 6e-8 .. 65504 (larger -> Inf)
+//   U16  fixed point, value = stored * scale + offset
+//                                    2 bytes, 65536 levels over [min, max]
+//
+// Conversion kernels (ConvertSamples) use F16C (8 values per instruction)
+// when the CPU has it, checked once at run time, and a bit-exact scalar path
+// otherwise. Both round to nearest even. Large arrays are converted in
+// parallel chunks.
+//
+// Usage:
+//   ImageF16 half = ConvertToStorage<f16>(image);     // core/Image.hpp
+//   ImageIO::WriteEXR("preview.exr", half);           // HALF channels
+// ============================================================================
+
+namespace quantiloom {
+
+enum class PixelFormat : u8 {
+    F32,
+    F16,
+    U16
+};
+
+// IEEE-754 half as raw bits (arithmetic goes through f32)
+struct f16 {
+    u16 bits = 0;
+};
+static_assert(sizeof(f16) == 2, "f16 must be 2 bytes");
+
+// ============================================================================
+// Scalar conversion (round to nearest even; Inf/NaN preserved)
+// ============================================================================
+
+inline f16 FloatToHalf(f32 value) {
+    u32 f = std::bit_cast<u32>(value);
+    const u32 sign = f & 0x80000000u;
+    f ^= sign;
+
+    u32 h;
+    if (f >= (143u << 23)) {
+        // Overflow to Inf, NaN stays NaN (quiet)
+        h = f > (255u << 23) ? 0x7E00u : 0x7C00u;
+    } else if (f < (113u << 23)) {
+        // Denormal or zero: let the FPU round the mantissa
+        const u32 magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        h = std::bit_cast<u32>(std::bit_cast<f32>(f) + std::bit_cast<f32>(magic)) - magic;
+    } else {
+        const u32 mantissaOdd = (f >> 13) & 1u;
+        f += (static_cast<u32>(15 - 127) << 23) + 0xFFFu + mantissaOdd;
+        h = f >> 13;
+    }
+    return f16{static_cast<u16>(h | (sign >> 16))};
+}
+
+inline f32 HalfToFloat(f16 value) {
+    const u32 shiftedExponent = 0x7C00u << 13;
+    u32 f = (value.bits & 0x7FFFu) << 13;
+    const u32 exponent = f & shiftedExponent;
+    f += (127u - 15u) << 23;
+
+    if (exponent == shiftedExponent) {
+        f += (128u - 16u) << 23;   // Inf/NaN
+    } else if (exponent == 0) {
+        f += 1u << 23;             // Denormal: renormalise
+        f = std::bit_cast<u32>(std::bit_cast<f32>(f) - std::bit_cast<f32>(113u << 23));
+    }
+    return std::bit_cast<f32>(f | (static_cast<u32>(value.bits & 0x8000u) << 16));
+}
+
+// ============================================================================
+// Bulk conversion
+// ============================================================================
+
+// f32 <-> f16 (parallel = false keeps the conversion on the calling thread)
+QL_API void ConvertSamples(const f32* src, f16* dst, usize count, bool parallel = true);
+QL_API void ConvertSamples(const f16* src, f32* dst, usize count, bool parallel = true);
+
+// f32 <-> u16 fixed point: stored = round((value - offset) / scale), clamped
+// to [0, 65535]; NaN stores 0
+QL_API void ConvertSamples(const f32* src, u16* dst, usize count, f32 scale, f32 offset, bool parallel = true);
+QL_API void ConvertSamples(const u16* src, f32* dst, usize count, f32 scale, f32 offset, bool parallel = true);
+
+// Scale/offset mapping the finite range of values onto [0, 65535]
+QL_API void Unorm16Range(const f32* values, usize count, f32& scale, f32& offset);
+
+// True if the F16C path is in use
+QL_API bool HasHardwareHalf();
+
+// "f32", "f16" or "u16" (unknown names warn and give F32)
+QL_API PixelFormat ParsePixelFormat(const String& name);
+
+template <typename T>
+inline constexpr PixelFormat PixelFormatOf = std::is_same_v<T, f16> ? PixelFormat::F16
+                                           : std::is_same_v<T, u16> ? PixelFormat::U16
+                                                                    : PixelFormat::F32;
+
+inline const char* PixelFormatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::F16: return "f16";
+        case PixelFormat::U16: return "u16";
+        default: return "f32";
+    }
+}
+
+} // namespace quantiloom
@@ -0,0 +1,325 @@
+#include "Profiler.hpp"
+#include "Config.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace quantiloom {
+
+std::atomic<bool> Profiler::s_enabled{false};
+
+// ============================================================================
+// Helper: Per-thread event buffers
+// ============================================================================
+
+namespace {
+
+struct ScopeEvent {
+    const char* name;
+    u64 startNs;
+    u64 durationNs;
+    u64 selfNs;
+    u32 depth;
+};
+
+struct CounterEvent {
+    const char* name;
+    u64 timeNs;
+    f64 value;
+};
+
+struct ThreadBuffer {
+    u32 id = 0;
+    String name;
+    std::mutex mutex;   // Uncontended except while exporting
+    std::vector<ScopeEvent> scopes;
+    std::vector<CounterEvent> counters;
+    u64 dropped = 0;
+};
+
+// Buffers outlive their threads (pool workers may exit before export)
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+std::atomic<u64> g_epochNs{0};
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local ProfileScope* t_currentScope = nullptr;
+
+ThreadBuffer& LocalBuffer() {
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->id = static_cast<u32>(g_buffers.size());
+        buffer->name = fmt::format("thread {}", buffer->id);
+        t_buffer = buffer.get();
+        g_buffers.push_back(std::move(buffer));
+    }
+    return *t_buffer;
+}
+
+} // namespace
+
+// ============================================================================
+// Helper: JSON string escaping
+// ============================================================================
+
+static String JsonEscape(std::string_view text) {
+    String escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+// ============================================================================
+// Profiler
+// ============================================================================
+
+u64 Profiler::NowNs() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::Start() {
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (auto& buffer : g_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->scopes.clear();
+            buffer->counters.clear();
+            buffer->dropped = 0;
+        }
+    }
+    g_epochNs.store(NowNs(), std::memory_order_relaxed);
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void Profiler::Stop() {
+    s_enabled.store(false, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void Profiler::RecordScope(const char* name, u64 startNs, u64 durationNs, u64 selfNs, u32 depth) {
+    if (!IsEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.scopes.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.scopes.push_back({name, startNs, durationNs, selfNs, depth});
+}
+
+void Profiler::RecordCounter(const char* name, f64 value) {
+    const u64 now = NowNs();
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.counters.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.counters.push_back({name, now, value});
+}
+
+bool Profiler::WriteChromeTrace(const String& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        QL_LOG_ERROR("Profiler::WriteChromeTrace: Cannot open {}", path);
+        return false;
+    }
+
+    const u64 epoch = g_epochNs.load(std::memory_order_relaxed);
+    auto micros = [epoch](u64 ns) { return static_cast<f64>(ns - std::min(ns, epoch)) / 1000.0; };
+
+    usize eventCount = 0;
+    u64 dropped = 0;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() -> const char* {
+        const char* sep = first ? "" : ",\n";
+        first = false;
+        return sep;
+    };
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (auto& buffer : g_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (buffer->scopes.empty() && buffer->counters.empty()) {
+            continue;
+        }
+        dropped += buffer->dropped;
+
+        file << separator()
+             << fmt::format("{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                            buffer->id, JsonEscape(buffer->name));
+        for (const ScopeEvent& event : buffer->scopes) {
+            file << separator()
+                 << fmt::format("{{\"ph\":\"X\",\"name\":\"{}\",\"cat\":\"cpu\",\"pid\":1,\"tid\":{},"
+                                "\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"self_ms\":{:.6f}}}}}",
+                                JsonEscape(event.name), buffer->id, micros(event.startNs),
+                                static_cast<f64>(event.durationNs) / 1000.0,
+                                static_cast<f64>(event.selfNs) / 1e6);
+        }
+        for (const CounterEvent& event : buffer->counters) {
+            file << separator()
+                 << fmt::format("{{\"ph\":\"C\",\"name\":\"{}\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                                "\"args\":{{\"value\":{}}}}}",
+                                JsonEscape(event.name), buffer->id, micros(event.timeNs), event.value);
+        }
+        eventCount += buffer->scopes.size() + buffer->counters.size();
+    }
+    file << "\n]}\n";
+
+    if (!file) {
+        QL_LOG_ERROR("Profiler::WriteChromeTrace: Failed to write {}", path);
+        return false;
+    }
+    QL_LOG_INFO("Profiler: Wrote {} event(s) to {}{}", eventCount, path,
+                dropped > 0 ? fmt::format(" ({} dropped)", dropped) : String());
+    return true;
+}
+
+void Profiler::LogSummary() {
+    struct Stats {
+        u64 calls = 0;
+        u64 totalNs = 0;
+        u64 selfNs = 0;
+        u64 maxNs = 0;
+    };
+    std::unordered_map<std::string_view, Stats> byName;
+
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (auto& buffer : g_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            for (const ScopeEvent& event : buffer->scopes) {
+                Stats& stats = byName[event.name];
+                ++stats.calls;
+                stats.totalNs += event.durationNs;
+                stats.selfNs += event.selfNs;
+                stats.maxNs = std::max(stats.maxNs, event.durationNs);
+            }
+        }
+    }
+    if (byName.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<std::string_view, Stats>> rows(byName.begin(), byName.end());
+    std::sort(rows.begin(), rows.end(),
+              [](const auto& a, const auto& b) { return a.second.totalNs > b.second.totalNs; });
+
+    auto ms = [](u64 ns) { return static_cast<f64>(ns) / 1e6; };
+    QL_LOG_INFO("Profiler summary (times summed over threads):");
+    QL_LOG_INFO("  {:<36} {:>8} {:>12} {:>12} {:>10} {:>10}", "Scope", "Calls", "Total ms", "Self ms", "Mean ms", "Max ms");
+    for (const auto& [name, stats] : rows) {
+        QL_LOG_INFO("  {:<36} {:>8} {:>12.3f} {:>12.3f} {:>10.3f} {:>10.3f}",
+                    name, stats.calls, ms(stats.totalNs), ms(stats.selfNs),
+                    ms(stats.totalNs) / static_cast<f64>(stats.calls), ms(stats.maxNs));
+    }
+}
+
+// ============================================================================
+// ProfileScope
+// ============================================================================
+
+void ProfileScope::Next(const char* name) {
+    End();
+    if (Profiler::IsEnabled()) {
+        Begin(name);
+    }
+}
+
+void ProfileScope::Begin(const char* name) {
+    m_name = name;
+    m_parent = t_currentScope;
+    m_depth = m_parent ? m_parent->m_depth + 1 : 0;
+    m_childNs = 0;
+    t_currentScope = this;
+    m_startNs = Profiler::NowNs();
+}
+
+void ProfileScope::End() {
+    if (!m_name) {
+        return;
+    }
+    const u64 duration = Profiler::NowNs() - m_startNs;
+    if (m_parent) {
+        m_parent->m_childNs += duration;
+    }
+    t_currentScope = m_parent;
+    Profiler::RecordScope(m_name, m_startNs, duration, duration - std::min(duration, m_childNs), m_depth);
+    m_name = nullptr;
+}
+
+// ============================================================================
+// ProfilerSettings / ProfilerSession
+// ============================================================================
+
+ProfilerSettings ProfilerSettings::FromEnvironment() {
+    ProfilerSettings settings;
+    if (const char* path = std::getenv("QUANTILOOM_TRACE")) {
+        settings.tracePath = path;
+    }
+    return settings;
+}
+
+ProfilerSettings ProfilerSettings::FromConfig(const Config& config) {
+    ProfilerSettings settings;
+    settings.tracePath = config.Get<String>("profiling.trace", "");
+    settings.summary = config.Get<bool>("profiling.summary", false);
+    if (const char* path = std::getenv("QUANTILOOM_TRACE")) {
+        settings.tracePath = path;
+    }
+    return settings;
+}
+
+ProfilerSession::ProfilerSession(const ProfilerSettings& settings)
+    : m_settings(settings) {
+    if (m_settings.Enabled()) {
+        Profiler::SetThreadName("main");
+        Profiler::Start();
+    }
+}
+
+ProfilerSession::~ProfilerSession() {
+    if (!m_settings.Enabled()) {
+        return;
+    }
+    Profiler::Stop();
+    if (!m_settings.tracePath.empty()) {
+        Profiler::WriteChromeTrace(m_settings.tracePath);
+    }
+    if (m_settings.summary) {
+        Profiler::LogSummary();
+    }
+}
+
+} // namespace quantiloom
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <atomic>
+
+// ============================================================================
+// Profiler - Hierarchical scoped CPU timers and counters
+// ============================================================================
+// QL_PROFILE_SCOPE("name") times the enclosing scope on the calling thread.
+// Scopes nest per thread; every event records its total and self time
+// (total minus nested scopes). QL_PROFILE_COUNTER("name", value) records a
+// sample of a numeric series (bytes uploaded, bands written, ...).
+//
+// Events go into per-thread buffers without contention and can be exported
+// as Chrome trace-event JSON (open in ui.perfetto.dev or chrome://tracing)
+// and as a per-scope summary table in the log.
+//
+// Cost:
+//   Compiled out   QUANTILOOM_ENABLE_PROFILING=OFF (CMake), macros are empty
+//   Not started    one relaxed atomic load per scope
+//   Recording      two clock reads and one buffer append per scope
+// Names must be string literals (or otherwise outlive the profiler session).
+//
+// Configuration ([profiling] in TOML, QUANTILOOM_TRACE wins for the path):
+//   trace = "trace.json"   Chrome trace output ("" = none)
+//   summary = true         Summary table at exit
+//
+// Usage:
+//   ProfilerSession session(ProfilerSettings::FromConfig(config));
+//
+//   void Load() {
+//       QL_PROFILE_SCOPE("Load");
+//       ...
+//       QL_PROFILE_COUNTER("Texture bytes", bytes);
+//   }
+//
+//   QL_PROFILE_PHASE(phase, "Init");     // sequential phases of one function
+//   ...
+//   QL_PROFILE_NEXT_PHASE(phase, "Render");
+// ============================================================================
+
+namespace quantiloom {
+
+class Config;
+
+class QL_API Profiler {
+public:
+    // Events kept per thread (further events are counted as dropped)
+    static constexpr usize MAX_EVENTS_PER_THREAD = 1u << 20;
+
+    // Begin recording (clears events from an earlier session)
+    static void Start();
+
+    // Stop recording; events stay available for export
+    static void Stop();
+
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Name of the calling thread in traces (default "thread N")
+    static void SetThreadName(const char* name);
+
+    // Write recorded events as Chrome trace-event JSON
+    static bool WriteChromeTrace(const String& path);
+
+    // Log calls, total, self, mean and max time per scope name
+    static void LogSummary();
+
+    // Recording (used by the macros)
+    static void RecordScope(const char* name, u64 startNs, u64 durationNs, u64 selfNs, u32 depth);
+    static void RecordCounter(const char* name, f64 value);
+    static u64 NowNs();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// ============================================================================
+// ProfileScope - RAII timer behind QL_PROFILE_SCOPE / QL_PROFILE_PHASE
+// ============================================================================
+
+class QL_API ProfileScope {
+public:
+    explicit ProfileScope(const char* name) {
+        if (Profiler::IsEnabled()) {
+            Begin(name);
+        }
+    }
+    ~ProfileScope() {
+        if (m_name) {
+            End();
+        }
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    // End this event and start another at the same depth
+    void Next(const char* name);
+
+private:
+    void Begin(const char* name);
+    void End();
+
+    const char* m_name = nullptr;   // Null when not recording
+    ProfileScope* m_parent = nullptr;
+    u64 m_startNs = 0;
+    u64 m_childNs = 0;
+    u32 m_depth = 0;
+};
+
+// ============================================================================
+// ProfilerSession - Start from settings, export and summarise at scope exit
+// ============================================================================
+
+struct QL_API ProfilerSettings {
+    String tracePath;      // Chrome trace JSON ("" = none)
+    bool summary = false;  // Summary table at exit
+
+    bool Enabled() const { return !tracePath.empty() || summary; }
+
+    // QUANTILOOM_TRACE only
+    static ProfilerSettings FromEnvironment();
+
+    // [profiling] trace / summary, then QUANTILOOM_TRACE
+    static ProfilerSettings FromConfig(const Config& config);
+};
+
+class QL_API ProfilerSession {
+public:
+    explicit ProfilerSession(const ProfilerSettings& settings);
+    ~ProfilerSession();
+    ProfilerSession(const ProfilerSession&) = delete;
+    ProfilerSession& operator=(const ProfilerSession&) = delete;
+
+private:
+    ProfilerSettings m_settings;
+};
+
+} // namespace quantiloom
+
+// ============================================================================
+// Macros
+// ============================================================================
+
+#define QL_PROFILE_CONCAT_INNER(a, b) a##b
+#define QL_PROFILE_CONCAT(a, b) QL_PROFILE_CONCAT_INNER(a, b)
+
+#if defined(QL_ENABLE_PROFILING)
+    #define QL_PROFILE_SCOPE(name) \
+        ::quantiloom::ProfileScope QL_PROFILE_CONCAT(ql_profileScope, __LINE__)(name)
+    #define QL_PROFILE_PHASE(var, name) ::quantiloom::ProfileScope var(name)
+    #define QL_PROFILE_NEXT_PHASE(var, name) var.Next(name)
+    #define QL_PROFILE_COUNTER(name, value) \
+        do { \
+            if (::quantiloom::Profiler::IsEnabled()) { \
+                ::quantiloom::Profiler::RecordCounter(name, static_cast<::quantiloom::f64>(value)); \
+            } \
+        } while (false)
+#else
+    #define QL_PROFILE_SCOPE(name) (void)0
+    #define QL_PROFILE_PHASE(var, name) (void)0
+    #define QL_PROFILE_NEXT_PHASE(var, name) (void)0
+    #define QL_PROFILE_COUNTER(name, value) (void)0
+#endif
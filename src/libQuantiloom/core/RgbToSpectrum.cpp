@@ -0,0 +1,321 @@
+#include "RgbToSpectrum.hpp"
+#include "Color.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace quantiloom {
+
+// ============================================================================
+// Fetch / Pack
+// ============================================================================
+
+glm::vec3 RgbToSpectrumTable::Fetch(glm::vec3 rgb) const {
+    for (glm::length_t c = 0; c < 3; ++c) {
+        rgb[c] = std::clamp(rgb[c], 0.0f, 1.0f);
+    }
+
+    // Largest component selects the sub-table
+    glm::length_t l = 0;
+    if (rgb[1] > rgb[l]) l = 1;
+    if (rgb[2] > rgb[l]) l = 2;
+
+    const f32 z = rgb[l];
+    if (z <= 0.0f) {
+        return glm::vec3(0.0f, 0.0f, -std::numeric_limits<f32>::infinity());  // Black
+    }
+
+    const u32 res = resolution;
+    const f32 norm = static_cast<f32>(res - 1) / z;
+    const f32 x = rgb[(l + 1) % 3] * norm;
+    const f32 y = rgb[(l + 2) % 3] * norm;
+
+    const u32 xi = std::min(static_cast<u32>(x), res - 2);
+    const u32 yi = std::min(static_cast<u32>(y), res - 2);
+    const u32 zi = static_cast<u32>(
+        std::clamp<isize>(std::upper_bound(scale.begin(), scale.end(), z) - scale.begin() - 1,
+                          0, static_cast<isize>(res) - 2));
+
+    const f32 dx = x - static_cast<f32>(xi);
+    const f32 dy = y - static_cast<f32>(yi);
+    const f32 dz = (z - scale[zi]) / (scale[zi + 1] - scale[zi]);
+
+    auto at = [&](u32 k, u32 j, u32 i, glm::length_t c) {
+        return coefficients[((((static_cast<usize>(l) * res + k) * res + j) * res + i) * 3) + static_cast<usize>(c)];
+    };
+
+    glm::vec3 result;
+    for (glm::length_t c = 0; c < 3; ++c) {
+        const f32 x00 = at(zi, yi, xi, c) * (1 - dx) + at(zi, yi, xi + 1, c) * dx;
+        const f32 x01 = at(zi, yi + 1, xi, c) * (1 - dx) + at(zi, yi + 1, xi + 1, c) * dx;
+        const f32 x10 = at(zi + 1, yi, xi, c) * (1 - dx) + at(zi + 1, yi, xi + 1, c) * dx;
+        const f32 x11 = at(zi + 1, yi + 1, xi, c) * (1 - dx) + at(zi + 1, yi + 1, xi + 1, c) * dx;
+        const f32 y0 = x00 * (1 - dy) + x01 * dy;
+        const f32 y1 = x10 * (1 - dy) + x11 * dy;
+        result[c] = y0 * (1 - dz) + y1 * dz;
+    }
+    return result;
+}
+
+std::vector<f32> RgbToSpectrumTable::PackForGpu() const {
+    std::vector<f32> packed;
+    packed.reserve(4 + scale.size() + coefficients.size());
+    packed.push_back(static_cast<f32>(resolution));
+    packed.push_back(0.0f);
+    packed.push_back(0.0f);
+    packed.push_back(0.0f);
+    packed.insert(packed.end(), scale.begin(), scale.end());
+    packed.insert(packed.end(), coefficients.begin(), coefficients.end());
+    return packed;
+}
+
+// ============================================================================
+// Builder: colorimetric setup
+// ============================================================================
+
+namespace {
+
+// CIE standard illuminant D65, 380-780 nm in 10 nm steps
+constexpr std::array<f64, 41> kD65 = {
+    49.9755, 54.6482, 82.7549, 91.4860, 93.4318, 86.6823, 104.865, 117.008,
+    117.812, 114.861, 115.923, 108.811, 109.354, 107.802, 104.790, 107.689,
+    104.405, 104.046, 100.000, 96.3342, 95.7880, 88.6856, 90.0062, 89.5991,
+    87.6987, 83.2886, 83.6992, 80.0268, 80.2146, 82.2778, 78.2842, 69.7213,
+    71.6091, 74.3490, 61.6040, 69.8856, 75.0870, 63.5927, 46.4182, 66.8054,
+    63.3828};
+
+f64 D65(f64 wavelengthNm) {
+    const f64 position = std::clamp((wavelengthNm - 380.0) / 10.0, 0.0, 40.0);
+    const usize i = std::min<usize>(static_cast<usize>(position), 39);
+    const f64 t = position - static_cast<f64>(i);
+    return kD65[i] * (1.0 - t) + kD65[i + 1] * t;
+}
+
+// Integration grid over the optimisation range (5 nm trapezoid; the CIE fit is smooth)
+constexpr u32 kSamples = 95;
+
+struct Colorimetry {
+    std::array<f64, kSamples> t;                     // Normalised wavelength
+    std::array<std::array<f64, kSamples>, 3> rgb;    // Per-sample linear sRGB weights (D65-lit)
+    std::array<f64, 3> whiteXyz;
+
+    Colorimetry() {
+        const f64 step = (RgbToSpectrumTable::LAMBDA_MAX - RgbToSpectrumTable::LAMBDA_MIN) / (kSamples - 1);
+        std::array<glm::dvec3, kSamples> xyz;
+        f64 normY = 0.0;
+        for (u32 i = 0; i < kSamples; ++i) {
+            const f64 lambda = RgbToSpectrumTable::LAMBDA_MIN + i * step;
+            const f64 weight = ((i == 0 || i == kSamples - 1) ? 0.5 : 1.0) * step * D65(lambda);
+            const glm::vec3 cmf = CieColorMatching(static_cast<f32>(lambda));
+            xyz[i] = glm::dvec3(cmf.x, cmf.y, cmf.z) * weight;
+            normY += xyz[i].y;
+            t[i] = static_cast<f64>(i) / (kSamples - 1);
+        }
+
+        std::array<f64, 3> rowSum = {0.0, 0.0, 0.0};
+        for (u32 i = 0; i < kSamples; ++i) {
+            xyz[i] /= normY;
+            const glm::vec3 w = XyzToLinearSrgb(glm::vec3(xyz[i]));
+            for (u32 c = 0; c < 3; ++c) {
+                rgb[c][i] = w[static_cast<glm::length_t>(c)];
+                rowSum[c] += w[static_cast<glm::length_t>(c)];
+            }
+        }
+
+        // The analytic CIE fit puts the white of the grid within a few percent
+        // of sRGB white; rescale so a constant spectrum of 1 is exactly (1, 1, 1)
+        for (u32 c = 0; c < 3; ++c) {
+            for (u32 i = 0; i < kSamples; ++i) {
+                rgb[c][i] /= rowSum[c];
+            }
+        }
+
+        whiteXyz = {0.4124564 + 0.3575761 + 0.1804375,
+                    0.2126729 + 0.7151522 + 0.0721750,
+                    0.0193339 + 0.1191920 + 0.9503041};
+    }
+
+    // CIELAB relative to D65 (double precision: the Jacobian uses finite differences)
+    std::array<f64, 3> ToLab(const glm::dvec3& rgb) const {
+        const glm::dvec3 xyz(0.4124564 * rgb.x + 0.3575761 * rgb.y + 0.1804375 * rgb.z,
+                             0.2126729 * rgb.x + 0.7151522 * rgb.y + 0.0721750 * rgb.z,
+                             0.0193339 * rgb.x + 0.1191920 * rgb.y + 0.9503041 * rgb.z);
+        auto f = [](f64 v) {
+            constexpr f64 delta = 6.0 / 29.0;
+            return (v > delta * delta * delta) ? std::cbrt(v) : v / (3.0 * delta * delta) + 4.0 / 29.0;
+        };
+        const f64 fx = f(xyz.x / whiteXyz[0]);
+        const f64 fy = f(xyz.y / whiteXyz[1]);
+        const f64 fz = f(xyz.z / whiteXyz[2]);
+        return {116.0 * fy - 16.0, 500.0 * (fx - fy), 200.0 * (fy - fz)};
+    }
+};
+
+f64 Sigmoid(f64 x) {
+    return 0.5 + x / (2.0 * std::sqrt(1.0 + x * x));
+}
+
+// CIELAB difference between the target colour and the colour of spectrum c
+std::array<f64, 3> Residual(const Colorimetry& cm, const std::array<f64, 3>& c,
+                            const std::array<f64, 3>& targetLab) {
+    glm::dvec3 rgb(0.0);
+    for (u32 i = 0; i < kSamples; ++i) {
+        const f64 x = (c[0] * cm.t[i] + c[1]) * cm.t[i] + c[2];
+        const f64 s = Sigmoid(x);
+        rgb += glm::dvec3(cm.rgb[0][i], cm.rgb[1][i], cm.rgb[2][i]) * s;
+    }
+    const std::array<f64, 3> lab = cm.ToLab(rgb);
+    return {targetLab[0] - lab[0], targetLab[1] - lab[1], targetLab[2] - lab[2]};
+}
+
+// Solve the 3x3 system A x = b (Gaussian elimination, partial pivoting)
+bool Solve3x3(std::array<std::array<f64, 3>, 3> a, std::array<f64, 3> b, std::array<f64, 3>& x) {
+    for (u32 col = 0; col < 3; ++col) {
+        u32 pivot = col;
+        for (u32 row = col + 1; row < 3; ++row) {
+            if (std::abs(a[row][col]) > std::abs(a[pivot][col])) pivot = row;
+        }
+        if (std::abs(a[pivot][col]) < 1e-15) {
+            return false;
+        }
+        std::swap(a[col], a[pivot]);
+        std::swap(b[col], b[pivot]);
+        for (u32 row = col + 1; row < 3; ++row) {
+            const f64 factor = a[row][col] / a[col][col];
+            for (u32 k = col; k < 3; ++k) a[row][k] -= factor * a[col][k];
+            b[row] -= factor * b[col];
+        }
+    }
+    for (u32 row = 3; row-- > 0;) {
+        f64 sum = b[row];
+        for (u32 k = row + 1; k < 3; ++k) sum -= a[row][k] * x[k];
+        x[row] = sum / a[row][row];
+    }
+    return true;
+}
+
+f64 SquaredNorm(const std::array<f64, 3>& r) {
+    return r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+}
+
+// Gauss-Newton fit of the coefficients to an RGB target (c holds the initial guess).
+// Steps are halved until the residual shrinks: undamped steps from a warm start
+// one brightness node away overshoot on dark, saturated targets.
+void Optimize(const Colorimetry& cm, const glm::vec3& rgb, std::array<f64, 3>& c) {
+    const std::array<f64, 3> targetLab = cm.ToLab(glm::dvec3(rgb.x, rgb.y, rgb.z));
+    constexpr f64 kEpsilon = 1e-5;
+
+    std::array<f64, 3> r = Residual(cm, c, targetLab);
+    for (u32 iteration = 0; iteration < 30; ++iteration) {
+        if (SquaredNorm(r) < 1e-6) {
+            break;
+        }
+
+        std::array<std::array<f64, 3>, 3> jacobian;
+        for (u32 k = 0; k < 3; ++k) {
+            std::array<f64, 3> c0 = c;
+            std::array<f64, 3> c1 = c;
+            c0[k] -= kEpsilon;
+            c1[k] += kEpsilon;
+            const std::array<f64, 3> r0 = Residual(cm, c0, targetLab);
+            const std::array<f64, 3> r1 = Residual(cm, c1, targetLab);
+            for (u32 j = 0; j < 3; ++j) {
+                jacobian[j][k] = (r1[j] - r0[j]) / (2.0 * kEpsilon);
+            }
+        }
+
+        std::array<f64, 3> delta{};
+        if (!Solve3x3(jacobian, r, delta)) {
+            break;
+        }
+
+        bool improved = false;
+        for (f64 step = 1.0; step > 1e-3; step *= 0.5) {
+            std::array<f64, 3> candidate = {c[0] - step * delta[0], c[1] - step * delta[1],
+                                            c[2] - step * delta[2]};
+
+            // Keep the polynomial in a numerically sane range
+            const f64 largest = std::max({std::abs(candidate[0]), std::abs(candidate[1]),
+                                          std::abs(candidate[2])});
+            if (largest > 200.0) {
+                for (f64& v : candidate) v *= 200.0 / largest;
+            }
+
+            const std::array<f64, 3> candidateResidual = Residual(cm, candidate, targetLab);
+            if (SquaredNorm(candidateResidual) < SquaredNorm(r)) {
+                c = candidate;
+                r = candidateResidual;
+                improved = true;
+                break;
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
+
+f32 Smoothstep(f32 x) {
+    return x * x * (3.0f - 2.0f * x);
+}
+
+} // namespace
+
+// ============================================================================
+// Builder
+// ============================================================================
+
+RgbToSpectrumTable RgbToSpectrumTable::Build(u32 resolution) {
+    RgbToSpectrumTable table;
+    table.resolution = std::max(resolution, 2u);
+    const u32 res = table.resolution;
+
+    // Denser sampling near black and white where spectra change fastest
+    table.scale.resize(res);
+    for (u32 k = 0; k < res; ++k) {
+        table.scale[k] = Smoothstep(Smoothstep(static_cast<f32>(k) / static_cast<f32>(res - 1)));
+    }
+    table.coefficients.resize(9 * static_cast<usize>(res) * res * res);
+
+    const Colorimetry cm;
+    const u32 start = res / 5;
+
+    // Each (l, j, i) column is solved along k, warm-starting from the neighbour
+    ParallelFor(3 * static_cast<usize>(res) * res, 1, [&](usize column) {
+        const u32 l = static_cast<u32>(column / (static_cast<usize>(res) * res));
+        const u32 j = static_cast<u32>((column / res) % res);
+        const u32 i = static_cast<u32>(column % res);
+        const f32 x = static_cast<f32>(i) / static_cast<f32>(res - 1);
+        const f32 y = static_cast<f32>(j) / static_cast<f32>(res - 1);
+
+        auto solve = [&](u32 k, std::array<f64, 3>& c) {
+            const f32 z = table.scale[k];
+            const glm::length_t axis = static_cast<glm::length_t>(l);
+            glm::vec3 rgb;
+            rgb[axis] = z;
+            rgb[(axis + 1) % 3] = x * z;
+            rgb[(axis + 2) % 3] = y * z;
+            Optimize(cm, rgb, c);
+
+            const usize index = (((static_cast<usize>(l) * res + k) * res + j) * res + i) * 3;
+            for (u32 n = 0; n < 3; ++n) {
+                table.coefficients[index + n] = static_cast<f32>(c[n]);
+            }
+        };
+
+        std::array<f64, 3> c = {0.0, 0.0, 0.0};
+        for (u32 k = start; k < res; ++k) {
+            solve(k, c);
+        }
+        c = {0.0, 0.0, 0.0};
+        for (u32 k = start + 1; k-- > 0;) {
+            solve(k, c);
+        }
+    });
+
+    return table;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <glm/glm.hpp>
+#include <cmath>
+#include <vector>
+
+namespace quantiloom {
+
+// ============================================================================
+// RgbToSpectrumTable - RGB -> smooth reflectance spectrum uplifting
+// ============================================================================
+// Precomputed 3D table of sigmoid-polynomial coefficients (Jakob & Hanika,
+// "A Low-Dimensional Function Space for Efficient Spectral Upsampling",
+// EGSR 2019). Each linear sRGB reflectance maps to three coefficients c with
+//
+//   s(lambda) = S(c0 * t^2 + c1 * t + c2),   S(x) = 1/2 + x / (2 sqrt(1 + x^2))
+//   t = (lambda - LAMBDA_MIN) / (LAMBDA_MAX - LAMBDA_MIN), clamped to [0, 1]
+//
+// so evaluating a spectrum at any wavelength takes a handful of FLOPs. The
+// spectra are smooth, bounded to [0, 1] and reproduce the input colour under
+// D65 for the CIE 1931 observer. Outside LAMBDA_MIN..LAMBDA_MAX (e.g. NIR/SWIR)
+// the spectrum is held at its boundary value; use measured spectral materials
+// for bands beyond the visible.
+//
+// Table layout (res = resolution):
+//   scale[res]                   - Non-linear spacing of the brightest component
+//   coefficients[3][res][res][res][3]
+//     index [l][k][j][i]: l = index of the largest RGB component,
+//     k = brightness (via scale), j/i = the other two components relative to it
+//
+// The table is built offline in parallel (Build, or the QuantiloomRgbToSpectrum
+// tool), stored in HDF5 (RgbToSpectrumLoader) and loaded once per run.
+//
+// Usage:
+//   glm::vec3 c = table.Fetch(glm::vec3(0.8f, 0.2f, 0.1f));
+//   f32 reflectance = RgbToSpectrumTable::Evaluate(c, 550.0f);
+// ============================================================================
+
+struct QL_API RgbToSpectrumTable {
+    static constexpr f32 LAMBDA_MIN = 360.0f;   // Optimisation range (nm)
+    static constexpr f32 LAMBDA_MAX = 830.0f;
+    static constexpr u32 DEFAULT_RESOLUTION = 64;
+
+    u32 resolution = 0;
+    std::vector<f32> scale;         // [resolution]
+    std::vector<f32> coefficients;  // [3 * resolution^3 * 3]
+
+    bool IsValid() const {
+        return resolution >= 2 && scale.size() == resolution &&
+               coefficients.size() == 9 * static_cast<usize>(resolution) * resolution * resolution;
+    }
+
+    // Trilinearly interpolated coefficients for a linear RGB reflectance (clamped to [0, 1])
+    glm::vec3 Fetch(glm::vec3 rgb) const;
+
+    // Sigmoid-polynomial spectrum value at a wavelength
+    static f32 Evaluate(const glm::vec3& coeffs, f32 wavelengthNm) {
+        f32 t = (wavelengthNm - LAMBDA_MIN) / (LAMBDA_MAX - LAMBDA_MIN);
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        const f32 x = (coeffs.x * t + coeffs.y) * t + coeffs.z;
+        if (std::isinf(x)) {
+            return x > 0.0f ? 1.0f : 0.0f;
+        }
+        return 0.5f + x / (2.0f * std::sqrt(1.0f + x * x));
+    }
+
+    // Convenience: reflectance of an RGB colour at a wavelength
+    f32 EvaluateReflectance(const glm::vec3& rgb, f32 wavelengthNm) const {
+        return Evaluate(Fetch(rgb), wavelengthNm);
+    }
+
+    // Flat float array for the GPU (binding 8, see closesthit.rchit):
+    //   [0] resolution, [1..3] unused, scale[res], coefficients[...]
+    std::vector<f32> PackForGpu() const;
+
+    // Optimise the full table (parallel over table columns; seconds at res 64)
+    static RgbToSpectrumTable Build(u32 resolution = DEFAULT_RESOLUTION);
+};
+
+} // namespace quantiloom
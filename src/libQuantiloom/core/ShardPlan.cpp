@@ -0,0 +1,139 @@
+#include "ShardPlan.hpp"
+#include "Config.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace quantiloom {
+
+// ============================================================================
+// ShardPlanSettings
+// ============================================================================
+
+ShardPlanSettings ShardPlanSettings::FromConfig(const Config& config) {
+    ShardPlanSettings settings;
+    const std::vector<u32> tileSize = config.GetArray<u32>("distributed.tile_size");
+    if (tileSize.size() == 2) {
+        settings.tileWidth = tileSize[0];
+        settings.tileHeight = tileSize[1];
+    }
+    settings.bandsPerShard = config.Get<u32>("distributed.bands_per_shard", 0);
+    settings.samplesPerShard = config.Get<u32>("distributed.samples_per_shard", 0);
+    return settings;
+}
+
+// ============================================================================
+// ShardPlan
+// ============================================================================
+
+ShardPlan::ShardPlan(u32 width, u32 height, u32 bandCount, u32 spp, const ShardPlanSettings& settings)
+    : m_width(width)
+    , m_height(height)
+    , m_bandCount(bandCount)
+    , m_spp(std::max(spp, 1u))
+    , m_settings(settings) {
+    const u32 tileWidth = (settings.tileWidth == 0) ? width : std::min(settings.tileWidth, width);
+    const u32 tileHeight = (settings.tileHeight == 0) ? height : std::min(settings.tileHeight, height);
+    const u32 bandsPerShard = (settings.bandsPerShard == 0) ? bandCount : std::min(settings.bandsPerShard, bandCount);
+    const u32 samplesPerShard = (settings.samplesPerShard == 0) ? m_spp : std::min(settings.samplesPerShard, m_spp);
+    if (tileWidth == 0 || tileHeight == 0 || bandsPerShard == 0) {
+        return;
+    }
+
+    for (u32 bandStart = 0; bandStart < bandCount; bandStart += bandsPerShard) {
+        for (u32 y = 0; y < height; y += tileHeight) {
+            for (u32 x = 0; x < width; x += tileWidth) {
+                for (u32 sampleStart = 0; sampleStart < m_spp; sampleStart += samplesPerShard) {
+                    Shard shard;
+                    shard.index = static_cast<u32>(m_shards.size());
+                    shard.x = x;
+                    shard.y = y;
+                    shard.width = std::min(tileWidth, width - x);
+                    shard.height = std::min(tileHeight, height - y);
+                    shard.bandStart = bandStart;
+                    shard.bandCount = std::min(bandsPerShard, bandCount - bandStart);
+                    shard.sampleStart = sampleStart;
+                    shard.sampleCount = std::min(samplesPerShard, m_spp - sampleStart);
+                    m_shards.push_back(shard);
+                }
+            }
+        }
+    }
+}
+
+void ShardPlan::WriteMetadata(const Shard& shard, std::unordered_map<std::string, std::string>& metadata) const {
+    metadata["shard.plan"] = m_id;
+    metadata["shard.count"] = std::to_string(m_shards.size());
+    metadata["shard.image_width"] = std::to_string(m_width);
+    metadata["shard.image_height"] = std::to_string(m_height);
+    metadata["shard.band_count"] = std::to_string(m_bandCount);
+    metadata["shard.spp"] = std::to_string(m_spp);
+    metadata["shard.index"] = std::to_string(shard.index);
+    metadata["shard.x"] = std::to_string(shard.x);
+    metadata["shard.y"] = std::to_string(shard.y);
+    metadata["shard.width"] = std::to_string(shard.width);
+    metadata["shard.height"] = std::to_string(shard.height);
+    metadata["shard.band_start"] = std::to_string(shard.bandStart);
+    metadata["shard.band_span"] = std::to_string(shard.bandCount);
+    metadata["shard.sample_start"] = std::to_string(shard.sampleStart);
+    metadata["shard.sample_count"] = std::to_string(shard.sampleCount);
+}
+
+// ============================================================================
+// Shard metadata
+// ============================================================================
+
+bool IsShardMetadataKey(const std::string& key) {
+    return key.rfind("shard.", 0) == 0;
+}
+
+std::optional<ShardHeader> ReadShardHeader(const std::unordered_map<std::string, std::string>& metadata) {
+    bool complete = true;
+    auto read = [&](const char* key) -> u32 {
+        auto it = metadata.find(key);
+        u32 value = 0;
+        if (it == metadata.end()) {
+            complete = false;
+            return 0;
+        }
+        const std::string& text = it->second;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || ptr != text.data() + text.size()) {
+            complete = false;
+        }
+        return value;
+    };
+
+    ShardHeader header;
+    header.shardCount = read("shard.count");
+    header.imageWidth = read("shard.image_width");
+    header.imageHeight = read("shard.image_height");
+    header.bandCount = read("shard.band_count");
+    header.spp = read("shard.spp");
+    header.shard.index = read("shard.index");
+    header.shard.x = read("shard.x");
+    header.shard.y = read("shard.y");
+    header.shard.width = read("shard.width");
+    header.shard.height = read("shard.height");
+    header.shard.bandStart = read("shard.band_start");
+    header.shard.bandCount = read("shard.band_span");
+    header.shard.sampleStart = read("shard.sample_start");
+    header.shard.sampleCount = read("shard.sample_count");
+
+    auto plan = metadata.find("shard.plan");
+    if (!complete || plan == metadata.end()) {
+        return std::nullopt;
+    }
+    header.planId = plan->second;
+
+    // Shard must lie inside the image and plan
+    const Shard& s = header.shard;
+    if (s.index >= header.shardCount || s.width == 0 || s.height == 0 || s.bandCount == 0 ||
+        s.sampleCount == 0 || s.x + s.width > header.imageWidth || s.y + s.height > header.imageHeight ||
+        s.bandStart + s.bandCount > header.bandCount || s.sampleStart + s.sampleCount > header.spp) {
+        return std::nullopt;
+    }
+    return header;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// ShardPlan - Deterministic partition of a render into (tile x band x sample)
+// ============================================================================
+// A render of width x height pixels, bandCount bands and spp samples is cut
+// into shards: tiles of tileWidth x tileHeight pixels (edge tiles smaller),
+// groups of bandsPerShard bands and ranges of samplesPerShard samples. The
+// plan is a pure function of its inputs, so every worker computes the same
+// shard list and a shard index names the same work on every machine.
+//
+// Shard order: band group, then tile row, tile column, then sample range
+// (sample ranges of one tile and band group are adjacent).
+//
+// A worker renders one shard to a partial output whose metadata carries the
+// shard (shard.* keys, WriteMetadata / ReadShardHeader); ShardMerger
+// (io/ShardMerge.hpp) averages partials weighted by their sample counts.
+//
+// Config ([distributed]):
+//   tile_size = [256, 256]      # 0 or missing = whole image
+//   bands_per_shard = 16        # 0 = all bands
+//   samples_per_shard = 0       # 0 = all samples
+//
+// Usage:
+//   ShardPlan plan(1280, 720, 421, 16, ShardPlanSettings::FromConfig(config));
+//   for (const Shard& shard : plan.GetShards()) { ... }
+// ============================================================================
+
+namespace quantiloom {
+
+class Config;
+
+struct Shard {
+    u32 index = 0;
+    u32 x = 0;              // Tile origin and size (pixels)
+    u32 y = 0;
+    u32 width = 0;
+    u32 height = 0;
+    u32 bandStart = 0;      // Bands [bandStart, bandStart + bandCount)
+    u32 bandCount = 0;
+    u32 sampleStart = 0;    // Samples [sampleStart, sampleStart + sampleCount)
+    u32 sampleCount = 0;
+};
+
+struct QL_API ShardPlanSettings {
+    u32 tileWidth = 0;        // 0 = image width
+    u32 tileHeight = 0;       // 0 = image height
+    u32 bandsPerShard = 0;    // 0 = all bands
+    u32 samplesPerShard = 0;  // 0 = all samples
+
+    // [distributed] tile_size, bands_per_shard, samples_per_shard
+    static ShardPlanSettings FromConfig(const Config& config);
+};
+
+// Shard and plan identity as stored in a partial output
+struct ShardHeader {
+    Shard shard;
+    u32 shardCount = 0;
+    u32 imageWidth = 0;
+    u32 imageHeight = 0;
+    u32 bandCount = 0;
+    u32 spp = 0;
+    std::string planId;
+};
+
+class QL_API ShardPlan {
+public:
+    ShardPlan() = default;
+    ShardPlan(u32 width, u32 height, u32 bandCount, u32 spp, const ShardPlanSettings& settings);
+
+    u32 GetWidth() const { return m_width; }
+    u32 GetHeight() const { return m_height; }
+    u32 GetBandCount() const { return m_bandCount; }
+    u32 GetSpp() const { return m_spp; }
+    const ShardPlanSettings& GetSettings() const { return m_settings; }
+    const std::vector<Shard>& GetShards() const { return m_shards; }
+
+    // Identity of everything the shards' contents depend on (set by the
+    // planner, e.g. a hash of the render config); partials of different
+    // plans are never merged
+    void SetId(const std::string& id) { m_id = id; }
+    const std::string& GetId() const { return m_id; }
+
+    // Store shard and plan identity as shard.* metadata entries
+    void WriteMetadata(const Shard& shard, std::unordered_map<std::string, std::string>& metadata) const;
+
+private:
+    u32 m_width = 0;
+    u32 m_height = 0;
+    u32 m_bandCount = 0;
+    u32 m_spp = 0;
+    ShardPlanSettings m_settings;
+    std::vector<Shard> m_shards;
+    std::string m_id;
+};
+
+// Parse shard.* metadata (nullopt if missing or inconsistent)
+QL_API std::optional<ShardHeader> ReadShardHeader(const std::unordered_map<std::string, std::string>& metadata);
+
+// True for metadata keys written by ShardPlan::WriteMetadata
+QL_API bool IsShardMetadataKey(const std::string& key);
+
+} // namespace quantiloom
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Types.hpp"
+#include "PixelFormat.hpp"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -19,9 +22,14 @@ namespace quantiloom {
 // 3. MODTRAN comparison: most atmospheric models output band-major data
 //
 // Alternative layouts (e.g., BIP/BSQ/BIL) can be handled via HDF5 chunking.
+//
+// Element type: SpectralCube (f32) is the working format; SpectralCubeF16 /
+// SpectralCubeU16 halve memory and file size of outputs (see
+// core/PixelFormat.hpp). Convert with ConvertToStorage / ConvertToFloat.
 // ============================================================================
 
-struct SpectralCube {
+template <typename T>
+struct SpectralCubeT {
     // Spatial dimensions
     u32 width = 0;
     u32 height = 0;
@@ -35,8 +43,11 @@ struct SpectralCube {
     f32 delta_lambda = 0.0f;
 
     // Pixel data (C-order: [band][y][x])
-    // Always stored as f32
-    std::vector<f32> data;
+    std::vector<T> data;
+
+    // U16 storage only: value = data * scale + offset
+    f32 scale = 1.0f;
+    f32 offset = 0.0f;
 
     // Wavelength array (nbands elements, in nm)
     // wavelengths[b] = lambda_min + b * delta_lambda
@@ -49,9 +60,9 @@ struct SpectralCube {
     // Constructors
     // ========================================================================
 
-    SpectralCube() = default;
+    SpectralCubeT() = default;
 
-    SpectralCube(u32 w, u32 h, u32 nb, f32 lmin, f32 lmax)
+    SpectralCubeT(u32 w, u32 h, u32 nb, f32 lmin, f32 lmax)
         : width(w), height(h), nbands(nb),
           lambda_min(lmin), lambda_max(lmax) {
 
@@ -59,7 +70,7 @@ struct SpectralCube {
         delta_lambda = (lmax - lmin) / static_cast<f32>(nb - 1);
 
         // Allocate data
-        data.resize(w * h * nb, 0.0f);
+        data.resize(w * h * nb, T{});
 
         // Generate wavelength array
         wavelengths.resize(nb);
@@ -73,20 +84,20 @@ struct SpectralCube {
     // ========================================================================
 
     // Get pixel value at (x, y, band)
-    inline f32& operator()(u32 x, u32 y, u32 b) {
+    inline T& operator()(u32 x, u32 y, u32 b) {
         return data[b * height * width + y * width + x];
     }
 
-    inline const f32& operator()(u32 x, u32 y, u32 b) const {
+    inline const T& operator()(u32 x, u32 y, u32 b) const {
         return data[b * height * width + y * width + x];
     }
 
     // Get pointer to entire band (useful for per-band processing)
-    inline f32* BandPtr(u32 b) {
+    inline T* BandPtr(u32 b) {
         return &data[b * height * width];
     }
 
-    inline const f32* BandPtr(u32 b) const {
+    inline const T* BandPtr(u32 b) const {
         return &data[b * height * width];
     }
 
@@ -110,7 +121,7 @@ struct SpectralCube {
     }
 
     // Clear cube data
-    void Clear() { std::fill(data.begin(), data.end(), 0.0f); }
+    void Clear() { std::fill(data.begin(), data.end(), T{}); }
 
     // Get wavelength for band index
     inline f32 GetWavelength(u32 b) const {
@@ -136,4 +147,62 @@ struct SpectralCube {
     }
 };
 
+using SpectralCube = SpectralCubeT<f32>;
+using SpectralCubeF16 = SpectralCubeT<f16>;
+using SpectralCubeU16 = SpectralCubeT<u16>;
+
+// ============================================================================
+// Storage conversion
+// ============================================================================
+
+// Everything but the pixel data
+template <typename To, typename From>
+SpectralCubeT<To> CopyCubeHeader(const SpectralCubeT<From>& cube) {
+    SpectralCubeT<To> result;
+    result.width = cube.width;
+    result.height = cube.height;
+    result.nbands = cube.nbands;
+    result.lambda_min = cube.lambda_min;
+    result.lambda_max = cube.lambda_max;
+    result.delta_lambda = cube.delta_lambda;
+    result.wavelengths = cube.wavelengths;
+    result.metadata = cube.metadata;
+    return result;
+}
+
+// Same cube in another element type (U16 scale/offset span the finite range
+// of the whole cube, so bands stay comparable)
+template <typename T>
+SpectralCubeT<T> ConvertToStorage(const SpectralCube& cube) {
+    if constexpr (std::is_same_v<T, f32>) {
+        return cube;
+    } else {
+        SpectralCubeT<T> result = CopyCubeHeader<T>(cube);
+        result.data.resize(cube.data.size());
+        if constexpr (std::is_same_v<T, u16>) {
+            Unorm16Range(cube.data.data(), cube.data.size(), result.scale, result.offset);
+            ConvertSamples(cube.data.data(), result.data.data(), cube.data.size(), result.scale, result.offset);
+        } else {
+            ConvertSamples(cube.data.data(), result.data.data(), cube.data.size());
+        }
+        return result;
+    }
+}
+
+template <typename T>
+SpectralCube ConvertToFloat(const SpectralCubeT<T>& cube) {
+    if constexpr (std::is_same_v<T, f32>) {
+        return cube;
+    } else {
+        SpectralCube result = CopyCubeHeader<f32>(cube);
+        result.data.resize(cube.data.size());
+        if constexpr (std::is_same_v<T, u16>) {
+            ConvertSamples(cube.data.data(), result.data.data(), cube.data.size(), cube.scale, cube.offset);
+        } else {
+            ConvertSamples(cube.data.data(), result.data.data(), cube.data.size());
+        }
+        return result;
+    }
+}
+
 } // namespace quantiloom
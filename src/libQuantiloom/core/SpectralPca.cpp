@@ -0,0 +1,391 @@
+#include "SpectralPca.hpp"
+#include "Log.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace quantiloom {
+
+// Independent accumulators per reduction (one or two SIMD registers)
+static constexpr usize kLanes = 8;
+
+// Coefficient quantisation levels (u16)
+static constexpr f32 kQuantLevels = 65535.0f;
+
+// Jacobi stops when the off-diagonal energy falls below this fraction
+static constexpr f64 kJacobiTolerance = 1e-24;
+static constexpr u32 kJacobiMaxSweeps = 50;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// sum_i a[i] * b[i] with kLanes f64 partial sums
+static f64 LaneDot(const f32* a, const f32* b, usize n) {
+    f64 acc[kLanes] = {};
+    usize i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (usize l = 0; l < kLanes; ++l) {
+            acc[l] += static_cast<f64>(a[i + l]) * b[i + l];
+        }
+    }
+    for (; i < n; ++i) {
+        acc[0] += static_cast<f64>(a[i]) * b[i];
+    }
+    return std::accumulate(acc, acc + kLanes, 0.0);
+}
+
+static f64 LaneSum(const f32* a, usize n) {
+    f64 acc[kLanes] = {};
+    usize i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (usize l = 0; l < kLanes; ++l) {
+            acc[l] += a[i + l];
+        }
+    }
+    for (; i < n; ++i) {
+        acc[0] += a[i];
+    }
+    return std::accumulate(acc, acc + kLanes, 0.0);
+}
+
+// out[i] = mean + sum_k basisColumn[k] * coefficients[k][i]
+static void ReconstructBandSpan(const f32* coefficients, usize coefficientStride, u32 components,
+                                const f32* basis, u32 nbands, u32 band, f32 mean, usize n, f32* out) {
+    std::fill(out, out + n, mean);
+    for (u32 k = 0; k < components; ++k) {
+        const f32 weight = basis[static_cast<usize>(k) * nbands + band];
+        const f32* c = coefficients + k * coefficientStride;
+        for (usize i = 0; i < n; ++i) {
+            out[i] += weight * c[i];
+        }
+    }
+}
+
+// Dequantise the coefficients of one region row into rowCoefficients ([k][regionWidth])
+static void DequantizeRow(const SpectralPcaEncoding& encoding, u32 y, f32* rowCoefficients) {
+    const usize regionPixels = static_cast<usize>(encoding.regionWidth) * encoding.regionHeight;
+    const u32 tilesX = encoding.TilesX();
+    const u32 tileY = (encoding.regionY + y) / encoding.tileSize;
+    for (u32 k = 0; k < encoding.components; ++k) {
+        const u16* q = &encoding.coefficients[k * regionPixels + static_cast<usize>(y) * encoding.regionWidth];
+        const usize tileRow = (static_cast<usize>(k) * encoding.TilesY() + tileY) * tilesX;
+        f32* dst = rowCoefficients + static_cast<usize>(k) * encoding.regionWidth;
+        for (u32 x = 0; x < encoding.regionWidth; ++x) {
+            const usize tile = tileRow + (encoding.regionX + x) / encoding.tileSize;
+            dst[x] = encoding.offset[tile] + encoding.scale[tile] * static_cast<f32>(q[x]);
+        }
+    }
+}
+
+// Project, quantise and verify with the first k basis vectors; fills the
+// coefficient/scale/offset arrays and relativeRmse of encoding
+static void EncodeComponents(const SpectralCube& cube, SpectralPcaEncoding& encoding, f64 energy) {
+    const u32 nbands = cube.nbands;
+    const u32 width = cube.width;
+    const u32 k = encoding.components;
+    const u32 tileSize = encoding.tileSize;
+    const u32 tilesX = encoding.TilesX();
+    const u32 tilesY = encoding.TilesY();
+    const usize pixels = cube.PixelsPerBand();
+    const usize tileCount = static_cast<usize>(tilesX) * tilesY;
+
+    encoding.coefficients.assign(k * pixels, 0);
+    encoding.scale.assign(k * tileCount, 0.0f);
+    encoding.offset.assign(k * tileCount, 0.0f);
+
+    std::vector<f64> tileError(tileCount, 0.0);
+    ParallelFor(tileCount, 1, [&](usize tile) {
+        const u32 tx = static_cast<u32>(tile % tilesX);
+        const u32 ty = static_cast<u32>(tile / tilesX);
+        const u32 x0 = tx * tileSize;
+        const u32 y0 = ty * tileSize;
+        const u32 tw = std::min(tileSize, width - x0);
+        const u32 th = std::min(tileSize, cube.height - y0);
+        const usize tilePixels = static_cast<usize>(tw) * th;
+
+        // Project: coefficients [k][tile pixel], band rows are contiguous
+        std::vector<f32> projected(static_cast<usize>(k) * tilePixels, 0.0f);
+        std::vector<f32> centred(tw);
+        for (u32 y = 0; y < th; ++y) {
+            for (u32 b = 0; b < nbands; ++b) {
+                const f32* src = cube.BandPtr(b) + static_cast<usize>(y0 + y) * width + x0;
+                const f32 mean = encoding.mean[b];
+                for (u32 x = 0; x < tw; ++x) {
+                    centred[x] = src[x] - mean;
+                }
+                for (u32 c = 0; c < k; ++c) {
+                    const f32 weight = encoding.basis[static_cast<usize>(c) * nbands + b];
+                    f32* dst = &projected[c * tilePixels + static_cast<usize>(y) * tw];
+                    for (u32 x = 0; x < tw; ++x) {
+                        dst[x] += weight * centred[x];
+                    }
+                }
+            }
+        }
+
+        // Quantise with a per-component range
+        for (u32 c = 0; c < k; ++c) {
+            const f32* values = &projected[c * tilePixels];
+            const auto [lo, hi] = std::minmax_element(values, values + tilePixels);
+            const f32 offset = *lo;
+            const f32 scale = (*hi - *lo) / kQuantLevels;
+            const f32 invScale = scale > 0.0f ? 1.0f / scale : 0.0f;
+            encoding.offset[c * tileCount + tile] = offset;
+            encoding.scale[c * tileCount + tile] = scale;
+            for (u32 y = 0; y < th; ++y) {
+                u16* dst = &encoding.coefficients[c * pixels + static_cast<usize>(y0 + y) * width + x0];
+                const f32* src = values + static_cast<usize>(y) * tw;
+                for (u32 x = 0; x < tw; ++x) {
+                    dst[x] = static_cast<u16>(std::clamp((src[x] - offset) * invScale + 0.5f, 0.0f, kQuantLevels));
+                }
+            }
+        }
+
+        // Verify: reconstruct from the quantised values, accumulate squared error
+        std::vector<f32> dequantized(static_cast<usize>(k) * tw);
+        std::vector<f32> reconstructed(tw);
+        f64 error = 0.0;
+        for (u32 y = 0; y < th; ++y) {
+            for (u32 c = 0; c < k; ++c) {
+                const u16* q = &encoding.coefficients[c * pixels + static_cast<usize>(y0 + y) * width + x0];
+                const f32 offset = encoding.offset[c * tileCount + tile];
+                const f32 scale = encoding.scale[c * tileCount + tile];
+                for (u32 x = 0; x < tw; ++x) {
+                    dequantized[static_cast<usize>(c) * tw + x] = offset + scale * static_cast<f32>(q[x]);
+                }
+            }
+            for (u32 b = 0; b < nbands; ++b) {
+                const f32* src = cube.BandPtr(b) + static_cast<usize>(y0 + y) * width + x0;
+                ReconstructBandSpan(dequantized.data(), tw, k, encoding.basis.data(), nbands, b,
+                                    encoding.mean[b], tw, reconstructed.data());
+                for (u32 x = 0; x < tw; ++x) {
+                    reconstructed[x] -= src[x];
+                }
+                error += LaneDot(reconstructed.data(), reconstructed.data(), tw);
+            }
+        }
+        tileError[tile] = error;
+    });
+
+    const f64 totalError = std::accumulate(tileError.begin(), tileError.end(), 0.0);
+    encoding.relativeRmse = energy > 0.0 ? std::sqrt(totalError / energy) : 0.0;
+}
+
+// ============================================================================
+// SpectralPcaEncoding
+// ============================================================================
+
+bool SpectralPcaEncoding::IsValid() const {
+    const usize tiles = static_cast<usize>(TilesX()) * TilesY();
+    return width > 0 && height > 0 && nbands > 0 && components > 0 && tileSize > 0 &&
+           regionX + regionWidth <= width && regionY + regionHeight <= height &&
+           mean.size() == nbands && basis.size() == static_cast<usize>(components) * nbands &&
+           coefficients.size() == static_cast<usize>(components) * regionWidth * regionHeight &&
+           scale.size() == components * tiles && offset.size() == components * tiles;
+}
+
+// ============================================================================
+// SpectralPca::SymmetricEigen (cyclic Jacobi)
+// ============================================================================
+
+void SpectralPca::SymmetricEigen(std::vector<f64>& matrix, u32 n, std::vector<f64>& values, std::vector<f64>& vectors) {
+    std::vector<f64> v(static_cast<usize>(n) * n, 0.0);
+    for (u32 i = 0; i < n; ++i) {
+        v[static_cast<usize>(i) * n + i] = 1.0;
+    }
+    auto a = [&](u32 r, u32 c) -> f64& { return matrix[static_cast<usize>(r) * n + c]; };
+
+    f64 total = 0.0;
+    for (f64 x : matrix) {
+        total += x * x;
+    }
+
+    for (u32 sweep = 0; sweep < kJacobiMaxSweeps; ++sweep) {
+        f64 off = 0.0;
+        for (u32 p = 0; p < n; ++p) {
+            for (u32 q = p + 1; q < n; ++q) {
+                off += a(p, q) * a(p, q);
+            }
+        }
+        if (off <= kJacobiTolerance * total) {
+            break;
+        }
+
+        for (u32 p = 0; p < n; ++p) {
+            for (u32 q = p + 1; q < n; ++q) {
+                const f64 apq = a(p, q);
+                if (apq == 0.0) {
+                    continue;
+                }
+                // Rotation angle that zeroes a(p, q)
+                const f64 theta = (a(q, q) - a(p, p)) / (2.0 * apq);
+                const f64 t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const f64 c = 1.0 / std::sqrt(t * t + 1.0);
+                const f64 s = t * c;
+
+                for (u32 k = 0; k < n; ++k) {
+                    const f64 akp = a(k, p);
+                    const f64 akq = a(k, q);
+                    a(k, p) = c * akp - s * akq;
+                    a(k, q) = s * akp + c * akq;
+                }
+                for (u32 k = 0; k < n; ++k) {
+                    const f64 apk = a(p, k);
+                    const f64 aqk = a(q, k);
+                    a(p, k) = c * apk - s * aqk;
+                    a(q, k) = s * apk + c * aqk;
+                }
+                for (u32 k = 0; k < n; ++k) {
+                    f64& vkp = v[static_cast<usize>(k) * n + p];
+                    f64& vkq = v[static_cast<usize>(k) * n + q];
+                    const f64 oldP = vkp;
+                    vkp = c * oldP - s * vkq;
+                    vkq = s * oldP + c * vkq;
+                }
+            }
+        }
+    }
+
+    // Sort descending; eigenvectors are the columns of v
+    std::vector<u32> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](u32 i, u32 j) { return a(i, i) > a(j, j); });
+
+    values.resize(n);
+    vectors.resize(static_cast<usize>(n) * n);
+    for (u32 i = 0; i < n; ++i) {
+        values[i] = a(order[i], order[i]);
+        for (u32 k = 0; k < n; ++k) {
+            vectors[static_cast<usize>(i) * n + k] = v[static_cast<usize>(k) * n + order[i]];
+        }
+    }
+}
+
+// ============================================================================
+// SpectralPca::Encode
+// ============================================================================
+
+std::optional<SpectralPcaEncoding> SpectralPca::Encode(const SpectralCube& cube, const SpectralPcaSettings& settings) {
+    if (!cube.IsValid()) {
+        QL_LOG_ERROR("SpectralPca::Encode: Invalid spectral cube");
+        return std::nullopt;
+    }
+
+    const u32 nbands = cube.nbands;
+    const usize pixels = cube.PixelsPerBand();
+    const u32 maxComponents = settings.maxComponents > 0 ? std::min(settings.maxComponents, nbands) : nbands;
+
+    // Mean spectrum and total energy (sum x^2) over all pixels
+    std::vector<f64> bandSum(nbands), bandEnergy(nbands);
+    ParallelFor(nbands, 1, [&](usize b) {
+        const f32* band = cube.BandPtr(static_cast<u32>(b));
+        bandSum[b] = LaneSum(band, pixels);
+        bandEnergy[b] = LaneDot(band, band, pixels);
+    });
+
+    SpectralPcaEncoding encoding;
+    encoding.width = cube.width;
+    encoding.height = cube.height;
+    encoding.nbands = nbands;
+    encoding.tileSize = std::max(settings.tileSize, 1u);
+    encoding.regionWidth = cube.width;
+    encoding.regionHeight = cube.height;
+    encoding.mean.resize(nbands);
+    for (u32 b = 0; b < nbands; ++b) {
+        encoding.mean[b] = static_cast<f32>(bandSum[b] / static_cast<f64>(pixels));
+    }
+    const f64 energy = std::accumulate(bandEnergy.begin(), bandEnergy.end(), 0.0);
+
+    // Centred sample [band][sample]; covariance by band-pair dot products
+    const usize stride = std::max<usize>(1, pixels / std::max(settings.samplePixels, 1u));
+    const usize samples = (pixels + stride - 1) / stride;
+    std::vector<f32> sample(static_cast<usize>(nbands) * samples);
+    ParallelFor(nbands, 1, [&](usize b) {
+        const f32* band = cube.BandPtr(static_cast<u32>(b));
+        for (usize s = 0; s < samples; ++s) {
+            sample[b * samples + s] = band[s * stride] - encoding.mean[b];
+        }
+    });
+
+    std::vector<f64> covariance(static_cast<usize>(nbands) * nbands);
+    ParallelFor(nbands, 1, [&](usize i) {
+        for (usize j = i; j < nbands; ++j) {
+            const f64 c = LaneDot(&sample[i * samples], &sample[j * samples], samples) / static_cast<f64>(samples);
+            covariance[i * nbands + j] = c;
+            covariance[j * nbands + i] = c;
+        }
+    });
+
+    std::vector<f64> eigenvalues, eigenvectors;
+    SymmetricEigen(covariance, nbands, eigenvalues, eigenvectors);
+
+    // Smallest k whose discarded variance fits half the bound (the rest is
+    // left for quantisation); residual(k) ~ pixels * sum_{i >= k} lambda_i
+    const f64 bound = settings.maxRelativeRmse;
+    u32 components = maxComponents;
+    f64 residual = 0.0;
+    for (u32 k = nbands; k-- > 1;) {
+        residual += std::max(eigenvalues[k], 0.0) * static_cast<f64>(pixels);
+        if (energy > 0.0 && std::sqrt(residual / energy) > 0.5 * bound) {
+            components = std::min(maxComponents, k + 1);
+            break;
+        }
+        components = std::min(maxComponents, k);
+    }
+    components = std::max(components, 1u);
+
+    for (;;) {
+        encoding.components = components;
+        encoding.basis.resize(static_cast<usize>(components) * nbands);
+        for (usize i = 0; i < encoding.basis.size(); ++i) {
+            encoding.basis[i] = static_cast<f32>(eigenvectors[i]);
+        }
+
+        EncodeComponents(cube, encoding, energy);
+        QL_LOG_DEBUG("SpectralPca::Encode: {} components -> relative RMSE {:.3e}", components, encoding.relativeRmse);
+        if (encoding.relativeRmse <= bound) {
+            QL_LOG_INFO("SpectralPca::Encode: {} bands -> {} components, relative RMSE {:.3e}",
+                        nbands, components, encoding.relativeRmse);
+            return encoding;
+        }
+        if (components == maxComponents) {
+            QL_LOG_ERROR("SpectralPca::Encode: Relative RMSE {:.3e} with {} components exceeds the bound {:.3e}",
+                         encoding.relativeRmse, components, bound);
+            return std::nullopt;
+        }
+        components = std::min(maxComponents, components + std::max(1u, components / 2));
+    }
+}
+
+// ============================================================================
+// SpectralPca::Decode
+// ============================================================================
+
+void SpectralPca::Decode(const SpectralPcaEncoding& encoding, f32* out) {
+    const u32 width = encoding.regionWidth;
+    const usize regionPixels = static_cast<usize>(width) * encoding.regionHeight;
+
+    ParallelFor(encoding.regionHeight, 4, [&](usize y) {
+        std::vector<f32> rowCoefficients(static_cast<usize>(encoding.components) * width);
+        DequantizeRow(encoding, static_cast<u32>(y), rowCoefficients.data());
+        for (u32 b = 0; b < encoding.nbands; ++b) {
+            ReconstructBandSpan(rowCoefficients.data(), width, encoding.components, encoding.basis.data(),
+                                encoding.nbands, b, encoding.mean[b], width, out + b * regionPixels + y * width);
+        }
+    });
+}
+
+SpectralCube SpectralPca::Decode(const SpectralPcaEncoding& encoding) {
+    SpectralCube cube;
+    cube.width = encoding.regionWidth;
+    cube.height = encoding.regionHeight;
+    cube.nbands = encoding.nbands;
+    cube.data.resize(static_cast<usize>(cube.width) * cube.height * cube.nbands);
+    Decode(encoding, cube.data.data());
+    return cube;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include "SpectralCube.hpp"
+#include <optional>
+#include <vector>
+
+// ============================================================================
+// SpectralPca - Lossy band-decorrelating compression of spectral cubes
+// ============================================================================
+// Radiance spectra of neighbouring bands are strongly correlated, so a few
+// principal components carry almost all of the energy. Encoding:
+//
+//   1. Mean spectrum over all pixels; covariance of a strided pixel sample
+//      (blocked band-pair dot products, rows in parallel)
+//   2. Eigen-decomposition of the covariance (cyclic Jacobi) -> basis
+//   3. Smallest k whose discarded eigenvalue energy fits half the error
+//      bound; project every pixel onto the first k basis vectors
+//   4. Quantise coefficients to u16 with a scale/offset per tile and
+//      component (tiles keep the range tight where the scene is dark)
+//   5. Reconstruct, measure the actual relative RMSE; grow k and repeat if
+//      the bound is missed (fails only if all nbands components miss it)
+//
+// Relative RMSE = sqrt(sum (x - x')^2 / sum x^2) over the whole cube.
+// Storage per pixel drops from 4 * nbands to 2 * k bytes (plus the basis):
+// e.g. 400 bands at k = 12 is ~65x smaller.
+//
+// Decoding is x_b = mean_b + sum_k basis[k][b] * c_k, evaluated per band as
+// contiguous multiply-adds over blocks of pixels (vectorised, blocks in
+// parallel). An encoding may cover a region of the cube (ROI decode reads
+// only the coefficients of that region).
+//
+// Usage:
+//   SpectralPcaSettings settings;
+//   settings.maxRelativeRmse = 1e-3f;
+//   auto encoding = SpectralPca::Encode(cube, settings);
+//   SpectralCube decoded = SpectralPca::Decode(encoding.value());
+// ============================================================================
+
+namespace quantiloom {
+
+struct QL_API SpectralPcaSettings {
+    f32 maxRelativeRmse = 1e-3f;   // Error bound checked at encode time
+    u32 maxComponents = 0;         // 0 = up to nbands
+    u32 tileSize = 64;             // Quantisation tile (pixels per side)
+    u32 samplePixels = 32768;      // Pixels used for the covariance
+};
+
+struct QL_API SpectralPcaEncoding {
+    // Full cube
+    u32 width = 0;
+    u32 height = 0;
+    u32 nbands = 0;
+    u32 components = 0;
+    u32 tileSize = 64;
+
+    // Region covered by coefficients (whole cube after Encode)
+    u32 regionX = 0;
+    u32 regionY = 0;
+    u32 regionWidth = 0;
+    u32 regionHeight = 0;
+
+    std::vector<f32> mean;           // [nbands]
+    std::vector<f32> basis;          // [components][nbands], orthonormal rows
+    std::vector<u16> coefficients;   // [components][regionHeight][regionWidth]
+    std::vector<f32> scale;          // [components][tilesY][tilesX] (full cube tiles)
+    std::vector<f32> offset;         // [components][tilesY][tilesX]
+
+    f64 relativeRmse = 0.0;          // Measured by Encode
+
+    u32 TilesX() const { return (width + tileSize - 1) / tileSize; }
+    u32 TilesY() const { return (height + tileSize - 1) / tileSize; }
+    bool IsValid() const;
+};
+
+class QL_API SpectralPca {
+public:
+    // Encode a cube within settings.maxRelativeRmse (nullopt if impossible)
+    static std::optional<SpectralPcaEncoding> Encode(const SpectralCube& cube, const SpectralPcaSettings& settings = {});
+
+    // Reconstruct the encoded region into out ([nbands][regionHeight][regionWidth])
+    static void Decode(const SpectralPcaEncoding& encoding, f32* out);
+
+    // Reconstruct the encoded region as a cube (wavelengths left empty)
+    static SpectralCube Decode(const SpectralPcaEncoding& encoding);
+
+    // Eigen-decomposition of a symmetric n x n matrix (row-major, destroyed):
+    // eigenvalues descending, eigenvectors as rows of vectors ([n][n])
+    static void SymmetricEigen(std::vector<f64>& matrix, u32 n, std::vector<f64>& values, std::vector<f64>& vectors);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,252 @@
+#include "ThreadPool.hpp"
+#include "Config.hpp"
+#include "Log.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#if defined(QL_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(QL_WINDOWS)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace quantiloom {
+
+// ============================================================================
+// ThreadPoolSettings
+// ============================================================================
+
+static ThreadPoolSettings ApplyEnvironment(ThreadPoolSettings defaults) {
+    if (const char* threads = std::getenv("QUANTILOOM_THREADS")) {
+        char* end = nullptr;
+        const unsigned long count = std::strtoul(threads, &end, 10);
+        if (end != threads && *end == '\0') {
+            defaults.threadCount = static_cast<u32>(count);
+        } else {
+            QL_LOG_WARN("QUANTILOOM_THREADS: Ignoring '{}' (expected a thread count)", threads);
+        }
+    }
+    if (const char* pin = std::getenv("QUANTILOOM_PIN_THREADS")) {
+        const std::string value = pin;
+        defaults.pinThreads = !(value.empty() || value == "0" || value == "false" || value == "off");
+    }
+    return defaults;
+}
+
+ThreadPoolSettings ThreadPoolSettings::FromEnvironment() {
+    return ApplyEnvironment(ThreadPoolSettings());
+}
+
+ThreadPoolSettings ThreadPoolSettings::FromConfig(const Config& config) {
+    ThreadPoolSettings settings;
+    settings.threadCount = config.Get<u32>("threads.count", 0);
+    settings.pinThreads = config.Get<bool>("threads.pin", false);
+    return ApplyEnvironment(settings);
+}
+
+// ============================================================================
+// Helper: Pin the calling thread to the index-th allowed CPU
+// ============================================================================
+
+static bool PinCurrentThread(u32 index) {
+#if defined(QL_LINUX)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        return false;
+    }
+
+    // index-th CPU of the allowed set (respects taskset / cgroup limits)
+    const u32 target = index % static_cast<u32>(CPU_COUNT(&allowed));
+    u32 seen = 0;
+    for (u32 cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        if (seen++ == target) {
+            cpu_set_t single;
+            CPU_ZERO(&single);
+            CPU_SET(cpu, &single);
+            return pthread_setaffinity_np(pthread_self(), sizeof(single), &single) == 0;
+        }
+    }
+    return false;
+#elif defined(QL_WINDOWS)
+    DWORD_PTR processMask = 0, systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) || processMask == 0) {
+        return false;
+    }
+
+    u32 allowedCount = 0;
+    for (u32 cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+        allowedCount += (processMask >> cpu) & 1;
+    }
+    const u32 target = index % allowedCount;
+    u32 seen = 0;
+    for (u32 cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+        if (((processMask >> cpu) & 1) && seen++ == target) {
+            return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+        }
+    }
+    return false;
+#else
+    (void)index;
+    return false;
+#endif
+}
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
+
+ThreadPool::ThreadPool(const ThreadPoolSettings& settings) {
+    const u32 hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const u32 threadCount = settings.threadCount > 0 ? settings.threadCount : hardwareThreads;
+
+    m_workers.reserve(threadCount - 1);
+    for (u32 i = 1; i < threadCount; ++i) {
+        m_workers.emplace_back([this, i, pin = settings.pinThreads] { WorkerLoop(i, pin); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    if (m_workers.empty()) {
+        task();   // Single-threaded pool: run inline
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+bool ThreadPool::RunPendingTask() {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        task = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(u32 index, bool pin) {
+    Profiler::SetThreadName(fmt::format("worker {}", index).c_str());
+    if (pin && !PinCurrentThread(index)) {
+        QL_LOG_WARN("ThreadPool: Could not pin worker {} to a CPU", index);
+    }
+
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;   // Stopping and drained
+            }
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        task();
+    }
+}
+
+// Global pool (replaced only by ConfigureGlobal at start-up)
+static std::mutex g_globalMutex;
+static std::unique_ptr<ThreadPool> g_globalPool;
+
+ThreadPool& ThreadPool::Global() {
+    std::lock_guard<std::mutex> lock(g_globalMutex);
+    if (!g_globalPool) {
+        g_globalPool = std::make_unique<ThreadPool>(ThreadPoolSettings::FromEnvironment());
+    }
+    return *g_globalPool;
+}
+
+void ThreadPool::ConfigureGlobal(const ThreadPoolSettings& settings) {
+    std::lock_guard<std::mutex> lock(g_globalMutex);
+    g_globalPool.reset();
+    g_globalPool = std::make_unique<ThreadPool>(settings);
+    QL_LOG_INFO("ThreadPool: {} threads{}", g_globalPool->ThreadCount(),
+                settings.pinThreads ? " (pinned)" : "");
+}
+
+// ============================================================================
+// TaskGroup
+// ============================================================================
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : m_pool(pool) {
+}
+
+TaskGroup::~TaskGroup() {
+    Wait();
+}
+
+void TaskGroup::Run(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_pending;
+    }
+    m_pool.Submit([this, task = std::move(task)] {
+        if (!m_token.IsCancelled()) {
+            task();
+        }
+        // Notify under the lock: Wait() may return and destroy the group as
+        // soon as the lock is released
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_pending;
+        m_done.notify_all();
+    });
+}
+
+void TaskGroup::Wait() {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pending == 0) {
+                return;
+            }
+        }
+
+        // Help instead of blocking (our tasks may still be queued)
+        if (m_pool.RunPendingTask()) {
+            continue;
+        }
+
+        // Everything queued is taken; wait for running tasks, rechecking the
+        // queue now and then for work submitted by nested loops
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait_for(lock, std::chrono::milliseconds(1), [this] { return m_pending == 0; });
+    }
+}
+
+} // namespace quantiloom
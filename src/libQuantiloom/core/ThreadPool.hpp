@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Types.hpp"
+#include "Platform.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// ============================================================================
+// ThreadPool - Fixed worker pool shared by every subsystem
+// ============================================================================
+// One process-wide pool (ThreadPool::Global()) runs all CPU parallelism:
+// ParallelFor / ParallelReduce / ForEachBand (core/Parallel.hpp) and
+// TaskGroups. Workers are started once, so short parallel loops cost a
+// queue push instead of a thread spawn.
+//
+// A thread waiting on a TaskGroup runs queued tasks while it waits, so
+// parallel loops can nest (a band loop inside a file loop) without
+// deadlocking or oversubscribing: the total stays at ThreadCount().
+//
+// Thread count and pinning come from ThreadPoolSettings:
+//   [threads] count = 0 (all cores), pin = false     (TOML config)
+//   QUANTILOOM_THREADS, QUANTILOOM_PIN_THREADS       (environment, wins)
+// Pinning binds worker i to the i-th allowed CPU after the first (Linux,
+// Windows; ignored on macOS).
+//
+// Usage:
+//   ThreadPool::ConfigureGlobal(ThreadPoolSettings::FromConfig(config));
+//
+//   TaskGroup group;
+//   for (const auto& file : files) {
+//       group.Run([&file] { Process(file); });
+//   }
+//   group.Wait();
+// ============================================================================
+
+namespace quantiloom {
+
+class Config;
+
+struct QL_API ThreadPoolSettings {
+    u32 threadCount = 0;       // Including the calling thread; 0 = all cores
+    bool pinThreads = false;   // Bind workers to CPUs
+
+    // Defaults, overridden by QUANTILOOM_THREADS / QUANTILOOM_PIN_THREADS
+    static ThreadPoolSettings FromEnvironment();
+
+    // [threads] count / pin, then environment overrides
+    static ThreadPoolSettings FromConfig(const Config& config);
+};
+
+// Cooperative cancellation: loops stop handing out work once cancelled,
+// work already running finishes (long bodies may poll IsCancelled())
+class QL_API CancellationToken {
+public:
+    void Cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    void Reset() { m_cancelled.store(false, std::memory_order_relaxed); }
+    bool IsCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+};
+
+class QL_API ThreadPool {
+public:
+    explicit ThreadPool(const ThreadPoolSettings& settings = {});
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Workers + the calling thread
+    u32 ThreadCount() const { return static_cast<u32>(m_workers.size()) + 1; }
+
+    // Queue a task (must not throw)
+    void Submit(std::function<void()> task);
+
+    // Run one queued task on the calling thread (false if the queue is empty)
+    bool RunPendingTask();
+
+    // Process-wide pool, created from the environment on first use
+    static ThreadPool& Global();
+
+    // Replace the global pool (at start-up, while no parallel work runs)
+    static void ConfigureGlobal(const ThreadPoolSettings& settings);
+
+private:
+    void WorkerLoop(u32 index, bool pin);
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+};
+
+// ============================================================================
+// TaskGroup - Tasks that are waited for (and cancelled) together
+// ============================================================================
+
+class QL_API TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::Global());
+    ~TaskGroup();
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Queue a task; skipped if the group is cancelled before it starts
+    void Run(std::function<void()> task);
+
+    // Block until every task has finished, running queued tasks meanwhile
+    void Wait();
+
+    void Cancel() { m_token.Cancel(); }
+    bool IsCancelled() const { return m_token.IsCancelled(); }
+    const CancellationToken& Token() const { return m_token; }
+
+private:
+    ThreadPool& m_pool;
+    CancellationToken m_token;
+    std::mutex m_mutex;                // Guards m_pending
+    usize m_pending = 0;
+    std::condition_variable m_done;
+};
+
+} // namespace quantiloom
@@ -220,6 +220,9 @@ namespace constants {
 
     // Planck constant (J⋅s)
     inline constexpr f64 PLANCK_CONSTANT = 6.62607015e-34;
+
+    // Boltzmann constant (J/K)
+    inline constexpr f64 BOLTZMANN_CONSTANT = 1.380649e-23;
 }
 
 } // namespace quantiloom
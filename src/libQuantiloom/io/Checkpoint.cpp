@@ -0,0 +1,320 @@
+#include "Checkpoint.hpp"
+#include "core/Config.hpp"
+#include "core/Log.hpp"
+#include "core/Profiler.hpp"
+
+#include <H5Cpp.h>
+#include <filesystem>
+
+#if defined(QL_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: Durable writes
+// ============================================================================
+// flush() / close() only hand the data to the OS. A checkpoint marking a
+// band done must not reach the disk before the band itself, or a power loss
+// leaves a checkpoint pointing at missing data: files are synced before
+// anything refers to them, and their directory after creating or renaming.
+
+// Force path's data to the device
+static bool SyncFile(const std::string& path) {
+#if defined(QL_WINDOWS)
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    const bool synced = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return synced;
+#else
+    const int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    const bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+// Force the directory entries (created / renamed files) of path's directory
+// to the device (POSIX; NTFS journals directory changes itself)
+static void SyncParentDirectory(const std::string& path) {
+#if !defined(QL_WINDOWS)
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    const int fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// ============================================================================
+// Helper: HDF5 attributes and datasets
+// ============================================================================
+
+template<typename T>
+static void WriteScalar(H5::H5File& file, const char* name, const H5::PredType& type, const T& value) {
+    file.createAttribute(name, type, H5::DataSpace(H5S_SCALAR)).write(type, &value);
+}
+
+template<typename T>
+static T ReadScalar(H5::H5File& file, const char* name, const H5::PredType& type) {
+    T value{};
+    file.openAttribute(name).read(type, &value);
+    return value;
+}
+
+template<typename T>
+static void WriteArray(H5::H5File& file, const char* name, const H5::PredType& type, const std::vector<T>& data) {
+    hsize_t dims[1] = {data.size()};
+    file.createDataSet(name, type, H5::DataSpace(1, dims)).write(data.data(), type);
+}
+
+// false if the dataset does not hold exactly size values
+template<typename T>
+static bool ReadArray(H5::H5File& file, const char* name, const H5::PredType& type, usize size,
+                      std::vector<T>& data) {
+    H5::DataSet dataset = file.openDataSet(name);
+    hsize_t dims[1] = {0};
+    if (dataset.getSpace().getSimpleExtentNdims() != 1) {
+        return false;
+    }
+    dataset.getSpace().getSimpleExtentDims(dims);
+    if (dims[0] != size) {
+        return false;
+    }
+    data.resize(size);
+    dataset.read(data.data(), type);
+    return true;
+}
+
+// ============================================================================
+// Helper: Content hashing
+// ============================================================================
+
+// FNV-1a of the file's bytes (nullopt if it cannot be read)
+static std::optional<u64> HashFileContents(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    u64 hash = 14695981039346656037ull;
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const usize count = static_cast<usize>(file.gcount());
+        for (usize i = 0; i < count; ++i) {
+            hash ^= static_cast<u8>(buffer[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+    if (file.bad()) {
+        return std::nullopt;
+    }
+    return hash;
+}
+
+// ============================================================================
+// CheckpointFile
+// ============================================================================
+
+bool CheckpointFile::Write(const std::string& path, const RenderCheckpoint& checkpoint) {
+    QL_PROFILE_SCOPE("CheckpointFile::Write");
+    const std::string tempPath = path + ".tmp";
+
+    try {
+        H5::H5File file(tempPath, H5F_ACC_TRUNC);
+
+        const u32 version = RenderCheckpoint::VERSION;
+        WriteScalar(file, "version", H5::PredType::NATIVE_UINT32, version);
+        H5::StrType strType(H5::PredType::C_S1, H5T_VARIABLE);
+        file.createAttribute("fingerprint", strType, H5::DataSpace(H5S_SCALAR))
+            .write(strType, checkpoint.fingerprint);
+        WriteScalar(file, "width", H5::PredType::NATIVE_UINT32, checkpoint.width);
+        WriteScalar(file, "height", H5::PredType::NATIVE_UINT32, checkpoint.height);
+        WriteScalar(file, "band_count", H5::PredType::NATIVE_UINT32, checkpoint.bandCount);
+        WriteScalar(file, "spp", H5::PredType::NATIVE_UINT32, checkpoint.spp);
+        WriteScalar(file, "seed", H5::PredType::NATIVE_UINT64, checkpoint.seed);
+        WriteScalar(file, "band", H5::PredType::NATIVE_UINT32, checkpoint.band);
+        WriteScalar(file, "next_sample", H5::PredType::NATIVE_UINT32, checkpoint.nextSample);
+
+        WriteArray(file, "bands_done", H5::PredType::NATIVE_UINT8, checkpoint.bandsDone);
+        if (!checkpoint.sum.empty()) {
+            WriteArray(file, "sum", H5::PredType::NATIVE_FLOAT, checkpoint.sum);
+            WriteArray(file, "sample_counts", H5::PredType::NATIVE_UINT32, checkpoint.sampleCounts);
+        }
+        file.close();
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("CheckpointFile::Write: Failed to write {}: {}", tempPath, e.getDetailMsg());
+        return false;
+    }
+
+    // On disk before it replaces the previous checkpoint
+    if (!SyncFile(tempPath)) {
+        QL_LOG_ERROR("CheckpointFile::Write: Cannot sync {}", tempPath);
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        QL_LOG_ERROR("CheckpointFile::Write: Cannot replace {}: {}", path, ec.message());
+        return false;
+    }
+    SyncParentDirectory(path);
+    return true;
+}
+
+std::optional<RenderCheckpoint> CheckpointFile::Read(const std::string& path) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return std::nullopt;
+    }
+
+    RenderCheckpoint checkpoint;
+    try {
+        H5::H5File file(path, H5F_ACC_RDONLY);
+
+        const u32 version = ReadScalar<u32>(file, "version", H5::PredType::NATIVE_UINT32);
+        if (version != RenderCheckpoint::VERSION) {
+            QL_LOG_WARN("CheckpointFile::Read: {} has version {}, expected {}", path, version,
+                        RenderCheckpoint::VERSION);
+            return std::nullopt;
+        }
+        H5::StrType strType(H5::PredType::C_S1, H5T_VARIABLE);
+        file.openAttribute("fingerprint").read(strType, checkpoint.fingerprint);
+        checkpoint.width = ReadScalar<u32>(file, "width", H5::PredType::NATIVE_UINT32);
+        checkpoint.height = ReadScalar<u32>(file, "height", H5::PredType::NATIVE_UINT32);
+        checkpoint.bandCount = ReadScalar<u32>(file, "band_count", H5::PredType::NATIVE_UINT32);
+        checkpoint.spp = ReadScalar<u32>(file, "spp", H5::PredType::NATIVE_UINT32);
+        checkpoint.seed = ReadScalar<u64>(file, "seed", H5::PredType::NATIVE_UINT64);
+        checkpoint.band = ReadScalar<u32>(file, "band", H5::PredType::NATIVE_UINT32);
+        checkpoint.nextSample = ReadScalar<u32>(file, "next_sample", H5::PredType::NATIVE_UINT32);
+
+        const usize pixels = static_cast<usize>(checkpoint.width) * checkpoint.height;
+        bool valid = ReadArray(file, "bands_done", H5::PredType::NATIVE_UINT8, checkpoint.bandCount,
+                               checkpoint.bandsDone);
+        if (valid && file.nameExists("sum")) {
+            valid = ReadArray(file, "sum", H5::PredType::NATIVE_FLOAT, pixels * 4, checkpoint.sum) &&
+                    ReadArray(file, "sample_counts", H5::PredType::NATIVE_UINT32, pixels, checkpoint.sampleCounts);
+        }
+        const bool partialBand = checkpoint.nextSample > 0;
+        if (!valid || checkpoint.band > checkpoint.bandCount || checkpoint.nextSample >= checkpoint.spp ||
+            partialBand != !checkpoint.sum.empty()) {
+            QL_LOG_WARN("CheckpointFile::Read: {} is inconsistent", path);
+            return std::nullopt;
+        }
+    } catch (const H5::Exception& e) {
+        QL_LOG_WARN("CheckpointFile::Read: Failed to read {}: {}", path, e.getDetailMsg());
+        return std::nullopt;
+    }
+    return checkpoint;
+}
+
+void CheckpointFile::Remove(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(path + ".tmp", ec);
+}
+
+std::string CheckpointFile::Fingerprint(const Config& config) {
+    QL_PROFILE_SCOPE("CheckpointFile::Fingerprint");
+    toml::table files;
+    for (const char* key : {"scene.gltf", "spectral.rgb_to_spectrum_table", "spectral_materials.library"}) {
+        const String path = config.Get<String>(key, "");
+        if (path.empty()) {
+            continue;
+        }
+        const auto hash = HashFileContents(path);
+        if (!hash) {
+            continue;   // Missing files fail later, when the scene is loaded
+        }
+        files.insert_or_assign(key, fmt::format("{:016x}", *hash));
+    }
+    toml::table stamps;
+    stamps.insert_or_assign("scene_files", std::move(files));
+
+    const Config identity = config.Without({"threads", "profiling", "checkpoint"})
+                                .WithOverrides(Config::FromTable(stamps));
+    return fmt::format("{:016x}", identity.Hash());
+}
+
+// ============================================================================
+// CheckpointBandStore
+// ============================================================================
+
+bool CheckpointBandStore::Open(const std::string& path, usize pixelsPerBand, bool keep) {
+    Close();
+    std::error_code ec;
+    if (!keep || !std::filesystem::exists(path, ec)) {
+        std::ofstream create(path, std::ios::binary | std::ios::trunc);
+        if (!create) {
+            QL_LOG_ERROR("CheckpointBandStore::Open: Cannot create {}", path);
+            return false;
+        }
+        create.close();
+        SyncParentDirectory(path);
+    }
+    m_file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!m_file) {
+        QL_LOG_ERROR("CheckpointBandStore::Open: Cannot open {}", path);
+        return false;
+    }
+    m_path = path;
+    m_pixelsPerBand = pixelsPerBand;
+    return true;
+}
+
+void CheckpointBandStore::Close() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+bool CheckpointBandStore::Write(u32 band, const f32* pixels) {
+    const std::streamsize bytes = static_cast<std::streamsize>(m_pixelsPerBand * sizeof(f32));
+    m_file.clear();
+    m_file.seekp(static_cast<std::streamoff>(band) * bytes);
+    m_file.write(reinterpret_cast<const char*>(pixels), bytes);
+    m_file.flush();
+    if (!m_file) {
+        QL_LOG_ERROR("CheckpointBandStore::Write: Failed to write band {} to {}", band, m_path);
+        return false;
+    }
+    // On disk before a checkpoint can mark the band done
+    if (!SyncFile(m_path)) {
+        QL_LOG_ERROR("CheckpointBandStore::Write: Cannot sync {}", m_path);
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointBandStore::Read(u32 band, f32* pixels) {
+    const std::streamsize bytes = static_cast<std::streamsize>(m_pixelsPerBand * sizeof(f32));
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(band) * bytes);
+    m_file.read(reinterpret_cast<char*>(pixels), bytes);
+    if (!m_file || m_file.gcount() != bytes) {
+        QL_LOG_ERROR("CheckpointBandStore::Read: Failed to read band {} from {}", band, m_path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace quantiloom {
+
+class Config;
+
+// ============================================================================
+// RenderCheckpoint - Resumable state of a band-by-band render
+// ============================================================================
+// A render proceeds band by band and, within a band, in passes over the
+// sample sequence. The checkpoint records which bands are finished and the
+// accumulation of the band in progress: the sample-weighted radiance sum and
+// the samples per pixel. Jitter is counter-based (Philox keyed by the seed,
+// counter = pixel and sample index), so seed and next sample index are the
+// complete RNG state; a resumed render is bit-identical to an uninterrupted
+// one.
+//
+// Finished bands are not part of the checkpoint file: they go to a
+// CheckpointBandStore next to it and are only marked finished by a
+// checkpoint written after the band data was synced to disk.
+//
+// HDF5 structure (CheckpointFile):
+//   attr version, fingerprint, width, height, band_count, spp,
+//        seed, band, next_sample
+//   bands_done     - u8 [band_count], 1 = band in the band store
+//   sum            - f32 [height * width * 4], RGBA radiance x samples
+//                    (absent when the band has no samples yet)
+//   sample_counts  - u32 [height * width], samples summed per pixel
+//
+// Writes are atomic and durable: the file is written as <path>.tmp, synced
+// (fsync) and renamed over <path>, then the directory is synced, so a crash
+// or power loss leaves the previous checkpoint or the new one intact.
+//
+// The fingerprint (CheckpointFile::Fingerprint) identifies the render: the
+// config without process settings ([threads], [profiling], [checkpoint])
+// plus a hash of the contents of the scene files it names (glTF, RGB to
+// spectrum table, spectral library). Contents rather than size and mtime,
+// so a checkpoint still resumes after the inputs were copied elsewhere
+// (relative paths) or restored without preserving timestamps. Files a
+// .gltf refers to (buffers, images) are not hashed; changing those needs a
+// fresh render.
+//
+// Usage:
+//   CheckpointFile::Write("cube.h5.ckpt", checkpoint);
+//   if (auto checkpoint = CheckpointFile::Read("cube.h5.ckpt")) { ... }
+// ============================================================================
+
+struct RenderCheckpoint {
+    static constexpr u32 VERSION = 1;
+
+    std::string fingerprint;        // Config / scene identity; resume only if equal
+    u32 width = 0;
+    u32 height = 0;
+    u32 bandCount = 0;
+    u32 spp = 0;
+    u64 seed = 0;                   // Philox key
+
+    std::vector<u8> bandsDone;      // Completed-band bitmap [bandCount]
+
+    u32 band = 0;                   // Band in progress
+    u32 nextSample = 0;             // Philox counter of its next sample
+    std::vector<f32> sum;           // RGBA radiance x samples (empty: no samples yet)
+    std::vector<u32> sampleCounts;  // Samples in sum per pixel
+};
+
+class QL_API CheckpointFile {
+public:
+    // Write atomically (<path>.tmp, then renamed over path)
+    static bool Write(const std::string& path, const RenderCheckpoint& checkpoint);
+
+    // nullopt if missing, unreadable, of another version or inconsistent
+    static std::optional<RenderCheckpoint> Read(const std::string& path);
+
+    // Remove the checkpoint and its temporary file (after the render finished)
+    static void Remove(const std::string& path);
+
+    // Identity of the render described by config (see above)
+    static std::string Fingerprint(const Config& config);
+};
+
+// ============================================================================
+// CheckpointBandStore - Finished bands of a checkpointed render
+// ============================================================================
+// Raw f32 file of bandCount x pixelsPerBand values; band b at offset
+// b * pixelsPerBand * 4. Bands are written in place and synced to disk
+// before Write returns, so the store grows with the render instead of being
+// rewritten per checkpoint, and no checkpoint can get ahead of its data.
+// Which bands are valid is recorded by RenderCheckpoint::bandsDone.
+// ============================================================================
+
+class QL_API CheckpointBandStore {
+public:
+    // Open or create path; keep = false discards existing contents
+    bool Open(const std::string& path, usize pixelsPerBand, bool keep);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    bool Write(u32 band, const f32* pixels);
+    bool Read(u32 band, f32* pixels);
+
+private:
+    std::fstream m_file;
+    std::string m_path;
+    usize m_pixelsPerBand = 0;
+};
+
+} // namespace quantiloom
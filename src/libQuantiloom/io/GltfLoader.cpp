@@ -1,9 +1,10 @@
 #include "GltfLoader.hpp"
 #include "core/Log.hpp"
+#include "core/Profiler.hpp"
+#include "io/TextureCache.hpp"
 
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE_WRITE  // We don't need write functionality
 #include <tiny_gltf.h>
 
@@ -79,11 +80,13 @@ static glm::mat4 ParseNodeTransform(const tinygltf::Node& node) {
 // ============================================================================
 
 template<>
-std::vector<glm::vec3> GltfLoader::ReadAccessor<glm::vec3>(const void* gltfModelPtr, int accessorIndex) {
+void GltfLoader::ReadAccessor<glm::vec3>(const void* gltfModelPtr, int accessorIndex,
+                                         std::pmr::vector<glm::vec3>& out) {
     const auto& model = *static_cast<const tinygltf::Model*>(gltfModelPtr);
 
+    out.clear();
     if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) {
-        return {};
+        return;
     }
 
     const auto& accessor = model.accessors[accessorIndex];
@@ -93,23 +96,22 @@ std::vector<glm::vec3> GltfLoader::ReadAccessor<glm::vec3>(const void* gltfModel
     const u8* dataPtr = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
     size_t stride = bufferView.byteStride ? bufferView.byteStride : sizeof(float) * 3;
 
-    std::vector<glm::vec3> result;
-    result.reserve(accessor.count);
+    out.reserve(accessor.count);
 
     for (size_t i = 0; i < accessor.count; ++i) {
         const float* floatPtr = reinterpret_cast<const float*>(dataPtr + i * stride);
-        result.emplace_back(floatPtr[0], floatPtr[1], floatPtr[2]);
+        out.emplace_back(floatPtr[0], floatPtr[1], floatPtr[2]);
     }
-
-    return result;
 }
 
 template<>
-std::vector<glm::vec2> GltfLoader::ReadAccessor<glm::vec2>(const void* gltfModelPtr, int accessorIndex) {
+void GltfLoader::ReadAccessor<glm::vec2>(const void* gltfModelPtr, int accessorIndex,
+                                         std::pmr::vector<glm::vec2>& out) {
     const auto& model = *static_cast<const tinygltf::Model*>(gltfModelPtr);
 
+    out.clear();
     if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) {
-        return {};
+        return;
     }
 
     const auto& accessor = model.accessors[accessorIndex];
@@ -119,26 +121,24 @@ std::vector<glm::vec2> GltfLoader::ReadAccessor<glm::vec2>(const void* gltfModel
     const u8* dataPtr = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
     size_t stride = bufferView.byteStride ? bufferView.byteStride : sizeof(float) * 2;
 
-    std::vector<glm::vec2> result;
-    result.reserve(accessor.count);
+    out.reserve(accessor.count);
 
     for (size_t i = 0; i < accessor.count; ++i) {
         const float* floatPtr = reinterpret_cast<const float*>(dataPtr + i * stride);
-        result.emplace_back(floatPtr[0], floatPtr[1]);
+        out.emplace_back(floatPtr[0], floatPtr[1]);
     }
-
-    return result;
 }
 
 // ============================================================================
 // ReadIndices
 // ============================================================================
 
-std::vector<u32> GltfLoader::ReadIndices(const void* gltfModelPtr, int accessorIndex) {
+void GltfLoader::ReadIndices(const void* gltfModelPtr, int accessorIndex, std::pmr::vector<u32>& out) {
     const auto& model = *static_cast<const tinygltf::Model*>(gltfModelPtr);
 
+    out.clear();
     if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) {
-        return {};
+        return;
     }
 
     const auto& accessor = model.accessors[accessorIndex];
@@ -147,27 +147,55 @@ std::vector<u32> GltfLoader::ReadIndices(const void* gltfModelPtr, int accessorI
 
     const u8* dataPtr = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
 
-    std::vector<u32> result;
-    result.reserve(accessor.count);
+    out.reserve(accessor.count);
 
     // glTF indices can be u8, u16, or u32
     if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
         for (size_t i = 0; i < accessor.count; ++i) {
-            result.push_back(static_cast<u32>(dataPtr[i]));
+            out.push_back(static_cast<u32>(dataPtr[i]));
         }
     } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
         const u16* indices = reinterpret_cast<const u16*>(dataPtr);
         for (size_t i = 0; i < accessor.count; ++i) {
-            result.push_back(static_cast<u32>(indices[i]));
+            out.push_back(static_cast<u32>(indices[i]));
         }
     } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT) {
         const u32* indices = reinterpret_cast<const u32*>(dataPtr);
-        for (size_t i = 0; i < accessor.count; ++i) {
-            result.push_back(indices[i]);
-        }
+        out.assign(indices, indices + accessor.count);
     }
+}
 
-    return result;
+// ============================================================================
+// Helper: Bytes of geometry the meshes will need (sizes the scene arena)
+// ============================================================================
+
+static usize EstimateGeometryBytes(const tinygltf::Model& model) {
+    auto accessorCount = [&](int accessorIndex) -> usize {
+        if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) {
+            return 0;
+        }
+        return model.accessors[accessorIndex].count;
+    };
+    auto attributeCount = [&](const tinygltf::Primitive& primitive, const char* name) -> usize {
+        auto it = primitive.attributes.find(name);
+        return it != primitive.attributes.end() ? accessorCount(it->second) : 0;
+    };
+
+    // Per-array slack for alignment padding
+    constexpr usize kSlack = 64;
+
+    usize bytes = 0;
+    for (const auto& mesh : model.meshes) {
+        bytes += mesh.primitives.size() * sizeof(GeometryPrimitive) + kSlack;
+        for (const auto& primitive : mesh.primitives) {
+            const usize vertexCount = attributeCount(primitive, "POSITION");
+            bytes += vertexCount * sizeof(glm::vec3) + kSlack;
+            bytes += attributeCount(primitive, "NORMAL") * sizeof(glm::vec3) + kSlack;
+            bytes += attributeCount(primitive, "TEXCOORD_0") * sizeof(glm::vec2) + kSlack;
+            bytes += (primitive.indices >= 0 ? accessorCount(primitive.indices) : vertexCount) * sizeof(u32) + kSlack;
+        }
+    }
+    return bytes;
 }
 
 // ============================================================================
@@ -186,7 +214,7 @@ Texture GltfLoader::ParseTexture(const void* gltfModelPtr, int textureIndex) {
     const auto& gltfImage = model.images[gltfTexture.source];
 
     Texture tex;
-    tex.name = gltfImage.name.empty() ? ("Texture_" + std::to_string(textureIndex)) : gltfImage.name;
+    tex.name = gltfImage.name.empty() ? fmt::format("Texture_{}", textureIndex) : gltfImage.name;
     tex.width = static_cast<u32>(gltfImage.width);
     tex.height = static_cast<u32>(gltfImage.height);
     tex.channels = static_cast<u32>(gltfImage.component);
@@ -213,6 +241,14 @@ Texture GltfLoader::ParseTexture(const void* gltfModelPtr, int textureIndex) {
             tex.sampler.magFilter = TextureSampler::Filter::Linear;
         }
 
+        // Mip filter (no mipmap mode in glTF = linear, we always generate mips)
+        if (gltfSampler.minFilter == TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST ||
+            gltfSampler.minFilter == TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST) {
+            tex.sampler.mipFilter = TextureSampler::Filter::Nearest;
+        } else {
+            tex.sampler.mipFilter = TextureSampler::Filter::Linear;
+        }
+
         // Wrap mode S
         switch (gltfSampler.wrapS) {
             case TINYGLTF_TEXTURE_WRAP_REPEAT:
@@ -244,7 +280,7 @@ Texture GltfLoader::ParseTexture(const void* gltfModelPtr, int textureIndex) {
         }
     }
 
-    QL_LOG_INFO("  Loaded texture '{}' ({}x{}, {} channels)",
+    QL_LOG_DEBUG("  Loaded texture '{}' ({}x{}, {} channels)",
                 tex.name, tex.width, tex.height, tex.channels);
 
     return tex;
@@ -271,7 +307,7 @@ Material GltfLoader::ParseMaterial(const void* gltfModelPtr, int materialIndex,
     }
 
     const auto& gltfMaterial = model.materials[materialIndex];
-    mat.name = gltfMaterial.name.empty() ? ("Material_" + std::to_string(materialIndex)) : gltfMaterial.name;
+    mat.name = gltfMaterial.name.empty() ? fmt::format("Material_{}", materialIndex) : gltfMaterial.name;
 
     // PBR metallic-roughness
     const auto& pbr = gltfMaterial.pbrMetallicRoughness;
@@ -326,7 +362,7 @@ Material GltfLoader::ParseMaterial(const void* gltfModelPtr, int materialIndex,
     // Compute spectral albedo for M1 compatibility
     mat.ComputeSpectralAlbedo();
 
-    QL_LOG_INFO("  Loaded material '{}' (metallic={:.2f}, roughness={:.2f})",
+    QL_LOG_DEBUG("  Loaded material '{}' (metallic={:.2f}, roughness={:.2f})",
                 mat.name, mat.metallicFactor, mat.roughnessFactor);
 
     return mat;
@@ -337,7 +373,8 @@ Material GltfLoader::ParseMaterial(const void* gltfModelPtr, int materialIndex,
 // ============================================================================
 
 Mesh GltfLoader::ParseMesh(const void* gltfModelPtr, int meshIndex,
-                            const std::vector<Material>& materials) {
+                            const std::vector<Material>& materials,
+                            std::pmr::memory_resource* resource) {
     const auto& model = *static_cast<const tinygltf::Model*>(gltfModelPtr);
 
     if (meshIndex < 0 || meshIndex >= static_cast<int>(model.meshes.size())) {
@@ -347,14 +384,15 @@ Mesh GltfLoader::ParseMesh(const void* gltfModelPtr, int meshIndex,
 
     const auto& gltfMesh = model.meshes[meshIndex];
 
-    Mesh mesh;
-    mesh.name = gltfMesh.name.empty() ? ("Mesh_" + std::to_string(meshIndex)) : gltfMesh.name;
+    Mesh mesh(resource);
+    mesh.name = gltfMesh.name.empty() ? fmt::format("Mesh_{}", meshIndex) : gltfMesh.name;
 
     // Parse each primitive
+    mesh.primitives.reserve(gltfMesh.primitives.size());
     for (size_t primIdx = 0; primIdx < gltfMesh.primitives.size(); ++primIdx) {
         const auto& gltfPrimitive = gltfMesh.primitives[primIdx];
 
-        GeometryPrimitive primitive;
+        GeometryPrimitive primitive(resource);
 
         // Material ID
         primitive.materialId = (gltfPrimitive.material >= 0) ? gltfPrimitive.material : 0;
@@ -362,7 +400,7 @@ Mesh GltfLoader::ParseMesh(const void* gltfModelPtr, int meshIndex,
         // Positions (required)
         auto posIt = gltfPrimitive.attributes.find("POSITION");
         if (posIt != gltfPrimitive.attributes.end()) {
-            primitive.positions = ReadAccessor<glm::vec3>(gltfModelPtr, posIt->second);
+            ReadAccessor(gltfModelPtr, posIt->second, primitive.positions);
         } else {
             QL_LOG_ERROR("Primitive {} in mesh '{}' has no POSITION attribute", primIdx, mesh.name);
             continue;
@@ -371,18 +409,18 @@ Mesh GltfLoader::ParseMesh(const void* gltfModelPtr, int meshIndex,
         // Normals (optional)
         auto normIt = gltfPrimitive.attributes.find("NORMAL");
         if (normIt != gltfPrimitive.attributes.end()) {
-            primitive.normals = ReadAccessor<glm::vec3>(gltfModelPtr, normIt->second);
+            ReadAccessor(gltfModelPtr, normIt->second, primitive.normals);
         }
 
         // UVs (optional, use TEXCOORD_0)
         auto uvIt = gltfPrimitive.attributes.find("TEXCOORD_0");
         if (uvIt != gltfPrimitive.attributes.end()) {
-            primitive.uvs = ReadAccessor<glm::vec2>(gltfModelPtr, uvIt->second);
+            ReadAccessor(gltfModelPtr, uvIt->second, primitive.uvs);
         }
 
         // Indices (required for indexed geometry)
         if (gltfPrimitive.indices >= 0) {
-            primitive.indices = ReadIndices(gltfModelPtr, gltfPrimitive.indices);
+            ReadIndices(gltfModelPtr, gltfPrimitive.indices, primitive.indices);
         } else {
             // Non-indexed geometry: generate sequential indices
             primitive.indices.resize(primitive.positions.size());
@@ -391,13 +429,13 @@ Mesh GltfLoader::ParseMesh(const void* gltfModelPtr, int meshIndex,
             }
         }
 
-        QL_LOG_INFO("    Primitive {}: {} vertices, {} triangles, material {}",
+        QL_LOG_DEBUG("    Primitive {}: {} vertices, {} triangles, material {}",
                     primIdx, primitive.GetVertexCount(), primitive.GetTriangleCount(), primitive.materialId);
 
         mesh.primitives.push_back(std::move(primitive));
     }
 
-    QL_LOG_INFO("  Loaded mesh '{}' with {} primitive(s)", mesh.name, mesh.primitives.size());
+    QL_LOG_DEBUG("  Loaded mesh '{}' with {} primitive(s)", mesh.name, mesh.primitives.size());
 
     return mesh;
 }
@@ -427,7 +465,7 @@ static void TraverseNode(const tinygltf::Model& model, int nodeIndex,
         SceneNode sceneNode;
         sceneNode.meshIndex = static_cast<u32>(gltfNode.mesh);
         sceneNode.transform = worldTransform;
-        sceneNode.name = gltfNode.name.empty() ? ("Node_" + std::to_string(nodeIndex)) : gltfNode.name;
+        sceneNode.name = gltfNode.name.empty() ? fmt::format("Node_{}", nodeIndex) : gltfNode.name;
         outNodes.push_back(sceneNode);
     }
 
@@ -464,11 +502,79 @@ std::vector<SceneNode> GltfLoader::FlattenSceneGraph(const void* gltfModelPtr) {
     return nodes;
 }
 
+// ============================================================================
+// AssignTextureUsage
+// ============================================================================
+
+void GltfLoader::AssignTextureUsage(Scene& scene) {
+    auto tag = [&](i32 index, TextureUsage usage) {
+        if (index >= 0 && index < static_cast<i32>(scene.textures.size())) {
+            scene.textures[index].usage = usage;
+        }
+    };
+
+    for (const auto& mat : scene.materials) {
+        tag(mat.baseColorTextureIndex, TextureUsage::Color);
+        tag(mat.emissiveTextureIndex, TextureUsage::Color);
+        tag(mat.metallicRoughnessTextureIndex, TextureUsage::Data);
+        tag(mat.normalTextureIndex, TextureUsage::Normal);
+    }
+}
+
+// ============================================================================
+// ProcessTextures
+// ============================================================================
+
+void GltfLoader::ProcessTextures(Scene& scene, const GltfLoadOptions& options) {
+    if (!options.generateMips || scene.textures.empty()) {
+        return;
+    }
+
+    u32 cacheHits = 0;
+    if (!options.textureCachePath.empty()) {
+        cacheHits = TextureCache::Load(options.textureCachePath, scene.textures, options.mipFilter);
+    }
+
+    // Only textures that missed the cache are processed
+    MipGenerator::GenerateMips(scene.textures, options.mipFilter);
+    bool cacheDirty = cacheHits < scene.textures.size();
+
+    u32 compressedCount = 0;
+    for (auto& texture : scene.textures) {
+        TextureCompression format = options.compressTextures
+            ? BcCodec::SelectFormat(texture, options.preferBc7)
+            : TextureCompression::None;
+
+        if (format == TextureCompression::None) {
+            // Drop cached blocks so the texture uploads uncompressed
+            texture.compression = TextureCompression::None;
+            texture.blockLevels.clear();
+        } else if (!texture.IsCompressed() || texture.compression != format) {
+            BcCodec::Compress(texture, format);
+            ++compressedCount;
+            cacheDirty = true;
+        }
+    }
+
+    if (compressedCount > 0) {
+        QL_LOG_INFO("Block-compressed {} texture(s)", compressedCount);
+    }
+
+    if (!options.textureCachePath.empty() && cacheDirty) {
+        TextureCache::Save(options.textureCachePath, scene.textures, options.mipFilter);
+    }
+}
+
 // ============================================================================
 // LoadFromFile
 // ============================================================================
 
 Result<Scene, String> GltfLoader::LoadFromFile(const String& path) {
+    return LoadFromFile(path, GltfLoadOptions{});
+}
+
+Result<Scene, String> GltfLoader::LoadFromFile(const String& path, const GltfLoadOptions& options) {
+    QL_PROFILE_SCOPE("GltfLoader::LoadFromFile");
     QL_LOG_INFO("Loading glTF model from: {}", path);
 
     if (!std::filesystem::exists(path)) {
@@ -485,6 +591,7 @@ Result<Scene, String> GltfLoader::LoadFromFile(const String& path) {
     tinygltf::TinyGLTF loader;
     String error, warning;
 
+    QL_PROFILE_PHASE(phase, "GltfLoader: parse");
     bool success = isBinary
         ? loader.LoadBinaryFromFile(&model, &error, &warning, path)
         : loader.LoadASCIIFromFile(&model, &error, &warning, path);
@@ -505,12 +612,14 @@ Result<Scene, String> GltfLoader::LoadFromFile(const String& path) {
     scene.name = filePath.stem().string();
 
     // Load textures
+    QL_PROFILE_NEXT_PHASE(phase, "GltfLoader: textures");
     scene.textures.reserve(model.textures.size());
     for (size_t i = 0; i < model.textures.size(); ++i) {
         scene.textures.push_back(ParseTexture(&model, static_cast<int>(i)));
     }
 
     // Load materials
+    QL_PROFILE_NEXT_PHASE(phase, "GltfLoader: materials");
     scene.materials.reserve(model.materials.size());
     for (size_t i = 0; i < model.materials.size(); ++i) {
         scene.materials.push_back(ParseMaterial(&model, static_cast<int>(i), scene.textures));
@@ -521,13 +630,27 @@ Result<Scene, String> GltfLoader::LoadFromFile(const String& path) {
         scene.materials.push_back(Material::CreateLambertian(glm::vec3(0.8f), "DefaultMaterial"));
     }
 
-    // Load meshes
+    // Texture usage depends on material bindings; mips depend on usage
+    QL_PROFILE_NEXT_PHASE(phase, "GltfLoader: process textures");
+    AssignTextureUsage(scene);
+    ProcessTextures(scene, options);
+
+    // Load meshes into one arena sized for all of them (a single block unless
+    // the estimate is off), instead of one heap allocation per array
+    QL_PROFILE_NEXT_PHASE(phase, "GltfLoader: meshes");
+    scene.geometryArena = std::make_shared<Arena>(EstimateGeometryBytes(model));
     scene.meshes.reserve(model.meshes.size());
     for (size_t i = 0; i < model.meshes.size(); ++i) {
-        scene.meshes.push_back(ParseMesh(&model, static_cast<int>(i), scene.materials));
+        scene.meshes.push_back(ParseMesh(&model, static_cast<int>(i), scene.materials,
+                                         scene.GetGeometryResource()));
     }
+    QL_LOG_INFO("  Geometry: {:.2f} MB in {} arena block(s)",
+                static_cast<f64>(scene.geometryArena->BytesUsed()) / (1024.0 * 1024.0),
+                scene.geometryArena->BlockCount());
+    QL_PROFILE_COUNTER("Geometry bytes", scene.geometryArena->BytesUsed());
 
     // Flatten scene graph to nodes
+    QL_PROFILE_NEXT_PHASE(phase, "GltfLoader: scene graph");
     scene.nodes = FlattenSceneGraph(&model);
 
     QL_LOG_INFO("  Scene '{}' loaded: {} meshes, {} nodes, {} materials, {} textures",
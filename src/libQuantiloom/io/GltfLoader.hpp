@@ -5,6 +5,9 @@
 #include "scene/Mesh.hpp"
 #include "scene/Material.hpp"
 #include "scene/Texture.hpp"
+#include "scene/TextureMips.hpp"
+#include "scene/TextureCompression.hpp"
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -24,6 +27,10 @@
 // - Embedded textures (PNG/JPEG via base64 or binary glb)
 // - Scene graph transforms (flattened to world space)
 // - Normal maps, emissive maps
+// - Mip chain generation and BCn compression per texture
+//   (optionally cached in an HDF5 file)
+// - Geometry packed into one arena sized from the accessors up front
+//   (Scene::geometryArena)
 //
 // Not Supported (M2):
 // - Animations
@@ -37,11 +44,20 @@
 //   if (!result.has_value()) {
 //       QL_LOG_ERROR("Failed to load glTF: {}", result.error());
 //   }
-//   Scene scene = result.value();
+//   Scene scene = std::move(result.value());
 // ============================================================================
 
 namespace quantiloom {
 
+// Texture post-processing performed after parsing
+struct GltfLoadOptions {
+    bool generateMips = true;               // Build full mip chains for all textures
+    MipFilter mipFilter = MipFilter::Box;   // Downsampling filter
+    bool compressTextures = false;          // Encode BCn blocks for GPU upload
+    bool preferBc7 = true;                  // Opaque colour: BC7 (true) or BC1 (false)
+    String textureCachePath;                // HDF5 texture cache (empty = disabled)
+};
+
 class QL_API GltfLoader {
 public:
     // ========================================================================
@@ -51,6 +67,7 @@ public:
     // Load glTF file (.gltf or .glb)
     // Returns Scene with meshes, materials, textures, and nodes
     static Result<Scene, String> LoadFromFile(const String& path);
+    static Result<Scene, String> LoadFromFile(const String& path, const GltfLoadOptions& options);
 
 private:
     // ========================================================================
@@ -58,9 +75,11 @@ private:
     // ========================================================================
 
     // Parse glTF mesh to Quantiloom Mesh
-    // Each glTF primitive becomes a GeometryPrimitive
+    // Each glTF primitive becomes a GeometryPrimitive; geometry is allocated
+    // from `resource` (the scene's geometry arena)
     static Mesh ParseMesh(const void* gltfModel, int meshIndex,
-                          const std::vector<Material>& materials);
+                          const std::vector<Material>& materials,
+                          std::pmr::memory_resource* resource);
 
     // Parse glTF material to Quantiloom Material
     // Converts PBR metallic-roughness to our format
@@ -71,6 +90,12 @@ private:
     // Loads embedded image data (PNG/JPEG)
     static Texture ParseTexture(const void* gltfModel, int textureIndex);
 
+    // Tag textures as Color/Data/Normal from the material slots that use them
+    static void AssignTextureUsage(Scene& scene);
+
+    // Generate (or restore from cache) mip chains and BCn blocks for all textures
+    static void ProcessTextures(Scene& scene, const GltfLoadOptions& options);
+
     // Flatten glTF scene graph to world-space nodes
     // Computes accumulated transforms for each node
     static std::vector<SceneNode> FlattenSceneGraph(const void* gltfModel);
@@ -79,14 +104,14 @@ private:
     // Accessor Utilities
     // ========================================================================
 
-    // Read vertex attribute from glTF accessor
-    // Returns std::vector<T> where T is glm::vec2, glm::vec3, etc.
+    // Read vertex attribute from glTF accessor into `out` (T is glm::vec2,
+    // glm::vec3, etc.); `out` keeps its allocator, so no temporary is made
     template<typename T>
-    static std::vector<T> ReadAccessor(const void* gltfModel, int accessorIndex);
+    static void ReadAccessor(const void* gltfModel, int accessorIndex, std::pmr::vector<T>& out);
 
-    // Read index buffer from glTF accessor
+    // Read index buffer from glTF accessor into `out`
     // Handles u8, u16, u32 indices
-    static std::vector<u32> ReadIndices(const void* gltfModel, int accessorIndex);
+    static void ReadIndices(const void* gltfModel, int accessorIndex, std::pmr::vector<u32>& out);
 };
 
 } // namespace quantiloom
@@ -9,8 +9,16 @@
 #include <OpenEXR/ImfHeader.h>
 #include <OpenEXR/ImfStringAttribute.h>
 
+// stb_image_write ships with tinygltf (which is built with TINYGLTF_NO_STB_IMAGE_WRITE)
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "core/Color.hpp"
+#include "core/Profiler.hpp"
+
 #include <filesystem>
 #include <algorithm>
+#include <type_traits>
 
 namespace quantiloom {
 
@@ -18,10 +26,17 @@ namespace quantiloom {
 // Helper: Convert Image to EXR FrameBuffer
 // ============================================================================
 
+// EXR pixel type of an element type (f16 has the bit layout of Imf::HALF)
+template <typename T>
+static constexpr Imf::PixelType ExrPixelType() {
+    return std::is_same_v<T, f16> ? Imf::HALF : Imf::FLOAT;
+}
+
+template <typename T>
 static void SetupFrameBufferForWrite(
     Imf::FrameBuffer& fb,
-    const Image& img,
-    std::vector<std::vector<float>>& buffers)
+    const ImageT<T>& img,
+    std::vector<std::vector<T>>& buffers)
 {
     // EXR expects separate buffers for each channel
     // We need to de-interleave our channel-last format
@@ -42,10 +57,10 @@ static void SetupFrameBufferForWrite(
         fb.insert(
             channelName,
             Imf::Slice(
-                Imf::FLOAT,                                  // type
+                ExrPixelType<T>(),                           // type
                 (char*)buffers[c].data(),                    // base
-                sizeof(float),                               // xStride
-                sizeof(float) * img.width                    // yStride
+                sizeof(T),                                   // xStride
+                sizeof(T) * img.width                        // yStride
             )
         );
     }
@@ -98,10 +113,12 @@ static void ReadFrameBufferToImage(
 }
 
 // ============================================================================
-// Public API: WriteEXR
+// Helper: Write an image in its element type (FLOAT or HALF channels)
 // ============================================================================
 
-bool ImageIO::WriteEXR(const std::string& filepath, const Image& image) {
+template <typename T>
+static bool WriteExrImage(const std::string& filepath, const ImageT<T>& image) {
+    QL_PROFILE_SCOPE("ImageIO::WriteEXR");
     if (!image.IsValid()) {
         QL_LOG_ERROR("ImageIO::WriteEXR: Invalid image");
         return false;
@@ -115,7 +132,7 @@ bool ImageIO::WriteEXR(const std::string& filepath, const Image& image) {
         for (u32 c = 0; c < image.channels; ++c) {
             header.channels().insert(
                 image.channelNames[c].c_str(),
-                Imf::Channel(Imf::FLOAT)
+                Imf::Channel(ExrPixelType<T>())
             );
         }
 
@@ -129,14 +146,14 @@ bool ImageIO::WriteEXR(const std::string& filepath, const Image& image) {
 
         // Setup FrameBuffer
         Imf::FrameBuffer fb;
-        std::vector<std::vector<float>> buffers;
+        std::vector<std::vector<T>> buffers;
         SetupFrameBufferForWrite(fb, image, buffers);
 
         file.setFrameBuffer(fb);
         file.writePixels(image.height);
 
-        QL_LOG_INFO("ImageIO::WriteEXR: Wrote {}x{} image with {} channels to {}",
-                    image.width, image.height, image.channels, filepath);
+        QL_LOG_INFO("ImageIO::WriteEXR: Wrote {}x{} {} image with {} channels to {}",
+                    image.width, image.height, PixelFormatName(PixelFormatOf<T>), image.channels, filepath);
         return true;
 
     } catch (const std::exception& e) {
@@ -145,11 +162,70 @@ bool ImageIO::WriteEXR(const std::string& filepath, const Image& image) {
     }
 }
 
+// ============================================================================
+// Public API: WriteEXR
+// ============================================================================
+
+bool ImageIO::WriteEXR(const std::string& filepath, const Image& image) {
+    return WriteExrImage(filepath, image);
+}
+
+bool ImageIO::WriteEXR(const std::string& filepath, const ImageF16& image) {
+    return WriteExrImage(filepath, image);
+}
+
+bool ImageIO::WriteEXR(const std::string& filepath, const Image& image, PixelFormat format) {
+    if (format == PixelFormat::F16) {
+        return WriteExrImage(filepath, ConvertToStorage<f16>(image));
+    }
+    if (format == PixelFormat::U16) {
+        QL_LOG_WARN("ImageIO::WriteEXR: EXR has no 16-bit integer channels, writing {} as f32", filepath);
+    }
+    return WriteExrImage(filepath, image);
+}
+
+// ============================================================================
+// Public API: WritePNG
+// ============================================================================
+
+bool ImageIO::WritePNG(const std::string& filepath, const Image& image) {
+    QL_PROFILE_SCOPE("ImageIO::WritePNG");
+    if (!image.IsValid()) {
+        QL_LOG_ERROR("ImageIO::WritePNG: Invalid image");
+        return false;
+    }
+
+    // 1 -> grey, 2 -> grey + alpha, 3 -> RGB, 4+ -> RGBA (first four channels)
+    const u32 components = std::min(image.channels, 4u);
+    const bool hasAlpha = (components == 2 || components == 4);
+    std::vector<u8> pixels(static_cast<usize>(image.PixelCount()) * components);
+
+    for (usize p = 0; p < image.PixelCount(); ++p) {
+        const f32* src = &image.data[p * image.channels];
+        for (u32 c = 0; c < components; ++c) {
+            const bool isAlpha = hasAlpha && c == components - 1;
+            pixels[p * components + c] = QuantizeUnorm8(isAlpha ? src[c] : LinearToSrgb(std::max(src[c], 0.0f)));
+        }
+    }
+
+    const int stride = static_cast<int>(image.width * components);
+    if (!stbi_write_png(filepath.c_str(), static_cast<int>(image.width), static_cast<int>(image.height),
+                        static_cast<int>(components), pixels.data(), stride)) {
+        QL_LOG_ERROR("ImageIO::WritePNG: Failed to write {}", filepath);
+        return false;
+    }
+
+    QL_LOG_INFO("ImageIO::WritePNG: Wrote {}x{} image with {} channels to {}",
+                image.width, image.height, components, filepath);
+    return true;
+}
+
 // ============================================================================
 // Public API: ReadEXR
 // ============================================================================
 
 std::optional<Image> ImageIO::ReadEXR(const std::string& filepath) {
+    QL_PROFILE_SCOPE("ImageIO::ReadEXR");
     if (!FileExists(filepath)) {
         QL_LOG_ERROR("ImageIO::ReadEXR: File not found: {}", filepath);
         return std::nullopt;
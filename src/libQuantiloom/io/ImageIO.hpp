@@ -16,8 +16,10 @@ namespace quantiloom {
 // - Preserves channel names and metadata
 //
 // Notes:
-// - Always converts to/from f32 internally (OpenEXR uses HALF by default)
+// - Image (f32) is written as FLOAT channels, ImageF16 as HALF channels
+//   (half the file size); reading always returns f32
 // - Metadata is stored as string attributes in EXR header
+// - WritePNG is for 8-bit previews only (stb_image_write)
 // ============================================================================
 
 class QL_API ImageIO {
@@ -29,6 +31,19 @@ public:
     // Write image to EXR file
     // Returns true on success, false on failure
     static bool WriteEXR(const std::string& filepath, const Image& image);
+    static bool WriteEXR(const std::string& filepath, const ImageF16& image);
+
+    // Write with the given storage format (F16 -> HALF channels; EXR has no
+    // 16-bit integer channels, so U16 falls back to f32)
+    static bool WriteEXR(const std::string& filepath, const Image& image, PixelFormat format);
+
+    // ========================================================================
+    // PNG Writing (previews)
+    // ========================================================================
+
+    // Write linear channels as 8-bit sRGB-encoded PNG (alpha stays linear).
+    // Uses the first 1-4 channels; values are clamped to [0, 1].
+    static bool WritePNG(const std::string& filepath, const Image& image);
 
     // ========================================================================
     // EXR Reading
@@ -0,0 +1,120 @@
+#include "RgbToSpectrumLoader.hpp"
+
+#include <H5Cpp.h>
+#include <filesystem>
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: scalar / string attributes on the root group
+// ============================================================================
+
+static void WriteStringAttribute(H5::H5File& file, const std::string& name, const std::string& value) {
+    H5::StrType strType(H5::PredType::C_S1, value.size() + 1);
+    H5::DataSpace scalar(H5S_SCALAR);
+    file.createAttribute(name, strType, scalar).write(strType, value.c_str());
+}
+
+static void WriteFloatAttribute(H5::H5File& file, const std::string& name, f32 value) {
+    H5::DataSpace scalar(H5S_SCALAR);
+    file.createAttribute(name, H5::PredType::NATIVE_FLOAT, scalar).write(H5::PredType::NATIVE_FLOAT, &value);
+}
+
+// ============================================================================
+// Public API: LoadHDF5
+// ============================================================================
+
+std::optional<RgbToSpectrumTable> RgbToSpectrumLoader::LoadHDF5(const std::string& filepath) {
+    if (!std::filesystem::exists(filepath)) {
+        QL_LOG_ERROR("RgbToSpectrumLoader::LoadHDF5: File not found: {}", filepath);
+        return std::nullopt;
+    }
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_RDONLY);
+
+        RgbToSpectrumTable table;
+        file.openAttribute("resolution").read(H5::PredType::NATIVE_UINT32, &table.resolution);
+
+        // Coefficients are only meaningful for the wavelength normalisation they were fitted with
+        f32 lambdaMin = 0.0f;
+        f32 lambdaMax = 0.0f;
+        file.openAttribute("lambda_min").read(H5::PredType::NATIVE_FLOAT, &lambdaMin);
+        file.openAttribute("lambda_max").read(H5::PredType::NATIVE_FLOAT, &lambdaMax);
+        if (lambdaMin != RgbToSpectrumTable::LAMBDA_MIN || lambdaMax != RgbToSpectrumTable::LAMBDA_MAX) {
+            QL_LOG_ERROR("RgbToSpectrumLoader::LoadHDF5: {} was built for {}-{} nm, expected {}-{} nm",
+                         filepath, lambdaMin, lambdaMax,
+                         RgbToSpectrumTable::LAMBDA_MIN, RgbToSpectrumTable::LAMBDA_MAX);
+            return std::nullopt;
+        }
+
+        const usize res = table.resolution;
+        table.scale.resize(res);
+        table.coefficients.resize(9 * res * res * res);
+
+        H5::DataSet scaleDataset = file.openDataSet("/scale");
+        H5::DataSet coeffDataset = file.openDataSet("/coefficients");
+        if (static_cast<usize>(scaleDataset.getSpace().getSimpleExtentNpoints()) != table.scale.size() ||
+            static_cast<usize>(coeffDataset.getSpace().getSimpleExtentNpoints()) != table.coefficients.size()) {
+            QL_LOG_ERROR("RgbToSpectrumLoader::LoadHDF5: Dataset sizes do not match resolution {}", res);
+            return std::nullopt;
+        }
+        scaleDataset.read(table.scale.data(), H5::PredType::NATIVE_FLOAT);
+        coeffDataset.read(table.coefficients.data(), H5::PredType::NATIVE_FLOAT);
+
+        if (!table.IsValid()) {
+            QL_LOG_ERROR("RgbToSpectrumLoader::LoadHDF5: Loaded table failed validation");
+            return std::nullopt;
+        }
+
+        QL_LOG_INFO("RgbToSpectrumLoader::LoadHDF5: Loaded {}^3 RGB-to-spectrum table from {}", res, filepath);
+        return table;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("RgbToSpectrumLoader::LoadHDF5: Failed to load {}: {}", filepath, e.getDetailMsg());
+        return std::nullopt;
+    }
+}
+
+// ============================================================================
+// Public API: SaveHDF5
+// ============================================================================
+
+bool RgbToSpectrumLoader::SaveHDF5(const std::string& filepath, const RgbToSpectrumTable& table) {
+    if (!table.IsValid()) {
+        QL_LOG_ERROR("RgbToSpectrumLoader::SaveHDF5: Invalid table");
+        return false;
+    }
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_TRUNC);
+
+        const hsize_t res = table.resolution;
+        hsize_t scaleDims[1] = {res};
+        H5::DataSet scaleDataset = file.createDataSet(
+            "/scale", H5::PredType::NATIVE_FLOAT, H5::DataSpace(1, scaleDims));
+        scaleDataset.write(table.scale.data(), H5::PredType::NATIVE_FLOAT);
+
+        hsize_t coeffDims[5] = {3, res, res, res, 3};
+        H5::DataSet coeffDataset = file.createDataSet(
+            "/coefficients", H5::PredType::NATIVE_FLOAT, H5::DataSpace(5, coeffDims));
+        coeffDataset.write(table.coefficients.data(), H5::PredType::NATIVE_FLOAT);
+
+        H5::DataSpace scalar(H5S_SCALAR);
+        file.createAttribute("resolution", H5::PredType::NATIVE_UINT32, scalar)
+            .write(H5::PredType::NATIVE_UINT32, &table.resolution);
+        WriteFloatAttribute(file, "lambda_min", RgbToSpectrumTable::LAMBDA_MIN);
+        WriteFloatAttribute(file, "lambda_max", RgbToSpectrumTable::LAMBDA_MAX);
+        WriteStringAttribute(file, "color_space", "sRGB");
+        WriteStringAttribute(file, "illuminant", "D65");
+
+        QL_LOG_INFO("RgbToSpectrumLoader::SaveHDF5: Saved {}^3 table to {}", table.resolution, filepath);
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("RgbToSpectrumLoader::SaveHDF5: Failed to save {}: {}", filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
+} // namespace quantiloom
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/RgbToSpectrum.hpp"
+#include "core/Log.hpp"
+#include <string>
+#include <optional>
+
+namespace quantiloom {
+
+// ============================================================================
+// RgbToSpectrumLoader - RGB-to-spectrum coefficient table I/O (HDF5)
+// ============================================================================
+// HDF5 structure:
+//   /scale               - 1D dataset [res], float32, brightness axis
+//   /coefficients        - 5D dataset [3][res][res][res][3], float32,
+//                          sigmoid-polynomial coefficients (see RgbToSpectrum.hpp)
+//   attributes (root)    - resolution (u32), color_space ("sRGB"),
+//                          illuminant ("D65"), lambda_min / lambda_max (nm,
+//                          normalisation range of the polynomial)
+//
+// Build the file once with the QuantiloomRgbToSpectrum tool.
+// ============================================================================
+
+class QL_API RgbToSpectrumLoader {
+public:
+    // Load table from HDF5 file (validates shape and wavelength range)
+    static std::optional<RgbToSpectrumTable> LoadHDF5(const std::string& filepath);
+
+    // Save table to HDF5 file (overwrites)
+    static bool SaveHDF5(const std::string& filepath, const RgbToSpectrumTable& table);
+};
+
+} // namespace quantiloom
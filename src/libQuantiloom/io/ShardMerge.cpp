@@ -0,0 +1,252 @@
+#include "ShardMerge.hpp"
+#include "SpectralIO.hpp"
+#include "ImageIO.hpp"
+#include "core/Image.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+#include "core/Profiler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <set>
+
+namespace quantiloom {
+
+// ============================================================================
+// ShardMerger
+// ============================================================================
+
+bool ShardMerger::Add(const std::string& path) {
+    SpectralCubeReader reader;
+    if (!reader.Open(path)) {
+        return false;
+    }
+    const SpectralCube& cube = reader.GetHeader();
+    const std::optional<ShardHeader> header = ReadShardHeader(cube.metadata);
+    if (!header) {
+        QL_LOG_ERROR("ShardMerger::Add: {} has no valid shard.* metadata", path);
+        return false;
+    }
+    const Shard& shard = header->shard;
+    if (cube.width != shard.width || cube.height != shard.height || cube.nbands != shard.bandCount ||
+        cube.wavelengths.size() != shard.bandCount) {
+        QL_LOG_ERROR("ShardMerger::Add: {} is {}x{}x{}, shard {} is {}x{}x{}", path,
+                     cube.width, cube.height, cube.nbands, shard.index, shard.width, shard.height, shard.bandCount);
+        return false;
+    }
+
+    if (m_partials.empty()) {
+        m_plan = *header;
+        m_wavelengths.assign(m_plan.bandCount, 0.0f);
+        m_hasWavelength.assign(m_plan.bandCount, 0);
+        for (const auto& [key, value] : cube.metadata) {
+            if (!IsShardMetadataKey(key)) {
+                m_metadata[key] = value;
+            }
+        }
+    } else if (header->planId != m_plan.planId || header->shardCount != m_plan.shardCount ||
+               header->imageWidth != m_plan.imageWidth || header->imageHeight != m_plan.imageHeight ||
+               header->bandCount != m_plan.bandCount || header->spp != m_plan.spp) {
+        QL_LOG_ERROR("ShardMerger::Add: {} belongs to another plan ({}, expected {})",
+                     path, header->planId, m_plan.planId);
+        return false;
+    }
+
+    for (const Partial& partial : m_partials) {
+        if (partial.header.shard.index == shard.index) {
+            QL_LOG_WARN("ShardMerger::Add: Shard {} already added from {}; ignoring {}",
+                        shard.index, partial.path, path);
+            return false;
+        }
+    }
+
+    for (u32 b = 0; b < shard.bandCount; ++b) {
+        m_wavelengths[shard.bandStart + b] = cube.wavelengths[b];
+        m_hasWavelength[shard.bandStart + b] = 1;
+    }
+    m_partials.push_back({path, *header});
+    return true;
+}
+
+std::vector<u32> ShardMerger::GetMissingShards() const {
+    std::set<u32> present;
+    for (const Partial& partial : m_partials) {
+        present.insert(partial.header.shard.index);
+    }
+    std::vector<u32> missing;
+    for (u32 index = 0; index < m_plan.shardCount; ++index) {
+        if (present.count(index) == 0) {
+            missing.push_back(index);
+        }
+    }
+    return missing;
+}
+
+bool ShardMerger::Merge(const std::string& outputPath, PixelFormat format, bool allowMissing) const {
+    QL_PROFILE_SCOPE("ShardMerger::Merge");
+
+    if (m_partials.empty()) {
+        QL_LOG_ERROR("ShardMerger::Merge: No partial outputs");
+        return false;
+    }
+    const std::vector<u32> missing = GetMissingShards();
+    if (!missing.empty()) {
+        if (!allowMissing) {
+            QL_LOG_ERROR("ShardMerger::Merge: {} of {} shards missing", missing.size(), m_plan.shardCount);
+            return false;
+        }
+        QL_LOG_WARN("ShardMerger::Merge: {} of {} shards missing; their pixels are written as 0",
+                    missing.size(), m_plan.shardCount);
+    }
+    if (std::count(m_hasWavelength.begin(), m_hasWavelength.end(), 0) > 0) {
+        QL_LOG_ERROR("ShardMerger::Merge: No partial covers some bands (wavelengths unknown)");
+        return false;
+    }
+
+    std::string extension = std::filesystem::path(outputPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const bool exr = (extension == ".exr");
+    if (!exr && extension != ".h5" && extension != ".hdf5") {
+        QL_LOG_ERROR("ShardMerger::Merge: Unknown output type '{}' (expected .h5, .hdf5 or .exr)", extension);
+        return false;
+    }
+    if (exr && m_plan.bandCount != 1) {
+        QL_LOG_ERROR("ShardMerger::Merge: EXR output needs a single-band plan ({} bands); use .h5",
+                     m_plan.bandCount);
+        return false;
+    }
+
+    const u32 width = m_plan.imageWidth;
+    const u32 height = m_plan.imageHeight;
+    const usize pixelsPerBand = static_cast<usize>(width) * height;
+
+    std::unordered_map<std::string, std::string> metadata = m_metadata;
+    metadata["resolution"] = std::to_string(width) + "x" + std::to_string(height);
+    metadata["spp"] = std::to_string(m_plan.spp);
+    metadata["shards"] = std::to_string(m_plan.shardCount);
+
+    SpectralCubeWriter writer;
+    if (!exr) {
+        SpectralCube header;
+        header.width = width;
+        header.height = height;
+        header.nbands = m_plan.bandCount;
+        header.lambda_min = m_wavelengths.front();
+        header.lambda_max = m_wavelengths.back();
+        header.delta_lambda = (m_plan.bandCount > 1)
+            ? (header.lambda_max - header.lambda_min) / static_cast<f32>(m_plan.bandCount - 1)
+            : 0.0f;
+        header.wavelengths = m_wavelengths;
+        header.metadata = metadata;
+        if (!writer.Open(outputPath, header, format)) {
+            return false;
+        }
+    }
+
+    // Partials grouped by their first band (one group per band range)
+    std::vector<const Partial*> sorted;
+    for (const Partial& partial : m_partials) {
+        sorted.push_back(&partial);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Partial* a, const Partial* b) {
+        return a->header.shard.bandStart < b->header.shard.bandStart;
+    });
+
+    std::vector<f32> sum;
+    std::vector<u32> weight;
+    std::vector<f32> tile;
+    usize next = 0;
+    u32 band = 0;
+    while (band < m_plan.bandCount) {
+        // Band range of the next group (a single empty band if none starts here)
+        u32 span = 1;
+        const usize groupBegin = next;
+        while (next < sorted.size() && sorted[next]->header.shard.bandStart == band) {
+            span = sorted[next]->header.shard.bandCount;
+            ++next;
+        }
+
+        sum.assign(span * pixelsPerBand, 0.0f);
+        weight.assign(pixelsPerBand, 0);
+        for (usize i = groupBegin; i < next; ++i) {
+            const Partial& partial = *sorted[i];
+            const Shard& shard = partial.header.shard;
+            if (shard.bandCount != span) {
+                QL_LOG_ERROR("ShardMerger::Merge: {} spans {} bands, its group {}", partial.path, shard.bandCount, span);
+                return false;
+            }
+
+            SpectralCubeReader reader;
+            const usize tilePixels = static_cast<usize>(shard.width) * shard.height;
+            tile.resize(span * tilePixels);
+            if (!reader.Open(partial.path) || !reader.ReadBands(0, span, tile.data())) {
+                QL_LOG_ERROR("ShardMerger::Merge: Cannot read {}", partial.path);
+                return false;
+            }
+
+            // Mean over the shard's samples -> sample-weighted sum
+            const f32 samples = static_cast<f32>(shard.sampleCount);
+            ParallelFor(static_cast<usize>(span) * shard.height, 16, [&](usize row) {
+                const usize b = row / shard.height;
+                const usize y = row % shard.height;
+                const f32* src = tile.data() + b * tilePixels + y * shard.width;
+                f32* dst = sum.data() + b * pixelsPerBand + (shard.y + y) * width + shard.x;
+                for (u32 x = 0; x < shard.width; ++x) {
+                    dst[x] += src[x] * samples;
+                }
+            });
+            for (u32 y = 0; y < shard.height; ++y) {
+                u32* dst = weight.data() + static_cast<usize>(shard.y + y) * width + shard.x;
+                for (u32 x = 0; x < shard.width; ++x) {
+                    dst[x] += shard.sampleCount;
+                }
+            }
+        }
+
+        usize uncovered = 0;
+        for (usize i = 0; i < pixelsPerBand; ++i) {
+            if (weight[i] == 0) {
+                ++uncovered;
+                continue;
+            }
+            const f32 scale = 1.0f / static_cast<f32>(weight[i]);
+            for (u32 b = 0; b < span; ++b) {
+                sum[b * pixelsPerBand + i] *= scale;
+            }
+        }
+        if (uncovered > 0 && !allowMissing) {
+            QL_LOG_ERROR("ShardMerger::Merge: {} pixels of bands {}-{} have no samples", uncovered, band, band + span - 1);
+            return false;
+        }
+
+        if (exr) {
+            Image img(width, height, 4);
+            img.channelNames = {"R", "G", "B", "A"};
+            img.metadata = metadata;
+            img.metadata["wavelength_nm"] = std::to_string(m_wavelengths[band]);
+            for (usize i = 0; i < pixelsPerBand; ++i) {
+                img.data[i * 4 + 0] = sum[i];
+                img.data[i * 4 + 1] = sum[i];
+                img.data[i * 4 + 2] = sum[i];
+                img.data[i * 4 + 3] = 1.0f;
+            }
+            if (!ImageIO::WriteEXR(outputPath, img, format)) {
+                return false;
+            }
+        } else if (!writer.WriteBands(band, span, sum.data())) {
+            return false;
+        }
+        band += span;
+    }
+
+    if (!exr && !writer.Close()) {
+        return false;
+    }
+    QL_LOG_INFO("ShardMerger: Merged {} partial(s) into {} ({}x{}, {} band(s), {} spp)", m_partials.size(),
+                outputPath, width, height, m_plan.bandCount, m_plan.spp);
+    return true;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "core/PixelFormat.hpp"
+#include "core/ShardPlan.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// ShardMerger - Combine partial outputs of a sharded render
+// ============================================================================
+// A partial is an HDF5 cube of one shard's tile and bands (the mean over the
+// shard's samples) whose metadata carries the shard (core/ShardPlan.hpp).
+// Merging averages every pixel over the partials covering it, weighted by
+// their sample counts, so shards that split the samples of a tile combine
+// into the mean over all samples. One band group is merged at a time, so
+// memory stays at bands_per_shard full-size bands.
+//
+// Output by extension: .h5 / .hdf5 -> SpectralCube (all bands), .exr ->
+// Image (single-band plans; grey RGB like the renderer's EXR output).
+//
+// Usage:
+//   ShardMerger merger;
+//   for (const auto& path : partialPaths) merger.Add(path);
+//   if (merger.GetMissingShards().empty()) merger.Merge("cube.h5");
+// ============================================================================
+
+namespace quantiloom {
+
+class QL_API ShardMerger {
+public:
+    // Register a partial output; false (logged) if it is not a partial, does
+    // not belong to the plan of the partials added before or duplicates one
+    bool Add(const std::string& path);
+
+    usize GetPartialCount() const { return m_partials.size(); }
+    const ShardHeader& GetPlan() const { return m_plan; }
+
+    // Shard indices of the plan that have no partial
+    std::vector<u32> GetMissingShards() const;
+
+    // Merge into outputPath (f32 or f16); with allowMissing, pixels no
+    // partial covers are written as 0 instead of failing
+    bool Merge(const std::string& outputPath, PixelFormat format = PixelFormat::F32, bool allowMissing = false) const;
+
+private:
+    struct Partial {
+        std::string path;
+        ShardHeader header;
+    };
+
+    std::vector<Partial> m_partials;
+    ShardHeader m_plan;                   // From the first partial
+    std::vector<f32> m_wavelengths;       // Plan's bands, from the partials
+    std::vector<u8> m_hasWavelength;
+    std::unordered_map<std::string, std::string> m_metadata;   // Renderer metadata (no shard.*)
+};
+
+} // namespace quantiloom
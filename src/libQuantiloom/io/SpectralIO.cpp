@@ -1,7 +1,11 @@
 #include "SpectralIO.hpp"
+#include "core/Parallel.hpp"
+#include "core/Profiler.hpp"
 
 #include <H5Cpp.h>
+#include <algorithm>
 #include <filesystem>
+#include <type_traits>
 
 namespace quantiloom {
 
@@ -9,7 +13,8 @@ namespace quantiloom {
 // Helper: Write metadata as HDF5 attributes
 // ============================================================================
 
-static void WriteMetadata(H5::H5File& file, const SpectralCube& cube) {
+template <typename T>
+static void WriteMetadata(H5::H5File& file, const SpectralCubeT<T>& cube) {
     // Create metadata group
     H5::Group metaGroup = file.createGroup("/metadata");
 
@@ -86,10 +91,298 @@ static void ReadMetadata(H5::H5File& file, SpectralCube& cube) {
 }
 
 // ============================================================================
-// Public API: WriteHDF5
+// Helper: Write / read per-band statistics (/stats group)
 // ============================================================================
 
-bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCube& cube) {
+template<typename T>
+static void WriteStatsDataset(H5::Group& group, const char* name, const H5::PredType& type,
+                              const std::vector<T>& values, hsize_t rows, hsize_t columns = 0) {
+    hsize_t dims[2] = {rows, columns};
+    H5::DataSpace dataspace(columns > 0 ? 2 : 1, dims);
+    group.createDataSet(name, type, dataspace).write(values.data(), type);
+}
+
+static void WriteStatistics(H5::H5File& file, const CubeStatistics& stats) {
+    H5::Group group = file.createGroup("/stats");
+    const hsize_t nbands = stats.BandCount();
+    WriteStatsDataset(group, "count", H5::PredType::NATIVE_UINT64, stats.count, nbands);
+    WriteStatsDataset(group, "non_finite", H5::PredType::NATIVE_UINT64, stats.nonFinite, nbands);
+    WriteStatsDataset(group, "min", H5::PredType::NATIVE_FLOAT, stats.min, nbands);
+    WriteStatsDataset(group, "max", H5::PredType::NATIVE_FLOAT, stats.max, nbands);
+    WriteStatsDataset(group, "mean", H5::PredType::NATIVE_FLOAT, stats.mean, nbands);
+    WriteStatsDataset(group, "stddev", H5::PredType::NATIVE_FLOAT, stats.stddev, nbands);
+    WriteStatsDataset(group, "percentile_levels", H5::PredType::NATIVE_FLOAT, stats.percentileLevels,
+                      stats.percentileLevels.size());
+    WriteStatsDataset(group, "percentiles", H5::PredType::NATIVE_FLOAT, stats.percentiles,
+                      nbands, stats.percentileLevels.size());
+}
+
+template<typename T>
+static void ReadStatsDataset(H5::Group& group, const char* name, const H5::PredType& type, std::vector<T>& values) {
+    H5::DataSet dataset = group.openDataSet(name);
+    values.resize(static_cast<usize>(dataset.getSpace().getSimpleExtentNpoints()));
+    dataset.read(values.data(), type);
+}
+
+static std::optional<CubeStatistics> ReadStatistics(H5::H5File& file) {
+    if (!file.nameExists("/stats")) {
+        return std::nullopt;
+    }
+
+    H5::Group group = file.openGroup("/stats");
+    CubeStatistics stats;
+    ReadStatsDataset(group, "count", H5::PredType::NATIVE_UINT64, stats.count);
+    ReadStatsDataset(group, "non_finite", H5::PredType::NATIVE_UINT64, stats.nonFinite);
+    ReadStatsDataset(group, "min", H5::PredType::NATIVE_FLOAT, stats.min);
+    ReadStatsDataset(group, "max", H5::PredType::NATIVE_FLOAT, stats.max);
+    ReadStatsDataset(group, "mean", H5::PredType::NATIVE_FLOAT, stats.mean);
+    ReadStatsDataset(group, "stddev", H5::PredType::NATIVE_FLOAT, stats.stddev);
+    ReadStatsDataset(group, "percentile_levels", H5::PredType::NATIVE_FLOAT, stats.percentileLevels);
+    ReadStatsDataset(group, "percentiles", H5::PredType::NATIVE_FLOAT, stats.percentiles);
+    return stats;
+}
+
+// ============================================================================
+// Helper: PCA-compressed archives (/pca group)
+// ============================================================================
+
+static void WriteU32Attribute(H5::Group& group, const char* name, u32 value) {
+    H5::DataSpace scalar(H5S_SCALAR);
+    group.createAttribute(name, H5::PredType::NATIVE_UINT32, scalar).write(H5::PredType::NATIVE_UINT32, &value);
+}
+
+static u32 ReadU32Attribute(H5::Group& group, const char* name) {
+    u32 value = 0;
+    group.openAttribute(name).read(H5::PredType::NATIVE_UINT32, &value);
+    return value;
+}
+
+static void WritePca(H5::H5File& file, const SpectralPcaEncoding& encoding) {
+    H5::Group group = file.createGroup("/pca");
+    WriteU32Attribute(group, "width", encoding.width);
+    WriteU32Attribute(group, "height", encoding.height);
+    WriteU32Attribute(group, "nbands", encoding.nbands);
+    WriteU32Attribute(group, "components", encoding.components);
+    WriteU32Attribute(group, "tile_size", encoding.tileSize);
+    H5::DataSpace scalar(H5S_SCALAR);
+    group.createAttribute("relative_rmse", H5::PredType::NATIVE_DOUBLE, scalar)
+        .write(H5::PredType::NATIVE_DOUBLE, &encoding.relativeRmse);
+
+    hsize_t meanDims[1] = {encoding.nbands};
+    group.createDataSet("mean", H5::PredType::NATIVE_FLOAT, H5::DataSpace(1, meanDims))
+        .write(encoding.mean.data(), H5::PredType::NATIVE_FLOAT);
+
+    hsize_t basisDims[2] = {encoding.components, encoding.nbands};
+    group.createDataSet("basis", H5::PredType::NATIVE_FLOAT, H5::DataSpace(2, basisDims))
+        .write(encoding.basis.data(), H5::PredType::NATIVE_FLOAT);
+
+    hsize_t coefficientDims[3] = {encoding.components, encoding.height, encoding.width};
+    hsize_t chunkDims[3] = {encoding.components, std::min<hsize_t>(encoding.tileSize, encoding.height),
+                            std::min<hsize_t>(encoding.tileSize, encoding.width)};
+    H5::DSetCreatPropList chunking;
+    chunking.setChunk(3, chunkDims);
+    group.createDataSet("coefficients", H5::PredType::NATIVE_UINT16, H5::DataSpace(3, coefficientDims), chunking)
+        .write(encoding.coefficients.data(), H5::PredType::NATIVE_UINT16);
+
+    hsize_t tileDims[3] = {encoding.components, encoding.TilesY(), encoding.TilesX()};
+    group.createDataSet("scale", H5::PredType::NATIVE_FLOAT, H5::DataSpace(3, tileDims))
+        .write(encoding.scale.data(), H5::PredType::NATIVE_FLOAT);
+    group.createDataSet("offset", H5::PredType::NATIVE_FLOAT, H5::DataSpace(3, tileDims))
+        .write(encoding.offset.data(), H5::PredType::NATIVE_FLOAT);
+}
+
+// Read the /pca encoding restricted to a region (coefficients of that region only)
+static std::optional<SpectralPcaEncoding> ReadPca(H5::H5File& file, u32 x, u32 y, u32 width, u32 height) {
+    H5::Group group = file.openGroup("/pca");
+    SpectralPcaEncoding encoding;
+    encoding.width = ReadU32Attribute(group, "width");
+    encoding.height = ReadU32Attribute(group, "height");
+    encoding.nbands = ReadU32Attribute(group, "nbands");
+    encoding.components = ReadU32Attribute(group, "components");
+    encoding.tileSize = ReadU32Attribute(group, "tile_size");
+    group.openAttribute("relative_rmse").read(H5::PredType::NATIVE_DOUBLE, &encoding.relativeRmse);
+
+    encoding.regionX = x;
+    encoding.regionY = y;
+    encoding.regionWidth = width > 0 ? width : encoding.width;
+    encoding.regionHeight = height > 0 ? height : encoding.height;
+    if (encoding.regionX + encoding.regionWidth > encoding.width ||
+        encoding.regionY + encoding.regionHeight > encoding.height) {
+        QL_LOG_ERROR("SpectralIO: Region {}x{} at ({}, {}) outside the {}x{} cube",
+                     encoding.regionWidth, encoding.regionHeight, x, y, encoding.width, encoding.height);
+        return std::nullopt;
+    }
+
+    const usize tiles = static_cast<usize>(encoding.TilesX()) * encoding.TilesY();
+    encoding.mean.resize(encoding.nbands);
+    encoding.basis.resize(static_cast<usize>(encoding.components) * encoding.nbands);
+    encoding.scale.resize(encoding.components * tiles);
+    encoding.offset.resize(encoding.components * tiles);
+    encoding.coefficients.resize(static_cast<usize>(encoding.components) * encoding.regionWidth * encoding.regionHeight);
+    group.openDataSet("mean").read(encoding.mean.data(), H5::PredType::NATIVE_FLOAT);
+    group.openDataSet("basis").read(encoding.basis.data(), H5::PredType::NATIVE_FLOAT);
+    group.openDataSet("scale").read(encoding.scale.data(), H5::PredType::NATIVE_FLOAT);
+    group.openDataSet("offset").read(encoding.offset.data(), H5::PredType::NATIVE_FLOAT);
+
+    H5::DataSet coefficients = group.openDataSet("coefficients");
+    hsize_t start[3] = {0, encoding.regionY, encoding.regionX};
+    hsize_t extent[3] = {encoding.components, encoding.regionHeight, encoding.regionWidth};
+    H5::DataSpace fileSpace = coefficients.getSpace();
+    fileSpace.selectHyperslab(H5S_SELECT_SET, extent, start);
+    H5::DataSpace memSpace(3, extent);
+    coefficients.read(encoding.coefficients.data(), H5::PredType::NATIVE_UINT16, memSpace, fileSpace);
+
+    if (!encoding.IsValid()) {
+        QL_LOG_ERROR("SpectralIO: Inconsistent /pca group");
+        return std::nullopt;
+    }
+    return encoding;
+}
+
+// Wavelengths and metadata shared by every read path
+static bool ReadHeader(H5::H5File& file, SpectralCube& cube) {
+    ReadMetadata(file, cube);
+
+    H5::DataSet waveDataset = file.openDataSet("/wavelengths");
+    hsize_t waveDims[1];
+    waveDataset.getSpace().getSimpleExtentDims(waveDims);
+    if (waveDims[0] != cube.nbands) {
+        QL_LOG_ERROR("SpectralIO: Wavelength array size mismatch");
+        return false;
+    }
+    cube.wavelengths.resize(cube.nbands);
+    waveDataset.read(cube.wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+    return true;
+}
+
+// Decode a region of a compressed archive (width = height = 0: whole cube)
+static std::optional<SpectralCube> ReadCompressed(H5::H5File& file, u32 x, u32 y, u32 width, u32 height) {
+    std::optional<SpectralPcaEncoding> encoding = ReadPca(file, x, y, width, height);
+    if (!encoding.has_value()) {
+        return std::nullopt;
+    }
+
+    SpectralCube cube = SpectralPca::Decode(encoding.value());
+    if (!ReadHeader(file, cube)) {
+        return std::nullopt;
+    }
+    return cube;
+}
+
+// ============================================================================
+// Helper: Storage types of /data (f32, f16, u16 with scale/offset)
+// ============================================================================
+
+// IEEE-754 binary16; HDF5 has no predefined half type, but converts this one
+// to float on read and h5py/NumPy see it as float16
+static H5::FloatType HalfFloatType() {
+    H5::FloatType type(H5::PredType::NATIVE_FLOAT);
+    type.setFields(15, 10, 5, 0, 10);
+    type.setOffset(0);
+    type.setPrecision(16);
+    type.setSize(2);
+    type.setEbias(15);
+    return type;
+}
+
+template <typename T>
+static H5::DataType StorageDataType() {
+    if constexpr (std::is_same_v<T, f16>) {
+        return HalfFloatType();
+    } else if constexpr (std::is_same_v<T, u16>) {
+        return H5::PredType::NATIVE_UINT16;
+    } else {
+        return H5::PredType::NATIVE_FLOAT;
+    }
+}
+
+// u16 data carries scale_factor / add_offset (CF convention) on /data
+static void WriteScaling(H5::DataSet& dataset, f32 scale, f32 offset) {
+    H5::DataSpace scalar(H5S_SCALAR);
+    dataset.createAttribute("scale_factor", H5::PredType::NATIVE_FLOAT, scalar)
+        .write(H5::PredType::NATIVE_FLOAT, &scale);
+    dataset.createAttribute("add_offset", H5::PredType::NATIVE_FLOAT, scalar)
+        .write(H5::PredType::NATIVE_FLOAT, &offset);
+}
+
+// False if the data is stored unscaled
+static bool ReadScaling(H5::DataSet& dataset, f32& scale, f32& offset) {
+    scale = 1.0f;
+    offset = 0.0f;
+    if (!dataset.attrExists("scale_factor")) {
+        return false;
+    }
+    dataset.openAttribute("scale_factor").read(H5::PredType::NATIVE_FLOAT, &scale);
+    if (dataset.attrExists("add_offset")) {
+        dataset.openAttribute("add_offset").read(H5::PredType::NATIVE_FLOAT, &offset);
+    }
+    return true;
+}
+
+// Values read as float from scaled data become value * scale + offset
+static void ApplyScaling(H5::DataSet& dataset, f32* values, usize count) {
+    f32 scale, offset;
+    if (!ReadScaling(dataset, scale, offset)) {
+        return;
+    }
+    ParallelFor((count + 65535) / 65536, 1, [&](usize chunk) {
+        const usize end = std::min(count, (chunk + 1) * 65536);
+        for (usize i = chunk * 65536; i < end; ++i) {
+            values[i] = values[i] * scale + offset;
+        }
+    });
+}
+
+// Band b of a cube as f32 (converted into scratch unless already f32)
+template <typename T>
+static const f32* BandValues(const SpectralCubeT<T>& cube, u32 b, std::vector<f32>& scratch, bool parallel) {
+    if constexpr (std::is_same_v<T, f32>) {
+        return cube.BandPtr(b);
+    } else {
+        scratch.resize(cube.PixelsPerBand());
+        if constexpr (std::is_same_v<T, u16>) {
+            ConvertSamples(cube.BandPtr(b), scratch.data(), scratch.size(), cube.scale, cube.offset, parallel);
+        } else {
+            ConvertSamples(cube.BandPtr(b), scratch.data(), scratch.size(), parallel);
+        }
+        return scratch.data();
+    }
+}
+
+// ============================================================================
+// CubeStatistics
+// ============================================================================
+
+const std::vector<f32>& CubeStatistics::DefaultLevels() {
+    static const std::vector<f32> levels = {0.1f, 1.0f, 5.0f, 25.0f, 50.0f, 75.0f, 95.0f, 99.0f, 99.9f};
+    return levels;
+}
+
+CubeStatistics CubeStatistics::FromBands(const std::vector<BandStatistics>& bands, const std::vector<f32>& levels) {
+    CubeStatistics stats;
+    stats.percentileLevels = levels;
+    stats.percentiles.reserve(bands.size() * levels.size());
+    for (const BandStatistics& band : bands) {
+        stats.count.push_back(band.count);
+        stats.nonFinite.push_back(band.nonFiniteCount);
+        stats.min.push_back(static_cast<f32>(band.min));
+        stats.max.push_back(static_cast<f32>(band.max));
+        stats.mean.push_back(static_cast<f32>(band.mean));
+        stats.stddev.push_back(static_cast<f32>(band.StdDev()));
+        for (f32 level : levels) {
+            stats.percentiles.push_back(static_cast<f32>(band.Percentile(level)));
+        }
+    }
+    return stats;
+}
+
+// ============================================================================
+// Helper: Write a cube in its element type
+// ============================================================================
+
+template <typename T>
+static bool WriteCube(const std::string& filepath, const SpectralCubeT<T>& cube) {
+    QL_PROFILE_SCOPE("SpectralIO::WriteHDF5");
     if (!cube.IsValid()) {
         QL_LOG_ERROR("SpectralIO::WriteHDF5: Invalid spectral cube");
         return false;
@@ -106,10 +399,13 @@ bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCube& cube
             hsize_t dims[3] = {cube.nbands, cube.height, cube.width};
             H5::DataSpace dataspace(3, dims);
 
-            H5::DataSet dataset = file.createDataSet(
-                "/data", H5::PredType::NATIVE_FLOAT, dataspace);
+            const H5::DataType type = StorageDataType<T>();
+            H5::DataSet dataset = file.createDataSet("/data", type, dataspace);
 
-            dataset.write(cube.data.data(), H5::PredType::NATIVE_FLOAT);
+            dataset.write(cube.data.data(), type);
+            if constexpr (std::is_same_v<T, u16>) {
+                WriteScaling(dataset, cube.scale, cube.offset);
+            }
         }
 
         // ====================================================================
@@ -130,8 +426,20 @@ bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCube& cube
         // ====================================================================
         WriteMetadata(file, cube);
 
-        QL_LOG_INFO("SpectralIO::WriteHDF5: Wrote {}x{}x{} cube to {}",
-                    cube.width, cube.height, cube.nbands, filepath);
+        // ====================================================================
+        // Write per-band statistics: /stats
+        // ====================================================================
+        // Statistics of the stored values
+        std::vector<BandStatistics> bandStats(cube.nbands);
+        ForEachBand(cube.nbands, [&](u32 b, bool parallel) {
+            std::vector<f32> scratch;
+            bandStats[b] = BandStatistics::Compute(BandValues(cube, b, scratch, parallel),
+                                                   cube.PixelsPerBand(), parallel);
+        });
+        WriteStatistics(file, CubeStatistics::FromBands(bandStats));
+
+        QL_LOG_INFO("SpectralIO::WriteHDF5: Wrote {}x{}x{} {} cube to {}",
+                    cube.width, cube.height, cube.nbands, PixelFormatName(PixelFormatOf<T>), filepath);
         return true;
 
     } catch (const H5::Exception& e) {
@@ -141,11 +449,86 @@ bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCube& cube
     }
 }
 
+// ============================================================================
+// Public API: WriteHDF5
+// ============================================================================
+
+bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCube& cube) {
+    return WriteCube(filepath, cube);
+}
+
+bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCubeF16& cube) {
+    return WriteCube(filepath, cube);
+}
+
+bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCubeU16& cube) {
+    return WriteCube(filepath, cube);
+}
+
+bool SpectralIO::WriteHDF5(const std::string& filepath, const SpectralCube& cube, PixelFormat format) {
+    switch (format) {
+        case PixelFormat::F16: return WriteCube(filepath, ConvertToStorage<f16>(cube));
+        case PixelFormat::U16: return WriteCube(filepath, ConvertToStorage<u16>(cube));
+        default: return WriteCube(filepath, cube);
+    }
+}
+
+// ============================================================================
+// Public API: WriteCompressedHDF5
+// ============================================================================
+
+bool SpectralIO::WriteCompressedHDF5(const std::string& filepath, const SpectralCube& cube,
+                                     const SpectralPcaSettings& settings) {
+    QL_PROFILE_SCOPE("SpectralIO::WriteCompressedHDF5");
+    std::optional<SpectralPcaEncoding> encoding = SpectralPca::Encode(cube, settings);
+    if (!encoding.has_value()) {
+        QL_LOG_ERROR("SpectralIO::WriteCompressedHDF5: Cannot compress {} within the error bound", filepath);
+        return false;
+    }
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_TRUNC);
+        WritePca(file, encoding.value());
+
+        hsize_t waveDims[1] = {cube.nbands};
+        file.createDataSet("/wavelengths", H5::PredType::NATIVE_FLOAT, H5::DataSpace(1, waveDims))
+            .write(cube.wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+
+        SpectralCube header;
+        header.lambda_min = cube.lambda_min;
+        header.lambda_max = cube.lambda_max;
+        header.delta_lambda = cube.delta_lambda;
+        header.metadata = cube.metadata;
+        header.metadata["compression"] = "pca";
+        WriteMetadata(file, header);
+
+        // Statistics of the original (not the reconstruction)
+        std::vector<BandStatistics> bandStats(cube.nbands);
+        ForEachBand(cube.nbands, [&](u32 b, bool parallel) {
+            bandStats[b] = BandStatistics::Compute(cube.BandPtr(b), cube.PixelsPerBand(), parallel);
+        });
+        WriteStatistics(file, CubeStatistics::FromBands(bandStats));
+
+        const f64 ratio = static_cast<f64>(cube.data.size() * sizeof(f32)) /
+                          static_cast<f64>(encoding->coefficients.size() * sizeof(u16) +
+                                           (encoding->basis.size() + encoding->mean.size() +
+                                            encoding->scale.size() + encoding->offset.size()) * sizeof(f32));
+        QL_LOG_INFO("SpectralIO::WriteCompressedHDF5: Wrote {}x{}x{} cube to {} ({} components, {:.1f}x smaller)",
+                    cube.width, cube.height, cube.nbands, filepath, encoding->components, ratio);
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralIO::WriteCompressedHDF5: Failed to write {}: {}", filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
 // ============================================================================
 // Public API: ReadHDF5
 // ============================================================================
 
 std::optional<SpectralCube> SpectralIO::ReadHDF5(const std::string& filepath) {
+    QL_PROFILE_SCOPE("SpectralIO::ReadHDF5");
     if (!FileExists(filepath)) {
         QL_LOG_ERROR("SpectralIO::ReadHDF5: File not found: {}", filepath);
         return std::nullopt;
@@ -154,6 +537,15 @@ std::optional<SpectralCube> SpectralIO::ReadHDF5(const std::string& filepath) {
     try {
         H5::H5File file(filepath, H5F_ACC_RDONLY);
 
+        if (file.nameExists("/pca")) {
+            std::optional<SpectralCube> cube = ReadCompressed(file, 0, 0, 0, 0);
+            if (cube.has_value()) {
+                QL_LOG_INFO("SpectralIO::ReadHDF5: Decoded {}x{}x{} compressed cube from {}",
+                            cube->width, cube->height, cube->nbands, filepath);
+            }
+            return cube;
+        }
+
         // ====================================================================
         // Read /data dimensions
         // ====================================================================
@@ -188,6 +580,7 @@ std::optional<SpectralCube> SpectralIO::ReadHDF5(const std::string& filepath) {
         // ====================================================================
         cube.data.resize(width * height * nbands);
         dataset.read(cube.data.data(), H5::PredType::NATIVE_FLOAT);
+        ApplyScaling(dataset, cube.data.data(), cube.data.size());
 
         // ====================================================================
         // Read wavelength array
@@ -225,6 +618,61 @@ std::optional<SpectralCube> SpectralIO::ReadHDF5(const std::string& filepath) {
     }
 }
 
+// ============================================================================
+// Public API: ReadRegion
+// ============================================================================
+
+std::optional<SpectralCube> SpectralIO::ReadRegion(const std::string& filepath, u32 x, u32 y, u32 width, u32 height) {
+    QL_PROFILE_SCOPE("SpectralIO::ReadRegion");
+    if (!FileExists(filepath)) {
+        QL_LOG_ERROR("SpectralIO::ReadRegion: File not found: {}", filepath);
+        return std::nullopt;
+    }
+    if (width == 0 || height == 0) {
+        QL_LOG_ERROR("SpectralIO::ReadRegion: Empty region");
+        return std::nullopt;
+    }
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_RDONLY);
+        if (file.nameExists("/pca")) {
+            return ReadCompressed(file, x, y, width, height);
+        }
+
+        H5::DataSet dataset = file.openDataSet("/data");
+        H5::DataSpace fileSpace = dataset.getSpace();
+        hsize_t dims[3];
+        fileSpace.getSimpleExtentDims(dims);
+        if (x + width > dims[2] || y + height > dims[1]) {
+            QL_LOG_ERROR("SpectralIO::ReadRegion: Region {}x{} at ({}, {}) outside the {}x{} cube",
+                         width, height, x, y, dims[2], dims[1]);
+            return std::nullopt;
+        }
+
+        SpectralCube cube;
+        cube.width = width;
+        cube.height = height;
+        cube.nbands = static_cast<u32>(dims[0]);
+        cube.data.resize(static_cast<usize>(width) * height * cube.nbands);
+
+        hsize_t start[3] = {0, y, x};
+        hsize_t extent[3] = {cube.nbands, height, width};
+        fileSpace.selectHyperslab(H5S_SELECT_SET, extent, start);
+        H5::DataSpace memSpace(3, extent);
+        dataset.read(cube.data.data(), H5::PredType::NATIVE_FLOAT, memSpace, fileSpace);
+        ApplyScaling(dataset, cube.data.data(), cube.data.size());
+
+        if (!ReadHeader(file, cube)) {
+            return std::nullopt;
+        }
+        return cube;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralIO::ReadRegion: Failed to read {}: {}", filepath, e.getDetailMsg());
+        return std::nullopt;
+    }
+}
+
 // ============================================================================
 // Public API: FileExists
 // ============================================================================
@@ -247,6 +695,12 @@ std::optional<std::tuple<u32, u32, u32>> SpectralIO::GetDimensions(
 
     try {
         H5::H5File file(filepath, H5F_ACC_RDONLY);
+        if (file.nameExists("/pca")) {
+            H5::Group group = file.openGroup("/pca");
+            return std::make_tuple(ReadU32Attribute(group, "width"), ReadU32Attribute(group, "height"),
+                                   ReadU32Attribute(group, "nbands"));
+        }
+
         H5::DataSet dataset = file.openDataSet("/data");
         H5::DataSpace dataspace = dataset.getSpace();
 
@@ -265,4 +719,257 @@ std::optional<std::tuple<u32, u32, u32>> SpectralIO::GetDimensions(
     }
 }
 
+// ============================================================================
+// Public API: ReadStatistics
+// ============================================================================
+
+std::optional<CubeStatistics> SpectralIO::ReadStatistics(const std::string& filepath) {
+    if (!FileExists(filepath)) {
+        QL_LOG_ERROR("SpectralIO::ReadStatistics: File not found: {}", filepath);
+        return std::nullopt;
+    }
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_RDONLY);
+        return quantiloom::ReadStatistics(file);
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralIO::ReadStatistics: Failed to read {}: {}", filepath, e.getDetailMsg());
+        return std::nullopt;
+    }
+}
+
+// ============================================================================
+// SpectralCubeReader
+// ============================================================================
+
+SpectralCubeReader::SpectralCubeReader() = default;
+
+SpectralCubeReader::~SpectralCubeReader() {
+    Close();
+}
+
+bool SpectralCubeReader::Open(const std::string& filepath) {
+    Close();
+    if (!SpectralIO::FileExists(filepath)) {
+        QL_LOG_ERROR("SpectralCubeReader::Open: File not found: {}", filepath);
+        return false;
+    }
+
+    try {
+        auto file = std::make_unique<H5::H5File>(filepath, H5F_ACC_RDONLY);
+        auto dataset = std::make_unique<H5::DataSet>(file->openDataSet("/data"));
+
+        H5::DataSpace dataspace = dataset->getSpace();
+        if (dataspace.getSimpleExtentNdims() != 3) {
+            QL_LOG_ERROR("SpectralCubeReader::Open: Expected 3D /data in {}", filepath);
+            return false;
+        }
+        hsize_t dims[3];
+        dataspace.getSimpleExtentDims(dims);
+
+        SpectralCube header;
+        header.nbands = static_cast<u32>(dims[0]);
+        header.height = static_cast<u32>(dims[1]);
+        header.width = static_cast<u32>(dims[2]);
+        ReadMetadata(*file, header);
+
+        header.wavelengths.resize(header.nbands);
+        file->openDataSet("/wavelengths").read(header.wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+
+        m_scaled = ReadScaling(*dataset, m_scale, m_offset);
+        m_file = std::move(file);
+        m_dataset = std::move(dataset);
+        m_header = std::move(header);
+        m_filepath = filepath;
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralCubeReader::Open: Failed to open {}: {}", filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
+void SpectralCubeReader::Close() {
+    m_dataset.reset();
+    m_file.reset();
+    m_header = SpectralCube();
+    m_filepath.clear();
+}
+
+bool SpectralCubeReader::ReadBands(u32 firstBand, u32 count, f32* out) {
+    QL_PROFILE_SCOPE("SpectralCubeReader::ReadBands");
+    if (!IsOpen() || count == 0 || firstBand + count > m_header.nbands) {
+        QL_LOG_ERROR("SpectralCubeReader::ReadBands: Bands [{}, {}) out of range ({} bands)",
+                     firstBand, firstBand + count, m_header.nbands);
+        return false;
+    }
+
+    try {
+        hsize_t start[3] = {firstBand, 0, 0};
+        hsize_t extent[3] = {count, m_header.height, m_header.width};
+        H5::DataSpace fileSpace = m_dataset->getSpace();
+        fileSpace.selectHyperslab(H5S_SELECT_SET, extent, start);
+        H5::DataSpace memSpace(3, extent);
+        m_dataset->read(out, H5::PredType::NATIVE_FLOAT, memSpace, fileSpace);
+        if (m_scaled) {
+            const usize valueCount = static_cast<usize>(count) * m_header.PixelsPerBand();
+            for (usize i = 0; i < valueCount; ++i) {
+                out[i] = out[i] * m_scale + m_offset;
+            }
+        }
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralCubeReader::ReadBands: Failed to read {}: {}", m_filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
+std::optional<CubeStatistics> SpectralCubeReader::ReadStatistics() const {
+    if (!IsOpen()) {
+        return std::nullopt;
+    }
+
+    try {
+        return quantiloom::ReadStatistics(*m_file);
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralCubeReader::ReadStatistics: Failed to read {}: {}", m_filepath, e.getDetailMsg());
+        return std::nullopt;
+    }
+}
+
+// ============================================================================
+// SpectralCubeWriter
+// ============================================================================
+
+SpectralCubeWriter::SpectralCubeWriter() = default;
+
+SpectralCubeWriter::~SpectralCubeWriter() {
+    if (IsOpen()) {
+        Close();
+    }
+}
+
+bool SpectralCubeWriter::Open(const std::string& filepath, const SpectralCube& header, PixelFormat format) {
+    if (IsOpen()) {
+        Close();
+    }
+    if (format == PixelFormat::U16) {
+        // The fixed-point range must be known before the first band
+        QL_LOG_ERROR("SpectralCubeWriter::Open: u16 needs the value range up front; "
+                     "use SpectralIO::WriteHDF5 with a SpectralCubeU16 for {}", filepath);
+        return false;
+    }
+    if (header.width == 0 || header.height == 0 || header.nbands == 0 ||
+        header.wavelengths.size() != header.nbands) {
+        QL_LOG_ERROR("SpectralCubeWriter::Open: Invalid cube header for {}", filepath);
+        return false;
+    }
+
+    try {
+        auto file = std::make_unique<H5::H5File>(filepath, H5F_ACC_TRUNC);
+
+        hsize_t dims[3] = {header.nbands, header.height, header.width};
+        hsize_t chunkDims[3] = {1, header.height, header.width};
+        H5::DSetCreatPropList chunking;
+        chunking.setChunk(3, chunkDims);
+        const H5::DataType type = format == PixelFormat::F16 ? H5::DataType(HalfFloatType())
+                                                             : H5::DataType(H5::PredType::NATIVE_FLOAT);
+        auto dataset = std::make_unique<H5::DataSet>(
+            file->createDataSet("/data", type, H5::DataSpace(3, dims), chunking));
+
+        hsize_t waveDims[1] = {header.nbands};
+        file->createDataSet("/wavelengths", H5::PredType::NATIVE_FLOAT, H5::DataSpace(1, waveDims))
+            .write(header.wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+
+        m_header.width = header.width;
+        m_header.height = header.height;
+        m_header.nbands = header.nbands;
+        m_header.lambda_min = header.lambda_min;
+        m_header.lambda_max = header.lambda_max;
+        m_header.delta_lambda = header.delta_lambda;
+        m_header.wavelengths = header.wavelengths;
+        m_header.metadata = header.metadata;
+        m_stats.assign(header.nbands, BandStatistics());
+        m_bandWritten.assign(header.nbands, 0);
+        m_format = format;
+        m_file = std::move(file);
+        m_dataset = std::move(dataset);
+        m_filepath = filepath;
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralCubeWriter::Open: Failed to create {}: {}", filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
+bool SpectralCubeWriter::WriteBands(u32 firstBand, u32 count, const f32* data) {
+    QL_PROFILE_SCOPE("SpectralCubeWriter::WriteBands");
+    if (!IsOpen() || count == 0 || firstBand + count > m_header.nbands) {
+        QL_LOG_ERROR("SpectralCubeWriter::WriteBands: Bands [{}, {}) out of range ({} bands)",
+                     firstBand, firstBand + count, m_header.nbands);
+        return false;
+    }
+
+    try {
+        hsize_t start[3] = {firstBand, 0, 0};
+        hsize_t extent[3] = {count, m_header.height, m_header.width};
+        H5::DataSpace fileSpace = m_dataset->getSpace();
+        fileSpace.selectHyperslab(H5S_SELECT_SET, extent, start);
+        H5::DataSpace memSpace(3, extent);
+        if (m_format == PixelFormat::F16) {
+            // Convert here (F16C) rather than through HDF5's soft conversion
+            m_halfScratch.resize(static_cast<usize>(count) * m_header.PixelsPerBand());
+            ConvertSamples(data, m_halfScratch.data(), m_halfScratch.size());
+            m_dataset->write(m_halfScratch.data(), HalfFloatType(), memSpace, fileSpace);
+        } else {
+            m_dataset->write(data, H5::PredType::NATIVE_FLOAT, memSpace, fileSpace);
+        }
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralCubeWriter::WriteBands: Failed to write {}: {}", m_filepath, e.getDetailMsg());
+        return false;
+    }
+
+    // Statistics of the bands just written (a rewrite replaces them)
+    const usize pixels = m_header.PixelsPerBand();
+    ForEachBand(count, [&](u32 b, bool parallel) {
+        m_stats[firstBand + b] = BandStatistics::Compute(data + b * pixels, pixels, parallel);
+        m_bandWritten[firstBand + b] = 1;
+    });
+    return true;
+}
+
+bool SpectralCubeWriter::Close() {
+    if (!IsOpen()) {
+        return false;
+    }
+
+    bool ok = true;
+    try {
+        WriteMetadata(*m_file, m_header);
+        if (std::all_of(m_bandWritten.begin(), m_bandWritten.end(), [](u8 written) { return written != 0; })) {
+            WriteStatistics(*m_file, CubeStatistics::FromBands(m_stats));
+        } else {
+            QL_LOG_WARN("SpectralCubeWriter::Close: Not every band of {} was written, skipping /stats", m_filepath);
+        }
+        QL_LOG_INFO("SpectralCubeWriter: Wrote {}x{}x{} cube to {}",
+                    m_header.width, m_header.height, m_header.nbands, m_filepath);
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralCubeWriter::Close: Failed to write metadata to {}: {}", m_filepath, e.getDetailMsg());
+        ok = false;
+    }
+
+    m_dataset.reset();
+    m_file.reset();
+    m_header = SpectralCube();
+    m_filepath.clear();
+    m_stats.clear();
+    m_bandWritten.clear();
+    m_halfScratch = std::vector<f16>();
+    m_format = PixelFormat::F32;
+    return ok;
+}
+
 } // namespace quantiloom
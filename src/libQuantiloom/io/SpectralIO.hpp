@@ -1,9 +1,18 @@
 #pragma once
 
 #include "core/SpectralCube.hpp"
+#include "core/BandStatistics.hpp"
+#include "core/SpectralPca.hpp"
 #include "core/Log.hpp"
+#include <memory>
 #include <string>
 #include <optional>
+#include <vector>
+
+namespace H5 {
+class H5File;
+class DataSet;
+}
 
 namespace quantiloom {
 
@@ -11,9 +20,24 @@ namespace quantiloom {
 // SpectralIO - HDF5 hyperspectral cube reading/writing
 // ============================================================================
 // HDF5 structure:
-//   /data              - 3D dataset [nbands, height, width], float32
+//   /data              - 3D dataset [nbands, height, width], float32,
+//                        float16 or uint16 (value = stored * scale_factor
+//                        + add_offset, attributes of /data as in CF);
+//                        readers always return float32
 //   /wavelengths       - 1D dataset [nbands], float32
 //   /metadata          - Group containing string attributes
+//   /stats             - Per-band statistics (CubeStatistics), computed by
+//                        the writers while the bands go out; optional
+//
+// Compressed archives (WriteCompressedHDF5, see core/SpectralPca.hpp) store
+// /pca instead of /data; ReadHDF5 and ReadRegion decode them transparently:
+//   /pca               - Group, attributes width, height, nbands,
+//                        components, tile_size, relative_rmse
+//   /pca/mean          - [nbands] float32
+//   /pca/basis         - [components, nbands] float32
+//   /pca/coefficients  - [components, height, width] uint16, one HDF5 chunk
+//                        per tile (ROI reads touch only overlapping tiles)
+//   /pca/scale, offset - [components, tilesY, tilesX] float32
 //
 // Memory layout:
 //   C-order (row-major): data[b][y][x]
@@ -25,22 +49,62 @@ namespace quantiloom {
 // - HDF5 is standard in scientific computing (MODTRAN, hyperspectral sensors)
 // ============================================================================
 
+// ============================================================================
+// CubeStatistics - Per-band statistics stored in /stats
+// ============================================================================
+// One HDF5 dataset per member: count, non_finite, min, max, mean, stddev
+// ([nbands]), percentile_levels ([levels], in %) and percentiles
+// ([nbands][levels]). Lets readers normalise or pick display ranges without
+// a pass over /data.
+// ============================================================================
+
+struct QL_API CubeStatistics {
+    std::vector<f32> percentileLevels;   // Percent, e.g. {0.1, 1, 5, 50, 95, 99, 99.9}
+    std::vector<u64> count;              // Finite values per band
+    std::vector<u64> nonFinite;          // NaN/Inf values per band
+    std::vector<f32> min;
+    std::vector<f32> max;
+    std::vector<f32> mean;
+    std::vector<f32> stddev;
+    std::vector<f32> percentiles;        // [band][level]
+
+    usize BandCount() const { return count.size(); }
+    f32 Percentile(u32 band, usize level) const { return percentiles[band * percentileLevels.size() + level]; }
+
+    static const std::vector<f32>& DefaultLevels();
+    static CubeStatistics FromBands(const std::vector<BandStatistics>& bands,
+                                    const std::vector<f32>& levels = DefaultLevels());
+};
+
 class QL_API SpectralIO {
 public:
     // ========================================================================
     // HDF5 Writing
     // ========================================================================
 
-    // Write spectral cube to HDF5 file
+    // Write spectral cube to HDF5 file (/data in the cube's element type)
     static bool WriteHDF5(const std::string& filepath, const SpectralCube& cube);
+    static bool WriteHDF5(const std::string& filepath, const SpectralCubeF16& cube);
+    static bool WriteHDF5(const std::string& filepath, const SpectralCubeU16& cube);
+
+    // Convert to the given storage format and write
+    static bool WriteHDF5(const std::string& filepath, const SpectralCube& cube, PixelFormat format);
+
+    // Write a PCA-compressed archive (fails if the error bound cannot be met)
+    static bool WriteCompressedHDF5(const std::string& filepath, const SpectralCube& cube,
+                                    const SpectralPcaSettings& settings = {});
 
     // ========================================================================
     // HDF5 Reading
     // ========================================================================
 
-    // Read spectral cube from HDF5 file
+    // Read spectral cube from HDF5 file (plain or compressed)
     static std::optional<SpectralCube> ReadHDF5(const std::string& filepath);
 
+    // Read the region [x, x + width) x [y, y + height) of every band
+    static std::optional<SpectralCube> ReadRegion(const std::string& filepath,
+                                                  u32 x, u32 y, u32 width, u32 height);
+
     // ========================================================================
     // Utilities
     // ========================================================================
@@ -50,6 +114,89 @@ public:
 
     // Get cube dimensions without loading data (fast peek)
     static std::optional<std::tuple<u32, u32, u32>> GetDimensions(const std::string& filepath);
+
+    // Read /stats without touching /data (nullopt if the file has none)
+    static std::optional<CubeStatistics> ReadStatistics(const std::string& filepath);
+};
+
+// ============================================================================
+// SpectralCubeReader / SpectralCubeWriter - Band-streaming HDF5 access
+// ============================================================================
+// Same file layout as SpectralIO, but bands are read or written a chunk at a
+// time so cubes larger than memory can be processed. The writer stores /data
+// in one HDF5 chunk per band, accumulates each band's statistics as it is
+// written, and writes /metadata and /stats on Close(). Bands are passed as
+// f32 and stored as f32 or f16.
+//
+// Usage:
+//   SpectralCubeReader reader;
+//   if (reader.Open("cube.h5")) {
+//       std::vector<f32> bands(16 * reader.GetHeader().PixelsPerBand());
+//       reader.ReadBands(0, 16, bands.data());
+//   }
+// ============================================================================
+
+class QL_API SpectralCubeReader {
+public:
+    SpectralCubeReader();
+    ~SpectralCubeReader();
+    SpectralCubeReader(const SpectralCubeReader&) = delete;
+    SpectralCubeReader& operator=(const SpectralCubeReader&) = delete;
+
+    bool Open(const std::string& filepath);
+    void Close();
+    bool IsOpen() const { return m_dataset != nullptr; }
+
+    // Dimensions, wavelengths and metadata (data left empty)
+    const SpectralCube& GetHeader() const { return m_header; }
+
+    // Read bands [firstBand, firstBand + count) into out ([count][height][width])
+    bool ReadBands(u32 firstBand, u32 count, f32* out);
+
+    // Read /stats (nullopt if the file has none)
+    std::optional<CubeStatistics> ReadStatistics() const;
+
+private:
+    std::unique_ptr<H5::H5File> m_file;
+    std::unique_ptr<H5::DataSet> m_dataset;
+    SpectralCube m_header;
+    std::string m_filepath;
+    bool m_scaled = false;   // u16 data: value = stored * m_scale + m_offset
+    f32 m_scale = 1.0f;
+    f32 m_offset = 0.0f;
+};
+
+class QL_API SpectralCubeWriter {
+public:
+    SpectralCubeWriter();
+    ~SpectralCubeWriter();
+    SpectralCubeWriter(const SpectralCubeWriter&) = delete;
+    SpectralCubeWriter& operator=(const SpectralCubeWriter&) = delete;
+
+    // Create the file; header gives dimensions, wavelengths and metadata
+    // (its data is ignored). format is F32 or F16 (u16 needs the value range
+    // before the first band; write a SpectralCubeU16 with SpectralIO instead)
+    bool Open(const std::string& filepath, const SpectralCube& header, PixelFormat format = PixelFormat::F32);
+
+    // Write bands [firstBand, firstBand + count) from data ([count][height][width])
+    bool WriteBands(u32 firstBand, u32 count, const f32* data);
+
+    // Write metadata and close the file
+    bool Close();
+    bool IsOpen() const { return m_dataset != nullptr; }
+
+    // Metadata written on Close() (may be extended while writing)
+    std::unordered_map<std::string, std::string>& Metadata() { return m_header.metadata; }
+
+private:
+    std::unique_ptr<H5::H5File> m_file;
+    std::unique_ptr<H5::DataSet> m_dataset;
+    SpectralCube m_header;
+    std::string m_filepath;
+    std::vector<BandStatistics> m_stats;
+    std::vector<u8> m_bandWritten;
+    PixelFormat m_format = PixelFormat::F32;
+    std::vector<f16> m_halfScratch;
 };
 
 } // namespace quantiloom
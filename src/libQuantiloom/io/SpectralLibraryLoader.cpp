@@ -0,0 +1,259 @@
+#include "SpectralLibraryLoader.hpp"
+
+#include <H5Cpp.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: Read / write 1D float datasets inside a group
+// ============================================================================
+
+static bool ReadDataset(const H5::Group& group, const std::string& name, std::vector<f32>& out) {
+    H5::DataSet dataset = group.openDataSet(name);
+    H5::DataSpace dataspace = dataset.getSpace();
+    if (dataspace.getSimpleExtentNdims() != 1) {
+        QL_LOG_ERROR("SpectralLibraryLoader: Expected 1D dataset for {}", name);
+        return false;
+    }
+
+    out.resize(static_cast<usize>(dataspace.getSimpleExtentNpoints()));
+    dataset.read(out.data(), H5::PredType::NATIVE_FLOAT);
+    return true;
+}
+
+static void WriteDataset(H5::Group& group, const std::string& name, const std::vector<f32>& data) {
+    hsize_t dims[1] = {data.size()};
+    H5::DataSpace dataspace(1, dims);
+    group.createDataSet(name, H5::PredType::NATIVE_FLOAT, dataspace)
+        .write(data.data(), H5::PredType::NATIVE_FLOAT);
+}
+
+// ============================================================================
+// Helper: CSV tokenising
+// ============================================================================
+
+static std::string Trim(const std::string& s) {
+    usize begin = 0;
+    usize end = s.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(s[begin]))) {
+        ++begin;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(s[end - 1]))) {
+        --end;
+    }
+    return s.substr(begin, end - begin);
+}
+
+static std::vector<std::string> SplitCSV(const std::string& line) {
+    std::vector<std::string> cells;
+    std::stringstream stream(line);
+    std::string cell;
+    while (std::getline(stream, cell, ',')) {
+        cells.push_back(Trim(cell));
+    }
+    return cells;
+}
+
+static bool ParseFloat(const std::string& s, f32& out) {
+    const char* end = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), end, out);
+    return ec == std::errc() && ptr == end;
+}
+
+// ============================================================================
+// Public API: Load
+// ============================================================================
+
+std::optional<SpectralMaterialLibrary> SpectralLibraryLoader::Load(const std::string& filepath) {
+    std::string ext = std::filesystem::path(filepath).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (ext == ".csv") {
+        return LoadCSV(filepath);
+    }
+    if (ext == ".h5" || ext == ".hdf5") {
+        return LoadHDF5(filepath);
+    }
+
+    QL_LOG_ERROR("SpectralLibraryLoader::Load: Unsupported extension '{}' ({})", ext, filepath);
+    return std::nullopt;
+}
+
+// ============================================================================
+// Public API: LoadHDF5
+// ============================================================================
+
+std::optional<SpectralMaterialLibrary> SpectralLibraryLoader::LoadHDF5(const std::string& filepath) {
+    if (!std::filesystem::exists(filepath)) {
+        QL_LOG_ERROR("SpectralLibraryLoader::LoadHDF5: File not found: {}", filepath);
+        return std::nullopt;
+    }
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_RDONLY);
+        H5::Group materials = file.openGroup("/materials");
+
+        SpectralMaterialLibrary library;
+        for (hsize_t i = 0; i < materials.getNumObjs(); ++i) {
+            MeasuredSpectrum spectrum;
+            spectrum.name = materials.getObjnameByIdx(i);
+            H5::Group group = materials.openGroup(spectrum.name);
+
+            if (!ReadDataset(group, "wavelengths", spectrum.wavelengths) ||
+                !ReadDataset(group, "reflectance", spectrum.reflectance)) {
+                return std::nullopt;
+            }
+            if (group.nameExists("emissivity") && !ReadDataset(group, "emissivity", spectrum.emissivity)) {
+                return std::nullopt;
+            }
+
+            library.Add(std::move(spectrum));
+        }
+
+        QL_LOG_INFO("SpectralLibraryLoader::LoadHDF5: Loaded {} spectra from {}", library.Size(), filepath);
+        return library;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralLibraryLoader::LoadHDF5: Failed to load {}: {}", filepath, e.getDetailMsg());
+        return std::nullopt;
+    }
+}
+
+// ============================================================================
+// Public API: LoadCSV
+// ============================================================================
+
+std::optional<SpectralMaterialLibrary> SpectralLibraryLoader::LoadCSV(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file) {
+        QL_LOG_ERROR("SpectralLibraryLoader::LoadCSV: Cannot open {}", filepath);
+        return std::nullopt;
+    }
+
+    static const std::string kEmissivitySuffix = ".emissivity";
+
+    std::vector<std::string> header;
+    std::vector<std::vector<f32>> columns;
+    std::string line;
+    usize lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const std::string trimmed = Trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> cells = SplitCSV(trimmed);
+        if (header.empty()) {
+            if (cells.size() < 2 || (cells[0] != "wavelength_nm" && cells[0] != "wavelength_um")) {
+                QL_LOG_ERROR("SpectralLibraryLoader::LoadCSV: {} must start with a 'wavelength_nm' or "
+                             "'wavelength_um' column followed by material columns", filepath);
+                return std::nullopt;
+            }
+            header = std::move(cells);
+            columns.resize(header.size());
+            continue;
+        }
+
+        if (cells.size() != header.size()) {
+            QL_LOG_ERROR("SpectralLibraryLoader::LoadCSV: {}:{}: Expected {} columns, got {}",
+                         filepath, lineNumber, header.size(), cells.size());
+            return std::nullopt;
+        }
+        for (usize c = 0; c < cells.size(); ++c) {
+            f32 value = 0.0f;
+            if (!ParseFloat(cells[c], value)) {
+                QL_LOG_ERROR("SpectralLibraryLoader::LoadCSV: {}:{}: Invalid number '{}'",
+                             filepath, lineNumber, cells[c]);
+                return std::nullopt;
+            }
+            columns[c].push_back(value);
+        }
+    }
+
+    if (header.empty() || columns[0].empty()) {
+        QL_LOG_ERROR("SpectralLibraryLoader::LoadCSV: No data in {}", filepath);
+        return std::nullopt;
+    }
+
+    std::vector<f32> wavelengths = std::move(columns[0]);
+    if (header[0] == "wavelength_um") {
+        for (f32& w : wavelengths) {
+            w *= 1000.0f;
+        }
+    }
+
+    // Reflectance columns first, then attach emissivity columns to them
+    std::vector<MeasuredSpectrum> spectra;
+    for (usize c = 1; c < header.size(); ++c) {
+        if (!header[c].ends_with(kEmissivitySuffix)) {
+            spectra.push_back(MeasuredSpectrum{header[c], wavelengths, std::move(columns[c]), {}});
+        }
+    }
+    for (usize c = 1; c < header.size(); ++c) {
+        if (!header[c].ends_with(kEmissivitySuffix)) {
+            continue;
+        }
+        const std::string name = header[c].substr(0, header[c].size() - kEmissivitySuffix.size());
+        auto it = std::find_if(spectra.begin(), spectra.end(),
+                               [&](const MeasuredSpectrum& s) { return s.name == name; });
+        if (it == spectra.end()) {
+            // Emissivity-only material: reflectance of an opaque body is 1 - emissivity
+            MeasuredSpectrum spectrum{name, wavelengths, {}, std::move(columns[c])};
+            spectrum.reflectance.reserve(spectrum.emissivity.size());
+            for (f32 e : spectrum.emissivity) {
+                spectrum.reflectance.push_back(1.0f - e);
+            }
+            spectra.push_back(std::move(spectrum));
+        } else {
+            it->emissivity = std::move(columns[c]);
+        }
+    }
+
+    SpectralMaterialLibrary library;
+    for (MeasuredSpectrum& spectrum : spectra) {
+        library.Add(std::move(spectrum));
+    }
+
+    QL_LOG_INFO("SpectralLibraryLoader::LoadCSV: Loaded {} spectra ({} samples) from {}",
+                library.Size(), wavelengths.size(), filepath);
+    return library;
+}
+
+// ============================================================================
+// Public API: SaveHDF5
+// ============================================================================
+
+bool SpectralLibraryLoader::SaveHDF5(const std::string& filepath, const SpectralMaterialLibrary& library) {
+    try {
+        H5::H5File file(filepath, H5F_ACC_TRUNC);
+        H5::Group materials = file.createGroup("/materials");
+
+        for (usize i = 0; i < library.Size(); ++i) {
+            const MeasuredSpectrum& spectrum = library.Get(i);
+            H5::Group group = materials.createGroup(spectrum.name);
+            WriteDataset(group, "wavelengths", spectrum.wavelengths);
+            WriteDataset(group, "reflectance", spectrum.reflectance);
+            if (spectrum.HasEmissivity()) {
+                WriteDataset(group, "emissivity", spectrum.emissivity);
+            }
+        }
+
+        QL_LOG_INFO("SpectralLibraryLoader::SaveHDF5: Saved {} spectra to {}", library.Size(), filepath);
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SpectralLibraryLoader::SaveHDF5: Failed to save {}: {}", filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
+} // namespace quantiloom
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "scene/SpectralMaterial.hpp"
+#include "core/Log.hpp"
+#include <string>
+#include <optional>
+
+namespace quantiloom {
+
+// ============================================================================
+// SpectralLibraryLoader - Measured material spectra I/O (HDF5, CSV)
+// ============================================================================
+// HDF5 structure (one group per material, native sampling per material):
+//   /materials/<name>/wavelengths  - 1D dataset [n], float32, nm
+//   /materials/<name>/reflectance  - 1D dataset [n], float32, [0, 1]
+//   /materials/<name>/emissivity   - 1D dataset [n], float32, optional
+//
+// CSV structure (shared wavelength column, '#' starts a comment line):
+//   wavelength_nm,concrete,asphalt,asphalt.emissivity
+//   400,0.21,0.05,0.95
+//   ...
+// - First column is wavelength in nm ("wavelength_nm") or micrometres
+//   ("wavelength_um", common for thermal libraries)
+// - Every other column is a reflectance spectrum named by its header;
+//   "<name>.emissivity" columns attach emissivity to material <name>
+// ============================================================================
+
+class QL_API SpectralLibraryLoader {
+public:
+    // Load by extension (.h5/.hdf5 -> HDF5, .csv -> CSV)
+    static std::optional<SpectralMaterialLibrary> Load(const std::string& filepath);
+
+    static std::optional<SpectralMaterialLibrary> LoadHDF5(const std::string& filepath);
+    static std::optional<SpectralMaterialLibrary> LoadCSV(const std::string& filepath);
+
+    // Save library to HDF5 file (overwrites), e.g. to convert CSV libraries
+    static bool SaveHDF5(const std::string& filepath, const SpectralMaterialLibrary& library);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,249 @@
+#include "TextureCache.hpp"
+#include "core/Log.hpp"
+#include "scene/TextureCompression.hpp"
+
+#include <H5Cpp.h>
+#include <filesystem>
+
+namespace quantiloom {
+
+// Bump when the cached data layout or the mip filtering changes
+static constexpr u64 kTextureCacheVersion = 1;
+
+// ============================================================================
+// Helper: FNV-1a hashing
+// ============================================================================
+
+static u64 HashBytes(u64 hash, const void* data, usize size) {
+    const u8* bytes = static_cast<const u8*>(data);
+    for (usize i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template<typename T>
+static u64 HashValue(u64 hash, const T& value) {
+    return HashBytes(hash, &value, sizeof(T));
+}
+
+u64 TextureCache::ComputeKey(const Texture& texture, MipFilter filter) {
+    u64 hash = 14695981039346656037ull;
+    hash = HashValue(hash, kTextureCacheVersion);
+    hash = HashValue(hash, texture.width);
+    hash = HashValue(hash, texture.height);
+    hash = HashValue(hash, texture.channels);
+    hash = HashValue(hash, static_cast<u32>(texture.usage));
+    hash = HashValue(hash, static_cast<u32>(texture.sampler.wrapS));
+    hash = HashValue(hash, static_cast<u32>(texture.sampler.wrapT));
+    hash = HashValue(hash, static_cast<u32>(filter));
+    return HashBytes(hash, texture.pixels.data(), texture.pixels.size());
+}
+
+// ============================================================================
+// Helper: Block-compressed levels
+// ============================================================================
+
+// Read the bc_<level> datasets of a cache entry. Each must hold exactly the
+// blocks of its level: a stale or truncated file would otherwise make the
+// decoder read past the end of the data.
+static bool LoadBlockLevels(const H5::Group& group, const Texture& texture, const std::vector<TextureMip>& mips,
+                            TextureCompression compression, std::vector<TextureBlockLevel>& blockLevels) {
+    const u32 blockSize = BcCodec::GetBlockSize(compression);
+    if (blockSize == 0) {
+        QL_LOG_FIRST_N(WARN, 16, "TextureCache::Load: Unknown block format {} for '{}', ignoring entry",
+                       static_cast<u32>(compression), texture.name);
+        return false;
+    }
+
+    const u32 mipCount = 1 + static_cast<u32>(mips.size());
+    blockLevels.reserve(mipCount);
+    for (u32 level = 0; level < mipCount; ++level) {
+        TextureBlockLevel blockLevel;
+        blockLevel.width = level == 0 ? texture.width : mips[level - 1].width;
+        blockLevel.height = level == 0 ? texture.height : mips[level - 1].height;
+        const usize expectedSize = static_cast<usize>((blockLevel.width + 3) / 4) *
+                                   ((blockLevel.height + 3) / 4) * blockSize;
+
+        const std::string name = "bc_" + std::to_string(level);
+        if (!group.nameExists(name)) {
+            QL_LOG_FIRST_N(WARN, 16, "TextureCache::Load: Missing blocks for '{}' level {}, ignoring entry",
+                           texture.name, level);
+            return false;
+        }
+        H5::DataSet dataset = group.openDataSet(name);
+        H5::DataSpace space = dataset.getSpace();
+        hsize_t dims[1] = {0};
+        if (space.getSimpleExtentNdims() == 1) {
+            space.getSimpleExtentDims(dims);
+        }
+        if (dims[0] != expectedSize) {
+            QL_LOG_FIRST_N(WARN, 16, "TextureCache::Load: Block size mismatch for '{}' level {}, ignoring entry",
+                           texture.name, level);
+            return false;
+        }
+        blockLevel.blocks.resize(expectedSize);
+        dataset.read(blockLevel.blocks.data(), H5::PredType::NATIVE_UINT8);
+        blockLevels.push_back(std::move(blockLevel));
+    }
+    return true;
+}
+
+// ============================================================================
+// Public API: Load
+// ============================================================================
+
+u32 TextureCache::Load(const std::string& filepath, std::vector<Texture>& textures, MipFilter filter) {
+    if (!std::filesystem::exists(filepath)) {
+        return 0;
+    }
+
+    u32 hits = 0;
+
+    try {
+        H5::H5File file(filepath, H5F_ACC_RDONLY);
+        if (!file.nameExists("/textures")) {
+            return 0;
+        }
+
+        for (usize i = 0; i < textures.size(); ++i) {
+            Texture& texture = textures[i];
+            std::string groupName = "/textures/" + std::to_string(i);
+            if (!texture.IsValid() || !file.nameExists(groupName)) {
+                continue;
+            }
+
+            H5::Group group = file.openGroup(groupName);
+
+            u64 key = 0;
+            group.openAttribute("key").read(H5::PredType::NATIVE_UINT64, &key);
+            if (key != ComputeKey(texture, filter)) {
+                continue;
+            }
+
+            u32 mipCount = 0;
+            group.openAttribute("mip_count").read(H5::PredType::NATIVE_UINT32, &mipCount);
+
+            std::vector<TextureMip> mips;
+            mips.reserve(mipCount > 0 ? mipCount - 1 : 0);
+            u32 width = texture.width;
+            u32 height = texture.height;
+
+            for (u32 level = 1; level < mipCount; ++level) {
+                width = std::max(1u, width / 2);
+                height = std::max(1u, height / 2);
+
+                TextureMip mip;
+                mip.width = width;
+                mip.height = height;
+                mip.pixels.resize(static_cast<usize>(width) * height * texture.channels);
+
+                H5::DataSet dataset = group.openDataSet("mip_" + std::to_string(level));
+                hsize_t dims[1];
+                dataset.getSpace().getSimpleExtentDims(dims);
+                if (dims[0] != mip.pixels.size()) {
+                    QL_LOG_FIRST_N(WARN, 16, "TextureCache::Load: Size mismatch for '{}' level {}, ignoring entry",
+                                   texture.name, level);
+                    mips.clear();
+                    break;
+                }
+                dataset.read(mip.pixels.data(), H5::PredType::NATIVE_UINT8);
+                mips.push_back(std::move(mip));
+            }
+
+            if (mips.size() + 1 != mipCount) {
+                continue;
+            }
+
+            // Block-compressed levels (optional, written when compression was enabled)
+            TextureCompression compression = TextureCompression::None;
+            std::vector<TextureBlockLevel> blockLevels;
+            if (group.attrExists("compression")) {
+                u32 format = 0;
+                group.openAttribute("compression").read(H5::PredType::NATIVE_UINT32, &format);
+                compression = static_cast<TextureCompression>(format);
+            }
+            if (compression != TextureCompression::None &&
+                !LoadBlockLevels(group, texture, mips, compression, blockLevels)) {
+                continue;
+            }
+
+            texture.mips = std::move(mips);
+            texture.compression = compression;
+            texture.blockLevels = std::move(blockLevels);
+            ++hits;
+        }
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_WARN("TextureCache::Load: Failed to read {}: {}", filepath, e.getDetailMsg());
+        return hits;
+    }
+
+    QL_LOG_INFO("TextureCache: Restored {}/{} texture(s) from {}", hits, textures.size(), filepath);
+    return hits;
+}
+
+// ============================================================================
+// Public API: Save
+// ============================================================================
+
+bool TextureCache::Save(const std::string& filepath, const std::vector<Texture>& textures, MipFilter filter) {
+    try {
+        H5::H5File file(filepath, H5F_ACC_TRUNC);
+        H5::Group root = file.createGroup("/textures");
+        H5::DataSpace scalar(H5S_SCALAR);
+
+        for (usize i = 0; i < textures.size(); ++i) {
+            const Texture& texture = textures[i];
+            if (!texture.IsValid()) {
+                continue;
+            }
+
+            H5::Group group = root.createGroup(std::to_string(i));
+
+            u64 key = ComputeKey(texture, filter);
+            group.createAttribute("key", H5::PredType::NATIVE_UINT64, scalar)
+                .write(H5::PredType::NATIVE_UINT64, &key);
+
+            u32 mipCount = texture.GetMipCount();
+            group.createAttribute("mip_count", H5::PredType::NATIVE_UINT32, scalar)
+                .write(H5::PredType::NATIVE_UINT32, &mipCount);
+
+            for (u32 level = 1; level < mipCount; ++level) {
+                const auto& pixels = texture.GetMipPixels(level);
+                hsize_t dims[1] = {pixels.size()};
+                H5::DataSpace dataspace(1, dims);
+
+                H5::DataSet dataset = group.createDataSet(
+                    "mip_" + std::to_string(level), H5::PredType::NATIVE_UINT8, dataspace);
+                dataset.write(pixels.data(), H5::PredType::NATIVE_UINT8);
+            }
+
+            if (texture.IsCompressed()) {
+                u32 compression = static_cast<u32>(texture.compression);
+                group.createAttribute("compression", H5::PredType::NATIVE_UINT32, scalar)
+                    .write(H5::PredType::NATIVE_UINT32, &compression);
+
+                for (u32 level = 0; level < mipCount; ++level) {
+                    const auto& blocks = texture.blockLevels[level].blocks;
+                    hsize_t dims[1] = {blocks.size()};
+                    H5::DataSpace dataspace(1, dims);
+
+                    H5::DataSet dataset = group.createDataSet(
+                        "bc_" + std::to_string(level), H5::PredType::NATIVE_UINT8, dataspace);
+                    dataset.write(blocks.data(), H5::PredType::NATIVE_UINT8);
+                }
+            }
+        }
+
+        QL_LOG_INFO("TextureCache: Wrote {} texture(s) to {}", textures.size(), filepath);
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("TextureCache::Save: Failed to write {}: {}", filepath, e.getDetailMsg());
+        return false;
+    }
+}
+
+} // namespace quantiloom
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "scene/Texture.hpp"
+#include "scene/TextureMips.hpp"
+#include <string>
+#include <vector>
+
+namespace quantiloom {
+
+// ============================================================================
+// TextureCache - HDF5 scene cache for derived texture data
+// ============================================================================
+// Persists data that is expensive to derive from the source images (mip
+// chains, BCn blocks) so that reloading an unchanged scene skips the
+// processing step.
+//
+// HDF5 structure:
+//   /textures/<index>         - Group per Scene::textures entry
+//     attr key                - u64 hash of level 0 pixels + dimensions,
+//                               usage, wrap modes, mip filter, cache version
+//     attr mip_count          - Number of levels including level 0
+//     mip_<n>                 - 1D u8 dataset, level n pixels (n >= 1)
+//     attr compression        - TextureCompression (only if compressed)
+//     bc_<n>                  - 1D u8 dataset, level n BCn blocks (n >= 0)
+//
+// An entry is only applied when its key matches the texture in memory and
+// every dataset has exactly the size of its level, so edited textures,
+// changed settings and stale or truncated files simply miss and get
+// regenerated.
+//
+// Usage:
+//   u32 hits = TextureCache::Load(path, scene.textures, filter);
+//   MipGenerator::GenerateMips(scene.textures, filter);  // misses only
+//   if (hits < scene.textures.size()) TextureCache::Save(path, scene.textures, filter);
+// ============================================================================
+
+class QL_API TextureCache {
+public:
+    // Restore cached mip chains (and BCn blocks, if present) into matching textures
+    // Returns number of textures restored (0 if the file does not exist)
+    static u32 Load(const std::string& filepath, std::vector<Texture>& textures, MipFilter filter);
+
+    // Write mip chains and BCn blocks of all textures (overwrites the file)
+    static bool Save(const std::string& filepath, const std::vector<Texture>& textures, MipFilter filter);
+
+    // Cache key for a texture's level 0 content and processing settings
+    static u64 ComputeKey(const Texture& texture, MipFilter filter);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,375 @@
+#include "TileCacheFile.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+#include "scene/TextureSampling.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(QL_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace quantiloom {
+
+static constexpr char kTileCacheMagic[4] = {'Q', 'L', 'V', 'T'};
+static constexpr u32 kTileCacheVersion = 1;
+static constexpr usize kTileDataAlignment = 4096;  // Page-aligned tiles for mmap
+
+// On-disk structures (fixed layout, little-endian)
+struct FileHeader {
+    char magic[4];
+    u32 version;
+    u32 tileSize;
+    u32 border;
+    u32 textureCount;
+    u32 reserved;
+    u64 tileCount;
+};
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout changed");
+
+struct FileTextureEntry {
+    u32 width;
+    u32 height;
+    u32 mipCount;
+    u32 usage;
+    u32 wrapS;
+    u32 wrapT;
+    u64 firstTile;
+};
+static_assert(sizeof(FileTextureEntry) == 32, "FileTextureEntry layout changed");
+
+// ============================================================================
+// Helper: tile grid
+// ============================================================================
+
+static u32 MipExtent(u32 size, u32 mip) {
+    return std::max(1u, size >> mip);
+}
+
+static u32 TileCount1D(u32 size, u32 tileSize) {
+    return (size + tileSize - 1) / tileSize;
+}
+
+static usize AlignUp(usize value, usize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Compute per-level first tile indices; returns the texture's total tile count
+static u64 LayoutMips(TileCacheFile::TextureInfo& info, u32 tileSize) {
+    info.mipFirstTile.resize(info.mipCount);
+    u64 tiles = 0;
+    for (u32 mip = 0; mip < info.mipCount; ++mip) {
+        info.mipFirstTile[mip] = info.firstTile + tiles;
+        tiles += static_cast<u64>(TileCount1D(MipExtent(info.width, mip), tileSize)) *
+                 TileCount1D(MipExtent(info.height, mip), tileSize);
+    }
+    return tiles;
+}
+
+// ============================================================================
+// Helper: tile extraction
+// ============================================================================
+
+// Copy one tile (with wrapped border texels) of a mip level into RGBA8 storage
+static void ExtractTile(const Texture& texture, u32 mip, u32 tileX, u32 tileY,
+                        u32 tileSize, u32 border, u8* out) {
+    const i32 width = static_cast<i32>(texture.GetMipWidth(mip));
+    const i32 height = static_cast<i32>(texture.GetMipHeight(mip));
+    const u8* pixels = texture.GetMipPixels(mip).data();
+    const u32 channels = texture.channels;
+    const u32 stored = tileSize + 2 * border;
+
+    const i32 originX = static_cast<i32>(tileX * tileSize) - static_cast<i32>(border);
+    const i32 originY = static_cast<i32>(tileY * tileSize) - static_cast<i32>(border);
+
+    for (u32 y = 0; y < stored; ++y) {
+        const i32 srcY = TextureSampling::WrapCoord(originY + static_cast<i32>(y), height, texture.sampler.wrapT);
+        for (u32 x = 0; x < stored; ++x) {
+            const i32 srcX = TextureSampling::WrapCoord(originX + static_cast<i32>(x), width, texture.sampler.wrapS);
+            const u8* texel = pixels + (static_cast<usize>(srcY) * static_cast<usize>(width) + static_cast<usize>(srcX)) * channels;
+
+            // Missing channels expand to (0, 0, 0, 255) like Vulkan format expansion
+            u8* dst = out + (static_cast<usize>(y) * stored + x) * 4;
+            dst[0] = 0;
+            dst[1] = 0;
+            dst[2] = 0;
+            dst[3] = 255;
+            for (u32 c = 0; c < std::min(channels, 4u); ++c) {
+                dst[c] = texel[c];
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Public API: Build
+// ============================================================================
+
+bool TileCacheFile::Build(const std::string& filepath, const std::vector<Texture>& textures,
+                          u32 tileSize, u32 border) {
+    if (tileSize == 0 || border > tileSize) {
+        QL_LOG_ERROR("TileCacheFile::Build: Invalid tile size {} / border {}", tileSize, border);
+        return false;
+    }
+
+    // Lay out all textures first so the header can be written up front
+    std::vector<FileTextureEntry> entries(textures.size());
+    u64 tileCount = 0;
+    for (usize i = 0; i < textures.size(); ++i) {
+        const Texture& texture = textures[i];
+        TextureInfo info;
+        if (texture.IsValid()) {
+            info.width = texture.width;
+            info.height = texture.height;
+            info.mipCount = texture.GetMipCount();
+        } else {
+            info.width = 1;
+            info.height = 1;
+            info.mipCount = 1;
+        }
+        info.firstTile = tileCount;
+        tileCount += LayoutMips(info, tileSize);
+
+        entries[i] = FileTextureEntry{info.width, info.height, info.mipCount,
+                                      static_cast<u32>(texture.usage),
+                                      static_cast<u32>(texture.sampler.wrapS),
+                                      static_cast<u32>(texture.sampler.wrapT),
+                                      info.firstTile};
+    }
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        QL_LOG_ERROR("TileCacheFile::Build: Failed to open {} for writing", filepath);
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kTileCacheMagic, sizeof(header.magic));
+    header.version = kTileCacheVersion;
+    header.tileSize = tileSize;
+    header.border = border;
+    header.textureCount = static_cast<u32>(textures.size());
+    header.tileCount = tileCount;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(FileTextureEntry)));
+
+    const usize headerBytes = sizeof(FileHeader) + entries.size() * sizeof(FileTextureEntry);
+    const std::vector<char> padding(AlignUp(headerBytes, kTileDataAlignment) - headerBytes, 0);
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    // Tiles are extracted one tile row at a time (in parallel) and appended in order
+    const u32 stored = tileSize + 2 * border;
+    const usize tileBytes = static_cast<usize>(stored) * stored * 4;
+    std::vector<u8> rowBuffer;
+
+    for (const Texture& texture : textures) {
+        if (!texture.IsValid()) {
+            std::vector<u8> white(tileBytes, 255);
+            file.write(reinterpret_cast<const char*>(white.data()), static_cast<std::streamsize>(white.size()));
+            continue;
+        }
+
+        for (u32 mip = 0; mip < texture.GetMipCount(); ++mip) {
+            const u32 tilesX = TileCount1D(texture.GetMipWidth(mip), tileSize);
+            const u32 tilesY = TileCount1D(texture.GetMipHeight(mip), tileSize);
+            rowBuffer.resize(tilesX * tileBytes);
+
+            for (u32 tileY = 0; tileY < tilesY; ++tileY) {
+                ParallelFor(tilesX, 1, [&](usize tileX) {
+                    ExtractTile(texture, mip, static_cast<u32>(tileX), tileY,
+                                tileSize, border, rowBuffer.data() + tileX * tileBytes);
+                });
+                file.write(reinterpret_cast<const char*>(rowBuffer.data()),
+                           static_cast<std::streamsize>(rowBuffer.size()));
+            }
+        }
+    }
+
+    if (!file) {
+        QL_LOG_ERROR("TileCacheFile::Build: Write error on {}", filepath);
+        return false;
+    }
+
+    QL_LOG_INFO("TileCacheFile: Wrote {} tile(s) of {}x{} for {} texture(s) to {}",
+                tileCount, stored, stored, textures.size(), filepath);
+    return true;
+}
+
+// ============================================================================
+// Public API: Open / Close
+// ============================================================================
+
+TileCacheFile::~TileCacheFile() {
+    Close();
+}
+
+bool TileCacheFile::Open(const std::string& filepath) {
+    Close();
+
+#if defined(QL_WINDOWS)
+    HANDLE fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        QL_LOG_ERROR("TileCacheFile::Open: Failed to open {}", filepath);
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(fileHandle, &size);
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        CloseHandle(fileHandle);
+        QL_LOG_ERROR("TileCacheFile::Open: Failed to map {}", filepath);
+        return false;
+    }
+    m_fileHandle = fileHandle;
+    m_mappingHandle = mappingHandle;
+    m_fileSize = static_cast<usize>(size.QuadPart);
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        QL_LOG_ERROR("TileCacheFile::Open: Failed to open {}", filepath);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        QL_LOG_ERROR("TileCacheFile::Open: Failed to stat {}", filepath);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<usize>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        QL_LOG_ERROR("TileCacheFile::Open: Failed to map {}", filepath);
+        return false;
+    }
+    m_fd = fd;
+    m_fileSize = static_cast<usize>(st.st_size);
+#endif
+    m_data = static_cast<const u8*>(data);
+
+    // Validate header and texture table
+    FileHeader header{};
+    if (m_fileSize < sizeof(FileHeader)) {
+        QL_LOG_ERROR("TileCacheFile::Open: {} is truncated", filepath);
+        Close();
+        return false;
+    }
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, kTileCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != kTileCacheVersion) {
+        QL_LOG_ERROR("TileCacheFile::Open: {} is not a version {} tile cache", filepath, kTileCacheVersion);
+        Close();
+        return false;
+    }
+
+    const usize headerBytes = sizeof(FileHeader) + static_cast<usize>(header.textureCount) * sizeof(FileTextureEntry);
+    m_tileSize = header.tileSize;
+    m_border = header.border;
+    m_tileCount = header.tileCount;
+    m_tileDataOffset = AlignUp(headerBytes, kTileDataAlignment);
+
+    if (m_tileSize == 0 || m_fileSize < m_tileDataOffset + m_tileCount * GetTileBytes()) {
+        QL_LOG_ERROR("TileCacheFile::Open: {} is truncated", filepath);
+        Close();
+        return false;
+    }
+
+    m_textures.resize(header.textureCount);
+    for (u32 i = 0; i < header.textureCount; ++i) {
+        FileTextureEntry entry;
+        std::memcpy(&entry, m_data + sizeof(FileHeader) + i * sizeof(FileTextureEntry), sizeof(entry));
+
+        TextureInfo& info = m_textures[i];
+        info.width = entry.width;
+        info.height = entry.height;
+        info.mipCount = entry.mipCount;
+        info.usage = static_cast<TextureUsage>(entry.usage);
+        info.wrapS = static_cast<TextureSampler::WrapMode>(entry.wrapS);
+        info.wrapT = static_cast<TextureSampler::WrapMode>(entry.wrapT);
+        info.firstTile = entry.firstTile;
+        LayoutMips(info, m_tileSize);
+    }
+
+    QL_LOG_INFO("TileCacheFile: Mapped {} ({} texture(s), {} tile(s), {:.1f} MB)",
+                filepath, m_textures.size(), m_tileCount, static_cast<f64>(m_fileSize) / (1024.0 * 1024.0));
+    return true;
+}
+
+void TileCacheFile::Close() {
+    if (m_data) {
+#if defined(QL_WINDOWS)
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<u8*>(m_data), m_fileSize);
+#endif
+    }
+#if defined(QL_WINDOWS)
+    if (m_mappingHandle) {
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_fileHandle) {
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    }
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+    m_fd = -1;
+#endif
+
+    m_data = nullptr;
+    m_fileSize = 0;
+    m_tileDataOffset = 0;
+    m_tileCount = 0;
+    m_textures.clear();
+}
+
+// ============================================================================
+// Tile Lookup
+// ============================================================================
+
+u32 TileCacheFile::GetTilesX(u32 textureIndex, u32 mip) const {
+    return TileCount1D(MipExtent(m_textures[textureIndex].width, mip), m_tileSize);
+}
+
+u32 TileCacheFile::GetTilesY(u32 textureIndex, u32 mip) const {
+    return TileCount1D(MipExtent(m_textures[textureIndex].height, mip), m_tileSize);
+}
+
+u64 TileCacheFile::GetTileIndex(u32 textureIndex, u32 mip, u32 tileX, u32 tileY) const {
+    if (textureIndex >= m_textures.size() || mip >= m_textures[textureIndex].mipCount) {
+        return std::numeric_limits<u64>::max();
+    }
+    const u32 tilesX = GetTilesX(textureIndex, mip);
+    if (tileX >= tilesX || tileY >= GetTilesY(textureIndex, mip)) {
+        return std::numeric_limits<u64>::max();
+    }
+    return m_textures[textureIndex].mipFirstTile[mip] + static_cast<u64>(tileY) * tilesX + tileX;
+}
+
+const u8* TileCacheFile::GetTile(u32 textureIndex, u32 mip, u32 tileX, u32 tileY) const {
+    const u64 index = GetTileIndex(textureIndex, mip, tileX, tileY);
+    if (!m_data || index >= m_tileCount) {
+        return nullptr;
+    }
+    return m_data + m_tileDataOffset + index * GetTileBytes();
+}
+
+} // namespace quantiloom
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "scene/Texture.hpp"
+#include <string>
+#include <vector>
+
+namespace quantiloom {
+
+// ============================================================================
+// TileCacheFile - Memory-mapped tile store for virtual texturing
+// ============================================================================
+// Splits every mip level of every texture into fixed-size RGBA8 tiles and
+// writes them to a single binary file. At runtime the file is memory-mapped
+// read-only, so streaming a tile is a pointer lookup and the OS page cache
+// decides what actually stays in memory (texture sets may exceed RAM).
+//
+// Each stored tile is (tileSize + 2*border)^2 texels: the border duplicates
+// neighbouring texels (honouring the texture's wrap modes) so that a GPU
+// physical tile pool can be sampled bilinearly/anisotropically without
+// seams. Mip levels smaller than a tile occupy one (partially filled) tile.
+//
+// File layout (little-endian, all offsets in bytes):
+//   Header                  - magic "QLVT", version, tile size, border,
+//                             texture count, total tile count
+//   TextureEntry[count]     - width, height, mip count, usage, wrap modes,
+//                             index of the texture's first tile
+//   <padding to 4 KiB>
+//   tiles                   - fixed-size RGBA8 tiles, ordered by texture,
+//                             then mip level, then row-major tile index
+//
+// Texel values are stored as-is (sRGB-encoded for Color textures); decoding
+// happens at sample time, like the non-virtual path.
+//
+// Usage:
+//   TileCacheFile::Build("scene.qlvt", scene.textures);
+//
+//   TileCacheFile file;
+//   if (file.Open("scene.qlvt")) {
+//       const u8* tile = file.GetTile(textureIndex, mip, tileX, tileY);
+//   }
+// ============================================================================
+
+class QL_API TileCacheFile {
+public:
+    static constexpr u32 DEFAULT_TILE_SIZE = 128;
+    static constexpr u32 DEFAULT_BORDER = 4;
+
+    struct TextureInfo {
+        u32 width = 0;
+        u32 height = 0;
+        u32 mipCount = 0;
+        TextureUsage usage = TextureUsage::Data;
+        TextureSampler::WrapMode wrapS = TextureSampler::WrapMode::Repeat;
+        TextureSampler::WrapMode wrapT = TextureSampler::WrapMode::Repeat;
+        u64 firstTile = 0;                // Global index of (mip 0, tile 0, 0)
+        std::vector<u64> mipFirstTile;    // Global index of each level's first tile
+    };
+
+    TileCacheFile() = default;
+    ~TileCacheFile();
+
+    TileCacheFile(const TileCacheFile&) = delete;
+    TileCacheFile& operator=(const TileCacheFile&) = delete;
+
+    // Write a tile cache for all textures (overwrites the file)
+    // Uses each texture's existing mip chain; invalid textures get one white tile
+    static bool Build(const std::string& filepath, const std::vector<Texture>& textures,
+                      u32 tileSize = DEFAULT_TILE_SIZE, u32 border = DEFAULT_BORDER);
+
+    // Map a tile cache file read-only (closes any previously opened file)
+    bool Open(const std::string& filepath);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // Layout queries
+    u32 GetTileSize() const { return m_tileSize; }
+    u32 GetBorder() const { return m_border; }
+    u32 GetStoredTileSize() const { return m_tileSize + 2 * m_border; }
+    usize GetTileBytes() const { return static_cast<usize>(GetStoredTileSize()) * GetStoredTileSize() * 4; }
+    u64 GetTileCount() const { return m_tileCount; }
+    u32 GetTextureCount() const { return static_cast<u32>(m_textures.size()); }
+    const TextureInfo& GetTextureInfo(u32 textureIndex) const { return m_textures[textureIndex]; }
+
+    // Tile grid of a mip level
+    u32 GetTilesX(u32 textureIndex, u32 mip) const;
+    u32 GetTilesY(u32 textureIndex, u32 mip) const;
+
+    // Global tile index, or UINT64_MAX if out of range
+    u64 GetTileIndex(u32 textureIndex, u32 mip, u32 tileX, u32 tileY) const;
+
+    // Pointer to a stored tile (RGBA8, GetStoredTileSize()^2 texels), nullptr if out of range
+    const u8* GetTile(u32 textureIndex, u32 mip, u32 tileX, u32 tileY) const;
+
+private:
+    const u8* m_data = nullptr;
+    usize m_fileSize = 0;
+    usize m_tileDataOffset = 0;
+#if defined(QL_WINDOWS)
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    u32 m_tileSize = 0;
+    u32 m_border = 0;
+    u64 m_tileCount = 0;
+    std::vector<TextureInfo> m_textures;
+};
+
+} // namespace quantiloom
@@ -0,0 +1,272 @@
+#include "AtrousDenoiser.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quantiloom {
+
+// B3 spline taps (1/16, 1/4, 3/8, 1/4, 1/16)
+static constexpr f32 kB3[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+
+// Albedo below this is treated as 1 when demodulating (background, black)
+static constexpr f32 kMinAlbedo = 1e-3f;
+
+// ============================================================================
+// AovBuffers
+// ============================================================================
+
+AovBuffers AovBuffers::Unpack(const std::vector<f32>& packedRgba, u32 width, u32 height) {
+    AovBuffers aovs;
+    aovs.width = width;
+    aovs.height = height;
+    const usize pixels = static_cast<usize>(width) * height;
+    aovs.albedo.resize(pixels);
+    aovs.depth.resize(pixels);
+    aovs.normal.resize(pixels * 3, 0.0f);
+
+    for (usize p = 0; p < pixels; ++p) {
+        const f32* texel = &packedRgba[p * 4];
+        aovs.albedo[p] = texel[0];
+        aovs.depth[p] = texel[1];
+        if (texel[1] <= 0.0f) {
+            continue;  // Miss: zero normal
+        }
+
+        // Octahedral decode (inverse of OctahedralEncode in common.hlsli)
+        f32 x = texel[2];
+        f32 y = texel[3];
+        const f32 z = 1.0f - std::abs(x) - std::abs(y);
+        const f32 fold = std::max(-z, 0.0f);
+        x += (x >= 0.0f) ? -fold : fold;
+        y += (y >= 0.0f) ? -fold : fold;
+        const f32 length = std::sqrt(x * x + y * y + z * z);
+        if (length > 0.0f) {
+            aovs.normal[p * 3 + 0] = x / length;
+            aovs.normal[p * 3 + 1] = y / length;
+            aovs.normal[p * 3 + 2] = z / length;
+        }
+    }
+    return aovs;
+}
+
+std::optional<AovBuffers> AovBuffers::FromImage(const Image& image) {
+    auto find = [&](const char* name) -> i32 {
+        auto it = std::find(image.channelNames.begin(), image.channelNames.end(), name);
+        return (it != image.channelNames.end()) ? static_cast<i32>(it - image.channelNames.begin()) : -1;
+    };
+    const i32 albedo = find(ALBEDO_CHANNEL);
+    const i32 nx = find(NORMAL_X_CHANNEL);
+    const i32 ny = find(NORMAL_Y_CHANNEL);
+    const i32 nz = find(NORMAL_Z_CHANNEL);
+    const i32 depth = find(DEPTH_CHANNEL);
+    if (albedo < 0 || nx < 0 || ny < 0 || nz < 0 || depth < 0) {
+        return std::nullopt;
+    }
+
+    AovBuffers aovs;
+    aovs.width = image.width;
+    aovs.height = image.height;
+    const usize pixels = image.PixelCount();
+    aovs.albedo.resize(pixels);
+    aovs.normal.resize(pixels * 3);
+    aovs.depth.resize(pixels);
+    for (usize p = 0; p < pixels; ++p) {
+        const f32* texel = &image.data[p * image.channels];
+        aovs.albedo[p] = texel[albedo];
+        aovs.normal[p * 3 + 0] = texel[nx];
+        aovs.normal[p * 3 + 1] = texel[ny];
+        aovs.normal[p * 3 + 2] = texel[nz];
+        aovs.depth[p] = texel[depth];
+    }
+    return aovs;
+}
+
+void AovBuffers::AppendTo(Image& image) const {
+    const u32 oldChannels = image.channels;
+    const u32 newChannels = oldChannels + 5;
+    std::vector<f32> data(static_cast<usize>(image.PixelCount()) * newChannels);
+
+    for (usize p = 0; p < image.PixelCount(); ++p) {
+        const f32* src = &image.data[p * oldChannels];
+        f32* dst = &data[p * newChannels];
+        std::copy(src, src + oldChannels, dst);
+        dst[oldChannels + 0] = albedo[p];
+        dst[oldChannels + 1] = normal[p * 3 + 0];
+        dst[oldChannels + 2] = normal[p * 3 + 1];
+        dst[oldChannels + 3] = normal[p * 3 + 2];
+        dst[oldChannels + 4] = depth[p];
+    }
+
+    image.data = std::move(data);
+    image.channels = newChannels;
+    image.channelNames.resize(oldChannels);
+    image.channelNames.insert(image.channelNames.end(),
+                              {ALBEDO_CHANNEL, NORMAL_X_CHANNEL, NORMAL_Y_CHANNEL, NORMAL_Z_CHANNEL, DEPTH_CHANNEL});
+}
+
+bool AovBuffers::IsAovChannel(const std::string& name) {
+    return name == ALBEDO_CHANNEL || name == NORMAL_X_CHANNEL || name == NORMAL_Y_CHANNEL ||
+           name == NORMAL_Z_CHANNEL || name == DEPTH_CHANNEL;
+}
+
+// ============================================================================
+// DenoiseBand
+// ============================================================================
+
+void AtrousDenoiser::DenoiseBand(f32* band, const AovBuffers& aovs, const DenoiseParameters& params) {
+    const u32 width = aovs.width;
+    const u32 height = aovs.height;
+    const usize pixels = static_cast<usize>(width) * height;
+
+    // Planar guides so every tap loop reads contiguous memory
+    std::vector<f32> nx(pixels), ny(pixels), nz(pixels);
+    std::vector<f32> depthScale(pixels);  // 1 / (sigmaDepth * z)^2
+    for (usize p = 0; p < pixels; ++p) {
+        nx[p] = aovs.normal[p * 3 + 0];
+        ny[p] = aovs.normal[p * 3 + 1];
+        nz[p] = aovs.normal[p * 3 + 2];
+        const f32 z = std::max(aovs.depth[p], 1e-4f);
+        depthScale[p] = 1.0f / (params.sigmaDepth * params.sigmaDepth * z * z);
+    }
+
+    // Demodulate: filter lighting, not texture
+    std::vector<f32> current(pixels);
+    std::vector<f32> modulation(pixels, 1.0f);
+    f64 originalSum = 0.0;
+    for (usize p = 0; p < pixels; ++p) {
+        if (params.demodulateAlbedo && aovs.albedo[p] > kMinAlbedo) {
+            modulation[p] = aovs.albedo[p];
+        }
+        current[p] = band[p] / modulation[p];
+        originalSum += band[p];
+    }
+
+    f64 absSum = 0.0;
+    for (f32 v : current) {
+        absSum += std::abs(v);
+    }
+    const f32 valueScale = std::max(static_cast<f32>(absSum / static_cast<f64>(pixels)), 1e-12f);
+    const f32 invSigmaNormal2 = 1.0f / (params.sigmaNormal * params.sigmaNormal);
+
+    std::vector<f32> next(pixels);
+    for (u32 iteration = 0; iteration < params.iterations; ++iteration) {
+        const i32 step = 1 << iteration;
+        const f32 sigmaColor = params.sigmaColor * valueScale / static_cast<f32>(step);
+        const f32 invSigmaColor2 = 1.0f / (sigmaColor * sigmaColor);
+
+        ParallelFor(height, 4, [&](usize yIndex) {
+            const i32 y = static_cast<i32>(yIndex);
+            const usize row = yIndex * width;
+            std::vector<f32> sum(width, 0.0f);
+            std::vector<f32> weightSum(width, 0.0f);
+
+            for (i32 ty = 0; ty < 5; ++ty) {
+                const i32 sy = y + (ty - 2) * step;
+                if (sy < 0 || sy >= static_cast<i32>(height)) {
+                    continue;
+                }
+                for (i32 tx = 0; tx < 5; ++tx) {
+                    const i32 offset = (tx - 2) * step;
+                    const u32 xBegin = static_cast<u32>(std::max(0, -offset));
+                    const u32 xEnd = static_cast<u32>(std::clamp(static_cast<i32>(width) - offset, 0, static_cast<i32>(width)));
+                    const f32 tapWeight = kB3[ty] * kB3[tx];
+                    const isize tapRow = static_cast<isize>(sy) * width + offset;
+
+                    for (u32 x = xBegin; x < xEnd; ++x) {
+                        const usize p = row + x;
+                        const usize q = static_cast<usize>(tapRow + x);
+                        const f32 dc = current[q] - current[p];
+                        const f32 dnx = nx[q] - nx[p];
+                        const f32 dny = ny[q] - ny[p];
+                        const f32 dnz = nz[q] - nz[p];
+                        const f32 dz = aovs.depth[q] - aovs.depth[p];
+                        const f32 exponent = dc * dc * invSigmaColor2 +
+                                             (dnx * dnx + dny * dny + dnz * dnz) * invSigmaNormal2 +
+                                             dz * dz * depthScale[p];
+                        const f32 w = tapWeight * std::exp(-exponent);
+                        sum[x] += w * current[q];
+                        weightSum[x] += w;
+                    }
+                }
+            }
+
+            // The centre tap always has weight > 0
+            for (u32 x = 0; x < width; ++x) {
+                next[row + x] = sum[x] / weightSum[x];
+            }
+        });
+
+        current.swap(next);
+    }
+
+    // Remodulate, then restore the band mean
+    f64 filteredSum = 0.0;
+    for (usize p = 0; p < pixels; ++p) {
+        band[p] = current[p] * modulation[p];
+        filteredSum += band[p];
+    }
+    if (params.preserveMean && filteredSum > 0.0 && originalSum > 0.0) {
+        const f32 correction = static_cast<f32>(originalSum / filteredSum);
+        for (usize p = 0; p < pixels; ++p) {
+            band[p] *= correction;
+        }
+    }
+}
+
+// ============================================================================
+// Apply
+// ============================================================================
+
+bool AtrousDenoiser::Apply(Image& image, const DenoiseParameters& params) {
+    std::optional<AovBuffers> aovs = AovBuffers::FromImage(image);
+    if (!aovs.has_value()) {
+        QL_LOG_ERROR("AtrousDenoiser::Apply: Image has no AOV channels (albedo, N.X, N.Y, N.Z, Z)");
+        return false;
+    }
+    return Apply(image, aovs.value(), params);
+}
+
+bool AtrousDenoiser::Apply(Image& image, const AovBuffers& aovs, const DenoiseParameters& params) {
+    if (!aovs.IsValid() || aovs.width != image.width || aovs.height != image.height) {
+        QL_LOG_ERROR("AtrousDenoiser::Apply: AOVs ({}x{}) do not match the image ({}x{})",
+                     aovs.width, aovs.height, image.width, image.height);
+        return false;
+    }
+
+    std::vector<f32> plane(image.PixelCount());
+    for (u32 c = 0; c < image.channels; ++c) {
+        const std::string& name = (c < image.channelNames.size()) ? image.channelNames[c] : std::string();
+        if (name == "A" || AovBuffers::IsAovChannel(name)) {
+            continue;
+        }
+
+        for (u32 i = 0; i < image.PixelCount(); ++i) {
+            plane[i] = image.data[static_cast<usize>(i) * image.channels + c];
+        }
+        DenoiseBand(plane.data(), aovs, params);
+        for (u32 i = 0; i < image.PixelCount(); ++i) {
+            image.data[static_cast<usize>(i) * image.channels + c] = plane[i];
+        }
+    }
+
+    image.metadata["denoiser"] = "atrous";
+    return true;
+}
+
+bool AtrousDenoiser::Apply(SpectralCube& cube, const AovBuffers& aovs, const DenoiseParameters& params) {
+    if (!aovs.IsValid() || aovs.width != cube.width || aovs.height != cube.height) {
+        QL_LOG_ERROR("AtrousDenoiser::Apply: AOVs ({}x{}) do not match the cube ({}x{})",
+                     aovs.width, aovs.height, cube.width, cube.height);
+        return false;
+    }
+
+    for (u32 b = 0; b < cube.nbands; ++b) {
+        DenoiseBand(cube.BandPtr(b), aovs, params);
+    }
+    cube.metadata["denoiser"] = "atrous";
+    return true;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "core/Image.hpp"
+#include "core/SpectralCube.hpp"
+#include <optional>
+#include <vector>
+
+// ============================================================================
+// AtrousDenoiser - Edge-avoiding a-trous wavelet filter for MS-RT previews
+// ============================================================================
+// Dammertz et al., "Edge-Avoiding A-Trous Wavelet Transform for fast Global
+// Illumination Filtering" (HPG 2010). Each iteration applies the 5x5 B3
+// spline kernel with holes (tap spacing 1, 2, 4, ...), weighting every tap
+// by how similar it is to the centre pixel in
+//   - value     exp(-|c_p - c_q|^2 / sigmaColor^2)  (sigma halves per pass)
+//   - normal    exp(-|n_p - n_q|^2 / sigmaNormal^2)
+//   - depth     exp(-((z_p - z_q) / z_p)^2 / sigmaDepth^2)
+// The guides come from the first-hit AOVs the renderer writes (binding 11).
+//
+// Radiometric bias:
+//   - Values are divided by the albedo before filtering and multiplied back
+//     after, so texture detail is not smeared (only lighting is filtered)
+//   - Every pass is a normalised convex combination: no new extrema
+//   - preserveMean rescales each band so its mean radiance is unchanged
+// The filter is still biased locally. It is opt-in ([denoise] enabled) and
+// must stay off for validation runs against reference data.
+//
+// Each pass walks rows in parallel; per tap the row loop is contiguous and
+// branch-free (out-of-image taps are clipped from the x range), so it
+// vectorises.
+// ============================================================================
+
+namespace quantiloom {
+
+// ============================================================================
+// AovBuffers - First-hit auxiliary buffers (denoiser guides)
+// ============================================================================
+struct QL_API AovBuffers {
+    // Channel names used when the AOVs travel inside an Image
+    static constexpr const char* ALBEDO_CHANNEL = "albedo";
+    static constexpr const char* NORMAL_X_CHANNEL = "N.X";
+    static constexpr const char* NORMAL_Y_CHANNEL = "N.Y";
+    static constexpr const char* NORMAL_Z_CHANNEL = "N.Z";
+    static constexpr const char* DEPTH_CHANNEL = "Z";
+
+    u32 width = 0;
+    u32 height = 0;
+    std::vector<f32> albedo;  // [pixel]
+    std::vector<f32> normal;  // [pixel][3], world space, zero where the ray missed
+    std::vector<f32> depth;   // [pixel], hit distance, zero where the ray missed
+
+    bool IsValid() const {
+        const usize pixels = static_cast<usize>(width) * height;
+        return pixels > 0 && albedo.size() == pixels && normal.size() == pixels * 3 && depth.size() == pixels;
+    }
+
+    // From the GPU AOV image (RGBA: albedo, depth, octahedral normal)
+    static AovBuffers Unpack(const std::vector<f32>& packedRgba, u32 width, u32 height);
+
+    // From the named channels of an Image (nullopt if any is missing)
+    static std::optional<AovBuffers> FromImage(const Image& image);
+
+    // Append the AOVs to an Image as named channels
+    void AppendTo(Image& image) const;
+
+    // True for the AOV channel names (not radiance)
+    static bool IsAovChannel(const std::string& name);
+};
+
+struct QL_API DenoiseParameters {
+    u32 iterations = 5;           // Tap spacing 1..2^(iterations-1)
+    f32 sigmaColor = 2.0f;        // Relative to the band's mean value
+    f32 sigmaNormal = 0.3f;
+    f32 sigmaDepth = 0.05f;       // Relative depth difference
+    bool demodulateAlbedo = true;
+    bool preserveMean = true;
+};
+
+class QL_API AtrousDenoiser {
+public:
+    // Filter one band in place
+    static void DenoiseBand(f32* band, const AovBuffers& aovs, const DenoiseParameters& params);
+
+    // Filter every radiance channel of an image that carries its own AOV
+    // channels (alpha and AOV channels are left untouched)
+    static bool Apply(Image& image, const DenoiseParameters& params);
+
+    // Same with separate guides (e.g. an image without AOV channels)
+    static bool Apply(Image& image, const AovBuffers& aovs, const DenoiseParameters& params);
+
+    // Filter every band of a cube rendered with the same camera as the AOVs
+    static bool Apply(SpectralCube& cube, const AovBuffers& aovs, const DenoiseParameters& params);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,91 @@
+#include "Fft.hpp"
+#include "core/Parallel.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace quantiloom {
+
+usize Fft::NextPowerOfTwo(usize n) {
+    usize p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+void Fft::Transform(Complex* data, usize n, bool inverse) {
+    if (n < 2) {
+        return;
+    }
+
+    // Bit-reversal permutation
+    for (usize i = 1, j = 0; i < n; ++i) {
+        usize bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // Butterflies; the twiddle of each stage is advanced by a double-precision rotation
+    const f64 sign = inverse ? 1.0 : -1.0;
+    for (usize length = 2; length <= n; length <<= 1) {
+        const f64 angle = sign * 2.0 * constants::PI / static_cast<f64>(length);
+        const std::complex<f64> step(std::cos(angle), std::sin(angle));
+        const usize half = length / 2;
+
+        for (usize start = 0; start < n; start += length) {
+            std::complex<f64> w(1.0, 0.0);
+            for (usize k = 0; k < half; ++k) {
+                const Complex twiddle(static_cast<f32>(w.real()), static_cast<f32>(w.imag()));
+                const Complex u = data[start + k];
+                const Complex v = data[start + k + half] * twiddle;
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+                w *= step;
+            }
+        }
+    }
+
+    if (inverse) {
+        const f32 scale = 1.0f / static_cast<f32>(n);
+        for (usize i = 0; i < n; ++i) {
+            data[i] *= scale;
+        }
+    }
+}
+
+void Fft::Transform2D(Complex* data, usize width, usize height, bool inverse, bool parallel) {
+    // Rows are contiguous
+    auto transformRow = [&](usize y) { Transform(data + y * width, width, inverse); };
+
+    // Columns go through a contiguous scratch copy
+    auto transformColumn = [&](usize x) {
+        std::vector<Complex> column(height);
+        for (usize y = 0; y < height; ++y) {
+            column[y] = data[y * width + x];
+        }
+        Transform(column.data(), height, inverse);
+        for (usize y = 0; y < height; ++y) {
+            data[y * width + x] = column[y];
+        }
+    };
+
+    if (parallel) {
+        ParallelFor(height, 16, transformRow);
+        ParallelFor(width, 16, transformColumn);
+    } else {
+        for (usize y = 0; y < height; ++y) {
+            transformRow(y);
+        }
+        for (usize x = 0; x < width; ++x) {
+            transformColumn(x);
+        }
+    }
+}
+
+} // namespace quantiloom
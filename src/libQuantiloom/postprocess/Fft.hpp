@@ -0,0 +1,42 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include <complex>
+#include <vector>
+
+// ============================================================================
+// Fft - Radix-2 complex FFT for image-sized post-processing
+// ============================================================================
+// Iterative in-place Cooley-Tukey transform for power-of-two lengths, with
+// a 2D variant over row-major data (rows first, then columns). Twiddle
+// factors are computed in double precision per call.
+//
+// Convention: forward uses exp(-2 pi i k n / N); the inverse is scaled by
+// 1/N so Inverse(Forward(x)) == x.
+//
+// Usage:
+//   std::vector<std::complex<f32>> grid(w * h);   // w, h powers of two
+//   Fft::Transform2D(grid.data(), w, h, false);
+//   ... multiply by a transfer function ...
+//   Fft::Transform2D(grid.data(), w, h, true);
+// ============================================================================
+
+namespace quantiloom {
+
+class QL_API Fft {
+public:
+    using Complex = std::complex<f32>;
+
+    static bool IsPowerOfTwo(usize n) { return n != 0 && (n & (n - 1)) == 0; }
+    static usize NextPowerOfTwo(usize n);
+
+    // In-place 1D transform of n contiguous values (n must be a power of two)
+    static void Transform(Complex* data, usize n, bool inverse);
+
+    // In-place 2D transform of a [height][width] grid (both powers of two).
+    // Rows and columns are distributed over threads when parallel is set.
+    static void Transform2D(Complex* data, usize width, usize height, bool inverse, bool parallel = true);
+};
+
+} // namespace quantiloom
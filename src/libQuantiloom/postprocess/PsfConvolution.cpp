@@ -0,0 +1,436 @@
+#include "PsfConvolution.hpp"
+#include "Fft.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quantiloom {
+
+// Rows per tile for the spatial-domain paths
+static constexpr u32 kTileRows = 32;
+
+static inline u32 ClampIndex(i64 i, u32 n) {
+    return static_cast<u32>(std::clamp<i64>(i, 0, static_cast<i64>(n) - 1));
+}
+
+// ============================================================================
+// PsfKernel
+// ============================================================================
+
+PsfKernel PsfKernel::Gaussian(f32 sigmaX, f32 sigmaY, f32 truncateSigmas) {
+    auto makeFactor = [&](f32 sigma) {
+        if (sigma <= 0.0f) {
+            return std::vector<f32>{1.0f};
+        }
+        const i32 radius = std::max(1, static_cast<i32>(std::ceil(truncateSigmas * sigma)));
+        std::vector<f32> factor(static_cast<usize>(2 * radius + 1));
+        f64 sum = 0.0;
+        for (i32 i = -radius; i <= radius; ++i) {
+            const f64 w = std::exp(-0.5 * (static_cast<f64>(i) * i) / (static_cast<f64>(sigma) * sigma));
+            factor[static_cast<usize>(i + radius)] = static_cast<f32>(w);
+            sum += w;
+        }
+        for (f32& w : factor) {
+            w = static_cast<f32>(w / sum);
+        }
+        return factor;
+    };
+
+    PsfKernel kernel;
+    kernel.rowFactor = makeFactor(sigmaX);
+    kernel.columnFactor = makeFactor(sigmaY);
+    kernel.width = static_cast<u32>(kernel.rowFactor.size());
+    kernel.height = static_cast<u32>(kernel.columnFactor.size());
+    kernel.weights.resize(static_cast<usize>(kernel.width) * kernel.height);
+    for (u32 y = 0; y < kernel.height; ++y) {
+        for (u32 x = 0; x < kernel.width; ++x) {
+            kernel.weights[y * kernel.width + x] = kernel.columnFactor[y] * kernel.rowFactor[x];
+        }
+    }
+    return kernel;
+}
+
+PsfKernel PsfKernel::Airy(f32 wavelengthNm, f32 fNumber, f32 pixelPitchUm, u32 radius) {
+    // Airy pattern I(r) = (2 J1(x) / x)^2 with x = pi r / (lambda N)
+    const f64 lambdaN = static_cast<f64>(wavelengthNm) * 1e-3 * fNumber;  // um
+    if (radius == 0) {
+        // Third dark ring at r = 3.238 lambda N
+        radius = std::max(1u, static_cast<u32>(std::ceil(3.238 * lambdaN / pixelPitchUm)));
+    }
+
+    constexpr u32 kSubsamples = 5;  // Per pixel axis, integrates over the pixel area
+    const u32 size = 2 * radius + 1;
+    std::vector<f32> weights(static_cast<usize>(size) * size);
+    for (u32 py = 0; py < size; ++py) {
+        for (u32 px = 0; px < size; ++px) {
+            f64 sum = 0.0;
+            for (u32 sy = 0; sy < kSubsamples; ++sy) {
+                for (u32 sx = 0; sx < kSubsamples; ++sx) {
+                    const f64 dx = (static_cast<f64>(px) - radius + (sx + 0.5) / kSubsamples - 0.5) * pixelPitchUm;
+                    const f64 dy = (static_cast<f64>(py) - radius + (sy + 0.5) / kSubsamples - 0.5) * pixelPitchUm;
+                    const f64 x = constants::PI * std::sqrt(dx * dx + dy * dy) / lambdaN;
+                    const f64 amplitude = (x < 1e-8) ? 1.0 : 2.0 * std::cyl_bessel_j(1.0, x) / x;
+                    sum += amplitude * amplitude;
+                }
+            }
+            weights[py * size + px] = static_cast<f32>(sum);
+        }
+    }
+
+    return FromWeights(size, size, std::move(weights));
+}
+
+PsfKernel PsfKernel::FromWeights(u32 width, u32 height, std::vector<f32> weights) {
+    PsfKernel kernel;
+    if (!(width & 1) || !(height & 1) || weights.size() != static_cast<usize>(width) * height) {
+        QL_LOG_ERROR("PsfKernel::FromWeights: Kernel must be odd-sized with width * height weights");
+        return kernel;
+    }
+
+    f64 sum = 0.0;
+    for (f32 w : weights) {
+        sum += w;
+    }
+    if (sum != 0.0) {
+        for (f32& w : weights) {
+            w = static_cast<f32>(w / sum);
+        }
+    }
+
+    kernel.width = width;
+    kernel.height = height;
+    kernel.weights = std::move(weights);
+
+    // Rank-1 test: factor through the largest weight and check the residual
+    const auto peak = std::max_element(kernel.weights.begin(), kernel.weights.end(),
+                                       [](f32 a, f32 b) { return std::abs(a) < std::abs(b); });
+    const usize peakIndex = static_cast<usize>(peak - kernel.weights.begin());
+    const u32 px = static_cast<u32>(peakIndex % width);
+    const u32 py = static_cast<u32>(peakIndex / width);
+    const f32 peakValue = *peak;
+    if (peakValue == 0.0f) {
+        return kernel;
+    }
+
+    std::vector<f32> row(kernel.weights.begin() + static_cast<usize>(py) * width,
+                         kernel.weights.begin() + static_cast<usize>(py + 1) * width);
+    std::vector<f32> column(height);
+    for (u32 y = 0; y < height; ++y) {
+        column[y] = kernel.weights[y * width + px] / peakValue;
+    }
+
+    const f32 tolerance = 1e-5f * std::abs(peakValue);
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            if (std::abs(kernel.weights[y * width + x] - column[y] * row[x]) > tolerance) {
+                return kernel;
+            }
+        }
+    }
+
+    // Separable: rescale so each factor sums to 1 (their product sums to 1)
+    f64 rowSum = 0.0;
+    for (f32 w : row) {
+        rowSum += w;
+    }
+    if (rowSum != 0.0) {
+        for (f32& w : row) {
+            w = static_cast<f32>(w / rowSum);
+        }
+        for (f32& w : column) {
+            w = static_cast<f32>(w * rowSum);
+        }
+    }
+    kernel.rowFactor = std::move(row);
+    kernel.columnFactor = std::move(column);
+    return kernel;
+}
+
+// ============================================================================
+// Spatial-domain paths (row tiles with halo)
+// ============================================================================
+
+// Copy source row sy into padded[0, width + 2 * radius) with replicated edges
+static void LoadPaddedRow(const f32* src, u32 width, u32 sy, u32 radius, f32* padded) {
+    const f32* row = src + static_cast<usize>(sy) * width;
+    std::fill(padded, padded + radius, row[0]);
+    std::copy(row, row + width, padded + radius);
+    std::fill(padded + radius + width, padded + 2 * radius + width, row[width - 1]);
+}
+
+static void ConvolveSeparable(const f32* src, f32* dst, u32 width, u32 height,
+                              const PsfKernel& kernel, bool parallel) {
+    const u32 rx = kernel.RadiusX();
+    const u32 ry = kernel.RadiusY();
+
+    // Flipped factors turn the convolution into contiguous multiply-adds
+    std::vector<f32> kx(kernel.rowFactor.rbegin(), kernel.rowFactor.rend());
+    std::vector<f32> ky(kernel.columnFactor.rbegin(), kernel.columnFactor.rend());
+
+    const u32 tileCount = (height + kTileRows - 1) / kTileRows;
+    auto processTile = [&](usize tile) {
+        const u32 y0 = static_cast<u32>(tile) * kTileRows;
+        const u32 y1 = std::min(height, y0 + kTileRows);
+        const u32 rows = y1 - y0 + 2 * ry;
+
+        std::vector<f32> padded(width + 2 * rx);
+        std::vector<f32> horizontal(static_cast<usize>(rows) * width, 0.0f);
+
+        // Horizontal pass over the tile rows plus the vertical halo
+        for (u32 r = 0; r < rows; ++r) {
+            LoadPaddedRow(src, width, ClampIndex(static_cast<i64>(y0) - ry + r, height), rx, padded.data());
+            f32* out = horizontal.data() + static_cast<usize>(r) * width;
+            for (u32 i = 0; i < kx.size(); ++i) {
+                const f32 k = kx[i];
+                const f32* in = padded.data() + i;
+                for (u32 x = 0; x < width; ++x) {
+                    out[x] += k * in[x];
+                }
+            }
+        }
+
+        // Vertical pass
+        for (u32 y = y0; y < y1; ++y) {
+            f32* out = dst + static_cast<usize>(y) * width;
+            std::fill(out, out + width, 0.0f);
+            for (u32 i = 0; i < ky.size(); ++i) {
+                const f32 k = ky[i];
+                const f32* in = horizontal.data() + static_cast<usize>(y - y0 + i) * width;
+                for (u32 x = 0; x < width; ++x) {
+                    out[x] += k * in[x];
+                }
+            }
+        }
+    };
+
+    if (parallel) {
+        ParallelFor(tileCount, 1, processTile);
+    } else {
+        for (u32 tile = 0; tile < tileCount; ++tile) {
+            processTile(tile);
+        }
+    }
+}
+
+static void ConvolveDirect(const f32* src, f32* dst, u32 width, u32 height,
+                           const PsfKernel& kernel, bool parallel) {
+    const u32 rx = kernel.RadiusX();
+    const u32 ry = kernel.RadiusY();
+    const u32 paddedWidth = width + 2 * rx;
+    const std::vector<f32> flipped(kernel.weights.rbegin(), kernel.weights.rend());
+
+    const u32 tileCount = (height + kTileRows - 1) / kTileRows;
+    auto processTile = [&](usize tile) {
+        const u32 y0 = static_cast<u32>(tile) * kTileRows;
+        const u32 y1 = std::min(height, y0 + kTileRows);
+        const u32 rows = y1 - y0 + 2 * ry;
+
+        std::vector<f32> block(static_cast<usize>(rows) * paddedWidth);
+        for (u32 r = 0; r < rows; ++r) {
+            LoadPaddedRow(src, width, ClampIndex(static_cast<i64>(y0) - ry + r, height), rx,
+                          block.data() + static_cast<usize>(r) * paddedWidth);
+        }
+
+        for (u32 y = y0; y < y1; ++y) {
+            f32* out = dst + static_cast<usize>(y) * width;
+            std::fill(out, out + width, 0.0f);
+            for (u32 j = 0; j < kernel.height; ++j) {
+                const f32* inRow = block.data() + static_cast<usize>(y - y0 + j) * paddedWidth;
+                for (u32 i = 0; i < kernel.width; ++i) {
+                    const f32 k = flipped[j * kernel.width + i];
+                    const f32* in = inRow + i;
+                    for (u32 x = 0; x < width; ++x) {
+                        out[x] += k * in[x];
+                    }
+                }
+            }
+        }
+    };
+
+    if (parallel) {
+        ParallelFor(tileCount, 1, processTile);
+    } else {
+        for (u32 tile = 0; tile < tileCount; ++tile) {
+            processTile(tile);
+        }
+    }
+}
+
+// ============================================================================
+// Frequency-domain paths
+// ============================================================================
+
+// Edge-replicated band on a power-of-two grid; the band starts at (marginX, marginY)
+static std::vector<Fft::Complex> LoadPaddedGrid(const f32* src, u32 width, u32 height,
+                                                u32 marginX, u32 marginY, usize gridWidth, usize gridHeight) {
+    std::vector<Fft::Complex> grid(gridWidth * gridHeight);
+    for (usize gy = 0; gy < gridHeight; ++gy) {
+        const u32 sy = ClampIndex(static_cast<i64>(gy) - marginY, height);
+        for (usize gx = 0; gx < gridWidth; ++gx) {
+            const u32 sx = ClampIndex(static_cast<i64>(gx) - marginX, width);
+            grid[gy * gridWidth + gx] = Fft::Complex(src[static_cast<usize>(sy) * width + sx], 0.0f);
+        }
+    }
+    return grid;
+}
+
+static void StoreCroppedGrid(const std::vector<Fft::Complex>& grid, usize gridWidth,
+                             u32 marginX, u32 marginY, u32 width, u32 height, f32* dst) {
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            dst[static_cast<usize>(y) * width + x] = grid[(y + marginY) * gridWidth + x + marginX].real();
+        }
+    }
+}
+
+static void ConvolveFft(const f32* src, f32* dst, u32 width, u32 height,
+                        const PsfKernel& kernel, bool parallel) {
+    const u32 rx = kernel.RadiusX();
+    const u32 ry = kernel.RadiusY();
+
+    // Outputs read the padded band within [0, width + 2r): no circular wrap-around
+    const usize gridWidth = Fft::NextPowerOfTwo(width + 2 * rx);
+    const usize gridHeight = Fft::NextPowerOfTwo(height + 2 * ry);
+
+    std::vector<Fft::Complex> grid = LoadPaddedGrid(src, width, height, rx, ry, gridWidth, gridHeight);
+
+    // Kernel centred on the origin (negative offsets wrap to the end)
+    std::vector<Fft::Complex> kernelGrid(gridWidth * gridHeight);
+    for (u32 y = 0; y < kernel.height; ++y) {
+        const usize gy = static_cast<usize>(static_cast<i64>(y) - ry + static_cast<i64>(gridHeight)) % gridHeight;
+        for (u32 x = 0; x < kernel.width; ++x) {
+            const usize gx = static_cast<usize>(static_cast<i64>(x) - rx + static_cast<i64>(gridWidth)) % gridWidth;
+            kernelGrid[gy * gridWidth + gx] = Fft::Complex(kernel.weights[y * kernel.width + x], 0.0f);
+        }
+    }
+
+    Fft::Transform2D(grid.data(), gridWidth, gridHeight, false, parallel);
+    Fft::Transform2D(kernelGrid.data(), gridWidth, gridHeight, false, parallel);
+    for (usize i = 0; i < grid.size(); ++i) {
+        grid[i] *= kernelGrid[i];
+    }
+    Fft::Transform2D(grid.data(), gridWidth, gridHeight, true, parallel);
+
+    StoreCroppedGrid(grid, gridWidth, rx, ry, width, height, dst);
+}
+
+void PsfConvolution::ApplyMtf(f32* band, u32 width, u32 height, const MtfFunction& mtf, bool parallel) {
+    // Replicated margin keeps the periodic FFT from blurring opposite edges together
+    const u32 margin = std::min(32u, std::max(width, height));
+    const usize gridWidth = Fft::NextPowerOfTwo(width + 2 * margin);
+    const usize gridHeight = Fft::NextPowerOfTwo(height + 2 * margin);
+
+    std::vector<Fft::Complex> grid = LoadPaddedGrid(band, width, height, margin, margin, gridWidth, gridHeight);
+    Fft::Transform2D(grid.data(), gridWidth, gridHeight, false, parallel);
+
+    auto frequency = [](usize k, usize n) {
+        const i64 signedK = (k <= n / 2) ? static_cast<i64>(k) : static_cast<i64>(k) - static_cast<i64>(n);
+        return static_cast<f32>(signedK) / static_cast<f32>(n);
+    };
+    for (usize y = 0; y < gridHeight; ++y) {
+        const f32 fy = frequency(y, gridHeight);
+        for (usize x = 0; x < gridWidth; ++x) {
+            grid[y * gridWidth + x] *= mtf(frequency(x, gridWidth), fy);
+        }
+    }
+
+    Fft::Transform2D(grid.data(), gridWidth, gridHeight, true, parallel);
+    StoreCroppedGrid(grid, gridWidth, margin, margin, width, height, band);
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+ConvolutionMethod PsfConvolution::ChooseMethod(const PsfKernel& kernel) {
+    if (kernel.IsSeparable()) {
+        return ConvolutionMethod::Separable;
+    }
+    return (kernel.width * kernel.height >= FFT_MIN_TAPS) ? ConvolutionMethod::Fft : ConvolutionMethod::Direct;
+}
+
+void PsfConvolution::ConvolveBand(const f32* src, f32* dst, u32 width, u32 height,
+                                  const PsfKernel& kernel, ConvolutionMethod method, bool parallel) {
+    if (method == ConvolutionMethod::Auto ||
+        (method == ConvolutionMethod::Separable && !kernel.IsSeparable())) {
+        method = ChooseMethod(kernel);
+    }
+
+    switch (method) {
+        case ConvolutionMethod::Separable:
+            ConvolveSeparable(src, dst, width, height, kernel, parallel);
+            break;
+        case ConvolutionMethod::Fft:
+            ConvolveFft(src, dst, width, height, kernel, parallel);
+            break;
+        default:
+            ConvolveDirect(src, dst, width, height, kernel, parallel);
+            break;
+    }
+}
+
+bool PsfConvolution::Apply(SpectralCube& cube, const std::vector<PsfKernel>& kernels, ConvolutionMethod method) {
+    if (kernels.size() != 1 && kernels.size() != cube.nbands) {
+        QL_LOG_ERROR("PsfConvolution::Apply: Expected 1 or {} kernels, got {}", cube.nbands, kernels.size());
+        return false;
+    }
+    for (const PsfKernel& kernel : kernels) {
+        if (!kernel.IsValid()) {
+            QL_LOG_ERROR("PsfConvolution::Apply: Invalid kernel");
+            return false;
+        }
+    }
+
+    ForEachBand(cube.nbands, [&](u32 b, bool parallel) {
+        const PsfKernel& kernel = kernels.size() == 1 ? kernels[0] : kernels[b];
+        std::vector<f32> blurred(cube.PixelsPerBand());
+        ConvolveBand(cube.BandPtr(b), blurred.data(), cube.width, cube.height, kernel, method, parallel);
+        std::copy(blurred.begin(), blurred.end(), cube.BandPtr(b));
+    });
+    return true;
+}
+
+bool PsfConvolution::Apply(Image& image, const std::vector<PsfKernel>& kernels, ConvolutionMethod method) {
+    if (kernels.size() != 1 && kernels.size() != image.channels) {
+        QL_LOG_ERROR("PsfConvolution::Apply: Expected 1 or {} kernels, got {}", image.channels, kernels.size());
+        return false;
+    }
+    for (const PsfKernel& kernel : kernels) {
+        if (!kernel.IsValid()) {
+            QL_LOG_ERROR("PsfConvolution::Apply: Invalid kernel");
+            return false;
+        }
+    }
+
+    // Channels are interleaved: convolve planar copies
+    ForEachBand(image.channels, [&](u32 c, bool parallel) {
+        if (c < image.channelNames.size() && image.channelNames[c] == "A") {
+            return;
+        }
+        const PsfKernel& kernel = kernels.size() == 1 ? kernels[0] : kernels[c];
+        std::vector<f32> plane(image.PixelCount());
+        std::vector<f32> blurred(image.PixelCount());
+        for (u32 i = 0; i < image.PixelCount(); ++i) {
+            plane[i] = image.data[static_cast<usize>(i) * image.channels + c];
+        }
+        ConvolveBand(plane.data(), blurred.data(), image.width, image.height, kernel, method, parallel);
+        for (u32 i = 0; i < image.PixelCount(); ++i) {
+            image.data[static_cast<usize>(i) * image.channels + c] = blurred[i];
+        }
+    });
+    return true;
+}
+
+bool PsfConvolution::ApplyMtf(SpectralCube& cube, const MtfFunction& mtf) {
+    if (!mtf) {
+        return false;
+    }
+    ForEachBand(cube.nbands, [&](u32 b, bool parallel) {
+        ApplyMtf(cube.BandPtr(b), cube.width, cube.height, mtf, parallel);
+    });
+    return true;
+}
+
+} // namespace quantiloom
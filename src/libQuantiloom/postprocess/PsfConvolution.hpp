@@ -0,0 +1,111 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "core/Image.hpp"
+#include "core/SpectralCube.hpp"
+#include <functional>
+#include <vector>
+
+// ============================================================================
+// PsfConvolution - Optical blur of rendered bands (sensor chain, stage 1)
+// ============================================================================
+// Convolves every band of a SpectralCube (or every channel of an Image) with
+// a point spread function, one kernel per band or one shared kernel.
+//
+// Three paths, picked per kernel by ChooseMethod():
+//   - Separable: Gaussian-like PSFs (kernel = column x row). Two 1D passes
+//     with contiguous inner loops the compiler vectorises; O(r) per pixel
+//   - Direct:    small non-separable kernels; O(r^2) per pixel
+//   - FFT:       large non-separable kernels (Airy, measured PSFs); the
+//     padded band and the kernel go through a 2D FFT; O(log N) per pixel
+// ApplyMtf filters directly in the frequency domain for systems specified
+// by their MTF instead of a PSF.
+//
+// Borders replicate the edge pixels. All paths compute the same true
+// convolution out(x) = sum_j k(j) in(x - j).
+//
+// Threading: bands are distributed over threads when there are at least as
+// many bands as cores, otherwise each band is split into row tiles (or FFT
+// rows/columns).
+//
+// Usage:
+//   std::vector<PsfKernel> psfs;
+//   for (f32 lambda : cube.wavelengths) {
+//       psfs.push_back(PsfKernel::Airy(lambda, 4.0f, 5.5f));   // f/4, 5.5 um pixels
+//   }
+//   PsfConvolution::Apply(cube, psfs);
+// ============================================================================
+
+namespace quantiloom {
+
+// ============================================================================
+// PsfKernel - Normalised, odd-sized convolution kernel
+// ============================================================================
+struct QL_API PsfKernel {
+    u32 width = 0;                  // Odd
+    u32 height = 0;                 // Odd
+    std::vector<f32> weights;       // [height][width], sums to 1
+    std::vector<f32> rowFactor;     // [width]  } non-empty if separable:
+    std::vector<f32> columnFactor;  // [height] } weights[y][x] = column[y] * row[x]
+
+    bool IsValid() const {
+        return (width & 1) && (height & 1) && weights.size() == static_cast<usize>(width) * height;
+    }
+    bool IsSeparable() const { return rowFactor.size() == width && columnFactor.size() == height; }
+    u32 RadiusX() const { return width / 2; }
+    u32 RadiusY() const { return height / 2; }
+
+    // Separable Gaussian, truncated at truncateSigmas standard deviations
+    static PsfKernel Gaussian(f32 sigmaX, f32 sigmaY, f32 truncateSigmas = 3.0f);
+
+    // Diffraction-limited (Airy) PSF of a circular aperture, integrated over
+    // square pixels. radius = 0 covers the first three dark rings.
+    static PsfKernel Airy(f32 wavelengthNm, f32 fNumber, f32 pixelPitchUm, u32 radius = 0);
+
+    // Arbitrary (e.g. measured) kernel; normalised, separability detected
+    static PsfKernel FromWeights(u32 width, u32 height, std::vector<f32> weights);
+};
+
+enum class ConvolutionMethod : u32 {
+    Auto = 0,
+    Direct = 1,
+    Separable = 2,
+    Fft = 3
+};
+
+// ============================================================================
+// PsfConvolution
+// ============================================================================
+class QL_API PsfConvolution {
+public:
+    // Non-separable kernels with at least this many taps use the FFT path
+    static constexpr u32 FFT_MIN_TAPS = 15 * 15;
+
+    // MTF as a function of spatial frequency (cycles/pixel, in [-0.5, 0.5])
+    using MtfFunction = std::function<f32(f32 fx, f32 fy)>;
+
+    static ConvolutionMethod ChooseMethod(const PsfKernel& kernel);
+
+    // Convolve one band (src and dst must not overlap)
+    static void ConvolveBand(const f32* src, f32* dst, u32 width, u32 height,
+                             const PsfKernel& kernel,
+                             ConvolutionMethod method = ConvolutionMethod::Auto,
+                             bool parallel = true);
+
+    // Multiply one band's spectrum by a (real, zero-phase) MTF, in place
+    static void ApplyMtf(f32* band, u32 width, u32 height, const MtfFunction& mtf, bool parallel = true);
+
+    // Blur every band; kernels holds one kernel per band or a single shared one
+    static bool Apply(SpectralCube& cube, const std::vector<PsfKernel>& kernels,
+                      ConvolutionMethod method = ConvolutionMethod::Auto);
+
+    // Blur every channel except one named "A"; one kernel per channel or one shared
+    static bool Apply(Image& image, const std::vector<PsfKernel>& kernels,
+                      ConvolutionMethod method = ConvolutionMethod::Auto);
+
+    // Same for an MTF shared by all bands
+    static bool ApplyMtf(SpectralCube& cube, const MtfFunction& mtf);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,342 @@
+#include "SensorNoise.hpp"
+#include "core/CounterRng.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+
+#include <H5Cpp.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+
+namespace quantiloom {
+
+// Pixels per work item; the per-block scratch arrays live on the stack
+static constexpr u32 kBlockPixels = 1024;
+
+// RNG streams (third counter word)
+static constexpr u32 kStreamTemporalNoise = 0;
+static constexpr u32 kStreamNonUniformity = 1;
+
+// ============================================================================
+// SensorParameters
+// ============================================================================
+
+f32 SensorParameters::QuantumEfficiencyAt(f32 wavelengthNm) const {
+    if (qeWavelengthsNm.empty() || qeCurve.size() != qeWavelengthsNm.size()) {
+        return quantumEfficiency;
+    }
+    if (wavelengthNm <= qeWavelengthsNm.front()) {
+        return qeCurve.front();
+    }
+    if (wavelengthNm >= qeWavelengthsNm.back()) {
+        return qeCurve.back();
+    }
+
+    const usize right = static_cast<usize>(
+        std::upper_bound(qeWavelengthsNm.begin(), qeWavelengthsNm.end(), wavelengthNm) - qeWavelengthsNm.begin());
+    const usize left = right - 1;
+    const f32 t = (wavelengthNm - qeWavelengthsNm[left]) / (qeWavelengthsNm[right] - qeWavelengthsNm[left]);
+    return qeCurve[left] * (1.0f - t) + qeCurve[right] * t;
+}
+
+f32 SensorParameters::ElectronsPerDn() const {
+    return (conversionGain > 0.0f) ? conversionGain : fullWellElectrons / static_cast<f32>(MaxDn());
+}
+
+bool SensorParameters::IsValid(u32 width, u32 height) const {
+    const usize pixels = static_cast<usize>(width) * height;
+    return adcBits >= 1 && adcBits <= 16 &&
+           integrationTimeS > 0.0f && fNumber > 0.0f && pixelPitchUm > 0.0f &&
+           fullWellElectrons > 0.0f && readNoiseElectrons >= 0.0f && darkCurrentElectronsPerS >= 0.0f &&
+           qeCurve.size() == qeWavelengthsNm.size() &&
+           (prnu.empty() || prnu.size() == pixels) &&
+           (dsnu.empty() || dsnu.size() == pixels);
+}
+
+// ============================================================================
+// Helper: Exact Poisson sample by CDF inversion (small means only)
+// ============================================================================
+
+static f32 SamplePoisson(f32 mean, f32 u) {
+    f64 probability = std::exp(-static_cast<f64>(mean));
+    f64 cdf = probability;
+    u32 k = 0;
+    while (u > cdf && k < 256) {
+        ++k;
+        probability *= mean / static_cast<f64>(k);
+        cdf += probability;
+    }
+    return static_cast<f32>(k);
+}
+
+// ============================================================================
+// Helper: One block of pixels in one band
+// ============================================================================
+
+struct BandConstants {
+    u32 band = 0;                 // Absolute band index
+    f32 electronsPerRadiance = 0.0f;
+    f32 darkElectrons = 0.0f;
+};
+
+static u64 ProcessBlock(const f32* radiance, u32 pixelBegin, u32 pixelCount,
+                        const BandConstants& bc, const SensorParameters& params,
+                        Philox4x32::Key key, u16* counts) {
+    f32 mean[kBlockPixels];
+    f32 shotNormal[kBlockPixels];
+    f32 readNormal[kBlockPixels];
+    f32 poissonUniform[kBlockPixels];
+    f32 electrons[kBlockPixels];
+
+    const f32* prnu = params.prnu.empty() ? nullptr : params.prnu.data() + pixelBegin;
+    const f32* dsnu = params.dsnu.empty() ? nullptr : params.dsnu.data() + pixelBegin;
+
+    // Expected electrons
+    for (u32 i = 0; i < pixelCount; ++i) {
+        const f32 signal = std::max(radiance[i], 0.0f) * bc.electronsPerRadiance * (prnu ? prnu[i] : 1.0f);
+        mean[i] = signal + bc.darkElectrons * (dsnu ? dsnu[i] : 1.0f);
+    }
+
+    // Random numbers: pure function of (pixel, band)
+    for (u32 i = 0; i < pixelCount; ++i) {
+        const Philox4x32::Counter r = Philox4x32::Generate({pixelBegin + i, bc.band, kStreamTemporalNoise, 0}, key);
+        Philox4x32::ToNormal(Philox4x32::ToUniform(r[0]), Philox4x32::ToUniform(r[1]),
+                             shotNormal[i], readNormal[i]);
+        poissonUniform[i] = Philox4x32::ToUniform(r[2]);
+    }
+
+    // Shot noise: normal approximation everywhere, exact Poisson for dim pixels
+    if (params.shotNoise) {
+        for (u32 i = 0; i < pixelCount; ++i) {
+            electrons[i] = mean[i] + std::sqrt(mean[i]) * shotNormal[i];
+        }
+        for (u32 i = 0; i < pixelCount; ++i) {
+            if (mean[i] < SensorNoise::POISSON_NORMAL_THRESHOLD) {
+                electrons[i] = SamplePoisson(mean[i], poissonUniform[i]);
+            }
+        }
+    } else {
+        std::copy(mean, mean + pixelCount, electrons);
+    }
+
+    // Full well, read noise, ADC
+    const f32 fullWell = params.fullWellElectrons;
+    const f32 readNoise = params.readNoiseElectrons;
+    const f32 dnPerElectron = 1.0f / params.ElectronsPerDn();
+    const f32 offset = params.offsetDn;
+    const f32 maxDn = static_cast<f32>(params.MaxDn());
+    u64 saturated = 0;
+    for (u32 i = 0; i < pixelCount; ++i) {
+        const f32 charge = std::clamp(electrons[i], 0.0f, fullWell);
+        const f32 dn = std::round((charge + readNoise * readNormal[i]) * dnPerElectron + offset);
+        const f32 clipped = std::clamp(dn, 0.0f, maxDn);
+        counts[i] = static_cast<u16>(clipped);
+        saturated += (charge >= fullWell || dn >= maxDn) ? 1 : 0;
+    }
+    return saturated;
+}
+
+// ============================================================================
+// Public API: ProcessBands
+// ============================================================================
+
+u64 SensorNoise::ProcessBands(const f32* radiance, u32 width, u32 height,
+                              u32 firstBand, u32 bandCount,
+                              const f32* wavelengthsNm, f32 bandwidthNm,
+                              const SensorParameters& params, u16* counts) {
+    const usize pixelsPerBand = static_cast<usize>(width) * height;
+
+    // Radiance -> photo-electrons per unit radiance, per band
+    const f64 pitchM = static_cast<f64>(params.pixelPitchUm) * 1e-6;
+    const f64 projectedSolidAngle = constants::PI / (1.0 + 4.0 * static_cast<f64>(params.fNumber) * params.fNumber);
+    const f64 energyToPhotonsBase = 1e-9 / (constants::PLANCK_CONSTANT * constants::SPEED_OF_LIGHT);  // lambda in nm
+    const f64 collected = static_cast<f64>(params.radianceScale) * bandwidthNm * pitchM * pitchM *
+                          projectedSolidAngle * params.opticsTransmission * params.integrationTimeS;
+
+    std::vector<BandConstants> bands(bandCount);
+    for (u32 b = 0; b < bandCount; ++b) {
+        const f32 lambda = wavelengthsNm[b];
+        bands[b].band = firstBand + b;
+        bands[b].electronsPerRadiance = static_cast<f32>(
+            collected * lambda * energyToPhotonsBase * params.QuantumEfficiencyAt(lambda));
+        bands[b].darkElectrons = params.darkCurrentElectronsPerS * params.integrationTimeS;
+    }
+
+    const Philox4x32::Key key = Philox4x32::KeyFromSeed(params.seed);
+    const usize blocksPerBand = (pixelsPerBand + kBlockPixels - 1) / kBlockPixels;
+    std::atomic<u64> saturated{0};
+
+    ParallelFor(blocksPerBand * bandCount, 1, [&](usize item) {
+        const u32 b = static_cast<u32>(item / blocksPerBand);
+        const usize pixelBegin = (item % blocksPerBand) * kBlockPixels;
+        const u32 pixelCount = static_cast<u32>(std::min<usize>(kBlockPixels, pixelsPerBand - pixelBegin));
+        const usize offset = b * pixelsPerBand + pixelBegin;
+
+        const u64 clipped = ProcessBlock(radiance + offset, static_cast<u32>(pixelBegin), pixelCount,
+                                         bands[b], params, key, counts + offset);
+        saturated.fetch_add(clipped, std::memory_order_relaxed);
+    });
+
+    return saturated.load();
+}
+
+// ============================================================================
+// Public API: Apply
+// ============================================================================
+
+bool SensorNoise::Apply(const SpectralCube& cube, const SensorParameters& params, std::vector<u16>& counts) {
+    if (!params.IsValid(cube.width, cube.height)) {
+        QL_LOG_ERROR("SensorNoise::Apply: Invalid sensor parameters for a {}x{} cube", cube.width, cube.height);
+        return false;
+    }
+
+    // A single-band cube has no band spacing (delta_lambda is 0 or not finite)
+    const f32 bandwidth = (params.bandwidthNm > 0.0f) ? params.bandwidthNm : cube.delta_lambda;
+    if (!(bandwidth > 0.0f) || !std::isfinite(bandwidth)) {
+        QL_LOG_ERROR("SensorNoise::Apply: Band width unknown (set bandwidthNm for single-band cubes)");
+        return false;
+    }
+
+    counts.resize(cube.data.size());
+    const u64 saturated = ProcessBands(cube.data.data(), cube.width, cube.height, 0, cube.nbands,
+                                       cube.wavelengths.data(), bandwidth, params, counts.data());
+    if (saturated > 0) {
+        QL_LOG_WARN("SensorNoise::Apply: {} of {} samples saturated", saturated, counts.size());
+    }
+    return true;
+}
+
+// ============================================================================
+// Public API: ProcessHDF5
+// ============================================================================
+
+static void WriteScalarAttribute(H5::Group& group, const char* name, const H5::PredType& type, const void* value) {
+    group.createAttribute(name, type, H5::DataSpace(H5S_SCALAR)).write(type, value);
+}
+
+bool SensorNoise::ProcessHDF5(const std::string& inputPath, const std::string& outputPath,
+                              const SensorParameters& params, u32 chunkBands) {
+    if (!std::filesystem::exists(inputPath)) {
+        QL_LOG_ERROR("SensorNoise::ProcessHDF5: File not found: {}", inputPath);
+        return false;
+    }
+
+    try {
+        H5::H5File input(inputPath, H5F_ACC_RDONLY);
+        H5::DataSet radianceSet = input.openDataSet("/data");
+        H5::DataSpace radianceSpace = radianceSet.getSpace();
+        if (radianceSpace.getSimpleExtentNdims() != 3) {
+            QL_LOG_ERROR("SensorNoise::ProcessHDF5: Expected 3D /data in {}", inputPath);
+            return false;
+        }
+
+        hsize_t dims[3];
+        radianceSpace.getSimpleExtentDims(dims);
+        const u32 nbands = static_cast<u32>(dims[0]);
+        const u32 height = static_cast<u32>(dims[1]);
+        const u32 width = static_cast<u32>(dims[2]);
+
+        if (!params.IsValid(width, height)) {
+            QL_LOG_ERROR("SensorNoise::ProcessHDF5: Invalid sensor parameters for a {}x{} cube", width, height);
+            return false;
+        }
+
+        std::vector<f32> wavelengths(nbands);
+        input.openDataSet("/wavelengths").read(wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+
+        f32 bandwidth = params.bandwidthNm;
+        if (bandwidth <= 0.0f && nbands > 1) {
+            bandwidth = (wavelengths.back() - wavelengths.front()) / static_cast<f32>(nbands - 1);
+        }
+        if (bandwidth <= 0.0f) {
+            QL_LOG_ERROR("SensorNoise::ProcessHDF5: Band width unknown (set bandwidthNm for single-band cubes)");
+            return false;
+        }
+
+        // Output: /counts [nbands, height, width] uint16, one chunk per band
+        H5::H5File output(outputPath, H5F_ACC_TRUNC);
+        H5::DSetCreatPropList chunking;
+        hsize_t chunkDims[3] = {1, dims[1], dims[2]};
+        chunking.setChunk(3, chunkDims);
+        H5::DataSpace countsSpace(3, dims);
+        H5::DataSet countsSet = output.createDataSet("/counts", H5::PredType::STD_U16LE, countsSpace, chunking);
+
+        {
+            hsize_t waveDims[1] = {nbands};
+            output.createDataSet("/wavelengths", H5::PredType::NATIVE_FLOAT, H5::DataSpace(1, waveDims))
+                .write(wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+        }
+
+        // Stream the cube through in band chunks
+        chunkBands = std::clamp(chunkBands, 1u, nbands);
+        const usize pixelsPerBand = static_cast<usize>(width) * height;
+        std::vector<f32> radiance(chunkBands * pixelsPerBand);
+        std::vector<u16> counts(chunkBands * pixelsPerBand);
+        u64 saturated = 0;
+
+        for (u32 b0 = 0; b0 < nbands; b0 += chunkBands) {
+            const u32 n = std::min(chunkBands, nbands - b0);
+            hsize_t start[3] = {b0, 0, 0};
+            hsize_t count[3] = {n, dims[1], dims[2]};
+            H5::DataSpace memSpace(3, count);
+
+            radianceSpace.selectHyperslab(H5S_SELECT_SET, count, start);
+            radianceSet.read(radiance.data(), H5::PredType::NATIVE_FLOAT, memSpace, radianceSpace);
+
+            saturated += ProcessBands(radiance.data(), width, height, b0, n,
+                                      wavelengths.data() + b0, bandwidth, params, counts.data());
+
+            countsSpace.selectHyperslab(H5S_SELECT_SET, count, start);
+            countsSet.write(counts.data(), H5::PredType::NATIVE_UINT16, memSpace, countsSpace);
+        }
+
+        // Sensor settings alongside the counts
+        H5::Group metaGroup = output.createGroup("/metadata");
+        const u32 adcBits = params.adcBits;
+        const f32 electronsPerDn = params.ElectronsPerDn();
+        WriteScalarAttribute(metaGroup, "integration_time_s", H5::PredType::NATIVE_FLOAT, &params.integrationTimeS);
+        WriteScalarAttribute(metaGroup, "f_number", H5::PredType::NATIVE_FLOAT, &params.fNumber);
+        WriteScalarAttribute(metaGroup, "pixel_pitch_um", H5::PredType::NATIVE_FLOAT, &params.pixelPitchUm);
+        WriteScalarAttribute(metaGroup, "bandwidth_nm", H5::PredType::NATIVE_FLOAT, &bandwidth);
+        WriteScalarAttribute(metaGroup, "read_noise_e", H5::PredType::NATIVE_FLOAT, &params.readNoiseElectrons);
+        WriteScalarAttribute(metaGroup, "dark_current_e_per_s", H5::PredType::NATIVE_FLOAT, &params.darkCurrentElectronsPerS);
+        WriteScalarAttribute(metaGroup, "full_well_e", H5::PredType::NATIVE_FLOAT, &params.fullWellElectrons);
+        WriteScalarAttribute(metaGroup, "conversion_gain_e_per_dn", H5::PredType::NATIVE_FLOAT, &electronsPerDn);
+        WriteScalarAttribute(metaGroup, "offset_dn", H5::PredType::NATIVE_FLOAT, &params.offsetDn);
+        WriteScalarAttribute(metaGroup, "adc_bits", H5::PredType::NATIVE_UINT32, &adcBits);
+        WriteScalarAttribute(metaGroup, "seed", H5::PredType::NATIVE_UINT64, &params.seed);
+
+        if (saturated > 0) {
+            QL_LOG_WARN("SensorNoise::ProcessHDF5: {} of {} samples saturated", saturated, pixelsPerBand * nbands);
+        }
+        QL_LOG_INFO("SensorNoise::ProcessHDF5: Wrote {}x{}x{} counts ({}-bit) to {}",
+                    width, height, nbands, params.adcBits, outputPath);
+        return true;
+
+    } catch (const H5::Exception& e) {
+        QL_LOG_ERROR("SensorNoise::ProcessHDF5: Failed ({} -> {}): {}", inputPath, outputPath, e.getDetailMsg());
+        return false;
+    }
+}
+
+// ============================================================================
+// Public API: MakeNonUniformityMap
+// ============================================================================
+
+std::vector<f32> SensorNoise::MakeNonUniformityMap(u32 width, u32 height, f32 sigma, u64 seed) {
+    const usize pixels = static_cast<usize>(width) * height;
+    std::vector<f32> map(pixels);
+    const Philox4x32::Key key = Philox4x32::KeyFromSeed(seed);
+
+    ParallelFor(pixels, kBlockPixels, [&](usize p) {
+        const Philox4x32::Counter r = Philox4x32::Generate({static_cast<u32>(p), 0, kStreamNonUniformity, 0}, key);
+        f32 n0 = 0.0f;
+        f32 n1 = 0.0f;
+        Philox4x32::ToNormal(Philox4x32::ToUniform(r[0]), Philox4x32::ToUniform(r[1]), n0, n1);
+        map[p] = std::max(0.0f, 1.0f + sigma * n0);
+    });
+    return map;
+}
+
+} // namespace quantiloom
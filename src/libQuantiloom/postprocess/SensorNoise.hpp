@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "core/SpectralCube.hpp"
+#include <string>
+#include <vector>
+
+// ============================================================================
+// SensorNoise - Radiance to detector counts (sensor chain, stage 2)
+// ============================================================================
+// Per pixel and band:
+//
+//   photons   = L * dlambda * pitch^2 * pi / (1 + 4 N^2) * tau * t * lambda / (h c)
+//   signal    = QE(lambda) * photons * PRNU(x, y)                  [e-]
+//   dark      = darkCurrent * t * DSNU(x, y)                       [e-]
+//   electrons = min(Poisson(signal + dark), fullWell) + N(0, readNoise)
+//   DN        = clamp(round(electrons / gain + offset), 0, 2^bits - 1)
+//
+// with L the band radiance in W/m^2/sr/nm (times radianceScale), dlambda the
+// band width (the cube's delta_lambda unless bandwidthNm is set), N the
+// f-number, tau the optics transmission and t the integration time.
+// Poisson noise is sampled exactly below POISSON_NORMAL_THRESHOLD electrons
+// and with the normal approximation above.
+//
+// Random numbers come from Philox4x32 (core/CounterRng.hpp) keyed by the
+// seed and indexed by (pixel, absolute band), so the output is identical for
+// any thread count and any band chunking. Pixels are processed in blocks of
+// independent straight-line loops (expected signal, RNG, Box-Muller, ADC)
+// that the compiler vectorises; only the exact-Poisson fix-up is scalar.
+//
+// ProcessBands converts a contiguous run of bands and is the streaming
+// primitive: ProcessHDF5 feeds it chunkBands bands at a time from an HS-OFF
+// cube on disk, so the cube never has to fit in memory.
+// ============================================================================
+
+namespace quantiloom {
+
+struct QL_API SensorParameters {
+    // Exposure and optics
+    f32 integrationTimeS = 0.01f;
+    f32 fNumber = 4.0f;
+    f32 opticsTransmission = 1.0f;
+    f32 pixelPitchUm = 5.0f;
+    f32 bandwidthNm = 0.0f;             // 0 = the cube's delta_lambda
+    f32 radianceScale = 1.0f;           // Renderer units -> W/m^2/sr/nm
+
+    // Quantum efficiency: curve sampled at qeWavelengthsNm (piecewise linear,
+    // clamped), or the scalar quantumEfficiency if the curve is empty
+    f32 quantumEfficiency = 0.8f;
+    std::vector<f32> qeWavelengthsNm;
+    std::vector<f32> qeCurve;
+
+    // Detector
+    f32 darkCurrentElectronsPerS = 0.0f;
+    f32 readNoiseElectrons = 0.0f;
+    f32 fullWellElectrons = 20000.0f;
+    bool shotNoise = true;
+
+    // Fixed-pattern noise, [height * width] or empty (ideal)
+    std::vector<f32> prnu;              // Photo-response gain (1 = nominal)
+    std::vector<f32> dsnu;              // Dark-signal gain (1 = nominal)
+
+    // ADC
+    u32 adcBits = 12;                   // 1..16
+    f32 conversionGain = 0.0f;          // e-/DN, 0 = full well spans the ADC range
+    f32 offsetDn = 0.0f;
+
+    u64 seed = 0;
+
+    f32 QuantumEfficiencyAt(f32 wavelengthNm) const;
+    f32 ElectronsPerDn() const;
+    u16 MaxDn() const { return static_cast<u16>((1u << adcBits) - 1u); }
+    bool IsValid(u32 width, u32 height) const;
+};
+
+class QL_API SensorNoise {
+public:
+    // Exact Poisson sampling below this mean (electrons), normal above
+    static constexpr f32 POISSON_NORMAL_THRESHOLD = 32.0f;
+
+    // Convert bands [firstBand, firstBand + bandCount) of a band-major
+    // radiance block ([bandCount][height][width]) to counts of the same
+    // layout. firstBand is the absolute band index (selects the noise stream).
+    // Returns the number of saturated (full-well or ADC-clipped) samples.
+    static u64 ProcessBands(const f32* radiance, u32 width, u32 height,
+                            u32 firstBand, u32 bandCount,
+                            const f32* wavelengthsNm, f32 bandwidthNm,
+                            const SensorParameters& params, u16* counts);
+
+    // Whole in-memory cube -> counts [nbands][height][width]
+    static bool Apply(const SpectralCube& cube, const SensorParameters& params, std::vector<u16>& counts);
+
+    // Streaming HDF5: reads /data of an HS-OFF cube chunkBands bands at a
+    // time and writes /counts (uint16), /wavelengths and /metadata
+    static bool ProcessHDF5(const std::string& inputPath, const std::string& outputPath,
+                            const SensorParameters& params, u32 chunkBands = 16);
+
+    // Per-pixel gain map 1 + sigma * N(0, 1) (PRNU / DSNU), reproducible from the seed
+    static std::vector<f32> MakeNonUniformityMap(u32 width, u32 height, f32 sigma, u64 seed);
+};
+
+} // namespace quantiloom
@@ -0,0 +1,273 @@
+#include "SpectralPreview.hpp"
+#include "core/Color.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quantiloom {
+
+// Pixels per work item in the cube kernel
+static constexpr usize kBlockPixels = 1024;
+
+// Mid-grey target of auto exposure
+static constexpr f32 kMiddleGrey = 0.18f;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// integral(y-bar) over 360-830 nm for the fitted CMFs (1 nm trapezoid)
+static f64 IntegralYBar() {
+    static const f64 integral = []() {
+        f64 sum = 0.0;
+        for (u32 nm = 360; nm <= 830; ++nm) {
+            const f64 weight = (nm == 360 || nm == 830) ? 0.5 : 1.0;
+            sum += weight * CieColorMatching(static_cast<f32>(nm)).y;
+        }
+        return sum;
+    }();
+    return integral;
+}
+
+static glm::vec3 XyzToOutput(const glm::vec3& xyz, PreviewColorSpace colorSpace) {
+    switch (colorSpace) {
+        case PreviewColorSpace::LinearSrgb: return XyzToLinearSrgb(xyz);
+        case PreviewColorSpace::AcesCg:     return XyzToAcesCg(xyz);
+        default:                            return xyz;
+    }
+}
+
+static std::vector<String> ChannelNames(PreviewColorSpace colorSpace) {
+    if (colorSpace == PreviewColorSpace::Xyz) {
+        return {"X", "Y", "Z"};
+    }
+    return {"R", "G", "B"};
+}
+
+// Scale from exposure / auto exposure; meanBands[b] is the mean value of band b
+static f32 ExposureScale(const std::vector<f32>& wavelengthsNm, const std::vector<f64>& meanBands,
+                         const PreviewSettings& settings) {
+    f32 scale = std::exp2(settings.exposure);
+    if (settings.autoExposure) {
+        // Mean Y is linear in the band means
+        const std::vector<f32> yWeights = SpectralPreview::ComputeWeights(wavelengthsNm, PreviewColorSpace::Xyz);
+        const usize nbands = wavelengthsNm.size();
+        f64 meanY = 0.0;
+        for (usize b = 0; b < nbands; ++b) {
+            meanY += yWeights[nbands + b] * meanBands[b];
+        }
+        if (meanY > 0.0) {
+            scale *= static_cast<f32>(kMiddleGrey / meanY);
+        }
+    }
+    return scale;
+}
+
+// ============================================================================
+// PreviewSettings
+// ============================================================================
+
+PreviewColorSpace PreviewSettings::ParseColorSpace(const std::string& name) {
+    if (name == "srgb" || name == "linear_srgb") {
+        return PreviewColorSpace::LinearSrgb;
+    }
+    if (name == "acescg") {
+        return PreviewColorSpace::AcesCg;
+    }
+    if (name == "xyz") {
+        return PreviewColorSpace::Xyz;
+    }
+    QL_LOG_WARN("PreviewSettings: Unknown colour space '{}' (expected srgb, acescg or xyz), using srgb", name);
+    return PreviewColorSpace::LinearSrgb;
+}
+
+PreviewTonemap PreviewSettings::ParseTonemap(const std::string& name) {
+    if (name == "none") {
+        return PreviewTonemap::None;
+    }
+    if (name == "reinhard") {
+        return PreviewTonemap::Reinhard;
+    }
+    if (name == "aces") {
+        return PreviewTonemap::Aces;
+    }
+    QL_LOG_WARN("PreviewSettings: Unknown tonemap '{}' (expected none, reinhard or aces), using none", name);
+    return PreviewTonemap::None;
+}
+
+// ============================================================================
+// SpectralPreview::ComputeWeights
+// ============================================================================
+
+std::vector<f32> SpectralPreview::ComputeWeights(const std::vector<f32>& wavelengthsNm, PreviewColorSpace colorSpace) {
+    const usize nbands = wavelengthsNm.size();
+    std::vector<f32> weights(3 * nbands, 0.0f);
+    const f64 normalization = 1.0 / IntegralYBar();
+
+    for (usize b = 0; b < nbands; ++b) {
+        // Trapezoid width of band b (a single band is a point sample)
+        f64 width = 1.0;
+        if (nbands > 1) {
+            const f32 left = wavelengthsNm[b > 0 ? b - 1 : b];
+            const f32 right = wavelengthsNm[b + 1 < nbands ? b + 1 : b];
+            width = 0.5 * static_cast<f64>(right - left);
+        }
+
+        const glm::vec3 xyz = CieColorMatching(wavelengthsNm[b]) * static_cast<f32>(width * normalization);
+        const glm::vec3 out = XyzToOutput(xyz, colorSpace);
+        weights[0 * nbands + b] = out.x;
+        weights[1 * nbands + b] = out.y;
+        weights[2 * nbands + b] = out.z;
+    }
+    return weights;
+}
+
+// ============================================================================
+// SpectralPreview::Convert (cube)
+// ============================================================================
+
+Image SpectralPreview::Convert(const SpectralCube& cube, const PreviewSettings& settings) {
+    const usize nbands = cube.nbands;
+    const usize pixels = cube.PixelsPerBand();
+
+    std::vector<f64> meanBands(nbands, 0.0);
+    if (settings.autoExposure) {
+        ParallelFor(nbands, 1, [&](usize b) {
+            f64 sum = 0.0;
+            const f32* band = cube.BandPtr(static_cast<u32>(b));
+            for (usize p = 0; p < pixels; ++p) {
+                sum += band[p];
+            }
+            meanBands[b] = sum / static_cast<f64>(pixels);
+        });
+    }
+
+    // Exposure folded into the weights
+    std::vector<f32> weights = ComputeWeights(cube.wavelengths, settings.colorSpace);
+    const f32 scale = ExposureScale(cube.wavelengths, meanBands, settings);
+    for (f32& w : weights) {
+        w *= scale;
+    }
+
+    Image image(cube.width, cube.height, 3);
+    image.channelNames = ChannelNames(settings.colorSpace);
+    image.metadata = cube.metadata;
+
+    const usize blockCount = (pixels + kBlockPixels - 1) / kBlockPixels;
+    ParallelFor(blockCount, 1, [&](usize block) {
+        const usize begin = block * kBlockPixels;
+        const usize count = std::min(kBlockPixels, pixels - begin);
+        f32 acc0[kBlockPixels] = {};
+        f32 acc1[kBlockPixels] = {};
+        f32 acc2[kBlockPixels] = {};
+
+        for (usize b = 0; b < nbands; ++b) {
+            const f32 w0 = weights[b];
+            const f32 w1 = weights[nbands + b];
+            const f32 w2 = weights[2 * nbands + b];
+            const f32* band = cube.BandPtr(static_cast<u32>(b)) + begin;
+            for (usize i = 0; i < count; ++i) {
+                acc0[i] += w0 * band[i];
+                acc1[i] += w1 * band[i];
+                acc2[i] += w2 * band[i];
+            }
+        }
+
+        f32* out = image.data.data() + begin * 3;
+        for (usize i = 0; i < count; ++i) {
+            out[i * 3 + 0] = acc0[i];
+            out[i * 3 + 1] = acc1[i];
+            out[i * 3 + 2] = acc2[i];
+        }
+    });
+
+    ApplyTonemap(image, settings);
+    return image;
+}
+
+// ============================================================================
+// SpectralPreview::Convert (band image)
+// ============================================================================
+
+Image SpectralPreview::Convert(const Image& bands, const std::vector<f32>& wavelengthsNm,
+                               const PreviewSettings& settings) {
+    const usize nbands = wavelengthsNm.size();
+    if (nbands == 0 || nbands > bands.channels) {
+        QL_LOG_ERROR("SpectralPreview::Convert: {} wavelengths for an image with {} channels",
+                     nbands, bands.channels);
+        return Image();
+    }
+
+    const usize pixels = bands.PixelCount();
+    std::vector<f64> meanBands(nbands, 0.0);
+    if (settings.autoExposure) {
+        for (usize p = 0; p < pixels; ++p) {
+            for (usize b = 0; b < nbands; ++b) {
+                meanBands[b] += bands.data[p * bands.channels + b];
+            }
+        }
+        for (f64& mean : meanBands) {
+            mean /= static_cast<f64>(pixels);
+        }
+    }
+
+    std::vector<f32> weights = ComputeWeights(wavelengthsNm, settings.colorSpace);
+    const f32 scale = ExposureScale(wavelengthsNm, meanBands, settings);
+    for (f32& w : weights) {
+        w *= scale;
+    }
+
+    Image image(bands.width, bands.height, 3);
+    image.channelNames = ChannelNames(settings.colorSpace);
+    image.metadata = bands.metadata;
+
+    // Channel-last input: one short dot product per pixel and output channel
+    ParallelFor(pixels, kBlockPixels, [&](usize p) {
+        const f32* spectrum = &bands.data[p * bands.channels];
+        f32 sum[3] = {0.0f, 0.0f, 0.0f};
+        for (usize c = 0; c < 3; ++c) {
+            const f32* row = &weights[c * nbands];
+            for (usize b = 0; b < nbands; ++b) {
+                sum[c] += row[b] * spectrum[b];
+            }
+        }
+        image.data[p * 3 + 0] = sum[0];
+        image.data[p * 3 + 1] = sum[1];
+        image.data[p * 3 + 2] = sum[2];
+    });
+
+    ApplyTonemap(image, settings);
+    return image;
+}
+
+// ============================================================================
+// SpectralPreview::ApplyTonemap
+// ============================================================================
+
+void SpectralPreview::ApplyTonemap(Image& image, const PreviewSettings& settings) {
+    // Exposure is already folded into the weights
+    switch (settings.tonemap) {
+        case PreviewTonemap::Reinhard:
+            for (f32& v : image.data) {
+                v = std::max(v, 0.0f);
+                v = v / (1.0f + v);
+            }
+            break;
+        case PreviewTonemap::Aces:
+            for (f32& v : image.data) {
+                v = std::max(v, 0.0f);
+                v = std::clamp((v * (2.51f * v + 0.03f)) / (v * (2.43f * v + 0.59f) + 0.14f), 0.0f, 1.0f);
+            }
+            break;
+        default:
+            break;
+    }
+
+    image.metadata["preview_color_space"] = (settings.colorSpace == PreviewColorSpace::Xyz) ? "xyz"
+                                          : (settings.colorSpace == PreviewColorSpace::AcesCg) ? "acescg"
+                                          : "linear_srgb";
+}
+
+} // namespace quantiloom
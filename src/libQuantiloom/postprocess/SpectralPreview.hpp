@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "core/Image.hpp"
+#include "core/SpectralCube.hpp"
+#include <vector>
+
+// ============================================================================
+// SpectralPreview - Spectral bands to CIE XYZ / sRGB / ACEScg quick looks
+// ============================================================================
+// Integrates each pixel's spectrum against the CIE 1931 colour matching
+// functions (core/Color.hpp):
+//
+//   XYZ = sum_b cmf(lambda_b) * L_b * dlambda_b / integral(y-bar)
+//
+// so a flat spectrum of value L maps to Y = L. dlambda_b are trapezoid
+// weights of the band grid; bands outside the visible range contribute ~0.
+// The XYZ -> output primaries matrix is folded into the per-band weights
+// (3 x nbands), so each pixel costs 3 multiply-adds per band.
+//
+// Cubes are band-major: the kernel walks blocks of pixels and, per band,
+// accumulates three contiguous rows (vectorised); blocks run in parallel.
+//
+// Then: exposure (EV), optional tonemap, output as linear RGB channels for
+// ImageIO::WriteEXR, or ImageIO::WritePNG (applies the sRGB curve, 8-bit).
+//
+// Usage:
+//   PreviewSettings settings;
+//   settings.exposure = 1.0f;
+//   settings.tonemap = PreviewTonemap::Aces;
+//   Image rgb = SpectralPreview::Convert(cube, settings);
+//   ImageIO::WritePNG("preview.png", rgb);
+// ============================================================================
+
+namespace quantiloom {
+
+enum class PreviewColorSpace : u32 {
+    Xyz = 0,         // CIE XYZ (channels X, Y, Z)
+    LinearSrgb = 1,  // Rec.709 primaries, D65
+    AcesCg = 2       // AP1 primaries, D60
+};
+
+enum class PreviewTonemap : u32 {
+    None = 0,
+    Reinhard = 1,    // x / (1 + x)
+    Aces = 2         // Narkowicz fit of the ACES filmic curve
+};
+
+struct QL_API PreviewSettings {
+    PreviewColorSpace colorSpace = PreviewColorSpace::LinearSrgb;
+    f32 exposure = 0.0f;             // EV, scale = 2^exposure
+    bool autoExposure = false;       // Scale the mean Y to 0.18 before exposure
+    PreviewTonemap tonemap = PreviewTonemap::None;
+
+    static PreviewColorSpace ParseColorSpace(const std::string& name);
+    static PreviewTonemap ParseTonemap(const std::string& name);
+};
+
+class QL_API SpectralPreview {
+public:
+    // Per-band weights [3][nbands] (row-major) for a wavelength grid (nm)
+    static std::vector<f32> ComputeWeights(const std::vector<f32>& wavelengthsNm, PreviewColorSpace colorSpace);
+
+    // Band-major cube -> 3-channel image
+    static Image Convert(const SpectralCube& cube, const PreviewSettings& settings = {});
+
+    // Band image (one channel per wavelength, e.g. MS-RT output) -> 3-channel image
+    static Image Convert(const Image& bands, const std::vector<f32>& wavelengthsNm,
+                         const PreviewSettings& settings = {});
+
+private:
+    static void ApplyTonemap(Image& image, const PreviewSettings& settings);
+};
+
+} // namespace quantiloom
@@ -19,7 +19,7 @@ BLAS::BLAS(VulkanContext& context, const GeometryPrimitive& primitive)
         throw std::runtime_error("Cannot create BLAS from empty primitive");
     }
 
-    QL_LOG_INFO("Creating BLAS for primitive with {} vertices, {} triangles",
+    QL_LOG_DEBUG("Creating BLAS for primitive with {} vertices, {} triangles",
                 primitive.positions.size(), primitive.indices.size() / 3);
 
     // Upload vertex and index data to GPU immediately (using ExecuteImmediate)
@@ -102,7 +102,7 @@ void BLAS::UploadGeometryBuffers() {
         );
     });
 
-    QL_LOG_INFO("  Uploaded geometry via staging buffers: {} vertices, {} indices",
+    QL_LOG_DEBUG("  Uploaded geometry via staging buffers: {} vertices, {} indices",
                 m_primitive.positions.size(), m_primitive.indices.size());
 }
 
@@ -222,7 +222,7 @@ void BLAS::Build(VkCommandBuffer cmd) {
         &sizeInfo
     );
 
-    QL_LOG_INFO("  BLAS build sizes: AS={} bytes, scratch={} bytes",
+    QL_LOG_DEBUG("  BLAS build sizes: AS={} bytes, scratch={} bytes",
                 sizeInfo.accelerationStructureSize, sizeInfo.buildScratchSize);
 
     // Create AS buffer
@@ -291,7 +291,7 @@ void BLAS::Build(VkCommandBuffer cmd) {
     );
 
     m_built = true;
-    QL_LOG_INFO("  BLAS built successfully (device address: 0x{:x})", m_deviceAddress);
+    QL_LOG_DEBUG("  BLAS built successfully (device address: 0x{:x})", m_deviceAddress);
 }
 
 // ============================================================================
@@ -379,7 +379,7 @@ void TLAS::AddInstance(const BLAS& blas, u32 materialId, const glm::mat4& transf
 
     m_instances.push_back(instance);
 
-    QL_LOG_INFO("  Added instance {} to TLAS (material {}, BLAS addr: 0x{:x})",
+    QL_LOG_TRACE("  Added instance {} to TLAS (material {}, BLAS addr: 0x{:x})",
                 m_instances.size() - 1, materialId, blas.GetDeviceAddress());
 }
 
@@ -63,23 +63,22 @@ void CommandHelper::ExecuteImmediate(
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmd;
 
-    QL_LOG_INFO("  [DEBUG CommandHelper] Submitting commands to GPU queue...");
+    QL_LOG_TRACE("CommandHelper::ExecuteImmediate: Submitting commands");
     result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
     if (result != VK_SUCCESS) {
         vkDestroyCommandPool(device, commandPool, nullptr);
-        QL_LOG_ERROR("  [DEBUG CommandHelper] vkQueueSubmit FAILED with VkResult: {}", static_cast<int>(result));
+        QL_LOG_ERROR("CommandHelper::ExecuteImmediate: vkQueueSubmit failed (VkResult: {})", static_cast<int>(result));
         throw std::runtime_error("Failed to submit command buffer (VkResult: " + std::to_string(result) + ")");
     }
-    QL_LOG_INFO("  [DEBUG CommandHelper] Commands submitted successfully, waiting for GPU...");
 
     // Wait for completion (synchronous)
     result = vkQueueWaitIdle(queue);
     if (result != VK_SUCCESS) {
         vkDestroyCommandPool(device, commandPool, nullptr);
-        QL_LOG_ERROR("  [DEBUG CommandHelper] vkQueueWaitIdle FAILED with VkResult: {} (GPU CRASHED)", static_cast<int>(result));
+        QL_LOG_ERROR("CommandHelper::ExecuteImmediate: vkQueueWaitIdle failed (VkResult: {}, device lost?)", static_cast<int>(result));
         throw std::runtime_error("Failed to wait for queue idle (VkResult: " + std::to_string(result) + ")");
     }
-    QL_LOG_INFO("  [DEBUG CommandHelper] GPU execution completed successfully");
+    QL_LOG_TRACE("CommandHelper::ExecuteImmediate: Completed");
 
     // Cleanup
     vkDestroyCommandPool(device, commandPool, nullptr);
@@ -181,7 +180,7 @@ void CommandHelper::TransitionImageLayoutImmediate(
         TransitionImageLayout(cmd, image, format, oldLayout, newLayout, mipLevels);
     });
 
-    QL_LOG_INFO("Image layout transition: {} -> {} (immediate)",
+    QL_LOG_DEBUG("Image layout transition: {} -> {} (immediate)",
                 static_cast<int>(oldLayout), static_cast<int>(newLayout));
 }
 
@@ -13,7 +13,8 @@ GpuImage::GpuImage(VmaAllocator allocator, VkDevice device,
                    VkFormat format,
                    VkImageUsageFlags usage,
                    VmaMemoryUsage memUsage,
-                   u32 mipLevels)
+                   u32 mipLevels,
+                   VkComponentMapping components)
     : m_allocator(allocator),
       m_device(device),
       m_format(format),
@@ -53,6 +54,7 @@ GpuImage::GpuImage(VmaAllocator allocator, VkDevice device,
     viewInfo.image = m_image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format = format;
+    viewInfo.components = components;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
     viewInfo.subresourceRange.levelCount = mipLevels;
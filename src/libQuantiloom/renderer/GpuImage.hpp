@@ -34,12 +34,14 @@ public:
     // ========================================================================
 
     // Create 2D image with VMA
+    // components: optional view swizzle (default identity)
     GpuImage(VmaAllocator allocator, VkDevice device,
              u32 width, u32 height,
              VkFormat format,
              VkImageUsageFlags usage,
              VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_GPU_ONLY,
-             u32 mipLevels = 1);
+             u32 mipLevels = 1,
+             VkComponentMapping components = {});
 
     // Destructor: automatically destroys VkImage, VkImageView, and VmaAllocation
     ~GpuImage();
@@ -1,5 +1,7 @@
 #include "RayTracingPipeline.hpp"
 #include "core/Log.hpp"
+#include "SpirvReflect.hpp"
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <cstring>
@@ -140,11 +142,16 @@ void RayTracingPipeline::CreateDescriptorSetLayout() {
     VkDevice device = m_context.GetDevice();
 
     // Define bindings (matches shader layout)
-    // NOTE: Using fixed array size for textures (max 1024) for simplicity
+    // NOTE: Using fixed array sizes (MAX_TEXTURES / MAX_SAMPLERS) for simplicity
     // Can be made dynamic via VkDescriptorSetVariableDescriptorCountAllocateInfo in M2+
-    constexpr u32 MAX_TEXTURES = 1024;
+    const VkPhysicalDeviceLimits& limits = m_context.GetDeviceProperties().limits;
+    if (MAX_SAMPLERS > limits.maxPerStageDescriptorSamplers) {
+        QL_LOG_ERROR("Sampler array size {} exceeds maxPerStageDescriptorSamplers ({})",
+                     MAX_SAMPLERS, limits.maxPerStageDescriptorSamplers);
+        throw std::runtime_error("Sampler array exceeds device limits");
+    }
 
-    std::vector<VkDescriptorSetLayoutBinding> bindings(8);
+    std::vector<VkDescriptorSetLayoutBinding> bindings(12);
 
     // Binding 0: Output image (RWTexture2D)
     bindings[0].binding = 0;
@@ -196,16 +203,44 @@ void RayTracingPipeline::CreateDescriptorSetLayout() {
     bindings[6].stageFlags = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
     bindings[6].pImmutableSamplers = nullptr;
 
-    // Binding 7: Sampler array (SamplerState[])
+    // Binding 7: Sampler array (SamplerState[]), indexed separately from textures
     bindings[7].binding = 7;
     bindings[7].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-    bindings[7].descriptorCount = MAX_TEXTURES;
+    bindings[7].descriptorCount = MAX_SAMPLERS;
     bindings[7].stageFlags = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
     bindings[7].pImmutableSamplers = nullptr;
 
+    // Binding 8: RGB-to-spectrum coefficient table (StructuredBuffer<float>)
+    bindings[8].binding = 8;
+    bindings[8].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[8].descriptorCount = 1;
+    bindings[8].stageFlags = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+    bindings[8].pImmutableSamplers = nullptr;
+
+    // Binding 9: Measured spectral material table (StructuredBuffer<float2>)
+    bindings[9].binding = 9;
+    bindings[9].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[9].descriptorCount = 1;
+    bindings[9].stageFlags = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+    bindings[9].pImmutableSamplers = nullptr;
+
+    // Binding 10: Band-integrated Planck radiance table (StructuredBuffer<float>)
+    bindings[10].binding = 10;
+    bindings[10].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[10].descriptorCount = 1;
+    bindings[10].stageFlags = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+    bindings[10].pImmutableSamplers = nullptr;
+
+    // Binding 11: AOV image (RWTexture2D, denoiser guides)
+    bindings[11].binding = 11;
+    bindings[11].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[11].descriptorCount = 1;
+    bindings[11].stageFlags = VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+    bindings[11].pImmutableSamplers = nullptr;
+
     // Enable descriptor indexing flags for texture arrays
     // This allows runtime indexing and partially bound descriptors
-    std::vector<VkDescriptorBindingFlags> bindingFlags(8, 0);
+    std::vector<VkDescriptorBindingFlags> bindingFlags(12, 0);
     bindingFlags[6] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;  // Not all textures need to be bound
     bindingFlags[7] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;  // Not all samplers need to be bound
 
@@ -214,6 +249,9 @@ void RayTracingPipeline::CreateDescriptorSetLayout() {
     bindingFlagsInfo.bindingCount = static_cast<u32>(bindingFlags.size());
     bindingFlagsInfo.pBindingFlags = bindingFlags.data();
 
+    // Kept to validate the shaders against (LoadShaders)
+    m_layoutBindings = bindings;
+
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.pNext = &bindingFlagsInfo;
@@ -228,15 +266,15 @@ void RayTracingPipeline::CreateDescriptorSetLayout() {
     // Create descriptor pool
     std::vector<VkDescriptorPoolSize> poolSizes(5);
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    poolSizes[0].descriptorCount = 1;
+    poolSizes[0].descriptorCount = 2;  // Output + AOV images
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
     poolSizes[1].descriptorCount = 1;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[2].descriptorCount = 4;  // LUT + vertex + index + material buffers
+    poolSizes[2].descriptorCount = 7;  // LUT + vertex + index + material + spectrum table + spectral material + Planck buffers
     poolSizes[3].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
     poolSizes[3].descriptorCount = MAX_TEXTURES;  // Texture array
     poolSizes[4].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-    poolSizes[4].descriptorCount = MAX_TEXTURES;  // Sampler array
+    poolSizes[4].descriptorCount = MAX_SAMPLERS;  // Sampler array (deduplicated)
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -304,6 +342,13 @@ void RayTracingPipeline::LoadShaders() {
     auto chitSpirv = LoadSPIRV(m_closestHitPath);
     auto missSpirv = LoadSPIRV(m_missPath);
 
+    // Reject SPIR-V built from HLSL with another resource layout
+    ValidateShaderBindings({
+        {m_raygenPath, VK_SHADER_STAGE_RAYGEN_BIT_KHR, &raygenSpirv},
+        {m_closestHitPath, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, &chitSpirv},
+        {m_missPath, VK_SHADER_STAGE_MISS_BIT_KHR, &missSpirv},
+    });
+
     // Create shader modules (will be destroyed after pipeline creation)
     m_shaderModules.resize(3);
     m_shaderModules[0] = CreateShaderModule(raygenSpirv);
@@ -346,6 +391,57 @@ std::vector<u32> RayTracingPipeline::LoadSPIRV(const std::string& path) {
     return buffer;
 }
 
+void RayTracingPipeline::ValidateShaderBindings(const std::vector<ShaderSource>& shaders) {
+    const char* rebuildHint = "the SPIR-V does not match this build; rebuild the CompileShaders target";
+    std::vector<bool> used(m_layoutBindings.size(), false);
+    m_bufferStrides.assign(m_layoutBindings.size(), 0);
+
+    for (const ShaderSource& shader : shaders) {
+        auto reflection = SpirvReflection::Parse(*shader.spirv);
+        if (!reflection.has_value()) {
+            throw std::runtime_error(shader.path + ": " + reflection.error());
+        }
+
+        for (const SpirvBinding& binding : reflection.value().GetBindings()) {
+            const auto layout = std::find_if(m_layoutBindings.begin(), m_layoutBindings.end(),
+                [&](const VkDescriptorSetLayoutBinding& b) { return b.binding == binding.binding; });
+            if (binding.set != 0 || layout == m_layoutBindings.end()) {
+                throw std::runtime_error(fmt::format("{}: uses set {} binding {}, which the pipeline layout does "
+                                                     "not declare ({})", shader.path, binding.set,
+                                                     binding.binding, rebuildHint));
+            }
+            if ((layout->stageFlags & shader.stage) == 0) {
+                throw std::runtime_error(fmt::format("{}: uses binding {}, which the pipeline layout does not "
+                                                     "expose to this stage ({})", shader.path, binding.binding,
+                                                     rebuildHint));
+            }
+            const usize index = static_cast<usize>(layout - m_layoutBindings.begin());
+            used[index] = true;
+            if (binding.arrayStride != 0) {
+                m_bufferStrides[index] = binding.arrayStride;
+            }
+        }
+    }
+
+    // Every declared binding is read by some stage; an unused one means the
+    // shaders predate it and the resources bound there are silently ignored
+    for (usize i = 0; i < m_layoutBindings.size(); ++i) {
+        if (!used[i]) {
+            throw std::runtime_error(fmt::format("Binding {} is not used by any shader ({})",
+                                                 m_layoutBindings[i].binding, rebuildHint));
+        }
+    }
+}
+
+u32 RayTracingPipeline::GetBufferStride(u32 binding) const {
+    for (usize i = 0; i < m_layoutBindings.size(); ++i) {
+        if (m_layoutBindings[i].binding == binding) {
+            return i < m_bufferStrides.size() ? m_bufferStrides[i] : 0;
+        }
+    }
+    return 0;
+}
+
 VkShaderModule RayTracingPipeline::CreateShaderModule(const std::vector<u32>& spirv) {
     VkDevice device = m_context.GetDevice();
 
@@ -569,6 +665,25 @@ void RayTracingPipeline::BindOutputImage(const GpuImage& image) {
     vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
 }
 
+void RayTracingPipeline::BindAovImage(const GpuImage& image) {
+    VkDevice device = m_context.GetDevice();
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageView = image.GetView();
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_descriptorSet;
+    write.dstBinding = 11;
+    write.dstArrayElement = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
 void RayTracingPipeline::BindAccelerationStructure(VkAccelerationStructureKHR tlas) {
     VkDevice device = m_context.GetDevice();
 
@@ -665,23 +780,84 @@ void RayTracingPipeline::BindMaterialBuffer(const GpuBuffer& buffer) {
     vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
 }
 
+void RayTracingPipeline::BindSpectrumTableBuffer(const GpuBuffer& buffer) {
+    VkDevice device = m_context.GetDevice();
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer.GetHandle();
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_descriptorSet;
+    write.dstBinding = 8;
+    write.dstArrayElement = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+void RayTracingPipeline::BindSpectralMaterialBuffer(const GpuBuffer& buffer) {
+    VkDevice device = m_context.GetDevice();
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer.GetHandle();
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_descriptorSet;
+    write.dstBinding = 9;
+    write.dstArrayElement = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+void RayTracingPipeline::BindPlanckTableBuffer(const GpuBuffer& buffer) {
+    VkDevice device = m_context.GetDevice();
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer.GetHandle();
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_descriptorSet;
+    write.dstBinding = 10;
+    write.dstArrayElement = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
 void RayTracingPipeline::BindTextures(const std::vector<VkImageView>& imageViews,
                                        const std::vector<VkSampler>& samplers) {
     VkDevice device = m_context.GetDevice();
 
-    if (imageViews.size() != samplers.size()) {
-        QL_LOG_ERROR("Texture binding failed: imageViews.size() ({}) != samplers.size() ({})",
-                     imageViews.size(), samplers.size());
-        throw std::runtime_error("Mismatched texture and sampler array sizes");
-    }
-
-    if (imageViews.empty()) {
+    if (imageViews.empty() || samplers.empty()) {
         QL_LOG_WARN("No textures to bind (TextureManager should provide at least a dummy texture)");
         return;
     }
 
+    if (imageViews.size() > MAX_TEXTURES || samplers.size() > MAX_SAMPLERS) {
+        QL_LOG_ERROR("Texture binding failed: {} textures / {} samplers exceed capacity ({} / {})",
+                     imageViews.size(), samplers.size(), MAX_TEXTURES, MAX_SAMPLERS);
+        throw std::runtime_error("Too many textures or samplers for descriptor arrays");
+    }
+
     u32 textureCount = static_cast<u32>(imageViews.size());
-    QL_LOG_INFO("Binding {} textures to descriptor set", textureCount);
+    u32 samplerCount = static_cast<u32>(samplers.size());
+    QL_LOG_INFO("Binding {} textures and {} samplers to descriptor set", textureCount, samplerCount);
 
     // Build descriptor image info array for textures
     std::vector<VkDescriptorImageInfo> imageInfos(textureCount);
@@ -692,8 +868,8 @@ void RayTracingPipeline::BindTextures(const std::vector<VkImageView>& imageViews
     }
 
     // Build descriptor image info array for samplers
-    std::vector<VkDescriptorImageInfo> samplerInfos(textureCount);
-    for (u32 i = 0; i < textureCount; ++i) {
+    std::vector<VkDescriptorImageInfo> samplerInfos(samplerCount);
+    for (u32 i = 0; i < samplerCount; ++i) {
         samplerInfos[i].sampler = samplers[i];
         samplerInfos[i].imageView = VK_NULL_HANDLE;  // Image view is separate
         samplerInfos[i].imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;  // Not used for samplers
@@ -717,7 +893,7 @@ void RayTracingPipeline::BindTextures(const std::vector<VkImageView>& imageViews
     writes[1].dstBinding = 7;
     writes[1].dstArrayElement = 0;
     writes[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-    writes[1].descriptorCount = textureCount;
+    writes[1].descriptorCount = samplerCount;
     writes[1].pImageInfo = samplerInfos.data();
 
     vkUpdateDescriptorSets(device, static_cast<u32>(writes.size()), writes.data(), 0, nullptr);
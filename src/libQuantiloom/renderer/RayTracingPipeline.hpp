@@ -5,6 +5,7 @@
 #include "GpuBuffer.hpp"
 #include "GpuImage.hpp"
 #include "scene/Camera.hpp"
+#include "scene/Texture.hpp"
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <string>
@@ -14,6 +15,8 @@
 // ============================================================================
 // Responsibilities:
 // - Load and compile ray tracing shaders (SPIR-V)
+// - Reject shaders whose reflected bindings do not match the descriptor set
+//   layout (stale SPIR-V), see SpirvReflect.hpp
 // - Create VkRayTracingPipelineKHR with shader groups
 // - Build Shader Binding Table (SBT) with correct alignment
 // - Manage descriptor set layouts and descriptor sets
@@ -29,6 +32,13 @@ namespace quantiloom {
 
 class QL_API RayTracingPipeline {
 public:
+    // Bindless array capacities (must match MAX_TEXTURE_INDEX / MAX_SAMPLER_INDEX
+    // in closesthit.rchit). Samplers are deduplicated by TextureManager, so
+    // the sampler array holds one entry per distinct TextureSampler state and
+    // any scene fits.
+    static constexpr u32 MAX_TEXTURES = 1024;
+    static constexpr u32 MAX_SAMPLERS = TextureSampler::STATE_COUNT;
+
     // ========================================================================
     // Shader stage descriptors
     // ========================================================================
@@ -79,10 +89,23 @@ public:
 
     // Bind texture arrays (binding 6: textures, binding 7: samplers)
     // Uses bindless descriptor indexing (VK_EXT_descriptor_indexing)
-    // If imageViews is empty, binds a single dummy white texture
+    // The arrays are indexed independently: materials carry a texture index
+    // and a sampler index, so samplers may be shared by many textures
     void BindTextures(const std::vector<VkImageView>& imageViews,
                       const std::vector<VkSampler>& samplers);
 
+    // Bind RGB-to-spectrum table (binding 8, RgbToSpectrumTable::PackForGpu layout)
+    void BindSpectrumTableBuffer(const GpuBuffer& buffer);
+
+    // Bind measured spectral material table (binding 9, SpectralMaterialTable::entries)
+    void BindSpectralMaterialBuffer(const GpuBuffer& buffer);
+
+    // Bind Planck radiance table (binding 10, PlanckTable::PackForGpu layout)
+    void BindPlanckTableBuffer(const GpuBuffer& buffer);
+
+    // Bind AOV image (binding 11, RGBA32F: albedo, depth, octahedral normal)
+    void BindAovImage(const GpuImage& image);
+
     // Update all bindings (call after all Bind* calls)
     void UpdateDescriptorSets();
 
@@ -101,6 +124,11 @@ public:
     // ========================================================================
 
     VkPipeline GetPipeline() const { return m_pipeline; }
+
+    // Element stride the shaders use for the structured buffer at binding
+    // (from SPIR-V reflection, 0 if not a structured buffer); callers check
+    // it against the size of the C++ struct they upload there
+    u32 GetBufferStride(u32 binding) const;
     VkPipelineLayout GetPipelineLayout() const { return m_pipelineLayout; }
 
 private:
@@ -121,6 +149,16 @@ private:
     // Load SPIR-V shader from file
     std::vector<u32> LoadSPIRV(const std::string& path);
 
+    struct ShaderSource {
+        std::string path;
+        VkShaderStageFlagBits stage;
+        const std::vector<u32>* spirv;
+    };
+
+    // Check the shaders' reflected bindings against the descriptor set layout
+    // (throws on a mismatch) and record the structured buffer strides
+    void ValidateShaderBindings(const std::vector<ShaderSource>& shaders);
+
     // Create shader module from SPIR-V
     VkShaderModule CreateShaderModule(const std::vector<u32>& spirv);
 
@@ -147,6 +185,10 @@ private:
     VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
     VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
 
+    // Descriptor set layout bindings and the reflected buffer strides per binding
+    std::vector<VkDescriptorSetLayoutBinding> m_layoutBindings;
+    std::vector<u32> m_bufferStrides;
+
     // Shader Binding Table (SBT)
     std::unique_ptr<GpuBuffer> m_sbtBuffer;
     VkStridedDeviceAddressRegionKHR m_raygenRegion{};
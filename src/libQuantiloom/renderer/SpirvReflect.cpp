@@ -0,0 +1,163 @@
+#include "SpirvReflect.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: SPIR-V constants (SPIR-V specification, section 3)
+// ============================================================================
+
+namespace {
+
+constexpr u32 kMagic = 0x07230203;
+constexpr u32 kHeaderWords = 5;
+
+constexpr u32 kOpEntryPoint = 15;
+constexpr u32 kOpTypeRuntimeArray = 29;
+constexpr u32 kOpTypeStruct = 30;
+constexpr u32 kOpTypePointer = 32;
+constexpr u32 kOpVariable = 59;
+constexpr u32 kOpDecorate = 71;
+
+constexpr u32 kDecorationArrayStride = 6;
+constexpr u32 kDecorationBinding = 33;
+constexpr u32 kDecorationDescriptorSet = 34;
+
+// Words taken by the nul-terminated literal string starting at words[0]
+usize StringWords(const u32* words, usize available) {
+    for (usize i = 0; i < available; ++i) {
+        const u32 word = words[i];
+        if ((word & 0xFF) == 0 || (word & 0xFF00) == 0 || (word & 0xFF0000) == 0 || (word & 0xFF000000) == 0) {
+            return i + 1;
+        }
+    }
+    return available;
+}
+
+} // namespace
+
+// ============================================================================
+// SpirvReflection
+// ============================================================================
+
+Result<SpirvReflection, String> SpirvReflection::Parse(const std::vector<u32>& words) {
+    using R = Result<SpirvReflection, String>;
+
+    if (words.size() < kHeaderWords || words[0] != kMagic) {
+        return R::Err("Not a SPIR-V module (bad magic number)");
+    }
+    const u32 version = words[1];
+    const bool interfaceListsAll = version >= 0x00010400;  // SPIR-V 1.4+
+
+    std::unordered_map<u32, u32> sets;
+    std::unordered_map<u32, u32> bindings;
+    std::unordered_map<u32, u32> strides;
+    std::unordered_map<u32, u32> pointees;        // Pointer type -> pointee type
+    std::unordered_map<u32, u32> firstMembers;    // Struct type -> first member type
+    std::unordered_set<u32> runtimeArrays;
+    std::unordered_map<u32, u32> variableTypes;   // Variable -> pointer type
+    std::unordered_set<u32> interfaceIds;
+
+    for (usize at = kHeaderWords; at < words.size();) {
+        const u32 count = words[at] >> 16;
+        const u32 opcode = words[at] & 0xFFFF;
+        if (count == 0 || at + count > words.size()) {
+            return R::Err("Truncated SPIR-V instruction stream");
+        }
+        const u32* operands = &words[at + 1];
+        const usize operandCount = count - 1;
+
+        switch (opcode) {
+            case kOpEntryPoint:
+                if (operandCount >= 3) {
+                    const usize name = StringWords(operands + 2, operandCount - 2);
+                    for (usize i = 2 + name; i < operandCount; ++i) {
+                        interfaceIds.insert(operands[i]);
+                    }
+                }
+                break;
+            case kOpDecorate:
+                if (operandCount >= 3) {
+                    if (operands[1] == kDecorationDescriptorSet) {
+                        sets[operands[0]] = operands[2];
+                    } else if (operands[1] == kDecorationBinding) {
+                        bindings[operands[0]] = operands[2];
+                    } else if (operands[1] == kDecorationArrayStride) {
+                        strides[operands[0]] = operands[2];
+                    }
+                }
+                break;
+            case kOpTypePointer:
+                if (operandCount >= 3) {
+                    pointees[operands[0]] = operands[2];
+                }
+                break;
+            case kOpTypeStruct:
+                if (operandCount >= 2) {
+                    firstMembers[operands[0]] = operands[1];
+                }
+                break;
+            case kOpTypeRuntimeArray:
+                if (operandCount >= 2) {
+                    runtimeArrays.insert(operands[0]);
+                }
+                break;
+            case kOpVariable:
+                if (operandCount >= 2) {
+                    variableTypes[operands[1]] = operands[0];
+                }
+                break;
+            default:
+                break;
+        }
+        at += count;
+    }
+
+    SpirvReflection reflection;
+    for (const auto& [variable, binding] : bindings) {
+        if (variableTypes.find(variable) == variableTypes.end()) {
+            continue;  // Binding decoration on something other than a variable
+        }
+        if (interfaceListsAll && interfaceIds.find(variable) == interfaceIds.end()) {
+            continue;  // Declared but not used by any entry point
+        }
+
+        SpirvBinding entry;
+        entry.binding = binding;
+        if (auto set = sets.find(variable); set != sets.end()) {
+            entry.set = set->second;
+        }
+
+        // StructuredBuffer<T>: pointer -> struct { T[] } with ArrayStride on T[]
+        auto pointee = pointees.find(variableTypes[variable]);
+        if (pointee != pointees.end()) {
+            auto member = firstMembers.find(pointee->second);
+            if (member != firstMembers.end() && runtimeArrays.count(member->second) != 0) {
+                if (auto stride = strides.find(member->second); stride != strides.end()) {
+                    entry.arrayStride = stride->second;
+                }
+            }
+        }
+        reflection.m_bindings.push_back(entry);
+    }
+
+    std::sort(reflection.m_bindings.begin(), reflection.m_bindings.end(),
+              [](const SpirvBinding& a, const SpirvBinding& b) {
+                  return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+              });
+    return reflection;
+}
+
+const SpirvBinding* SpirvReflection::FindBinding(u32 set, u32 binding) const {
+    for (const SpirvBinding& entry : m_bindings) {
+        if (entry.set == set && entry.binding == binding) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace quantiloom
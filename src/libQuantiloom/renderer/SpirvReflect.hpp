@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include <vector>
+
+// ============================================================================
+// SpirvReflection - Descriptor bindings declared by a SPIR-V module
+// ============================================================================
+// Minimal reflection for validating a pipeline layout against the shaders it
+// runs: which (set, binding) pairs the entry points use and, for structured
+// buffers, the array stride the compiler laid the element struct out with.
+// A mismatch means the SPIR-V was built from other HLSL than the C++ side
+// (e.g. stale binaries after a layout change) and would read garbage.
+//
+// Only the instructions needed for this are decoded (OpEntryPoint, OpDecorate,
+// OpVariable, pointer / struct / array types); everything else is skipped.
+// For SPIR-V 1.4+ the entry point interfaces list every global the shader
+// references, so only those variables are reported; older modules report
+// every decorated variable.
+//
+// Usage:
+//   auto reflection = SpirvReflection::Parse(words);
+//   if (const SpirvBinding* b = reflection.value().FindBinding(0, 5)) {
+//       if (b->arrayStride != sizeof(MaterialDataCPU)) { ... }
+//   }
+// ============================================================================
+
+namespace quantiloom {
+
+struct SpirvBinding {
+    u32 set = 0;
+    u32 binding = 0;
+    u32 arrayStride = 0;  // Element stride of a structured buffer, 0 otherwise
+};
+
+class QL_API SpirvReflection {
+public:
+    // Decode a module; fails on a bad header or truncated instruction stream
+    static Result<SpirvReflection, String> Parse(const std::vector<u32>& words);
+
+    // Bindings used by the module's entry points, sorted by (set, binding)
+    const std::vector<SpirvBinding>& GetBindings() const { return m_bindings; }
+
+    // nullptr if the module does not use (set, binding)
+    const SpirvBinding* FindBinding(u32 set, u32 binding) const;
+
+private:
+    std::vector<SpirvBinding> m_bindings;
+};
+
+} // namespace quantiloom
@@ -2,7 +2,9 @@
 #include "GpuBuffer.hpp"
 #include "CommandHelper.hpp"
 #include "core/Log.hpp"
+#include "core/Profiler.hpp"
 #include <stdexcept>
+#include <algorithm>
 #include <cstring>
 
 namespace quantiloom {
@@ -33,12 +35,15 @@ TextureManager::~TextureManager() {
 // ============================================================================
 
 void TextureManager::UploadTextures(const std::vector<Texture>& textures) {
+    QL_PROFILE_SCOPE("TextureManager::UploadTextures");
     // Clear previous state
     m_images.clear();
     for (VkSampler sampler : m_samplers) {
         vkDestroySampler(m_context.GetDevice(), sampler, nullptr);
     }
     m_samplers.clear();
+    m_samplerStates.clear();
+    m_textureSamplerIndices.clear();
     m_imageViews.clear();
 
     // Handle empty texture list: create dummy 1x1 white texture
@@ -47,7 +52,7 @@ void TextureManager::UploadTextures(const std::vector<Texture>& textures) {
         Texture dummyTex = CreateDummyTexture();
 
         m_images.push_back(UploadTexture(dummyTex));
-        m_samplers.push_back(CreateSampler(dummyTex.sampler));
+        m_textureSamplerIndices.push_back(AcquireSampler(dummyTex.sampler));
         m_imageViews.push_back(m_images.back()->GetView());
 
         return;
@@ -60,48 +65,89 @@ void TextureManager::UploadTextures(const std::vector<Texture>& textures) {
         // Upload texture to GPU
         auto gpuImage = UploadTexture(texture);
 
-        // Create sampler for this texture
-        VkSampler sampler = CreateSampler(texture.sampler);
+        // Share a sampler with any previous texture using the same state
+        m_textureSamplerIndices.push_back(AcquireSampler(texture.sampler));
 
         // Store resources
         m_imageViews.push_back(gpuImage->GetView());
-        m_samplers.push_back(sampler);
         m_images.push_back(std::move(gpuImage));
     }
 
-    QL_LOG_INFO("  Texture upload complete: {} textures, {} samplers",
+    QL_LOG_INFO("  Texture upload complete: {} textures, {} unique samplers",
                 m_images.size(), m_samplers.size());
 }
 
+i32 TextureManager::GetSamplerIndex(i32 textureIndex) const {
+    if (textureIndex < 0 || static_cast<usize>(textureIndex) >= m_textureSamplerIndices.size()) {
+        return -1;
+    }
+    return static_cast<i32>(m_textureSamplerIndices[textureIndex]);
+}
+
 // ============================================================================
 // Internal Helper Functions
 // ============================================================================
 
 std::unique_ptr<GpuImage> TextureManager::UploadTexture(const Texture& texture) {
+    QL_PROFILE_SCOPE("TextureManager::UploadTexture");
     // Validate texture data
     if (texture.pixels.empty()) {
         QL_LOG_ERROR("Texture '{}' has no pixel data", texture.name);
         throw std::runtime_error("Cannot upload empty texture");
     }
 
-    if (texture.channels != 4) {
-        QL_LOG_ERROR("Texture '{}' has {} channels (expected 4 for RGBA8)",
-                     texture.name, texture.channels);
-        throw std::runtime_error("Only RGBA8 textures are supported");
+    // Block-compressed upload needs device support; otherwise fall back to RGBA8
+    const bool useBlocks = texture.IsCompressed() && m_context.IsTextureCompressionBCSupported();
+    if (texture.IsCompressed() && !useBlocks) {
+        QL_LOG_WARN("Texture '{}': BC formats not supported by device, uploading RGBA8",
+                    texture.name);
     }
 
-    VkDeviceSize bufferSize = static_cast<VkDeviceSize>(texture.width) * texture.height * 4;
+    if (!useBlocks) {
+        if (texture.channels != 4) {
+            QL_LOG_ERROR("Texture '{}' has {} channels (expected 4 for RGBA8)",
+                         texture.name, texture.channels);
+            throw std::runtime_error("Only RGBA8 textures are supported");
+        }
+
+        VkDeviceSize baseSize = static_cast<VkDeviceSize>(texture.width) * texture.height * 4;
 
-    if (texture.pixels.size() != bufferSize) {
-        QL_LOG_ERROR("Texture '{}' pixel data size mismatch: expected {} bytes, got {}",
-                     texture.name, bufferSize, texture.pixels.size());
-        throw std::runtime_error("Texture pixel data size mismatch");
+        if (texture.pixels.size() != baseSize) {
+            QL_LOG_ERROR("Texture '{}' pixel data size mismatch: expected {} bytes, got {}",
+                         texture.name, baseSize, texture.pixels.size());
+            throw std::runtime_error("Texture pixel data size mismatch");
+        }
+    }
+
+    // Colour textures are stored sRGB-encoded; the hardware decodes them to
+    // linear before filtering (matches the gamma-correct mip generation)
+    const VkFormat format = useBlocks
+        ? ToVkFormat(texture.compression, texture.usage)
+        : (texture.usage == TextureUsage::Color ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+
+    // BC4 holds one channel; present it as grayscale (RRR1) like the CPU decoder
+    VkComponentMapping components{};
+    if (useBlocks && texture.compression == TextureCompression::BC4) {
+        components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R,
+                      VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
     }
 
-    QL_LOG_INFO("  Uploading texture '{}': {}x{} RGBA8 ({} bytes)",
-                texture.name, texture.width, texture.height, bufferSize);
+    auto levelData = [&](u32 level) -> const std::vector<u8>& {
+        return useBlocks ? texture.blockLevels[level].blocks : texture.GetMipPixels(level);
+    };
+
+    const u32 mipLevels = texture.GetMipCount();
+    VkDeviceSize bufferSize = 0;
+    for (u32 level = 0; level < mipLevels; ++level) {
+        bufferSize += levelData(level).size();
+    }
 
-    // Step 1: Create staging buffer (CPU-accessible)
+    QL_LOG_DEBUG("  Uploading texture '{}': {}x{} {}, {} mip level(s) ({} bytes)",
+                texture.name, texture.width, texture.height,
+                useBlocks ? "BCn" : "RGBA8", mipLevels, bufferSize);
+    QL_PROFILE_COUNTER("Texture upload bytes", bufferSize);
+
+    // Step 1: Create staging buffer (CPU-accessible, all levels back to back)
     GpuBuffer stagingBuffer(
         m_context.GetAllocator(),
         bufferSize,
@@ -109,21 +155,43 @@ std::unique_ptr<GpuImage> TextureManager::UploadTexture(const Texture& texture)
         VMA_MEMORY_USAGE_CPU_ONLY
     );
 
-    // Step 2: Upload CPU pixel data to staging buffer
-    void* data = stagingBuffer.Map();
-    std::memcpy(data, texture.pixels.data(), bufferSize);
+    // Step 2: Upload CPU pixel/block data to staging buffer (one copy region per level)
+    std::vector<VkBufferImageCopy> regions;
+    regions.reserve(mipLevels);
+
+    u8* data = static_cast<u8*>(stagingBuffer.Map());
+    VkDeviceSize offset = 0;
+    for (u32 level = 0; level < mipLevels; ++level) {
+        const auto& levelBytes = levelData(level);
+        std::memcpy(data + offset, levelBytes.data(), levelBytes.size());
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.bufferRowLength = 0;   // Tightly packed (texels or 4x4 blocks)
+        region.bufferImageHeight = 0; // Tightly packed
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {texture.GetMipWidth(level), texture.GetMipHeight(level), 1};
+        regions.push_back(region);
+
+        offset += levelBytes.size();
+    }
     stagingBuffer.Unmap();
 
-    // Step 3: Create device-local GPU image (RGBA8_UNORM)
+    // Step 3: Create device-local GPU image with the full mip chain
     auto gpuImage = std::make_unique<GpuImage>(
         m_context.GetAllocator(),
         m_context.GetDevice(),
         texture.width,
         texture.height,
-        VK_FORMAT_R8G8B8A8_UNORM,  // Standard 8-bit RGBA format
+        format,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VMA_MEMORY_USAGE_GPU_ONLY,
-        1  // mipLevels (no mipmapping for M1)
+        mipLevels,
+        components
     );
 
     // Step 4: Execute upload via command buffer
@@ -132,48 +200,49 @@ std::unique_ptr<GpuImage> TextureManager::UploadTexture(const Texture& texture)
         CommandHelper::TransitionImageLayout(
             cmd,
             gpuImage->GetImage(),
-            VK_FORMAT_R8G8B8A8_UNORM,
+            format,
             VK_IMAGE_LAYOUT_UNDEFINED,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1  // mipLevels
+            mipLevels
         );
 
-        // Define copy region (buffer -> image)
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;   // Tightly packed
-        region.bufferImageHeight = 0; // Tightly packed
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {texture.width, texture.height, 1};
-
-        // Copy staging buffer to GPU image
+        // Copy staging buffer to GPU image (all levels in one command)
         vkCmdCopyBufferToImage(
             cmd,
             stagingBuffer.GetHandle(),
             gpuImage->GetImage(),
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region
+            static_cast<u32>(regions.size()),
+            regions.data()
         );
 
         // Transition: TRANSFER_DST_OPTIMAL -> SHADER_READ_ONLY_OPTIMAL
         CommandHelper::TransitionImageLayout(
             cmd,
             gpuImage->GetImage(),
-            VK_FORMAT_R8G8B8A8_UNORM,
+            format,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            1  // mipLevels
+            mipLevels
         );
     });
 
     return gpuImage;
 }
 
+u32 TextureManager::AcquireSampler(const TextureSampler& samplerInfo) {
+    // Linear search: scenes only use a handful of distinct sampler states
+    for (usize i = 0; i < m_samplerStates.size(); ++i) {
+        if (m_samplerStates[i] == samplerInfo) {
+            return static_cast<u32>(i);
+        }
+    }
+
+    m_samplers.push_back(CreateSampler(samplerInfo));
+    m_samplerStates.push_back(samplerInfo);
+    return static_cast<u32>(m_samplers.size() - 1);
+}
+
 VkSampler TextureManager::CreateSampler(const TextureSampler& samplerInfo) {
     VkSamplerCreateInfo samplerCreateInfo{};
     samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -187,9 +256,15 @@ VkSampler TextureManager::CreateSampler(const TextureSampler& samplerInfo) {
     samplerCreateInfo.addressModeV = ToVkAddressMode(samplerInfo.wrapT);
     samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;  // Default for W
 
-    // Anisotropy (disabled for M1 - can be enabled in M2+ if needed)
-    samplerCreateInfo.anisotropyEnable = VK_FALSE;
-    samplerCreateInfo.maxAnisotropy = 1.0f;
+    // Anisotropy (shaders pass ray-cone gradients via SampleGrad)
+    if (m_context.IsSamplerAnisotropySupported()) {
+        samplerCreateInfo.anisotropyEnable = VK_TRUE;
+        samplerCreateInfo.maxAnisotropy = std::min(
+            16.0f, m_context.GetDeviceProperties().limits.maxSamplerAnisotropy);
+    } else {
+        samplerCreateInfo.anisotropyEnable = VK_FALSE;
+        samplerCreateInfo.maxAnisotropy = 1.0f;
+    }
 
     // Border color (for clamp-to-border mode, not used in glTF)
     samplerCreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
@@ -201,11 +276,13 @@ VkSampler TextureManager::CreateSampler(const TextureSampler& samplerInfo) {
     samplerCreateInfo.compareEnable = VK_FALSE;
     samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 
-    // Mipmapping (disabled for M1)
-    samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    // Mipmapping (LOD comes from the ray-cone footprint in the shader)
+    samplerCreateInfo.mipmapMode = (samplerInfo.mipFilter == TextureSampler::Filter::Nearest)
+        ? VK_SAMPLER_MIPMAP_MODE_NEAREST
+        : VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerCreateInfo.mipLodBias = 0.0f;
     samplerCreateInfo.minLod = 0.0f;
-    samplerCreateInfo.maxLod = 0.0f;  // No mipmaps
+    samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;  // Clamped to the image's mip count
 
     VkSampler sampler;
     VkResult result = vkCreateSampler(m_context.GetDevice(), &samplerCreateInfo, nullptr, &sampler);
@@ -230,6 +307,23 @@ VkFilter TextureManager::ToVkFilter(TextureSampler::Filter filter) {
     }
 }
 
+VkFormat TextureManager::ToVkFormat(TextureCompression compression, TextureUsage usage) {
+    const bool srgb = (usage == TextureUsage::Color);
+    switch (compression) {
+        case TextureCompression::BC1:
+            return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case TextureCompression::BC4:
+            return VK_FORMAT_BC4_UNORM_BLOCK;
+        case TextureCompression::BC5:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureCompression::BC7:
+            return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        case TextureCompression::None:
+        default:
+            return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
 VkSamplerAddressMode TextureManager::ToVkAddressMode(TextureSampler::WrapMode wrapMode) {
     switch (wrapMode) {
         case TextureSampler::WrapMode::Repeat:
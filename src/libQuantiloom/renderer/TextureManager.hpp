@@ -14,14 +14,19 @@
 // ============================================================================
 // Responsibilities:
 // - Upload CPU Texture objects to GPU VkImage resources
-// - Create VkSampler for each texture based on TextureSampler settings
+// - Create one VkSampler per unique TextureSampler state (deduplicated)
 // - Manage lifetime of all texture resources (RAII)
 // - Provide arrays of VkImageView and VkSampler for bindless descriptor sets
 //
 // Architecture:
 // - One GpuImage per texture (VkImage + VkImageView)
-// - One VkSampler per texture (filter + wrap mode)
-// - All textures uploaded to RGBA8_UNORM format
+// - One VkSampler per distinct sampler state (filter + wrap mode + mip mode,
+//   anisotropic); textures reference it via GetSamplerIndex(). Sampler count
+//   is at most TextureSampler::STATE_COUNT regardless of texture count, and
+//   binding 7 is sized for all of them (RayTracingPipeline::MAX_SAMPLERS).
+// - All mip levels uploaded in a single copy from one staging buffer
+// - Color textures use RGBA8_SRGB, Data/Normal textures use RGBA8_UNORM
+// - Block-compressed textures upload their BCn blocks directly (BC1/4/5/7)
 // - Image layout: VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
 //
 // Usage:
@@ -31,6 +36,9 @@
 //   // Bind to descriptor set
 //   const auto& views = texMgr.GetImageViews();
 //   const auto& samplers = texMgr.GetSamplers();
+//
+//   // Per-material sampler index (written into MaterialData)
+//   i32 samplerIndex = texMgr.GetSamplerIndex(material.baseColorTextureIndex);
 // ============================================================================
 
 namespace quantiloom {
@@ -54,8 +62,8 @@ public:
     // ========================================================================
 
     // Upload all textures from CPU to GPU
-    // - Creates VkImage + VkImageView for each texture (RGBA8_UNORM)
-    // - Creates VkSampler based on TextureSampler settings
+    // - Creates VkImage + VkImageView for each texture (RGBA8, full mip chain)
+    // - Reuses or creates a VkSampler matching the TextureSampler settings
     // - Uploads pixel data via staging buffer
     // - Transitions layout to SHADER_READ_ONLY_OPTIMAL
     //
@@ -74,10 +82,17 @@ public:
     // Index matches original texture index from scene
     const std::vector<VkImageView>& GetImageViews() const { return m_imageViews; }
 
-    // Get array of VkSampler handles (for descriptor set binding)
-    // Index matches original texture index from scene
+    // Get number of unique samplers
+    u32 GetSamplerCount() const { return static_cast<u32>(m_samplers.size()); }
+
+    // Get array of unique VkSampler handles (for descriptor set binding)
+    // Index with GetSamplerIndex(), NOT with the texture index
     const std::vector<VkSampler>& GetSamplers() const { return m_samplers; }
 
+    // Get the sampler index used by a texture
+    // Returns -1 for a negative (absent) or out-of-range texture index
+    i32 GetSamplerIndex(i32 textureIndex) const;
+
     // Check if textures have been uploaded
     bool IsEmpty() const { return m_images.empty(); }
 
@@ -90,12 +105,18 @@ private:
     // Returns GpuImage containing VkImage + VkImageView
     std::unique_ptr<GpuImage> UploadTexture(const Texture& texture);
 
+    // Return the index of a sampler matching samplerInfo, creating it if needed
+    u32 AcquireSampler(const TextureSampler& samplerInfo);
+
     // Create VkSampler based on TextureSampler settings
     VkSampler CreateSampler(const TextureSampler& samplerInfo);
 
     // Convert TextureSampler::Filter to VkFilter
     static VkFilter ToVkFilter(TextureSampler::Filter filter);
 
+    // Convert TextureCompression (+ usage for sRGB) to a block VkFormat
+    static VkFormat ToVkFormat(TextureCompression compression, TextureUsage usage);
+
     // Convert TextureSampler::WrapMode to VkSamplerAddressMode
     static VkSamplerAddressMode ToVkAddressMode(TextureSampler::WrapMode wrapMode);
 
@@ -111,8 +132,12 @@ private:
     // GPU image resources (VkImage + VkImageView managed by GpuImage)
     std::vector<std::unique_ptr<GpuImage>> m_images;
 
-    // VkSampler objects (created manually, must be destroyed in destructor)
+    // Unique VkSampler objects (created manually, must be destroyed in destructor)
     std::vector<VkSampler> m_samplers;
+    std::vector<TextureSampler> m_samplerStates;  // State of each m_samplers entry
+
+    // Sampler index per texture (index into m_samplers)
+    std::vector<u32> m_textureSamplerIndices;
 
     // Cached arrays for descriptor binding (updated after upload)
     std::vector<VkImageView> m_imageViews;  // Extracted from m_images
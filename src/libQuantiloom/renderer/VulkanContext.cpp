@@ -268,6 +268,7 @@ void VulkanContext::CreateDevice() {
     features12.runtimeDescriptorArray = VK_TRUE;
     features12.descriptorBindingPartiallyBound = VK_TRUE;  // Required for PARTIALLY_BOUND_BIT
     features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;  // Required for NonUniformResourceIndex
+    features12.scalarBlockLayout = VK_TRUE;  // Shaders use C-like buffer layouts (-fvk-use-scalar-layout)
     features12.pNext = &features13;
 
     // Enable Ray Tracing features
@@ -287,9 +288,16 @@ void VulkanContext::CreateDevice() {
     asFeatures.accelerationStructure = VK_TRUE;
     asFeatures.pNext = &rayQueryFeatures;
 
-    // Device features
+    // Device features (optional core features enabled only when supported)
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+    m_samplerAnisotropySupported = (supportedFeatures.samplerAnisotropy == VK_TRUE);
+    m_textureCompressionBCSupported = (supportedFeatures.textureCompressionBC == VK_TRUE);
+
     VkPhysicalDeviceFeatures2 deviceFeatures{};
     deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures.features.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    deviceFeatures.features.textureCompressionBC = supportedFeatures.textureCompressionBC;
     deviceFeatures.pNext = &asFeatures;
 
     // Device creation
@@ -65,6 +65,12 @@ public:
     // Check if Ray Tracing is supported
     bool IsRayTracingSupported() const { return m_rayTracingSupported; }
 
+    // Check if anisotropic texture filtering is enabled on the device
+    bool IsSamplerAnisotropySupported() const { return m_samplerAnisotropySupported; }
+
+    // Check if BC1-BC7 compressed image formats are enabled on the device
+    bool IsTextureCompressionBCSupported() const { return m_textureCompressionBCSupported; }
+
     // Get Ray Tracing properties (only valid if IsRayTracingSupported() == true)
     const VkPhysicalDeviceRayTracingPipelinePropertiesKHR& GetRayTracingProperties() const {
         return m_rtPipelineProperties;
@@ -110,6 +116,8 @@ private:
 
     VkPhysicalDeviceProperties m_deviceProperties{};
     bool m_rayTracingSupported = false;
+    bool m_samplerAnisotropySupported = false;
+    bool m_textureCompressionBCSupported = false;
 
     // Ray Tracing properties (if supported)
     VkPhysicalDeviceRayTracingPipelinePropertiesKHR m_rtPipelineProperties{};
@@ -23,7 +23,23 @@ struct CameraData {
     f32 wavelength_nm;       // Current wavelength (nanometers) for spectral rendering
     glm::vec3 up;            // Up vector (normalized)
     f32 _pad1;               // Padding for alignment
+
+    // Region and samples of this dispatch (set by the renderer): the launch
+    // covers pixels [tileOffset, tileOffset + launch size) of an
+    // imageWidth x imageHeight image (0 = the launch size) and averages
+    // samples [sampleStart, sampleStart + sampleCount). Sample 0 is the pixel
+    // centre; later samples are jittered by Philox4x32(pixel, sample) keyed
+    // by the seed, so any split of tiles and samples gives the same values.
+    u32 tileOffsetX = 0;
+    u32 tileOffsetY = 0;
+    u32 imageWidth = 0;
+    u32 imageHeight = 0;
+    u32 sampleStart = 0;
+    u32 sampleCount = 1;
+    u32 seedLo = 0;
+    u32 seedHi = 0;
 };
+static_assert(sizeof(CameraData) == 96, "CameraData must match the shader push constants");
 
 class QL_API Camera {
 public:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/Types.hpp"
+#include "core/RgbToSpectrum.hpp"
 #include <glm/glm.hpp>
 #include <string>
 
@@ -15,7 +16,10 @@
 // - Alpha blending modes
 //
 // For spectral rendering (M1 compatibility):
-// - spectralAlbedo: Scalar reflectance computed from baseColorFactor
+// - spectralAlbedo: Reflectance of baseColorFactor at the render wavelength,
+//   uplifted through an RgbToSpectrumTable (grey average if none is loaded)
+// - spectralMaterialIndex: Measured spectrum bound by name, which takes
+//   precedence over the uplift (see SpectralMaterial.hpp)
 //
 // Texture binding:
 // - Texture indices refer to Scene::textures array
@@ -71,10 +75,23 @@ struct Material {
     // Spectral Mode (M1 compatibility)
     // ========================================================================
     // Scalar spectral reflectance for single-wavelength rendering
-    // Computed from baseColorFactor during scene loading:
-    //   spectralAlbedo = (R + G + B) / 3.0
+    // Computed from baseColorFactor by ComputeSpectralAlbedo(table, wavelength);
+    // scene loading initialises it with the grey fallback (R + G + B) / 3
     f32 spectralAlbedo = 0.8f;
 
+    // Row in the SpectralMaterialTable of a bound measured spectrum
+    // (-1 = none; reflectance then comes from the RGB uplift)
+    i32 spectralMaterialIndex = -1;
+
+    // ========================================================================
+    // Thermal Emission (see PlanckTable.hpp)
+    // ========================================================================
+    // Emitted radiance = emissivity(band) * B_band(T). Emissivity comes from
+    // the bound measured spectrum, else 1 - reflectance (opaque body)
+    f32 temperatureK = 0.0f;               // Surface temperature (K), 0 = no thermal emission
+    i32 temperatureTextureIndex = -1;      // Per-texel temperature map (R channel), -1 = uniform
+    glm::vec2 temperatureRangeK{0.0f, 0.0f};  // Temperatures of map values 0 and 1
+
     // ========================================================================
     // Metadata
     // ========================================================================
@@ -103,20 +120,36 @@ struct Material {
             return false;
         }
 
+        // Temperatures are absolute
+        if (temperatureK < 0.0f || temperatureRangeK.x < 0.0f || temperatureRangeK.y < 0.0f) {
+            return false;
+        }
+
         return true;
     }
 
-    // Compute spectral albedo from base color (for M1 mode)
+    // Grey fallback when no RGB-to-spectrum table is available (wavelength independent)
     void ComputeSpectralAlbedo() {
         spectralAlbedo = (baseColorFactor.r + baseColorFactor.g + baseColorFactor.b) / 3.0f;
     }
 
+    // Reflectance of the base colour's smooth spectrum at a wavelength
+    void ComputeSpectralAlbedo(const RgbToSpectrumTable& table, f32 wavelengthNm) {
+        spectralAlbedo = table.EvaluateReflectance(glm::vec3(baseColorFactor), wavelengthNm);
+    }
+
     // Check if material has any textures
     bool HasTextures() const {
         return baseColorTextureIndex != -1 ||
                metallicRoughnessTextureIndex != -1 ||
                normalTextureIndex != -1 ||
-               emissiveTextureIndex != -1;
+               emissiveTextureIndex != -1 ||
+               temperatureTextureIndex != -1;
+    }
+
+    // Check if material emits thermal radiation
+    bool IsThermalEmitter() const {
+        return temperatureK > 0.0f || temperatureTextureIndex != -1;
     }
 
     // Create simple Lambertian material (for procedural geometry)
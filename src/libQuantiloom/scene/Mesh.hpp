@@ -3,6 +3,7 @@
 #include "core/Types.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <memory_resource>
 #include <vector>
 #include <string>
 
@@ -23,24 +24,58 @@
 // - BLAS is instanced in TLAS with transform and material ID
 //
 // Memory layout:
-// - All data stored in CPU memory (std::vector)
+// - All data stored in CPU memory (std::pmr::vector)
 // - Upload to GPU happens in AccelerationStructure::BuildBLAS()
+//
+// Allocation:
+// - Allocator-aware: vectors use the memory resource given at construction
+//   (GltfLoader passes the scene's Arena, see Scene::geometryArena), and a
+//   pmr::vector<GeometryPrimitive> hands its resource down to its elements
+// - Default-constructed primitives use the default (heap) resource
+// - Copies always go to the default resource; moves keep the resource
 // ============================================================================
 
 namespace quantiloom {
 
 struct GeometryPrimitive {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     // Vertex attributes
-    std::vector<glm::vec3> positions;  // Vertex positions (object space)
-    std::vector<glm::vec3> normals;    // Vertex normals (normalized, object space)
-    std::vector<glm::vec2> uvs;        // Texture coordinates [0, 1]
+    std::pmr::vector<glm::vec3> positions;  // Vertex positions (object space)
+    std::pmr::vector<glm::vec3> normals;    // Vertex normals (normalized, object space)
+    std::pmr::vector<glm::vec2> uvs;        // Texture coordinates [0, 1]
 
     // Triangle indices (3 per triangle)
-    std::vector<u32> indices;
+    std::pmr::vector<u32> indices;
 
     // Material binding
     u32 materialId = 0;  // Index into Scene::materials
 
+    // ========================================================================
+    // Construction
+    // ========================================================================
+
+    GeometryPrimitive() = default;
+    GeometryPrimitive(const GeometryPrimitive&) = default;
+    GeometryPrimitive(GeometryPrimitive&&) = default;
+    GeometryPrimitive& operator=(const GeometryPrimitive&) = default;
+    GeometryPrimitive& operator=(GeometryPrimitive&&) = default;
+
+    explicit GeometryPrimitive(const allocator_type& alloc)
+        : positions(alloc), normals(alloc), uvs(alloc), indices(alloc) {}
+
+    GeometryPrimitive(const GeometryPrimitive& other, const allocator_type& alloc)
+        : positions(other.positions, alloc), normals(other.normals, alloc)
+        , uvs(other.uvs, alloc), indices(other.indices, alloc)
+        , materialId(other.materialId) {}
+
+    GeometryPrimitive(GeometryPrimitive&& other, const allocator_type& alloc)
+        : positions(std::move(other.positions), alloc), normals(std::move(other.normals), alloc)
+        , uvs(std::move(other.uvs), alloc), indices(std::move(other.indices), alloc)
+        , materialId(other.materialId) {}
+
+    allocator_type get_allocator() const { return positions.get_allocator(); }
+
     // ========================================================================
     // Utilities
     // ========================================================================
@@ -123,12 +158,35 @@ struct GeometryPrimitive {
 // ============================================================================
 
 struct Mesh {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     // Geometry primitives (at least one required)
-    std::vector<GeometryPrimitive> primitives;
+    std::pmr::vector<GeometryPrimitive> primitives;
 
     // Metadata
     String name;  // Mesh name (for debugging)
 
+    // ========================================================================
+    // Construction (allocator-aware, see GeometryPrimitive)
+    // ========================================================================
+
+    Mesh() = default;
+    Mesh(const Mesh&) = default;
+    Mesh(Mesh&&) = default;
+    Mesh& operator=(const Mesh&) = default;
+    Mesh& operator=(Mesh&&) = default;
+
+    explicit Mesh(const allocator_type& alloc)
+        : primitives(alloc) {}
+
+    Mesh(const Mesh& other, const allocator_type& alloc)
+        : primitives(other.primitives, alloc), name(other.name) {}
+
+    Mesh(Mesh&& other, const allocator_type& alloc)
+        : primitives(std::move(other.primitives), alloc), name(std::move(other.name)) {}
+
+    allocator_type get_allocator() const { return primitives.get_allocator(); }
+
     // ========================================================================
     // Utilities
     // ========================================================================
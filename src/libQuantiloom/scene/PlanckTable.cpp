@@ -0,0 +1,57 @@
+#include "PlanckTable.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+
+#include <cmath>
+
+namespace quantiloom {
+
+f64 PlanckTable::SpectralRadiance(f64 wavelengthNm, f64 temperatureK) {
+    if (wavelengthNm <= 0.0 || temperatureK <= 0.0) {
+        return 0.0;
+    }
+
+    using namespace constants;
+    const f64 lambda = wavelengthNm * 1e-9;  // m
+    const f64 exponent = PLANCK_CONSTANT * SPEED_OF_LIGHT / (lambda * BOLTZMANN_CONSTANT * temperatureK);
+    const f64 perMetre = 2.0 * PLANCK_CONSTANT * SPEED_OF_LIGHT * SPEED_OF_LIGHT /
+                         (std::pow(lambda, 5.0) * std::expm1(exponent));
+    return perMetre * 1e-9;  // W/m^2/sr/m -> W/m^2/sr/nm
+}
+
+std::vector<f32> PlanckTable::PackForGpu() const {
+    std::vector<f32> packed;
+    packed.reserve(4 + radiance.size());
+    packed.push_back(temperatureMin);
+    packed.push_back(temperatureMax);
+    packed.push_back(static_cast<f32>(temperatureBins));
+    packed.push_back(static_cast<f32>(bandCount));
+    packed.insert(packed.end(), radiance.begin(), radiance.end());
+    return packed;
+}
+
+PlanckTable PlanckTable::Build(const std::vector<SpectralBand>& bands,
+                               f32 temperatureMin, f32 temperatureMax, u32 temperatureBins) {
+    PlanckTable table;
+    table.temperatureMin = temperatureMin;
+    table.temperatureMax = temperatureMax;
+    table.temperatureBins = std::max(temperatureBins, 2u);
+    table.bandCount = static_cast<u32>(bands.size());
+    table.radiance.resize(static_cast<usize>(table.bandCount) * table.temperatureBins);
+
+    const f64 step = (static_cast<f64>(temperatureMax) - temperatureMin) / (table.temperatureBins - 1);
+    ParallelFor(bands.size(), 1, [&](usize b) {
+        f32* row = table.radiance.data() + b * table.temperatureBins;
+        for (u32 i = 0; i < table.temperatureBins; ++i) {
+            const f64 temperature = temperatureMin + step * i;
+            row[i] = static_cast<f32>(bands[b].Average(
+                [&](f64 lambda) { return SpectralRadiance(lambda, temperature); }));
+        }
+    });
+
+    QL_LOG_INFO("PlanckTable: {} band(s) x {} bins, {:.0f}-{:.0f} K",
+                table.bandCount, table.temperatureBins, temperatureMin, temperatureMax);
+    return table;
+}
+
+} // namespace quantiloom
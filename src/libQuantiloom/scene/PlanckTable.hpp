@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "SpectralBand.hpp"
+#include <algorithm>
+#include <vector>
+
+// ============================================================================
+// PlanckTable - Band-integrated blackbody radiance per (band, temperature)
+// ============================================================================
+// Thermal emission of a surface at temperature T in a band is
+//
+//   L_e = emissivity(band) * B_band(T)
+//
+// where B_band is Planck's law averaged over the band response. Evaluating
+// B needs an exp() per wavelength sample, so B_band is tabulated once per run
+// on a uniform temperature grid and looked up with linear interpolation in T
+// (two loads per hit). Temperatures outside [temperatureMin, temperatureMax]
+// are clamped.
+//
+// Units: W/m^2/sr/nm (same as the atmosphere LUT), temperatures in Kelvin.
+//
+// Table layout (PackForGpu, binding 10):
+//   [0] temperatureMin, [1] temperatureMax, [2] temperature bins,
+//   [3] band count, radiance[band][bin]
+// ============================================================================
+
+namespace quantiloom {
+
+struct QL_API PlanckTable {
+    static constexpr f32 DEFAULT_TEMPERATURE_MIN = 200.0f;   // K
+    static constexpr f32 DEFAULT_TEMPERATURE_MAX = 1500.0f;  // K
+    static constexpr u32 DEFAULT_TEMPERATURE_BINS = 1024;
+
+    f32 temperatureMin = DEFAULT_TEMPERATURE_MIN;
+    f32 temperatureMax = DEFAULT_TEMPERATURE_MAX;
+    u32 temperatureBins = 0;
+    u32 bandCount = 0;
+    std::vector<f32> radiance;  // [bandCount * temperatureBins]
+
+    bool IsValid() const {
+        return temperatureBins >= 2 && bandCount > 0 && temperatureMax > temperatureMin &&
+               radiance.size() == static_cast<usize>(bandCount) * temperatureBins;
+    }
+
+    // Band radiance of a blackbody at a temperature (linear in T between bins)
+    f32 Lookup(f32 temperatureK, u32 band) const {
+        const f32 maxIndex = static_cast<f32>(temperatureBins - 1);
+        const f32 x = std::clamp((temperatureK - temperatureMin) / (temperatureMax - temperatureMin) * maxIndex,
+                                 0.0f, maxIndex);
+        const u32 i0 = std::min(static_cast<u32>(x), temperatureBins - 2);
+        const f32 t = x - static_cast<f32>(i0);
+        const f32* row = radiance.data() + static_cast<usize>(band) * temperatureBins;
+        return row[i0] * (1.0f - t) + row[i0 + 1] * t;
+    }
+
+    // Planck's law, spectral radiance in W/m^2/sr/nm
+    static f64 SpectralRadiance(f64 wavelengthNm, f64 temperatureK);
+
+    std::vector<f32> PackForGpu() const;
+
+    // Tabulate B_band(T) for every band (parallel over bands)
+    static PlanckTable Build(const std::vector<SpectralBand>& bands,
+                             f32 temperatureMin = DEFAULT_TEMPERATURE_MIN,
+                             f32 temperatureMax = DEFAULT_TEMPERATURE_MAX,
+                             u32 temperatureBins = DEFAULT_TEMPERATURE_BINS);
+};
+
+} // namespace quantiloom
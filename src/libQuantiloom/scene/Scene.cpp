@@ -216,6 +216,50 @@ u32 Scene::GetTotalVertexCount() const {
     return total;
 }
 
+// ============================================================================
+// Assignment - the old meshes go before the arena holding them
+// ============================================================================
+
+Scene& Scene::operator=(const Scene& other) {
+    if (this != &other) {
+        Scene copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+Scene& Scene::operator=(Scene&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    // Members would otherwise be assigned in declaration order, replacing
+    // (and possibly destroying) geometryArena while the old meshes in it
+    // are still alive
+    meshes.clear();
+
+    camera = std::move(other.camera);
+    width = other.width;
+    height = other.height;
+    geometryArena = std::move(other.geometryArena);
+    meshes = std::move(other.meshes);
+    nodes = std::move(other.nodes);
+    materials = std::move(other.materials);
+    textures = std::move(other.textures);
+    bands = std::move(other.bands);
+    lambda_min = other.lambda_min;
+    lambda_max = other.lambda_max;
+    delta_lambda = other.delta_lambda;
+    atmosphereLUT = std::move(other.atmosphereLUT);
+    name = std::move(other.name);
+    description = std::move(other.description);
+    return *this;
+}
+
+std::pmr::memory_resource* Scene::GetGeometryResource() const {
+    return geometryArena ? geometryArena.get() : std::pmr::get_default_resource();
+}
+
 void Scene::PrintSummary() const {
     QL_LOG_INFO("========================================");
     QL_LOG_INFO("  Scene: {}", name);
@@ -233,6 +277,12 @@ void Scene::PrintSummary() const {
     QL_LOG_INFO("  Materials: {}", materials.size());
     QL_LOG_INFO("  Triangles: {}", GetTotalTriangleCount());
     QL_LOG_INFO("  Vertices: {}", GetTotalVertexCount());
+    if (geometryArena) {
+        QL_LOG_INFO("  Geometry arena: {:.2f} MB used, {:.2f} MB in {} block(s)",
+                    static_cast<f64>(geometryArena->BytesUsed()) / (1024.0 * 1024.0),
+                    static_cast<f64>(geometryArena->BytesReserved()) / (1024.0 * 1024.0),
+                    geometryArena->BlockCount());
+    }
 
     QL_LOG_INFO("Spectral:");
     if (!bands.empty()) {
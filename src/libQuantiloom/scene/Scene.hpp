@@ -4,35 +4,17 @@
 #include "Mesh.hpp"
 #include "Material.hpp"
 #include "Texture.hpp"
+#include "SpectralBand.hpp"
 #include "core/Types.hpp"
 #include "core/Config.hpp"
 #include "core/LUT.hpp"
+#include "core/Arena.hpp"
+#include <memory>
 #include <vector>
 #include <string>
 
-// ============================================================================
-// SpectralBand - Band-pass configuration for MS-RT mode
-// ============================================================================
-// Defines a single spectral band with:
-// - center_nm: Center wavelength (nanometers)
-// - fwhm_nm: Full-width at half-maximum (bandwidth)
-// - name: Human-readable identifier
-//
-// Used in MS-RT mode to define output channels
-// ============================================================================
-
 namespace quantiloom {
 
-struct SpectralBand {
-    String name;
-    f32 center_nm = 550.0f;
-    f32 fwhm_nm = 40.0f;
-
-    bool IsValid() const {
-        return center_nm > 0.0f && fwhm_nm > 0.0f;
-    }
-};
-
 // ============================================================================
 // Scene - Top-level scene container
 // ============================================================================
@@ -49,6 +31,15 @@ struct SpectralBand {
 // Lifetime:
 // - Scene must outlive Renderer (Renderer holds reference, not ownership)
 // - Typically created at application startup, destroyed at shutdown
+//
+// Geometry memory:
+// - Loaders allocate mesh geometry from geometryArena (core/Arena.hpp), so
+//   vertex and index arrays are packed into a few large blocks and freed
+//   together with the scene
+// - Moving a Scene keeps the arena; copying one copies the geometry to the
+//   heap
+// - The arena must outlive every mesh allocated from it: it is declared
+//   before meshes, and assignment frees the old meshes first
 // ============================================================================
 
 class QL_API Scene {
@@ -58,6 +49,13 @@ public:
     // ========================================================================
 
     Scene() = default;
+    Scene(const Scene&) = default;
+    Scene(Scene&&) = default;
+    ~Scene() = default;
+
+    // Free the old meshes before the arena they live in is replaced
+    Scene& operator=(const Scene& other);
+    Scene& operator=(Scene&& other) noexcept;
 
     // Load scene from TOML configuration
     static Result<Scene, String> FromConfig(const Config& config);
@@ -71,6 +69,10 @@ public:
     u32 width = 1280;   // Render resolution width
     u32 height = 720;   // Render resolution height
 
+    // Backing store of mesh geometry (null = heap allocated). Declared
+    // before meshes so that it is destroyed after them
+    std::shared_ptr<Arena> geometryArena;
+
     // Scene graph and resources
     std::vector<Mesh> meshes;            // Mesh definitions (geometry primitives)
     std::vector<SceneNode> nodes;        // Scene instances (mesh + transform)
@@ -103,6 +105,9 @@ public:
     // Get total vertex count
     u32 GetTotalVertexCount() const;
 
+    // Memory resource for new geometry (geometryArena, or the default resource)
+    std::pmr::memory_resource* GetGeometryResource() const;
+
     // Print scene summary (for debugging)
     void PrintSummary() const;
 };
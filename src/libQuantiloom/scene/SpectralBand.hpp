@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <cmath>
+
+// ============================================================================
+// SpectralBand - Band-pass configuration for MS-RT mode
+// ============================================================================
+// Defines a single spectral band with:
+// - center_nm: Center wavelength (nanometers)
+// - fwhm_nm: Full-width at half-maximum (bandwidth)
+// - name: Human-readable identifier
+//
+// Used in MS-RT mode to define output channels, and as the band response
+// when resampling measured spectra (SpectralMaterialTable)
+// ============================================================================
+
+namespace quantiloom {
+
+struct SpectralBand {
+    String name;
+    f32 center_nm = 550.0f;
+    f32 fwhm_nm = 40.0f;
+
+    bool IsValid() const {
+        return center_nm > 0.0f && fwhm_nm > 0.0f;
+    }
+
+    // Response-weighted average of f(lambda_nm) over the band: Gaussian with
+    // this FWHM, integrated over +-1.5 FWHM (~ +-3.5 sigma) with the
+    // trapezoidal rule; a point sample at the centre for FWHM <= 0
+    template<typename Fn>
+    f64 Average(Fn&& f) const {
+        if (fwhm_nm <= 0.0f) {
+            return f(static_cast<f64>(center_nm));
+        }
+
+        constexpr u32 kIntervals = 64;
+        const f64 sigma = fwhm_nm / 2.354820045;
+        const f64 halfSpan = 1.5 * fwhm_nm;
+        const f64 step = 2.0 * halfSpan / kIntervals;
+
+        f64 weightSum = 0.0;
+        f64 valueSum = 0.0;
+        for (u32 i = 0; i <= kIntervals; ++i) {
+            const f64 lambda = center_nm - halfSpan + step * i;
+            const f64 x = (lambda - center_nm) / sigma;
+            f64 weight = std::exp(-0.5 * x * x);
+            if (i == 0 || i == kIntervals) {
+                weight *= 0.5;
+            }
+            weightSum += weight;
+            valueSum += weight * f(lambda);
+        }
+        return valueSum / weightSum;
+    }
+};
+
+} // namespace quantiloom
@@ -0,0 +1,174 @@
+#include "SpectralMaterial.hpp"
+#include "core/Log.hpp"
+
+#include <algorithm>
+
+namespace quantiloom {
+
+// ============================================================================
+// Helper: Piecewise-linear interpolation, clamped to the sampled range
+// ============================================================================
+
+static f32 InterpolateClamped(const std::vector<f32>& wavelengths,
+                              const std::vector<f32>& values,
+                              f32 wavelengthNm) {
+    if (wavelengthNm <= wavelengths.front()) {
+        return values.front();
+    }
+    if (wavelengthNm >= wavelengths.back()) {
+        return values.back();
+    }
+
+    const usize right = static_cast<usize>(
+        std::upper_bound(wavelengths.begin(), wavelengths.end(), wavelengthNm) - wavelengths.begin());
+    const usize left = right - 1;
+    const f32 t = (wavelengthNm - wavelengths[left]) / (wavelengths[right] - wavelengths[left]);
+    return values[left] * (1.0f - t) + values[right] * t;
+}
+
+// ============================================================================
+// MeasuredSpectrum
+// ============================================================================
+
+bool MeasuredSpectrum::IsValid() const {
+    const usize n = wavelengths.size();
+    if (n == 0 || reflectance.size() != n || (!emissivity.empty() && emissivity.size() != n)) {
+        return false;
+    }
+    for (usize i = 1; i < n; ++i) {
+        if (wavelengths[i] <= wavelengths[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+f32 MeasuredSpectrum::EvaluateReflectance(f32 wavelengthNm) const {
+    return InterpolateClamped(wavelengths, reflectance, wavelengthNm);
+}
+
+f32 MeasuredSpectrum::EvaluateEmissivity(f32 wavelengthNm) const {
+    if (emissivity.empty()) {
+        return 1.0f - EvaluateReflectance(wavelengthNm);
+    }
+    return InterpolateClamped(wavelengths, emissivity, wavelengthNm);
+}
+
+// ============================================================================
+// SpectralMaterialLibrary
+// ============================================================================
+
+bool SpectralMaterialLibrary::Add(MeasuredSpectrum spectrum) {
+    if (!spectrum.IsValid()) {
+        QL_LOG_WARN("SpectralMaterialLibrary: Ignoring invalid spectrum '{}'", spectrum.name);
+        return false;
+    }
+
+    auto it = m_indexOfName.find(spectrum.name);
+    if (it != m_indexOfName.end()) {
+        m_spectra[it->second] = std::move(spectrum);
+        return true;
+    }
+
+    m_indexOfName[spectrum.name] = m_spectra.size();
+    m_spectra.push_back(std::move(spectrum));
+    return true;
+}
+
+i32 SpectralMaterialLibrary::Find(const String& name) const {
+    auto it = m_indexOfName.find(name);
+    return (it != m_indexOfName.end()) ? static_cast<i32>(it->second) : -1;
+}
+
+// ============================================================================
+// SpectralMaterialTable: Resampling
+// ============================================================================
+
+SpectralMaterialTable::Entry SpectralMaterialTable::ResampleToBand(const MeasuredSpectrum& spectrum,
+                                                                   const SpectralBand& band) {
+    Entry entry;
+    entry.reflectance = static_cast<f32>(band.Average(
+        [&](f64 lambda) { return spectrum.EvaluateReflectance(static_cast<f32>(lambda)); }));
+    entry.emissivity = static_cast<f32>(band.Average(
+        [&](f64 lambda) { return spectrum.EvaluateEmissivity(static_cast<f32>(lambda)); }));
+    return entry;
+}
+
+std::vector<SpectralBand> SpectralMaterialTable::MakeUniformBands(f32 lambdaMin, f32 lambdaMax, f32 delta) {
+    std::vector<SpectralBand> bands;
+    if (delta <= 0.0f || lambdaMax < lambdaMin) {
+        return bands;
+    }
+
+    const u32 count = static_cast<u32>((lambdaMax - lambdaMin) / delta) + 1;
+    bands.reserve(count);
+    for (u32 i = 0; i < count; ++i) {
+        SpectralBand band;
+        band.center_nm = lambdaMin + delta * static_cast<f32>(i);
+        band.fwhm_nm = delta;
+        band.name = std::to_string(band.center_nm);
+        bands.push_back(band);
+    }
+    return bands;
+}
+
+// ============================================================================
+// SpectralMaterialTable: Build
+// ============================================================================
+
+SpectralMaterialTable SpectralMaterialTable::Build(const SpectralMaterialLibrary& library,
+                                                   std::vector<Material>& materials,
+                                                   const std::vector<SpectralBand>& bands,
+                                                   const std::unordered_map<String, String>& aliases) {
+    SpectralMaterialTable table;
+    table.bands = bands;
+    table.bandCount = static_cast<u32>(bands.size());
+
+    // Row of each library spectrum in the table (-1 = not used yet)
+    std::vector<i32> rowOfSpectrum(library.Size(), -1);
+    u32 boundCount = 0;
+
+    for (Material& mat : materials) {
+        mat.spectralMaterialIndex = -1;
+
+        auto alias = aliases.find(mat.name);
+        const String& spectrumName = (alias != aliases.end()) ? alias->second : mat.name;
+        const i32 spectrumIndex = library.Find(spectrumName);
+        if (spectrumIndex < 0) {
+            if (alias != aliases.end()) {
+                QL_LOG_FIRST_N(WARN, 16, "SpectralMaterialTable: Material '{}' is bound to unknown spectrum '{}'",
+                               mat.name, spectrumName);
+            }
+            continue;
+        }
+        const usize libraryIndex = static_cast<usize>(spectrumIndex);
+
+        i32& row = rowOfSpectrum[libraryIndex];
+        if (row < 0) {
+            row = static_cast<i32>(table.rowCount++);
+            table.rowNames.push_back(spectrumName);
+
+            const MeasuredSpectrum& spectrum = library.Get(libraryIndex);
+            u32 clampedBands = 0;
+            for (const SpectralBand& band : bands) {
+                table.entries.push_back(ResampleToBand(spectrum, band));
+                if (band.center_nm < spectrum.wavelengths.front() || band.center_nm > spectrum.wavelengths.back()) {
+                    ++clampedBands;
+                }
+            }
+            if (clampedBands > 0) {
+                QL_LOG_WARN("SpectralMaterialTable: '{}' covers {:.1f}-{:.1f} nm, {} band(s) outside use boundary values",
+                            spectrumName, spectrum.wavelengths.front(), spectrum.wavelengths.back(), clampedBands);
+            }
+        }
+
+        mat.spectralMaterialIndex = row;
+        ++boundCount;
+    }
+
+    QL_LOG_INFO("SpectralMaterialTable: {} of {} material(s) bound to {} measured spectra x {} band(s)",
+                boundCount, materials.size(), table.rowCount, table.bandCount);
+    return table;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "Material.hpp"
+#include "SpectralBand.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// SpectralMaterial - Measured spectral reflectance / emissivity
+// ============================================================================
+// Measured spectra (lab or field spectrometer, spectral libraries such as
+// ECOSTRESS/USGS) replace the RGB-to-spectrum uplift for materials that
+// have them. They cover bands the RGB colour says nothing about (NIR, SWIR,
+// thermal IR).
+//
+// Pipeline:
+//   1. SpectralMaterialLibrary holds the raw spectra at their native sampling
+//      (SpectralLibraryLoader reads HDF5 or CSV)
+//   2. SpectralMaterialTable::Build resamples every spectrum that a scene
+//      material binds to (by name) onto the render bands, once per run
+//   3. Per hit, the lookup is a single indexed load:
+//        table.At(material.spectralMaterialIndex, band)
+//      The GPU uses the same packed array (binding 9, float2 per entry)
+//
+// Band resampling integrates the piecewise-linear spectrum against the band
+// response: Gaussian with the band FWHM (MS-RT sensor bands, HS-OFF grid
+// with FWHM = step), or a point sample for FWHM = 0 (single wavelength).
+// Outside the measured range the spectrum is held at its boundary value.
+//
+// Missing emissivity defaults to 1 - reflectance (opaque, Kirchhoff's law).
+// ============================================================================
+
+namespace quantiloom {
+
+// One measured spectrum at its native sampling
+struct MeasuredSpectrum {
+    String name;
+    std::vector<f32> wavelengths;   // nm, strictly increasing
+    std::vector<f32> reflectance;   // [0, 1], same length as wavelengths
+    std::vector<f32> emissivity;    // [0, 1], same length or empty
+
+    bool IsValid() const;
+    bool HasEmissivity() const { return !emissivity.empty(); }
+
+    // Piecewise-linear value at a wavelength (clamped to the measured range)
+    f32 EvaluateReflectance(f32 wavelengthNm) const;
+    f32 EvaluateEmissivity(f32 wavelengthNm) const;
+};
+
+// ============================================================================
+// SpectralMaterialLibrary - Named collection of measured spectra
+// ============================================================================
+class QL_API SpectralMaterialLibrary {
+public:
+    // Add or replace a spectrum (returns false if invalid)
+    bool Add(MeasuredSpectrum spectrum);
+
+    // Index of a spectrum by name, or -1
+    i32 Find(const String& name) const;
+
+    const MeasuredSpectrum& Get(usize index) const { return m_spectra[index]; }
+    usize Size() const { return m_spectra.size(); }
+    bool Empty() const { return m_spectra.empty(); }
+
+private:
+    std::vector<MeasuredSpectrum> m_spectra;
+    std::unordered_map<String, usize> m_indexOfName;
+};
+
+// ============================================================================
+// SpectralMaterialTable - Measured spectra resampled to the render bands
+// ============================================================================
+// Entries are packed [row][band] as (reflectance, emissivity) pairs, so one
+// contiguous load serves both. Rows are only created for spectra that a
+// scene material actually binds to.
+struct QL_API SpectralMaterialTable {
+    struct Entry {
+        f32 reflectance = 0.0f;
+        f32 emissivity = 0.0f;
+    };
+
+    u32 rowCount = 0;
+    u32 bandCount = 0;
+    std::vector<SpectralBand> bands;     // Band each column was resampled to
+    std::vector<String> rowNames;        // Library spectrum of each row
+    std::vector<Entry> entries;          // [rowCount * bandCount]
+
+    bool IsValid() const {
+        return bandCount > 0 && bands.size() == bandCount && rowNames.size() == rowCount &&
+               entries.size() == static_cast<usize>(rowCount) * bandCount;
+    }
+
+    const Entry& At(u32 row, u32 band) const { return entries[static_cast<usize>(row) * bandCount + band]; }
+
+    // Resample the library spectra bound by `materials` onto `bands` and set
+    // each bound material's spectralMaterialIndex (-1 for unbound ones).
+    // A material binds to the library entry named in `aliases[material.name]`,
+    // else to the entry with its own name.
+    static SpectralMaterialTable Build(const SpectralMaterialLibrary& library,
+                                       std::vector<Material>& materials,
+                                       const std::vector<SpectralBand>& bands,
+                                       const std::unordered_map<String, String>& aliases = {});
+
+    // Band response-weighted average of a spectrum (see header comment)
+    static Entry ResampleToBand(const MeasuredSpectrum& spectrum, const SpectralBand& band);
+
+    // Uniform HS-OFF grid lambda_min..lambda_max in steps of delta (FWHM = delta)
+    static std::vector<SpectralBand> MakeUniformBands(f32 lambdaMin, f32 lambdaMax, f32 delta);
+};
+
+} // namespace quantiloom
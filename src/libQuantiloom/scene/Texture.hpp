@@ -13,6 +13,8 @@
 //
 // Lifecycle:
 // - Created during scene loading (GltfLoader or procedural)
+// - Mip chain generated once at load by MipGenerator (cached with the scene)
+// - Optionally block-compressed by BcCodec (cached with the scene)
 // - Uploaded to GPU by TextureManager
 // - Referenced by Material via textureIndex
 //
@@ -38,8 +40,47 @@ struct TextureSampler {
 
     Filter minFilter = Filter::Linear;
     Filter magFilter = Filter::Linear;
+    Filter mipFilter = Filter::Linear;  // Filtering between mip levels
     WrapMode wrapS = WrapMode::Repeat;
     WrapMode wrapT = WrapMode::Repeat;
+
+    // Number of distinct states (min x mag x mip filter x wrapS x wrapT):
+    // the upper bound on GPU samplers after deduplication
+    static constexpr u32 STATE_COUNT = 2 * 2 * 2 * 3 * 3;
+
+    // Identical states share one GPU sampler object (see TextureManager)
+    bool operator==(const TextureSampler&) const = default;
+};
+
+// How texel data is interpreted (drives gamma-correct filtering and GPU format)
+// Assigned from material bindings after the materials are parsed
+enum class TextureUsage : u32 {
+    Color = 0,   // sRGB-encoded colour (base colour, emissive)
+    Data = 1,    // Linear data (metallic-roughness, occlusion)
+    Normal = 2   // Tangent-space normal map (renormalised per mip level)
+};
+
+// Single downsampled level of a mip chain (level 0 lives in Texture::pixels)
+struct TextureMip {
+    u32 width = 0;
+    u32 height = 0;
+    std::vector<u8> pixels;  // Same channel layout as Texture::pixels
+};
+
+// GPU block compression format of a texture's blocks (None = upload RGBA8)
+enum class TextureCompression : u32 {
+    None = 0,
+    BC1 = 1,   // RGB, 4 bpp (opaque colour / data)
+    BC4 = 2,   // Single channel, 4 bpp (grayscale, sampled as RRR1)
+    BC5 = 3,   // Two channels, 8 bpp (tangent-space normal XY)
+    BC7 = 4    // RGBA, 8 bpp (high quality colour / alpha)
+};
+
+// Compressed blocks of one mip level (4x4 texel blocks, row-major)
+struct TextureBlockLevel {
+    u32 width = 0;   // Level size in texels (not rounded to blocks)
+    u32 height = 0;
+    std::vector<u8> blocks;
 };
 
 // Texture image data (CPU-side)
@@ -52,9 +93,20 @@ struct Texture {
     // Pixel data (CPU memory, row-major, RGBA8 format)
     std::vector<u8> pixels;
 
+    // Mip levels 1..N-1 (empty = no mip chain, level 0 only)
+    std::vector<TextureMip> mips;
+
     // Sampler parameters
     TextureSampler sampler;
 
+    // Texel interpretation (Color textures are stored and filtered as sRGB)
+    TextureUsage usage = TextureUsage::Data;
+
+    // Block-compressed copy of every mip level (empty if compression == None)
+    // Uncompressed pixels are kept for CPU-side processing and as a fallback
+    TextureCompression compression = TextureCompression::None;
+    std::vector<TextureBlockLevel> blockLevels;
+
     // Metadata
     String name;  // Texture name (for debugging)
     String sourceUri;  // Original file path (if from external file)
@@ -84,9 +136,37 @@ struct Texture {
         return true;
     }
 
-    // Get size in bytes
+    // Get size in bytes (all mip levels)
     size_t GetSizeInBytes() const {
-        return pixels.size();
+        size_t total = pixels.size();
+        for (const auto& mip : mips) {
+            total += mip.pixels.size();
+        }
+        return total;
+    }
+
+    // Number of mip levels including level 0
+    u32 GetMipCount() const {
+        return 1 + static_cast<u32>(mips.size());
+    }
+
+    // Dimensions of a mip level (level 0 = full resolution)
+    u32 GetMipWidth(u32 level) const {
+        return level == 0 ? width : mips[level - 1].width;
+    }
+
+    u32 GetMipHeight(u32 level) const {
+        return level == 0 ? height : mips[level - 1].height;
+    }
+
+    // Pixel data of a mip level
+    const std::vector<u8>& GetMipPixels(u32 level) const {
+        return level == 0 ? pixels : mips[level - 1].pixels;
+    }
+
+    // Check if block-compressed data is available for all mip levels
+    bool IsCompressed() const {
+        return compression != TextureCompression::None && blockLevels.size() == GetMipCount();
     }
 
     // Get pixel data pointer (for GPU upload)
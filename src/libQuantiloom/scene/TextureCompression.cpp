@@ -0,0 +1,716 @@
+#include "TextureCompression.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace quantiloom {
+
+namespace {
+
+// ============================================================================
+// Block gathering / analysis helpers
+// ============================================================================
+
+// Fetch a 4x4 block as RGBA8, replicating edge texels for partial blocks
+// Channel expansion: 1 -> RRR1 (grayscale), 2 -> RG01, 3 -> RGB1
+void GatherBlock(const std::vector<u8>& pixels, u32 width, u32 height, u32 channels,
+                 u32 blockX, u32 blockY, u8 out[16][4]) {
+    for (u32 ty = 0; ty < 4; ++ty) {
+        u32 y = std::min(blockY * 4 + ty, height - 1);
+        for (u32 tx = 0; tx < 4; ++tx) {
+            u32 x = std::min(blockX * 4 + tx, width - 1);
+            const u8* src = &pixels[(static_cast<usize>(y) * width + x) * channels];
+            u8* dst = out[ty * 4 + tx];
+
+            switch (channels) {
+                case 1: dst[0] = dst[1] = dst[2] = src[0]; dst[3] = 255; break;
+                case 2: dst[0] = src[0]; dst[1] = src[1]; dst[2] = 0; dst[3] = 255; break;
+                case 3: dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255; break;
+                default: std::memcpy(dst, src, 4); break;
+            }
+        }
+    }
+}
+
+// Mean and principal axis of 16 points in N dimensions (power iteration)
+template<u32 N>
+void PrincipalAxis(const f32 points[16][4], f32 mean[4], f32 axis[4]) {
+    for (u32 c = 0; c < N; ++c) {
+        mean[c] = 0.0f;
+        for (u32 i = 0; i < 16; ++i) {
+            mean[c] += points[i][c];
+        }
+        mean[c] /= 16.0f;
+    }
+
+    f32 cov[N][N] = {};
+    for (u32 i = 0; i < 16; ++i) {
+        for (u32 a = 0; a < N; ++a) {
+            for (u32 b = 0; b < N; ++b) {
+                cov[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+            }
+        }
+    }
+
+    for (u32 c = 0; c < N; ++c) {
+        axis[c] = 1.0f;
+    }
+    for (u32 iter = 0; iter < 8; ++iter) {
+        f32 next[N] = {};
+        for (u32 a = 0; a < N; ++a) {
+            for (u32 b = 0; b < N; ++b) {
+                next[a] += cov[a][b] * axis[b];
+            }
+        }
+        f32 length = 0.0f;
+        for (u32 c = 0; c < N; ++c) {
+            length += next[c] * next[c];
+        }
+        if (length < 1e-12f) {
+            break;  // Flat block: any axis works
+        }
+        length = std::sqrt(length);
+        for (u32 c = 0; c < N; ++c) {
+            axis[c] = next[c] / length;
+        }
+    }
+}
+
+// Endpoints at the extreme projections along the principal axis
+template<u32 N>
+void AxisEndpoints(const f32 points[16][4], f32 e0[4], f32 e1[4]) {
+    f32 mean[4] = {};
+    f32 axis[4] = {};
+    PrincipalAxis<N>(points, mean, axis);
+
+    f32 tMin = 0.0f;
+    f32 tMax = 0.0f;
+    for (u32 i = 0; i < 16; ++i) {
+        f32 t = 0.0f;
+        for (u32 c = 0; c < N; ++c) {
+            t += (points[i][c] - mean[c]) * axis[c];
+        }
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    for (u32 c = 0; c < N; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    }
+}
+
+// Least-squares endpoints for fixed interpolation weights
+// weights[i] = fraction of e1 in texel i (0 = e0, 1 = e1)
+// Returns false if the system is degenerate (all texels use one weight)
+template<u32 N>
+bool RefitEndpoints(const f32 points[16][4], const f32 weights[16], f32 e0[4], f32 e1[4]) {
+    f32 aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    f32 ax[4] = {}, bx[4] = {};
+    for (u32 i = 0; i < 16; ++i) {
+        f32 b = weights[i];
+        f32 a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (u32 c = 0; c < N; ++c) {
+            ax[c] += a * points[i][c];
+            bx[c] += b * points[i][c];
+        }
+    }
+
+    f32 det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) {
+        return false;
+    }
+
+    for (u32 c = 0; c < N; ++c) {
+        e0[c] = std::clamp((bb * ax[c] - ab * bx[c]) / det, 0.0f, 255.0f);
+        e1[c] = std::clamp((aa * bx[c] - ab * ax[c]) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// Little-endian bit packing/unpacking for 128-bit BC7 blocks
+struct BitWriter {
+    u8* data;
+    u32 pos = 0;
+
+    void Write(u32 value, u32 bits) {
+        for (u32 i = 0; i < bits; ++i) {
+            if ((value >> i) & 1u) {
+                data[pos >> 3] |= static_cast<u8>(1u << (pos & 7));
+            }
+            ++pos;
+        }
+    }
+};
+
+struct BitReader {
+    const u8* data;
+    u32 pos = 0;
+
+    u32 Read(u32 bits) {
+        u32 value = 0;
+        for (u32 i = 0; i < bits; ++i) {
+            value |= static_cast<u32>((data[pos >> 3] >> (pos & 7)) & 1u) << i;
+            ++pos;
+        }
+        return value;
+    }
+};
+
+// ============================================================================
+// BC1
+// ============================================================================
+
+u16 Pack565(const f32 color[4]) {
+    u32 r = static_cast<u32>(std::lround(color[0] * 31.0f / 255.0f));
+    u32 g = static_cast<u32>(std::lround(color[1] * 63.0f / 255.0f));
+    u32 b = static_cast<u32>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<u16>((r << 11) | (g << 5) | b);
+}
+
+void Unpack565(u16 packed, i32 out[3]) {
+    i32 r = (packed >> 11) & 31;
+    i32 g = (packed >> 5) & 63;
+    i32 b = packed & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+void EncodeBC1(const u8 texels[16][4], u8* out) {
+    f32 points[16][4];
+    for (u32 i = 0; i < 16; ++i) {
+        for (u32 c = 0; c < 4; ++c) {
+            points[i][c] = texels[i][c];
+        }
+    }
+
+    f32 e0[4] = {}, e1[4] = {};
+    AxisEndpoints<3>(points, e0, e1);
+
+    // Fraction of color1 for palette entries 0..3 in 4-colour mode
+    static constexpr f32 kWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+    u16 bestC0 = 0, bestC1 = 0;
+    u32 bestIndices = 0;
+    i64 bestError = -1;
+
+    for (u32 iter = 0; iter < 2; ++iter) {
+        u16 c0 = Pack565(e0);
+        u16 c1 = Pack565(e1);
+        if (c0 < c1) {
+            std::swap(c0, c1);
+        }
+
+        i32 palette[4][3];
+        Unpack565(c0, palette[0]);
+        Unpack565(c1, palette[1]);
+        for (u32 c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        u32 indices = 0;
+        i64 error = 0;
+        f32 weights[16];
+        for (u32 i = 0; i < 16; ++i) {
+            i32 best = 0;
+            i32 bestDist = INT32_MAX;
+            // c0 == c1 selects 3-colour mode on decode; index 0 is still exact
+            i32 entries = (c0 == c1) ? 1 : 4;
+            for (i32 p = 0; p < entries; ++p) {
+                i32 dist = 0;
+                for (u32 c = 0; c < 3; ++c) {
+                    i32 d = static_cast<i32>(texels[i][c]) - palette[p][c];
+                    dist += d * d;
+                }
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<u32>(best) << (2 * i);
+            weights[i] = kWeights[best];
+            error += bestDist;
+        }
+
+        if (bestError < 0 || error < bestError) {
+            bestError = error;
+            bestC0 = c0;
+            bestC1 = c1;
+            bestIndices = indices;
+        }
+
+        // Refit endpoints to the chosen indices (weights are in c0/c1 order)
+        if (bestError == 0 || !RefitEndpoints<3>(points, weights, e0, e1)) {
+            break;
+        }
+    }
+
+    out[0] = static_cast<u8>(bestC0 & 0xFF);
+    out[1] = static_cast<u8>(bestC0 >> 8);
+    out[2] = static_cast<u8>(bestC1 & 0xFF);
+    out[3] = static_cast<u8>(bestC1 >> 8);
+    for (u32 i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<u8>((bestIndices >> (8 * i)) & 0xFF);
+    }
+}
+
+void DecodeBC1(const u8* block, u8 out[64]) {
+    u16 c0 = static_cast<u16>(block[0] | (block[1] << 8));
+    u16 c1 = static_cast<u16>(block[2] | (block[3] << 8));
+    u32 indices = static_cast<u32>(block[4]) | (static_cast<u32>(block[5]) << 8) |
+                  (static_cast<u32>(block[6]) << 16) | (static_cast<u32>(block[7]) << 24);
+
+    i32 palette[4][4];
+    Unpack565(c0, palette[0]);
+    Unpack565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = 255;
+    if (c0 > c1) {
+        for (u32 c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        palette[2][3] = palette[3][3] = 255;
+    } else {
+        for (u32 c = 0; c < 3; ++c) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;  // Transparent black
+    }
+
+    for (u32 i = 0; i < 16; ++i) {
+        u32 index = (indices >> (2 * i)) & 3u;
+        for (u32 c = 0; c < 4; ++c) {
+            out[i * 4 + c] = static_cast<u8>(palette[index][c]);
+        }
+    }
+}
+
+// ============================================================================
+// BC4 (single channel; BC5 = two BC4 blocks)
+// ============================================================================
+
+void EncodeBC4(const u8 values[16], u8* out) {
+    u8 maxValue = *std::max_element(values, values + 16);
+    u8 minValue = *std::min_element(values, values + 16);
+
+    out[0] = maxValue;  // a0 > a1 selects the 8-value mode
+    out[1] = minValue;
+
+    u64 bits = 0;
+    if (maxValue != minValue) {
+        f32 scale = 7.0f / static_cast<f32>(maxValue - minValue);
+        for (u32 i = 0; i < 16; ++i) {
+            // Step 0 = a0 ... step 7 = a1; codes 0/1 are the endpoints
+            u32 step = static_cast<u32>(std::lround((maxValue - values[i]) * scale));
+            u32 code = (step == 0) ? 0u : (step == 7) ? 1u : step + 1;
+            bits |= static_cast<u64>(code) << (3 * i);
+        }
+    }
+
+    for (u32 i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<u8>((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+void DecodeBC4(const u8* block, u8 out[16]) {
+    i32 a0 = block[0];
+    i32 a1 = block[1];
+
+    i32 palette[8];
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (i32 i = 2; i < 8; ++i) {
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        }
+    } else {
+        for (i32 i = 2; i < 6; ++i) {
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    u64 bits = 0;
+    for (u32 i = 0; i < 6; ++i) {
+        bits |= static_cast<u64>(block[2 + i]) << (8 * i);
+    }
+    for (u32 i = 0; i < 16; ++i) {
+        out[i] = static_cast<u8>(palette[(bits >> (3 * i)) & 7u]);
+    }
+}
+
+// ============================================================================
+// BC7 (mode 6)
+// ============================================================================
+
+constexpr i32 kBc7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+i32 Bc7Interpolate(i32 e0, i32 e1, i32 weight) {
+    return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+}
+
+// Quantise an RGBA endpoint to 7 bits per channel + shared P bit
+void QuantizeMode6Endpoint(const f32 endpoint[4], u32 q[4], u32& pbit) {
+    f32 bestError = -1.0f;
+    for (u32 p = 0; p < 2; ++p) {
+        u32 candidate[4];
+        f32 error = 0.0f;
+        for (u32 c = 0; c < 4; ++c) {
+            i32 v = static_cast<i32>(std::lround((endpoint[c] - static_cast<f32>(p)) * 0.5f));
+            candidate[c] = static_cast<u32>(std::clamp(v, 0, 127));
+            f32 d = static_cast<f32>((candidate[c] << 1) | p) - endpoint[c];
+            error += d * d;
+        }
+        if (bestError < 0.0f || error < bestError) {
+            bestError = error;
+            pbit = p;
+            std::copy(candidate, candidate + 4, q);
+        }
+    }
+}
+
+void EncodeBC7(const u8 texels[16][4], u8* out) {
+    f32 points[16][4];
+    for (u32 i = 0; i < 16; ++i) {
+        for (u32 c = 0; c < 4; ++c) {
+            points[i][c] = texels[i][c];
+        }
+    }
+
+    f32 e0[4] = {}, e1[4] = {};
+    AxisEndpoints<4>(points, e0, e1);
+
+    u32 bestQ0[4] = {}, bestQ1[4] = {};
+    u32 bestP0 = 0, bestP1 = 0;
+    u32 bestIndices[16] = {};
+    i64 bestError = -1;
+
+    for (u32 iter = 0; iter < 2; ++iter) {
+        u32 q0[4], q1[4], p0 = 0, p1 = 0;
+        QuantizeMode6Endpoint(e0, q0, p0);
+        QuantizeMode6Endpoint(e1, q1, p1);
+
+        i32 end0[4], end1[4];
+        for (u32 c = 0; c < 4; ++c) {
+            end0[c] = static_cast<i32>((q0[c] << 1) | p0);
+            end1[c] = static_cast<i32>((q1[c] << 1) | p1);
+        }
+
+        i32 palette[16][4];
+        for (u32 w = 0; w < 16; ++w) {
+            for (u32 c = 0; c < 4; ++c) {
+                palette[w][c] = Bc7Interpolate(end0[c], end1[c], kBc7Weights4[w]);
+            }
+        }
+
+        u32 indices[16];
+        f32 weights[16];
+        i64 error = 0;
+        for (u32 i = 0; i < 16; ++i) {
+            i32 bestDist = INT32_MAX;
+            u32 best = 0;
+            for (u32 w = 0; w < 16; ++w) {
+                i32 dist = 0;
+                for (u32 c = 0; c < 4; ++c) {
+                    i32 d = static_cast<i32>(texels[i][c]) - palette[w][c];
+                    dist += d * d;
+                }
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = w;
+                }
+            }
+            indices[i] = best;
+            weights[i] = static_cast<f32>(kBc7Weights4[best]) / 64.0f;
+            error += bestDist;
+        }
+
+        if (bestError < 0 || error < bestError) {
+            bestError = error;
+            std::copy(q0, q0 + 4, bestQ0);
+            std::copy(q1, q1 + 4, bestQ1);
+            bestP0 = p0;
+            bestP1 = p1;
+            std::copy(indices, indices + 16, bestIndices);
+        }
+
+        if (bestError == 0 || !RefitEndpoints<4>(points, weights, e0, e1)) {
+            break;
+        }
+    }
+
+    // Anchor texel 0 stores its index with an implicit 0 MSB: swap endpoints if needed
+    if (bestIndices[0] >= 8) {
+        std::swap(bestQ0, bestQ1);
+        std::swap(bestP0, bestP1);
+        for (u32& index : bestIndices) {
+            index = 15 - index;
+        }
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.Write(1u << 6, 7);  // Mode 6
+    for (u32 c = 0; c < 4; ++c) {
+        writer.Write(bestQ0[c], 7);
+        writer.Write(bestQ1[c], 7);
+    }
+    writer.Write(bestP0, 1);
+    writer.Write(bestP1, 1);
+    writer.Write(bestIndices[0], 3);
+    for (u32 i = 1; i < 16; ++i) {
+        writer.Write(bestIndices[i], 4);
+    }
+}
+
+void DecodeBC7(const u8* block, u8 out[64]) {
+    if ((block[0] & 0x7F) != (1u << 6)) {
+        // Only mode 6 is supported (the only mode BcCodec emits)
+        for (u32 i = 0; i < 16; ++i) {
+            out[i * 4 + 0] = 255;
+            out[i * 4 + 1] = 0;
+            out[i * 4 + 2] = 255;
+            out[i * 4 + 3] = 255;
+        }
+        return;
+    }
+
+    BitReader reader{block};
+    reader.Read(7);
+
+    u32 q0[4], q1[4];
+    for (u32 c = 0; c < 4; ++c) {
+        q0[c] = reader.Read(7);
+        q1[c] = reader.Read(7);
+    }
+    u32 p0 = reader.Read(1);
+    u32 p1 = reader.Read(1);
+
+    i32 end0[4], end1[4];
+    for (u32 c = 0; c < 4; ++c) {
+        end0[c] = static_cast<i32>((q0[c] << 1) | p0);
+        end1[c] = static_cast<i32>((q1[c] << 1) | p1);
+    }
+
+    for (u32 i = 0; i < 16; ++i) {
+        u32 index = reader.Read(i == 0 ? 3 : 4);
+        for (u32 c = 0; c < 4; ++c) {
+            out[i * 4 + c] = static_cast<u8>(Bc7Interpolate(end0[c], end1[c], kBc7Weights4[index]));
+        }
+    }
+}
+
+void EncodeBlock(TextureCompression format, const u8 texels[16][4], u8* out) {
+    switch (format) {
+        case TextureCompression::BC1:
+            EncodeBC1(texels, out);
+            break;
+        case TextureCompression::BC4: {
+            u8 values[16];
+            for (u32 i = 0; i < 16; ++i) values[i] = texels[i][0];
+            EncodeBC4(values, out);
+            break;
+        }
+        case TextureCompression::BC5: {
+            u8 red[16], green[16];
+            for (u32 i = 0; i < 16; ++i) {
+                red[i] = texels[i][0];
+                green[i] = texels[i][1];
+            }
+            EncodeBC4(red, out);
+            EncodeBC4(green, out + 8);
+            break;
+        }
+        case TextureCompression::BC7:
+            EncodeBC7(texels, out);
+            break;
+        case TextureCompression::None:
+        default:
+            break;
+    }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// BcCodec
+// ============================================================================
+
+u32 BcCodec::GetBlockSize(TextureCompression format) {
+    switch (format) {
+        case TextureCompression::BC1:
+        case TextureCompression::BC4:
+            return 8;
+        case TextureCompression::BC5:
+        case TextureCompression::BC7:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+bool BcCodec::ParsePreferBc7(StringView name) {
+    if (name == "bc1") {
+        return false;
+    }
+    if (name != "bc7") {
+        QL_LOG_WARN("Unknown colour block format '{}', using bc7", name);
+    }
+    return true;
+}
+
+TextureCompression BcCodec::SelectFormat(const Texture& texture, bool preferBc7) {
+    if (!texture.IsValid()) {
+        return TextureCompression::None;
+    }
+
+    if (texture.usage == TextureUsage::Normal) {
+        return TextureCompression::BC5;
+    }
+
+    bool grayscale = true;
+    bool opaque = true;
+    const u32 channels = texture.channels;
+    for (usize i = 0; i < texture.pixels.size() && (grayscale || opaque); i += channels) {
+        const u8* texel = &texture.pixels[i];
+        if (channels >= 3 && (texel[0] != texel[1] || texel[0] != texel[2])) {
+            grayscale = false;
+        }
+        if (channels == 2) {
+            grayscale = false;
+        }
+        if (channels == 4 && texel[3] != 255) {
+            opaque = false;
+        }
+    }
+
+    // BC4 has no sRGB variant, so grayscale colour textures stay on BC7/BC1
+    if (grayscale && opaque && texture.usage != TextureUsage::Color) {
+        return TextureCompression::BC4;
+    }
+    if (!opaque || preferBc7) {
+        return TextureCompression::BC7;
+    }
+    return TextureCompression::BC1;
+}
+
+void BcCodec::Compress(Texture& texture, TextureCompression format) {
+    texture.blockLevels.clear();
+    texture.compression = TextureCompression::None;
+
+    if (format == TextureCompression::None || !texture.IsValid()) {
+        return;
+    }
+
+    const u32 blockSize = GetBlockSize(format);
+    const u32 mipCount = texture.GetMipCount();
+    texture.blockLevels.reserve(mipCount);
+
+    for (u32 level = 0; level < mipCount; ++level) {
+        const u32 width = texture.GetMipWidth(level);
+        const u32 height = texture.GetMipHeight(level);
+        const u32 blocksX = (width + 3) / 4;
+        const u32 blocksY = (height + 3) / 4;
+        const auto& pixels = texture.GetMipPixels(level);
+
+        TextureBlockLevel blockLevel;
+        blockLevel.width = width;
+        blockLevel.height = height;
+        blockLevel.blocks.resize(static_cast<usize>(blocksX) * blocksY * blockSize);
+
+        // Block rows per parallel chunk: aim for ~1K blocks per chunk
+        usize grain = std::max<usize>(1, 1024 / blocksX);
+        ParallelFor(blocksY, grain, [&](usize by) {
+            u8 texels[16][4];
+            for (u32 bx = 0; bx < blocksX; ++bx) {
+                GatherBlock(pixels, width, height, texture.channels, bx, static_cast<u32>(by), texels);
+                u8* dst = &blockLevel.blocks[(by * blocksX + bx) * blockSize];
+                EncodeBlock(format, texels, dst);
+            }
+        });
+
+        texture.blockLevels.push_back(std::move(blockLevel));
+    }
+
+    texture.compression = format;
+}
+
+void BcCodec::DecodeBlock(TextureCompression format, const u8* block, u8 outRGBA[64]) {
+    switch (format) {
+        case TextureCompression::BC1:
+            DecodeBC1(block, outRGBA);
+            break;
+        case TextureCompression::BC4: {
+            u8 values[16];
+            DecodeBC4(block, values);
+            for (u32 i = 0; i < 16; ++i) {
+                // Matches the RRR1 swizzle of the GPU image view
+                outRGBA[i * 4 + 0] = outRGBA[i * 4 + 1] = outRGBA[i * 4 + 2] = values[i];
+                outRGBA[i * 4 + 3] = 255;
+            }
+            break;
+        }
+        case TextureCompression::BC5: {
+            u8 red[16], green[16];
+            DecodeBC4(block, red);
+            DecodeBC4(block + 8, green);
+            for (u32 i = 0; i < 16; ++i) {
+                outRGBA[i * 4 + 0] = red[i];
+                outRGBA[i * 4 + 1] = green[i];
+                outRGBA[i * 4 + 2] = 0;
+                outRGBA[i * 4 + 3] = 255;
+            }
+            break;
+        }
+        case TextureCompression::BC7:
+            DecodeBC7(block, outRGBA);
+            break;
+        case TextureCompression::None:
+        default:
+            std::memset(outRGBA, 0, 64);
+            break;
+    }
+}
+
+std::vector<u8> BcCodec::DecodeLevel(const Texture& texture, u32 level) {
+    if (!texture.IsCompressed() || level >= texture.blockLevels.size()) {
+        return {};
+    }
+
+    const TextureBlockLevel& blockLevel = texture.blockLevels[level];
+    const u32 blockSize = GetBlockSize(texture.compression);
+    const u32 blocksX = (blockLevel.width + 3) / 4;
+    const u32 blocksY = (blockLevel.height + 3) / 4;
+
+    std::vector<u8> rgba(static_cast<usize>(blockLevel.width) * blockLevel.height * 4);
+    ParallelFor(blocksY, std::max<usize>(1, 1024 / blocksX), [&](usize by) {
+        u8 decoded[64];
+        for (u32 bx = 0; bx < blocksX; ++bx) {
+            DecodeBlock(texture.compression, &blockLevel.blocks[(by * blocksX + bx) * blockSize], decoded);
+            for (u32 ty = 0; ty < 4; ++ty) {
+                u32 y = static_cast<u32>(by) * 4 + ty;
+                if (y >= blockLevel.height) break;
+                for (u32 tx = 0; tx < 4; ++tx) {
+                    u32 x = bx * 4 + tx;
+                    if (x >= blockLevel.width) break;
+                    std::memcpy(&rgba[(static_cast<usize>(y) * blockLevel.width + x) * 4],
+                                &decoded[(ty * 4 + tx) * 4], 4);
+                }
+            }
+        }
+    });
+
+    return rgba;
+}
+
+} // namespace quantiloom
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "scene/Texture.hpp"
+#include <vector>
+
+// ============================================================================
+// BcCodec - BCn block compression for Texture objects
+// ============================================================================
+// Encodes every mip level of a texture into GPU block-compressed formats at
+// cache-build time, and decodes blocks on the CPU (TextureSampling uses the
+// decoder so CPU results match what the GPU samples).
+//
+// Format selection (SelectFormat):
+// - Normal maps            -> BC5 (XY only, Z reconstructed in the shader)
+// - Single-channel content -> BC4 (R == G == B and opaque, sampled as RRR1)
+// - Colour/data with alpha -> BC7
+// - Opaque colour/data     -> BC7 (or BC1 when preferBc7 = false)
+//
+// Encoders:
+// - BC1: principal-axis endpoints, 4-colour mode, one least-squares refit
+// - BC4: min/max endpoints, 8-value mode
+// - BC5: two independent BC4 channels
+// - BC7: mode 6 only (single subset, 7.7.7.7+P endpoints, 4-bit indices),
+//        principal-axis endpoints with one least-squares refit
+// Blocks are encoded in parallel per block row.
+//
+// Decoders handle all BC1/BC4/BC5 modes; the BC7 decoder supports mode 6
+// (everything BcCodec emits) and returns opaque magenta for other modes.
+//
+// Usage:
+//   BcCodec::Compress(texture, BcCodec::SelectFormat(texture, true));
+// ============================================================================
+
+namespace quantiloom {
+
+class QL_API BcCodec {
+public:
+    // Choose a block format from texture usage and content
+    static TextureCompression SelectFormat(const Texture& texture, bool preferBc7 = true);
+
+    // Encode all mip levels into texture.blockLevels (replaces existing blocks)
+    // Format None clears the compressed data
+    static void Compress(Texture& texture, TextureCompression format);
+
+    // Decode one 4x4 block into 16 RGBA8 texels (row-major)
+    static void DecodeBlock(TextureCompression format, const u8* block, u8 outRGBA[64]);
+
+    // Decode a whole compressed mip level to tightly packed RGBA8
+    static std::vector<u8> DecodeLevel(const Texture& texture, u32 level);
+
+    // Bytes per 4x4 block (8 for BC1/BC4, 16 for BC5/BC7)
+    static u32 GetBlockSize(TextureCompression format);
+
+    // Parse a colour format preference from config ("bc7" or "bc1")
+    static bool ParsePreferBc7(StringView name);
+};
+
+} // namespace quantiloom
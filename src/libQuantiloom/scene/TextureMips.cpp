@@ -0,0 +1,299 @@
+#include "TextureMips.hpp"
+#include "TextureSampling.hpp"
+#include "core/Color.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace quantiloom {
+
+// ============================================================================
+// Filter kernels
+// ============================================================================
+
+namespace {
+
+constexpr f32 kKaiserAlpha = 4.0f;   // Window shape (higher = smoother, wider main lobe)
+constexpr f32 kKaiserRadius = 2.0f;  // Half-width in destination texels (8 source taps at 2:1)
+
+// Zeroth-order modified Bessel function of the first kind (power series)
+f64 BesselI0(f64 x) {
+    f64 sum = 1.0;
+    f64 term = 1.0;
+    f64 halfX = 0.5 * x;
+    for (int k = 1; k < 32; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < 1e-12 * sum) {
+            break;
+        }
+    }
+    return sum;
+}
+
+f64 KaiserWeight(f64 u) {
+    f64 absU = std::abs(u);
+    if (absU >= kKaiserRadius) {
+        return 0.0;
+    }
+
+    f64 sinc = (absU < 1e-6) ? 1.0 : std::sin(std::numbers::pi * u) / (std::numbers::pi * u);
+    f64 ratio = u / kKaiserRadius;
+    f64 window = BesselI0(kKaiserAlpha * std::sqrt(1.0 - ratio * ratio)) / BesselI0(kKaiserAlpha);
+    return sinc * window;
+}
+
+// Precomputed 1D resampling weights for one axis (fixed tap count per output)
+struct AxisKernel {
+    u32 tapCount = 0;
+    std::vector<i32> indices;  // [dstSize * tapCount] source texel indices (wrapped)
+    std::vector<f32> weights;  // [dstSize * tapCount] normalised weights
+};
+
+AxisKernel BuildKernel(u32 srcSize, u32 dstSize, MipFilter filter, TextureSampler::WrapMode wrap) {
+    const f64 scale = static_cast<f64>(srcSize) / dstSize;
+    const f64 radius = (filter == MipFilter::Kaiser) ? kKaiserRadius * scale : 0.5 * scale;
+
+    AxisKernel kernel;
+    kernel.tapCount = static_cast<u32>(std::ceil(2.0 * radius)) + 1;
+    kernel.indices.assign(static_cast<usize>(dstSize) * kernel.tapCount, 0);
+    kernel.weights.assign(static_cast<usize>(dstSize) * kernel.tapCount, 0.0f);
+
+    for (u32 d = 0; d < dstSize; ++d) {
+        // Destination texel centre in source texel coordinates
+        f64 center = (d + 0.5) * scale - 0.5;
+        i32 first = static_cast<i32>(std::ceil(center - radius - 1e-6));
+
+        f64 weightSum = 0.0;
+        usize base = static_cast<usize>(d) * kernel.tapCount;
+        for (u32 t = 0; t < kernel.tapCount; ++t) {
+            i32 src = first + static_cast<i32>(t);
+            f64 dist = src - center;
+            f64 w = 0.0;
+
+            if (filter == MipFilter::Kaiser) {
+                w = KaiserWeight(dist / scale);
+            } else {
+                // Box: full weight inside, half weight for texels straddling the edge
+                f64 absDist = std::abs(dist);
+                if (absDist < radius - 1e-6) {
+                    w = 1.0;
+                } else if (absDist < radius + 1e-6) {
+                    w = 0.5;
+                }
+            }
+
+            kernel.indices[base + t] = TextureSampling::WrapCoord(src, static_cast<i32>(srcSize), wrap);
+            kernel.weights[base + t] = static_cast<f32>(w);
+            weightSum += w;
+        }
+
+        if (weightSum > 0.0) {
+            for (u32 t = 0; t < kernel.tapCount; ++t) {
+                kernel.weights[base + t] = static_cast<f32>(kernel.weights[base + t] / weightSum);
+            }
+        }
+    }
+
+    return kernel;
+}
+
+// ============================================================================
+// u8 <-> float conversion per usage
+// ============================================================================
+
+std::vector<f32> DecodeLevel(const Texture& texture) {
+    const u32 channels = texture.channels;
+    const usize texelCount = static_cast<usize>(texture.width) * texture.height;
+
+    std::array<f32, 256> srgbTable{};
+    for (u32 i = 0; i < 256; ++i) {
+        srgbTable[i] = SrgbToLinear(static_cast<f32>(i) / 255.0f);
+    }
+
+    std::vector<f32> out(texelCount * channels);
+    for (usize i = 0; i < texelCount; ++i) {
+        for (u32 c = 0; c < channels; ++c) {
+            u8 raw = texture.pixels[i * channels + c];
+            bool isAlpha = (channels == 4 && c == 3);
+            f32 value = raw / 255.0f;
+
+            if (!isAlpha && c < 3) {
+                if (texture.usage == TextureUsage::Color) {
+                    value = srgbTable[raw];
+                } else if (texture.usage == TextureUsage::Normal) {
+                    value = value * 2.0f - 1.0f;
+                }
+            }
+            out[i * channels + c] = value;
+        }
+    }
+    return out;
+}
+
+void EncodeLevel(const std::vector<f32>& level, u32 channels, TextureUsage usage,
+                 std::vector<u8>& out) {
+    const usize texelCount = level.size() / channels;
+    out.resize(level.size());
+
+    for (usize i = 0; i < texelCount; ++i) {
+        const f32* texel = &level[i * channels];
+
+        f32 invLength = 1.0f;
+        if (usage == TextureUsage::Normal && channels >= 3) {
+            f32 lengthSq = texel[0] * texel[0] + texel[1] * texel[1] + texel[2] * texel[2];
+            invLength = (lengthSq > 1e-12f) ? 1.0f / std::sqrt(lengthSq) : 1.0f;
+        }
+
+        for (u32 c = 0; c < channels; ++c) {
+            f32 value = texel[c];
+            bool isAlpha = (channels == 4 && c == 3);
+
+            if (!isAlpha && c < 3) {
+                if (usage == TextureUsage::Color) {
+                    value = LinearToSrgb(std::clamp(value, 0.0f, 1.0f));
+                } else if (usage == TextureUsage::Normal) {
+                    value = value * invLength * 0.5f + 0.5f;
+                }
+            }
+            out[i * channels + c] = QuantizeUnorm8(value);
+        }
+    }
+}
+
+// Downsample one level with separable filtering (horizontal, then vertical)
+std::vector<f32> DownsampleLevel(const std::vector<f32>& src, u32 srcWidth, u32 srcHeight,
+                                 u32 dstWidth, u32 dstHeight, u32 channels,
+                                 MipFilter filter, const TextureSampler& sampler) {
+    AxisKernel kernelX = BuildKernel(srcWidth, dstWidth, filter, sampler.wrapS);
+    AxisKernel kernelY = BuildKernel(srcHeight, dstHeight, filter, sampler.wrapT);
+
+    // Rows per parallel chunk: aim for ~64K floats of work per chunk
+    auto rowGrain = [](usize rowElements) {
+        return std::max<usize>(1, 65536 / std::max<usize>(rowElements, 1));
+    };
+
+    // Horizontal pass: srcHeight rows of dstWidth texels
+    std::vector<f32> temp(static_cast<usize>(srcHeight) * dstWidth * channels);
+    ParallelFor(srcHeight, rowGrain(static_cast<usize>(srcWidth) * channels), [&](usize y) {
+        const f32* srcRow = &src[y * srcWidth * channels];
+        f32* dstRow = &temp[y * dstWidth * channels];
+        for (u32 x = 0; x < dstWidth; ++x) {
+            usize base = static_cast<usize>(x) * kernelX.tapCount;
+            for (u32 c = 0; c < channels; ++c) {
+                f32 sum = 0.0f;
+                for (u32 t = 0; t < kernelX.tapCount; ++t) {
+                    sum += kernelX.weights[base + t] * srcRow[static_cast<usize>(kernelX.indices[base + t]) * channels + c];
+                }
+                dstRow[x * channels + c] = sum;
+            }
+        }
+    });
+
+    // Vertical pass: accumulate whole rows for cache-friendly access
+    const usize rowElements = static_cast<usize>(dstWidth) * channels;
+    std::vector<f32> dst(static_cast<usize>(dstHeight) * rowElements, 0.0f);
+    ParallelFor(dstHeight, rowGrain(rowElements * kernelY.tapCount), [&](usize y) {
+        f32* dstRow = &dst[y * rowElements];
+        usize base = y * kernelY.tapCount;
+        for (u32 t = 0; t < kernelY.tapCount; ++t) {
+            f32 w = kernelY.weights[base + t];
+            if (w == 0.0f) {
+                continue;
+            }
+            const f32* srcRow = &temp[static_cast<usize>(kernelY.indices[base + t]) * rowElements];
+            for (usize i = 0; i < rowElements; ++i) {
+                dstRow[i] += w * srcRow[i];
+            }
+        }
+    });
+
+    return dst;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// MipGenerator
+// ============================================================================
+
+u32 MipGenerator::ComputeMipCount(u32 width, u32 height) {
+    u32 count = 1;
+    u32 largest = std::max(width, height);
+    while (largest > 1) {
+        largest >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+MipFilter MipGenerator::ParseFilter(StringView name) {
+    if (name == "kaiser") {
+        return MipFilter::Kaiser;
+    }
+    if (name != "box") {
+        QL_LOG_WARN("Unknown mip filter '{}', using box", name);
+    }
+    return MipFilter::Box;
+}
+
+void MipGenerator::GenerateMips(Texture& texture, MipFilter filter) {
+    texture.mips.clear();
+
+    if (!texture.IsValid()) {
+        QL_LOG_WARN("Skipping mip generation for invalid texture '{}'", texture.name);
+        return;
+    }
+
+    const u32 mipCount = ComputeMipCount(texture.width, texture.height);
+    if (mipCount <= 1) {
+        return;
+    }
+
+    texture.mips.reserve(mipCount - 1);
+
+    std::vector<f32> current = DecodeLevel(texture);
+    u32 width = texture.width;
+    u32 height = texture.height;
+
+    for (u32 level = 1; level < mipCount; ++level) {
+        u32 nextWidth = std::max(1u, width / 2);
+        u32 nextHeight = std::max(1u, height / 2);
+
+        std::vector<f32> next = DownsampleLevel(current, width, height, nextWidth, nextHeight,
+                                                texture.channels, filter, texture.sampler);
+
+        TextureMip mip;
+        mip.width = nextWidth;
+        mip.height = nextHeight;
+        EncodeLevel(next, texture.channels, texture.usage, mip.pixels);
+        texture.mips.push_back(std::move(mip));
+
+        current = std::move(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+void MipGenerator::GenerateMips(std::vector<Texture>& textures, MipFilter filter) {
+    u32 generated = 0;
+    for (auto& texture : textures) {
+        if (!texture.mips.empty()) {
+            continue;
+        }
+        GenerateMips(texture, filter);
+        if (!texture.mips.empty()) {
+            ++generated;
+        }
+    }
+
+    if (generated > 0) {
+        QL_LOG_INFO("Generated mip chains for {} texture(s) ({} filter)",
+                    generated, filter == MipFilter::Kaiser ? "kaiser" : "box");
+    }
+}
+
+} // namespace quantiloom
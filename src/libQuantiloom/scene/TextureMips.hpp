@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "scene/Texture.hpp"
+#include <vector>
+
+// ============================================================================
+// MipGenerator - CPU mip chain generation for Texture objects
+// ============================================================================
+// Builds the full mip chain (down to 1x1) for each texture at load time so
+// that TextureManager can upload every level and the shaders can select a
+// level from the ray cone footprint instead of always sampling level 0.
+//
+// Filtering:
+// - Box:    2x2 average (fast, slight aliasing on high-frequency content)
+// - Kaiser: 8-tap separable Kaiser-windowed sinc (sharper, less aliasing)
+//
+// Colour handling (per TextureUsage):
+// - Color:  RGB decoded sRGB -> linear before filtering, re-encoded after
+// - Data:   filtered as stored (linear)
+// - Normal: decoded to [-1, 1], filtered, renormalised, re-encoded
+// Alpha is always filtered linearly.
+//
+// Each level is filtered from the previous level's float buffer (not from
+// the quantised u8 data), and rows are processed in parallel.
+//
+// Usage:
+//   MipGenerator::GenerateMips(scene.textures, MipFilter::Kaiser);
+// ============================================================================
+
+namespace quantiloom {
+
+enum class MipFilter : u32 {
+    Box = 0,
+    Kaiser = 1
+};
+
+class QL_API MipGenerator {
+public:
+    // Generate mip levels 1..N-1 for a texture (replaces existing mips)
+    // Textures that are invalid or 1x1 are left without a mip chain
+    static void GenerateMips(Texture& texture, MipFilter filter = MipFilter::Box);
+
+    // Generate mips for every texture that does not have a mip chain yet
+    static void GenerateMips(std::vector<Texture>& textures, MipFilter filter = MipFilter::Box);
+
+    // Number of levels in a full chain for the given dimensions (including level 0)
+    static u32 ComputeMipCount(u32 width, u32 height);
+
+    // Parse a filter name from config ("box" or "kaiser", defaults to Box)
+    static MipFilter ParseFilter(StringView name);
+};
+
+} // namespace quantiloom
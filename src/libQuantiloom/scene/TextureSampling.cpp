@@ -0,0 +1,156 @@
+#include "TextureSampling.hpp"
+#include "TextureCompression.hpp"
+#include "core/Color.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace quantiloom {
+
+i32 TextureSampling::WrapCoord(i32 coord, i32 size, TextureSampler::WrapMode mode) {
+    switch (mode) {
+        case TextureSampler::WrapMode::Repeat:
+            return ((coord % size) + size) % size;
+        case TextureSampler::WrapMode::MirroredRepeat: {
+            i32 period = 2 * size;
+            i32 m = ((coord % period) + period) % period;
+            return (m < size) ? m : (period - 1 - m);
+        }
+        case TextureSampler::WrapMode::ClampToEdge:
+        default:
+            return std::clamp(coord, 0, size - 1);
+    }
+}
+
+glm::vec4 TextureSampling::FetchTexel(const Texture& texture, u32 level, i32 x, i32 y) {
+    const i32 width = static_cast<i32>(texture.GetMipWidth(level));
+    const i32 height = static_cast<i32>(texture.GetMipHeight(level));
+    x = WrapCoord(x, width, texture.sampler.wrapS);
+    y = WrapCoord(y, height, texture.sampler.wrapT);
+
+    // Compressed textures are decoded per block so results match the GPU exactly
+    u8 decoded[64];
+    const u8* texel = nullptr;
+    u32 channels = texture.channels;
+    if (texture.IsCompressed()) {
+        const TextureBlockLevel& blockLevel = texture.blockLevels[level];
+        const u32 blockSize = BcCodec::GetBlockSize(texture.compression);
+        const usize blocksX = (static_cast<usize>(width) + 3) / 4;
+        const usize blockIndex = (static_cast<usize>(y) / 4) * blocksX + static_cast<usize>(x) / 4;
+        BcCodec::DecodeBlock(texture.compression, &blockLevel.blocks[blockIndex * blockSize], decoded);
+        texel = &decoded[((y % 4) * 4 + (x % 4)) * 4];
+        channels = 4;
+    } else {
+        texel = texture.GetMipPixels(level).data() +
+                (static_cast<usize>(y) * static_cast<usize>(width) + static_cast<usize>(x)) * texture.channels;
+    }
+
+    glm::vec4 result(0.0f, 0.0f, 0.0f, 1.0f);
+    for (u32 c = 0; c < channels; ++c) {
+        f32 value = texel[c] / 255.0f;
+        if (texture.usage == TextureUsage::Color && c < 3) {
+            value = SrgbToLinear(value);
+        }
+        result[static_cast<glm::length_t>(c)] = value;
+    }
+    return result;
+}
+
+glm::vec4 TextureSampling::SampleBilinear(const Texture& texture, u32 level, glm::vec2 uv, bool linear) {
+    const f32 x = uv.x * static_cast<f32>(texture.GetMipWidth(level));
+    const f32 y = uv.y * static_cast<f32>(texture.GetMipHeight(level));
+
+    if (!linear) {
+        return FetchTexel(texture, level,
+                          static_cast<i32>(std::floor(x)), static_cast<i32>(std::floor(y)));
+    }
+
+    // Texel centres are at half-integer coordinates
+    const f32 fx = x - 0.5f;
+    const f32 fy = y - 0.5f;
+    const i32 x0 = static_cast<i32>(std::floor(fx));
+    const i32 y0 = static_cast<i32>(std::floor(fy));
+    const f32 tx = fx - static_cast<f32>(x0);
+    const f32 ty = fy - static_cast<f32>(y0);
+
+    glm::vec4 top = glm::mix(FetchTexel(texture, level, x0, y0),
+                             FetchTexel(texture, level, x0 + 1, y0), tx);
+    glm::vec4 bottom = glm::mix(FetchTexel(texture, level, x0, y0 + 1),
+                                FetchTexel(texture, level, x0 + 1, y0 + 1), tx);
+    return glm::mix(top, bottom, ty);
+}
+
+glm::vec4 TextureSampling::SampleLevel(const Texture& texture, glm::vec2 uv, f32 lod) {
+    if (!texture.IsValid()) {
+        return glm::vec4(1.0f);
+    }
+
+    const TextureSampler& sampler = texture.sampler;
+    const f32 maxLevel = static_cast<f32>(texture.GetMipCount() - 1);
+    lod = std::clamp(lod, 0.0f, maxLevel);
+
+    // Magnification uses magFilter, minification uses minFilter (Vulkan rules)
+    const bool linear = (lod <= 0.0f) ? sampler.magFilter == TextureSampler::Filter::Linear
+                                      : sampler.minFilter == TextureSampler::Filter::Linear;
+
+    if (sampler.mipFilter == TextureSampler::Filter::Nearest) {
+        u32 level = static_cast<u32>(std::floor(lod + 0.5f));
+        return SampleBilinear(texture, level, uv, linear);
+    }
+
+    const u32 level0 = static_cast<u32>(std::floor(lod));
+    const u32 level1 = std::min(level0 + 1, texture.GetMipCount() - 1);
+    const f32 t = lod - static_cast<f32>(level0);
+
+    glm::vec4 a = SampleBilinear(texture, level0, uv, linear);
+    if (t <= 0.0f || level1 == level0) {
+        return a;
+    }
+    glm::vec4 b = SampleBilinear(texture, level1, uv, linear);
+    return glm::mix(a, b, t);
+}
+
+f32 TextureSampling::ComputeLod(const Texture& texture, glm::vec2 ddx, glm::vec2 ddy) {
+    const glm::vec2 size(static_cast<f32>(texture.width), static_cast<f32>(texture.height));
+    const f32 lengthX = glm::length(ddx * size);
+    const f32 lengthY = glm::length(ddy * size);
+    const f32 major = std::max(lengthX, lengthY);
+    return (major > 0.0f) ? std::log2(major) : 0.0f;
+}
+
+glm::vec4 TextureSampling::SampleGrad(const Texture& texture, glm::vec2 uv,
+                                      glm::vec2 ddx, glm::vec2 ddy, u32 maxAnisotropy) {
+    if (!texture.IsValid()) {
+        return glm::vec4(1.0f);
+    }
+
+    const glm::vec2 size(static_cast<f32>(texture.width), static_cast<f32>(texture.height));
+    const f32 lengthX = glm::length(ddx * size);
+    const f32 lengthY = glm::length(ddy * size);
+
+    const bool xIsMajor = lengthX >= lengthY;
+    const f32 major = xIsMajor ? lengthX : lengthY;
+    const f32 minor = xIsMajor ? lengthY : lengthX;
+    const glm::vec2 majorAxis = xIsMajor ? ddx : ddy;
+
+    if (major <= 0.0f) {
+        return SampleLevel(texture, uv, 0.0f);
+    }
+
+    // Number of probes along the major axis; LOD chosen from the per-probe footprint
+    const f32 ratio = (minor > 0.0f) ? major / minor : static_cast<f32>(maxAnisotropy);
+    const u32 probes = std::clamp(static_cast<u32>(std::ceil(ratio)), 1u, std::max(1u, maxAnisotropy));
+    const f32 lod = std::log2(major / static_cast<f32>(probes));
+
+    if (probes == 1) {
+        return SampleLevel(texture, uv, lod);
+    }
+
+    glm::vec4 sum(0.0f);
+    for (u32 i = 0; i < probes; ++i) {
+        f32 offset = (static_cast<f32>(i) + 0.5f) / static_cast<f32>(probes) - 0.5f;
+        sum += SampleLevel(texture, uv + majorAxis * offset, lod);
+    }
+    return sum / static_cast<f32>(probes);
+}
+
+} // namespace quantiloom
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "scene/Texture.hpp"
+#include <glm/glm.hpp>
+
+// ============================================================================
+// TextureSampling - CPU texture sampler (mirrors the GPU sampler state)
+// ============================================================================
+// Reference implementation of what TextureManager's VkSampler + SampleGrad
+// do on the GPU, for CPU-side rendering and validation:
+// - Bilinear filtering within a level (nearest if min/mag filter is Nearest)
+// - Trilinear filtering between mip levels (nearest level if mipFilter is Nearest)
+// - Anisotropic filtering: up to maxAnisotropy probes along the major axis
+// - Wrap modes: Repeat, ClampToEdge, MirroredRepeat
+//
+// Returned values match the GPU image format:
+// - Color textures are sRGB-decoded to linear before filtering (VK_FORMAT_*_SRGB)
+// - Data/Normal textures return raw [0, 1] values (VK_FORMAT_*_UNORM)
+// Missing channels are filled as (0, 0, 0, 1) like Vulkan format expansion.
+// Block-compressed textures are sampled from their decoded BCn blocks.
+//
+// Usage:
+//   glm::vec4 texel = TextureSampling::SampleGrad(texture, uv, ddx, ddy);
+// ============================================================================
+
+namespace quantiloom {
+
+class QL_API TextureSampling {
+public:
+    // Trilinear sample at an explicit level of detail
+    static glm::vec4 SampleLevel(const Texture& texture, glm::vec2 uv, f32 lod);
+
+    // Sample with UV-space footprint derivatives (anisotropic + trilinear)
+    static glm::vec4 SampleGrad(const Texture& texture, glm::vec2 uv,
+                                glm::vec2 ddx, glm::vec2 ddy, u32 maxAnisotropy = 16);
+
+    // Isotropic LOD for a UV footprint (log2 of the major axis in texels)
+    static f32 ComputeLod(const Texture& texture, glm::vec2 ddx, glm::vec2 ddy);
+
+    // Map an integer texel coordinate into [0, size) according to a wrap mode
+    static i32 WrapCoord(i32 coord, i32 size, TextureSampler::WrapMode mode);
+
+private:
+    static glm::vec4 FetchTexel(const Texture& texture, u32 level, i32 x, i32 y);
+    static glm::vec4 SampleBilinear(const Texture& texture, u32 level, glm::vec2 uv, bool linear);
+};
+
+} // namespace quantiloom
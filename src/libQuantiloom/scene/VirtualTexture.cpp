@@ -0,0 +1,327 @@
+#include "VirtualTexture.hpp"
+#include "TextureSampling.hpp"
+#include "core/Color.hpp"
+#include "core/Log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace quantiloom {
+
+// ============================================================================
+// VirtualTextureFeedback
+// ============================================================================
+
+void VirtualTextureFeedback::Merge(const VirtualTextureFeedback& other) {
+    m_requests.insert(m_requests.end(), other.m_requests.begin(), other.m_requests.end());
+}
+
+std::vector<TileId> VirtualTextureFeedback::Resolve() const {
+    std::vector<u64> sorted = m_requests;
+    std::sort(sorted.begin(), sorted.end());
+
+    struct Request {
+        u64 key;
+        u32 count;
+    };
+    std::vector<Request> unique;
+    for (usize i = 0; i < sorted.size();) {
+        usize j = i;
+        while (j < sorted.size() && sorted[j] == sorted[i]) {
+            ++j;
+        }
+        unique.push_back({sorted[i], static_cast<u32>(j - i)});
+        i = j;
+    }
+
+    // Coarser mips first, then most requested, then key (deterministic order)
+    std::sort(unique.begin(), unique.end(), [](const Request& a, const Request& b) {
+        const u32 mipA = TileId::Unpack(a.key).mip;
+        const u32 mipB = TileId::Unpack(b.key).mip;
+        if (mipA != mipB) {
+            return mipA > mipB;
+        }
+        if (a.count != b.count) {
+            return a.count > b.count;
+        }
+        return a.key < b.key;
+    });
+
+    std::vector<TileId> tiles;
+    tiles.reserve(unique.size());
+    for (const Request& request : unique) {
+        tiles.push_back(TileId::Unpack(request.key));
+    }
+    return tiles;
+}
+
+// ============================================================================
+// TilePool
+// ============================================================================
+
+TilePool::TilePool(u32 capacity, usize tileBytes)
+    : m_capacity(capacity)
+    , m_tileBytes(tileBytes)
+    , m_storage(static_cast<usize>(capacity) * tileBytes)
+    , m_slots(capacity) {
+    // Hand out low slots first
+    m_freeSlots.reserve(capacity);
+    for (u32 i = capacity; i > 0; --i) {
+        m_freeSlots.push_back(i - 1);
+    }
+}
+
+u32 TilePool::Find(u64 key) const {
+    auto it = m_slotOfKey.find(key);
+    return (it != m_slotOfKey.end()) ? it->second : INVALID_SLOT;
+}
+
+void TilePool::Touch(u32 slot, u64 frame) {
+    Slot& s = m_slots[slot];
+    s.lastUsedFrame = frame;
+    if (!s.pinned) {
+        m_lru.splice(m_lru.end(), m_lru, s.lruIt);
+    }
+}
+
+u32 TilePool::Allocate(u64 key, u64 frame, bool pinned, u64* evictedKey) {
+    u32 slot = INVALID_SLOT;
+
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        // Evict the least recently used tile, unless it is still needed this frame
+        if (m_lru.empty() || m_slots[m_lru.front()].lastUsedFrame >= frame) {
+            return INVALID_SLOT;
+        }
+        slot = m_lru.front();
+        m_lru.pop_front();
+
+        Slot& victim = m_slots[slot];
+        if (evictedKey) {
+            *evictedKey = victim.key;
+        }
+        m_slotOfKey.erase(victim.key);
+    }
+
+    Slot& s = m_slots[slot];
+    s.key = key;
+    s.lastUsedFrame = frame;
+    s.occupied = true;
+    s.pinned = pinned;
+    if (!pinned) {
+        s.lruIt = m_lru.insert(m_lru.end(), slot);
+    }
+    m_slotOfKey[key] = slot;
+    return slot;
+}
+
+// ============================================================================
+// VirtualTextureSystem: Open / Close
+// ============================================================================
+
+bool VirtualTextureSystem::Open(const std::string& tileCachePath, u32 poolCapacity) {
+    Close();
+
+    if (!m_file.Open(tileCachePath)) {
+        return false;
+    }
+
+    // Pinned fallback tiles: the coarsest level of every texture
+    u64 pinnedTiles = 0;
+    for (u32 t = 0; t < m_file.GetTextureCount(); ++t) {
+        const u32 mip = m_file.GetTextureInfo(t).mipCount - 1;
+        pinnedTiles += static_cast<u64>(m_file.GetTilesX(t, mip)) * m_file.GetTilesY(t, mip);
+    }
+    if (pinnedTiles >= poolCapacity) {
+        QL_LOG_ERROR("VirtualTextureSystem: Pool of {} tiles cannot hold {} pinned fallback tiles",
+                     poolCapacity, pinnedTiles);
+        Close();
+        return false;
+    }
+
+    m_pool = std::make_unique<TilePool>(poolCapacity, m_file.GetTileBytes());
+    for (u32 t = 0; t < m_file.GetTextureCount(); ++t) {
+        const u32 mip = m_file.GetTextureInfo(t).mipCount - 1;
+        for (u32 y = 0; y < m_file.GetTilesY(t, mip); ++y) {
+            for (u32 x = 0; x < m_file.GetTilesX(t, mip); ++x) {
+                const TileId tile{t, mip, x, y};
+                const u32 slot = m_pool->Allocate(tile.Pack(), m_frame, true);
+                std::memcpy(m_pool->GetSlotData(slot), m_file.GetTile(t, mip, x, y), m_file.GetTileBytes());
+            }
+        }
+    }
+
+    QL_LOG_INFO("VirtualTextureSystem: {} texture(s), pool {} tiles ({:.1f} MB), {} pinned",
+                m_file.GetTextureCount(), poolCapacity,
+                static_cast<f64>(poolCapacity * m_file.GetTileBytes()) / (1024.0 * 1024.0), pinnedTiles);
+    return true;
+}
+
+void VirtualTextureSystem::Close() {
+    m_pool.reset();
+    m_file.Close();
+    m_stats = Stats{};
+    m_frame = 1;
+}
+
+// ============================================================================
+// VirtualTextureSystem: Streaming
+// ============================================================================
+
+std::vector<VirtualTextureSystem::TileUpload> VirtualTextureSystem::Update(
+    const VirtualTextureFeedback& feedback, u32 maxUploads) {
+    std::vector<TileUpload> uploads;
+    m_stats = Stats{};
+    if (!m_pool) {
+        return uploads;
+    }
+
+    const std::vector<TileId> requested = feedback.Resolve();
+    m_stats.requested = static_cast<u32>(requested.size());
+
+    // Touch resident tiles first so they are protected from eviction this frame
+    for (const TileId& tile : requested) {
+        const u32 slot = m_pool->Find(tile.Pack());
+        if (slot != TilePool::INVALID_SLOT) {
+            m_pool->Touch(slot, m_frame);
+            ++m_stats.hits;
+        }
+    }
+
+    for (const TileId& tile : requested) {
+        const u64 key = tile.Pack();
+        if (m_pool->Find(key) != TilePool::INVALID_SLOT) {
+            continue;
+        }
+
+        const u8* data = m_file.GetTile(tile.texture, tile.mip, tile.x, tile.y);
+        if (!data) {
+            continue;  // Stale request for a tile outside the file
+        }
+        if (uploads.size() >= maxUploads) {
+            ++m_stats.deferred;
+            continue;
+        }
+
+        u64 evictedKey = TilePool::NO_KEY;
+        const u32 slot = m_pool->Allocate(key, m_frame, false, &evictedKey);
+        if (slot == TilePool::INVALID_SLOT) {
+            ++m_stats.deferred;
+            continue;
+        }
+        if (evictedKey != TilePool::NO_KEY) {
+            ++m_stats.evictions;
+        }
+
+        std::memcpy(m_pool->GetSlotData(slot), data, m_file.GetTileBytes());
+        uploads.push_back({slot, tile, data});
+    }
+
+    m_stats.uploads = static_cast<u32>(uploads.size());
+    ++m_frame;
+    return uploads;
+}
+
+// ============================================================================
+// VirtualTextureSystem: Translation / Sampling
+// ============================================================================
+
+TileId VirtualTextureSystem::GetTileId(u32 textureIndex, u32 mip, u32 x, u32 y) const {
+    const u32 tileSize = m_file.GetTileSize();
+    return TileId{textureIndex, mip, x / tileSize, y / tileSize};
+}
+
+u32 VirtualTextureSystem::Translate(const TileId& tile, u32* residentMip) const {
+    if (!m_pool || tile.texture >= m_file.GetTextureCount()) {
+        return TilePool::INVALID_SLOT;
+    }
+
+    const u32 mipCount = m_file.GetTextureInfo(tile.texture).mipCount;
+    TileId current = tile;
+    while (current.mip < mipCount) {
+        const u32 slot = m_pool->Find(current.Pack());
+        if (slot != TilePool::INVALID_SLOT) {
+            if (residentMip) {
+                *residentMip = current.mip;
+            }
+            return slot;
+        }
+        // Parent tile covers twice the texel area
+        current.mip += 1;
+        current.x /= 2;
+        current.y /= 2;
+    }
+    return TilePool::INVALID_SLOT;
+}
+
+glm::vec4 VirtualTextureSystem::FetchTexel(u32 textureIndex, u32 mip, i32 x, i32 y) const {
+    const TileCacheFile::TextureInfo& info = m_file.GetTextureInfo(textureIndex);
+    const i32 width = static_cast<i32>(std::max(1u, info.width >> mip));
+    const i32 height = static_cast<i32>(std::max(1u, info.height >> mip));
+    x = TextureSampling::WrapCoord(x, width, info.wrapS);
+    y = TextureSampling::WrapCoord(y, height, info.wrapT);
+
+    u32 residentMip = mip;
+    const u32 slot = Translate(GetTileId(textureIndex, mip, static_cast<u32>(x), static_cast<u32>(y)), &residentMip);
+    if (slot == TilePool::INVALID_SLOT) {
+        return glm::vec4(1.0f);
+    }
+
+    // Texel coordinates in the resident (possibly coarser) level
+    const u32 shift = residentMip - mip;
+    const u32 tileSize = m_file.GetTileSize();
+    const u32 rx = static_cast<u32>(x) >> shift;
+    const u32 ry = static_cast<u32>(y) >> shift;
+    const u32 localX = rx % tileSize + m_file.GetBorder();
+    const u32 localY = ry % tileSize + m_file.GetBorder();
+
+    const u8* texel = m_pool->GetSlotData(slot) +
+                      (static_cast<usize>(localY) * m_file.GetStoredTileSize() + localX) * 4;
+
+    glm::vec4 result;
+    for (u32 c = 0; c < 4; ++c) {
+        f32 value = texel[c] / 255.0f;
+        if (info.usage == TextureUsage::Color && c < 3) {
+            value = SrgbToLinear(value);
+        }
+        result[static_cast<glm::length_t>(c)] = value;
+    }
+    return result;
+}
+
+glm::vec4 VirtualTextureSystem::Sample(u32 textureIndex, glm::vec2 uv, f32 lod,
+                                       VirtualTextureFeedback* feedback) const {
+    if (!m_pool || textureIndex >= m_file.GetTextureCount()) {
+        return glm::vec4(1.0f);
+    }
+
+    const TileCacheFile::TextureInfo& info = m_file.GetTextureInfo(textureIndex);
+    const f32 maxLevel = static_cast<f32>(info.mipCount - 1);
+    const u32 mip = static_cast<u32>(std::floor(std::clamp(lod, 0.0f, maxLevel) + 0.5f));
+
+    const i32 width = static_cast<i32>(std::max(1u, info.width >> mip));
+    const i32 height = static_cast<i32>(std::max(1u, info.height >> mip));
+    const f32 fx = uv.x * static_cast<f32>(width) - 0.5f;
+    const f32 fy = uv.y * static_cast<f32>(height) - 0.5f;
+    const i32 x0 = static_cast<i32>(std::floor(fx));
+    const i32 y0 = static_cast<i32>(std::floor(fy));
+    const f32 tx = fx - static_cast<f32>(x0);
+    const f32 ty = fy - static_cast<f32>(y0);
+
+    if (feedback) {
+        const i32 cx = TextureSampling::WrapCoord(static_cast<i32>(std::floor(fx + 0.5f)), width, info.wrapS);
+        const i32 cy = TextureSampling::WrapCoord(static_cast<i32>(std::floor(fy + 0.5f)), height, info.wrapT);
+        feedback->Record(GetTileId(textureIndex, mip, static_cast<u32>(cx), static_cast<u32>(cy)));
+    }
+
+    glm::vec4 top = glm::mix(FetchTexel(textureIndex, mip, x0, y0),
+                             FetchTexel(textureIndex, mip, x0 + 1, y0), tx);
+    glm::vec4 bottom = glm::mix(FetchTexel(textureIndex, mip, x0, y0 + 1),
+                                FetchTexel(textureIndex, mip, x0 + 1, y0 + 1), tx);
+    return glm::mix(top, bottom, ty);
+}
+
+} // namespace quantiloom
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "io/TileCacheFile.hpp"
+#include <glm/glm.hpp>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// VirtualTexture - Tile residency, feedback and streaming for texture sets
+//                  larger than memory
+// ============================================================================
+// Textures live in a memory-mapped TileCacheFile. Only the tiles that were
+// actually touched are kept in a fixed-size physical tile pool:
+//
+//   1. Feedback: every sample records the (texture, mip, tile) it wanted
+//      (VirtualTextureFeedback; the GPU equivalent is a readback buffer)
+//   2. Update:   requested tiles are streamed from the cache file into free
+//      or least-recently-used pool slots, up to an upload budget per frame
+//   3. Sample:   lookups translate virtual tiles to pool slots; tiles that
+//      are not resident yet fall back to the nearest resident coarser mip
+//
+// The coarsest level of every texture is loaded and pinned at Open(), so a
+// fallback always exists. Pool slots mirror a GPU tile pool image: Update()
+// returns the list of (slot, tile data) uploads a GPU backend has to copy.
+//
+// All residency logic is CPU-only and deterministic, so it can be exercised
+// without a GPU.
+//
+// Usage:
+//   VirtualTextureSystem vt;
+//   vt.Open("scene.qlvt", 1024);                 // 1024 pool slots
+//   for (frame...) {
+//       VirtualTextureFeedback feedback;
+//       glm::vec4 c = vt.Sample(tex, uv, lod, &feedback);
+//       auto uploads = vt.Update(feedback, 64);   // Stream <= 64 tiles
+//   }
+// ============================================================================
+
+namespace quantiloom {
+
+// Virtual tile address (texture, mip level, tile coordinates)
+struct TileId {
+    u32 texture = 0;
+    u32 mip = 0;
+    u32 x = 0;
+    u32 y = 0;
+
+    // Packed 64-bit key: 20 bits texture, 4 bits mip, 20 bits x, 20 bits y
+    u64 Pack() const {
+        return (static_cast<u64>(texture) << 44) | (static_cast<u64>(mip) << 40) |
+               (static_cast<u64>(x) << 20) | static_cast<u64>(y);
+    }
+
+    static TileId Unpack(u64 key) {
+        return TileId{static_cast<u32>(key >> 44), static_cast<u32>((key >> 40) & 0xF),
+                      static_cast<u32>((key >> 20) & 0xFFFFF), static_cast<u32>(key & 0xFFFFF)};
+    }
+
+    bool operator==(const TileId&) const = default;
+};
+
+// ============================================================================
+// VirtualTextureFeedback - Tile requests gathered while sampling
+// ============================================================================
+// Not thread-safe: use one instance per thread and Merge() them before Update.
+class QL_API VirtualTextureFeedback {
+public:
+    void Record(const TileId& tile) { m_requests.push_back(tile.Pack()); }
+    void Merge(const VirtualTextureFeedback& other);
+    void Clear() { m_requests.clear(); }
+
+    // Unique requested tiles ordered for streaming: coarse mips first (they
+    // fix the most visible fallbacks), then by request count
+    std::vector<TileId> Resolve() const;
+
+    usize GetRequestCount() const { return m_requests.size(); }
+
+private:
+    std::vector<u64> m_requests;
+};
+
+// ============================================================================
+// TilePool - Fixed number of physical tile slots with LRU eviction
+// ============================================================================
+class QL_API TilePool {
+public:
+    static constexpr u32 INVALID_SLOT = ~0u;
+    static constexpr u64 NO_KEY = ~0ull;
+
+    TilePool(u32 capacity, usize tileBytes);
+
+    // Slot holding a tile, or INVALID_SLOT if not resident
+    u32 Find(u64 key) const;
+
+    // Mark a resident slot as used in this frame (moves it to the MRU end)
+    void Touch(u32 slot, u64 frame);
+
+    // Get a slot for a new tile: a free slot, else the least recently used
+    // unpinned slot not touched in this frame. Returns INVALID_SLOT if full.
+    // evictedKey receives the key that was evicted (left untouched if none)
+    u32 Allocate(u64 key, u64 frame, bool pinned, u64* evictedKey = nullptr);
+
+    u8* GetSlotData(u32 slot) { return m_storage.data() + slot * m_tileBytes; }
+    const u8* GetSlotData(u32 slot) const { return m_storage.data() + slot * m_tileBytes; }
+
+    u32 GetCapacity() const { return m_capacity; }
+    u32 GetResidentCount() const { return static_cast<u32>(m_slotOfKey.size()); }
+
+private:
+    struct Slot {
+        u64 key = 0;
+        u64 lastUsedFrame = 0;
+        bool occupied = false;
+        bool pinned = false;
+        std::list<u32>::iterator lruIt;
+    };
+
+    u32 m_capacity;
+    usize m_tileBytes;
+    std::vector<u8> m_storage;
+    std::vector<Slot> m_slots;
+    std::vector<u32> m_freeSlots;
+    std::list<u32> m_lru;                        // Front = least recently used
+    std::unordered_map<u64, u32> m_slotOfKey;
+};
+
+// ============================================================================
+// VirtualTextureSystem - Cache file + tile pool + page translation
+// ============================================================================
+class QL_API VirtualTextureSystem {
+public:
+    struct TileUpload {
+        u32 slot;
+        TileId tile;
+        const u8* data;   // Tile texels (RGBA8, GetStoredTileSize()^2), valid until Close()
+    };
+
+    struct Stats {
+        u32 requested = 0;   // Unique tiles requested by the last feedback
+        u32 hits = 0;        // Already resident
+        u32 uploads = 0;     // Streamed in this frame
+        u32 evictions = 0;   // Tiles evicted to make room
+        u32 deferred = 0;    // Over budget or pool full, retried next frame
+    };
+
+    // Map the cache file and pin the coarsest level of every texture
+    // Returns false if the file cannot be opened or the pool cannot hold the pinned tiles
+    bool Open(const std::string& tileCachePath, u32 poolCapacity);
+    void Close();
+
+    // Stream requested tiles into the pool (at most maxUploads) and advance the frame
+    std::vector<TileUpload> Update(const VirtualTextureFeedback& feedback, u32 maxUploads);
+
+    // Pool slot and mip level actually used for a virtual tile (walks up the
+    // mip chain to the nearest resident ancestor)
+    u32 Translate(const TileId& tile, u32* residentMip = nullptr) const;
+
+    // Filtered sample (bilinear within the nearest mip level), recording the
+    // wanted tile into feedback if given. Color textures are sRGB-decoded.
+    glm::vec4 Sample(u32 textureIndex, glm::vec2 uv, f32 lod,
+                     VirtualTextureFeedback* feedback = nullptr) const;
+
+    // Tile containing texel (x, y) of a mip level
+    TileId GetTileId(u32 textureIndex, u32 mip, u32 x, u32 y) const;
+
+    const TileCacheFile& GetCacheFile() const { return m_file; }
+    const TilePool* GetPool() const { return m_pool.get(); }
+    const Stats& GetLastStats() const { return m_stats; }
+    u64 GetFrame() const { return m_frame; }
+
+private:
+    glm::vec4 FetchTexel(u32 textureIndex, u32 mip, i32 x, i32 y) const;
+
+    TileCacheFile m_file;
+    std::unique_ptr<TilePool> m_pool;
+    Stats m_stats;
+    u64 m_frame = 1;
+};
+
+} // namespace quantiloom
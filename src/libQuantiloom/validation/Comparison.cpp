@@ -0,0 +1,610 @@
+#include "Comparison.hpp"
+#include "core/Log.hpp"
+#include "core/Parallel.hpp"
+#include "io/ImageIO.hpp"
+#include "io/SpectralIO.hpp"
+#include "postprocess/AtrousDenoiser.hpp"
+#include "postprocess/PsfConvolution.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace quantiloom {
+
+// Independent accumulators per row (one SIMD register of f32)
+static constexpr usize kLanes = 8;
+
+// Two-sided 95% normal quantile
+static constexpr f64 kZ95 = 1.959964;
+
+// SSIM stabilisers (Wang et al. 2004): C1 = (K1 L)^2, C2 = (K2 L)^2
+static constexpr f64 kSsimK1 = 0.01;
+static constexpr f64 kSsimK2 = 0.03;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+struct TileSums {
+    f64 sumTest = 0.0;
+    f64 sumReference = 0.0;
+    f64 sumDiff = 0.0;
+    f64 sumDiff2 = 0.0;
+    f64 sumRel = 0.0;
+    f64 maxAbs = 0.0;
+    u64 count = 0;
+    u64 nonFinite = 0;
+};
+
+} // namespace
+
+// Slow path for rows with NaN/Inf (or sums that overflow f32): f64, per pixel
+static void ReduceRowChecked(const f32* test, const f32* reference, usize n, f64 eps, TileSums& sums) {
+    for (usize i = 0; i < n; ++i) {
+        const f64 t = test[i];
+        const f64 r = reference[i];
+        if (!std::isfinite(t) || !std::isfinite(r)) {
+            ++sums.nonFinite;
+            continue;
+        }
+        const f64 d = t - r;
+        sums.sumTest += t;
+        sums.sumReference += r;
+        sums.sumDiff += d;
+        sums.sumDiff2 += d * d;
+        sums.sumRel += d * d / (r * r + eps);
+        sums.maxAbs = std::max(sums.maxAbs, std::abs(d));
+        ++sums.count;
+    }
+}
+
+// Reduce one row span into sums. The lane arrays keep kLanes independent
+// partial sums, which the compiler maps onto one vector register each.
+static void ReduceRow(const f32* test, const f32* reference, usize n, f32 eps, TileSums& sums) {
+    f32 accTest[kLanes] = {};
+    f32 accReference[kLanes] = {};
+    f32 accDiff[kLanes] = {};
+    f32 accDiff2[kLanes] = {};
+    f32 accRel[kLanes] = {};
+    f32 accMax[kLanes] = {};
+
+    usize i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (usize l = 0; l < kLanes; ++l) {
+            const f32 t = test[i + l];
+            const f32 r = reference[i + l];
+            const f32 d = t - r;
+            accTest[l] += t;
+            accReference[l] += r;
+            accDiff[l] += d;
+            accDiff2[l] += d * d;
+            accRel[l] += d * d / (r * r + eps);
+            accMax[l] = std::max(accMax[l], std::abs(d));
+        }
+    }
+    for (; i < n; ++i) {
+        const f32 d = test[i] - reference[i];
+        accTest[0] += test[i];
+        accReference[0] += reference[i];
+        accDiff[0] += d;
+        accDiff2[0] += d * d;
+        accRel[0] += d * d / (reference[i] * reference[i] + eps);
+        accMax[0] = std::max(accMax[0], std::abs(d));
+    }
+
+    TileSums row;
+    for (usize l = 0; l < kLanes; ++l) {
+        row.sumTest += accTest[l];
+        row.sumReference += accReference[l];
+        row.sumDiff += accDiff[l];
+        row.sumDiff2 += accDiff2[l];
+        row.sumRel += accRel[l];
+        row.maxAbs = std::max(row.maxAbs, static_cast<f64>(accMax[l]));
+    }
+
+    // NaN/Inf anywhere poisons the sums (std::max may hide it, the sums do not)
+    if (!std::isfinite(row.sumTest + row.sumReference + row.sumDiff2 + row.sumRel)) {
+        ReduceRowChecked(test, reference, n, eps, sums);
+        return;
+    }
+
+    sums.sumTest += row.sumTest;
+    sums.sumReference += row.sumReference;
+    sums.sumDiff += row.sumDiff;
+    sums.sumDiff2 += row.sumDiff2;
+    sums.sumRel += row.sumRel;
+    sums.maxAbs = std::max(sums.maxAbs, row.maxAbs);
+    sums.count += n;
+}
+
+static void WriteErrorRow(const f32* test, const f32* reference, usize n, f32 eps, ErrorMapKind kind, f32* out) {
+    switch (kind) {
+        case ErrorMapKind::Difference:
+            for (usize i = 0; i < n; ++i) {
+                out[i] = test[i] - reference[i];
+            }
+            break;
+        case ErrorMapKind::Absolute:
+            for (usize i = 0; i < n; ++i) {
+                out[i] = std::abs(test[i] - reference[i]);
+            }
+            break;
+        case ErrorMapKind::RelMse:
+            for (usize i = 0; i < n; ++i) {
+                const f32 d = test[i] - reference[i];
+                out[i] = d * d / (reference[i] * reference[i] + eps);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Mean SSIM over the finite pixels of one band
+static f64 ComputeSsim(const f32* test, const f32* reference, u32 width, u32 height, bool parallel) {
+    // 11x11 window: radius ceil(3.33 * 1.5) = 5
+    static const PsfKernel window = PsfKernel::Gaussian(1.5f, 1.5f, 3.33f);
+    const usize pixels = static_cast<usize>(width) * height;
+
+    std::vector<u8> finite(pixels);
+    std::vector<f32> t(pixels), r(pixels);
+    f32 range = 0.0f;
+    for (usize p = 0; p < pixels; ++p) {
+        finite[p] = std::isfinite(test[p]) && std::isfinite(reference[p]);
+        t[p] = finite[p] ? test[p] : 0.0f;
+        r[p] = finite[p] ? reference[p] : 0.0f;
+        range = std::max(range, std::abs(r[p]));
+    }
+    if (range <= 0.0f) {
+        range = 1.0f;
+    }
+
+    // Local moments: blur(t), blur(r), blur(t^2), blur(r^2), blur(t r)
+    std::vector<f32> muT(pixels), muR(pixels), sTT(pixels), sRR(pixels), sTR(pixels);
+    std::vector<f32> product(pixels);
+    auto blur = [&](const f32* src, std::vector<f32>& dst) {
+        PsfConvolution::ConvolveBand(src, dst.data(), width, height, window, ConvolutionMethod::Auto, parallel);
+    };
+    auto blurProduct = [&](const std::vector<f32>& a, const std::vector<f32>& b, std::vector<f32>& dst) {
+        for (usize p = 0; p < pixels; ++p) {
+            product[p] = a[p] * b[p];
+        }
+        blur(product.data(), dst);
+    };
+    blur(t.data(), muT);
+    blur(r.data(), muR);
+    blurProduct(t, t, sTT);
+    blurProduct(r, r, sRR);
+    blurProduct(t, r, sTR);
+
+    const f64 c1 = (kSsimK1 * range) * (kSsimK1 * range);
+    const f64 c2 = (kSsimK2 * range) * (kSsimK2 * range);
+    f64 sum = 0.0;
+    u64 count = 0;
+    for (usize p = 0; p < pixels; ++p) {
+        if (!finite[p]) {
+            continue;
+        }
+        const f64 mt = muT[p];
+        const f64 mr = muR[p];
+        const f64 varT = std::max(0.0, sTT[p] - mt * mt);
+        const f64 varR = std::max(0.0, sRR[p] - mr * mr);
+        const f64 covar = sTR[p] - mt * mr;
+        sum += ((2.0 * mt * mr + c1) * (2.0 * covar + c2)) / ((mt * mt + mr * mr + c1) * (varT + varR + c2));
+        ++count;
+    }
+    return count > 0 ? sum / static_cast<f64>(count) : 1.0;
+}
+
+// Two-sided 95% Student-t quantile (Cornish-Fisher expansion, < 0.5% error
+// for dof >= 3); few tiles make the batch-means variance itself noisy
+static f64 StudentT95(f64 dof) {
+    const f64 z = kZ95;
+    const f64 z3 = z * z * z;
+    const f64 z5 = z3 * z * z;
+    return z + (z3 + z) / (4.0 * dof) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * dof * dof);
+}
+
+static bool IsCubePath(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == ".h5" || ext == ".hdf5";
+}
+
+static std::string WavelengthName(f32 wavelengthNm) {
+    return fmt::format("{:.1f}nm", wavelengthNm);
+}
+
+static bool SameWavelengths(const std::vector<f32>& a, const std::vector<f32>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (usize i = 0; i < a.size(); ++i) {
+        if (std::abs(a[i] - b[i]) > 1e-2f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char* ErrorMapName(ErrorMapKind kind) {
+    switch (kind) {
+        case ErrorMapKind::Difference: return "difference";
+        case ErrorMapKind::Absolute:   return "absolute";
+        case ErrorMapKind::RelMse:     return "relmse";
+        default:                       return "none";
+    }
+}
+
+// ============================================================================
+// ComparisonSettings / ComparisonResult
+// ============================================================================
+
+ErrorMapKind ComparisonSettings::ParseErrorMap(const std::string& name) {
+    if (name == "none") {
+        return ErrorMapKind::None;
+    }
+    if (name == "diff" || name == "difference") {
+        return ErrorMapKind::Difference;
+    }
+    if (name == "abs" || name == "absolute") {
+        return ErrorMapKind::Absolute;
+    }
+    if (name == "relmse") {
+        return ErrorMapKind::RelMse;
+    }
+    QL_LOG_WARN("ComparisonSettings: Unknown error map '{}' (expected diff, abs or relmse), using diff", name);
+    return ErrorMapKind::Difference;
+}
+
+BandMetrics ComparisonResult::Summary() const {
+    BandMetrics summary;
+    summary.name = "all";
+    if (bands.empty()) {
+        return summary;
+    }
+
+    f64 sumSsim = 0.0;
+    f64 ciSquared = 0.0;
+    for (const BandMetrics& band : bands) {
+        const f64 n = static_cast<f64>(band.pixelCount);
+        summary.pixelCount += band.pixelCount;
+        summary.nonFiniteCount += band.nonFiniteCount;
+        summary.meanTest += band.meanTest * n;
+        summary.meanReference += band.meanReference * n;
+        summary.bias += band.bias * n;
+        summary.rmse += band.rmse * band.rmse * n;
+        summary.relMse += band.relMse * n;
+        summary.maxAbsError = std::max(summary.maxAbsError, band.maxAbsError);
+        ciSquared += band.biasCi95 * band.biasCi95 * n * n;
+        sumSsim += band.ssim;
+    }
+
+    const f64 total = static_cast<f64>(std::max<u64>(summary.pixelCount, 1));
+    summary.meanTest /= total;
+    summary.meanReference /= total;
+    summary.bias /= total;
+    summary.biasCi95 = std::sqrt(ciSquared) / total;  // Bands treated as independent
+    summary.rmse = std::sqrt(summary.rmse / total);
+    summary.relMse /= total;
+    summary.ssim = sumSsim / static_cast<f64>(bands.size());
+    return summary;
+}
+
+// ============================================================================
+// Comparison::CompareBand
+// ============================================================================
+
+BandMetrics Comparison::CompareBand(const f32* test, const f32* reference, u32 width, u32 height,
+                                    const ComparisonSettings& settings, f32* errorMap, bool parallel) {
+    const u32 tileSize = std::max(settings.tileSize, 1u);
+    const u32 tilesX = (width + tileSize - 1) / tileSize;
+    const u32 tilesY = (height + tileSize - 1) / tileSize;
+    const usize tileCount = static_cast<usize>(tilesX) * tilesY;
+    const f32 eps = settings.relMseEpsilon;
+
+    std::vector<TileSums> tiles(tileCount);
+    auto processTile = [&](usize tile) {
+        const u32 x0 = static_cast<u32>(tile % tilesX) * tileSize;
+        const u32 y0 = static_cast<u32>(tile / tilesX) * tileSize;
+        const usize spanWidth = std::min(tileSize, width - x0);
+        const u32 y1 = std::min(height, y0 + tileSize);
+        for (u32 y = y0; y < y1; ++y) {
+            const usize offset = static_cast<usize>(y) * width + x0;
+            ReduceRow(test + offset, reference + offset, spanWidth, eps, tiles[tile]);
+            if (errorMap != nullptr) {
+                WriteErrorRow(test + offset, reference + offset, spanWidth, eps, settings.errorMap, errorMap + offset);
+            }
+        }
+    };
+    if (parallel) {
+        ParallelFor(tileCount, 1, processTile);
+    } else {
+        for (usize tile = 0; tile < tileCount; ++tile) {
+            processTile(tile);
+        }
+    }
+
+    TileSums total;
+    for (const TileSums& tile : tiles) {
+        total.sumTest += tile.sumTest;
+        total.sumReference += tile.sumReference;
+        total.sumDiff += tile.sumDiff;
+        total.sumDiff2 += tile.sumDiff2;
+        total.sumRel += tile.sumRel;
+        total.maxAbs = std::max(total.maxAbs, tile.maxAbs);
+        total.count += tile.count;
+        total.nonFinite += tile.nonFinite;
+    }
+
+    BandMetrics metrics;
+    metrics.pixelCount = total.count;
+    metrics.nonFiniteCount = total.nonFinite;
+    if (total.count == 0) {
+        return metrics;
+    }
+
+    const f64 n = static_cast<f64>(total.count);
+    metrics.meanTest = total.sumTest / n;
+    metrics.meanReference = total.sumReference / n;
+    metrics.bias = total.sumDiff / n;
+    metrics.rmse = std::sqrt(total.sumDiff2 / n);
+    metrics.relMse = total.sumRel / n;
+    metrics.maxAbsError = total.maxAbs;
+
+    // Batch means: the tiles are the batches, weighted by their pixel counts
+    // Var(bias) = K / (K - 1) * sum_k ((S_k - n_k * bias) / N)^2
+    u64 batches = 0;
+    f64 variance = 0.0;
+    for (const TileSums& tile : tiles) {
+        if (tile.count == 0) {
+            continue;
+        }
+        const f64 deviation = (tile.sumDiff - static_cast<f64>(tile.count) * metrics.bias) / n;
+        variance += deviation * deviation;
+        ++batches;
+    }
+    if (batches > 1) {
+        variance *= static_cast<f64>(batches) / static_cast<f64>(batches - 1);
+        metrics.biasCi95 = StudentT95(static_cast<f64>(batches - 1)) * std::sqrt(variance);
+    }
+
+    if (settings.computeSsim) {
+        metrics.ssim = ComputeSsim(test, reference, width, height, parallel);
+    }
+    return metrics;
+}
+
+// ============================================================================
+// Comparison::Compare (cube)
+// ============================================================================
+
+std::optional<ComparisonResult> Comparison::Compare(const SpectralCube& test, const SpectralCube& reference,
+                                                    const ComparisonSettings& settings, SpectralCube* errorMap) {
+    if (test.width != reference.width || test.height != reference.height || test.nbands != reference.nbands) {
+        QL_LOG_ERROR("Comparison::Compare: Cube sizes differ ({}x{}x{} vs {}x{}x{})",
+                     test.width, test.height, test.nbands, reference.width, reference.height, reference.nbands);
+        return std::nullopt;
+    }
+    if (!SameWavelengths(test.wavelengths, reference.wavelengths)) {
+        QL_LOG_ERROR("Comparison::Compare: Wavelength grids differ");
+        return std::nullopt;
+    }
+
+    const bool writeMap = errorMap != nullptr && settings.errorMap != ErrorMapKind::None;
+    if (writeMap) {
+        *errorMap = SpectralCube(test.width, test.height, test.nbands, test.lambda_min, test.lambda_max);
+        errorMap->wavelengths = test.wavelengths;
+        errorMap->metadata["error_map"] = ErrorMapName(settings.errorMap);
+    }
+
+    ComparisonResult result;
+    result.bands.resize(test.nbands);
+    ForEachBand(test.nbands, [&](u32 b, bool parallel) {
+        BandMetrics& metrics = result.bands[b];
+        metrics = CompareBand(test.BandPtr(b), reference.BandPtr(b), test.width, test.height, settings,
+                              writeMap ? errorMap->BandPtr(b) : nullptr, parallel);
+        metrics.wavelengthNm = test.wavelengths[b];
+        metrics.name = WavelengthName(metrics.wavelengthNm);
+    });
+    return result;
+}
+
+// ============================================================================
+// Comparison::Compare (image)
+// ============================================================================
+
+std::optional<ComparisonResult> Comparison::Compare(const Image& test, const Image& reference,
+                                                    const ComparisonSettings& settings, Image* errorMap) {
+    if (test.width != reference.width || test.height != reference.height) {
+        QL_LOG_ERROR("Comparison::Compare: Image sizes differ ({}x{} vs {}x{})",
+                     test.width, test.height, reference.width, reference.height);
+        return std::nullopt;
+    }
+
+    // Pair channels by name, falling back to position for unnamed images
+    std::vector<std::pair<u32, u32>> pairs;
+    for (u32 c = 0; c < test.channels && c < test.channelNames.size(); ++c) {
+        const std::string& name = test.channelNames[c];
+        if (name == "A" || AovBuffers::IsAovChannel(name)) {
+            continue;
+        }
+        auto it = std::find(reference.channelNames.begin(), reference.channelNames.end(), name);
+        if (it != reference.channelNames.end()) {
+            pairs.emplace_back(c, static_cast<u32>(it - reference.channelNames.begin()));
+        }
+    }
+    if (pairs.empty() && test.channels == reference.channels) {
+        for (u32 c = 0; c < test.channels; ++c) {
+            pairs.emplace_back(c, c);
+        }
+    }
+    if (pairs.empty()) {
+        QL_LOG_ERROR("Comparison::Compare: Images share no channels");
+        return std::nullopt;
+    }
+
+    const bool writeMap = errorMap != nullptr && settings.errorMap != ErrorMapKind::None;
+    if (writeMap) {
+        *errorMap = Image(test.width, test.height, static_cast<u32>(pairs.size()));
+        errorMap->metadata["error_map"] = ErrorMapName(settings.errorMap);
+    }
+
+    const usize pixels = test.PixelCount();
+    std::vector<f32> testPlane(pixels), referencePlane(pixels), mapPlane(writeMap ? pixels : 0);
+    ComparisonResult result;
+    for (usize i = 0; i < pairs.size(); ++i) {
+        const auto [testChannel, referenceChannel] = pairs[i];
+        for (usize p = 0; p < pixels; ++p) {
+            testPlane[p] = test.data[p * test.channels + testChannel];
+            referencePlane[p] = reference.data[p * reference.channels + referenceChannel];
+        }
+
+        BandMetrics metrics = CompareBand(testPlane.data(), referencePlane.data(), test.width, test.height,
+                                          settings, writeMap ? mapPlane.data() : nullptr);
+        metrics.name = (testChannel < test.channelNames.size()) ? test.channelNames[testChannel]
+                                                                : "Channel_" + std::to_string(testChannel);
+        result.bands.push_back(std::move(metrics));
+
+        if (writeMap) {
+            errorMap->channelNames[i] = result.bands.back().name;
+            for (usize p = 0; p < pixels; ++p) {
+                errorMap->data[p * pairs.size() + i] = mapPlane[p];
+            }
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// Comparison::CompareFiles
+// ============================================================================
+
+std::optional<ComparisonResult> Comparison::CompareFiles(const std::string& testPath,
+                                                         const std::string& referencePath,
+                                                         const ComparisonSettings& settings,
+                                                         const std::string& errorMapPath) {
+    ComparisonSettings effective = settings;
+    if (errorMapPath.empty()) {
+        effective.errorMap = ErrorMapKind::None;
+    } else if (effective.errorMap == ErrorMapKind::None) {
+        effective.errorMap = ErrorMapKind::Difference;
+    }
+    const bool writeMap = effective.errorMap != ErrorMapKind::None;
+
+    if (!IsCubePath(testPath)) {
+        std::optional<Image> test = ImageIO::ReadEXR(testPath);
+        std::optional<Image> reference = ImageIO::ReadEXR(referencePath);
+        if (!test.has_value() || !reference.has_value()) {
+            return std::nullopt;
+        }
+
+        Image errorMap;
+        std::optional<ComparisonResult> result = Compare(test.value(), reference.value(), effective,
+                                                         writeMap ? &errorMap : nullptr);
+        if (result.has_value()) {
+            result->label = testPath;
+            if (writeMap && !ImageIO::WriteEXR(errorMapPath, errorMap)) {
+                return std::nullopt;
+            }
+        }
+        return result;
+    }
+
+    // Cubes: stream chunkBands bands at a time
+    SpectralCubeReader testReader;
+    SpectralCubeReader referenceReader;
+    if (!testReader.Open(testPath) || !referenceReader.Open(referencePath)) {
+        return std::nullopt;
+    }
+    const SpectralCube& header = testReader.GetHeader();
+    const SpectralCube& referenceHeader = referenceReader.GetHeader();
+    if (header.width != referenceHeader.width || header.height != referenceHeader.height ||
+        header.nbands != referenceHeader.nbands) {
+        QL_LOG_ERROR("Comparison::CompareFiles: Cube sizes differ ({}x{}x{} vs {}x{}x{})",
+                     header.width, header.height, header.nbands,
+                     referenceHeader.width, referenceHeader.height, referenceHeader.nbands);
+        return std::nullopt;
+    }
+    if (!SameWavelengths(header.wavelengths, referenceHeader.wavelengths)) {
+        QL_LOG_ERROR("Comparison::CompareFiles: Wavelength grids of {} and {} differ", testPath, referencePath);
+        return std::nullopt;
+    }
+
+    SpectralCubeWriter mapWriter;
+    if (writeMap) {
+        if (!mapWriter.Open(errorMapPath, header)) {
+            return std::nullopt;
+        }
+        mapWriter.Metadata()["error_map"] = ErrorMapName(effective.errorMap);
+        mapWriter.Metadata()["test"] = testPath;
+        mapWriter.Metadata()["reference"] = referencePath;
+    }
+
+    const usize pixels = header.PixelsPerBand();
+    const u32 chunkBands = std::clamp(effective.chunkBands, 1u, header.nbands);
+    std::vector<f32> testChunk(pixels * chunkBands);
+    std::vector<f32> referenceChunk(pixels * chunkBands);
+    std::vector<f32> mapChunk(writeMap ? pixels * chunkBands : 0);
+
+    ComparisonResult result;
+    result.label = testPath;
+    result.bands.resize(header.nbands);
+    for (u32 first = 0; first < header.nbands; first += chunkBands) {
+        const u32 count = std::min(chunkBands, header.nbands - first);
+        if (!testReader.ReadBands(first, count, testChunk.data()) ||
+            !referenceReader.ReadBands(first, count, referenceChunk.data())) {
+            return std::nullopt;
+        }
+
+        ForEachBand(count, [&](u32 b, bool parallel) {
+            const usize offset = static_cast<usize>(b) * pixels;
+            BandMetrics& metrics = result.bands[first + b];
+            metrics = CompareBand(testChunk.data() + offset, referenceChunk.data() + offset,
+                                  header.width, header.height, effective,
+                                  writeMap ? mapChunk.data() + offset : nullptr, parallel);
+            metrics.wavelengthNm = header.wavelengths[first + b];
+            metrics.name = WavelengthName(metrics.wavelengthNm);
+        });
+
+        if (writeMap && !mapWriter.WriteBands(first, count, mapChunk.data())) {
+            return std::nullopt;
+        }
+    }
+
+    if (writeMap && !mapWriter.Close()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+// ============================================================================
+// Comparison::WriteCsv
+// ============================================================================
+
+bool Comparison::WriteCsv(const std::string& filepath, const std::vector<ComparisonResult>& results) {
+    std::ofstream file(filepath);
+    if (!file) {
+        QL_LOG_ERROR("Comparison::WriteCsv: Cannot open {}", filepath);
+        return false;
+    }
+
+    file << "label,band,wavelength_nm,pixels,non_finite,mean_test,mean_reference,"
+            "bias,bias_ci95,rmse,relmse,max_abs_error,ssim\n";
+    for (const ComparisonResult& result : results) {
+        for (const BandMetrics& band : result.bands) {
+            file << fmt::format("{},{},{},{},{},{:.9g},{:.9g},{:.9g},{:.9g},{:.9g},{:.9g},{:.9g},{:.9g}\n",
+                                result.label, band.name, band.wavelengthNm, band.pixelCount, band.nonFiniteCount,
+                                band.meanTest, band.meanReference, band.bias, band.biasCi95,
+                                band.rmse, band.relMse, band.maxAbsError, band.ssim);
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace quantiloom
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/Platform.hpp"
+#include "core/Image.hpp"
+#include "core/SpectralCube.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Comparison - Per-band error metrics against reference renders
+// ============================================================================
+// Validation gate for PBRT-v4 / Mitsuba 3 references. Per band (or image
+// channel), with d = test - reference:
+//   - bias       mean(d), with a 95% confidence interval from batch means
+//                over square tiles (tiles absorb the spatial correlation a
+//                PSF or denoiser introduces, which per-pixel variance misses)
+//   - rmse       sqrt(mean(d^2))
+//   - relMse     mean(d^2 / (reference^2 + eps))
+//   - ssim       Wang et al. 2004, 11x11 Gaussian window (sigma 1.5),
+//                dynamic range = the band's largest |reference|
+//   - maxAbs     max |d|
+// Pixels where either input is NaN/Inf are counted and excluded.
+//
+// Tiles run in parallel; each tile row is reduced with fixed-width lane
+// accumulators, so the inner loops vectorise without -ffast-math. Cubes
+// split bands across threads when there are enough of them. CompareFiles
+// streams HDF5 cubes a few bands at a time (SpectralCubeReader), so memory
+// stays bounded for full-spectrum cubes.
+//
+// Usage:
+//   ComparisonSettings settings;
+//   settings.errorMap = ErrorMapKind::Difference;
+//   auto result = Comparison::CompareFiles("ours.h5", "pbrt.h5", settings, "error.h5");
+//   if (result && result->Summary().relMse > 1e-3) { ... }
+// ============================================================================
+
+namespace quantiloom {
+
+enum class ErrorMapKind : u32 {
+    None = 0,
+    Difference = 1,  // test - reference
+    Absolute = 2,    // |test - reference|
+    RelMse = 3       // (test - reference)^2 / (reference^2 + eps), averages to relMse
+};
+
+struct QL_API ComparisonSettings {
+    f32 relMseEpsilon = 1e-2f;     // Keeps relMse finite where the reference is ~0
+    u32 tileSize = 32;             // Batch size (pixels per side) for the bias CI
+    bool computeSsim = true;       // SSIM costs ~5 blurs per band
+    ErrorMapKind errorMap = ErrorMapKind::None;
+    u32 chunkBands = 8;            // Bands per read when streaming HDF5 cubes
+
+    static ErrorMapKind ParseErrorMap(const std::string& name);
+};
+
+struct QL_API BandMetrics {
+    std::string name;              // Channel name or "<wavelength>nm"
+    f32 wavelengthNm = 0.0f;       // 0 for image channels
+    u64 pixelCount = 0;            // Finite pixels compared
+    u64 nonFiniteCount = 0;        // Pixels skipped (NaN/Inf in either input)
+    f64 meanTest = 0.0;
+    f64 meanReference = 0.0;
+    f64 bias = 0.0;
+    f64 biasCi95 = 0.0;            // Half-width of the 95% interval
+    f64 rmse = 0.0;
+    f64 relMse = 0.0;
+    f64 maxAbsError = 0.0;
+    f64 ssim = 1.0;                // 1 when SSIM is disabled
+};
+
+struct QL_API ComparisonResult {
+    std::string label;             // e.g. the test file path
+    std::vector<BandMetrics> bands;
+
+    // Pixel-weighted pooling over all bands (ssim averaged, maxAbs is the max)
+    BandMetrics Summary() const;
+};
+
+class QL_API Comparison {
+public:
+    // Compare one band; errorMap (optional) receives width * height values
+    static BandMetrics CompareBand(const f32* test, const f32* reference, u32 width, u32 height,
+                                   const ComparisonSettings& settings, f32* errorMap = nullptr,
+                                   bool parallel = true);
+
+    // Compare two cubes on the same wavelength grid
+    static std::optional<ComparisonResult> Compare(const SpectralCube& test, const SpectralCube& reference,
+                                                   const ComparisonSettings& settings = {},
+                                                   SpectralCube* errorMap = nullptr);
+
+    // Compare the channels two images share by name (alpha and AOVs skipped);
+    // unnamed images with equal channel counts are compared positionally
+    static std::optional<ComparisonResult> Compare(const Image& test, const Image& reference,
+                                                   const ComparisonSettings& settings = {},
+                                                   Image* errorMap = nullptr);
+
+    // Compare two files: .h5/.hdf5 cubes are streamed, anything else is read
+    // as EXR. The error map (if requested) is written to errorMapPath.
+    static std::optional<ComparisonResult> CompareFiles(const std::string& testPath,
+                                                        const std::string& referencePath,
+                                                        const ComparisonSettings& settings = {},
+                                                        const std::string& errorMapPath = "");
+
+    // One row per band of every result, prefixed by its label
+    static bool WriteCsv(const std::string& filepath, const std::vector<ComparisonResult>& results);
+};
+
+} // namespace quantiloom
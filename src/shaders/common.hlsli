@@ -16,12 +16,34 @@
 // Ray Payload
 // ============================================================================
 // Carries radiance information through the ray tracing pipeline
+//
+// RAY CONES:
+// - coneSpread is the cone's spread angle (radians, one pixel for primary rays)
+// - Cone width at a hit = coneSpread * hit distance; used for texture LOD
+//
+// AOVs (first hit, denoiser guides): albedo at λ, shading normal (world
+// space) and hit distance. Misses leave them zero.
 // ============================================================================
 
 struct Payload {
-    float3 radiance;  // Accumulated radiance (W·sr⁻¹·m⁻²)
+    float3 radiance;    // Accumulated radiance (W·sr⁻¹·m⁻²)
+    float  coneSpread;  // Ray cone spread angle (radians)
+    float3 normal;      // AOV: shading normal (zero on miss)
+    float  albedo;      // AOV: reflectance at λ
+    float  depth;       // AOV: hit distance (zero on miss)
 };
 
+// Octahedral normal encoding (unit vector -> [-1, 1]^2), decoded on the CPU
+// by AovBuffers::Unpack
+float2 OctahedralEncode(float3 n) {
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    if (n.z < 0.0) {
+        float2 signs = float2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signs;
+    }
+    return n.xy;
+}
+
 // ============================================================================
 // LUT Data Structure
 // ============================================================================
@@ -37,9 +59,9 @@ struct LUTData {
     float3 sunDirection;        // Normalized sun direction vector (FROM surface TO sun)
     float  sunRadiance_spectral; // Sun spectral radiance at current λ
     float  skyRadiance_spectral; // Sky spectral radiance at current λ
-    float  _pad0;
-    float  _pad1;
-    float  _pad2;
+    float  wavelength_nm;        // Current wavelength (nm), for RGB-to-spectrum uplifting
+    uint   spectralBand;         // Column of the measured material table (binding 9)
+    uint   spectralBandCount;    // Columns per material row in binding 9
 };
 
 // ============================================================================
@@ -58,8 +80,24 @@ struct CameraData {
     float  wavelength_nm;  // Current wavelength (nanometers) for spectral rendering
     float3 up;             // Up vector (normalized)
     float  _pad1;
+
+    // Dispatch region and samples (see CameraData in Camera.hpp)
+    uint   tileOffsetX;    // First pixel of the launch in the image
+    uint   tileOffsetY;
+    uint   imageWidth;     // Full image size (0 = launch size)
+    uint   imageHeight;
+    uint   sampleStart;    // First sample index of this dispatch
+    uint   sampleCount;    // Samples averaged per pixel (0 = 1)
+    uint   seedLo;         // Philox key
+    uint   seedHi;
 };
 
+// ============================================================================
+// Counter-based RNG (Philox4x32-10, see philox.hlsli)
+// ============================================================================
+
+#include "philox.hlsli"
+
 // ============================================================================
 // Material Data Structure (PBR)
 // ============================================================================
@@ -94,7 +132,24 @@ struct MaterialData {
 
     // Spectral mode (M1 compatibility)
     float  spectralAlbedo;           // Scalar reflectance at current λ [0, 1]
-    float  _pad0;                    // Padding to 16-byte alignment
+
+    // Sampler indices into samplers[] (shared between textures, -1 = no texture)
+    int    baseColorSamplerIndex;
+    int    metallicRoughnessSamplerIndex;
+    int    normalSamplerIndex;
+    int    emissiveSamplerIndex;
+
+    // Measured spectrum row in binding 9 (-1 = uplift the base colour)
+    int    spectralMaterialIndex;
+
+    // Thermal emission (temperature 0 and no map = not emitting)
+    float  temperatureK;             // Uniform surface temperature (K)
+    int    temperatureTextureIndex;  // Per-texel temperature map (R), -1 = uniform
+    int    temperatureSamplerIndex;
+    float  temperatureMinK;          // Temperature of map value 0
+    float  temperatureMaxK;          // Temperature of map value 1
+
+    float  _pad0;                    // Padding to 16-byte alignment (112 bytes)
 };
 
 #endif // QUANTILOOM_COMMON_HLSLI
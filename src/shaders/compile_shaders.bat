@@ -26,7 +26,7 @@ echo DXC found
 echo.
 
 REM Compilation flags
-set FLAGS=-spirv -T lib_6_3 -fspv-target-env="vulkan1.3"
+set FLAGS=-spirv -T lib_6_3 -fspv-target-env="vulkan1.3" -fvk-use-scalar-layout
 
 REM Compile raygen shader
 echo [1/3] Compiling raygen.rgen...
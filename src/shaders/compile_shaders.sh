@@ -28,7 +28,7 @@ echo "DXC found: $(command -v dxc)"
 echo ""
 
 # Compilation flags
-FLAGS="-spirv -T lib_6_3 -fspv-target-env=vulkan1.3"
+FLAGS="-spirv -T lib_6_3 -fspv-target-env=vulkan1.3 -fvk-use-scalar-layout"
 
 # Compile raygen shader
 echo "[1/3] Compiling raygen.rgen..."
@@ -0,0 +1,60 @@
+// ============================================================================
+// Quantiloom - Counter-based RNG (Philox4x32-10)
+// ============================================================================
+// Stateless: the value for (pixel, sample) depends only on those indices and
+// the seed, so renders split into tiles or sample ranges are reproducible.
+// Must produce the same bits as core/CounterRng.hpp (Philox4x32::Generate).
+//
+// Written in the subset of HLSL that is also valid C++, so the unit tests
+// compile this file directly (tests/test_core/HlslShim.hpp provides uint,
+// uint2, uint4 and QL_OUT) and check it against the Random123 known-answer
+// vectors and the CPU implementation.
+// ============================================================================
+
+#ifndef QUANTILOOM_PHILOX_HLSLI
+#define QUANTILOOM_PHILOX_HLSLI
+
+#ifndef QL_OUT
+#define QL_OUT(T) out T
+#endif
+
+// 32 x 32 -> 64-bit product as (hi, lo) without 64-bit integer support
+void MulWide(uint a, uint b, QL_OUT(uint) hi, QL_OUT(uint) lo) {
+    uint p0 = (a & 0xFFFFu) * (b & 0xFFFFu);
+    uint p1 = (a & 0xFFFFu) * (b >> 16);
+    uint p2 = (a >> 16) * (b & 0xFFFFu);
+    uint p3 = (a >> 16) * (b >> 16);
+    uint mid = (p0 >> 16) + (p1 & 0xFFFFu) + (p2 & 0xFFFFu);
+    lo = (mid << 16) | (p0 & 0xFFFFu);
+    hi = p3 + (p1 >> 16) + (p2 >> 16) + (mid >> 16);
+}
+
+uint4 Philox4x32(uint4 counter, uint2 key) {
+    for (uint round = 0; round < 10; ++round) {
+        uint hi0, lo0, hi1, lo1;
+        MulWide(0xD2511F53u, counter.x, hi0, lo0);
+        MulWide(0xCD9E8D57u, counter.z, hi1, lo1);
+        counter = uint4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+        key += uint2(0x9E3779B9u, 0xBB67AE85u);
+    }
+    return counter;
+}
+
+// 23 random bits -> uniform in (0, 1), as Philox4x32::ToUniform
+float PhiloxToUniform(uint bits) {
+    return (float(bits >> 9) + 0.5f) * (1.0f / 8388608.0f);
+}
+
+// Sub-pixel position of a pixel's sample: sample 0 at the pixel centre,
+// later samples jittered. A function of pixel, sample index and seed only,
+// so a shard rendering samples [sampleStart, ...) takes exactly those
+// samples of the full render.
+float2 SampleJitter(uint pixelIndex, uint sampleIndex, uint2 key) {
+    if (sampleIndex == 0) {
+        return float2(0.5f, 0.5f);
+    }
+    uint4 bits = Philox4x32(uint4(pixelIndex, sampleIndex, 0, 0), key);
+    return float2(PhiloxToUniform(bits.x), PhiloxToUniform(bits.y));
+}
+
+#endif // QUANTILOOM_PHILOX_HLSLI
@@ -0,0 +1,18 @@
+// ============================================================================
+// Shared main() of the unit test executables
+// ============================================================================
+// The library logs through Log, which must be initialised before use.
+// Warnings and errors stay visible, since they explain failing tests.
+// ============================================================================
+
+#include "core/Log.hpp"
+
+#include <gtest/gtest.h>
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    quantiloom::Log::Init(nullptr, quantiloom::Log::Level::Warn);
+    const int result = RUN_ALL_TESTS();
+    quantiloom::Log::Shutdown();
+    return result;
+}
@@ -0,0 +1,187 @@
+// ============================================================================
+// BandStatistics tests: moments against a direct f64 evaluation, percentile
+// error of the quantile sketch against sorted data, merging and NaN handling
+// ============================================================================
+
+#include "core/BandStatistics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+// Half a bucket of 2^MANTISSA_BITS buckets per octave, relative
+constexpr f64 kSketchRelativeError = 1.0 / f64(1u << (QuantileSketch::MANTISSA_BITS + 1));
+
+// Denormal buckets are 2^-133 wide
+const f64 kDenormalError = std::ldexp(1.0, -133);
+
+const f64 kPercentiles[] = {0.0, 0.1, 1.0, 5.0, 10.0, 25.0, 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 100.0};
+
+std::vector<f32> LogNormal(usize count, u32 seed) {
+    std::mt19937 rng(seed);
+    std::lognormal_distribution<f32> dist(0.0f, 3.0f);
+    std::vector<f32> values(count);
+    for (f32& v : values) {
+        v = dist(rng);
+    }
+    return values;
+}
+
+// Both signs, a spike of exact zeros and repeated values
+std::vector<f32> Mixed(usize count, u32 seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<f32> dist(-2.0f, 50.0f);
+    std::vector<f32> values(count);
+    for (usize i = 0; i < count; ++i) {
+        values[i] = (i % 7 == 0) ? 0.0f : (i % 11 == 0) ? 3.25f : dist(rng);
+    }
+    return values;
+}
+
+// Value with rank floor(q * (n - 1)) in ascending order
+f64 ExactPercentile(std::vector<f32> values, f64 p) {
+    std::sort(values.begin(), values.end());
+    const usize rank = static_cast<usize>(p / 100.0 * static_cast<f64>(values.size() - 1));
+    return values[rank];
+}
+
+void ExpectPercentiles(const BandStatistics& stats, const std::vector<f32>& values) {
+    for (f64 p : kPercentiles) {
+        SCOPED_TRACE(::testing::Message() << "p" << p);
+        const f64 exact = ExactPercentile(values, p);
+        const f64 bound = std::abs(exact) >= std::numeric_limits<f32>::min() ? kSketchRelativeError * std::abs(exact)
+                                                                             : kDenormalError;
+        EXPECT_LE(std::abs(stats.Percentile(p) - exact), bound);
+    }
+}
+
+} // namespace
+
+TEST(BandStatisticsTest, MomentsMatchDirectEvaluation) {
+    // Sizes with partial lanes and partial blocks
+    for (usize count : {usize(1), usize(7), usize(1024), usize(1031), usize(5000)}) {
+        SCOPED_TRACE(count);
+        const std::vector<f32> values = Mixed(count, 11);
+
+        f64 sum = 0.0;
+        for (f32 v : values) {
+            sum += v;
+        }
+        const f64 mean = sum / static_cast<f64>(count);
+        f64 m2 = 0.0;
+        for (f32 v : values) {
+            m2 += (v - mean) * (v - mean);
+        }
+
+        const BandStatistics stats = BandStatistics::Compute(values.data(), count, false);
+        EXPECT_EQ(stats.count, count);
+        EXPECT_EQ(stats.nonFiniteCount, 0u);
+        EXPECT_EQ(stats.min, *std::min_element(values.begin(), values.end()));
+        EXPECT_EQ(stats.max, *std::max_element(values.begin(), values.end()));
+        EXPECT_NEAR(stats.mean, mean, 1e-5 * 50.0);
+        EXPECT_NEAR(stats.m2, m2, 1e-5 * m2 + 1e-12);
+        if (count > 1) {
+            EXPECT_NEAR(stats.Variance(), m2 / static_cast<f64>(count - 1), 1e-5 * m2);
+        }
+    }
+}
+
+TEST(BandStatisticsTest, PercentilesWithinSketchError) {
+    const std::vector<f32> logNormal = LogNormal(20000, 3);
+    ExpectPercentiles(BandStatistics::Compute(logNormal.data(), logNormal.size(), false), logNormal);
+
+    const std::vector<f32> mixed = Mixed(20000, 5);
+    ExpectPercentiles(BandStatistics::Compute(mixed.data(), mixed.size(), false), mixed);
+
+    // Denormals and values spanning the whole f32 range, including the top
+    // bucket (which ends at FLT_MAX) inside the percentiles
+    const f32 top = std::numeric_limits<f32>::max();
+    std::vector<f32> extreme = {std::numeric_limits<f32>::denorm_min(), 1e-40f, 1e-30f, 1.0f, 1e20f,
+                                top, top, -top, -top, -1e-38f};
+    ExpectPercentiles(BandStatistics::Compute(extreme.data(), extreme.size(), false), extreme);
+}
+
+TEST(BandStatisticsTest, EndPercentilesAreExact) {
+    const std::vector<f32> values = LogNormal(3000, 7);
+    const BandStatistics stats = BandStatistics::Compute(values.data(), values.size(), false);
+    EXPECT_EQ(stats.Percentile(0.0), stats.min);
+    EXPECT_EQ(stats.Percentile(100.0), stats.max);
+}
+
+TEST(BandStatisticsTest, MergeIsOrderIndependent) {
+    const std::vector<f32> values = Mixed(9000, 13);
+    const BandStatistics whole = BandStatistics::Compute(values.data(), values.size(), false);
+
+    // Uneven shards merged in reverse order
+    const usize cuts[] = {0, 1, 1500, 1501, 4097, 9000};
+    BandStatistics merged;
+    for (usize s = std::size(cuts) - 1; s-- > 0;) {
+        BandStatistics shard;
+        shard.Accumulate(values.data() + cuts[s], cuts[s + 1] - cuts[s]);
+        merged.Merge(shard);
+    }
+
+    EXPECT_EQ(merged.count, whole.count);
+    EXPECT_EQ(merged.min, whole.min);
+    EXPECT_EQ(merged.max, whole.max);
+    // Shard boundaries move the f32 blocks, so moments agree to f32 precision
+    EXPECT_NEAR(merged.mean, whole.mean, 1e-6 * 50.0);
+    EXPECT_NEAR(merged.m2, whole.m2, 1e-6 * whole.m2);
+    for (f64 p : kPercentiles) {
+        EXPECT_EQ(merged.Percentile(p), whole.Percentile(p)) << "p" << p;
+    }
+}
+
+TEST(BandStatisticsTest, ParallelMatchesSerial) {
+    const std::vector<f32> values = LogNormal(300000, 17);
+    const BandStatistics serial = BandStatistics::Compute(values.data(), values.size(), false);
+    const BandStatistics parallel = BandStatistics::Compute(values.data(), values.size(), true);
+
+    EXPECT_EQ(parallel.count, serial.count);
+    EXPECT_EQ(parallel.min, serial.min);
+    EXPECT_EQ(parallel.max, serial.max);
+    EXPECT_NEAR(parallel.mean, serial.mean, 1e-9 * std::abs(serial.mean));
+    EXPECT_NEAR(parallel.m2, serial.m2, 1e-9 * serial.m2);
+    for (f64 p : kPercentiles) {
+        EXPECT_EQ(parallel.Percentile(p), serial.Percentile(p)) << "p" << p;
+    }
+    ExpectPercentiles(parallel, values);
+}
+
+TEST(BandStatisticsTest, ExcludesNonFiniteValues) {
+    std::vector<f32> values = Mixed(2000, 19);
+    std::vector<f32> finite = values;
+    const f32 nan = std::numeric_limits<f32>::quiet_NaN();
+    const f32 inf = std::numeric_limits<f32>::infinity();
+    values.insert(values.begin() + 10, nan);
+    values.insert(values.begin() + 1500, inf);
+    values.push_back(-inf);
+
+    const BandStatistics stats = BandStatistics::Compute(values.data(), values.size(), false);
+    const BandStatistics reference = BandStatistics::Compute(finite.data(), finite.size(), false);
+    EXPECT_EQ(stats.count, reference.count);
+    EXPECT_EQ(stats.nonFiniteCount, 3u);
+    EXPECT_EQ(stats.min, reference.min);
+    EXPECT_EQ(stats.max, reference.max);
+    EXPECT_NEAR(stats.mean, reference.mean, 1e-6 * std::abs(reference.mean) + 1e-9);
+    EXPECT_NEAR(stats.m2, reference.m2, 1e-6 * reference.m2);
+    for (f64 p : kPercentiles) {
+        EXPECT_EQ(stats.Percentile(p), reference.Percentile(p)) << "p" << p;
+    }
+}
+
+TEST(BandStatisticsTest, EmptyStatistics) {
+    const BandStatistics stats = BandStatistics::Compute(nullptr, 0, false);
+    EXPECT_EQ(stats.count, 0u);
+    EXPECT_EQ(stats.Variance(), 0.0);
+    EXPECT_EQ(stats.Percentile(50.0), 0.0);
+    EXPECT_EQ(QuantileSketch().Quantile(0.5), 0.0);
+}
@@ -0,0 +1,34 @@
+// ============================================================================
+// Config tests: typed access to TOML values
+// ============================================================================
+
+#include "core/Config.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace quantiloom;
+
+TEST(ConfigTest, ReadsSixtyFourBitIntegers) {
+    const Config config = Config::FromTable(toml::parse(R"(
+        [renderer]
+        seed = 0x123456789ABCDEF0
+        negative = -1
+        small = 7
+    )"));
+
+    // u64 keeps the high word (the renderer splits it into seedLo / seedHi)
+    EXPECT_EQ(config.Get<u64>("renderer.seed", 0), 0x123456789ABCDEF0ull);
+    EXPECT_EQ(config.Get<i64>("renderer.seed", 0), 0x123456789ABCDEF0ll);
+    EXPECT_EQ(config.Get<u64>("renderer.small", 0), 7u);
+    EXPECT_EQ(config.Get<u64>("renderer.missing", 99), 99u);
+
+    // TOML integers are signed: -1 is the all-ones u64
+    EXPECT_EQ(config.Get<u64>("renderer.negative", 0), ~0ull);
+    EXPECT_EQ(config.Get<i64>("renderer.negative", 0), -1);
+
+    auto required = config.GetRequired<u64>("renderer.seed");
+    ASSERT_TRUE(required.has_value());
+    EXPECT_EQ(required.value(), 0x123456789ABCDEF0ull);
+    EXPECT_FALSE(config.GetRequired<u64>("renderer.missing").has_value());
+    EXPECT_FALSE(config.GetRequired<bool>("renderer.seed").has_value());
+}
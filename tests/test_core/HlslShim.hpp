@@ -0,0 +1,49 @@
+#pragma once
+
+// ============================================================================
+// HlslShim - Just enough HLSL vocabulary to compile shared shader code as C++
+// ============================================================================
+// Used by tests that check shader helpers (e.g. philox.hlsli) against their
+// CPU counterparts. Include inside the same namespace as the .hlsli so its
+// functions do not collide with the library's (no standard headers here,
+// so that is safe).
+//
+// Usage:
+//   namespace hlsl {
+//   #include "HlslShim.hpp"
+//   #include "philox.hlsli"
+//   }
+// ============================================================================
+
+#define QL_OUT(T) T&
+
+using uint = unsigned int;  // 32-bit on every supported platform
+
+struct uint2 {
+    uint x = 0;
+    uint y = 0;
+
+    uint2(uint x_, uint y_) : x(x_), y(y_) {}
+
+    uint2& operator+=(const uint2& o) {
+        x += o.x;
+        y += o.y;
+        return *this;
+    }
+};
+
+struct uint4 {
+    uint x = 0;
+    uint y = 0;
+    uint z = 0;
+    uint w = 0;
+
+    uint4(uint x_, uint y_, uint z_, uint w_) : x(x_), y(y_), z(z_), w(w_) {}
+};
+
+struct float2 {
+    float x = 0.0f;
+    float y = 0.0f;
+
+    float2(float x_, float y_) : x(x_), y(y_) {}
+};
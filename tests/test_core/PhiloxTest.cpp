@@ -0,0 +1,131 @@
+// ============================================================================
+// Philox4x32-10 tests: CPU (core/CounterRng.hpp) and shader (philox.hlsli),
+// and the shader's per-sample jitter
+// ============================================================================
+// Both implementations are checked against the Random123 known-answer vectors
+// (kat_vectors, philox4x32_10) and against each other, so they cannot drift.
+// ============================================================================
+
+#include "core/CounterRng.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace hlsl {
+#include "HlslShim.hpp"
+#include "philox.hlsli"
+} // namespace hlsl
+
+using namespace quantiloom;
+
+namespace {
+
+struct KnownAnswer {
+    Philox4x32::Counter counter;
+    Philox4x32::Key key;
+    Philox4x32::Counter expected;
+};
+
+constexpr KnownAnswer kKnownAnswers[] = {
+    {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+     {0x00000000, 0x00000000},
+     {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+    {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+     {0xffffffff, 0xffffffff},
+     {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+    {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+     {0xa4093822, 0x299f31d0},
+     {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+};
+
+Philox4x32::Counter Shader(const Philox4x32::Counter& counter, const Philox4x32::Key& key) {
+    const hlsl::uint4 bits = hlsl::Philox4x32(hlsl::uint4(counter[0], counter[1], counter[2], counter[3]),
+                                              hlsl::uint2(key[0], key[1]));
+    return {bits.x, bits.y, bits.z, bits.w};
+}
+
+} // namespace
+
+// Generate is constexpr: the first vector also holds at compile time
+static_assert(Philox4x32::Generate(kKnownAnswers[0].counter, kKnownAnswers[0].key) == kKnownAnswers[0].expected);
+
+TEST(PhiloxTest, CpuMatchesKnownAnswers) {
+    for (const KnownAnswer& kat : kKnownAnswers) {
+        EXPECT_EQ(Philox4x32::Generate(kat.counter, kat.key), kat.expected);
+    }
+}
+
+TEST(PhiloxTest, ShaderMatchesKnownAnswers) {
+    for (const KnownAnswer& kat : kKnownAnswers) {
+        EXPECT_EQ(Shader(kat.counter, kat.key), kat.expected);
+    }
+}
+
+TEST(PhiloxTest, ShaderMatchesCpu) {
+    // Counters and keys as raygen uses them: (pixel, sample, 0, 0), seed split
+    for (u32 seed : {0u, 1u, 0xDEADBEEFu}) {
+        const Philox4x32::Key key = {seed, ~seed};
+        for (u32 pixel = 0; pixel < 64; ++pixel) {
+            for (u32 sample = 0; sample < 16; ++sample) {
+                const Philox4x32::Counter counter = {pixel * 7919u, sample, 0, 0};
+                const Philox4x32::Counter cpu = Philox4x32::Generate(counter, key);
+                ASSERT_EQ(Shader(counter, key), cpu) << "pixel " << pixel << " sample " << sample;
+                for (u32 bits : cpu) {
+                    ASSERT_EQ(hlsl::PhiloxToUniform(bits), Philox4x32::ToUniform(bits));
+                }
+            }
+        }
+    }
+}
+
+TEST(PhiloxTest, UniformStaysInOpenInterval) {
+    EXPECT_GT(Philox4x32::ToUniform(0u), 0.0f);
+    EXPECT_LT(Philox4x32::ToUniform(0xFFFFFFFFu), 1.0f);
+    EXPECT_GT(hlsl::PhiloxToUniform(0u), 0.0f);
+    EXPECT_LT(hlsl::PhiloxToUniform(0xFFFFFFFFu), 1.0f);
+}
+
+// ============================================================================
+// SampleJitter (raygen sub-pixel positions)
+// ============================================================================
+
+TEST(SampleJitterTest, SampleZeroIsPixelCentre) {
+    const hlsl::float2 jitter = hlsl::SampleJitter(123, 0, hlsl::uint2(7, 9));
+    EXPECT_EQ(jitter.x, 0.5f);
+    EXPECT_EQ(jitter.y, 0.5f);
+}
+
+TEST(SampleJitterTest, ShardsWithDifferentSampleStartTakeDifferentSamples) {
+    // Two shards of the same pixel: samples [0, 8) and [8, 16). Each must
+    // take the full render's samples of its range, so their positions differ
+    // (a shard ignoring sampleStart would repeat the first shard's samples).
+    const hlsl::uint2 key(0x89ABCDEFu, 0x01234567u);
+    for (u32 pixel : {0u, 1u, 4095u}) {
+        std::vector<std::pair<f32, f32>> first;
+        std::vector<std::pair<f32, f32>> second;
+        for (u32 i = 0; i < 8; ++i) {
+            const hlsl::float2 a = hlsl::SampleJitter(pixel, 0 + i, key);
+            const hlsl::float2 b = hlsl::SampleJitter(pixel, 8 + i, key);
+            first.emplace_back(a.x, a.y);
+            second.emplace_back(b.x, b.y);
+        }
+        for (const auto& sample : second) {
+            EXPECT_EQ(std::count(first.begin(), first.end(), sample), 0) << "pixel " << pixel;
+        }
+        for (const auto& [x, y] : first) {
+            EXPECT_TRUE(x > 0.0f && x < 1.0f && y > 0.0f && y < 1.0f);
+        }
+    }
+}
+
+TEST(SampleJitterTest, DependsOnBothSeedWords) {
+    // renderer.seed is 64-bit: the high word (seedHi) changes the samples too
+    const hlsl::float2 base = hlsl::SampleJitter(5, 3, hlsl::uint2(42, 0));
+    const hlsl::float2 high = hlsl::SampleJitter(5, 3, hlsl::uint2(42, 1));
+    const hlsl::float2 low = hlsl::SampleJitter(5, 3, hlsl::uint2(43, 0));
+    EXPECT_TRUE(base.x != high.x || base.y != high.y);
+    EXPECT_TRUE(base.x != low.x || base.y != low.y);
+}
@@ -0,0 +1,239 @@
+// ============================================================================
+// PixelFormat tests: f16 and u16 conversion against exact reference values
+// ============================================================================
+// The f16 reference rounds in f64 (where every step is exact), so it checks
+// round to nearest even independently of the bit tricks in FloatToHalf. The
+// bulk kernels (F16C when the CPU has it) must agree with the scalar path.
+// ============================================================================
+
+#include "core/PixelFormat.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+// Exact value of a half (NaN for NaN encodings)
+f64 ReferenceHalfValue(u16 bits) {
+    const f64 sign = (bits & 0x8000u) ? -1.0 : 1.0;
+    const i32 exponent = (bits >> 10) & 0x1F;
+    const i32 mantissa = bits & 0x3FF;
+    if (exponent == 31) {
+        return mantissa == 0 ? sign * std::numeric_limits<f64>::infinity() : std::numeric_limits<f64>::quiet_NaN();
+    }
+    if (exponent == 0) {
+        return sign * std::ldexp(mantissa, -24);
+    }
+    return sign * std::ldexp(1024 + mantissa, exponent - 25);
+}
+
+// Round a finite f32 to the nearest half, ties to even
+u16 ReferenceFloatToHalf(f32 value) {
+    const u16 sign = std::signbit(value) ? 0x8000u : 0u;
+    const f64 magnitude = std::abs(static_cast<f64>(value));
+    if (magnitude == 0.0) {
+        return sign;
+    }
+
+    // Spacing of halves around the value (denormals share 2^-24)
+    i32 exponent = 0;
+    std::frexp(magnitude, &exponent);
+    exponent = std::max(exponent - 1, -14);
+    const f64 steps = std::nearbyint(std::ldexp(magnitude, 10 - exponent));   // Ties to even
+
+    // Normals have steps in [1024, 2048]; 2048 carries into the exponent
+    const u32 bits = exponent == -14 && steps < 1024.0
+                         ? static_cast<u32>(steps)
+                         : (static_cast<u32>(exponent + 15) << 10) + static_cast<u32>(steps) - 1024u;
+    return static_cast<u16>(std::min(bits, 0x7C00u) | sign);
+}
+
+bool IsHalfNan(u16 bits) {
+    return (bits & 0x7C00u) == 0x7C00u && (bits & 0x3FFu) != 0;
+}
+
+// Every rounding boundary: each half midpoint and the floats on either side
+std::vector<f32> BoundaryValues() {
+    std::vector<f32> values;
+    for (u32 bits = 0; bits < 0x7C00u; ++bits) {
+        // Above 65504 the next step would be 65536 (the midpoint to Inf is 65520)
+        const f64 next = bits + 1 == 0x7C00u ? 65536.0 : ReferenceHalfValue(static_cast<u16>(bits + 1));
+        const f32 mid = static_cast<f32>(0.5 * (ReferenceHalfValue(static_cast<u16>(bits)) + next));
+        for (f32 v : {mid, std::nextafter(mid, 0.0f), std::nextafter(mid, 1e9f)}) {
+            values.push_back(v);
+            values.push_back(-v);
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(PixelFormatTest, KnownHalfValues) {
+    struct Case { f32 value; u16 bits; };
+    const Case cases[] = {
+        {0.0f, 0x0000}, {-0.0f, 0x8000}, {1.0f, 0x3C00}, {-2.0f, 0xC000}, {0.5f, 0x3800},
+        {0.1f, 0x2E66}, {1.0f / 3.0f, 0x3555}, {3.14159265f, 0x4248},
+        {65504.0f, 0x7BFF},                           // Largest half
+        {65519.99f, 0x7BFF}, {65520.0f, 0x7C00},      // Below / at the rounding midpoint to Inf
+        {1e6f, 0x7C00}, {-1e6f, 0xFC00},
+        {6.103515625e-5f, 0x0400},                    // Smallest normal 2^-14
+        {6.097555160522461e-5f, 0x03FF},              // Largest denormal
+        {5.960464477539063e-8f, 0x0001},              // Smallest denormal 2^-24
+        {2.9802322387695312e-8f, 0x0000},             // 2^-25: tie rounds to even (0)
+        {4.470348358154297e-8f, 0x0001},              // 1.5 * 2^-25
+        {1.7881393432617188e-7f, 0x0003},             // 3 * 2^-24
+        {1.0f + 1.0f / 2048.0f, 0x3C00},              // Tie rounds down to even
+        {1.0f + 3.0f / 2048.0f, 0x3C02},              // Tie rounds up to even
+        {2048.0f + 1.0f, 0x6800},                     // Half spacing is 2 here
+        {std::numeric_limits<f32>::infinity(), 0x7C00},
+        {-std::numeric_limits<f32>::infinity(), 0xFC00},
+        {std::numeric_limits<f32>::denorm_min(), 0x0000},
+    };
+    for (const Case& c : cases) {
+        EXPECT_EQ(FloatToHalf(c.value).bits, c.bits) << c.value;
+        if (std::isfinite(c.value)) {
+            EXPECT_EQ(ReferenceFloatToHalf(c.value), c.bits) << c.value;
+        }
+    }
+
+    EXPECT_TRUE(IsHalfNan(FloatToHalf(std::numeric_limits<f32>::quiet_NaN()).bits));
+    EXPECT_TRUE(IsHalfNan(FloatToHalf(-std::numeric_limits<f32>::quiet_NaN()).bits));
+    // A NaN whose payload lives only in the low mantissa bits must not become Inf
+    EXPECT_TRUE(IsHalfNan(FloatToHalf(std::bit_cast<f32>(0x7F800001u)).bits));
+}
+
+TEST(PixelFormatTest, HalfToFloatIsExactForEveryHalf) {
+    for (u32 bits = 0; bits <= 0xFFFFu; ++bits) {
+        const f16 h{static_cast<u16>(bits)};
+        const f64 expected = ReferenceHalfValue(h.bits);
+        const f32 value = HalfToFloat(h);
+        if (std::isnan(expected)) {
+            EXPECT_TRUE(std::isnan(value)) << std::hex << bits;
+            continue;
+        }
+        EXPECT_EQ(value, expected) << std::hex << bits;
+        EXPECT_EQ(std::signbit(value), (bits & 0x8000u) != 0) << std::hex << bits;
+        EXPECT_EQ(FloatToHalf(value).bits, bits) << std::hex << bits;   // Round trip
+    }
+}
+
+TEST(PixelFormatTest, FloatToHalfRoundsToNearestEven) {
+    std::vector<f32> values = BoundaryValues();
+
+    // Random bit patterns over the whole f32 range (non-finite skipped)
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<u32> bits;
+    while (values.size() < 2'000'000) {
+        const f32 v = std::bit_cast<f32>(bits(rng));
+        if (std::isfinite(v)) {
+            values.push_back(v);
+        }
+    }
+
+    for (f32 v : values) {
+        const u16 expected = ReferenceFloatToHalf(v);
+        const u16 actual = FloatToHalf(v).bits;
+        if (actual != expected) {
+            FAIL() << v << " (0x" << std::hex << std::bit_cast<u32>(v) << "): got 0x" << actual << ", expected 0x"
+                   << expected;
+        }
+    }
+}
+
+TEST(PixelFormatTest, BulkConversionMatchesScalar) {
+    // Not a multiple of 8 (F16C tail) and more than one parallel chunk
+    std::vector<f32> values = BoundaryValues();
+    values.resize(200003, 1.5f);
+    values[3] = std::numeric_limits<f32>::quiet_NaN();
+    values[5] = std::numeric_limits<f32>::infinity();
+
+    for (bool parallel : {false, true}) {
+        SCOPED_TRACE(parallel ? "parallel" : "serial");
+        std::vector<f16> halves(values.size());
+        ConvertSamples(values.data(), halves.data(), values.size(), parallel);
+        std::vector<f32> back(values.size());
+        ConvertSamples(halves.data(), back.data(), halves.size(), parallel);
+
+        usize mismatches = 0;
+        for (usize i = 0; i < values.size(); ++i) {
+            if (std::isnan(values[i])) {
+                // F16C keeps the NaN payload, the scalar path a canonical quiet NaN
+                EXPECT_TRUE(IsHalfNan(halves[i].bits));
+                EXPECT_TRUE(std::isnan(back[i]));
+                continue;
+            }
+            mismatches += halves[i].bits != FloatToHalf(values[i]).bits;
+            mismatches += std::bit_cast<u32>(back[i]) != std::bit_cast<u32>(HalfToFloat(halves[i]));
+        }
+        EXPECT_EQ(mismatches, 0u) << (HasHardwareHalf() ? "F16C" : "scalar") << " path";
+    }
+}
+
+TEST(PixelFormatTest, Unorm16RangeAndConversion) {
+    const f32 nan = std::numeric_limits<f32>::quiet_NaN();
+    const f32 inf = std::numeric_limits<f32>::infinity();
+    const std::vector<f32> range = {-2.0f, 5.0f, nan, inf, 1.0f};
+
+    f32 scale = 0.0f, offset = 0.0f;
+    Unorm16Range(range.data(), range.size(), scale, offset);
+    EXPECT_EQ(offset, -2.0f);
+    EXPECT_EQ(scale, 7.0f / 65535.0f);
+
+    // Ends, non-finite values, and levels just either side of a rounding step
+    const std::vector<f32> values = {-2.0f, 5.0f, nan, inf, -inf, -3.0f, 6.0f,
+                                     offset + 100.49f * scale, offset + 100.51f * scale};
+    std::vector<u16> stored(values.size());
+    ConvertSamples(values.data(), stored.data(), values.size(), scale, offset, false);
+    const std::vector<u16> expected = {0, 65535, 0, 65535, 0, 0, 65535, 100, 101};
+    EXPECT_EQ(stored, expected);
+
+    // Decoding is stored * scale + offset; round trips lose at most half a level
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<f32> value(-2.0f, 5.0f);
+    std::vector<f32> samples(70001);
+    for (f32& v : samples) {
+        v = value(rng);
+    }
+    std::vector<u16> levels(samples.size());
+    std::vector<f32> decoded(samples.size());
+    ConvertSamples(samples.data(), levels.data(), samples.size(), scale, offset, true);
+    ConvertSamples(levels.data(), decoded.data(), levels.size(), scale, offset, true);
+    for (usize i = 0; i < samples.size(); ++i) {
+        ASSERT_LE(std::abs(decoded[i] - samples[i]), 0.5f * scale + 1e-6f) << samples[i];
+    }
+}
+
+TEST(PixelFormatTest, Unorm16RangeDegenerateInputs) {
+    const std::vector<f32> constant(10, 3.0f);
+    f32 scale = 0.0f, offset = 0.0f;
+    Unorm16Range(constant.data(), constant.size(), scale, offset);
+    EXPECT_EQ(scale, 1.0f);
+    EXPECT_EQ(offset, 3.0f);
+
+    const std::vector<f32> nonFinite = {std::numeric_limits<f32>::quiet_NaN(), std::numeric_limits<f32>::infinity()};
+    Unorm16Range(nonFinite.data(), nonFinite.size(), scale, offset);
+    EXPECT_EQ(scale, 1.0f);
+    EXPECT_EQ(offset, 0.0f);
+}
+
+TEST(PixelFormatTest, ParsesFormatNames) {
+    EXPECT_EQ(ParsePixelFormat("f32"), PixelFormat::F32);
+    EXPECT_EQ(ParsePixelFormat("float"), PixelFormat::F32);
+    EXPECT_EQ(ParsePixelFormat("f16"), PixelFormat::F16);
+    EXPECT_EQ(ParsePixelFormat("half"), PixelFormat::F16);
+    EXPECT_EQ(ParsePixelFormat("u16"), PixelFormat::U16);
+    EXPECT_EQ(ParsePixelFormat("bf16"), PixelFormat::F32);
+    for (PixelFormat format : {PixelFormat::F32, PixelFormat::F16, PixelFormat::U16}) {
+        EXPECT_EQ(ParsePixelFormat(PixelFormatName(format)), format);
+    }
+    static_assert(PixelFormatOf<f16> == PixelFormat::F16 && PixelFormatOf<u16> == PixelFormat::U16 &&
+                  PixelFormatOf<f32> == PixelFormat::F32);
+}
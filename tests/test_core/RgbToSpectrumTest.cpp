@@ -0,0 +1,153 @@
+// ============================================================================
+// RgbToSpectrumTable tests: RGB -> spectrum -> RGB round trip
+// ============================================================================
+// The uplifted spectrum of a colour, lit by D65 and seen by the CIE 1931
+// observer, must give the colour back. The reference integration below is
+// independent of the builder's (1 nm grid, own D65 table).
+// ============================================================================
+
+#include "core/Color.hpp"
+#include "core/RgbToSpectrum.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+using namespace quantiloom;
+
+namespace {
+
+// CIE standard illuminant D65, 380-780 nm in 10 nm steps
+constexpr std::array<f64, 41> kD65 = {
+    49.9755, 54.6482, 82.7549, 91.4860, 93.4318, 86.6823, 104.865, 117.008,
+    117.812, 114.861, 115.923, 108.811, 109.354, 107.802, 104.790, 107.689,
+    104.405, 104.046, 100.000, 96.3342, 95.7880, 88.6856, 90.0062, 89.5991,
+    87.6987, 83.2886, 83.6992, 80.0268, 80.2146, 82.2778, 78.2842, 69.7213,
+    71.6091, 74.3490, 61.6040, 69.8856, 75.0870, 63.5927, 46.4182, 66.8054,
+    63.3828};
+
+// Linear sRGB of a reflectance spectrum under D65, scaled so that a
+// constant spectrum of 1 is exactly white
+class Observer {
+public:
+    Observer() {
+        for (u32 nm = 380; nm <= 780; ++nm) {
+            const f64 position = (nm - 380) / 10.0;
+            const usize i = std::min<usize>(static_cast<usize>(position), 39);
+            const f64 illuminant = kD65[i] + (kD65[i + 1] - kD65[i]) * (position - static_cast<f64>(i));
+            const glm::vec3 cmf = CieColorMatching(static_cast<f32>(nm));
+            const glm::vec3 weight = XyzToLinearSrgb(cmf * static_cast<f32>(illuminant));
+            m_weights[nm - 380] = weight;
+            m_white += glm::dvec3(weight.x, weight.y, weight.z);
+        }
+    }
+
+    template<typename Spectrum>
+    glm::vec3 ToRgb(Spectrum&& spectrum) const {
+        glm::dvec3 rgb(0.0);
+        for (u32 nm = 380; nm <= 780; ++nm) {
+            const glm::vec3& w = m_weights[nm - 380];
+            rgb += glm::dvec3(w.x, w.y, w.z) * static_cast<f64>(spectrum(static_cast<f32>(nm)));
+        }
+        return glm::vec3(glm::dvec3(rgb.x / m_white.x, rgb.y / m_white.y, rgb.z / m_white.z));
+    }
+
+private:
+    std::array<glm::vec3, 401> m_weights;
+    glm::dvec3 m_white = glm::dvec3(0.0);
+};
+
+const RgbToSpectrumTable& Table() {
+    static const RgbToSpectrumTable table = RgbToSpectrumTable::Build(16);
+    return table;
+}
+
+TEST(RgbToSpectrumTest, BuildsValidTable) {
+    const RgbToSpectrumTable& table = Table();
+    EXPECT_TRUE(table.IsValid());
+    EXPECT_EQ(table.scale.front(), 0.0f);
+    EXPECT_EQ(table.scale.back(), 1.0f);
+    EXPECT_TRUE(std::is_sorted(table.scale.begin(), table.scale.end()));
+}
+
+// Largest per-channel error of the RGB -> spectrum -> RGB round trip; also
+// checks that the spectrum is a valid reflectance
+f32 RoundTripError(const RgbToSpectrumTable& table, const Observer& observer, const glm::vec3& rgb) {
+    const glm::vec3 coeffs = table.Fetch(rgb);
+    bool bounded = true;
+    const glm::vec3 back = observer.ToRgb([&](f32 nm) {
+        const f32 s = RgbToSpectrumTable::Evaluate(coeffs, nm);
+        bounded = bounded && s >= 0.0f && s <= 1.0f;
+        return s;
+    });
+    if (!bounded) {
+        return std::numeric_limits<f32>::infinity();
+    }
+    f32 error = 0.0f;
+    for (glm::length_t c = 0; c < 3; ++c) {
+        error = std::max(error, std::abs(back[c] - rgb[c]));
+    }
+    return error;
+}
+
+} // namespace
+
+TEST(RgbToSpectrumTest, RoundTripsTableNodes) {
+    const RgbToSpectrumTable& table = Table();
+    const Observer observer;
+    const u32 res = table.resolution;
+
+    // Only the fit and the two integrations differ here: includes the dark,
+    // saturated corners where the optimiser is hardest to converge. Below 1%
+    // brightness the coefficient clamp limits the fit, invisibly.
+    for (u32 l = 0; l < 3; ++l) {
+        for (u32 k = 1; k < res; ++k) {
+            if (table.scale[k] < 0.01f) {
+                continue;
+            }
+            for (u32 j = 0; j < res; j += 3) {
+                for (u32 i = 0; i < res; i += 3) {
+                    const f32 z = table.scale[k];
+                    glm::vec3 rgb;
+                    rgb[static_cast<glm::length_t>(l)] = z;
+                    rgb[static_cast<glm::length_t>((l + 1) % 3)] = static_cast<f32>(i) / static_cast<f32>(res - 1) * z;
+                    rgb[static_cast<glm::length_t>((l + 2) % 3)] = static_cast<f32>(j) / static_cast<f32>(res - 1) * z;
+                    EXPECT_LT(RoundTripError(table, observer, rgb), 0.005f)
+                        << "(" << rgb.x << ", " << rgb.y << ", " << rgb.z << ")";
+                }
+            }
+        }
+    }
+}
+
+TEST(RgbToSpectrumTest, RoundTripsColours) {
+    const RgbToSpectrumTable& table = Table();
+    const Observer observer;
+
+    // Grid over the gamut, mostly between table nodes: adds interpolation error
+    for (f32 r = 0.05f; r < 1.0f; r += 0.1f) {
+        for (f32 g = 0.05f; g < 1.0f; g += 0.1f) {
+            for (f32 b = 0.05f; b < 1.0f; b += 0.1f) {
+                EXPECT_LT(RoundTripError(table, observer, glm::vec3(r, g, b)), 0.02f)
+                    << "(" << r << ", " << g << ", " << b << ")";
+            }
+        }
+    }
+}
+
+TEST(RgbToSpectrumTest, GreysAreFlat) {
+    const RgbToSpectrumTable& table = Table();
+    for (f32 grey : {0.1f, 0.5f, 0.9f}) {
+        const glm::vec3 coeffs = table.Fetch(glm::vec3(grey));
+        for (f32 nm = 400.0f; nm <= 700.0f; nm += 50.0f) {
+            EXPECT_NEAR(RgbToSpectrumTable::Evaluate(coeffs, nm), grey, 0.02f) << nm << " nm";
+        }
+    }
+
+    // Black and white at the ends of the range
+    EXPECT_EQ(table.EvaluateReflectance(glm::vec3(0.0f), 550.0f), 0.0f);
+    EXPECT_NEAR(table.EvaluateReflectance(glm::vec3(1.0f), 550.0f), 1.0f, 0.01f);
+}
@@ -0,0 +1,119 @@
+// ============================================================================
+// ShardPlan tests: shards are disjoint and cover every pixel, band and sample
+// ============================================================================
+
+#include "core/ShardPlan.hpp"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+struct PlanCase {
+    u32 width, height, bandCount, spp;
+    ShardPlanSettings settings;
+};
+
+// Whole image, exact and ragged tiles, band groups and sample ranges that do
+// and do not divide evenly, settings larger than the render
+const PlanCase kCases[] = {
+    {37, 23, 5, 7, {}},
+    {37, 23, 5, 7, {8, 8, 0, 0}},
+    {32, 16, 4, 8, {16, 8, 2, 4}},
+    {37, 23, 5, 7, {10, 7, 2, 3}},
+    {37, 23, 5, 7, {1, 23, 1, 1}},
+    {9, 4, 3, 2, {64, 64, 16, 32}},
+};
+
+} // namespace
+
+TEST(ShardPlanTest, CoversEverySampleExactlyOnce) {
+    for (const PlanCase& c : kCases) {
+        SCOPED_TRACE(::testing::Message() << c.width << "x" << c.height << "x" << c.bandCount << ", spp " << c.spp
+                                          << ", tile " << c.settings.tileWidth << "x" << c.settings.tileHeight
+                                          << ", bands " << c.settings.bandsPerShard
+                                          << ", samples " << c.settings.samplesPerShard);
+        const ShardPlan plan(c.width, c.height, c.bandCount, c.spp, c.settings);
+        ASSERT_FALSE(plan.GetShards().empty());
+
+        // Times each (band, y, x, sample) is rendered by some shard
+        std::vector<u32> covered(static_cast<usize>(c.bandCount) * c.height * c.width * c.spp, 0);
+        for (usize i = 0; i < plan.GetShards().size(); ++i) {
+            const Shard& shard = plan.GetShards()[i];
+            EXPECT_EQ(shard.index, i);
+            ASSERT_GT(shard.width, 0u);
+            ASSERT_GT(shard.height, 0u);
+            ASSERT_GT(shard.bandCount, 0u);
+            ASSERT_GT(shard.sampleCount, 0u);
+            ASSERT_LE(shard.x + shard.width, c.width);
+            ASSERT_LE(shard.y + shard.height, c.height);
+            ASSERT_LE(shard.bandStart + shard.bandCount, c.bandCount);
+            ASSERT_LE(shard.sampleStart + shard.sampleCount, c.spp);
+
+            for (u32 b = shard.bandStart; b < shard.bandStart + shard.bandCount; ++b) {
+                for (u32 y = shard.y; y < shard.y + shard.height; ++y) {
+                    for (u32 x = shard.x; x < shard.x + shard.width; ++x) {
+                        for (u32 s = shard.sampleStart; s < shard.sampleStart + shard.sampleCount; ++s) {
+                            ++covered[((static_cast<usize>(b) * c.height + y) * c.width + x) * c.spp + s];
+                        }
+                    }
+                }
+            }
+        }
+
+        usize wrong = 0;
+        for (u32 count : covered) {
+            wrong += (count != 1);
+        }
+        EXPECT_EQ(wrong, 0u) << "samples rendered zero or several times";
+    }
+}
+
+TEST(ShardPlanTest, IsDeterministic) {
+    const ShardPlanSettings settings{10, 7, 2, 3};
+    const ShardPlan a(37, 23, 5, 7, settings);
+    const ShardPlan b(37, 23, 5, 7, settings);
+    ASSERT_EQ(a.GetShards().size(), b.GetShards().size());
+    for (usize i = 0; i < a.GetShards().size(); ++i) {
+        const Shard& x = a.GetShards()[i];
+        const Shard& y = b.GetShards()[i];
+        EXPECT_EQ(std::tie(x.x, x.y, x.width, x.height, x.bandStart, x.bandCount, x.sampleStart, x.sampleCount),
+                  std::tie(y.x, y.y, y.width, y.height, y.bandStart, y.bandCount, y.sampleStart, y.sampleCount));
+    }
+}
+
+TEST(ShardPlanTest, MetadataRoundTrips) {
+    ShardPlan plan(37, 23, 5, 7, ShardPlanSettings{10, 7, 2, 3});
+    plan.SetId("0123456789abcdef");
+    const Shard& shard = plan.GetShards()[17];
+
+    std::unordered_map<std::string, std::string> metadata;
+    metadata["renderer"] = "Quantiloom Spectral";
+    plan.WriteMetadata(shard, metadata);
+    EXPECT_FALSE(IsShardMetadataKey("renderer"));
+    EXPECT_TRUE(IsShardMetadataKey("shard.index"));
+
+    const std::optional<ShardHeader> header = ReadShardHeader(metadata);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->planId, plan.GetId());
+    EXPECT_EQ(header->shardCount, plan.GetShards().size());
+    EXPECT_EQ(header->imageWidth, 37u);
+    EXPECT_EQ(header->imageHeight, 23u);
+    EXPECT_EQ(header->bandCount, 5u);
+    EXPECT_EQ(header->spp, 7u);
+    EXPECT_EQ(header->shard.index, shard.index);
+    EXPECT_EQ(std::tie(header->shard.x, header->shard.y, header->shard.width, header->shard.height),
+              std::tie(shard.x, shard.y, shard.width, shard.height));
+    EXPECT_EQ(std::tie(header->shard.bandStart, header->shard.bandCount),
+              std::tie(shard.bandStart, shard.bandCount));
+    EXPECT_EQ(std::tie(header->shard.sampleStart, header->shard.sampleCount),
+              std::tie(shard.sampleStart, shard.sampleCount));
+
+    // Missing keys: not a partial
+    metadata.erase("shard.sample_count");
+    EXPECT_FALSE(ReadShardHeader(metadata).has_value());
+}
@@ -0,0 +1,193 @@
+// ============================================================================
+// SpectralPca tests: eigen-decomposition, the reconstruction error bound and
+// the compressed HDF5 archive
+// ============================================================================
+// The error bound is checked against an independent measurement of the
+// decoded cube, not only the relativeRmse the encoder reports.
+// ============================================================================
+
+#include "core/SpectralPca.hpp"
+#include "io/SpectralIO.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+constexpr u32 kWidth = 70;    // Ragged last tile for tileSize 32
+constexpr u32 kHeight = 45;
+constexpr u32 kBands = 40;
+
+// A few smooth spectra mixed with random per-pixel weights, plus noise
+SpectralCube MakeCube(u32 seed, f32 noise) {
+    SpectralCube cube(kWidth, kHeight, kBands, 400.0f, 790.0f);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> weight(0.0f, 1.0f);
+    std::normal_distribution<f32> jitter(0.0f, noise);
+
+    for (u32 y = 0; y < kHeight; ++y) {
+        for (u32 x = 0; x < kWidth; ++x) {
+            const f32 w0 = 0.5f + weight(rng), w1 = weight(rng), w2 = weight(rng);
+            for (u32 b = 0; b < kBands; ++b) {
+                const f32 t = static_cast<f32>(b) / static_cast<f32>(kBands - 1);
+                const f32 value = w0 + w1 * std::sin(3.0f * t) + w2 * std::exp(-20.0f * (t - 0.6f) * (t - 0.6f));
+                cube.BandPtr(b)[static_cast<usize>(y) * kWidth + x] = value + jitter(rng);
+            }
+        }
+    }
+    return cube;
+}
+
+// sqrt(sum (x - x')^2 / sum x^2) over [y0, y0 + h) x [x0, x0 + w) of every band
+f64 RelativeRmse(const SpectralCube& reference, const SpectralCube& decoded, u32 x0 = 0, u32 y0 = 0) {
+    f64 error = 0.0, energy = 0.0;
+    for (u32 b = 0; b < decoded.nbands; ++b) {
+        for (u32 y = 0; y < decoded.height; ++y) {
+            for (u32 x = 0; x < decoded.width; ++x) {
+                const f64 r = reference.BandPtr(b)[static_cast<usize>(y0 + y) * reference.width + x0 + x];
+                const f64 d = decoded.BandPtr(b)[static_cast<usize>(y) * decoded.width + x];
+                error += (d - r) * (d - r);
+                energy += r * r;
+            }
+        }
+    }
+    return std::sqrt(error / energy);
+}
+
+std::filesystem::path TempFile(const char* name) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "ql_pca_test";
+    std::filesystem::create_directories(dir);
+    return dir / name;
+}
+
+} // namespace
+
+TEST(SpectralPcaTest, SymmetricEigenReconstructsMatrix) {
+    constexpr u32 n = 6;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<f64> value(-1.0, 1.0);
+    std::vector<f64> matrix(n * n);
+    for (u32 i = 0; i < n; ++i) {
+        for (u32 j = i; j < n; ++j) {
+            matrix[i * n + j] = matrix[j * n + i] = value(rng);
+        }
+    }
+    const std::vector<f64> original = matrix;
+
+    std::vector<f64> values, vectors;
+    SpectralPca::SymmetricEigen(matrix, n, values, vectors);
+    ASSERT_EQ(values.size(), n);
+    ASSERT_EQ(vectors.size(), n * n);
+    EXPECT_TRUE(std::is_sorted(values.rbegin(), values.rend()));
+
+    for (u32 i = 0; i < n; ++i) {
+        for (u32 j = 0; j < n; ++j) {
+            // Orthonormal rows, and A = sum_k lambda_k v_k v_k^T
+            f64 dot = 0.0, a = 0.0;
+            for (u32 k = 0; k < n; ++k) {
+                dot += vectors[i * n + k] * vectors[j * n + k];
+                a += values[k] * vectors[k * n + i] * vectors[k * n + j];
+            }
+            EXPECT_NEAR(dot, i == j ? 1.0 : 0.0, 1e-10);
+            EXPECT_NEAR(a, original[i * n + j], 1e-10);
+        }
+    }
+}
+
+TEST(SpectralPcaTest, ReconstructionMeetsErrorBound) {
+    const SpectralCube cube = MakeCube(1, 1e-3f);
+
+    u32 previousComponents = 0;
+    for (f32 bound : {1e-2f, 1e-3f, 2e-4f}) {
+        SCOPED_TRACE(bound);
+        SpectralPcaSettings settings;
+        settings.maxRelativeRmse = bound;
+        settings.tileSize = 32;
+        const auto encoding = SpectralPca::Encode(cube, settings);
+        ASSERT_TRUE(encoding.has_value());
+        ASSERT_TRUE(encoding->IsValid());
+
+        const SpectralCube decoded = SpectralPca::Decode(*encoding);
+        ASSERT_EQ(decoded.nbands, kBands);
+        const f64 measured = RelativeRmse(cube, decoded);
+        EXPECT_LE(measured, bound);
+        EXPECT_NEAR(encoding->relativeRmse, measured, 1e-3 * measured);
+
+        // Tighter bounds never need fewer components; the cube is low rank
+        EXPECT_GE(encoding->components, previousComponents);
+        EXPECT_LT(encoding->components, kBands);
+        previousComponents = encoding->components;
+
+        for (u32 i = 0; i < encoding->components; ++i) {
+            f64 norm = 0.0;
+            for (u32 b = 0; b < kBands; ++b) {
+                norm += static_cast<f64>(encoding->basis[i * kBands + b]) * encoding->basis[i * kBands + b];
+            }
+            EXPECT_NEAR(norm, 1.0, 1e-5);
+        }
+    }
+}
+
+TEST(SpectralPcaTest, FailsWhenBoundIsUnreachable) {
+    // Independent noise in every band cannot be represented by 2 components
+    SpectralCube cube(32, 32, 16, 400.0f, 550.0f);
+    std::mt19937 rng(3);
+    std::normal_distribution<f32> value(1.0f, 0.5f);
+    for (f32& v : cube.data) {
+        v = value(rng);
+    }
+
+    SpectralPcaSettings settings;
+    settings.maxRelativeRmse = 1e-3f;
+    settings.maxComponents = 2;
+    EXPECT_FALSE(SpectralPca::Encode(cube, settings).has_value());
+
+    // With every component available the bound is met
+    settings.maxComponents = 0;
+    const auto encoding = SpectralPca::Encode(cube, settings);
+    ASSERT_TRUE(encoding.has_value());
+    EXPECT_LE(RelativeRmse(cube, SpectralPca::Decode(*encoding)), settings.maxRelativeRmse);
+}
+
+TEST(SpectralPcaTest, CompressedArchiveRoundTrip) {
+    const SpectralCube cube = MakeCube(2, 1e-3f);
+    const std::filesystem::path path = TempFile("compressed.h5");
+
+    SpectralPcaSettings settings;
+    settings.maxRelativeRmse = 5e-4f;
+    settings.tileSize = 32;
+    ASSERT_TRUE(SpectralIO::WriteCompressedHDF5(path.string(), cube, settings));
+
+    const auto full = SpectralIO::ReadHDF5(path.string());
+    ASSERT_TRUE(full.has_value());
+    EXPECT_EQ(full->width, kWidth);
+    EXPECT_EQ(full->height, kHeight);
+    ASSERT_EQ(full->nbands, kBands);
+    EXPECT_EQ(full->wavelengths, cube.wavelengths);
+    EXPECT_LE(RelativeRmse(cube, *full), settings.maxRelativeRmse);
+
+    // A region across tile boundaries decodes to the same values as the
+    // whole cube
+    constexpr u32 x0 = 20, y0 = 30, w = 45, h = 12;
+    const auto region = SpectralIO::ReadRegion(path.string(), x0, y0, w, h);
+    ASSERT_TRUE(region.has_value());
+    ASSERT_EQ(region->width, w);
+    ASSERT_EQ(region->height, h);
+    for (u32 b = 0; b < kBands; ++b) {
+        for (u32 y = 0; y < h; ++y) {
+            for (u32 x = 0; x < w; ++x) {
+                EXPECT_NEAR(region->BandPtr(b)[y * w + x],
+                            full->BandPtr(b)[static_cast<usize>(y0 + y) * kWidth + x0 + x], 1e-6f);
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
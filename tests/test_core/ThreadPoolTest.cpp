@@ -0,0 +1,252 @@
+// ============================================================================
+// ThreadPool tests: task groups, cancellation, ParallelFor / ParallelReduce,
+// nesting and settings
+// ============================================================================
+// Parallel loops run on a 4-thread global pool (whatever the machine has), so
+// the multi-threaded paths are exercised on single-core CI runners too.
+// ============================================================================
+
+#include "core/Config.hpp"
+#include "core/Parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+void SetEnvironment(const char* name, const char* value) {
+#if defined(_WIN32)
+    _putenv_s(name, value ? value : "");
+#else
+    if (value) {
+        setenv(name, value, 1);
+    } else {
+        unsetenv(name);
+    }
+#endif
+}
+
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override { ThreadPool::ConfigureGlobal({4, false}); }
+    void TearDown() override { ThreadPool::ConfigureGlobal(ThreadPoolSettings::FromEnvironment()); }
+};
+
+} // namespace
+
+TEST_F(ThreadPoolTest, TaskGroupRunsEveryTaskOnce) {
+    for (u32 threads : {1u, 2u, 4u}) {
+        SCOPED_TRACE(threads);
+        ThreadPool pool({threads, false});
+        EXPECT_EQ(pool.ThreadCount(), threads);
+
+        std::vector<std::atomic<u32>> runs(1000);
+        {
+            TaskGroup group(pool);
+            for (auto& run : runs) {
+                group.Run([&run] { run.fetch_add(1, std::memory_order_relaxed); });
+            }
+            group.Wait();
+            for (const auto& run : runs) {
+                EXPECT_EQ(run.load(), 1u);
+            }
+
+            // A group can be reused after Wait()
+            group.Run([&] { runs[0].fetch_add(1); });
+        }   // Destructor waits
+        EXPECT_EQ(runs[0].load(), 2u);
+    }
+}
+
+TEST_F(ThreadPoolTest, CancelledGroupSkipsQueuedTasks) {
+    ThreadPool pool({2, false});
+    TaskGroup group(pool);
+
+    // Occupy the only worker so the following tasks stay queued
+    std::promise<void> started, release;
+    std::shared_future<void> released = release.get_future().share();
+    group.Run([&started, released] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    std::atomic<u32> ran{0};
+    for (u32 i = 0; i < 100; ++i) {
+        group.Run([&ran] { ran.fetch_add(1); });
+    }
+    group.Cancel();
+    EXPECT_TRUE(group.IsCancelled());
+    EXPECT_TRUE(group.Token().IsCancelled());
+    release.set_value();
+    group.Wait();
+
+    EXPECT_EQ(ran.load(), 0u);
+    EXPECT_FALSE(pool.RunPendingTask());   // Skipped tasks are still dequeued
+}
+
+TEST_F(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    struct Case { usize count, grain; };
+    for (const Case& c : {Case{0, 1}, Case{1, 1}, Case{7, 100}, Case{1000, 1}, Case{1001, 16}, Case{100000, 0}}) {
+        SCOPED_TRACE(::testing::Message() << c.count << " / " << c.grain);
+        std::vector<std::atomic<u32>> visits(c.count);
+        EXPECT_TRUE(ParallelFor(c.count, c.grain, [&](usize i) { visits[i].fetch_add(1, std::memory_order_relaxed); }));
+        for (const auto& v : visits) {
+            ASSERT_EQ(v.load(), 1u);
+        }
+    }
+}
+
+TEST_F(ThreadPoolTest, NestedLoopsComplete) {
+    // Outer loop occupies every thread; inner loops must not deadlock
+    std::vector<std::atomic<u32>> visits(16 * 500);
+    ParallelFor(16, 1, [&](usize outer) {
+        ParallelFor(500, 8, [&](usize inner) { visits[outer * 500 + inner].fetch_add(1); });
+    });
+    for (const auto& v : visits) {
+        ASSERT_EQ(v.load(), 1u);
+    }
+
+    // Task groups inside a parallel loop
+    std::atomic<u32> tasks{0};
+    ParallelFor(8, 1, [&](usize) {
+        TaskGroup group;
+        for (u32 i = 0; i < 50; ++i) {
+            group.Run([&tasks] { tasks.fetch_add(1); });
+        }
+        group.Wait();
+    });
+    EXPECT_EQ(tasks.load(), 8u * 50u);
+}
+
+TEST_F(ThreadPoolTest, ParallelForStopsWhenCancelled) {
+    CancellationToken token;
+    std::atomic<usize> visited{0};
+    const bool completed = ParallelFor(100000, 1, [&](usize i) {
+        visited.fetch_add(1);
+        if (i == 10) {
+            token.Cancel();
+        }
+    }, &token);
+    EXPECT_FALSE(completed);
+    // Only chunks already handed out finish (at most one per thread)
+    EXPECT_LT(visited.load(), 100000u);
+
+    // A cancelled token starts nothing; Reset makes it usable again
+    visited = 0;
+    EXPECT_FALSE(ParallelFor(1000, 1, [&](usize) { visited.fetch_add(1); }, &token));
+    EXPECT_EQ(visited.load(), 0u);
+    token.Reset();
+    EXPECT_TRUE(ParallelFor(1000, 1, [&](usize) { visited.fetch_add(1); }, &token));
+    EXPECT_EQ(visited.load(), 1000u);
+}
+
+TEST_F(ThreadPoolTest, ParallelReduceIsDeterministic) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<f32> value(-1.0f, 1.0f);
+    std::vector<f32> values(100003);
+    for (f32& v : values) {
+        v = value(rng) * 1e4f;
+    }
+
+    auto reduce = [&] {
+        return ParallelReduce(values.size(), 1000, 0.0f,
+            [&](usize begin, usize end, f32& partial) {
+                for (usize i = begin; i < end; ++i) {
+                    partial += values[i];
+                }
+            },
+            [](f32 a, f32 b) { return a + b; });
+    };
+
+    // Serial fold of the same chunks, in chunk order
+    f32 expected = 0.0f;
+    for (usize begin = 0; begin < values.size(); begin += 1000) {
+        f32 partial = 0.0f;
+        for (usize i = begin; i < std::min(values.size(), begin + 1000); ++i) {
+            partial += values[i];
+        }
+        expected += partial;
+    }
+
+    // Bitwise equal whatever the thread count
+    EXPECT_EQ(reduce(), expected);
+    ThreadPool::ConfigureGlobal({1, false});
+    EXPECT_EQ(reduce(), expected);
+    ThreadPool::ConfigureGlobal({3, false});
+    EXPECT_EQ(reduce(), expected);
+
+    // Partials are combined in chunk order (non-commutative combine)
+    const std::vector<usize> order = ParallelReduce(50, 3, std::vector<usize>(),
+        [](usize begin, usize, std::vector<usize>& partial) { partial.push_back(begin); },
+        [](std::vector<usize> a, const std::vector<usize>& b) {
+            a.insert(a.end(), b.begin(), b.end());
+            return a;
+        });
+    ASSERT_EQ(order.size(), 17u);
+    for (usize i = 0; i < order.size(); ++i) {
+        EXPECT_EQ(order[i], 3 * i);
+    }
+}
+
+TEST_F(ThreadPoolTest, ForEachBandPicksTheParallelLevel) {
+    for (u32 bands : {2u, 4u, 9u}) {
+        SCOPED_TRACE(bands);
+        std::vector<std::atomic<u32>> visits(bands);
+        std::atomic<u32> parallelInside{0};
+        ForEachBand(bands, [&](u32 b, bool parallel) {
+            visits[b].fetch_add(1);
+            parallelInside.fetch_add(parallel ? 1u : 0u);
+        });
+        for (const auto& v : visits) {
+            EXPECT_EQ(v.load(), 1u);
+        }
+        // Fewer bands than the 4 threads: parallelism goes inside each band
+        EXPECT_EQ(parallelInside.load(), bands < 4 ? bands : 0u);
+    }
+}
+
+TEST_F(ThreadPoolTest, SettingsFromConfigAndEnvironment) {
+    SetEnvironment("QUANTILOOM_THREADS", nullptr);
+    SetEnvironment("QUANTILOOM_PIN_THREADS", nullptr);
+
+    const Config config = Config::FromTable(toml::parse(R"(
+        [threads]
+        count = 5
+        pin = true
+    )"));
+    ThreadPoolSettings settings = ThreadPoolSettings::FromConfig(config);
+    EXPECT_EQ(settings.threadCount, 5u);
+    EXPECT_TRUE(settings.pinThreads);
+
+    settings = ThreadPoolSettings::FromEnvironment();
+    EXPECT_EQ(settings.threadCount, 0u);
+    EXPECT_FALSE(settings.pinThreads);
+
+    // The environment wins over the config; malformed counts are ignored
+    SetEnvironment("QUANTILOOM_THREADS", "3");
+    SetEnvironment("QUANTILOOM_PIN_THREADS", "off");
+    settings = ThreadPoolSettings::FromConfig(config);
+    EXPECT_EQ(settings.threadCount, 3u);
+    EXPECT_FALSE(settings.pinThreads);
+
+    SetEnvironment("QUANTILOOM_THREADS", "3x");
+    SetEnvironment("QUANTILOOM_PIN_THREADS", "1");
+    settings = ThreadPoolSettings::FromConfig(config);
+    EXPECT_EQ(settings.threadCount, 5u);
+    EXPECT_TRUE(settings.pinThreads);
+
+    SetEnvironment("QUANTILOOM_THREADS", nullptr);
+    SetEnvironment("QUANTILOOM_PIN_THREADS", nullptr);
+
+    EXPECT_GE(ThreadPool(ThreadPoolSettings{}).ThreadCount(), 1u);
+}
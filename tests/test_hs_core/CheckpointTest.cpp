@@ -0,0 +1,192 @@
+// ============================================================================
+// Checkpoint tests: checkpoint file and band store round trips
+// ============================================================================
+
+#include "io/Checkpoint.hpp"
+#include "core/Config.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_dir = std::filesystem::temp_directory_path() / (std::string("ql_ckpt_") + info->name());
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(m_dir, ec);
+    }
+
+    std::filesystem::path m_dir;
+};
+
+void WriteFile(const std::filesystem::path& path, const std::string& contents) {
+    std::ofstream(path, std::ios::binary) << contents;
+}
+
+// Render config naming its scene files relative to the working directory
+Config SceneConfig(const char* extra = "") {
+    return Config::FromTable(toml::parse(std::string(R"(
+        [renderer]
+        resolution = [64, 32]
+        spp = 16
+        [scene]
+        gltf = "scene.gltf"
+        [spectral_materials]
+        library = "library.h5"
+        [threads]
+        count = 4
+    )") + extra));
+}
+
+// Working directory set to dir while in scope
+class ScopedWorkingDirectory {
+public:
+    explicit ScopedWorkingDirectory(const std::filesystem::path& dir)
+        : m_previous(std::filesystem::current_path()) {
+        std::filesystem::current_path(dir);
+    }
+    ~ScopedWorkingDirectory() { std::filesystem::current_path(m_previous); }
+
+private:
+    std::filesystem::path m_previous;
+};
+
+} // namespace
+
+TEST_F(CheckpointTest, FileRoundTripsAndReplacesAtomically) {
+    const std::string path = (m_dir / "cube.h5.ckpt").string();
+
+    RenderCheckpoint checkpoint;
+    checkpoint.fingerprint = "abc";
+    checkpoint.width = 3;
+    checkpoint.height = 2;
+    checkpoint.bandCount = 4;
+    checkpoint.spp = 8;
+    checkpoint.seed = 0x123456789ABCDEF0ull;
+    checkpoint.bandsDone = {1, 1, 0, 0};
+    checkpoint.band = 2;
+    checkpoint.nextSample = 5;
+    checkpoint.sum.assign(3 * 2 * 4, 1.5f);
+    checkpoint.sampleCounts.assign(3 * 2, 5);
+    ASSERT_TRUE(CheckpointFile::Write(path, checkpoint));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    std::optional<RenderCheckpoint> read = CheckpointFile::Read(path);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(read->fingerprint, checkpoint.fingerprint);
+    EXPECT_EQ(read->seed, checkpoint.seed);
+    EXPECT_EQ(read->bandsDone, checkpoint.bandsDone);
+    EXPECT_EQ(read->band, 2u);
+    EXPECT_EQ(read->nextSample, 5u);
+    EXPECT_EQ(read->sum, checkpoint.sum);
+    EXPECT_EQ(read->sampleCounts, checkpoint.sampleCounts);
+
+    // A later checkpoint replaces it
+    checkpoint.bandsDone = {1, 1, 1, 0};
+    checkpoint.band = 3;
+    checkpoint.nextSample = 0;
+    checkpoint.sum.clear();
+    checkpoint.sampleCounts.clear();
+    ASSERT_TRUE(CheckpointFile::Write(path, checkpoint));
+    read = CheckpointFile::Read(path);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(read->bandsDone, checkpoint.bandsDone);
+    EXPECT_TRUE(read->sum.empty());
+
+    CheckpointFile::Remove(path);
+    EXPECT_FALSE(CheckpointFile::Read(path).has_value());
+}
+
+TEST_F(CheckpointTest, BandStoreKeepsBandsAcrossReopen) {
+    const std::string path = (m_dir / "cube.h5.ckpt.bands").string();
+    constexpr usize kPixels = 6;
+    const std::vector<f32> band0(kPixels, 0.25f);
+    const std::vector<f32> band2 = {1, 2, 3, 4, 5, 6};
+
+    {
+        CheckpointBandStore store;
+        ASSERT_TRUE(store.Open(path, kPixels, false));
+        EXPECT_TRUE(store.Write(2, band2.data()));
+        EXPECT_TRUE(store.Write(0, band0.data()));
+    }
+
+    // Resume: keep = true reads what was written; keep = false discards it
+    CheckpointBandStore store;
+    ASSERT_TRUE(store.Open(path, kPixels, true));
+    std::vector<f32> pixels(kPixels);
+    ASSERT_TRUE(store.Read(2, pixels.data()));
+    EXPECT_EQ(pixels, band2);
+    ASSERT_TRUE(store.Read(0, pixels.data()));
+    EXPECT_EQ(pixels, band0);
+
+    ASSERT_TRUE(store.Open(path, kPixels, false));
+    EXPECT_FALSE(store.Read(2, pixels.data()));
+    store.Close();
+}
+
+TEST_F(CheckpointTest, FingerprintFollowsSceneFileContents) {
+    const std::filesystem::path original = m_dir / "original";
+    const std::filesystem::path copy = m_dir / "copy";
+    std::filesystem::create_directories(original);
+    WriteFile(original / "scene.gltf", R"({"asset": {"version": "2.0"}, "nodes": [0]})");
+    WriteFile(original / "library.h5", std::string(4096, 'x'));
+
+    std::string fingerprint;
+    {
+        ScopedWorkingDirectory cwd(original);
+        fingerprint = CheckpointFile::Fingerprint(SceneConfig());
+
+        // Process settings do not change the render, render settings do
+        EXPECT_EQ(CheckpointFile::Fingerprint(SceneConfig("[profiling]\nsummary = true\n")), fingerprint);
+        EXPECT_NE(CheckpointFile::Fingerprint(SceneConfig("[lighting]\nexposure = 2.0\n")), fingerprint);
+
+        // New timestamps (copied without preserving them) keep the identity
+        const auto later = std::filesystem::last_write_time("scene.gltf") + std::chrono::hours(3);
+        std::filesystem::last_write_time("scene.gltf", later);
+        EXPECT_EQ(CheckpointFile::Fingerprint(SceneConfig()), fingerprint);
+    }
+
+    // The inputs copied to another directory resume there
+    std::filesystem::copy(original, copy);
+    {
+        ScopedWorkingDirectory cwd(copy);
+        EXPECT_EQ(CheckpointFile::Fingerprint(SceneConfig()), fingerprint);
+
+        // An edit that keeps the size and the timestamp does not
+        const auto modified = std::filesystem::last_write_time("library.h5");
+        WriteFile("library.h5", std::string(2048, 'x') + "y" + std::string(2047, 'x'));
+        std::filesystem::last_write_time("library.h5", modified);
+        EXPECT_NE(CheckpointFile::Fingerprint(SceneConfig()), fingerprint);
+    }
+
+    // A checkpoint written for the original resumes against the copy's
+    // fingerprint only while the contents agree
+    RenderCheckpoint checkpoint;
+    checkpoint.fingerprint = fingerprint;
+    checkpoint.width = 64;
+    checkpoint.height = 32;
+    checkpoint.bandCount = 1;
+    checkpoint.spp = 16;
+    checkpoint.bandsDone = {0};
+    const std::string path = (copy / "out.exr.ckpt").string();
+    ASSERT_TRUE(CheckpointFile::Write(path, checkpoint));
+    WriteFile(copy / "library.h5", std::string(4096, 'x'));
+    ScopedWorkingDirectory cwd(copy);
+    const auto resumed = CheckpointFile::Read(path);
+    ASSERT_TRUE(resumed.has_value());
+    EXPECT_EQ(resumed->fingerprint, CheckpointFile::Fingerprint(SceneConfig()));
+}
@@ -0,0 +1,173 @@
+// ============================================================================
+// ShardMerger tests: merging a plan's partials equals one accumulation
+// ============================================================================
+// Stand-in renderer: every (band, pixel, sample) has a known radiance. A
+// single process averages all samples of each pixel; a sharded render writes
+// one partial cube per shard holding the mean over its samples, exactly as
+// ShardWorker does. Merging the partials must give the single-process result.
+// ============================================================================
+
+#include "core/ShardPlan.hpp"
+#include "io/ShardMerge.hpp"
+#include "io/SpectralIO.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+constexpr u32 kWidth = 21;
+constexpr u32 kHeight = 13;
+constexpr u32 kBands = 5;
+constexpr u32 kSpp = 7;
+
+// Radiance of one sample: varies with every index, so a partial written to
+// the wrong place or weighted wrongly shows up
+f32 SampleRadiance(u32 band, u32 x, u32 y, u32 sample) {
+    return 0.1f * static_cast<f32>(band + 1) + 0.01f * static_cast<f32>(x) + 0.003f * static_cast<f32>(y) +
+           0.05f * std::sin(static_cast<f32>(sample * 7 + x * 3 + y + band));
+}
+
+f32 BandWavelength(u32 band) {
+    return 400.0f + 50.0f * static_cast<f32>(band);
+}
+
+class ShardMergeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_dir = std::filesystem::temp_directory_path() / (std::string("ql_merge_") + info->name());
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(m_dir, ec);
+    }
+
+    // Render shard into a partial cube (mean over its samples)
+    std::string WritePartial(const ShardPlan& plan, const Shard& shard) {
+        SpectralCube header;
+        header.width = shard.width;
+        header.height = shard.height;
+        header.nbands = shard.bandCount;
+        for (u32 b = 0; b < shard.bandCount; ++b) {
+            header.wavelengths.push_back(BandWavelength(shard.bandStart + b));
+        }
+        header.lambda_min = header.wavelengths.front();
+        header.lambda_max = header.wavelengths.back();
+        header.metadata["renderer"] = "Quantiloom Spectral";
+        plan.WriteMetadata(shard, header.metadata);
+
+        std::vector<f32> data(static_cast<usize>(shard.bandCount) * shard.width * shard.height);
+        usize i = 0;
+        for (u32 b = 0; b < shard.bandCount; ++b) {
+            for (u32 y = 0; y < shard.height; ++y) {
+                for (u32 x = 0; x < shard.width; ++x) {
+                    f64 sum = 0.0;
+                    for (u32 s = shard.sampleStart; s < shard.sampleStart + shard.sampleCount; ++s) {
+                        sum += SampleRadiance(shard.bandStart + b, shard.x + x, shard.y + y, s);
+                    }
+                    data[i++] = static_cast<f32>(sum / shard.sampleCount);
+                }
+            }
+        }
+
+        const std::string path = (m_dir / ("shard_" + std::to_string(shard.index) + ".h5")).string();
+        SpectralCubeWriter writer;
+        EXPECT_TRUE(writer.Open(path, header));
+        EXPECT_TRUE(writer.WriteBands(0, shard.bandCount, data.data()));
+        EXPECT_TRUE(writer.Close());
+        return path;
+    }
+
+    std::filesystem::path m_dir;
+};
+
+} // namespace
+
+TEST_F(ShardMergeTest, MergedPartialsEqualSingleProcessAccumulation) {
+    const ShardPlanSettings settings[] = {
+        {8, 5, 2, 3},     // Ragged tiles, band groups and sample ranges
+        {0, 0, 0, 2},     // Sample ranges only
+        {7, 13, 5, 0},    // Tiles only
+    };
+    for (const ShardPlanSettings& setting : settings) {
+        ShardPlan plan(kWidth, kHeight, kBands, kSpp, setting);
+        plan.SetId("merge-test");
+        SCOPED_TRACE(::testing::Message() << plan.GetShards().size() << " shards");
+
+        // Partials added out of order: merging must not depend on it
+        ShardMerger merger;
+        for (auto it = plan.GetShards().rbegin(); it != plan.GetShards().rend(); ++it) {
+            ASSERT_TRUE(merger.Add(WritePartial(plan, *it)));
+        }
+        EXPECT_TRUE(merger.GetMissingShards().empty());
+
+        const std::string mergedPath = (m_dir / "merged.h5").string();
+        ASSERT_TRUE(merger.Merge(mergedPath));
+        const std::optional<SpectralCube> merged = SpectralIO::ReadHDF5(mergedPath);
+        ASSERT_TRUE(merged.has_value());
+        ASSERT_EQ(merged->width, kWidth);
+        ASSERT_EQ(merged->height, kHeight);
+        ASSERT_EQ(merged->nbands, kBands);
+        for (u32 b = 0; b < kBands; ++b) {
+            EXPECT_FLOAT_EQ(merged->wavelengths[b], BandWavelength(b));
+        }
+
+        usize mismatches = 0;
+        f64 maxError = 0.0;
+        for (u32 b = 0; b < kBands; ++b) {
+            for (u32 y = 0; y < kHeight; ++y) {
+                for (u32 x = 0; x < kWidth; ++x) {
+                    f64 sum = 0.0;
+                    for (u32 s = 0; s < kSpp; ++s) {
+                        sum += SampleRadiance(b, x, y, s);
+                    }
+                    const f64 expected = sum / kSpp;
+                    const f64 actual = merged->data[(static_cast<usize>(b) * kHeight + y) * kWidth + x];
+                    const f64 error = std::abs(actual - expected);
+                    maxError = std::max(maxError, error);
+                    mismatches += (error > 1e-5 * std::max(1.0, std::abs(expected)));
+                }
+            }
+        }
+        EXPECT_EQ(mismatches, 0u) << "max error " << maxError;
+        std::filesystem::remove(mergedPath);
+    }
+}
+
+TEST_F(ShardMergeTest, RefusesIncompletePlansAndForeignPartials) {
+    ShardPlan plan(kWidth, kHeight, kBands, kSpp, ShardPlanSettings{8, 5, 0, 0});
+    plan.SetId("plan-a");
+    ASSERT_GT(plan.GetShards().size(), 2u);
+
+    ShardMerger merger;
+    for (usize i = 1; i < plan.GetShards().size(); ++i) {
+        ASSERT_TRUE(merger.Add(WritePartial(plan, plan.GetShards()[i])));
+    }
+    EXPECT_EQ(merger.GetMissingShards(), std::vector<u32>{0});
+    EXPECT_FALSE(merger.Merge((m_dir / "incomplete.h5").string()));
+
+    // Same shard again, and a shard of another plan
+    EXPECT_FALSE(merger.Add(WritePartial(plan, plan.GetShards()[1])));
+    ShardPlan other(kWidth, kHeight, kBands, kSpp, ShardPlanSettings{8, 5, 0, 0});
+    other.SetId("plan-b");
+    EXPECT_FALSE(merger.Add(WritePartial(other, other.GetShards()[0])));
+
+    // allowMissing writes the uncovered tile as 0
+    ASSERT_TRUE(merger.Merge((m_dir / "partial.h5").string(), PixelFormat::F32, true));
+    const std::optional<SpectralCube> merged = SpectralIO::ReadHDF5((m_dir / "partial.h5").string());
+    ASSERT_TRUE(merged.has_value());
+    const Shard& missing = plan.GetShards()[0];
+    EXPECT_EQ(merged->data[static_cast<usize>(missing.y) * kWidth + missing.x], 0.0f);
+    EXPECT_NE(merged->data[static_cast<usize>(kHeight - 1) * kWidth + (kWidth - 1)], 0.0f);
+}
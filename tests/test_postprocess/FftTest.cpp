@@ -0,0 +1,118 @@
+// ============================================================================
+// Fft tests: 1D/2D transforms against a direct DFT
+// ============================================================================
+// The radix-2 transform must match sum_n x[n] exp(-2 pi i k n / N) (double
+// precision reference), and the scaled inverse must undo it.
+// ============================================================================
+
+#include "postprocess/Fft.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+std::vector<Fft::Complex> RandomSignal(usize n, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> value(-1.0f, 1.0f);
+    std::vector<Fft::Complex> signal(n);
+    for (Fft::Complex& c : signal) {
+        c = Fft::Complex(value(rng), value(rng));
+    }
+    return signal;
+}
+
+// Direct DFT of count values spaced stride apart
+std::vector<std::complex<f64>> DirectDft(const Fft::Complex* data, usize count, usize stride) {
+    std::vector<std::complex<f64>> out(count);
+    for (usize k = 0; k < count; ++k) {
+        std::complex<f64> sum(0.0, 0.0);
+        for (usize n = 0; n < count; ++n) {
+            const f64 angle = -2.0 * std::numbers::pi * static_cast<f64>(k * n % count) / static_cast<f64>(count);
+            sum += std::complex<f64>(data[n * stride]) * std::complex<f64>(std::cos(angle), std::sin(angle));
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(FftTest, PowerOfTwoHelpers) {
+    EXPECT_TRUE(Fft::IsPowerOfTwo(1));
+    EXPECT_TRUE(Fft::IsPowerOfTwo(64));
+    EXPECT_FALSE(Fft::IsPowerOfTwo(0));
+    EXPECT_FALSE(Fft::IsPowerOfTwo(48));
+    EXPECT_EQ(Fft::NextPowerOfTwo(1), 1u);
+    EXPECT_EQ(Fft::NextPowerOfTwo(33), 64u);
+    EXPECT_EQ(Fft::NextPowerOfTwo(64), 64u);
+}
+
+TEST(FftTest, MatchesDirectDft) {
+    for (usize n : {1u, 2u, 8u, 64u, 256u}) {
+        std::vector<Fft::Complex> signal = RandomSignal(n, static_cast<u32>(n));
+        const std::vector<std::complex<f64>> expected = DirectDft(signal.data(), n, 1);
+
+        Fft::Transform(signal.data(), n, false);
+        // f32 butterflies: error grows with log2(n) and the magnitude (~sqrt(n))
+        const f64 tolerance = 1e-5 * std::sqrt(static_cast<f64>(n)) * (1.0 + std::log2(static_cast<f64>(n)));
+        for (usize k = 0; k < n; ++k) {
+            EXPECT_NEAR(signal[k].real(), expected[k].real(), tolerance) << "n=" << n << " k=" << k;
+            EXPECT_NEAR(signal[k].imag(), expected[k].imag(), tolerance) << "n=" << n << " k=" << k;
+        }
+    }
+}
+
+TEST(FftTest, InverseRestoresSignal) {
+    const std::vector<Fft::Complex> original = RandomSignal(128, 7);
+    std::vector<Fft::Complex> signal = original;
+    Fft::Transform(signal.data(), signal.size(), false);
+    Fft::Transform(signal.data(), signal.size(), true);
+    for (usize i = 0; i < signal.size(); ++i) {
+        EXPECT_NEAR(signal[i].real(), original[i].real(), 1e-5f);
+        EXPECT_NEAR(signal[i].imag(), original[i].imag(), 1e-5f);
+    }
+}
+
+TEST(FftTest, Transform2DMatchesRowColumnDft) {
+    constexpr usize kWidth = 16;
+    constexpr usize kHeight = 8;
+    const std::vector<Fft::Complex> original = RandomSignal(kWidth * kHeight, 3);
+
+    // Reference: direct DFT over rows, then over columns
+    std::vector<Fft::Complex> rows(original.size());
+    for (usize y = 0; y < kHeight; ++y) {
+        const std::vector<std::complex<f64>> row = DirectDft(&original[y * kWidth], kWidth, 1);
+        for (usize x = 0; x < kWidth; ++x) {
+            rows[y * kWidth + x] = Fft::Complex(row[x]);
+        }
+    }
+    std::vector<std::complex<f64>> expected(original.size());
+    for (usize x = 0; x < kWidth; ++x) {
+        const std::vector<std::complex<f64>> column = DirectDft(&rows[x], kHeight, kWidth);
+        for (usize y = 0; y < kHeight; ++y) {
+            expected[y * kWidth + x] = column[y];
+        }
+    }
+
+    for (bool parallel : {false, true}) {
+        std::vector<Fft::Complex> grid = original;
+        Fft::Transform2D(grid.data(), kWidth, kHeight, false, parallel);
+        for (usize i = 0; i < grid.size(); ++i) {
+            EXPECT_NEAR(grid[i].real(), expected[i].real(), 1e-4) << i;
+            EXPECT_NEAR(grid[i].imag(), expected[i].imag(), 1e-4) << i;
+        }
+
+        Fft::Transform2D(grid.data(), kWidth, kHeight, true, parallel);
+        for (usize i = 0; i < grid.size(); ++i) {
+            EXPECT_NEAR(grid[i].real(), original[i].real(), 1e-5f) << i;
+            EXPECT_NEAR(grid[i].imag(), original[i].imag(), 1e-5f) << i;
+        }
+    }
+}
@@ -0,0 +1,195 @@
+// ============================================================================
+// PsfConvolution tests: kernels and the direct/separable/FFT paths
+// ============================================================================
+// Every path must compute out(x) = sum_j k(j) in(x - j) with replicated
+// borders; the reference below evaluates that sum literally.
+// ============================================================================
+
+#include "postprocess/PsfConvolution.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+std::vector<f32> RandomBand(u32 width, u32 height, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> value(0.0f, 1.0f);
+    std::vector<f32> band(static_cast<usize>(width) * height);
+    for (f32& v : band) {
+        v = value(rng);
+    }
+    return band;
+}
+
+std::vector<f32> ReferenceConvolve(const std::vector<f32>& src, u32 width, u32 height, const PsfKernel& kernel) {
+    const i32 rx = static_cast<i32>(kernel.RadiusX());
+    const i32 ry = static_cast<i32>(kernel.RadiusY());
+    std::vector<f32> dst(src.size());
+    for (i32 y = 0; y < static_cast<i32>(height); ++y) {
+        for (i32 x = 0; x < static_cast<i32>(width); ++x) {
+            f64 sum = 0.0;
+            for (i32 j = -ry; j <= ry; ++j) {
+                for (i32 i = -rx; i <= rx; ++i) {
+                    const i32 sx = std::clamp(x - i, 0, static_cast<i32>(width) - 1);
+                    const i32 sy = std::clamp(y - j, 0, static_cast<i32>(height) - 1);
+                    const f32 k = kernel.weights[static_cast<usize>((j + ry) * static_cast<i32>(kernel.width) + i + rx)];
+                    sum += static_cast<f64>(k) * src[static_cast<usize>(sy) * width + static_cast<usize>(sx)];
+                }
+            }
+            dst[static_cast<usize>(y) * width + static_cast<usize>(x)] = static_cast<f32>(sum);
+        }
+    }
+    return dst;
+}
+
+// Asymmetric, non-separable kernel: catches flipped or transposed paths
+PsfKernel SkewedKernel(u32 size) {
+    std::vector<f32> weights(static_cast<usize>(size) * size);
+    for (u32 y = 0; y < size; ++y) {
+        for (u32 x = 0; x < size; ++x) {
+            weights[y * size + x] = 1.0f + static_cast<f32>((x * 3 + y * y) % 7) + (x > y ? 4.0f : 0.0f);
+        }
+    }
+    return PsfKernel::FromWeights(size, size, std::move(weights));
+}
+
+void ExpectBandsNear(const std::vector<f32>& actual, const std::vector<f32>& expected, f32 tolerance) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (usize i = 0; i < actual.size(); ++i) {
+        ASSERT_NEAR(actual[i], expected[i], tolerance) << "pixel " << i;
+    }
+}
+
+} // namespace
+
+TEST(PsfConvolutionTest, KernelsAreNormalised) {
+    const PsfKernel gaussian = PsfKernel::Gaussian(1.5f, 0.7f);
+    ASSERT_TRUE(gaussian.IsValid());
+    EXPECT_TRUE(gaussian.IsSeparable());
+    EXPECT_EQ(gaussian.width, 2 * 5 + 1u);   // ceil(3 * 1.5)
+    EXPECT_EQ(gaussian.height, 2 * 3 + 1u);  // ceil(3 * 0.7)
+    EXPECT_NEAR(std::accumulate(gaussian.weights.begin(), gaussian.weights.end(), 0.0), 1.0, 1e-5);
+
+    const PsfKernel airy = PsfKernel::Airy(550.0f, 4.0f, 2.0f);
+    ASSERT_TRUE(airy.IsValid());
+    EXPECT_NEAR(std::accumulate(airy.weights.begin(), airy.weights.end(), 0.0), 1.0, 1e-5);
+    const f32 peak = airy.weights[airy.weights.size() / 2];
+    EXPECT_EQ(peak, *std::max_element(airy.weights.begin(), airy.weights.end()));
+    // Point symmetric
+    for (usize i = 0; i < airy.weights.size(); ++i) {
+        EXPECT_NEAR(airy.weights[i], airy.weights[airy.weights.size() - 1 - i], 1e-6f);
+    }
+
+    EXPECT_FALSE(SkewedKernel(5).IsSeparable());
+    EXPECT_FALSE(PsfKernel::FromWeights(4, 3, std::vector<f32>(12, 1.0f)).IsValid());
+}
+
+TEST(PsfConvolutionTest, ChoosesMethodByKernel) {
+    EXPECT_EQ(PsfConvolution::ChooseMethod(PsfKernel::Gaussian(4.0f, 4.0f)), ConvolutionMethod::Separable);
+    EXPECT_EQ(PsfConvolution::ChooseMethod(SkewedKernel(5)), ConvolutionMethod::Direct);
+    EXPECT_EQ(PsfConvolution::ChooseMethod(SkewedKernel(15)), ConvolutionMethod::Fft);
+}
+
+TEST(PsfConvolutionTest, AllPathsMatchReference) {
+    constexpr u32 kWidth = 37;
+    constexpr u32 kHeight = 23;
+    const std::vector<f32> src = RandomBand(kWidth, kHeight, 11);
+
+    struct Case {
+        PsfKernel kernel;
+        std::vector<ConvolutionMethod> methods;
+    };
+    const Case cases[] = {
+        {PsfKernel::Gaussian(1.2f, 2.0f),
+         {ConvolutionMethod::Separable, ConvolutionMethod::Direct, ConvolutionMethod::Fft}},
+        {SkewedKernel(5), {ConvolutionMethod::Direct, ConvolutionMethod::Fft}},
+        // Larger than the image: every tap reaches into the replicated border
+        {SkewedKernel(29), {ConvolutionMethod::Direct, ConvolutionMethod::Fft}},
+    };
+
+    for (const Case& c : cases) {
+        const std::vector<f32> expected = ReferenceConvolve(src, kWidth, kHeight, c.kernel);
+        for (ConvolutionMethod method : c.methods) {
+            for (bool parallel : {false, true}) {
+                SCOPED_TRACE(testing::Message() << "kernel " << c.kernel.width << "x" << c.kernel.height
+                                                << " method " << static_cast<u32>(method)
+                                                << " parallel " << parallel);
+                std::vector<f32> dst(src.size());
+                PsfConvolution::ConvolveBand(src.data(), dst.data(), kWidth, kHeight, c.kernel, method, parallel);
+                ExpectBandsNear(dst, expected, 2e-5f);
+            }
+        }
+    }
+}
+
+TEST(PsfConvolutionTest, ImpulseResponseIsKernel) {
+    constexpr u32 kSize = 16;
+    std::vector<f32> src(kSize * kSize, 0.0f);
+    src[8 * kSize + 8] = 1.0f;
+    const PsfKernel kernel = SkewedKernel(5);
+
+    std::vector<f32> dst(src.size());
+    PsfConvolution::ConvolveBand(src.data(), dst.data(), kSize, kSize, kernel, ConvolutionMethod::Fft);
+    for (u32 j = 0; j < 5; ++j) {
+        for (u32 i = 0; i < 5; ++i) {
+            EXPECT_NEAR(dst[(8 + j - 2) * kSize + (8 + i - 2)], kernel.weights[j * 5 + i], 1e-6f);
+        }
+    }
+}
+
+TEST(PsfConvolutionTest, MtfFiltersFrequencies) {
+    constexpr u32 kSize = 32;
+    const std::vector<f32> src = RandomBand(kSize, kSize, 5);
+
+    // Unit MTF leaves the band unchanged
+    std::vector<f32> band = src;
+    PsfConvolution::ApplyMtf(band.data(), kSize, kSize, [](f32, f32) { return 1.0f; });
+    ExpectBandsNear(band, src, 1e-5f);
+
+    // Keeping only DC flattens the band (to the mean of the padded grid)
+    band = src;
+    PsfConvolution::ApplyMtf(band.data(), kSize, kSize,
+                             [](f32 fx, f32 fy) { return (fx == 0.0f && fy == 0.0f) ? 1.0f : 0.0f; });
+    for (f32 v : band) {
+        EXPECT_NEAR(v, band[0], 1e-5f);
+    }
+
+    // The MTF of a Gaussian PSF blurs like the (untruncated) spatial kernel
+    constexpr f32 kSigma = 1.0f;
+    band = src;
+    PsfConvolution::ApplyMtf(band.data(), kSize, kSize, [](f32 fx, f32 fy) {
+        const f32 twoPiSigma = 2.0f * std::numbers::pi_v<f32> * kSigma;
+        return std::exp(-0.5f * twoPiSigma * twoPiSigma * (fx * fx + fy * fy));
+    });
+    ExpectBandsNear(band, ReferenceConvolve(src, kSize, kSize, PsfKernel::Gaussian(kSigma, kSigma, 6.0f)), 2e-3f);
+}
+
+TEST(PsfConvolutionTest, AppliesPerBandKernels) {
+    SpectralCube cube(12, 10, 3, 400.0f, 600.0f);
+    for (u32 b = 0; b < cube.nbands; ++b) {
+        const std::vector<f32> band = RandomBand(cube.width, cube.height, b);
+        std::copy(band.begin(), band.end(), cube.BandPtr(b));
+    }
+    const SpectralCube original = cube;
+    const std::vector<PsfKernel> kernels = {PsfKernel::Gaussian(0.8f, 0.8f), SkewedKernel(3),
+                                            PsfKernel::Gaussian(2.0f, 1.0f)};
+
+    ASSERT_TRUE(PsfConvolution::Apply(cube, kernels));
+    for (u32 b = 0; b < cube.nbands; ++b) {
+        const std::vector<f32> src(original.BandPtr(b), original.BandPtr(b) + original.PixelsPerBand());
+        const std::vector<f32> dst(cube.BandPtr(b), cube.BandPtr(b) + cube.PixelsPerBand());
+        ExpectBandsNear(dst, ReferenceConvolve(src, cube.width, cube.height, kernels[b]), 2e-5f);
+    }
+
+    // Neither one kernel per band nor a shared kernel
+    EXPECT_FALSE(PsfConvolution::Apply(cube, {kernels[0], kernels[1]}));
+}
@@ -0,0 +1,272 @@
+// ============================================================================
+// SensorNoise tests: radiometry, noise statistics, ADC and reproducibility
+// ============================================================================
+// The expected electron count is recomputed here from the documented
+// formula; noise is checked statistically over flat bands (moments against
+// the Poisson / Gaussian model), and outputs must not depend on how bands
+// are chunked or streamed.
+// ============================================================================
+
+#include "postprocess/SensorNoise.hpp"
+
+#include <gtest/gtest.h>
+
+#include <H5Cpp.h>
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+constexpr u32 kWidth = 128;
+constexpr u32 kHeight = 128;
+
+// Photo-electrons per unit radiance for one band (SensorNoise.hpp formula)
+f64 ElectronsPerRadiance(const SensorParameters& params, f64 wavelengthNm, f64 bandwidthNm) {
+    const f64 pitch = params.pixelPitchUm * 1e-6;
+    const f64 etendue = pitch * pitch * std::numbers::pi / (1.0 + 4.0 * params.fNumber * params.fNumber);
+    const f64 energy = bandwidthNm * etendue * params.opticsTransmission * params.integrationTimeS;
+    const f64 photonsPerJoule = wavelengthNm * 1e-9 / (6.62607015e-34 * 299792458.0);
+    return energy * photonsPerJoule * params.QuantumEfficiencyAt(static_cast<f32>(wavelengthNm));
+}
+
+// Two-band cube (550 and 560 nm, 10 nm wide) whose pixels all expect the given electrons
+SpectralCube FlatCube(const SensorParameters& params, f64 electrons) {
+    SpectralCube cube(kWidth, kHeight, 2, 550.0f, 560.0f);
+    for (u32 b = 0; b < cube.nbands; ++b) {
+        const f32 radiance = static_cast<f32>(electrons / ElectronsPerRadiance(params, cube.wavelengths[b], 10.0));
+        std::fill(cube.BandPtr(b), cube.BandPtr(b) + cube.PixelsPerBand(), radiance);
+    }
+    return cube;
+}
+
+struct Moments {
+    f64 mean = 0.0;
+    f64 variance = 0.0;
+};
+
+Moments ComputeMoments(const std::vector<u16>& counts) {
+    Moments m;
+    for (u16 c : counts) {
+        m.mean += c;
+    }
+    m.mean /= static_cast<f64>(counts.size());
+    for (u16 c : counts) {
+        m.variance += (c - m.mean) * (c - m.mean);
+    }
+    m.variance /= static_cast<f64>(counts.size() - 1);
+    return m;
+}
+
+// 1 e-/DN with headroom, no noise sources unless a test enables them
+SensorParameters UnitGain() {
+    SensorParameters params;
+    params.conversionGain = 1.0f;
+    params.adcBits = 16;
+    params.fullWellElectrons = 60000.0f;
+    params.shotNoise = false;
+    params.seed = 42;
+    return params;
+}
+
+} // namespace
+
+TEST(SensorNoiseTest, Parameters) {
+    SensorParameters params;
+    params.qeWavelengthsNm = {400.0f, 500.0f, 700.0f};
+    params.qeCurve = {0.2f, 0.6f, 0.4f};
+    EXPECT_FLOAT_EQ(params.QuantumEfficiencyAt(300.0f), 0.2f);
+    EXPECT_FLOAT_EQ(params.QuantumEfficiencyAt(450.0f), 0.4f);
+    EXPECT_FLOAT_EQ(params.QuantumEfficiencyAt(650.0f), 0.45f);
+    EXPECT_FLOAT_EQ(params.QuantumEfficiencyAt(900.0f), 0.4f);
+
+    // Default gain spans the ADC range with the full well
+    params.adcBits = 12;
+    params.fullWellElectrons = 4095.0f * 5.0f;
+    EXPECT_EQ(params.MaxDn(), 4095);
+    EXPECT_FLOAT_EQ(params.ElectronsPerDn(), 5.0f);
+
+    EXPECT_TRUE(params.IsValid(4, 4));
+    params.prnu.assign(15, 1.0f);
+    EXPECT_FALSE(params.IsValid(4, 4));
+    params.prnu.clear();
+    params.adcBits = 17;
+    EXPECT_FALSE(params.IsValid(4, 4));
+}
+
+TEST(SensorNoiseTest, NoiselessSignalFollowsRadiometry) {
+    SensorParameters params = UnitGain();
+    params.offsetDn = 10.0f;
+    params.darkCurrentElectronsPerS = 2000.0f;  // 20 e- over 10 ms
+
+    const SpectralCube cube = FlatCube(params, 1234.0);
+    std::vector<u16> counts;
+    ASSERT_TRUE(SensorNoise::Apply(cube, params, counts));
+    ASSERT_EQ(counts.size(), cube.data.size());
+    for (u16 c : counts) {
+        ASSERT_NEAR(c, 1234 + 20 + 10, 1);
+    }
+
+    // Explicit band width scales the signal
+    params.bandwidthNm = 20.0f;
+    params.darkCurrentElectronsPerS = 0.0f;
+    params.offsetDn = 0.0f;
+    ASSERT_TRUE(SensorNoise::Apply(cube, params, counts));
+    EXPECT_NEAR(counts[0], 2468, 1);
+
+    // A single band has no spacing to take the width from
+    SpectralCube single(4, 4, 1, 550.0f, 560.0f);
+    single.wavelengths[0] = 550.0f;
+    params.bandwidthNm = 0.0f;
+    EXPECT_FALSE(SensorNoise::Apply(single, params, counts));
+    params.bandwidthNm = 10.0f;
+    EXPECT_TRUE(SensorNoise::Apply(single, params, counts));
+}
+
+TEST(SensorNoiseTest, ShotNoiseIsPoisson) {
+    // Below the threshold (exact Poisson) and above it (normal approximation)
+    for (f64 electrons : {4.0, 20.0, 400.0}) {
+        SensorParameters params = UnitGain();
+        params.shotNoise = true;
+        std::vector<u16> counts;
+        ASSERT_TRUE(SensorNoise::Apply(FlatCube(params, electrons), params, counts));
+
+        const Moments m = ComputeMoments(counts);
+        const f64 n = static_cast<f64>(counts.size());
+        // Rounding the normal approximation to DN adds 1/12 of variance
+        const f64 expectedVariance = electrons + (electrons >= SensorNoise::POISSON_NORMAL_THRESHOLD ? 1.0 / 12.0 : 0.0);
+        EXPECT_NEAR(m.mean, electrons, 4.0 * std::sqrt(electrons / n)) << electrons << " e-";
+        EXPECT_NEAR(m.variance, expectedVariance, 4.0 * expectedVariance * std::sqrt(2.0 / n) + 0.05) << electrons << " e-";
+    }
+}
+
+TEST(SensorNoiseTest, ReadNoiseIsGaussian) {
+    SensorParameters params = UnitGain();
+    params.readNoiseElectrons = 3.0f;
+    params.offsetDn = 100.0f;
+    std::vector<u16> counts;
+    ASSERT_TRUE(SensorNoise::Apply(FlatCube(params, 500.0), params, counts));
+
+    const Moments m = ComputeMoments(counts);
+    const f64 n = static_cast<f64>(counts.size());
+    EXPECT_NEAR(m.mean, 600.0, 4.0 * 3.0 / std::sqrt(n));
+    EXPECT_NEAR(m.variance, 9.0 + 1.0 / 12.0, 4.0 * 9.0 * std::sqrt(2.0 / n));
+}
+
+TEST(SensorNoiseTest, SaturatesAtFullWellAndAdcRange) {
+    SensorParameters params = UnitGain();
+    params.fullWellElectrons = 1000.0f;
+    std::vector<u16> counts;
+    ASSERT_TRUE(SensorNoise::Apply(FlatCube(params, 5000.0), params, counts));
+    for (u16 c : counts) {
+        ASSERT_EQ(c, 1000);
+    }
+
+    // 8-bit ADC clips first
+    params.adcBits = 8;
+    ASSERT_TRUE(SensorNoise::Apply(FlatCube(params, 5000.0), params, counts));
+    for (u16 c : counts) {
+        ASSERT_EQ(c, 255);
+    }
+
+    // ProcessBands reports every sample as saturated
+    const SpectralCube cube = FlatCube(params, 5000.0);
+    const u64 saturated = SensorNoise::ProcessBands(cube.data.data(), kWidth, kHeight, 0, cube.nbands,
+                                                    cube.wavelengths.data(), 10.0f, params, counts.data());
+    EXPECT_EQ(saturated, static_cast<u64>(cube.TotalElements()));
+}
+
+TEST(SensorNoiseTest, NoiseDependsOnlyOnSeedPixelAndBand) {
+    SensorParameters params = UnitGain();
+    params.shotNoise = true;
+    params.readNoiseElectrons = 2.0f;
+    params.offsetDn = 20.0f;
+
+    SpectralCube cube(kWidth, kHeight, 6, 500.0f, 550.0f);
+    for (usize i = 0; i < cube.data.size(); ++i) {
+        cube.data[i] = static_cast<f32>(i % 97) * 1e-4f;
+    }
+
+    std::vector<u16> whole;
+    ASSERT_TRUE(SensorNoise::Apply(cube, params, whole));
+
+    // Same bands converted in chunks of 4 + 2
+    std::vector<u16> chunked(whole.size());
+    const usize pixels = cube.PixelsPerBand();
+    SensorNoise::ProcessBands(cube.BandPtr(0), kWidth, kHeight, 0, 4, cube.wavelengths.data(),
+                              cube.delta_lambda, params, chunked.data());
+    SensorNoise::ProcessBands(cube.BandPtr(4), kWidth, kHeight, 4, 2, cube.wavelengths.data() + 4,
+                              cube.delta_lambda, params, chunked.data() + 4 * pixels);
+    EXPECT_EQ(chunked, whole);
+
+    std::vector<u16> again;
+    ASSERT_TRUE(SensorNoise::Apply(cube, params, again));
+    EXPECT_EQ(again, whole);
+
+    params.seed = 43;
+    ASSERT_TRUE(SensorNoise::Apply(cube, params, again));
+    EXPECT_NE(again, whole);
+}
+
+TEST(SensorNoiseTest, StreamedHdf5MatchesInMemory) {
+    const auto dir = std::filesystem::temp_directory_path() / "ql_sensor_noise_stream";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string inputPath = (dir / "radiance.h5").string();
+    const std::string outputPath = (dir / "counts.h5").string();
+
+    SpectralCube cube(32, 16, 5, 500.0f, 540.0f);
+    for (usize i = 0; i < cube.data.size(); ++i) {
+        cube.data[i] = static_cast<f32>(i % 53) * 2e-4f;
+    }
+    {
+        H5::H5File file(inputPath, H5F_ACC_TRUNC);
+        hsize_t dims[3] = {cube.nbands, cube.height, cube.width};
+        file.createDataSet("/data", H5::PredType::NATIVE_FLOAT, H5::DataSpace(3, dims))
+            .write(cube.data.data(), H5::PredType::NATIVE_FLOAT);
+        hsize_t waveDims[1] = {cube.nbands};
+        file.createDataSet("/wavelengths", H5::PredType::NATIVE_FLOAT, H5::DataSpace(1, waveDims))
+            .write(cube.wavelengths.data(), H5::PredType::NATIVE_FLOAT);
+    }
+
+    SensorParameters params = UnitGain();
+    params.shotNoise = true;
+    params.readNoiseElectrons = 1.5f;
+    std::vector<u16> expected;
+    ASSERT_TRUE(SensorNoise::Apply(cube, params, expected));
+
+    // Chunks that do not divide the band count
+    ASSERT_TRUE(SensorNoise::ProcessHDF5(inputPath, outputPath, params, 2));
+    std::vector<u16> streamed(expected.size());
+    {
+        H5::H5File file(outputPath, H5F_ACC_RDONLY);
+        file.openDataSet("/counts").read(streamed.data(), H5::PredType::NATIVE_UINT16);
+    }
+    EXPECT_EQ(streamed, expected);
+
+    EXPECT_FALSE(SensorNoise::ProcessHDF5((dir / "missing.h5").string(), outputPath, params));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(SensorNoiseTest, NonUniformityMap) {
+    const std::vector<f32> map = SensorNoise::MakeNonUniformityMap(kWidth, kHeight, 0.02f, 7);
+    ASSERT_EQ(map.size(), static_cast<usize>(kWidth) * kHeight);
+    f64 mean = 0.0;
+    for (f32 v : map) {
+        mean += v;
+    }
+    mean /= static_cast<f64>(map.size());
+    f64 variance = 0.0;
+    for (f32 v : map) {
+        variance += (v - mean) * (v - mean);
+    }
+    variance /= static_cast<f64>(map.size() - 1);
+    EXPECT_NEAR(mean, 1.0, 0.001);
+    EXPECT_NEAR(std::sqrt(variance), 0.02, 0.001);
+
+    EXPECT_EQ(SensorNoise::MakeNonUniformityMap(kWidth, kHeight, 0.02f, 7), map);
+    EXPECT_NE(SensorNoise::MakeNonUniformityMap(kWidth, kHeight, 0.02f, 8), map);
+}
@@ -0,0 +1,180 @@
+// ============================================================================
+// SpectralPreview tests: spectral integration, colour spaces, exposure
+// ============================================================================
+// A flat spectrum of value L must give Y = L, a single band must give the
+// colour matching functions at that wavelength, and the cube and band-image
+// kernels must agree.
+// ============================================================================
+
+#include "postprocess/SpectralPreview.hpp"
+#include "core/Color.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+// 5 nm grid over 360-830 nm with a spatially varying, smooth spectrum
+SpectralCube MakeCube(u32 width, u32 height) {
+    SpectralCube cube(width, height, 95, 360.0f, 830.0f);
+    for (u32 b = 0; b < cube.nbands; ++b) {
+        const f32 t = static_cast<f32>(b) / static_cast<f32>(cube.nbands - 1);
+        for (u32 y = 0; y < height; ++y) {
+            for (u32 x = 0; x < width; ++x) {
+                cube(x, y, b) = 0.5f + 0.4f * std::sin(6.0f * t + 0.1f * static_cast<f32>(x + 3 * y));
+            }
+        }
+    }
+    return cube;
+}
+
+// The same cube as a band image (one channel per wavelength)
+Image ToBandImage(const SpectralCube& cube) {
+    Image image(cube.width, cube.height, cube.nbands);
+    for (u32 y = 0; y < cube.height; ++y) {
+        for (u32 x = 0; x < cube.width; ++x) {
+            for (u32 b = 0; b < cube.nbands; ++b) {
+                image(x, y, b) = cube(x, y, b);
+            }
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+TEST(SpectralPreviewTest, FlatSpectrumHasUnitLuminance) {
+    SpectralCube cube(4, 4, 95, 360.0f, 830.0f);
+    std::fill(cube.data.begin(), cube.data.end(), 2.5f);
+
+    PreviewSettings settings;
+    settings.colorSpace = PreviewColorSpace::Xyz;
+    const Image xyz = SpectralPreview::Convert(cube, settings);
+    ASSERT_EQ(xyz.channels, 3u);
+    EXPECT_EQ(xyz.channelNames, (std::vector<std::string>{"X", "Y", "Z"}));
+    EXPECT_EQ(xyz.metadata.at("preview_color_space"), "xyz");
+    for (u32 p = 0; p < xyz.PixelCount(); ++p) {
+        EXPECT_NEAR(xyz.data[p * 3 + 1], 2.5f, 0.01f);
+        // Equal-energy white: X = Y = Z up to the fitted CMFs
+        EXPECT_NEAR(xyz.data[p * 3 + 0], 2.5f, 0.05f);
+        EXPECT_NEAR(xyz.data[p * 3 + 2], 2.5f, 0.05f);
+    }
+}
+
+TEST(SpectralPreviewTest, SingleBandIsColourMatchingFunction) {
+    const std::vector<f32> wavelengths = {550.0f};
+    const std::vector<f32> weights = SpectralPreview::ComputeWeights(wavelengths, PreviewColorSpace::Xyz);
+    ASSERT_EQ(weights.size(), 3u);
+    const glm::vec3 cmf = CieColorMatching(550.0f);
+    // Ratios do not depend on the normalisation
+    EXPECT_NEAR(weights[0] / weights[1], cmf.x / cmf.y, 1e-5f);
+    EXPECT_NEAR(weights[2] / weights[1], cmf.z / cmf.y, 1e-5f);
+
+    // Far outside the visible range a band contributes nothing
+    const std::vector<f32> infrared = SpectralPreview::ComputeWeights({1000.0f, 1010.0f}, PreviewColorSpace::Xyz);
+    for (f32 w : infrared) {
+        EXPECT_NEAR(w, 0.0f, 1e-6f);
+    }
+}
+
+TEST(SpectralPreviewTest, ColourSpacesAreMatricesOfXyz) {
+    const SpectralCube cube = MakeCube(8, 5);
+    PreviewSettings settings;
+    settings.colorSpace = PreviewColorSpace::Xyz;
+    const Image xyz = SpectralPreview::Convert(cube, settings);
+    settings.colorSpace = PreviewColorSpace::LinearSrgb;
+    const Image srgb = SpectralPreview::Convert(cube, settings);
+    settings.colorSpace = PreviewColorSpace::AcesCg;
+    const Image aces = SpectralPreview::Convert(cube, settings);
+    EXPECT_EQ(srgb.channelNames, (std::vector<std::string>{"R", "G", "B"}));
+
+    for (u32 p = 0; p < xyz.PixelCount(); ++p) {
+        const glm::vec3 v(xyz.data[p * 3 + 0], xyz.data[p * 3 + 1], xyz.data[p * 3 + 2]);
+        const glm::vec3 expectedSrgb = XyzToLinearSrgb(v);
+        const glm::vec3 expectedAces = XyzToAcesCg(v);
+        for (u32 c = 0; c < 3; ++c) {
+            EXPECT_NEAR(srgb.data[p * 3 + c], expectedSrgb[static_cast<glm::length_t>(c)], 1e-5f);
+            EXPECT_NEAR(aces.data[p * 3 + c], expectedAces[static_cast<glm::length_t>(c)], 1e-5f);
+        }
+    }
+}
+
+TEST(SpectralPreviewTest, CubeAndBandImageAgree) {
+    // More pixels than one kernel block, with a partial last block
+    const SpectralCube cube = MakeCube(40, 30);
+    const Image bands = ToBandImage(cube);
+
+    PreviewSettings settings;
+    settings.exposure = -0.5f;
+    const Image fromCube = SpectralPreview::Convert(cube, settings);
+    const Image fromBands = SpectralPreview::Convert(bands, cube.wavelengths, settings);
+    ASSERT_EQ(fromCube.data.size(), fromBands.data.size());
+    for (usize i = 0; i < fromCube.data.size(); ++i) {
+        ASSERT_NEAR(fromCube.data[i], fromBands.data[i], 1e-5f) << i;
+    }
+
+    // More wavelengths than channels
+    const std::vector<f32> tooMany(bands.channels + 1, 500.0f);
+    EXPECT_FALSE(SpectralPreview::Convert(bands, tooMany).IsValid());
+}
+
+TEST(SpectralPreviewTest, ExposureScalesLinearly) {
+    const SpectralCube cube = MakeCube(6, 6);
+    PreviewSettings settings;
+    settings.colorSpace = PreviewColorSpace::Xyz;
+    const Image base = SpectralPreview::Convert(cube, settings);
+    settings.exposure = 1.0f;
+    const Image brighter = SpectralPreview::Convert(cube, settings);
+    for (usize i = 0; i < base.data.size(); ++i) {
+        EXPECT_NEAR(brighter.data[i], 2.0f * base.data[i], 1e-5f);
+    }
+
+    // Auto exposure brings the mean luminance to middle grey, then applies EV
+    settings.exposure = 0.0f;
+    settings.autoExposure = true;
+    const Image automatic = SpectralPreview::Convert(cube, settings);
+    f64 meanY = 0.0;
+    for (u32 p = 0; p < automatic.PixelCount(); ++p) {
+        meanY += automatic.data[p * 3 + 1];
+    }
+    EXPECT_NEAR(meanY / automatic.PixelCount(), 0.18, 1e-4);
+}
+
+TEST(SpectralPreviewTest, Tonemaps) {
+    SpectralCube cube(3, 1, 95, 360.0f, 830.0f);
+    const f32 levels[] = {0.0f, 1.0f, 100.0f};
+    for (u32 x = 0; x < 3; ++x) {
+        for (u32 b = 0; b < cube.nbands; ++b) {
+            cube(x, 0, b) = levels[x];
+        }
+    }
+
+    PreviewSettings settings;
+    settings.colorSpace = PreviewColorSpace::Xyz;
+    settings.tonemap = PreviewTonemap::Reinhard;
+    const Image reinhard = SpectralPreview::Convert(cube, settings);
+    EXPECT_NEAR(reinhard.data[0 * 3 + 1], 0.0f, 1e-6f);
+    EXPECT_NEAR(reinhard.data[1 * 3 + 1], 0.5f, 0.005f);
+    EXPECT_NEAR(reinhard.data[2 * 3 + 1], 100.0f / 101.0f, 0.001f);
+
+    settings.tonemap = PreviewTonemap::Aces;
+    const Image aces = SpectralPreview::Convert(cube, settings);
+    EXPECT_NEAR(aces.data[0 * 3 + 1], 0.0f, 1e-6f);
+    EXPECT_GT(aces.data[1 * 3 + 1], 0.7f);
+    EXPECT_LT(aces.data[1 * 3 + 1], aces.data[2 * 3 + 1]);
+    EXPECT_LE(aces.data[2 * 3 + 1], 1.0f);
+}
+
+TEST(SpectralPreviewTest, ParsesSettings) {
+    EXPECT_EQ(PreviewSettings::ParseColorSpace("srgb"), PreviewColorSpace::LinearSrgb);
+    EXPECT_EQ(PreviewSettings::ParseColorSpace("acescg"), PreviewColorSpace::AcesCg);
+    EXPECT_EQ(PreviewSettings::ParseColorSpace("xyz"), PreviewColorSpace::Xyz);
+    EXPECT_EQ(PreviewSettings::ParseColorSpace("p3"), PreviewColorSpace::LinearSrgb);
+    EXPECT_EQ(PreviewSettings::ParseTonemap("reinhard"), PreviewTonemap::Reinhard);
+    EXPECT_EQ(PreviewSettings::ParseTonemap("aces"), PreviewTonemap::Aces);
+    EXPECT_EQ(PreviewSettings::ParseTonemap("filmic"), PreviewTonemap::None);
+}
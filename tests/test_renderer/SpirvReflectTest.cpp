@@ -0,0 +1,104 @@
+// ============================================================================
+// SpirvReflection tests: bindings and structured buffer strides
+// ============================================================================
+
+#include "renderer/SpirvReflect.hpp"
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+
+using namespace quantiloom;
+
+namespace {
+
+// Hand-assembled module shaped like DXC output for
+//   [[vk::binding(0, 0)]] RWTexture2D<float4> output;          (used)
+//   [[vk::binding(5, 0)]] StructuredBuffer<MaterialData> mats; (used, 112 B)
+//   [[vk::binding(3, 0)]] StructuredBuffer<float3> unused;     (not in interface)
+class ModuleBuilder {
+public:
+    explicit ModuleBuilder(u32 version) : m_words{0x07230203, version, 0, 100, 0} {}
+
+    void Op(u32 opcode, std::initializer_list<u32> operands) {
+        m_words.push_back((static_cast<u32>(operands.size() + 1) << 16) | opcode);
+        m_words.insert(m_words.end(), operands);
+    }
+
+    std::vector<u32>& Words() { return m_words; }
+
+private:
+    std::vector<u32> m_words;
+};
+
+constexpr u32 kMain = 0x6E69616D;  // "main" (nul terminator in the next word)
+
+std::vector<u32> MakeModule(u32 version) {
+    ModuleBuilder m(version);
+    m.Op(15, {5313, 1, kMain, 0, 10, 11});     // OpEntryPoint RayGenerationKHR %1 "main" %10 %11
+    m.Op(71, {10, 34, 0});                     // OpDecorate %10 DescriptorSet 0
+    m.Op(71, {10, 33, 5});                     // OpDecorate %10 Binding 5
+    m.Op(71, {11, 34, 0});
+    m.Op(71, {11, 33, 0});
+    m.Op(71, {12, 34, 0});
+    m.Op(71, {12, 33, 3});
+    m.Op(71, {20, 6, 112});                    // OpDecorate %20 ArrayStride 112
+    m.Op(71, {24, 6, 12});
+    m.Op(29, {20, 31});                        // %20 = OpTypeRuntimeArray %31
+    m.Op(30, {21, 20});                        // %21 = OpTypeStruct %20
+    m.Op(32, {22, 12, 21});                    // %22 = OpTypePointer StorageBuffer %21
+    m.Op(32, {23, 0, 40});                     // %23 = OpTypePointer UniformConstant %40 (image)
+    m.Op(29, {24, 32});
+    m.Op(30, {25, 24});
+    m.Op(32, {26, 12, 25});
+    m.Op(59, {22, 10, 12});                    // %10 = OpVariable %22 StorageBuffer
+    m.Op(59, {23, 11, 0});                     // %11 = OpVariable %23 UniformConstant
+    m.Op(59, {26, 12, 12});                    // %12 = OpVariable %26 StorageBuffer
+    return m.Words();
+}
+
+} // namespace
+
+TEST(SpirvReflectTest, ReportsBindingsUsedByEntryPoints) {
+    auto result = SpirvReflection::Parse(MakeModule(0x00010600));
+    ASSERT_TRUE(result.has_value()) << result.error();
+    const SpirvReflection& reflection = result.value();
+
+    ASSERT_EQ(reflection.GetBindings().size(), 2u);
+    EXPECT_EQ(reflection.GetBindings()[0].binding, 0u);
+    EXPECT_EQ(reflection.GetBindings()[1].binding, 5u);
+
+    const SpirvBinding* image = reflection.FindBinding(0, 0);
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->arrayStride, 0u);
+
+    const SpirvBinding* materials = reflection.FindBinding(0, 5);
+    ASSERT_NE(materials, nullptr);
+    EXPECT_EQ(materials->arrayStride, 112u);
+
+    // Declared but unused by the entry point (SPIR-V 1.4+ interface lists all globals)
+    EXPECT_EQ(reflection.FindBinding(0, 3), nullptr);
+    EXPECT_EQ(reflection.FindBinding(1, 5), nullptr);
+}
+
+TEST(SpirvReflectTest, ReportsAllDecoratedVariablesBeforeSpirv14) {
+    auto result = SpirvReflection::Parse(MakeModule(0x00010300));
+    ASSERT_TRUE(result.has_value()) << result.error();
+
+    const SpirvBinding* vertices = result.value().FindBinding(0, 3);
+    ASSERT_NE(vertices, nullptr);
+    EXPECT_EQ(vertices->arrayStride, 12u);
+    EXPECT_EQ(result.value().GetBindings().size(), 3u);
+}
+
+TEST(SpirvReflectTest, RejectsMalformedModules) {
+    std::vector<u32> words = MakeModule(0x00010600);
+    words[0] = 0x12345678;
+    EXPECT_FALSE(SpirvReflection::Parse(words).has_value());
+
+    words = MakeModule(0x00010600);
+    words.pop_back();
+    EXPECT_FALSE(SpirvReflection::Parse(words).has_value());
+
+    EXPECT_FALSE(SpirvReflection::Parse({}).has_value());
+}
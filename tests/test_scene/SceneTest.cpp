@@ -0,0 +1,72 @@
+// ============================================================================
+// Scene tests: geometry allocated from the scene's arena
+// ============================================================================
+// The arena must outlive the meshes in it on destruction and assignment (run
+// under AddressSanitizer to catch a use-after-free; without it a violation
+// may pass silently).
+// ============================================================================
+
+#include "scene/Scene.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace quantiloom;
+
+namespace {
+
+// Scene whose geometry lives in its own arena, as GltfLoader builds it
+Scene MakeArenaScene(u32 meshCount, f32 offset) {
+    Scene scene;
+    scene.geometryArena = std::make_shared<Arena>(1024);
+    for (u32 m = 0; m < meshCount; ++m) {
+        Mesh mesh(scene.GetGeometryResource());
+        GeometryPrimitive& prim = mesh.primitives.emplace_back();
+        for (u32 i = 0; i < 3; ++i) {
+            prim.positions.push_back(glm::vec3(offset + static_cast<f32>(i), 0.0f, 0.0f));
+            prim.indices.push_back(i);
+        }
+        mesh.name = "mesh" + std::to_string(m);
+        scene.meshes.push_back(std::move(mesh));
+    }
+    return scene;
+}
+
+} // namespace
+
+TEST(SceneTest, GeometryIsAllocatedFromTheArena) {
+    Scene scene = MakeArenaScene(4, 0.0f);
+    EXPECT_EQ(scene.meshes[0].primitives[0].positions.get_allocator().resource(), scene.geometryArena.get());
+    EXPECT_GT(scene.geometryArena->BytesUsed(), 0u);
+    EXPECT_EQ(scene.GetTotalVertexCount(), 12u);
+}
+
+TEST(SceneTest, MoveKeepsTheArenaAlive) {
+    Scene moved = MakeArenaScene(4, 0.0f);
+    Arena* arena = moved.geometryArena.get();
+    Scene scene(std::move(moved));
+    EXPECT_EQ(scene.geometryArena.get(), arena);
+    EXPECT_EQ(scene.meshes[3].primitives[0].positions[2].x, 2.0f);
+}
+
+TEST(SceneTest, AssignmentFreesOldMeshesBeforeTheirArena) {
+    Scene scene = MakeArenaScene(4, 0.0f);
+    scene = MakeArenaScene(2, 10.0f);
+    ASSERT_EQ(scene.meshes.size(), 2u);
+    EXPECT_EQ(scene.meshes[1].primitives[0].positions[0].x, 10.0f);
+    EXPECT_EQ(scene.meshes[1].name, "mesh1");
+
+    const Scene other = MakeArenaScene(3, 20.0f);
+    scene = other;
+    ASSERT_EQ(scene.meshes.size(), 3u);
+    EXPECT_EQ(scene.meshes[2].primitives[0].positions[1].x, 21.0f);
+}
+
+TEST(SceneTest, CopyMovesGeometryToTheHeap) {
+    Scene copy;
+    {
+        const Scene scene = MakeArenaScene(2, 0.0f);
+        copy = scene;
+    }
+    EXPECT_EQ(copy.meshes[0].primitives[0].positions.get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy.meshes[1].primitives[0].positions[2].x, 2.0f);
+}
@@ -0,0 +1,117 @@
+// ============================================================================
+// TextureCache tests: restoring mips and BCn blocks, rejecting bad entries
+// ============================================================================
+
+#include "io/TextureCache.hpp"
+#include "scene/TextureCompression.hpp"
+
+#include <gtest/gtest.h>
+
+#include <H5Cpp.h>
+#include <filesystem>
+
+using namespace quantiloom;
+
+namespace {
+
+class TextureCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_dir = std::filesystem::temp_directory_path() / (std::string("ql_texcache_") + info->name());
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+        m_path = (m_dir / "textures.h5").string();
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(m_dir, ec);
+    }
+
+    // 20x12 texture with mips, as the loader prepares it before caching
+    static Texture MakeSource() {
+        Texture texture;
+        texture.width = 20;
+        texture.height = 12;
+        texture.name = "gradient";
+        texture.pixels.resize(20 * 12 * 4);
+        for (usize i = 0; i < texture.pixels.size(); ++i) {
+            texture.pixels[i] = static_cast<u8>(i * 7);
+        }
+        MipGenerator::GenerateMips(texture, MipFilter::Box);
+        return texture;
+    }
+
+    // Replace a dataset of cache entry 0 with `size` zero bytes
+    void ReplaceDataset(const std::string& name, hsize_t size) const {
+        H5::H5File file(m_path, H5F_ACC_RDWR);
+        H5::Group group = file.openGroup("/textures/0");
+        group.unlink(name);
+        H5::DataSpace space(1, &size);
+        std::vector<u8> zeros(size, 0);
+        group.createDataSet(name, H5::PredType::NATIVE_UINT8, space).write(zeros.data(), H5::PredType::NATIVE_UINT8);
+    }
+
+    std::filesystem::path m_dir;
+    std::string m_path;
+};
+
+// Level 0 as it is before loading (no mips, no blocks)
+Texture Unprocessed(const Texture& source) {
+    Texture texture = source;
+    texture.mips.clear();
+    texture.blockLevels.clear();
+    texture.compression = TextureCompression::None;
+    return texture;
+}
+
+} // namespace
+
+TEST_F(TextureCacheTest, RestoresMipsAndBlocks) {
+    Texture source = MakeSource();
+    BcCodec::Compress(source, TextureCompression::BC7);
+    ASSERT_TRUE(TextureCache::Save(m_path, {source}, MipFilter::Box));
+
+    std::vector<Texture> textures = {Unprocessed(source)};
+    EXPECT_EQ(TextureCache::Load(m_path, textures, MipFilter::Box), 1u);
+    const Texture& texture = textures[0];
+    ASSERT_EQ(texture.GetMipCount(), source.GetMipCount());
+    EXPECT_EQ(texture.mips.back().pixels, source.mips.back().pixels);
+    ASSERT_TRUE(texture.IsCompressed());
+    EXPECT_EQ(texture.compression, TextureCompression::BC7);
+    for (u32 level = 0; level < texture.GetMipCount(); ++level) {
+        EXPECT_EQ(texture.blockLevels[level].blocks, source.blockLevels[level].blocks);
+    }
+
+    // Another mip filter is another key
+    textures = {Unprocessed(source)};
+    EXPECT_EQ(TextureCache::Load(m_path, textures, MipFilter::Kaiser), 0u);
+}
+
+TEST_F(TextureCacheTest, RejectsTruncatedBlocks) {
+    Texture source = MakeSource();
+    BcCodec::Compress(source, TextureCompression::BC7);
+    ASSERT_TRUE(TextureCache::Save(m_path, {source}, MipFilter::Box));
+
+    // Level 0 is 5x3 blocks of 16 bytes; one block short
+    ReplaceDataset("bc_0", 5 * 3 * 16 - 16);
+    std::vector<Texture> textures = {Unprocessed(source)};
+    EXPECT_EQ(TextureCache::Load(m_path, textures, MipFilter::Box), 0u);
+    EXPECT_FALSE(textures[0].IsCompressed());
+    EXPECT_TRUE(textures[0].mips.empty());
+}
+
+TEST_F(TextureCacheTest, RejectsBlocksOfAnotherFormat) {
+    // BC1 blocks are half the size of the BC7 blocks the entry claims
+    Texture source = MakeSource();
+    BcCodec::Compress(source, TextureCompression::BC7);
+    ASSERT_TRUE(TextureCache::Save(m_path, {source}, MipFilter::Box));
+    Texture bc1 = source;
+    BcCodec::Compress(bc1, TextureCompression::BC1);
+    ReplaceDataset("bc_1", bc1.blockLevels[1].blocks.size());
+
+    std::vector<Texture> textures = {Unprocessed(source)};
+    EXPECT_EQ(TextureCache::Load(m_path, textures, MipFilter::Box), 0u);
+    EXPECT_FALSE(textures[0].IsCompressed());
+}
@@ -0,0 +1,173 @@
+// ============================================================================
+// BcCodec tests: BC1/BC4/BC5/BC7 encode -> decode round trips
+// ============================================================================
+// Each format is checked on smooth content (gradients, the common case for
+// block compression) against a per-channel error bound, and on flat blocks,
+// which every format must reproduce (nearly) exactly.
+// ============================================================================
+
+#include "scene/TextureCompression.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+// 18x10 texels: partial blocks on the right and bottom edges
+constexpr u32 kWidth = 18;
+constexpr u32 kHeight = 10;
+
+Texture MakeTexture(TextureUsage usage, u32 channels, auto&& texel) {
+    Texture texture;
+    texture.width = kWidth;
+    texture.height = kHeight;
+    texture.channels = channels;
+    texture.usage = usage;
+    texture.pixels.resize(static_cast<usize>(kWidth) * kHeight * channels);
+    for (u32 y = 0; y < kHeight; ++y) {
+        for (u32 x = 0; x < kWidth; ++x) {
+            texel(x, y, &texture.pixels[(static_cast<usize>(y) * kWidth + x) * channels]);
+        }
+    }
+    return texture;
+}
+
+// Colour ramp: every texel on one line through RGB space, the case a
+// single-subset format (BC1, BC7 mode 6) represents best
+Texture MakeRamp(u32 alpha = 255) {
+    return MakeTexture(TextureUsage::Color, 4, [alpha](u32 x, u32 y, u8* out) {
+        const u32 t = x * 8 + y * 5;
+        out[0] = static_cast<u8>(20 + t);
+        out[1] = static_cast<u8>(230 - t / 2);
+        out[2] = static_cast<u8>(60 + t / 4);
+        out[3] = static_cast<u8>(alpha == 255 ? 255 : alpha + t / 3);
+    });
+}
+
+// Independent gradients per channel: colours of a block span a plane, and
+// one endpoint line per block leaves an error across it
+Texture MakeGradient() {
+    return MakeTexture(TextureUsage::Color, 4, [](u32 x, u32 y, u8* out) {
+        out[0] = static_cast<u8>(x * 14);
+        out[1] = static_cast<u8>(y * 25);
+        out[2] = static_cast<u8>(200 - x * 5 - y * 3);
+        out[3] = 255;
+    });
+}
+
+struct RoundTripError {
+    i32 max = 0;
+    f64 rms = 0.0;
+};
+
+// Error of the decoded level 0 against the source, over the given channels
+RoundTripError Measure(const Texture& source, TextureCompression format, std::vector<u32> channels) {
+    Texture texture = source;
+    BcCodec::Compress(texture, format);
+    EXPECT_EQ(texture.compression, format);
+    EXPECT_TRUE(texture.IsCompressed());
+    EXPECT_EQ(texture.blockLevels[0].blocks.size(),
+              static_cast<usize>((kWidth + 3) / 4) * ((kHeight + 3) / 4) * BcCodec::GetBlockSize(format));
+
+    const std::vector<u8> decoded = BcCodec::DecodeLevel(texture, 0);
+    EXPECT_EQ(decoded.size(), static_cast<usize>(kWidth) * kHeight * 4);
+
+    RoundTripError error;
+    f64 sumSquared = 0.0;
+    usize count = 0;
+    for (usize i = 0; i < static_cast<usize>(kWidth) * kHeight; ++i) {
+        for (u32 c : channels) {
+            const i32 diff = std::abs(static_cast<i32>(decoded[i * 4 + c]) -
+                                      static_cast<i32>(source.pixels[i * source.channels + c]));
+            error.max = std::max(error.max, diff);
+            sumSquared += static_cast<f64>(diff) * diff;
+            ++count;
+        }
+    }
+    error.rms = std::sqrt(sumSquared / static_cast<f64>(count));
+    return error;
+}
+
+} // namespace
+
+TEST(TextureCompressionTest, Bc1RoundTrip) {
+    // 5:6:5 endpoints and 4 palette entries per block
+    const RoundTripError ramp = Measure(MakeRamp(), TextureCompression::BC1, {0, 1, 2});
+    EXPECT_LE(ramp.max, 10);
+    EXPECT_LE(ramp.rms, 4.0);
+    const RoundTripError gradient = Measure(MakeGradient(), TextureCompression::BC1, {0, 1, 2});
+    EXPECT_LE(gradient.max, 32);
+    EXPECT_LE(gradient.rms, 12.0);
+}
+
+TEST(TextureCompressionTest, Bc4RoundTrip) {
+    // 8-bit endpoints and 8 palette entries: close to lossless on gradients
+    const Texture source = MakeTexture(TextureUsage::Data, 1, [](u32 x, u32 y, u8* out) {
+        out[0] = static_cast<u8>(x * 9 + y * 7);
+    });
+    const RoundTripError error = Measure(source, TextureCompression::BC4, {0});
+    EXPECT_LE(error.max, 6);
+    EXPECT_LE(error.rms, 2.5);
+}
+
+TEST(TextureCompressionTest, Bc5RoundTrip) {
+    // Two independent BC4 channels; the decoder writes B = 0, A = 255
+    const Texture source = MakeTexture(TextureUsage::Normal, 4, [](u32 x, u32 y, u8* out) {
+        out[0] = static_cast<u8>(40 + x * 9);
+        out[1] = static_cast<u8>(230 - y * 17);
+        out[2] = 255;
+        out[3] = 255;
+    });
+    const RoundTripError error = Measure(source, TextureCompression::BC5, {0, 1});
+    EXPECT_LE(error.max, 6);
+    EXPECT_LE(error.rms, 2.5);
+}
+
+TEST(TextureCompressionTest, Bc7RoundTrip) {
+    // Mode 6: 7.7.7.7+P endpoints, 16 palette entries, alpha included
+    const RoundTripError ramp = Measure(MakeRamp(100), TextureCompression::BC7, {0, 1, 2, 3});
+    EXPECT_LE(ramp.max, 2);
+    EXPECT_LE(ramp.rms, 1.0);
+    const RoundTripError gradient = Measure(MakeGradient(), TextureCompression::BC7, {0, 1, 2, 3});
+    EXPECT_LE(gradient.max, 28);
+    EXPECT_LE(gradient.rms, 10.0);
+}
+
+TEST(TextureCompressionTest, FlatBlocksAreNearlyExact) {
+    const Texture flat = MakeTexture(TextureUsage::Color, 4, [](u32, u32, u8* out) {
+        out[0] = 37;
+        out[1] = 142;
+        out[2] = 201;
+        out[3] = 255;
+    });
+    // BC1 rounds the colour to 5:6:5 (its interpolated entries can land
+    // closer); the others store 7- or 8-bit endpoints
+    EXPECT_LE(Measure(flat, TextureCompression::BC1, {0, 1, 2}).max, 4);
+    EXPECT_LE(Measure(flat, TextureCompression::BC7, {0, 1, 2, 3}).max, 1);
+    EXPECT_EQ(Measure(flat, TextureCompression::BC4, {0}).max, 0);
+    EXPECT_EQ(Measure(flat, TextureCompression::BC5, {0, 1}).max, 0);
+}
+
+TEST(TextureCompressionTest, CompressesEveryMipLevel) {
+    Texture texture = MakeRamp();
+    TextureMip mip;
+    mip.width = kWidth / 2;
+    mip.height = kHeight / 2;
+    mip.pixels.assign(static_cast<usize>(mip.width) * mip.height * 4, 128);
+    texture.mips.push_back(mip);
+
+    BcCodec::Compress(texture, TextureCompression::BC7);
+    ASSERT_EQ(texture.blockLevels.size(), 2u);
+    EXPECT_EQ(texture.blockLevels[1].width, mip.width);
+    EXPECT_EQ(texture.blockLevels[1].blocks.size(), static_cast<usize>(3 * 2 * 16));
+    const std::vector<u8> decoded = BcCodec::DecodeLevel(texture, 1);
+    ASSERT_EQ(decoded.size(), static_cast<usize>(mip.width) * mip.height * 4);
+    for (u8 value : decoded) {
+        EXPECT_NEAR(value, 128, 1);
+    }
+}
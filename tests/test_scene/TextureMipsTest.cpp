@@ -0,0 +1,163 @@
+// ============================================================================
+// MipGenerator tests: chain layout, box/Kaiser filtering, per-usage colour
+// ============================================================================
+// Levels must halve down to 1x1, preserve flat content exactly, average in
+// linear space for sRGB colour textures, and keep normals unit length.
+// ============================================================================
+
+#include "scene/TextureMips.hpp"
+#include "core/Color.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+Texture MakeTexture(u32 width, u32 height, u32 channels, TextureUsage usage, auto&& texel) {
+    Texture texture;
+    texture.width = width;
+    texture.height = height;
+    texture.channels = channels;
+    texture.usage = usage;
+    texture.pixels.resize(static_cast<usize>(width) * height * channels);
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            texel(x, y, &texture.pixels[(static_cast<usize>(y) * width + x) * channels]);
+        }
+    }
+    return texture;
+}
+
+} // namespace
+
+TEST(TextureMipsTest, ComputeMipCount) {
+    EXPECT_EQ(MipGenerator::ComputeMipCount(1, 1), 1u);
+    EXPECT_EQ(MipGenerator::ComputeMipCount(2, 2), 2u);
+    EXPECT_EQ(MipGenerator::ComputeMipCount(256, 1), 9u);
+    EXPECT_EQ(MipGenerator::ComputeMipCount(5, 3), 3u);
+}
+
+TEST(TextureMipsTest, ParseFilter) {
+    EXPECT_EQ(MipGenerator::ParseFilter("kaiser"), MipFilter::Kaiser);
+    EXPECT_EQ(MipGenerator::ParseFilter("box"), MipFilter::Box);
+    EXPECT_EQ(MipGenerator::ParseFilter("lanczos"), MipFilter::Box);
+}
+
+TEST(TextureMipsTest, ChainHalvesDownToOneTexel) {
+    Texture texture = MakeTexture(8, 6, 4, TextureUsage::Data, [](u32, u32, u8* out) {
+        out[0] = out[1] = out[2] = out[3] = 90;
+    });
+    MipGenerator::GenerateMips(texture, MipFilter::Box);
+
+    ASSERT_EQ(texture.GetMipCount(), 4u);
+    const u32 expected[][2] = {{8, 6}, {4, 3}, {2, 1}, {1, 1}};
+    for (u32 level = 0; level < texture.GetMipCount(); ++level) {
+        EXPECT_EQ(texture.GetMipWidth(level), expected[level][0]) << "level " << level;
+        EXPECT_EQ(texture.GetMipHeight(level), expected[level][1]) << "level " << level;
+        EXPECT_EQ(texture.GetMipPixels(level).size(),
+                  static_cast<usize>(expected[level][0]) * expected[level][1] * 4);
+    }
+
+    // A 1x1 texture has no chain
+    Texture single = MakeTexture(1, 1, 4, TextureUsage::Data, [](u32, u32, u8* out) { out[0] = 1; });
+    MipGenerator::GenerateMips(single, MipFilter::Box);
+    EXPECT_TRUE(single.mips.empty());
+}
+
+TEST(TextureMipsTest, BoxAveragesTexelQuads) {
+    // At 2:1 the box kernel covers exactly the 2x2 source quad
+    Texture texture = MakeTexture(4, 4, 1, TextureUsage::Data, [](u32 x, u32 y, u8* out) {
+        out[0] = static_cast<u8>((x + 4 * y) * 16);
+    });
+    MipGenerator::GenerateMips(texture, MipFilter::Box);
+
+    ASSERT_EQ(texture.mips.size(), 2u);
+    const std::vector<u8>& level1 = texture.mips[0].pixels;
+    for (u32 y = 0; y < 2; ++y) {
+        for (u32 x = 0; x < 2; ++x) {
+            // Mean of (x0 + 4 y0) * 16 over the quad
+            const u32 first = 2 * x + 8 * y;
+            const f32 average = static_cast<f32>(first * 4 + 1 + 4 + 5) * 4.0f;
+            EXPECT_NEAR(level1[y * 2 + x], average, 0.5f) << x << ", " << y;
+        }
+    }
+    EXPECT_NEAR(texture.mips[1].pixels[0], 15 * 16 / 2.0f, 0.5f);
+}
+
+TEST(TextureMipsTest, FlatContentIsPreserved) {
+    for (MipFilter filter : {MipFilter::Box, MipFilter::Kaiser}) {
+        Texture texture = MakeTexture(16, 8, 4, TextureUsage::Color, [](u32, u32, u8* out) {
+            out[0] = 37;
+            out[1] = 142;
+            out[2] = 201;
+            out[3] = 77;
+        });
+        MipGenerator::GenerateMips(texture, filter);
+        for (const TextureMip& mip : texture.mips) {
+            for (usize i = 0; i < mip.pixels.size(); i += 4) {
+                EXPECT_NEAR(mip.pixels[i + 0], 37, 1);
+                EXPECT_NEAR(mip.pixels[i + 1], 142, 1);
+                EXPECT_NEAR(mip.pixels[i + 2], 201, 1);
+                EXPECT_NEAR(mip.pixels[i + 3], 77, 1);
+            }
+        }
+    }
+}
+
+TEST(TextureMipsTest, ColourIsFilteredInLinearSpace) {
+    // Black/white columns average to linear 0.5, which is sRGB 188, not 128
+    for (MipFilter filter : {MipFilter::Box, MipFilter::Kaiser}) {
+        Texture texture = MakeTexture(8, 8, 4, TextureUsage::Color, [](u32 x, u32, u8* out) {
+            out[0] = out[1] = out[2] = (x % 2 == 0) ? 0 : 255;
+            out[3] = (x % 2 == 0) ? 0 : 255;
+        });
+        MipGenerator::GenerateMips(texture, filter);
+
+        const u8 expectedColour = QuantizeUnorm8(LinearToSrgb(0.5f));
+        for (usize i = 0; i < texture.mips[0].pixels.size(); i += 4) {
+            EXPECT_NEAR(texture.mips[0].pixels[i], expectedColour, 2);
+            // Alpha is always linear
+            EXPECT_NEAR(texture.mips[0].pixels[i + 3], 128, 2);
+        }
+    }
+}
+
+TEST(TextureMipsTest, NormalsStayUnitLength) {
+    // Alternating tilted normals: the raw average is shorter than 1
+    Texture texture = MakeTexture(8, 8, 4, TextureUsage::Normal, [](u32 x, u32 y, u8* out) {
+        const bool flip = (x + y) % 2 == 0;
+        out[0] = flip ? 218 : 37;  // +-0.71
+        out[1] = 128;
+        out[2] = 218;              // +0.71
+        out[3] = 255;
+    });
+    MipGenerator::GenerateMips(texture, MipFilter::Kaiser);
+
+    for (const TextureMip& mip : texture.mips) {
+        for (usize i = 0; i < mip.pixels.size(); i += 4) {
+            const f32 nx = mip.pixels[i + 0] / 255.0f * 2.0f - 1.0f;
+            const f32 ny = mip.pixels[i + 1] / 255.0f * 2.0f - 1.0f;
+            const f32 nz = mip.pixels[i + 2] / 255.0f * 2.0f - 1.0f;
+            EXPECT_NEAR(std::sqrt(nx * nx + ny * ny + nz * nz), 1.0f, 0.02f);
+            EXPECT_GT(nz, 0.95f);
+        }
+    }
+}
+
+TEST(TextureMipsTest, KaiserRemovesNyquistPattern) {
+    // A one-texel checkerboard cannot be represented at half resolution:
+    // the windowed sinc leaves (nearly) its mean
+    Texture texture = MakeTexture(16, 16, 1, TextureUsage::Data, [](u32 x, u32 y, u8* out) {
+        out[0] = ((x + y) % 2 == 0) ? 0 : 255;
+    });
+    MipGenerator::GenerateMips(texture, MipFilter::Kaiser);
+
+    for (u8 value : texture.mips[0].pixels) {
+        EXPECT_NEAR(value, 128, 3);
+    }
+}
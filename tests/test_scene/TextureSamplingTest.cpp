@@ -0,0 +1,142 @@
+// ============================================================================
+// TextureSampling tests: wrap modes, bilinear/trilinear and anisotropic
+// ============================================================================
+// The CPU sampler is the reference for the GPU sampler state, so texel
+// centres, filter selection, level blending and LOD selection are checked
+// against values computed by hand.
+// ============================================================================
+
+#include "scene/TextureSampling.hpp"
+#include "core/Color.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace quantiloom;
+
+namespace {
+
+// Single-channel data texture with the given level-0 texels
+Texture MakeTexture(u32 width, u32 height, std::vector<u8> texels) {
+    Texture texture;
+    texture.width = width;
+    texture.height = height;
+    texture.channels = 1;
+    texture.pixels = std::move(texels);
+    return texture;
+}
+
+// 64x64 texture whose every level is flat with value 32 * level
+Texture MakeLevelCoded() {
+    Texture texture = MakeTexture(64, 64, std::vector<u8>(64 * 64, 0));
+    for (u32 size = 32, level = 1; size >= 1; size /= 2, ++level) {
+        TextureMip mip;
+        mip.width = size;
+        mip.height = size;
+        mip.pixels.assign(static_cast<usize>(size) * size, static_cast<u8>(32 * level));
+        texture.mips.push_back(mip);
+    }
+    return texture;
+}
+
+} // namespace
+
+TEST(TextureSamplingTest, WrapModes) {
+    using Wrap = TextureSampler::WrapMode;
+    EXPECT_EQ(TextureSampling::WrapCoord(5, 4, Wrap::Repeat), 1);
+    EXPECT_EQ(TextureSampling::WrapCoord(-1, 4, Wrap::Repeat), 3);
+    EXPECT_EQ(TextureSampling::WrapCoord(-1, 4, Wrap::ClampToEdge), 0);
+    EXPECT_EQ(TextureSampling::WrapCoord(9, 4, Wrap::ClampToEdge), 3);
+    EXPECT_EQ(TextureSampling::WrapCoord(4, 4, Wrap::MirroredRepeat), 3);
+    EXPECT_EQ(TextureSampling::WrapCoord(-1, 4, Wrap::MirroredRepeat), 0);
+    EXPECT_EQ(TextureSampling::WrapCoord(9, 4, Wrap::MirroredRepeat), 1);
+}
+
+TEST(TextureSamplingTest, BilinearInterpolatesBetweenTexelCentres) {
+    Texture texture = MakeTexture(2, 1, {0, 200});
+    texture.sampler.wrapS = TextureSampler::WrapMode::ClampToEdge;
+
+    // Texel centres return the texel, the midpoint the average
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.25f, 0.5f}, 0.0f).x, 0.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.75f, 0.5f}, 0.0f).x, 200 / 255.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.5f, 0.5f}, 0.0f).x, 100 / 255.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.375f, 0.5f}, 0.0f).x, 50 / 255.0f, 1e-6f);
+
+    // Repeat wraps the left edge onto the right texel
+    texture.sampler.wrapS = TextureSampler::WrapMode::Repeat;
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.0f, 0.5f}, 0.0f).x, 100 / 255.0f, 1e-6f);
+
+    // Nearest magnification picks the containing texel
+    texture.sampler.magFilter = TextureSampler::Filter::Nearest;
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.45f, 0.5f}, 0.0f).x, 0.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, {0.55f, 0.5f}, 0.0f).x, 200 / 255.0f, 1e-6f);
+}
+
+TEST(TextureSamplingTest, ExpandsChannelsAndDecodesColour) {
+    Texture texture = MakeTexture(1, 1, {128});
+    const glm::vec4 data = TextureSampling::SampleLevel(texture, {0.5f, 0.5f}, 0.0f);
+    EXPECT_NEAR(data.x, 128 / 255.0f, 1e-6f);
+    EXPECT_EQ(data.y, 0.0f);
+    EXPECT_EQ(data.z, 0.0f);
+    EXPECT_EQ(data.w, 1.0f);
+
+    texture.usage = TextureUsage::Color;
+    const glm::vec4 colour = TextureSampling::SampleLevel(texture, {0.5f, 0.5f}, 0.0f);
+    EXPECT_NEAR(colour.x, SrgbToLinear(128 / 255.0f), 1e-6f);
+}
+
+TEST(TextureSamplingTest, TrilinearBlendsLevels) {
+    Texture texture = MakeLevelCoded();
+    const glm::vec2 uv(0.3f, 0.7f);
+
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, 1.0f).x, 32 / 255.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, 1.25f).x, 40 / 255.0f, 1e-5f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, 2.5f).x, 80 / 255.0f, 1e-5f);
+
+    // LOD is clamped to the chain
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, -3.0f).x, 0.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, 20.0f).x, 192 / 255.0f, 1e-6f);
+
+    // Nearest mip filtering rounds to the closest level
+    texture.sampler.mipFilter = TextureSampler::Filter::Nearest;
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, 1.4f).x, 32 / 255.0f, 1e-6f);
+    EXPECT_NEAR(TextureSampling::SampleLevel(texture, uv, 1.6f).x, 64 / 255.0f, 1e-6f);
+}
+
+TEST(TextureSamplingTest, LodFollowsFootprint) {
+    const Texture texture = MakeLevelCoded();
+    EXPECT_FLOAT_EQ(TextureSampling::ComputeLod(texture, {4.0f / 64, 0.0f}, {0.0f, 1.0f / 64}), 2.0f);
+    EXPECT_FLOAT_EQ(TextureSampling::ComputeLod(texture, {0.0f, 0.0f}, {0.0f, 0.0f}), 0.0f);
+
+    // Isotropic footprint of 4 texels samples level 2
+    const glm::vec2 uv(0.5f, 0.5f);
+    EXPECT_NEAR(TextureSampling::SampleGrad(texture, uv, {4.0f / 64, 0.0f}, {0.0f, 4.0f / 64}).x,
+                64 / 255.0f, 1e-5f);
+}
+
+TEST(TextureSamplingTest, AnisotropicProbesUseMinorAxisLod) {
+    const Texture texture = MakeLevelCoded();
+    const glm::vec2 uv(0.5f, 0.5f);
+    const glm::vec2 ddx(8.0f / 64, 0.0f);
+    const glm::vec2 ddy(0.0f, 2.0f / 64);
+
+    // 4:1 footprint: four probes, each covering 2 texels -> level 1
+    EXPECT_NEAR(TextureSampling::SampleGrad(texture, uv, ddx, ddy).x, 32 / 255.0f, 1e-5f);
+
+    // Capped at 2 probes the per-probe footprint is 4 texels -> level 2
+    EXPECT_NEAR(TextureSampling::SampleGrad(texture, uv, ddx, ddy, 2).x, 64 / 255.0f, 1e-5f);
+
+    // Probes are spread along the major axis: a horizontal ramp averages
+    // symmetric samples around uv
+    std::vector<u8> ramp(64 * 4);
+    for (u32 y = 0; y < 4; ++y) {
+        for (u32 x = 0; x < 64; ++x) {
+            ramp[y * 64 + x] = static_cast<u8>(x * 4);
+        }
+    }
+    Texture rampTexture = MakeTexture(64, 4, ramp);
+    const f32 centre = TextureSampling::SampleLevel(rampTexture, uv, 0.0f).x;
+    EXPECT_NEAR(TextureSampling::SampleGrad(rampTexture, uv, {8.0f / 64, 0.0f}, {0.0f, 1.0f / 4}).x,
+                centre, 1e-5f);
+}
@@ -0,0 +1,252 @@
+// ============================================================================
+// VirtualTexture tests: TilePool LRU eviction and page-table translation
+// ============================================================================
+
+#include "io/TileCacheFile.hpp"
+#include "scene/VirtualTexture.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+
+using namespace quantiloom;
+
+namespace {
+
+constexpr usize kTileBytes = 16;
+
+u64 Key(u32 x) {
+    return TileId{0, 0, x, 0}.Pack();
+}
+
+// 64x64 Data texture with mips 32x32 and 16x16; 16-texel tiles give 4x4, 2x2
+// and 1x1 tile grids. Texel = (mip * 60, x, y, 255) of its level.
+Texture MakeTexture() {
+    auto fill = [](u32 size, u32 mip) {
+        std::vector<u8> pixels(static_cast<usize>(size) * size * 4);
+        for (u32 y = 0; y < size; ++y) {
+            for (u32 x = 0; x < size; ++x) {
+                u8* texel = &pixels[(static_cast<usize>(y) * size + x) * 4];
+                texel[0] = static_cast<u8>(mip * 60);
+                texel[1] = static_cast<u8>(x);
+                texel[2] = static_cast<u8>(y);
+                texel[3] = 255;
+            }
+        }
+        return pixels;
+    };
+
+    Texture texture;
+    texture.width = 64;
+    texture.height = 64;
+    texture.channels = 4;
+    texture.usage = TextureUsage::Data;
+    texture.pixels = fill(64, 0);
+    texture.mips.push_back(TextureMip{32, 32, fill(32, 1)});
+    texture.mips.push_back(TextureMip{16, 16, fill(16, 2)});
+    return texture;
+}
+
+class VirtualTextureSystemTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_path = std::filesystem::temp_directory_path() /
+                 (std::string("ql_vt_") + info->name() + ".qlvt");
+        ASSERT_TRUE(TileCacheFile::Build(m_path.string(), {MakeTexture()}, 16, 1));
+    }
+
+    void TearDown() override {
+        m_vt.Close();
+        std::error_code ec;
+        std::filesystem::remove(m_path, ec);
+    }
+
+    std::vector<VirtualTextureSystem::TileUpload> Request(std::initializer_list<TileId> tiles, u32 maxUploads) {
+        VirtualTextureFeedback feedback;
+        for (const TileId& tile : tiles) {
+            feedback.Record(tile);
+        }
+        return m_vt.Update(feedback, maxUploads);
+    }
+
+    std::filesystem::path m_path;
+    VirtualTextureSystem m_vt;
+};
+
+} // namespace
+
+// ============================================================================
+// TilePool
+// ============================================================================
+
+TEST(TilePoolTest, AllocatesFreeSlotsLowFirst) {
+    TilePool pool(3, kTileBytes);
+    EXPECT_EQ(pool.Allocate(Key(0), 1, false), 0u);
+    EXPECT_EQ(pool.Allocate(Key(1), 1, false), 1u);
+    EXPECT_EQ(pool.Allocate(Key(2), 1, false), 2u);
+    EXPECT_EQ(pool.Find(Key(1)), 1u);
+    EXPECT_EQ(pool.Find(Key(3)), TilePool::INVALID_SLOT);
+    EXPECT_EQ(pool.GetResidentCount(), 3u);
+}
+
+TEST(TilePoolTest, EvictsLeastRecentlyUsed) {
+    TilePool pool(3, kTileBytes);
+    pool.Allocate(Key(0), 1, false);
+    pool.Allocate(Key(1), 1, false);
+    pool.Allocate(Key(2), 1, false);
+
+    // Key 0 used again: key 1 is now the least recently used
+    pool.Touch(pool.Find(Key(0)), 2);
+
+    u64 evicted = TilePool::NO_KEY;
+    const u32 slot = pool.Allocate(Key(3), 2, false, &evicted);
+    EXPECT_EQ(slot, 1u);
+    EXPECT_EQ(evicted, Key(1));
+    EXPECT_EQ(pool.Find(Key(1)), TilePool::INVALID_SLOT);
+    EXPECT_EQ(pool.Find(Key(3)), 1u);
+    EXPECT_EQ(pool.Find(Key(0)), 0u);
+
+    // Then key 2, then key 0 (touched in frame 2, before key 3 was added)
+    evicted = TilePool::NO_KEY;
+    EXPECT_EQ(pool.Allocate(Key(4), 3, false, &evicted), 2u);
+    EXPECT_EQ(evicted, Key(2));
+    evicted = TilePool::NO_KEY;
+    EXPECT_EQ(pool.Allocate(Key(5), 3, false, &evicted), 0u);
+    EXPECT_EQ(evicted, Key(0));
+    EXPECT_EQ(pool.GetResidentCount(), 3u);
+}
+
+TEST(TilePoolTest, KeepsTilesUsedThisFrame) {
+    TilePool pool(2, kTileBytes);
+    pool.Allocate(Key(0), 5, false);
+    pool.Allocate(Key(1), 5, false);
+
+    u64 evicted = TilePool::NO_KEY;
+    EXPECT_EQ(pool.Allocate(Key(2), 5, false, &evicted), TilePool::INVALID_SLOT);
+    EXPECT_EQ(evicted, TilePool::NO_KEY);
+    EXPECT_EQ(pool.Find(Key(0)), 0u);
+    EXPECT_EQ(pool.Find(Key(1)), 1u);
+}
+
+TEST(TilePoolTest, NeverEvictsPinnedTiles) {
+    TilePool pool(2, kTileBytes);
+    pool.Allocate(Key(0), 1, true);
+    pool.Allocate(Key(1), 1, false);
+
+    for (u32 frame = 2; frame < 6; ++frame) {
+        u64 evicted = TilePool::NO_KEY;
+        EXPECT_EQ(pool.Allocate(Key(frame), frame, false, &evicted), 1u);
+        EXPECT_NE(evicted, Key(0));
+    }
+    EXPECT_EQ(pool.Find(Key(0)), 0u);
+
+    // Only pinned tiles left to evict: full
+    TilePool pinned(1, kTileBytes);
+    pinned.Allocate(Key(0), 1, true);
+    EXPECT_EQ(pinned.Allocate(Key(1), 2, false), TilePool::INVALID_SLOT);
+}
+
+// ============================================================================
+// VirtualTextureSystem
+// ============================================================================
+
+TEST_F(VirtualTextureSystemTest, PinsCoarsestLevel) {
+    ASSERT_TRUE(m_vt.Open(m_path.string(), 4));
+    const TileCacheFile& file = m_vt.GetCacheFile();
+    ASSERT_EQ(file.GetTextureInfo(0).mipCount, 3u);
+    EXPECT_EQ(file.GetTilesX(0, 0), 4u);
+    EXPECT_EQ(file.GetTilesX(0, 1), 2u);
+    EXPECT_EQ(file.GetTilesX(0, 2), 1u);
+
+    // Only the 1x1 tile of mip 2 is resident; every tile falls back to it
+    EXPECT_EQ(m_vt.GetPool()->GetResidentCount(), 1u);
+    u32 residentMip = 0;
+    const u32 slot = m_vt.Translate(TileId{0, 0, 3, 2}, &residentMip);
+    ASSERT_NE(slot, TilePool::INVALID_SLOT);
+    EXPECT_EQ(residentMip, 2u);
+    EXPECT_EQ(std::memcmp(m_vt.GetPool()->GetSlotData(slot), file.GetTile(0, 2, 0, 0), file.GetTileBytes()), 0);
+
+    // Pool too small for the pinned tiles plus one streamed tile
+    VirtualTextureSystem tooSmall;
+    EXPECT_FALSE(tooSmall.Open(m_path.string(), 1));
+}
+
+TEST_F(VirtualTextureSystemTest, StreamsRequestedTilesIntoPageTable) {
+    ASSERT_TRUE(m_vt.Open(m_path.string(), 4));
+    const TileCacheFile& file = m_vt.GetCacheFile();
+
+    const TileId tile{0, 0, 3, 2};
+    const auto uploads = Request({tile, tile}, 8);
+    ASSERT_EQ(uploads.size(), 1u);
+    EXPECT_EQ(uploads[0].tile, tile);
+    EXPECT_EQ(uploads[0].data, file.GetTile(0, 0, 3, 2));
+    EXPECT_EQ(m_vt.GetLastStats().requested, 1u);
+    EXPECT_EQ(m_vt.GetLastStats().uploads, 1u);
+
+    // Page table: the tile now translates to its own slot holding its texels
+    u32 residentMip = 99;
+    EXPECT_EQ(m_vt.Translate(tile, &residentMip), uploads[0].slot);
+    EXPECT_EQ(residentMip, 0u);
+    EXPECT_EQ(std::memcmp(m_vt.GetPool()->GetSlotData(uploads[0].slot), file.GetTile(0, 0, 3, 2),
+                          file.GetTileBytes()), 0);
+
+    // Neighbours still fall back to the pinned mip; the parent is not resident
+    m_vt.Translate(TileId{0, 0, 2, 2}, &residentMip);
+    EXPECT_EQ(residentMip, 2u);
+
+    // Sampling inside the tile reads mip 0 texels (R = mip * 60, G = x, B = y)
+    const glm::vec4 texel = m_vt.Sample(0, glm::vec2(52.5f / 64.0f, 40.5f / 64.0f), 0.0f);
+    EXPECT_NEAR(texel.x, 0.0f, 1e-6f);
+    EXPECT_NEAR(texel.y * 255.0f, 52.0f, 1e-3f);
+    EXPECT_NEAR(texel.z * 255.0f, 40.0f, 1e-3f);
+
+    // Requesting it again is a hit
+    EXPECT_TRUE(Request({tile}, 8).empty());
+    EXPECT_EQ(m_vt.GetLastStats().hits, 1u);
+}
+
+TEST_F(VirtualTextureSystemTest, EvictsLeastRecentlyRequestedTile) {
+    // 1 pinned + 2 streamed slots
+    ASSERT_TRUE(m_vt.Open(m_path.string(), 3));
+
+    const TileId a{0, 0, 0, 0};
+    const TileId b{0, 0, 1, 0};
+    const TileId c{0, 0, 2, 0};
+    ASSERT_EQ(Request({a, b}, 8).size(), 2u);
+
+    // b is requested again, so a is the one to go
+    const auto uploads = Request({b, c}, 8);
+    ASSERT_EQ(uploads.size(), 1u);
+    EXPECT_EQ(uploads[0].tile, c);
+    const VirtualTextureSystem::Stats& stats = m_vt.GetLastStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.uploads, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+
+    u32 residentMip = 0;
+    EXPECT_NE(m_vt.Translate(b, &residentMip), TilePool::INVALID_SLOT);
+    EXPECT_EQ(residentMip, 0u);
+    EXPECT_EQ(m_vt.Translate(c, &residentMip), uploads[0].slot);
+    EXPECT_EQ(residentMip, 0u);
+    m_vt.Translate(a, &residentMip);
+    EXPECT_EQ(residentMip, 2u);  // Evicted: back to the pinned fallback
+
+    // The pinned tile survives any amount of streaming
+    EXPECT_NE(m_vt.GetPool()->Find(TileId{0, 2, 0, 0}.Pack()), TilePool::INVALID_SLOT);
+}
+
+TEST_F(VirtualTextureSystemTest, DefersUploadsOverBudget) {
+    ASSERT_TRUE(m_vt.Open(m_path.string(), 8));
+
+    // Coarser mips stream first
+    const auto uploads = Request({TileId{0, 0, 0, 0}, TileId{0, 1, 1, 1}, TileId{0, 0, 3, 3}}, 1);
+    ASSERT_EQ(uploads.size(), 1u);
+    EXPECT_EQ(uploads[0].tile, (TileId{0, 1, 1, 1}));
+    EXPECT_EQ(m_vt.GetLastStats().deferred, 2u);
+
+    // Deferred tiles are streamed when requested again
+    EXPECT_EQ(Request({TileId{0, 0, 0, 0}, TileId{0, 0, 3, 3}}, 8).size(), 2u);
+    EXPECT_EQ(m_vt.GetLastStats().deferred, 0u);
+}
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""
+Smoke test for the render daemon (src/app/RenderDaemon.hpp).
+
+Starts `Quantiloom --daemon` on a temporary socket with a scene cache of two,
+then talks to it like a client would:
+
+- ping
+- render to shared memory, map the result, check its size and values, unlink
+- render the three built-in scene presets and the first one again, and check
+  the scene cache statistics (misses, hits, LRU evictions)
+- shutdown, and check that the daemon exits cleanly
+
+Needs a Vulkan device with ray tracing and the compiled shaders next to the
+executable. Only the Python standard library is used.
+
+Usage: tools/daemon_smoke_test.py <path/to/Quantiloom> [--base <config.toml>]
+Exit code: 0 if every check passed, 1 otherwise.
+"""
+
+import argparse
+import json
+import math
+import os
+import shutil
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+from multiprocessing import shared_memory
+
+PROJECT_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_BASE = os.path.join(PROJECT_ROOT, "assets", "configs", "spectral_single.toml")
+PRESETS = ["cornell_box", "multi_object", "lighting_test"]
+CACHE_SIZE = 2
+WIDTH, HEIGHT = 64, 48
+
+
+class Client:
+    """One connection; requests are answered in order, one JSON line each."""
+
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.buffer = b""
+
+    def request(self, message):
+        self.sock.sendall((json.dumps(message) + "\n").encode())
+        while b"\n" not in self.buffer:
+            chunk = self.sock.recv(4096)
+            if not chunk:
+                raise ConnectionError("daemon closed the connection")
+            self.buffer += chunk
+        line, self.buffer = self.buffer.split(b"\n", 1)
+        return json.loads(line)
+
+    def close(self):
+        self.sock.close()
+
+
+def render(client, request_id, preset, output="shm"):
+    return client.request({
+        "op": "render",
+        "id": request_id,
+        "output": output,
+        "config": {
+            "scene": {"preset": preset},
+            "renderer": {"resolution": [WIDTH, HEIGHT], "spp": 1},
+        },
+    })
+
+
+def read_shared_memory(reply):
+    """Radiance of a "shm" reply as floats; the object is unlinked."""
+    shm = shared_memory.SharedMemory(name=reply["shm"].lstrip("/"))
+    try:
+        data = bytes(shm.buf[:reply["bytes"]])
+    finally:
+        shm.close()
+        shm.unlink()
+    return struct.unpack("<%df" % (len(data) // 4), data)
+
+
+def wait_for_socket(path, daemon, timeout):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if daemon.poll() is not None:
+            return False
+        if os.path.exists(path):
+            try:
+                Client(path).close()
+                return True
+            except OSError:
+                pass
+        time.sleep(0.1)
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("executable", help="Quantiloom executable")
+    parser.add_argument("--base", default=DEFAULT_BASE, help="config requests start from")
+    parser.add_argument("--timeout", type=float, default=60.0, help="seconds to wait for the daemon to start")
+    args = parser.parse_args()
+
+    failures = []
+
+    def check(condition, message):
+        print(("  [OK] " if condition else "  [FAIL] ") + message)
+        if not condition:
+            failures.append(message)
+        return condition
+
+    workdir = tempfile.mkdtemp(prefix="ql_daemon_")
+    socket_path = os.path.join(workdir, "daemon.sock")
+    config_path = os.path.join(workdir, "daemon.toml")
+    with open(config_path, "w") as f:
+        f.write("[daemon]\n")
+        f.write("socket = %s\n" % json.dumps(socket_path))
+        f.write("base = %s\n" % json.dumps(os.path.abspath(args.base)))
+        f.write("scene_cache = %d\n" % CACHE_SIZE)
+
+    # Asset paths in configs are relative to the project root; the shaders
+    # are found next to the executable
+    executable = os.path.abspath(args.executable)
+    daemon = subprocess.Popen([executable, "--daemon", config_path], cwd=PROJECT_ROOT)
+    try:
+        if not wait_for_socket(socket_path, daemon, args.timeout):
+            print("Daemon did not start (exit code %s)" % daemon.poll())
+            return 1
+        client = Client(socket_path)
+
+        print("ping")
+        check(client.request({"op": "ping"}).get("status") == "ok", "ping answered")
+
+        print("render to shared memory")
+        reply = render(client, "shm", PRESETS[0])
+        if check(reply.get("status") == "ok", "render succeeded (%s)" % reply.get("error", "ok")):
+            bands = reply["bands"]
+            check(reply["width"] == WIDTH and reply["height"] == HEIGHT, "reply has the requested size")
+            check(len(reply["wavelengths_nm"]) == bands, "one wavelength per band")
+            check(reply["bytes"] == WIDTH * HEIGHT * bands * 4, "shared memory holds f32 [band][y][x]")
+            pixels = read_shared_memory(reply)
+            check(all(math.isfinite(v) for v in pixels), "radiance is finite")
+            check(max(pixels) > 0.0, "radiance is not all zero")
+            check(reply.get("scene_cache") == "miss", "first render loads the scene")
+
+        print("scene cache (capacity %d)" % CACHE_SIZE)
+        # cornell_box is cached; multi_object fills the cache, lighting_test
+        # evicts cornell_box, cornell_box then evicts multi_object
+        for index, preset in enumerate(PRESETS[1:] + PRESETS[:1]):
+            reply = render(client, "evict%d" % index, preset)
+            if check(reply.get("status") == "ok", "render %s (%s)" % (preset, reply.get("error", "ok"))):
+                read_shared_memory(reply)
+                check(reply.get("scene_cache") == "miss", "%s is a miss" % preset)
+        reply = render(client, "hit", PRESETS[0])
+        if check(reply.get("status") == "ok", "render %s again" % PRESETS[0]):
+            read_shared_memory(reply)
+            check(reply.get("scene_cache") == "hit", "%s is a hit" % PRESETS[0])
+
+        stats = client.request({"op": "stats"})
+        cache = stats.get("scene_cache", {})
+        print("stats: %s" % json.dumps(stats))
+        check(stats.get("completed") == 5 and stats.get("failed") == 0, "5 renders completed, none failed")
+        check(cache.get("capacity") == CACHE_SIZE and cache.get("scenes") == CACHE_SIZE, "cache is full")
+        check(cache.get("misses") == 4 and cache.get("hits") == 1, "4 misses, 1 hit")
+        check(cache.get("evictions") == 2, "2 evictions")
+        check(stats.get("latency_s", {}).get("count") == 5, "latency recorded per render")
+
+        print("shutdown")
+        check(client.request({"op": "shutdown"}).get("status") == "ok", "shutdown answered")
+        client.close()
+        check(daemon.wait(timeout=args.timeout) == 0, "daemon exited cleanly")
+    except (OSError, ValueError, KeyError, subprocess.TimeoutExpired) as e:
+        failures.append(str(e))
+        print("  [FAIL] %s" % e)
+    finally:
+        if daemon.poll() is None:
+            daemon.kill()
+            daemon.wait()
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    print("%d check(s) failed" % len(failures) if failures else "All checks passed")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())